@@ -0,0 +1,87 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <key.h>
+#include <pubkey.h>
+#include <qtum/qtumutils.h>
+#include <random.h>
+#include <uint256.h>
+#include <util/convert.h>
+
+#include <cassert>
+#include <vector>
+
+namespace {
+struct Signature {
+    dev::h256 hash;
+    dev::u256 v;
+    dev::h256 r;
+    dev::h256 s;
+};
+
+std::vector<Signature> Signatures(size_t count)
+{
+    std::vector<Signature> signatures;
+    for (size_t i = 0; i < count; ++i) {
+        const CKey key{GenerateRandomKey(/*compressed=*/i % 2 == 0)};
+        const uint256 hash{GetRandHash()};
+        std::vector<unsigned char> sig;
+        assert(key.SignCompact(hash, sig));
+        signatures.push_back({dev::h256(hash.begin(), dev::h256::ConstructFromPointer), sig[0],
+                              dev::h256(&sig[1], dev::h256::ConstructFromPointer), dev::h256(&sig[33], dev::h256::ConstructFromPointer)});
+    }
+    return signatures;
+}
+} // namespace
+
+/** The precompile before it used libsecp256k1 directly: CPubKey::RecoverCompact on a vector */
+static void BtcEcrecoverRecoverCompact(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+    const std::vector<Signature> signatures{Signatures(256)};
+    size_t i{0};
+    bench.run([&] {
+        const Signature& sig{signatures[i++ % signatures.size()]};
+        std::vector<unsigned char> vchSig;
+        vchSig.push_back((unsigned char)sig.v);
+        vchSig.insert(vchSig.end(), sig.r.begin(), sig.r.end());
+        vchSig.insert(vchSig.end(), sig.s.begin(), sig.s.end());
+        CPubKey pubKey;
+        assert(pubKey.RecoverCompact(h256Touint(sig.hash), vchSig));
+        ankerl::nanobench::doNotOptimizeAway(pubKey.GetID());
+    });
+}
+
+/** Recovery of distinct signatures, which always miss the cache */
+static void BtcEcrecover(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+    const std::vector<Signature> signatures{Signatures(256)};
+    size_t i{0};
+    dev::h256 key;
+    bench.run([&] {
+        const Signature& sig{signatures[i++ % signatures.size()]};
+        assert(qtumutils::btc_ecrecover_uncached(sig.hash, sig.v, sig.r, sig.s, key));
+        ankerl::nanobench::doNotOptimizeAway(key);
+    });
+}
+
+/** A relayer checking the same few signatures again within a block */
+static void BtcEcrecoverCached(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+    const std::vector<Signature> signatures{Signatures(8)};
+    size_t i{0};
+    dev::h256 key;
+    bench.run([&] {
+        const Signature& sig{signatures[i++ % signatures.size()]};
+        assert(qtumutils::btc_ecrecover(sig.hash, sig.v, sig.r, sig.s, key));
+        ankerl::nanobench::doNotOptimizeAway(key);
+    });
+}
+
+BENCHMARK(BtcEcrecoverRecoverCompact, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BtcEcrecover, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BtcEcrecoverCached, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,123 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <consensus/validation.h>
+#include <key.h>
+#include <node/cache_warmup.h>
+#include <qtum/qtumstate.h>
+#include <script/script.h>
+#include <script/sign.h>
+#include <script/signingprovider.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <util/check.h>
+#include <util/convert.h>
+#include <util/translation.h>
+#include <validation.h>
+
+#include <cassert>
+#include <map>
+#include <vector>
+
+/**
+ * Block connect latency right after a restart. The chainstate is flushed,
+ * which empties the coins tip cache like a restart does, and a block spending
+ * 1000 coins created in the block before is connected with the cache cold,
+ * and after the cache warm-up prefetched the keys dumped before the flush.
+ * The LevelDB and page caches stay warm within the process, so this measures
+ * the coins tip cache only. The block has no contract transactions, and the
+ * prefetch of the trie nodes into the block caches of the EVM state databases
+ * is not covered.
+ */
+namespace {
+
+constexpr size_t SPENT_COINS{1000};
+
+struct RestartSetup {
+    std::unique_ptr<TestChain100Setup> setup{MakeNoLogFileContext<TestChain100Setup>()};
+    CBlock block;
+    CBlockIndex* pindex{nullptr};
+    node::CacheWarmupKeys keys;
+
+    RestartSetup()
+    {
+        ChainstateManager& chainman{*Assert(setup->m_node.chainman)};
+        Chainstate& chainstate{chainman.ActiveChainstate()};
+        const CScript script{CScript() << OP_TRUE};
+
+        // Spend the first mature coinbase into the outputs the block spends
+        const CTransactionRef& coinbase{setup->m_coinbase_txns.at(0)};
+        CMutableTransaction funding;
+        funding.vin.emplace_back(COutPoint{coinbase->GetHash(), 0});
+        funding.vout.assign(SPENT_COINS, CTxOut{(coinbase->vout[0].nValue - COIN) / CAmount(SPENT_COINS), script});
+        FillableSigningProvider keystore;
+        keystore.AddKey(setup->coinbaseKey);
+        std::map<int, bilingual_str> input_errors;
+        const bool signed_funding{SignTransaction(funding, &keystore, {{funding.vin[0].prevout, Coin{coinbase->vout[0], 1, true, false}}}, SIGHASH_ALL, input_errors)};
+        assert(signed_funding);
+        setup->CreateAndProcessBlock({funding}, GetScriptForRawPubKey(setup->coinbaseKey.GetPubKey()));
+
+        std::vector<CMutableTransaction> txs;
+        for (uint32_t n = 0; n < SPENT_COINS; ++n) {
+            CMutableTransaction tx;
+            tx.vin.emplace_back(COutPoint{funding.GetHash(), n});
+            tx.vout.emplace_back(funding.vout[n].nValue - COIN / 100, script);
+            txs.push_back(std::move(tx));
+        }
+        block = setup->CreateBlock(txs, GetScriptForRawPubKey(setup->coinbaseKey.GetPubKey()), chainstate);
+
+        LOCK(::cs_main);
+        pindex = chainman.m_blockman.AddToBlockIndex(block, chainman.m_best_header);
+        keys = node::GetCacheWarmupKeys(chainstate);
+        chainstate.ForceFlushStateToDisk();
+        assert(chainstate.CoinsTip().GetCacheSize() == 0);
+    }
+
+    void Connect(bool uncache)
+    {
+        Chainstate& chainstate{setup->m_node.chainman->ActiveChainstate()};
+        const CBlockIndex& tip{*Assert(pindex->pprev)};
+        LOCK(::cs_main);
+        {
+            CCoinsViewCache view{&chainstate.CoinsTip()};
+            BlockValidationState state;
+            const bool connected{chainstate.ConnectBlock(block, state, pindex, view)};
+            assert(connected);
+        }
+        globalState->setRoot(uintToh256(tip.hashStateRoot));
+        globalState->setRootUTXO(uintToh256(tip.hashUTXORoot));
+        if (uncache) {
+            for (size_t i = 1; i < block.vtx.size(); ++i) {
+                for (const CTxIn& txin : block.vtx[i]->vin) chainstate.CoinsTip().Uncache(txin.prevout);
+            }
+        }
+    }
+};
+
+} // namespace
+
+/** The inputs of every run are read from the coins database, as right after a restart */
+static void ConnectBlockAfterRestart(benchmark::Bench& bench)
+{
+    RestartSetup restart;
+    bench.unit("block").run([&] { restart.Connect(/*uncache=*/true); });
+}
+
+/** The inputs were prefetched by the cache warm-up, the trie nodes play no part */
+static void ConnectBlockAfterRestartWarm(benchmark::Bench& bench)
+{
+    RestartSetup restart;
+    const fs::path path{restart.setup->m_args.GetDataDirNet() / "warmcache.dat"};
+    assert(node::DumpCacheWarmupKeys(restart.keys, path));
+    assert(node::LoadCacheWarmup(path));
+    ChainstateManager& chainman{*restart.setup->m_node.chainman};
+    node::RunCacheWarmup(chainman.ActiveChainstate(), chainman.m_interrupt);
+    assert(node::GetCacheWarmupProgress().complete);
+    bench.unit("block").run([&] { restart.Connect(/*uncache=*/false); });
+}
+
+BENCHMARK(ConnectBlockAfterRestart, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnectBlockAfterRestartWarm, benchmark::PriorityLevel::HIGH);
@@ -40,6 +40,20 @@ static void DeserializeBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void DeserializeBlockArenaTest(benchmark::Bench& bench)
+{
+    DataStream stream(benchmark::data::blockbench);
+    std::byte a{0};
+    stream.write({&a, 1}); // Prevent compaction
+
+    bench.unit("block").run([&] {
+        CBlock block;
+        stream >> TX_WITH_WITNESS(BlockWithArena{block, stream.size()});
+        bool rewound = stream.Rewind(benchmark::data::blockbench.size());
+        assert(rewound);
+    });
+}
+
 static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 {
     DataStream stream(benchmark::data::blockbench);
@@ -63,5 +77,30 @@ static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void DeserializeAndCheckBlockArenaTest(benchmark::Bench& bench)
+{
+    DataStream stream(benchmark::data::blockbench);
+    std::byte a{0};
+    stream.write({&a, 1}); // Prevent compaction
+
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, ChainType::MAIN);
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN);
+    Chainstate& chainstate = testing_setup->m_node.chainman->ActiveChainstate();
+
+    bench.unit("block").run([&] {
+        CBlock block; // Note that CBlock caches its checked state, so we need to recreate it here
+        stream >> TX_WITH_WITNESS(BlockWithArena{block, stream.size()});
+        bool rewound = stream.Rewind(benchmark::data::blockbench.size());
+        assert(rewound);
+
+        BlockValidationState validationState;
+        bool checked = CheckBlock(block, validationState, chainParams->GetConsensus(), chainstate);
+        assert(checked);
+    });
+}
+
 BENCHMARK(DeserializeBlockTest, benchmark::PriorityLevel::HIGH);
 BENCHMARK(DeserializeAndCheckBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeBlockArenaTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeAndCheckBlockArenaTest, benchmark::PriorityLevel::HIGH);
@@ -56,7 +56,7 @@ static void addCoin(const CAmount& nValue, const CWallet& wallet, std::vector<st
 // same one over and over isn't too useful. Generating random isn't useful
 // either for measurements."
 // (https://github.com/bitcoin/bitcoin/issues/7883#issuecomment-224807484)
-static void CoinSelection(benchmark::Bench& bench)
+static void BenchCoinSelection(benchmark::Bench& bench, int num_reward_coins)
 {
     NodeContext node;
     auto chain = interfaces::MakeChain(node);
@@ -69,6 +69,10 @@ static void CoinSelection(benchmark::Bench& bench)
         addCoin(1000 * COIN, wallet, wtxs);
     }
     addCoin(3 * COIN, wallet, wtxs);
+    // Small stake and MPoS rewards, which pile up in pool payout and staking wallets
+    for (int i = 0; i < num_reward_coins; ++i) {
+        addCoin(COIN / 4 + (i % 1000) * 1000, wallet, wtxs);
+    }
 
     // Create coins
     wallet::CoinsResult available_coins;
@@ -94,11 +98,23 @@ static void CoinSelection(benchmark::Bench& bench)
     bench.run([&] {
         auto result = AttemptSelection(wallet.chain(), 1002.99 * COIN, group, coin_selection_params, /*allow_mixed_output_types=*/true);
         assert(result);
-        assert(result->GetSelectedValue() == 1003 * COIN);
-        assert(result->GetInputSet().size() == 2);
+        if (num_reward_coins == 0) {
+            assert(result->GetSelectedValue() == 1003 * COIN);
+            assert(result->GetInputSet().size() == 2);
+        }
     });
 }
 
+static void CoinSelection(benchmark::Bench& bench)
+{
+    BenchCoinSelection(bench, /*num_reward_coins=*/0);
+}
+
+static void CoinSelectionLargeWallet(benchmark::Bench& bench)
+{
+    BenchCoinSelection(bench, /*num_reward_coins=*/20000);
+}
+
 // Copied from src/wallet/test/coinselector_tests.cpp
 static void add_coin(const CAmount& nValue, int nInput, std::vector<OutputGroup>& set)
 {
@@ -138,4 +154,5 @@ static void BnBExhaustion(benchmark::Bench& bench)
 }
 
 BENCHMARK(CoinSelection, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CoinSelectionLargeWallet, benchmark::PriorityLevel::LOW);
 BENCHMARK(BnBExhaustion, benchmark::PriorityLevel::HIGH);
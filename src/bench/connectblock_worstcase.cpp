@@ -0,0 +1,378 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <addresstype.h>
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <consensus/consensus.h>
+#include <consensus/gapcoin_pow.h>
+#include <consensus/validation.h>
+#include <crypto/dilithium.h>
+#include <hash.h>
+#include <key.h>
+#include <node/miner.h>
+#include <pow.h>
+#include <qtum/qtumDGP.h>
+#include <qtum/qtumtransaction.h>
+#include <script/script.h>
+#include <script/sign.h>
+#include <script/signingprovider.h>
+#include <sync.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <util/check.h>
+#include <util/convert.h>
+#include <util/strencodings.h>
+#include <util/translation.h>
+#include <validation.h>
+
+#include <cassert>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Worst-case block validation. Each benchmark builds the most expensive block
+ * of one kind that the limits currently in effect allow (DGP block size,
+ * sigops and gas) and times connecting it on top of the tip. The median time
+ * is also reported as a share of the main network block interval, so a change
+ * of consensus parameters can be checked against the time budget it has.
+ */
+namespace {
+
+//! Report the median time of the last run against the main network block interval
+void ReportBlockInterval(benchmark::Bench& bench, const std::string& what, int height)
+{
+    if (!bench.output() || bench.results().empty()) return;
+    const double seconds{bench.results().back().median(ankerl::nanobench::Result::Measure::elapsed)};
+    const int64_t interval{CChainParams::Main()->GetConsensus().TargetSpacing(height)};
+    *bench.output() << strprintf("%s: %s, %.1f%% of the %ds block interval\n", bench.name(), what, 100 * seconds / interval, interval);
+}
+
+//! Time connecting a block on top of the tip, rewinding the contract state after each run
+void BenchConnectBlock(benchmark::Bench& bench, TestChain100Setup& setup, const CBlock& block)
+{
+    ChainstateManager& chainman{*Assert(setup.m_node.chainman)};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+    CBlockIndex* pindex{WITH_LOCK(::cs_main, return chainman.m_blockman.AddToBlockIndex(block, chainman.m_best_header))};
+    const CBlockIndex& tip{*Assert(pindex->pprev)};
+
+    bench.unit("block").run([&] {
+        LOCK(::cs_main);
+        CCoinsViewCache view{&chainstate.CoinsTip()};
+        BlockValidationState state;
+        const bool connected{chainstate.ConnectBlock(block, state, pindex, view)};
+        assert(connected);
+        globalState->setRoot(uintToh256(tip.hashStateRoot));
+        globalState->setRootUTXO(uintToh256(tip.hashUTXORoot));
+    });
+    ReportBlockInterval(bench, strprintf("%u bytes, %u transactions", ::GetSerializeSize(TX_WITH_WITNESS(block)), block.vtx.size()), pindex->nHeight);
+}
+
+void SignTx(CMutableTransaction& tx, const FillableSigningProvider& keystore, const std::map<COutPoint, Coin>& coins)
+{
+    std::map<int, bilingual_str> input_errors;
+    const bool complete{SignTransaction(tx, &keystore, coins, SIGHASH_ALL, input_errors)};
+    assert(complete);
+}
+
+//! Spend the first mature coinbase into equal outputs paying to script
+CTransactionRef FundOutputs(TestChain100Setup& setup, const CScript& script, size_t count)
+{
+    const CTransactionRef& coinbase{setup.m_coinbase_txns.at(0)};
+    CMutableTransaction tx;
+    tx.vin.emplace_back(COutPoint{coinbase->GetHash(), 0});
+    const CAmount value{(coinbase->vout[0].nValue - COIN) / CAmount(count)};
+    tx.vout.assign(count, CTxOut{value, script});
+    FillableSigningProvider keystore;
+    keystore.AddKey(setup.coinbaseKey);
+    SignTx(tx, keystore, {{tx.vin[0].prevout, Coin{coinbase->vout[0], 1, true, false}}});
+    setup.CreateAndProcessBlock({tx}, GetScriptForRawPubKey(setup.coinbaseKey.GetPubKey()));
+    return MakeTransactionRef(std::move(tx));
+}
+
+//! Add transactions spending one funded output each until the block weight or sigops limit is hit
+std::vector<CMutableTransaction> FillBlock(const CTransaction& funding, const FillableSigningProvider& keystore, int64_t sigops_per_tx,
+                                           const std::function<void(CMutableTransaction&)>& sign = {})
+{
+    std::vector<CMutableTransaction> txs;
+    int64_t weight{4000};
+    int64_t sigops{WITNESS_SCALE_FACTOR * 100};
+    for (uint32_t n = 0; n < funding.vout.size(); ++n) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{funding.GetHash(), n});
+        tx.vout.emplace_back(funding.vout[n].nValue - COIN / 100, CScript() << OP_TRUE);
+        if (sign) {
+            sign(tx);
+        } else {
+            SignTx(tx, keystore, {{tx.vin[0].prevout, Coin{funding.vout[n], 1, false, false}}});
+        }
+        weight += GetTransactionWeight(CTransaction{tx});
+        sigops += sigops_per_tx;
+        if (weight > dgpMaxBlockWeight || sigops > dgpMaxBlockSigOps) break;
+        txs.push_back(std::move(tx));
+    }
+    return txs;
+}
+
+uint64_t BlockGasLimit(TestChain100Setup& setup)
+{
+    LOCK(::cs_main);
+    Chainstate& chainstate{setup.m_node.chainman->ActiveChainstate()};
+    QtumDGP qtumDGP(globalState.get(), chainstate, fGettingValuesDGP);
+    return qtumDGP.getBlockGasLimit(chainstate.m_chain.Height() + 1);
+}
+
+CScript CreateScript(const std::vector<unsigned char>& code, uint64_t gas_limit)
+{
+    return CScript() << CScriptNum(VersionVM::GetEVMDefault().toRaw()) << CScriptNum(int64_t(gas_limit)) << CScriptNum(DEFAULT_GAS_PRICE) << code << OP_CREATE;
+}
+
+CScript CallScript(const uint160& contract, uint64_t gas_limit)
+{
+    return CScript() << CScriptNum(VersionVM::GetEVMDefault().toRaw()) << CScriptNum(int64_t(gas_limit)) << CScriptNum(DEFAULT_GAS_PRICE) << std::vector<unsigned char>{0} << ToByteVector(contract) << OP_CALL;
+}
+
+//! Init code deploying runtime as the contract code
+std::vector<unsigned char> DeployCode(const std::vector<unsigned char>& runtime)
+{
+    // PUSH1 len DUP1 PUSH1 11 PUSH1 0 CODECOPY PUSH1 0 RETURN
+    std::vector<unsigned char> code{0x60, uint8_t(runtime.size()), 0x80, 0x60, 0x0b, 0x60, 0x00, 0x39, 0x60, 0x00, 0xf3};
+    code.insert(code.end(), runtime.begin(), runtime.end());
+    return code;
+}
+
+//! Address of the contract created by output n of a transaction
+uint160 ContractAddress(const CTransaction& tx, uint32_t n)
+{
+    DataStream stream;
+    stream << tx.GetHash() << n;
+    return Hash160(stream);
+}
+
+//! Contract transaction spending a P2PK output of the coinbase key
+CMutableTransaction ContractTx(TestChain100Setup& setup, const COutPoint& prevout, const CTxOut& prev_out, const CScript& contract, uint64_t gas_limit, CAmount value = 0)
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(prevout);
+    tx.vout.emplace_back(value, contract);
+    const CAmount fee{CAmount(gas_limit) * DEFAULT_GAS_PRICE + COIN / 100};
+    tx.vout.emplace_back(prev_out.nValue - value - fee, GetScriptForRawPubKey(setup.coinbaseKey.GetPubKey()));
+    FillableSigningProvider keystore;
+    keystore.AddKey(setup.coinbaseKey);
+    SignTx(tx, keystore, {{prevout, Coin{prev_out, 1, false, false}}});
+    return tx;
+}
+
+//! Assemble a block from the contract transactions, executing them like a miner would
+CBlock AssembleContractBlock(TestChain100Setup& setup, const std::vector<CMutableTransaction>& txs)
+{
+    for (const CMutableTransaction& tx : txs) {
+        const MempoolAcceptResult result{WITH_LOCK(::cs_main, return setup.m_node.chainman->ProcessTransaction(MakeTransactionRef(tx)))};
+        assert(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    }
+    node::BlockAssembler::Options options;
+    options.coinbase_output_script = GetScriptForRawPubKey(setup.coinbaseKey.GetPubKey());
+    std::shared_ptr<CBlock> block{PrepareBlock(setup.m_node, options)};
+    assert(block->vtx.size() > txs.size());
+    while (!CheckProofOfWork(block->GetHash(), block->nBits, Params().GetConsensus())) ++block->nNonce;
+    return *block;
+}
+
+//! Deploy runtime code with the first mature coinbase, returning the contract and the change
+std::pair<uint160, CTransactionRef> Deploy(TestChain100Setup& setup, const std::vector<unsigned char>& runtime)
+{
+    const CTransactionRef& coinbase{setup.m_coinbase_txns.at(0)};
+    const CMutableTransaction tx{ContractTx(setup, {coinbase->GetHash(), 0}, coinbase->vout[0], CreateScript(DeployCode(runtime), 1000000), 1000000)};
+    std::shared_ptr<CBlock> block{std::make_shared<CBlock>(AssembleContractBlock(setup, {tx}))};
+    [[maybe_unused]] const bool accepted{setup.m_node.chainman->ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/nullptr)};
+    assert(accepted && WITH_LOCK(::cs_main, return setup.m_node.chainman->ActiveChain().Tip()->GetBlockHash()) == block->GetHash());
+    return {ContractAddress(CTransaction{tx}, 0), MakeTransactionRef(tx)};
+}
+
+/** A maximum-gas loop reading one cold storage slot and writing a fresh one per iteration */
+void ConnectBlockColdStorageLoop(benchmark::Bench& bench)
+{
+    const auto setup{MakeNoLogFileContext<TestChain100Setup>()};
+    // PUSH1 0
+    // loop: JUMPDEST PUSH1 1 ADD DUP1 NOT SLOAD POP DUP1 DUP1 SSTORE
+    //       PUSH2 30000 GAS GT PUSH1 loop JUMPI STOP
+    const std::vector<unsigned char> code{ParseHex("60005b60010180195450808055617530" "5a1160025700")};
+    const uint64_t gas_limit{BlockGasLimit(*setup)};
+    const CTransactionRef& coinbase{setup->m_coinbase_txns.at(0)};
+    const CBlock block{AssembleContractBlock(*setup, {ContractTx(*setup, {coinbase->GetHash(), 0}, coinbase->vout[0], CreateScript(code, gas_limit), gas_limit)})};
+    BenchConnectBlock(bench, *setup, block);
+}
+
+/** A contract calling itself in a loop until the gas of the block runs out, at up to the maximum call depth */
+void ConnectBlockDeepCalls(benchmark::Bench& bench)
+{
+    const auto setup{MakeNoLogFileContext<TestChain100Setup>()};
+    // loop: JUMPDEST PUSH1 0 PUSH1 0 PUSH1 0 PUSH1 0 PUSH1 0 ADDRESS GAS CALL POP
+    //       PUSH2 3000 GAS GT PUSH1 loop JUMPI STOP
+    const auto [contract, deploy]{Deploy(*setup, ParseHex("5b60006000600060006000305af150610bb85a1160005700"))};
+    const uint64_t gas_limit{BlockGasLimit(*setup)};
+    const CBlock block{AssembleContractBlock(*setup, {ContractTx(*setup, {deploy->GetHash(), 1}, deploy->vout[1], CallScript(contract, gas_limit), gas_limit)})};
+    BenchConnectBlock(bench, *setup, block);
+}
+
+/** A contract paying one satoshi to a fresh address per iteration, so the condensing transaction gets an output for each */
+void ConnectBlockLargeCondensing(benchmark::Bench& bench)
+{
+    const auto setup{MakeNoLogFileContext<TestChain100Setup>()};
+    // PUSH3 0x10000 (above the precompiled contracts)
+    // loop: JUMPDEST PUSH1 0 PUSH1 0 PUSH1 0 PUSH1 0 PUSH1 1 DUP6 PUSH1 0 CALL POP PUSH1 1 ADD
+    //       PUSH2 40000 GAS GT PUSH1 loop JUMPI STOP
+    const std::vector<unsigned char> code{ParseHex("620100005b60006000600060006001856000f150600101619c40" "5a1160045700")};
+    const uint64_t gas_limit{BlockGasLimit(*setup)};
+    const CTransactionRef& coinbase{setup->m_coinbase_txns.at(0)};
+    const CBlock block{AssembleContractBlock(*setup, {ContractTx(*setup, {coinbase->GetHash(), 0}, coinbase->vout[0], CreateScript(code, gas_limit), gas_limit, COIN / 1000)})};
+    BenchConnectBlock(bench, *setup, block);
+}
+
+/** As many minimal contract calls as the block gas allows, each refunded by its own output of the coinbase */
+void ConnectBlockMaxRewardOutputs(benchmark::Bench& bench)
+{
+    const auto setup{MakeNoLogFileContext<TestChain100Setup>()};
+    const auto [contract, deploy]{Deploy(*setup, {0x00})};
+    const size_t count{size_t(BlockGasLimit(*setup) / MEMPOOL_MIN_GAS_LIMIT)};
+
+    // Fund one output per call from the deployment change
+    CMutableTransaction funding;
+    funding.vin.emplace_back(COutPoint{deploy->GetHash(), 1});
+    const CAmount value{(deploy->vout[1].nValue - COIN) / CAmount(count)};
+    funding.vout.assign(count, CTxOut{value, GetScriptForRawPubKey(setup->coinbaseKey.GetPubKey())});
+    FillableSigningProvider keystore;
+    keystore.AddKey(setup->coinbaseKey);
+    SignTx(funding, keystore, {{funding.vin[0].prevout, Coin{deploy->vout[1], 1, false, false}}});
+    setup->CreateAndProcessBlock({funding}, GetScriptForRawPubKey(setup->coinbaseKey.GetPubKey()));
+
+    std::vector<CMutableTransaction> calls;
+    for (uint32_t n = 0; n < count; ++n) {
+        calls.push_back(ContractTx(*setup, {funding.GetHash(), n}, funding.vout[n], CallScript(contract, MEMPOOL_MIN_GAS_LIMIT), MEMPOOL_MIN_GAS_LIMIT));
+    }
+    const CBlock block{AssembleContractBlock(*setup, calls)};
+    BenchConnectBlock(bench, *setup, block);
+}
+
+/** P2SH 1-of-20 multisig spends signed by the last key, so every input runs 20 signature checks, up to the sigops limit */
+void ConnectBlockMaxSigops(benchmark::Bench& bench)
+{
+    const auto setup{MakeNoLogFileContext<TestChain100Setup>()};
+    std::vector<CKey> keys;
+    std::vector<CPubKey> pubkeys;
+    for (unsigned i = 0; i < MAX_PUBKEYS_PER_MULTISIG; ++i) {
+        keys.push_back(GenerateRandomKey());
+        pubkeys.push_back(keys.back().GetPubKey());
+    }
+    const CScript redeem{GetScriptForMultisig(1, pubkeys)};
+    FillableSigningProvider keystore;
+    keystore.AddCScript(redeem);
+    keystore.AddKey(keys.back());
+
+    const int64_t sigops_per_tx{MAX_PUBKEYS_PER_MULTISIG * WITNESS_SCALE_FACTOR};
+    const size_t count{size_t(dgpMaxBlockSigOps / sigops_per_tx)};
+    const CTransactionRef funding{FundOutputs(*setup, GetScriptForDestination(ScriptHash(redeem)), count)};
+    const std::vector<CMutableTransaction> txs{FillBlock(*funding, keystore, sigops_per_tx)};
+    const CBlock block{setup->CreateBlock(txs, GetScriptForRawPubKey(setup->coinbaseKey.GetPubKey()), setup->m_node.chainman->ActiveChainstate())};
+    BenchConnectBlock(bench, *setup, block);
+}
+
+/** Dilithium pubkey hash spends revealing the full key, up to the block weight limit */
+void ConnectBlockDilithiumInputs(benchmark::Bench& bench)
+{
+    // Without liboqs no valid signature can be made
+    if (!dilithium::IsAvailable()) return;
+
+    const auto setup{MakeNoLogFileContext<TestChain100Setup>()};
+    dilithium::CKey key;
+    assert(key.MakeNewKey());
+    const std::vector<unsigned char> pubkey{key.GetPubKey().GetBytes()};
+    const CScript script{GetScriptForDestination(DilithiumPubKeyHash{pubkey})};
+    // The signature commits to the executed script only, so one fits every input
+    std::vector<unsigned char> sig;
+    assert(key.Sign(Hash(script), sig));
+
+    const size_t count{dgpMaxBlockWeight / (WITNESS_SCALE_FACTOR * (dilithium::SIGNATURE_SIZE + dilithium::PUBLIC_KEY_SIZE))};
+    const CTransactionRef funding{FundOutputs(*setup, script, count)};
+    const std::vector<CMutableTransaction> txs{FillBlock(*funding, {}, 0, [&](CMutableTransaction& tx) {
+        tx.vin[0].scriptSig = CScript() << sig << pubkey;
+    })};
+    const CBlock block{setup->CreateBlock(txs, GetScriptForRawPubKey(setup->coinbaseKey.GetPubKey()), setup->m_node.chainman->ActiveChainstate())};
+    BenchConnectBlock(bench, *setup, block);
+}
+
+/**
+ * Gapcoin header with the largest shift a header may claim. The candidate is
+ * not prime, so this times the primality test of a candidate as large as the
+ * shift allows, the cost of rejecting a header that fails it.
+ */
+void GapcoinProofMaxShiftNotPrime(benchmark::Bench& bench)
+{
+    const auto setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    const Consensus::Params& params{Params().GetConsensus()};
+    CBlockHeader header;
+    header.nBits = MeritToCompact(params.nGapcoinInitialDifficulty);
+    header.nShift = params.nGapcoinShiftMax;
+    header.nGapSize = std::numeric_limits<uint32_t>::max();
+
+    bench.run([&] {
+        std::string error;
+        ankerl::nanobench::doNotOptimizeAway(CheckGapcoinProof(header, params, error));
+        assert(error == "gapcoin-start-not-prime");
+    });
+    ReportBlockInterval(bench, strprintf("shift %u", header.nShift), 0);
+}
+
+/**
+ * Gapcoin proof whose start and end pass the primality tests, so that every
+ * number of the gap is tested to be composite. A proof at the largest shift
+ * can not be searched for in the setup, so it is searched for at a shift of
+ * 1024, where that takes about a second.
+ */
+void GapcoinProofPrimeGap(benchmark::Bench& bench)
+{
+    const auto setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    const Consensus::Params& params{Params().GetConsensus()};
+    CBlockHeader header;
+    header.nBits = MeritToCompact(params.nGapcoinInitialDifficulty);
+    header.nShift = 1024;
+    header.nGapSize = 2;
+
+    std::string error;
+    const auto check{[&] {
+        error.clear();
+        return CheckGapcoinProof(header, params, error);
+    }};
+    // The candidate is made odd, so even adders step through the odd ones
+    for (uint64_t adder = 2; !check() && error == "gapcoin-start-not-prime"; adder += 2) {
+        header.nAdder = ArithToUint256(arith_uint256{adder});
+    }
+    while (!check() && error == "gapcoin-end-not-prime") {
+        header.nGapSize += 2;
+    }
+
+    // The gap falls short of the merit target, which is checked last
+    bench.run([&] {
+        std::string error;
+        ankerl::nanobench::doNotOptimizeAway(CheckGapcoinProof(header, params, error));
+    });
+    ReportBlockInterval(bench, strprintf("shift %u, gap %u (%s)", header.nShift, header.nGapSize, error.empty() ? "valid" : error), 0);
+}
+
+} // namespace
+
+BENCHMARK(ConnectBlockColdStorageLoop, benchmark::PriorityLevel::LOW);
+BENCHMARK(ConnectBlockDeepCalls, benchmark::PriorityLevel::LOW);
+BENCHMARK(ConnectBlockLargeCondensing, benchmark::PriorityLevel::LOW);
+BENCHMARK(ConnectBlockMaxRewardOutputs, benchmark::PriorityLevel::LOW);
+BENCHMARK(ConnectBlockMaxSigops, benchmark::PriorityLevel::LOW);
+BENCHMARK(ConnectBlockDilithiumInputs, benchmark::PriorityLevel::LOW);
+BENCHMARK(GapcoinProofMaxShiftNotPrime, benchmark::PriorityLevel::LOW);
+BENCHMARK(GapcoinProofPrimeGap, benchmark::PriorityLevel::LOW);
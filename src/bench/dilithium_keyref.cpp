@@ -0,0 +1,94 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <addresstype.h>
+#include <chain.h>
+#include <crypto/dilithium.h>
+#include <hash.h>
+#include <node/blockstorage.h>
+#include <script/interpreter.h>
+#include <script/script.h>
+#include <tinyformat.h>
+#include <uint256.h>
+#include <validation.h>
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+/**
+ * Spending a Dilithium pubkey hash output by revealing the 1952-byte public
+ * key, and by referencing the key id of a key an earlier block revealed. The
+ * reference trades hashing the key for a read of the revealed-key index.
+ */
+namespace {
+
+/** Signature checker resolving key references like ConnectBlock does */
+class KeyRefChecker : public BaseSignatureChecker
+{
+public:
+    const DilithiumKeyLookup& m_keys;
+
+    explicit KeyRefChecker(const DilithiumKeyLookup& keys) : m_keys(keys) {}
+
+    bool GetDilithiumPubKey(const uint160& keyid, std::vector<unsigned char>& pubkey) const override
+    {
+        return m_keys.GetDilithiumPubKey(keyid, pubkey);
+    }
+};
+
+void BenchDilithiumSpend(benchmark::Bench& bench, bool keyref)
+{
+    // Without liboqs no valid signature can be made
+    if (!dilithium::IsAvailable()) return;
+
+    dilithium::CKey key;
+    assert(key.MakeNewKey());
+    const std::vector<unsigned char> pubkey{key.GetPubKey().GetBytes()};
+    const DilithiumPubKeyHash keyid{pubkey};
+    const CScript scriptPubKey{GetScriptForDestination(keyid)};
+    std::vector<unsigned char> sig;
+    assert(key.Sign(Hash(scriptPubKey), sig));
+
+    // The key was revealed by the tip
+    kernel::BlockTreeDB db{DBParams{.path = "", .cache_bytes = 1 << 20, .memory_only = true}};
+    const uint256 hash{uint256::ONE};
+    CBlockIndex tip;
+    tip.phashBlock = &hash;
+    assert(db.WriteDilithiumKeyIndex({{uint160{keyid}, CDilithiumKeyIndexValue(tip.nHeight, hash, pubkey)}}));
+    const ChainDilithiumKeys keys{db, &tip};
+    const KeyRefChecker checker{keys};
+
+    const CScript scriptSig{keyref ? CScript() << sig << ToByteVector(keyid) : CScript() << sig << pubkey};
+    const CScript fullSpend{CScript() << sig << pubkey};
+    const unsigned int flags{SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_DILITHIUM_KEYREF};
+
+    bench.unit("input").run([&] {
+        ScriptError err;
+        const bool success{VerifyScript(scriptSig, scriptPubKey, nullptr, flags, checker, &err)};
+        assert(success);
+    });
+
+    // Every reference saves the key minus the key id push
+    assert(fullSpend.size() - scriptSig.size() == (keyref ? dilithium::PUBLIC_KEY_SIZE + 2 - DILITHIUM_KEYREF_SIZE : 0));
+    if (bench.output()) {
+        *bench.output() << strprintf("%s: scriptSig %u bytes, %u bytes saved per input\n", bench.name(), scriptSig.size(), fullSpend.size() - scriptSig.size());
+    }
+}
+
+void DilithiumSpendFullKey(benchmark::Bench& bench)
+{
+    BenchDilithiumSpend(bench, /*keyref=*/false);
+}
+
+void DilithiumSpendKeyRef(benchmark::Bench& bench)
+{
+    BenchDilithiumSpend(bench, /*keyref=*/true);
+}
+
+} // namespace
+
+BENCHMARK(DilithiumSpendFullKey, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DilithiumSpendKeyRef, benchmark::PriorityLevel::HIGH);
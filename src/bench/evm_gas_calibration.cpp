@@ -0,0 +1,464 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <crypto/sha256.h>
+#include <key.h>
+#include <qtum/qtumDGP.h>
+#include <qtum/qtumstate.h>
+#include <qtum/qtumtransaction.h>
+#include <random.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <uint256.h>
+#include <util/check.h>
+#include <util/convert.h>
+#include <util/strencodings.h>
+#include <validation.h>
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+/**
+ * Gas calibration of the EVM backend. Each case runs a contract that repeats
+ * one operation, storage access pattern or precompile call until its gas is
+ * used up, and reports the time per unit of gas charged under the gas
+ * schedule in effect. Cases where a block filled with the operation would
+ * take longer to validate than the main network block interval are flagged,
+ * as they are mispriced for the block time.
+ */
+namespace {
+
+//! EVM opcodes used by the calibration contracts
+enum Op : uint8_t {
+    STOP = 0x00,
+    ADD = 0x01,
+    MUL = 0x02,
+    SUB = 0x03,
+    DIV = 0x04,
+    SDIV = 0x05,
+    MOD = 0x06,
+    ADDMOD = 0x08,
+    MULMOD = 0x09,
+    EXP = 0x0a,
+    GT = 0x11,
+    ISZERO = 0x15,
+    SHA3 = 0x20,
+    BALANCE = 0x31,
+    CODECOPY = 0x39,
+    EXTCODESIZE = 0x3b,
+    EXTCODEHASH = 0x3f,
+    POP = 0x50,
+    MLOAD = 0x51,
+    MSTORE = 0x52,
+    SLOAD = 0x54,
+    SSTORE = 0x55,
+    JUMPI = 0x57,
+    GAS = 0x5a,
+    JUMPDEST = 0x5b,
+    PUSH1 = 0x60,
+    PUSH2 = 0x61,
+    DUP1 = 0x80,
+    DUP6 = 0x85,
+    SWAP1 = 0x90,
+    LOG2 = 0xa2,
+    CALL = 0xf1,
+    RETURN = 0xf3,
+    STATICCALL = 0xfa,
+    INVALID = 0xfe,
+};
+
+//! Gas given to each run of a case
+constexpr uint64_t CASE_GAS{4'000'000};
+//! Gas left when the loop of a case stops, above the cost of any one iteration
+constexpr uint64_t LOOP_RESERVE{400'000};
+
+//! Minimal assembler for the calibration contracts
+class Code
+{
+public:
+    Code& Op(uint8_t op)
+    {
+        m_code.push_back(op);
+        return *this;
+    }
+
+    Code& Push(uint64_t value)
+    {
+        std::vector<unsigned char> bytes;
+        do {
+            bytes.insert(bytes.begin(), uint8_t(value));
+            value >>= 8;
+        } while (value);
+        return Push(bytes);
+    }
+
+    Code& Push(const std::vector<unsigned char>& bytes)
+    {
+        assert(!bytes.empty() && bytes.size() <= 32);
+        m_code.push_back(PUSH1 + bytes.size() - 1);
+        m_code.insert(m_code.end(), bytes.begin(), bytes.end());
+        return *this;
+    }
+
+    //! Push a 16-bit placeholder to be set later with Set, returning its position
+    size_t PushLabel()
+    {
+        m_code.insert(m_code.end(), {PUSH2, 0, 0});
+        return m_code.size() - 2;
+    }
+
+    void Set(size_t pos, uint16_t value)
+    {
+        m_code[pos] = value >> 8;
+        m_code[pos + 1] = value & 0xff;
+    }
+
+    //! Abort the execution if the top of the stack is zero
+    Code& Require()
+    {
+        Op(ISZERO);
+        m_fails.push_back(PushLabel());
+        return Op(JUMPI);
+    }
+
+    //! Add the target of the Require checks, to be placed after the code that can reach it
+    Code& ResolveRequires()
+    {
+        if (m_fails.empty()) return *this;
+        for (const size_t pos : m_fails) Set(pos, m_code.size());
+        m_fails.clear();
+        return Op(JUMPDEST).Op(INVALID);
+    }
+
+    Code& Append(const Code& code, size_t count = 1)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            for (const size_t pos : code.m_fails) m_fails.push_back(m_code.size() + pos);
+            m_code.insert(m_code.end(), code.m_code.begin(), code.m_code.end());
+        }
+        return *this;
+    }
+
+    Code& Data(const std::vector<unsigned char>& data)
+    {
+        m_code.insert(m_code.end(), data.begin(), data.end());
+        return *this;
+    }
+
+    size_t Size() const { return m_code.size(); }
+    const std::vector<unsigned char>& Bytes() const { return m_code; }
+
+private:
+    std::vector<unsigned char> m_code;
+    //! Placeholders of the Require checks
+    std::vector<size_t> m_fails;
+};
+
+/**
+ * Contract running body until less than LOOP_RESERVE gas is left. The
+ * prologue may leave values on the stack for the body, and data is appended
+ * after the code and copied to memory at 0 before the loop starts.
+ */
+std::vector<unsigned char> Loop(const Code& prologue, const Code& body, const std::vector<unsigned char>& data = {})
+{
+    Code code;
+    size_t data_pos{0};
+    if (!data.empty()) {
+        code.Push(data.size());
+        data_pos = code.PushLabel();
+        code.Push(0).Op(CODECOPY);
+    }
+    code.Append(prologue);
+    const size_t loop{code.Size()};
+    code.Op(JUMPDEST).Append(body);
+    code.Push(LOOP_RESERVE).Op(GAS).Op(GT);
+    code.Set(code.PushLabel(), loop);
+    code.Op(JUMPI).Op(STOP).ResolveRequires();
+    if (!data.empty()) {
+        code.Set(data_pos, code.Size());
+        code.Data(data);
+    }
+    return code.Bytes();
+}
+
+//! Call a precompiled contract with the input in memory, failing the run if the call fails
+std::vector<unsigned char> PrecompileLoop(uint8_t address, const std::vector<unsigned char>& input)
+{
+    Code body;
+    body.Push(0).Push(0).Push(input.size()).Push(0).Push(address).Op(GAS).Op(STATICCALL).Require();
+    return Loop({}, body, input);
+}
+
+//! Deploy code that stores 1..count at keys 1..count and has runtime as its code
+std::vector<unsigned char> PopulateCode(uint16_t count, const std::vector<unsigned char>& runtime)
+{
+    Code code;
+    code.Push(count);
+    const size_t loop{code.Size()};
+    code.Op(JUMPDEST).Op(DUP1).Op(DUP1).Op(SSTORE).Push(1).Op(SWAP1).Op(SUB).Op(DUP1);
+    code.Set(code.PushLabel(), loop);
+    code.Op(JUMPI).Op(POP);
+    code.Push(runtime.size()).Op(DUP1);
+    const size_t offset{code.PushLabel()};
+    code.Push(0).Op(CODECOPY).Push(0).Op(RETURN);
+    code.Set(offset, code.Size());
+    code.Data(runtime);
+    return code.Bytes();
+}
+
+struct GasCase {
+    std::string name;
+    std::vector<unsigned char> code;
+    //! Contract to call with the code as data, or a creation if null
+    dev::Address contract;
+};
+
+class Calibration
+{
+public:
+    explicit Calibration(TestChain100Setup& setup) : m_setup(setup)
+    {
+        CMutableTransaction coinbase;
+        coinbase.vout.emplace_back(0, CScript() << OP_DUP << OP_HASH160 << ParseHex("abababababababababababababababababababab") << OP_EQUALVERIFY << OP_CHECKSIG);
+        m_block.vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+        LOCK(::cs_main);
+        Chainstate& chainstate{m_setup.m_node.chainman->ActiveChainstate()};
+        QtumDGP qtumDGP(globalState.get(), chainstate, fGettingValuesDGP);
+        m_block_gas_limit = qtumDGP.getBlockGasLimit(chainstate.m_chain.Height() + 1);
+    }
+
+    uint64_t BlockGasLimit() const { return m_block_gas_limit; }
+
+    ResultExecute Execute(const GasCase& gas_case, uint64_t gas, dev::eth::Permanence permanence)
+    {
+        QtumTransaction tx;
+        if (gas_case.contract == dev::Address{}) {
+            tx = QtumTransaction(0, 1, gas, gas_case.code, 0);
+        } else {
+            tx = QtumTransaction(0, 1, gas, gas_case.contract, gas_case.code, 0);
+        }
+        tx.forceSender(dev::Address("0101010101010101010101010101010101010101"));
+        tx.setHashWith(dev::h256(++m_nonce));
+        tx.setNVout(0);
+        tx.setVersion(VersionVM::GetEVMDefault());
+
+        LOCK(::cs_main);
+        CChain& chain{m_setup.m_node.chainman->ActiveChain()};
+        ByteCodeExec exec(m_block, {tx}, m_block_gas_limit, chain.Tip(), chain);
+        exec.performByteCode(permanence);
+        const ResultExecute result{exec.getResult().at(0)};
+        assert(result.execRes.excepted == dev::eth::TransactionException::None);
+        return result;
+    }
+
+    //! Deploy a contract for good, returning its address
+    dev::Address Deploy(const std::vector<unsigned char>& code)
+    {
+        return Execute({"", code, {}}, m_block_gas_limit, dev::eth::Permanence::Committed).execRes.newAddress;
+    }
+
+private:
+    TestChain100Setup& m_setup;
+    CBlock m_block;
+    uint64_t m_block_gas_limit{0};
+    uint64_t m_nonce{0};
+};
+
+std::vector<unsigned char> Word(const uint256& value)
+{
+    return {value.begin(), value.end()};
+}
+
+std::vector<unsigned char> EcrecoverInput()
+{
+    const CKey key{GenerateRandomKey()};
+    const uint256 hash{GetRandHash()};
+    std::vector<unsigned char> sig;
+    assert(key.SignCompact(hash, sig));
+    // Compact signatures start with 27 + recovery id, plus 4 for compressed keys
+    std::vector<unsigned char> input{Word(hash)};
+    input.resize(64);
+    input[63] = 27 + ((sig[0] - 27) & 3);
+    input.insert(input.end(), sig.begin() + 1, sig.end());
+    return input;
+}
+
+std::vector<unsigned char> ModexpInput(size_t base_size, size_t exp_size, size_t mod_size)
+{
+    std::vector<unsigned char> input;
+    for (const size_t size : {base_size, exp_size, mod_size}) {
+        std::vector<unsigned char> word(32);
+        word[30] = size >> 8;
+        word[31] = size & 0xff;
+        input.insert(input.end(), word.begin(), word.end());
+    }
+    input.resize(input.size() + base_size + exp_size + mod_size, 0xff);
+    return input;
+}
+
+//! The bn254 G1 generator (1, 2)
+std::vector<unsigned char> Bn254G1()
+{
+    return ParseHex("0000000000000000000000000000000000000000000000000000000000000001"
+                    "0000000000000000000000000000000000000000000000000000000000000002");
+}
+
+std::vector<unsigned char> Bn254Pairs(size_t count)
+{
+    // The bn254 G2 generator, imaginary part first
+    const std::vector<unsigned char> g2{ParseHex(
+        "198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c2"
+        "1800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed"
+        "090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b"
+        "12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa")};
+    std::vector<unsigned char> input;
+    for (size_t i = 0; i < count; ++i) {
+        const std::vector<unsigned char> g1{Bn254G1()};
+        input.insert(input.end(), g1.begin(), g1.end());
+        input.insert(input.end(), g2.begin(), g2.end());
+    }
+    return input;
+}
+
+std::vector<unsigned char> Blake2fInput(uint32_t rounds)
+{
+    std::vector<unsigned char> input(213);
+    input[0] = rounds >> 24;
+    input[1] = rounds >> 16;
+    input[2] = rounds >> 8;
+    input[3] = rounds;
+    input[212] = 1;
+    return input;
+}
+
+//! Point evaluation proving f(z) = 0 for the zero polynomial
+std::vector<unsigned char> PointEvaluationInput()
+{
+    std::vector<unsigned char> infinity(48);
+    infinity[0] = 0xc0;
+    std::vector<unsigned char> input(32);
+    CSHA256().Write(infinity.data(), infinity.size()).Finalize(input.data());
+    input[0] = 0x01;
+    std::vector<unsigned char> z(32);
+    z[13] = 17;
+    input.insert(input.end(), z.begin(), z.end());
+    input.resize(input.size() + 32);
+    input.insert(input.end(), infinity.begin(), infinity.end());
+    input.insert(input.end(), infinity.begin(), infinity.end());
+    return input;
+}
+
+std::vector<GasCase> Cases(Calibration& calibration)
+{
+    const std::vector<unsigned char> max_word(32, 0xff);
+    Code big;
+    big.Push(max_word);
+    const auto binary = [&](uint8_t op) {
+        Code body;
+        body.Append(Code{}.Op(DUP1).Op(DUP1).Op(op).Op(POP), 16);
+        return Loop(big, body);
+    };
+    const auto ternary = [&](uint8_t op) {
+        Code body;
+        body.Append(Code{}.Op(DUP1).Op(DUP1).Op(DUP1).Op(op).Op(POP), 16);
+        return Loop(big, body);
+    };
+    // A counter on the stack, starting above the precompiled contracts
+    Code counter;
+    counter.Push(0x10000);
+    const auto per_address = [&](uint8_t op) {
+        Code body;
+        body.Append(Code{}.Op(DUP1).Op(op).Op(POP).Push(1).Op(ADD), 8);
+        return Loop(counter, body);
+    };
+
+    std::vector<GasCase> cases{
+        {"add", binary(ADD), {}},
+        {"mul", binary(MUL), {}},
+        {"div", binary(DIV), {}},
+        {"sdiv", binary(SDIV), {}},
+        {"mod", binary(MOD), {}},
+        {"addmod", ternary(ADDMOD), {}},
+        {"mulmod", ternary(MULMOD), {}},
+        {"exp", binary(EXP), {}},
+        {"sha3_32", Loop({}, Code{}.Append(Code{}.Push(32).Push(0).Op(SHA3).Op(POP), 16)), {}},
+        {"sha3_1024", Loop(Code{}.Push(0).Push(1024 - 32).Op(MSTORE), Code{}.Append(Code{}.Push(1024).Push(0).Op(SHA3).Op(POP), 4)), {}},
+        {"mstore_mload", Loop(big, Code{}.Append(Code{}.Op(DUP1).Push(0).Op(MSTORE).Push(0).Op(MLOAD).Op(POP), 16)), {}},
+        {"log2_32", Loop(big, Code{}.Append(Code{}.Op(DUP1).Op(DUP1).Push(32).Push(0).Op(LOG2), 8)), {}},
+        {"balance_cold", per_address(BALANCE), {}},
+        {"extcodesize_cold", per_address(EXTCODESIZE), {}},
+        {"extcodehash_cold", per_address(EXTCODEHASH), {}},
+        {"call_cold", Loop(counter, Code{}.Append(Code{}.Push(0).Push(0).Push(0).Push(0).Push(0).Op(DUP6).Op(GAS).Op(CALL).Op(POP).Push(1).Op(ADD), 4)), {}},
+        {"sload_warm", Loop({}, Code{}.Append(Code{}.Push(1).Op(SLOAD).Op(POP), 16)), {}},
+        {"sstore_new", Loop(Code{}.Push(1), Code{}.Append(Code{}.Op(DUP1).Op(DUP1).Op(SSTORE).Push(1).Op(ADD), 4)), {}},
+    };
+
+    // Reads and updates of storage written by an earlier block go through the
+    // state database rather than the account cache
+    constexpr uint16_t stored_keys{1500};
+    Code read;
+    read.Append(Code{}.Op(DUP1).Op(SLOAD).Op(POP).Push(1).Op(ADD), 4);
+    const dev::Address reader{calibration.Deploy(PopulateCode(stored_keys, Loop(Code{}.Push(1), read)))};
+    cases.push_back({"sload_cold", {}, reader});
+    Code update;
+    update.Append(Code{}.Op(DUP1).Op(DUP1).Push(1).Op(ADD).Op(SWAP1).Op(SSTORE).Push(1).Op(ADD), 4);
+    const dev::Address updater{calibration.Deploy(PopulateCode(stored_keys, Loop(Code{}.Push(1), update)))};
+    cases.push_back({"sstore_update", {}, updater});
+
+    cases.push_back({"ecrecover", PrecompileLoop(0x01, EcrecoverInput()), {}});
+    cases.push_back({"sha256_32", PrecompileLoop(0x02, std::vector<unsigned char>(32)), {}});
+    cases.push_back({"sha256_4096", PrecompileLoop(0x02, std::vector<unsigned char>(4096)), {}});
+    cases.push_back({"ripemd160_4096", PrecompileLoop(0x03, std::vector<unsigned char>(4096)), {}});
+    cases.push_back({"identity_4096", PrecompileLoop(0x04, std::vector<unsigned char>(4096)), {}});
+    cases.push_back({"modexp_32", PrecompileLoop(0x05, ModexpInput(32, 32, 32)), {}});
+    cases.push_back({"modexp_128", PrecompileLoop(0x05, ModexpInput(128, 32, 128)), {}});
+    std::vector<unsigned char> bn254_add{Bn254G1()};
+    bn254_add.insert(bn254_add.end(), bn254_add.begin(), bn254_add.end());
+    cases.push_back({"bn254_add", PrecompileLoop(0x06, bn254_add), {}});
+    std::vector<unsigned char> bn254_mul{Bn254G1()};
+    bn254_mul.insert(bn254_mul.end(), max_word.begin(), max_word.end());
+    cases.push_back({"bn254_mul", PrecompileLoop(0x07, bn254_mul), {}});
+    cases.push_back({"bn254_pairing_1", PrecompileLoop(0x08, Bn254Pairs(1)), {}});
+    cases.push_back({"bn254_pairing_4", PrecompileLoop(0x08, Bn254Pairs(4)), {}});
+    cases.push_back({"blake2f_12", PrecompileLoop(0x09, Blake2fInput(12)), {}});
+    cases.push_back({"blake2f_10000", PrecompileLoop(0x09, Blake2fInput(10000)), {}});
+    cases.push_back({"point_evaluation", PrecompileLoop(0x0a, PointEvaluationInput()), {}});
+    cases.push_back({"bls12_map_fp_to_g1", PrecompileLoop(0x10, std::vector<unsigned char>(64)), {}});
+    return cases;
+}
+
+void EvmGasCalibration(benchmark::Bench& bench)
+{
+    const auto setup{MakeNoLogFileContext<TestChain100Setup>()};
+    Calibration calibration{*setup};
+    const int64_t interval{CChainParams::Main()->GetConsensus().TargetSpacing(setup->m_node.chainman->ActiveHeight() + 1)};
+    // Time a full block may take for each unit of gas
+    const double budget{double(interval) / calibration.BlockGasLimit()};
+
+    std::vector<std::pair<std::string, uint64_t>> gas_used;
+    for (const GasCase& gas_case : Cases(calibration)) {
+        // Cases are priced by the gas their loop uses, not by the gas given
+        const uint64_t gas{uint64_t(calibration.Execute(gas_case, CASE_GAS, dev::eth::Permanence::Reverted).execRes.gasUsed)};
+        gas_used.emplace_back(gas_case.name, gas);
+        bench.batch(gas).unit("gas").run(gas_case.name, [&] {
+            calibration.Execute(gas_case, CASE_GAS, dev::eth::Permanence::Reverted);
+        });
+    }
+
+    if (!bench.output()) return;
+    *bench.output() << strprintf("\nBudget: %.2f ns/gas (%d s block interval, %u block gas limit)\n", budget * 1e9, interval, calibration.BlockGasLimit());
+    for (size_t i = 0; i < bench.results().size() && i < gas_used.size(); ++i) {
+        const double per_gas{bench.results()[i].median(ankerl::nanobench::Result::Measure::elapsed)};
+        *bench.output() << strprintf("%-20s %9.2f ns/gas %8.1f ms/block%s\n", gas_used[i].first, per_gas * 1e9,
+                                     per_gas * calibration.BlockGasLimit() * 1e3, per_gas > budget ? "  OVER BUDGET" : "");
+    }
+}
+
+} // namespace
+
+BENCHMARK(EvmGasCalibration, benchmark::PriorityLevel::LOW);
@@ -0,0 +1,75 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <kernel/cs_main.h>
+#include <node/mempool_persist.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <util/fs.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+static constexpr int MEMPOOL_LOAD_TXS{150};
+
+/**
+ * Restore a mempool.dat of MEMPOOL_LOAD_TXS signed transactions, either
+ * re-verifying every script or trusting the results stored for the tip.
+ */
+static void MempoolLoad(benchmark::Bench& bench, bool use_restore_witness)
+{
+    const auto testing_setup{MakeNoLogFileContext<TestChain100Setup>(ChainType::UNITTEST, {.extra_args = {"-persistmempoolwitness=1"}})};
+    CTxMemPool& pool{*testing_setup->m_node.mempool};
+    Chainstate& chainstate{testing_setup->m_node.chainman->ActiveChainstate()};
+    const CScript spk{CScript() << ToByteVector(testing_setup->coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+
+    // Split the only mature coinbase into as many confirmed outputs
+    std::vector<CTxOut> outputs(MEMPOOL_LOAD_TXS, CTxOut{100 * COIN, spk});
+    const CTransactionRef fanout{MakeTransactionRef(testing_setup->CreateValidMempoolTransaction(
+        {testing_setup->m_coinbase_txns[0]}, {COutPoint{testing_setup->m_coinbase_txns[0]->GetHash(), 0}},
+        /*input_height=*/0, {testing_setup->coinbaseKey}, outputs, /*submit=*/false))};
+    testing_setup->CreateAndProcessBlock({CMutableTransaction{*fanout}}, spk);
+
+    std::vector<CTransactionRef> txs;
+    for (int i = 0; i < MEMPOOL_LOAD_TXS; ++i) {
+        txs.push_back(MakeTransactionRef(testing_setup->CreateValidMempoolTransaction(
+            fanout, i, /*input_height=*/0, testing_setup->coinbaseKey, spk, 99 * COIN)));
+    }
+    assert(pool.size() == txs.size());
+
+    const fs::path path{testing_setup->m_path_root / "mempool_load.dat"};
+    const bool dumped{node::DumpMempool(pool, path, fsbridge::fopen, /*skip_file_commit=*/true, &chainstate)};
+    assert(dumped);
+
+    bench.unit("tx").batch(txs.size()).run([&] {
+        {
+            LOCK(pool.cs);
+            for (const auto& tx : txs) {
+                pool.removeRecursive(*tx, MemPoolRemovalReason::REPLACED);
+            }
+        }
+        node::LoadMempool(pool, path, chainstate, {.use_restore_witness = use_restore_witness});
+        assert(pool.size() == txs.size());
+    });
+    fs::remove(path);
+}
+
+static void MempoolLoadFull(benchmark::Bench& bench)
+{
+    MempoolLoad(bench, /*use_restore_witness=*/false);
+}
+
+static void MempoolLoadWitness(benchmark::Bench& bench)
+{
+    MempoolLoad(bench, /*use_restore_witness=*/true);
+}
+
+BENCHMARK(MempoolLoadFull, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolLoadWitness, benchmark::PriorityLevel::HIGH);
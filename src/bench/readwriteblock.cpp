@@ -50,6 +50,19 @@ static void ReadBlockBench(benchmark::Bench& bench)
     });
 }
 
+static void ReadBlockArenaBench(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, {.extra_args = {"-blockarena"}})};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    assert(blockman.UseBlockArena());
+    const auto pos{blockman.WriteBlock(CreateTestBlock(), 413'567)};
+    CBlock block;
+    bench.run([&] {
+        const auto success{blockman.ReadBlock(block, pos)};
+        assert(success);
+    });
+}
+
 static void ReadRawBlockBench(benchmark::Bench& bench)
 {
     const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
@@ -65,4 +78,5 @@ static void ReadRawBlockBench(benchmark::Bench& bench)
 
 BENCHMARK(SaveBlockBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadBlockBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadBlockArenaBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadRawBlockBench, benchmark::PriorityLevel::HIGH);
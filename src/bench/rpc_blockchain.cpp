@@ -5,20 +5,26 @@
 #include <bench/bench.h>
 #include <bench/data/blockbench.raw.h>
 #include <chain.h>
+#include <common/json_stream.h>
 #include <core_io.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
+#include <rpc/response_cache.h>
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
 #include <uint256.h>
 #include <univalue.h>
+#include <util/string.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -43,6 +49,9 @@ struct TestBlockAndIndex {
     }
 };
 
+//! Thrown by a sink to stop serializing once the first byte of the reply is ready
+struct FirstByte {};
+
 } // namespace
 
 static void BlockToJsonVerbose(benchmark::Bench& bench)
@@ -69,3 +78,68 @@ static void BlockToJsonVerboseWrite(benchmark::Bench& bench)
 }
 
 BENCHMARK(BlockToJsonVerboseWrite, benchmark::PriorityLevel::HIGH);
+
+/** Time until the first byte of the reply when the block is built as a tree first */
+static void BlockToJsonVerboseFirstByte(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    bench.run([&] {
+        const UniValue univalue{blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit)};
+        JSONStreamWriter writer{[](std::string_view, bool) { throw FirstByte{}; }};
+        try {
+            writer.Value(univalue);
+            writer.Finish();
+        } catch (const FirstByte&) {
+        }
+    });
+}
+
+BENCHMARK(BlockToJsonVerboseFirstByte, benchmark::PriorityLevel::HIGH);
+
+static void BlockToJsonVerboseStream(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    size_t max_part{0};
+    bench.run([&] {
+        JSONStreamWriter writer{[&](std::string_view part, bool) {
+            max_part = std::max(max_part, part.size());
+            ankerl::nanobench::doNotOptimizeAway(part);
+        }};
+        blockToJSONStream(writer, data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit);
+        writer.Finish();
+    });
+
+    // Peak memory of the reply: the whole tree plus one output part when it
+    // is built first, but only one transaction and one output part when it
+    // is streamed.
+    const UniValue univalue{blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit)};
+    size_t max_tx{0};
+    for (const UniValue& tx : univalue["tx"].getValues()) max_tx = std::max(max_tx, UniValueUsage(tx));
+    const size_t tree_peak{UniValueUsage(univalue) + max_part};
+    const size_t stream_peak{max_tx + max_part};
+    bench.context("tree_peak_bytes", util::ToString(tree_peak));
+    bench.context("stream_peak_bytes", util::ToString(stream_peak));
+    assert(max_part < 2 * JSONStreamWriter::DEFAULT_FLUSH_BYTES);
+    assert(stream_peak * 10 < tree_peak);
+}
+
+BENCHMARK(BlockToJsonVerboseStream, benchmark::PriorityLevel::HIGH);
+
+/** Time until the first byte of the reply when the block is streamed */
+static void BlockToJsonVerboseStreamFirstByte(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    bench.run([&] {
+        JSONStreamWriter writer{[](std::string_view, bool) { throw FirstByte{}; }};
+        try {
+            blockToJSONStream(writer, data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit);
+            writer.Finish();
+        } catch (const FirstByte&) {
+        }
+    });
+}
+
+BENCHMARK(BlockToJsonVerboseStreamFirstByte, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,86 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <rpc/request.h>
+#include <rpc/response_cache.h>
+#include <rpc/server.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+#include <util/check.h>
+#include <validation.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+/**
+ * Requests of a block explorer paging through old blocks: every block is
+ * fetched with its header and its coinbase transaction, and the same pages
+ * are requested again by other visitors. Served from disk every time, and
+ * from the RPC response cache.
+ */
+namespace {
+
+constexpr int EXPLORER_BLOCKS{50};
+
+struct ExplorerTraffic {
+    std::unique_ptr<TestChain100Setup> setup{MakeNoLogFileContext<TestChain100Setup>()};
+    std::vector<JSONRPCRequest> requests;
+
+    ExplorerTraffic()
+    {
+        if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+        LOCK(::cs_main);
+        const CChain& chain{Assert(setup->m_node.chainman)->ActiveChain()};
+        for (int height = 1; height <= EXPLORER_BLOCKS; ++height) {
+            const std::string hash{chain[height]->GetBlockHash().GetHex()};
+            const std::string txid{setup->m_coinbase_txns.at(height - 1)->GetHash().GetHex()};
+            Add("getblock", {hash, 2});
+            Add("getblockheader", {hash, true});
+            Add("getrawtransaction", {txid, 1, hash});
+        }
+    }
+
+    void Add(const std::string& method, const std::vector<UniValue>& params)
+    {
+        JSONRPCRequest request;
+        request.context = &setup->m_node;
+        request.strMethod = method;
+        request.params = UniValue{UniValue::VARR};
+        for (const UniValue& param : params) request.params.push_back(param);
+        requests.push_back(std::move(request));
+    }
+
+    void Replay()
+    {
+        for (const JSONRPCRequest& request : requests) {
+            UniValue result{tableRPC.execute(request)};
+            ankerl::nanobench::doNotOptimizeAway(result);
+        }
+    }
+};
+
+} // namespace
+
+static void RPCExplorerTrafficCold(benchmark::Bench& bench)
+{
+    ExplorerTraffic traffic;
+    bench.unit("request").batch(traffic.requests.size()).run([&] { traffic.Replay(); });
+}
+
+static void RPCExplorerTrafficCached(benchmark::Bench& bench)
+{
+    ExplorerTraffic traffic;
+    g_rpc_response_cache = std::make_unique<RPCResponseCache>(/*max_bytes=*/size_t{64} << 20, /*depth=*/10);
+    traffic.Replay();
+    assert(g_rpc_response_cache->GetStats().entries == traffic.requests.size());
+    bench.unit("request").batch(traffic.requests.size()).run([&] { traffic.Replay(); });
+    g_rpc_response_cache.reset();
+}
+
+BENCHMARK(RPCExplorerTrafficCold, benchmark::PriorityLevel::HIGH);
+BENCHMARK(RPCExplorerTrafficCached, benchmark::PriorityLevel::HIGH);
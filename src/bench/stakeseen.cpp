@@ -0,0 +1,59 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <node/stakeseen.h>
+#include <primitives/transaction.h>
+#include <random.h>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+//! Blocks kept behind the tip, about a mainnet checkpoint span
+static constexpr int WINDOW{2000};
+
+static std::vector<COutPoint> RandomStakes(size_t count)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<COutPoint> stakes;
+    stakes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        stakes.emplace_back(Txid::FromUint256(rng.rand256()), rng.randbits(2));
+    }
+    return stakes;
+}
+
+/** Connect a block: remember its stake, advance the window and look up a header */
+static void StakeSeenConnect(benchmark::Bench& bench)
+{
+    const std::vector<COutPoint> stakes{RandomStakes(1 << 16)};
+    node::StakeSeenCache cache;
+    int height{0};
+    bench.run([&] {
+        const COutPoint& stake{stakes[height % stakes.size()]};
+        cache.Insert(stake, height * 16, height);
+        cache.SetMinHeight(height - WINDOW);
+        ankerl::nanobench::doNotOptimizeAway(cache.Contains(stake, height * 16 + 16));
+        ++height;
+    });
+}
+
+/** Rebuild the cache from the block index of a long chain at startup */
+static void StakeSeenLoad(benchmark::Bench& bench)
+{
+    const std::vector<COutPoint> stakes{RandomStakes(200000)};
+    const int min_height{static_cast<int>(stakes.size()) - WINDOW};
+    bench.batch(stakes.size()).unit("block").run([&] {
+        node::StakeSeenCache cache;
+        cache.SetMinHeight(min_height);
+        for (size_t height = 0; height < stakes.size(); ++height) {
+            cache.Insert(stakes[height], height * 16, height);
+        }
+        assert(cache.Size() == WINDOW);
+    });
+}
+
+BENCHMARK(StakeSeenConnect, benchmark::PriorityLevel::HIGH);
+BENCHMARK(StakeSeenLoad, benchmark::PriorityLevel::HIGH);
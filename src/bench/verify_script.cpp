@@ -66,6 +66,33 @@ static void VerifyScriptBench(benchmark::Bench& bench)
     });
 }
 
+// Legacy signature hashes of every input of a consolidation transaction
+// spending many P2PKH outputs, with and without the precomputed data shared
+// by the inputs of a transaction during validation.
+static void LegacySighashManyInputs(benchmark::Bench& bench, bool precompute)
+{
+    constexpr unsigned int INPUTS{500};
+    const CScript scriptCode = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0xab) << OP_EQUALVERIFY << OP_CHECKSIG;
+    CMutableTransaction tx;
+    for (unsigned int i = 0; i < INPUTS; ++i) {
+        // Signed inputs: a 72-byte signature and a 33-byte public key
+        tx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256{uint8_t(i)}), i}, CScript() << std::vector<unsigned char>(72) << std::vector<unsigned char>(33));
+    }
+    tx.vout.emplace_back(1, scriptCode);
+    const CTransaction txTo{tx};
+
+    bench.unit("input").batch(INPUTS).run([&] {
+        PrecomputedTransactionData txdata;
+        if (precompute) txdata.Init(txTo, {});
+        for (unsigned int i = 0; i < INPUTS; ++i) {
+            ankerl::nanobench::doNotOptimizeAway(SignatureHash(scriptCode, txTo, i, SIGHASH_ALL, 0, SigVersion::BASE, &txdata));
+        }
+    });
+}
+
+static void LegacySighashManyInputsUncached(benchmark::Bench& bench) { LegacySighashManyInputs(bench, /*precompute=*/false); }
+static void LegacySighashManyInputsCached(benchmark::Bench& bench) { LegacySighashManyInputs(bench, /*precompute=*/true); }
+
 static void VerifyNestedIfScript(benchmark::Bench& bench)
 {
     std::vector<std::vector<unsigned char>> stack;
@@ -88,4 +115,6 @@ static void VerifyNestedIfScript(benchmark::Bench& bench)
 }
 
 BENCHMARK(VerifyScriptBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(LegacySighashManyInputsUncached, benchmark::PriorityLevel::HIGH);
+BENCHMARK(LegacySighashManyInputsCached, benchmark::PriorityLevel::HIGH);
 BENCHMARK(VerifyNestedIfScript, benchmark::PriorityLevel::HIGH);
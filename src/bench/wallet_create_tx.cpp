@@ -60,7 +60,8 @@ TipBlock getTip(const CChainParams& params, const node::NodeContext& context)
 void generateFakeBlock(const CChainParams& params,
                        const node::NodeContext& context,
                        CWallet& wallet,
-                       const CScript& coinbase_out_script)
+                       const CScript& coinbase_out_script,
+                       unsigned int foreign_outputs = 0)
 {
     TipBlock tip{getTip(params, context)};
 
@@ -75,6 +76,8 @@ void generateFakeBlock(const CChainParams& params,
     coinbase_tx.vin[0].scriptSig = CScript() << ++tip.tip_height << OP_0;
     coinbase_tx.vout[1].scriptPubKey = coinbase_out_script; // extra output
     coinbase_tx.vout[1].nValue = 1 * COIN;
+    // outputs the wallet does not own, which only make its history larger
+    coinbase_tx.vout.resize(2 + foreign_outputs, CTxOut(1 * COIN, CScript() << OP_TRUE));
     block.vtx = {MakeTransactionRef(std::move(coinbase_tx))};
 
     block.nVersion = VERSIONBITS_LAST_OLD_BLOCK_VERSION;
@@ -160,7 +163,7 @@ static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type
     });
 }
 
-static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType>& output_type)
+static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType>& output_type, unsigned int foreign_outputs = 0)
 {
     const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
     // Set clock to genesis block, so the descriptors/keys creation time don't interfere with the blocks scanning process.
@@ -184,7 +187,7 @@ static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType
     unsigned int chain_size = 3000;
     for (unsigned int i = 0; i < chain_size / dest_wallet.size(); ++i) {
         for (const auto& dest : dest_wallet) {
-            generateFakeBlock(params, test_setup->m_node, wallet, dest);
+            generateFakeBlock(params, test_setup->m_node, wallet, dest, foreign_outputs);
         }
     }
 
@@ -207,7 +210,9 @@ static void WalletCreateTxUsePresetInputsAndCoinSelection(benchmark::Bench& benc
                                                                                                     {{/*num_of_internal_inputs=*/4}}); }
 
 static void WalletAvailableCoins(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32M}); }
+static void WalletAvailableCoinsLargeHistory(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32M}, /*foreign_outputs=*/50); }
 
 BENCHMARK(WalletCreateTxUseOnlyPresetInputs, benchmark::PriorityLevel::LOW)
 BENCHMARK(WalletCreateTxUsePresetInputsAndCoinSelection, benchmark::PriorityLevel::LOW)
 BENCHMARK(WalletAvailableCoins, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletAvailableCoinsLargeHistory, benchmark::PriorityLevel::LOW);
@@ -0,0 +1,230 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// The wattx-evm-indexer executable shows how an embedded indexer can read
+// contract state and execution results straight from a data directory through
+// the kernel, instead of polling JSON-RPC.
+//
+// It loads the chainstate of DATADIR, prints the receipts and logs of the
+// blocks from -startheight to the tip and the storage of -contract at the tip,
+// then connects hex-encoded blocks read from standard input and prints their
+// receipts as they are connected.
+//
+// The data directory must belong to a node that was run with -logevents, and
+// the node must be stopped: the databases can only be opened by one process.
+//
+// DEVELOPER NOTE: Since this is a "demo-only", experimental, etc. executable,
+//                 it may diverge from Bitcoin Core's coding style.
+//
+// It is part of the libbitcoinkernel project.
+
+#include <kernel/chainparams.h>
+#include <kernel/chainstatemanager_opts.h>
+#include <kernel/checks.h>
+#include <kernel/context.h>
+#include <kernel/evmstate.h>
+#include <kernel/warning.h>
+
+#include <chainparams.h>
+#include <chainparamsbase.h>
+#include <common/args.h>
+#include <consensus/validation.h>
+#include <core_io.h>
+#include <kernel/caches.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <node/chainstate.h>
+#include <util/fs.h>
+#include <util/signalinterrupt.h>
+#include <util/strencodings.h>
+#include <util/task_runner.h>
+#include <util/translation.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+
+static void PrintReceipts(const CBlockIndex& index, const std::vector<kernel::ContractReceipt>& receipts)
+{
+    for (const kernel::ContractReceipt& receipt : receipts) {
+        std::cout << index.nHeight << " " << receipt.tx_hash.GetHex() << ":" << receipt.output_index
+                  << " from=" << HexStr(receipt.from) << " to=" << HexStr(receipt.to)
+                  << " contract=" << HexStr(receipt.contract_address)
+                  << " gas=" << receipt.gas_used << " excepted=" << receipt.excepted << std::endl;
+        for (const kernel::ContractLog& log : receipt.logs) {
+            std::cout << "\tlog address=" << HexStr(log.address);
+            for (const uint256& topic : log.topics) {
+                std::cout << " topic=" << HexStr(topic);
+            }
+            std::cout << " data=" << HexStr(log.data) << std::endl;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    LogInstance().DisableLogging();
+
+    // SETUP: Argument parsing and handling
+    ArgsManager& args{gArgs};
+    SetupChainParamsBaseOptions(args);
+    args.AddArg("-datadir=<dir>", "Data directory of a stopped node that ran with -logevents", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    args.AddArg("-addrindex", "Set if the node ran with -addrindex", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    args.AddArg("-startheight=<n>", "Print the receipts of the blocks from this height to the tip (default: tip)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    args.AddArg("-contract=<address>", "Print the storage of this contract at the tip", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    std::string error;
+    if (!args.ParseParameters(argc, argv, error) || !args.IsArgSet("-datadir")) {
+        std::cerr
+            << (error.empty() ? "" : error + "\n")
+            << "Usage: " << argv[0] << " -datadir=DATADIR [-chain=CHAIN] [-addrindex] [-startheight=N] [-contract=ADDRESS]" << std::endl
+            << "Print the contract receipts and state of DATADIR, and process hex-encoded blocks on standard input." << std::endl
+            << std::endl
+            << "IMPORTANT: THIS EXECUTABLE IS EXPERIMENTAL, FOR TESTING ONLY, AND EXPECTED TO" << std::endl
+            << "           BREAK IN FUTURE VERSIONS. DO NOT USE ON YOUR ACTUAL DATADIR." << std::endl;
+        return 1;
+    }
+    if (!CheckDataDirOption(args)) {
+        std::cerr << "Data directory " << args.GetArg("-datadir", "") << " does not exist." << std::endl;
+        return 1;
+    }
+    // The contract state and receipts are opened relative to the network
+    // data directory of the arguments
+    SelectParams(args.GetChainType());
+    const fs::path abs_datadir{args.GetDataDirNet()};
+
+    // SETUP: Context
+    kernel::Context kernel_context{};
+    assert(kernel::SanityChecks(kernel_context));
+
+    ValidationSignals validation_signals{std::make_unique<util::ImmediateTaskRunner>()};
+
+    class KernelNotifications : public kernel::Notifications
+    {
+    public:
+        kernel::InterruptResult blockTip(SynchronizationState, CBlockIndex&) override { return {}; }
+        void headerTip(SynchronizationState, int64_t, int64_t, bool) override {}
+        void progress(const bilingual_str&, int, bool) override {}
+        void warningSet(kernel::Warning, const bilingual_str&) override {}
+        void warningUnset(kernel::Warning) override {}
+        void flushError(const bilingual_str& message) override
+        {
+            std::cerr << "Error flushing block data to disk: " << message.original << std::endl;
+        }
+        void fatalError(const bilingual_str& message) override
+        {
+            std::cerr << "Error: " << message.original << std::endl;
+        }
+    };
+    auto notifications = std::make_unique<KernelNotifications>();
+
+    kernel::CacheSizes cache_sizes{DEFAULT_KERNEL_CACHE};
+
+    // SETUP: Chainstate
+    const ChainstateManager::Options chainman_opts{
+        .chainparams = Params(),
+        .datadir = abs_datadir,
+        .notifications = *notifications,
+        .signals = &validation_signals,
+    };
+    const node::BlockManager::Options blockman_opts{
+        .chainparams = chainman_opts.chainparams,
+        .blocks_dir = abs_datadir / "blocks",
+        .notifications = chainman_opts.notifications,
+        .block_tree_db_params = DBParams{
+            .path = abs_datadir / "blocks" / "index",
+            .cache_bytes = cache_sizes.block_tree_db,
+        },
+    };
+    util::SignalInterrupt interrupt;
+    ChainstateManager chainman{interrupt, chainman_opts, blockman_opts};
+
+    node::ChainstateLoadOptions options;
+    // Loading without -logevents would erase the stored receipts
+    options.logevents = true;
+    options.addrindex = args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX);
+    auto [status, load_error] = node::LoadChainstate(chainman, cache_sizes, options);
+    if (status != node::ChainstateLoadStatus::SUCCESS) {
+        std::cerr << "Failed to load Chain state from your datadir: " << load_error.original << std::endl;
+        goto epilogue;
+    }
+
+    // Main program logic starts here
+    {
+        LOCK(cs_main);
+        const CChain& chain{chainman.ActiveChain()};
+        const CBlockIndex* tip{chain.Tip()};
+        if (!tip) goto epilogue;
+        for (int height = args.GetIntArg("-startheight", tip->nHeight); height <= tip->nHeight; ++height) {
+            const CBlockIndex* index{chain[std::max(height, 0)]};
+            CBlock block;
+            if (!chainman.m_blockman.ReadBlock(block, *index)) {
+                std::cerr << "Failed to read block " << index->nHeight << std::endl;
+                goto epilogue;
+            }
+            PrintReceipts(*index, kernel::GetBlockReceipts(block));
+        }
+
+        if (args.IsArgSet("-contract")) {
+            const std::optional<std::vector<unsigned char>> address{TryParseHex<unsigned char>(args.GetArg("-contract", ""))};
+            if (!address || address->size() != uint160::size()) {
+                std::cerr << "Invalid contract address" << std::endl;
+                goto epilogue;
+            }
+            const uint160 contract{*address};
+            const kernel::EvmStateView view{*tip};
+            std::cout << "contract " << HexStr(contract) << " at " << tip->nHeight
+                      << " balance=" << view.Balance(contract) << " code=" << view.Code(contract).size() << " bytes" << std::endl;
+            for (const auto& [key, value] : view.Storage(contract)) {
+                std::cout << "\t" << HexStr(key) << " = " << HexStr(value) << std::endl;
+            }
+        }
+    }
+
+    {
+        auto subscriber = std::make_shared<kernel::EvmBlockSubscriber>(
+            [](const CBlock&, const CBlockIndex& index, const std::vector<kernel::ContractReceipt>& receipts) {
+                std::cout << "connected " << index.nHeight << " " << index.GetBlockHash().GetHex() << std::endl;
+                PrintReceipts(index, receipts);
+            },
+            [](const CBlock&, const CBlockIndex& index, const std::vector<kernel::ContractReceipt>&) {
+                std::cout << "disconnected " << index.nHeight << " " << index.GetBlockHash().GetHex() << std::endl;
+            });
+        validation_signals.RegisterSharedValidationInterface(subscriber);
+        for (std::string line; std::getline(std::cin, line) && !line.empty();) {
+            auto block = std::make_shared<CBlock>();
+            if (!DecodeHexBlk(*block, line)) {
+                std::cerr << "Block decode failed" << std::endl;
+                break;
+            }
+            {
+                LOCK(cs_main);
+                const CBlockIndex* pindex = chainman.m_blockman.LookupBlockIndex(block->hashPrevBlock);
+                if (pindex) {
+                    chainman.UpdateUncommittedBlockStructures(*block, pindex);
+                }
+            }
+            chainman.ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/nullptr);
+        }
+        validation_signals.UnregisterSharedValidationInterface(subscriber);
+    }
+
+epilogue:
+    // Without this precise shutdown sequence, there will be a lot of nullptr
+    // dereferencing and UB.
+    validation_signals.FlushBackgroundCallbacks();
+    {
+        LOCK(cs_main);
+        for (Chainstate* chainstate : chainman.GetAll()) {
+            if (chainstate->CanFlushToDisk()) {
+                chainstate->ForceFlushStateToDisk();
+                chainstate->ResetCoinsViews();
+            }
+        }
+    }
+}
@@ -0,0 +1,214 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockorphanage.h>
+
+#include <logging.h>
+#include <serialize.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <cassert>
+
+BlockOrphanage::BlockOrphanage(size_t max_usage, size_t max_peer_usage)
+    : m_max_usage{max_usage}, m_max_peer_usage{std::min(max_usage, max_peer_usage)} {}
+
+bool BlockOrphanage::AddBlock(const std::shared_ptr<const CBlock>& block, NodeId peer)
+{
+    LOCK(m_mutex);
+    const uint256 hash = block->GetHash();
+    if (m_orphans.count(hash)) {
+        return false;
+    }
+    const size_t usage = GetSerializeSize(TX_WITH_WITNESS(*block));
+    if (usage > m_max_peer_usage) {
+        LogDebug(BCLog::NET, "ignoring large orphan block %s (size: %u) from peer=%d\n", hash.ToString(), usage, peer);
+        return false;
+    }
+
+    const NodeSeconds now{Now<NodeSeconds>()};
+    ExpireInternal(now);
+
+    // Make room within the peer quota from the peer's own orphans
+    while (m_peer_orphan_info.count(peer) && m_peer_orphan_info[peer].m_total_usage + usage > m_max_peer_usage) {
+        EraseOldest(peer);
+    }
+    auto& peer_info = m_peer_orphan_info[peer];
+
+    const uint64_t sequence{m_sequence++};
+    m_orphans.emplace(hash, OrphanBlock{block, peer, now, sequence, usage});
+    m_by_prev.emplace(block->hashPrevBlock, hash);
+    if (block->IsProofOfStake()) {
+        ++m_stakes[{block->prevoutStake, block->nTime}];
+    }
+    m_by_age.emplace(sequence, hash);
+    peer_info.m_by_age.emplace(sequence, hash);
+    peer_info.m_total_usage += usage;
+    m_total_usage += usage;
+
+    // Make room in the pool from the peer using the most
+    while (m_total_usage > m_max_usage) {
+        const auto heaviest = std::max_element(m_peer_orphan_info.begin(), m_peer_orphan_info.end(),
+            [](const auto& a, const auto& b) { return a.second.m_total_usage < b.second.m_total_usage; });
+        EraseOldest(heaviest->first);
+    }
+
+    LogDebug(BCLog::NET, "stored orphan block %s from peer=%d, size: %u (%u orphans, %u bytes)\n",
+             hash.ToString(), peer, usage, m_orphans.size(), m_total_usage);
+    return m_orphans.count(hash) > 0;
+}
+
+bool BlockOrphanage::HaveBlock(const uint256& hash) const
+{
+    LOCK(m_mutex);
+    return m_orphans.count(hash) > 0;
+}
+
+bool BlockOrphanage::HaveChild(const uint256& hash) const
+{
+    LOCK(m_mutex);
+    return m_by_prev.count(hash) > 0;
+}
+
+bool BlockOrphanage::HaveStake(const COutPoint& prevout, uint32_t time) const
+{
+    LOCK(m_mutex);
+    return m_stakes.count({prevout, time}) > 0;
+}
+
+std::vector<std::pair<std::shared_ptr<const CBlock>, NodeId>> BlockOrphanage::ExtractChildren(const uint256& hash)
+{
+    LOCK(m_mutex);
+    std::vector<std::pair<uint64_t, uint256>> children;
+    auto [begin, end] = m_by_prev.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        children.emplace_back(m_orphans.at(it->second).sequence, it->second);
+    }
+    std::sort(children.begin(), children.end());
+
+    std::vector<std::pair<std::shared_ptr<const CBlock>, NodeId>> ret;
+    ret.reserve(children.size());
+    for (const auto& [sequence, child] : children) {
+        auto it = m_orphans.find(child);
+        ret.emplace_back(it->second.block, it->second.peer);
+        EraseBlock(it);
+    }
+    return ret;
+}
+
+void BlockOrphanage::EraseForPeer(NodeId peer)
+{
+    LOCK(m_mutex);
+    auto it = m_peer_orphan_info.find(peer);
+    if (it == m_peer_orphan_info.end()) return;
+    const size_t count = it->second.m_by_age.size();
+    while (m_peer_orphan_info.count(peer)) {
+        EraseOldest(peer);
+    }
+    if (count > 0) LogDebug(BCLog::NET, "Erased %d orphan block(s) from peer=%d\n", count, peer);
+}
+
+void BlockOrphanage::Expire()
+{
+    LOCK(m_mutex);
+    ExpireInternal(Now<NodeSeconds>());
+}
+
+size_t BlockOrphanage::Size() const
+{
+    LOCK(m_mutex);
+    return m_orphans.size();
+}
+
+size_t BlockOrphanage::TotalUsage() const
+{
+    LOCK(m_mutex);
+    return m_total_usage;
+}
+
+size_t BlockOrphanage::UsageByPeer(NodeId peer) const
+{
+    LOCK(m_mutex);
+    auto it = m_peer_orphan_info.find(peer);
+    return it == m_peer_orphan_info.end() ? 0 : it->second.m_total_usage;
+}
+
+void BlockOrphanage::SanityCheck() const
+{
+    LOCK(m_mutex);
+    size_t total_usage{0};
+    std::map<NodeId, size_t> peer_usage;
+    std::map<Stake, int> stakes;
+    for (const auto& [hash, orphan] : m_orphans) {
+        total_usage += orphan.usage;
+        peer_usage[orphan.peer] += orphan.usage;
+        if (orphan.block->IsProofOfStake()) ++stakes[{orphan.block->prevoutStake, orphan.block->nTime}];
+        assert(orphan.sequence < m_sequence);
+        assert(m_by_age.count({orphan.sequence, hash}));
+        assert(m_peer_orphan_info.at(orphan.peer).m_by_age.count({orphan.sequence, hash}));
+    }
+    assert(total_usage == m_total_usage);
+    assert(total_usage <= m_max_usage);
+    assert(m_by_age.size() == m_orphans.size());
+    assert(m_by_prev.size() == m_orphans.size());
+    assert(stakes == m_stakes);
+    assert(peer_usage.size() == m_peer_orphan_info.size());
+    for (const auto& [peer, info] : m_peer_orphan_info) {
+        assert(info.m_total_usage == peer_usage.at(peer));
+        assert(info.m_total_usage <= m_max_peer_usage);
+    }
+}
+
+void BlockOrphanage::EraseBlock(std::map<uint256, OrphanBlock>::iterator it)
+{
+    AssertLockHeld(m_mutex);
+    const uint256& hash = it->first;
+    const OrphanBlock& orphan = it->second;
+
+    auto [begin, end] = m_by_prev.equal_range(orphan.block->hashPrevBlock);
+    for (auto prev_it = begin; prev_it != end; ++prev_it) {
+        if (prev_it->second == hash) {
+            m_by_prev.erase(prev_it);
+            break;
+        }
+    }
+    if (orphan.block->IsProofOfStake()) {
+        auto stake_it = m_stakes.find({orphan.block->prevoutStake, orphan.block->nTime});
+        if (--stake_it->second == 0) m_stakes.erase(stake_it);
+    }
+    m_by_age.erase({orphan.sequence, hash});
+
+    auto peer_it = m_peer_orphan_info.find(orphan.peer);
+    peer_it->second.m_by_age.erase({orphan.sequence, hash});
+    peer_it->second.m_total_usage -= orphan.usage;
+    if (peer_it->second.m_by_age.empty()) m_peer_orphan_info.erase(peer_it);
+
+    m_total_usage -= orphan.usage;
+    m_orphans.erase(it);
+}
+
+void BlockOrphanage::EraseOldest(NodeId peer)
+{
+    AssertLockHeld(m_mutex);
+    auto peer_it = m_peer_orphan_info.find(peer);
+    if (peer_it == m_peer_orphan_info.end()) return;
+    if (peer_it->second.m_by_age.empty()) {
+        m_peer_orphan_info.erase(peer_it);
+        return;
+    }
+    EraseBlock(m_orphans.find(peer_it->second.m_by_age.begin()->second));
+}
+
+void BlockOrphanage::ExpireInternal(NodeSeconds now)
+{
+    AssertLockHeld(m_mutex);
+    size_t erased{0};
+    while (!m_by_age.empty()) {
+        auto it = m_orphans.find(m_by_age.begin()->second);
+        if (it->second.time_added + ORPHAN_BLOCK_EXPIRE_TIME > now) break;
+        EraseBlock(it);
+        ++erased;
+    }
+    if (erased > 0) LogDebug(BCLog::NET, "Erased %d expired orphan block(s)\n", erased);
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKORPHANAGE_H
+#define BITCOIN_BLOCKORPHANAGE_H
+
+#include <net.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/time.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+/** Expiration time for orphan blocks */
+static constexpr auto ORPHAN_BLOCK_EXPIRE_TIME{20min};
+/** A single peer may use at most this fraction of the orphan block pool */
+static constexpr size_t ORPHAN_BLOCK_PEER_SHARE{4};
+
+/** A class to track blocks whose parent we do not have yet.
+ *
+ * Every orphan is charged to the peer that sent it. A peer that exceeds its
+ * quota evicts its own oldest orphans, and when the pool as a whole is full
+ * the oldest orphans of the peer using the most memory go first, so one peer
+ * cannot push out the orphans of others. Orphans also expire after
+ * ORPHAN_BLOCK_EXPIRE_TIME.
+ *
+ * Thread-safe, and never takes cs_main.
+ */
+class BlockOrphanage {
+public:
+    BlockOrphanage(size_t max_usage, size_t max_peer_usage);
+
+    /** Add an orphan block received from a peer
+     *  Returns false if it is already known or too large for the peer quota.
+     */
+    bool AddBlock(const std::shared_ptr<const CBlock>& block, NodeId peer) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Check if we already have an orphan block */
+    bool HaveBlock(const uint256& hash) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Check if an orphan builds on the given block */
+    bool HaveChild(const uint256& hash) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Check if an orphan uses the stake at the given time */
+    bool HaveStake(const COutPoint& prevout, uint32_t time) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Remove and return the orphans that build on the given block with the
+     *  peers that sent them, oldest first */
+    std::vector<std::pair<std::shared_ptr<const CBlock>, NodeId>> ExtractChildren(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Erase all orphans sent by a peer (eg, after that peer disconnects) */
+    void EraseForPeer(NodeId peer) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Erase orphans older than ORPHAN_BLOCK_EXPIRE_TIME */
+    void Expire() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Return how many orphans exist in the orphanage */
+    size_t Size() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Total serialized size of all orphans */
+    size_t TotalUsage() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Total serialized size of the orphans sent by a peer */
+    size_t UsageByPeer(NodeId peer) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Check consistency between the indexes and recalculate the usage counters */
+    void SanityCheck() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    using Stake = std::pair<COutPoint, uint32_t>;
+    /** Orphans are ordered by arrival, which the clock cannot tell apart within a second */
+    using AgeKey = std::pair<uint64_t, uint256>;
+
+    struct OrphanBlock {
+        std::shared_ptr<const CBlock> block;
+        NodeId peer;
+        NodeSeconds time_added;
+        uint64_t sequence;
+        size_t usage;
+    };
+
+    struct PeerOrphanInfo {
+        /** Orphans sent by this peer, oldest first */
+        std::set<AgeKey> m_by_age;
+        size_t m_total_usage{0};
+    };
+
+    mutable Mutex m_mutex;
+
+    const size_t m_max_usage;
+    const size_t m_max_peer_usage;
+
+    std::map<uint256, OrphanBlock> m_orphans GUARDED_BY(m_mutex);
+    /** Index from the parent hash to the orphans building on it */
+    std::multimap<uint256, uint256> m_by_prev GUARDED_BY(m_mutex);
+    /** Number of orphans using each stake */
+    std::map<Stake, int> m_stakes GUARDED_BY(m_mutex);
+    /** All orphans, oldest first */
+    std::set<AgeKey> m_by_age GUARDED_BY(m_mutex);
+    std::map<NodeId, PeerOrphanInfo> m_peer_orphan_info GUARDED_BY(m_mutex);
+    size_t m_total_usage GUARDED_BY(m_mutex){0};
+    /** Arrival number of the next orphan */
+    uint64_t m_sequence GUARDED_BY(m_mutex){0};
+
+    void EraseBlock(std::map<uint256, OrphanBlock>::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    /** Erase the oldest orphan sent by a peer */
+    void EraseOldest(NodeId peer) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void ExpireInternal(NodeSeconds now) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
+#endif // BITCOIN_BLOCKORPHANAGE_H
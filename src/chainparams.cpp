@@ -176,6 +176,11 @@ void UpdateLastMPoSBlockHeight(int nHeight)
     const_cast<CChainParams*>(globalChainParams.get())->UpdateLastMPoSBlockHeight(nHeight);
 }
 
+void UpdateMPoSBalanceHeight(int nHeight)
+{
+    const_cast<CChainParams*>(globalChainParams.get())->UpdateMPoSBalanceHeight(nHeight);
+}
+
 void UpdateReduceBlocktimeHeight(int nHeight)
 {
     const_cast<CChainParams*>(globalChainParams.get())->UpdateReduceBlocktimeHeight(nHeight);
@@ -225,3 +230,13 @@ void UpdatePectraHeight(int nHeight)
 {
     const_cast<CChainParams*>(globalChainParams.get())->UpdatePectraHeight(nHeight);
 }
+
+void UpdateDilithiumKeyRefHeight(int nHeight)
+{
+    const_cast<CChainParams*>(globalChainParams.get())->UpdateDilithiumKeyRefHeight(nHeight);
+}
+
+void UpdateHeartbeatAggregateHeight(int nHeight)
+{
+    const_cast<CChainParams*>(globalChainParams.get())->UpdateHeartbeatAggregateHeight(nHeight);
+}
@@ -64,6 +64,11 @@ void UpdateDelegationsAddress(const uint160& address);
  */
 void UpdateLastMPoSBlockHeight(int nHeight);
 
+/**
+ * Allows modifying the MPoS balance height regtest parameter.
+ */
+void UpdateMPoSBalanceHeight(int nHeight);
+
 /**
  * Allows modifying the reduce block time height regtest parameter.
  */
@@ -113,4 +118,14 @@ void UpdateCancunHeight(int nHeight);
  * Allows modifying the pectra block height regtest parameter.
  */
 void UpdatePectraHeight(int nHeight);
+
+/**
+ * Allows modifying the Dilithium key reference activation block height regtest parameter.
+ */
+void UpdateDilithiumKeyRefHeight(int nHeight);
+
+/**
+ * Allows modifying the heartbeat aggregate activation block height regtest parameter.
+ */
+void UpdateHeartbeatAggregateHeight(int nHeight);
 #endif // BITCOIN_CHAINPARAMS_H
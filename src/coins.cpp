@@ -294,6 +294,16 @@ unsigned int CCoinsViewCache::GetCacheSize() const {
     return cacheCoins.size();
 }
 
+std::vector<COutPoint> CCoinsViewCache::GetCachedOutpoints(size_t max_count) const {
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(std::min<size_t>(max_count, cacheCoins.size()));
+    for (const auto& [outpoint, entry] : cacheCoins) {
+        if (outpoints.size() >= max_count) break;
+        if (!entry.coin.IsSpent()) outpoints.push_back(outpoint);
+    }
+    return outpoints;
+}
+
 CAmount CCoinsViewCache::GetValueIn(const CTransaction& tx) const
 {
     if (tx.IsCoinBase())
@@ -21,6 +21,7 @@
 
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////// // qtum
 struct CSpentIndexKey {
@@ -530,6 +531,9 @@ public:
     //! Calculate the size of the cache (in number of transaction outputs)
     unsigned int GetCacheSize() const;
 
+    //! Return the outpoints of up to max_count unspent coins in the cache
+    std::vector<COutPoint> GetCachedOutpoints(size_t max_count) const;
+
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
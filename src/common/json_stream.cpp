@@ -0,0 +1,121 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <common/json_stream.h>
+
+#include <univalue.h>
+
+#include <cassert>
+#include <utility>
+
+JSONStreamWriter::JSONStreamWriter(Sink sink, size_t flush_bytes)
+    : m_sink(std::move(sink)), m_flush_bytes(flush_bytes)
+{
+    m_buffer.reserve(m_flush_bytes);
+}
+
+void JSONStreamWriter::Separator()
+{
+    assert(!m_finished);
+    if (m_after_key) {
+        m_after_key = false;
+        return;
+    }
+    if (m_empty.empty()) return;
+    if (!m_empty.back()) m_buffer += ',';
+    m_empty.back() = false;
+}
+
+void JSONStreamWriter::MaybeFlush()
+{
+    if (m_buffer.size() < m_flush_bytes) return;
+    m_sink(m_buffer, /*last=*/false);
+    m_written += m_buffer.size();
+    m_buffer.clear();
+}
+
+void JSONStreamWriter::BeginObject()
+{
+    Separator();
+    m_buffer += '{';
+    m_empty.push_back(true);
+}
+
+void JSONStreamWriter::EndObject()
+{
+    assert(!m_empty.empty() && !m_after_key);
+    m_empty.pop_back();
+    m_buffer += '}';
+    MaybeFlush();
+}
+
+void JSONStreamWriter::BeginArray()
+{
+    Separator();
+    m_buffer += '[';
+    m_empty.push_back(true);
+}
+
+void JSONStreamWriter::EndArray()
+{
+    assert(!m_empty.empty() && !m_after_key);
+    m_empty.pop_back();
+    m_buffer += ']';
+    MaybeFlush();
+}
+
+void JSONStreamWriter::Key(std::string_view key)
+{
+    assert(!m_empty.empty() && !m_after_key);
+    Separator();
+    m_buffer += UniValue{std::string{key}}.write();
+    m_buffer += ':';
+    m_after_key = true;
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void JSONStreamWriter::Value(const UniValue& value)
+{
+    switch (value.getType()) {
+    case UniValue::VOBJ: {
+        BeginObject();
+        const std::vector<std::string>& keys{value.getKeys()};
+        const std::vector<UniValue>& values{value.getValues()};
+        for (size_t i = 0; i < keys.size(); ++i) {
+            Key(keys[i]);
+            Value(values[i]);
+        }
+        EndObject();
+        break;
+    }
+    case UniValue::VARR:
+        BeginArray();
+        for (const UniValue& element : value.getValues()) {
+            Value(element);
+        }
+        EndArray();
+        break;
+    default:
+        Separator();
+        m_buffer += value.write();
+        MaybeFlush();
+        break;
+    }
+}
+
+void JSONStreamWriter::Raw(std::string_view text)
+{
+    assert(!m_finished);
+    m_buffer += text;
+    MaybeFlush();
+}
+
+void JSONStreamWriter::Finish()
+{
+    assert(!m_finished && m_empty.empty() && !m_after_key);
+    m_finished = true;
+    m_sink(m_buffer, /*last=*/true);
+    m_written += m_buffer.size();
+    m_buffer.clear();
+}
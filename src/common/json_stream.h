@@ -0,0 +1,64 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_COMMON_JSON_STREAM_H
+#define BITCOIN_COMMON_JSON_STREAM_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class UniValue;
+
+/**
+ * Incremental JSON serializer.
+ *
+ * Produces the same compact output as UniValue::write(), but hands it to a
+ * sink in pieces of roughly flush_bytes instead of building the whole
+ * document in one string. Callers can also emit a document element by
+ * element, so that a large array never has to exist as a UniValue tree.
+ */
+class JSONStreamWriter
+{
+public:
+    /** Receives serialized output. last is set on the final call, made by Finish(). */
+    using Sink = std::function<void(std::string_view data, bool last)>;
+
+    static constexpr size_t DEFAULT_FLUSH_BYTES{64 * 1024};
+
+    explicit JSONStreamWriter(Sink sink, size_t flush_bytes = DEFAULT_FLUSH_BYTES);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    /** Write an object key. Must be followed by exactly one value. */
+    void Key(std::string_view key);
+    /** Write a complete value, streaming the members of objects and arrays. */
+    void Value(const UniValue& value);
+    /** Append text verbatim, e.g. a trailing newline after the document. */
+    void Raw(std::string_view text);
+    /** Pass all remaining output to the sink. Nothing may be written afterwards. */
+    void Finish();
+
+    /** Total number of bytes produced so far. */
+    size_t BytesWritten() const { return m_written + m_buffer.size(); }
+
+private:
+    void Separator();
+    void MaybeFlush();
+
+    Sink m_sink;
+    const size_t m_flush_bytes;
+    std::string m_buffer;
+    /** One entry per open object or array, set until its first member is written. */
+    std::vector<bool> m_empty;
+    bool m_after_key{false};
+    size_t m_written{0};
+    bool m_finished{false};
+};
+
+#endif // BITCOIN_COMMON_JSON_STREAM_H
@@ -121,6 +121,8 @@ struct Params {
     int nCancunHeight;
     /** Block height at which EVM Pectra fork becomes active */
     int nPectraHeight;
+    /** Block height at which spends may reference an already revealed Dilithium public key */
+    int nDilithiumKeyRefHeight;
     /**
      * Minimum blocks including miner confirmation of the total of 2016 blocks in a retargeting period,
      * (nPowTargetTimespan / nPowTargetSpacing) which is also used for BIP9 deployments.
@@ -197,6 +199,11 @@ struct Params {
     uint160 delegationsAddress;
     uint160 historyStorageAddress;
     int nLastMPoSBlock;
+    /** Block height at which the MPoS rewards accrue to balances of their recipients
+     * instead of being paid as outputs of every coinstake, as does the reward of the
+     * delegate of a delegated block. A transaction spending a coin of the owner of a
+     * balance claims it, see GetMPoSClaim. */
+    int nMPoSBalanceHeight{std::numeric_limits<int>::max()};
     int nLastBigReward;
     uint32_t nStakeTimestampMask;
     uint32_t nRBTStakeTimestampMask;
@@ -295,6 +302,12 @@ struct Params {
     /** Uptime tracking window in blocks (~30 days at 1s blocks) */
     int nUptimeWindow{2592000};
 
+    /** Height from which stakers commit heartbeat aggregates and uptime is derived from them */
+    int nHeartbeatAggregateHeight{std::numeric_limits<int>::max()};
+
+    /** Number of blocks after the start of a heartbeat window in which its aggregate can be included */
+    int nHeartbeatInclusionWindow{60};
+
     /** Trust tier uptime thresholds (in percentage * 10, e.g., 950 = 95.0%) */
     int nBronzeUptimeThreshold{950};   // 95.0% uptime for Bronze
     int nSilverUptimeThreshold{970};   // 97.0% uptime for Silver
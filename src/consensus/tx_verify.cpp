@@ -8,12 +8,13 @@
 #include <coins.h>
 #include <consensus/amount.h>
 #include <consensus/consensus.h>
+#include <consensus/params.h>
 #include <consensus/validation.h>
 #include <primitives/transaction.h>
 #include <script/interpreter.h>
+#include <script/solver.h>
 #include <util/check.h>
 #include <util/moneystr.h>
-#include <chainparams.h>
 
 bool IsFinalTx(const CTransaction &tx, int nBlockHeight, int64_t nBlockTime)
 {
@@ -162,7 +163,33 @@ int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& i
     return nSigOps;
 }
 
-bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee)
+/**
+ * Whether the signature in scriptSig for the P2PKH or P2PK scriptPubKey is
+ * SIGHASH_ALL, so that it commits to all the outputs of the transaction.
+ * The signature itself is checked with the scripts.
+ */
+static bool SignsAllOutputs(const CScript& scriptSig, const CScript& scriptPubKey)
+{
+    std::vector<std::vector<unsigned char>> solutions;
+    const TxoutType type{Solver(scriptPubKey, solutions)};
+    if (type != TxoutType::PUBKEYHASH && type != TxoutType::PUBKEY) return false;
+
+    std::vector<std::vector<unsigned char>> stack;
+    CScript::const_iterator pc{scriptSig.begin()};
+    opcodetype opcode;
+    std::vector<unsigned char> data;
+    while (pc < scriptSig.end()) {
+        if (!scriptSig.GetOp(pc, opcode, data) || opcode > OP_PUSHDATA4) return false;
+        stack.push_back(data);
+    }
+    // P2PKH takes the signature below the public key, P2PK from the top
+    const size_t depth{type == TxoutType::PUBKEYHASH ? 2U : 1U};
+    if (stack.size() < depth) return false;
+    const std::vector<unsigned char>& sig{stack[stack.size() - depth]};
+    return !sig.empty() && sig.back() == SIGHASH_ALL;
+}
+
+bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee, const Consensus::Params& params)
 {
     // are the actual inputs available?
     if (!inputs.HaveInputs(tx)) {
@@ -177,7 +204,7 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state,
         assert(!coin.IsSpent());
 
         // If prev is coinbase, check that it's matured
-        if ((coin.IsCoinBase() || coin.IsCoinStake()) && nSpendHeight - coin.nHeight < ::Params().GetConsensus().CoinbaseMaturity(nSpendHeight)) {
+        if ((coin.IsCoinBase() || coin.IsCoinStake()) && nSpendHeight - coin.nHeight < params.CoinbaseMaturity(nSpendHeight)) {
             return state.Invalid(TxValidationResult::TX_PREMATURE_SPEND, "bad-txns-premature-spend-of-coinbase",
                 strprintf("tried to spend coinbase at depth %d", nSpendHeight - coin.nHeight));
         }
@@ -189,6 +216,37 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state,
         }
     }
 
+    // After the MPoS balance fork a transaction can claim the accrued balance of
+    // the key paid by its first input, whose SIGHASH_ALL signature authorizes
+    // the claim and its outputs. Whether the balance covers the claim is
+    // checked in ConnectBlock.
+    if (!tx.IsCoinStake() && nSpendHeight >= params.nMPoSBalanceHeight) {
+        int claims = 0;
+        for (const CTxOut& txout : tx.vout) {
+            uint160 keyid;
+            CAmount amount;
+            if (!ExtractMPoSClaim(txout.scriptPubKey, keyid, amount)) continue;
+            if (++claims > 1 || txout.nValue != 0 || amount <= 0 || !MoneyRange(amount)) {
+                return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-mpos-claim",
+                    strprintf("%s: invalid MPoS balance claim", __func__));
+            }
+            uint160 owner;
+            const CScript& ownerScript{inputs.AccessCoin(tx.vin[0].prevout).out.scriptPubKey};
+            if (!GetMPoSBalanceKey(ownerScript, owner) || owner != keyid) {
+                return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-mpos-claim-owner",
+                    strprintf("%s: the first input does not belong to the owner of the claimed MPoS balance", __func__));
+            }
+            if (!SignsAllOutputs(tx.vin[0].scriptSig, ownerScript)) {
+                return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-mpos-claim-sighash",
+                    strprintf("%s: the signature of the owner of the claimed MPoS balance does not commit to all outputs", __func__));
+            }
+            nValueIn += amount;
+            if (!MoneyRange(nValueIn)) {
+                return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-inputvalues-outofrange");
+            }
+        }
+    }
+
     if (!tx.IsCoinStake())
     {
         const CAmount value_out = tx.GetValueOut();
@@ -207,3 +265,12 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state,
     }
     return true;
 }
+
+bool GetMPoSClaim(const CTransaction& tx, uint160& keyid, CAmount& amount)
+{
+    if (tx.IsCoinBase() || tx.IsCoinStake()) return false;
+    for (const CTxOut& txout : tx.vout) {
+        if (ExtractMPoSClaim(txout.scriptPubKey, keyid, amount)) return true;
+    }
+    return false;
+}
@@ -11,9 +11,13 @@
 #include <vector>
 
 class CBlockIndex;
+class uint160;
 class CCoinsViewCache;
 class CTransaction;
 class TxValidationState;
+namespace Consensus {
+struct Params;
+} // namespace Consensus
 
 /** Transaction validation functions */
 
@@ -24,9 +28,16 @@ namespace Consensus {
  * @param[out] txfee Set to the transaction fee if successful.
  * Preconditions: tx.IsCoinBase() is false.
  */
-[[nodiscard]] bool CheckTxInputs(const CTransaction& tx, TxValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee);
+[[nodiscard]] bool CheckTxInputs(const CTransaction& tx, TxValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee, const Consensus::Params& params);
 } // namespace Consensus
 
+/**
+ * Get the accrued MPoS balance a transaction claims, see Consensus::Params::nMPoSBalanceHeight.
+ * CheckTxInputs adds the claimed amount to the value in of the transaction.
+ * @return whether the transaction has a claim output
+ */
+bool GetMPoSClaim(const CTransaction& tx, uint160& keyid, CAmount& amount);
+
 /** Auxiliary functions for transaction validation (ideally should not be exposed) */
 
 /**
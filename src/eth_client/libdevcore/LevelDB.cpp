@@ -4,12 +4,16 @@
 #include "LevelDB.h"
 #include "Assertions.h"
 
+#include <atomic>
+
 namespace dev
 {
 namespace db
 {
 namespace
 {
+std::atomic<size_t> g_blockCacheSize{0};
+
 inline leveldb::Slice toLDBSlice(Slice _slice)
 {
     return leveldb::Slice(_slice.data(), _slice.size());
@@ -86,10 +90,20 @@ leveldb::Options LevelDB::defaultDBOptions()
     return options;
 }
 
+void LevelDB::setBlockCacheSize(size_t _size)
+{
+    g_blockCacheSize = _size;
+}
+
 LevelDB::LevelDB(boost::filesystem::path const& _path, leveldb::ReadOptions _readOptions,
     leveldb::WriteOptions _writeOptions, leveldb::Options _dbOptions)
   : m_db(nullptr), m_readOptions(std::move(_readOptions)), m_writeOptions(std::move(_writeOptions))
 {
+    if (!_dbOptions.block_cache && g_blockCacheSize > 0)
+    {
+        m_blockCache.reset(leveldb::NewLRUCache(g_blockCacheSize));
+        _dbOptions.block_cache = m_blockCache.get();
+    }
     auto db = static_cast<leveldb::DB*>(nullptr);
     auto const status = leveldb::DB::Open(_dbOptions, _path.string(), &db);
     checkStatus(status, _path);
@@ -7,6 +7,7 @@
 #include "db.h"
 
 #include <boost/filesystem.hpp>
+#include <leveldb/cache.h>
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 
@@ -21,6 +22,9 @@ public:
     static leveldb::WriteOptions defaultWriteOptions();
     static leveldb::Options defaultDBOptions();
 
+    /// Size of the block cache of the databases opened without one, 0 for the leveldb default
+    static void setBlockCacheSize(size_t _size);
+
     explicit LevelDB(boost::filesystem::path const& _path,
         leveldb::ReadOptions _readOptions = defaultReadOptions(),
         leveldb::WriteOptions _writeOptions = defaultWriteOptions(),
@@ -37,6 +41,7 @@ public:
     void forEach(std::function<bool(Slice, Slice)> _f) const override;
 
 private:
+    std::unique_ptr<leveldb::Cache> m_blockCache;
     std::unique_ptr<leveldb::DB> m_db;
     leveldb::ReadOptions const m_readOptions;
     leveldb::WriteOptions const m_writeOptions;
@@ -86,6 +86,15 @@ void OverlayDB::commit()
 }
 
 bytes OverlayDB::lookupAux(h256 const& _h) const
+{
+    bytes ret = tryLookupAux(_h);
+    if (ret.empty() && m_db)
+        cwarn << "Aux not found: " << _h;
+
+    return ret;
+}
+
+bytes OverlayDB::tryLookupAux(h256 const& _h) const
 {
     bytes ret = StateCacheDB::lookupAux(_h);
     if (!ret.empty() || !m_db)
@@ -93,11 +102,7 @@ bytes OverlayDB::lookupAux(h256 const& _h) const
 
     bytes b = _h.asBytes();
     b.push_back(255);   // for aux
-    std::string const v = m_db->lookup(toSlice(b));
-    if (v.empty())
-        cwarn << "Aux not found: " << _h;
-
-    return asBytes(v);
+    return asBytes(m_db->lookup(toSlice(b)));
 }
 
 void OverlayDB::rollback()
@@ -114,6 +119,8 @@ std::string OverlayDB::lookup(h256 const& _h) const
     if (!ret.empty() || !m_db)
         return ret;
 
+    if (m_readObserver)
+        m_readObserver(_h);
     return m_db->lookup(toSlice(_h));
 }
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <libdevcore/db.h>
 #include <libdevcore/Common.h>
@@ -40,11 +41,17 @@ public:
 	void kill(h256 const& _h);
 
 	bytes lookupAux(h256 const& _h) const;
+	/// Like lookupAux, without a warning when the data is missing
+	bytes tryLookupAux(h256 const& _h) const;
+
+	/// Called with the hash of every node that lookup() reads from the database
+	void setReadObserver(std::function<void(h256 const&)> _observer) { m_readObserver = std::move(_observer); }
 
 private:
 	using StateCacheDB::clear;
 
     std::shared_ptr<db::DatabaseFace> m_db;
+	std::function<void(h256 const&)> m_readObserver;
 };
 
 }
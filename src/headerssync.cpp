@@ -12,57 +12,75 @@
 // The two constants below are computed using the simulation script in
 // contrib/devtools/headerssync-params.py.
 
-//! Store one header commitment per HEADER_COMMITMENT_PERIOD blocks.
+//! Store one header commitment per HEADER_COMMITMENT_PERIOD blocks, or more
+//! blocks for very long chains (see MAX_HEADER_COMMITMENTS).
 constexpr size_t HEADER_COMMITMENT_PERIOD{59};
 
 //! Only feed headers to validation once this many headers on top have been
 //! received and validated against commitments.
 constexpr size_t REDOWNLOAD_BUFFER_SIZE{741}; // 741/59 = ~12.6 commitments
 
+//! Store at most this many header commitments per peer (256 KiB); the
+//! commitment period is raised for chains that could be longer.
+constexpr uint64_t MAX_HEADER_COMMITMENTS{1 << 21};
+
 // Our memory analysis assumes 176 bytes for a CompressedHeader (so we should
 // re-calculate parameters if we compress further)
 // 160 bytes for a CompressedHeader is for ARM Linux
 static_assert(sizeof(CompressedHeader) == 176 || sizeof(CompressedHeader) == 160);
 
+/** Estimate the number of blocks that could possibly exist on top of
+ * chain_start *right now*. This serves as a memory bound on how many
+ * commitments we might store from a peer, and we can safely give up syncing
+ * if the peer exceeds this bound, because it's not possible for a
+ * consensus-valid chain to be longer than this (at the current time -- in the
+ * future we could try again, if necessary, to sync a longer chain). */
+static uint64_t MaxHeaders(const Consensus::Params& consensus_params, const CBlockIndex* chain_start)
+{
+    if(consensus_params.nLastPOWBlock != consensus_params.nLastBigReward)
+    {
+        // Regtest mode, so use the Bitcoin formula: 6 blocks/second (fastest
+        // blockrate given the MTP rule) times the number of seconds from the
+        // last allowed block until today
+        return std::max<int64_t>(0, 6*(Ticks<std::chrono::seconds>(NodeClock::now() - NodeSeconds{std::chrono::seconds{chain_start->GetMedianTimePast()}}) + MAX_FUTURE_BLOCK_TIME));
+    }
+
+    // Mainnet or testnet, so use the Qtum formula: one proof-of-stake block
+    // per stake timestamp slot
+    int64_t numberOfBlocks = (TicksSinceEpoch<std::chrono::seconds>(NodeClock::now()) + MAX_FUTURE_BLOCK_TIME - chain_start->GetBlockTime()) / (consensus_params.MinStakeTimestampMask() + 1);
+    if(numberOfBlocks <= 0) return 0;
+    if(chain_start->nHeight <= consensus_params.nLastPOWBlock)
+    {
+        // Add the PoW block, they take no time
+        numberOfBlocks += consensus_params.nLastPOWBlock;
+    }
+    return numberOfBlocks;
+}
+
+/** Headers per commitment for a chain of up to max_headers headers */
+static unsigned CommitmentPeriod(uint64_t max_headers)
+{
+    return std::max<uint64_t>(HEADER_COMMITMENT_PERIOD, (max_headers + MAX_HEADER_COMMITMENTS - 1) / MAX_HEADER_COMMITMENTS);
+}
+
 HeadersSyncState::HeadersSyncState(NodeId id, const Consensus::Params& consensus_params,
-        const CBlockIndex* chain_start, const arith_uint256& minimum_required_work) :
-    m_commit_offset(FastRandomContext().randrange<unsigned>(HEADER_COMMITMENT_PERIOD)),
+        const CBlockIndex* chain_start, const arith_uint256& minimum_required_work,
+        StakeCheck check_stake) :
+    m_commit_period(CommitmentPeriod(MaxHeaders(consensus_params, chain_start))),
+    m_commit_offset(FastRandomContext().randrange<unsigned>(m_commit_period)),
     m_id(id), m_consensus_params(consensus_params),
     m_chain_start(chain_start),
     m_minimum_required_work(minimum_required_work),
+    m_check_stake(std::move(check_stake)),
+    m_redownload_buffer_size(REDOWNLOAD_BUFFER_SIZE * m_commit_period / HEADER_COMMITMENT_PERIOD),
     m_current_chain_work(chain_start->nChainWork),
     m_last_header_received(m_chain_start->GetBlockHeader()),
     m_current_height(chain_start->nHeight)
 {
-    // Estimate the number of blocks that could possibly exist on the peer's
-    // chain *right now* using 6 blocks/second (fastest blockrate given the MTP
-    // rule) times the number of seconds from the last allowed block until
-    // today. This serves as a memory bound on how many commitments we might
-    // store from this peer, and we can safely give up syncing if the peer
-    // exceeds this bound, because it's not possible for a consensus-valid
-    // chain to be longer than this (at the current time -- in the future we
-    // could try again, if necessary, to sync a longer chain).
-    if(consensus_params.nLastPOWBlock != consensus_params.nLastBigReward)
-    {
-        // Regtest mode, so use the Bitcoin formula for max commitments
-        m_max_commitments = 6*(Ticks<std::chrono::seconds>(NodeClock::now() - NodeSeconds{std::chrono::seconds{chain_start->GetMedianTimePast()}}) + MAX_FUTURE_BLOCK_TIME) / HEADER_COMMITMENT_PERIOD;
-    }
-    else
-    {
-        // Mainnet or testnet, so use the Qtum formula
-        int64_t numberOfBlocks = (TicksSinceEpoch<std::chrono::seconds>(NodeClock::now()) + MAX_FUTURE_BLOCK_TIME - chain_start->GetBlockTime()) / (consensus_params.MinStakeTimestampMask() + 1);
-        if(numberOfBlocks > 0)
-        {
-            if(chain_start->nHeight <= consensus_params.nLastPOWBlock)
-            {
-                // Add the PoW block, they take no time
-                numberOfBlocks += consensus_params.nLastPOWBlock;
-            }
-            m_max_commitments = 1 + numberOfBlocks / HEADER_COMMITMENT_PERIOD;
-        }
-    }
+    const uint64_t max_headers{MaxHeaders(consensus_params, chain_start)};
+    if (max_headers > 0) m_max_commitments = 1 + max_headers / m_commit_period;
 
-    LogDebug(BCLog::NET, "Initial headers sync started with peer=%d: height=%i, max_commitments=%i, min_work=%s\n", m_id, m_current_height, m_max_commitments, m_minimum_required_work.ToString());
+    LogDebug(BCLog::NET, "Initial headers sync started with peer=%d: height=%i, max_commitments=%i, commitment_period=%u, min_work=%s\n", m_id, m_current_height, m_max_commitments, m_commit_period, m_minimum_required_work.ToString());
 }
 
 /** Free any memory in use, and mark this object as no longer usable. This is
@@ -213,7 +231,14 @@ bool HeadersSyncState::ValidateAndProcessSingleHeader(const CBlockHeader& curren
         return false;
     }
 
-    if (next_height % HEADER_COMMITMENT_PERIOD == m_commit_offset) {
+    if (next_height % m_commit_period == m_commit_offset) {
+        // Spot check the stake of the headers we commit to. A peer does not
+        // know the offset, so it cannot tell which of its headers are checked.
+        if (current.IsProofOfStake() && m_check_stake && !m_check_stake(current, next_height)) {
+            LogDebug(BCLog::NET, "Initial headers sync aborted with peer=%d: invalid stake at height=%i (presync phase)\n", m_id, next_height);
+            return false;
+        }
+
         // Add a commitment.
         m_header_commitments.push_back(m_hasher(current.GetHash()) & 1);
         if (m_header_commitments.size() > m_max_commitments) {
@@ -274,7 +299,7 @@ bool HeadersSyncState::ValidateAndStoreRedownloadedHeader(const CBlockHeader& he
     // it's possible our peer has extended its chain between our first sync and
     // our second, and we don't want to return failure after we've seen our
     // target blockhash just because we ran out of commitments.
-    if (!m_process_all_remaining_headers && next_height % HEADER_COMMITMENT_PERIOD == m_commit_offset) {
+    if (!m_process_all_remaining_headers && next_height % m_commit_period == m_commit_offset) {
         if (m_header_commitments.size() == 0) {
             LogDebug(BCLog::NET, "Initial headers sync aborted with peer=%d: commitment overrun at height=%i (redownload phase)\n", m_id, next_height);
             // Somehow our peer managed to feed us a different chain and
@@ -305,7 +330,7 @@ std::vector<CBlockHeader> HeadersSyncState::PopHeadersReadyForAcceptance()
     Assume(m_download_state == State::REDOWNLOAD);
     if (m_download_state != State::REDOWNLOAD) return ret;
 
-    while (m_redownloaded_headers.size() > REDOWNLOAD_BUFFER_SIZE ||
+    while (m_redownloaded_headers.size() > m_redownload_buffer_size ||
             (m_redownloaded_headers.size() > 0 && m_process_all_remaining_headers)) {
         ret.emplace_back(m_redownloaded_headers.front().GetFullHeader(m_redownload_buffer_first_prev_hash));
         m_redownloaded_headers.pop_front();
@@ -15,6 +15,7 @@
 #include <util/hasher.h>
 
 #include <deque>
+#include <functional>
 #include <vector>
 
 // A compressed CBlockHeader, which leaves out the prevhash
@@ -112,6 +113,21 @@ struct CompressedHeader {
  * parametrization, we can achieve a given security target for potential
  * permanent memory usage, while choosing N to minimize memory use during the
  * sync (temporary, per-peer storage).
+ *
+ * Proof-of-stake headers cost no work to produce and can be spaced much more
+ * closely than proof-of-work blocks, so a valid chain may be far longer than
+ * a Bitcoin one for the same time span. Two adjustments keep the above bounds
+ * for such chains:
+ *
+ * - The commitment period grows with the longest chain possible at the time
+ * of the sync, so the commitments of a peer never exceed a fixed size. The
+ * redownload buffer grows with it, to keep the same number of verified
+ * commitments on top of the headers that are accepted.
+ *
+ * - In presync, the stake of each header we store a commitment for is
+ * spot-checked when its kernel is in our UTXO set, by the block signature.
+ * As the commitment offset is secret, a peer cannot tell which of its
+ * headers are checked, and a chain of forged stakes is caught early.
  */
 
 class HeadersSyncState {
@@ -143,6 +159,13 @@ public:
     /** Return the amount of work in the chain received during the PRESYNC phase. */
     arith_uint256 GetPresyncWork() const { return m_current_chain_work; }
 
+    /** Return the number of headers per commitment */
+    unsigned GetCommitmentPeriod() const { return m_commit_period; }
+
+    /** Check of the stake of a proof-of-stake header at a height. Returns
+     *  false only if the stake is known to be invalid. */
+    using StakeCheck = std::function<bool(const CBlockHeader& header, int height)>;
+
     /** Construct a HeadersSyncState object representing a headers sync via this
      *  download-twice mechanism).
      *
@@ -150,9 +173,11 @@ public:
      * consensus_params: parameters needed for difficulty adjustment validation
      * chain_start: best known fork point that the peer's headers branch from
      * minimum_required_work: amount of chain work required to accept the chain
+     * check_stake: spot check of the stake of proof-of-stake headers, if any
      */
     HeadersSyncState(NodeId id, const Consensus::Params& consensus_params,
-            const CBlockIndex* chain_start, const arith_uint256& minimum_required_work);
+            const CBlockIndex* chain_start, const arith_uint256& minimum_required_work,
+            StakeCheck check_stake = {});
 
     /** Result data structure for ProcessNextHeaders. */
     struct ProcessingResult {
@@ -192,10 +217,14 @@ public:
     CBlockLocator NextHeadersRequestLocator() const;
 
 protected:
+    /** The number of headers per commitment, at least HEADER_COMMITMENT_PERIOD
+     * and more for chains that could be too long for MAX_HEADER_COMMITMENTS. */
+    const unsigned m_commit_period;
+
     /** The (secret) offset on the heights for which to create commitments.
      *
      * m_header_commitments entries are created at any height h for which
-     * (h % HEADER_COMMITMENT_PERIOD) == m_commit_offset. */
+     * (h % m_commit_period) == m_commit_offset. */
     const unsigned m_commit_offset;
 
 private:
@@ -236,6 +265,13 @@ private:
     /** Minimum work that we're looking for on this chain. */
     const arith_uint256 m_minimum_required_work;
 
+    /** Spot check of the stake of proof-of-stake headers in PRESYNC */
+    const StakeCheck m_check_stake;
+
+    /** Number of headers kept in m_redownloaded_headers before the oldest are
+     * released, scaled with m_commit_period */
+    const size_t m_redownload_buffer_size;
+
     /** Work that we've seen so far on the peer's chain */
     arith_uint256 m_current_chain_work;
 
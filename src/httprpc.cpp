@@ -5,6 +5,7 @@
 #include <httprpc.h>
 
 #include <common/args.h>
+#include <common/json_stream.h>
 #include <crypto/hmac_sha256.h>
 #include <httpserver.h>
 #include <logging.h>
@@ -220,6 +221,7 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // 2.0 behavior is to catch exceptions and return HTTP success with
             // RPC errors, as long as there is not an actual HTTP server error.
             const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
+            jreq.canStream = true;
             reply = JSONRPCExec(jreq, catch_errors);
 
             if (jreq.isLongPolling) {
@@ -227,6 +229,11 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
                 return true;
             }
 
+            if (jreq.isStreamed) {
+                // The method has already written the reply
+                return true;
+            }
+
             if (jreq.IsNotification()) {
                 // Even though we do execute notifications, we do not respond to them
                 req->WriteReply(HTTP_NO_CONTENT);
@@ -289,7 +296,10 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
 
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, reply.write() + "\n");
+        JSONStreamWriter writer{[req](std::string_view part, bool last) { req->WriteReplyPart(HTTP_OK, part, last); }};
+        writer.Value(reply);
+        writer.Raw("\n");
+        writer.Finish();
     } catch (UniValue& e) {
         JSONErrorReply(req, std::move(e), jreq);
         return false;
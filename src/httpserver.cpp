@@ -20,6 +20,7 @@
 #include <util/threadnames.h>
 #include <util/translation.h>
 
+#include <algorithm>
 #include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
@@ -260,6 +261,30 @@ std::string RequestMethodString(HTTPRequest::RequestMethod m)
 }
 
 /** HTTP request callback */
+/** Stop tracking a connection once libevent has closed it */
+static void http_connection_close_cb(evhttp_connection* conn, void* arg)
+{
+    g_requests.RemoveConnection(conn);
+}
+
+/** Re-enable reading from the socket after the reply to a request has been
+ * handed to libevent. This is the second part of the libevent workaround in
+ * http_request_cb; without it a keep-alive connection never reads the next
+ * request.
+ */
+static void http_reenable_reading(evhttp_request* req)
+{
+    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
+        evhttp_connection* conn = evhttp_request_get_connection(req);
+        if (conn) {
+            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+            if (bev) {
+                bufferevent_enable(bev, EV_READ | EV_WRITE);
+            }
+        }
+    }
+}
+
 static void http_request_cb(struct evhttp_request* req, void* arg)
 {
     evhttp_connection* conn{evhttp_request_get_connection(req)};
@@ -269,9 +294,7 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
         evhttp_request_set_on_complete_cb(req, [](struct evhttp_request* req, void*) {
             g_requests.RemoveRequest(req);
         }, nullptr);
-        evhttp_connection_set_closecb(conn, [](evhttp_connection* conn, void* arg) {
-            g_requests.RemoveConnection(conn);
-        }, nullptr);
+        evhttp_connection_set_closecb(conn, http_connection_close_cb, nullptr);
     }
 
     // Disable reading to work around a libevent bug, fixed in 2.1.9
@@ -606,6 +629,12 @@ HTTPRequest::~HTTPRequest()
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
         WriteReply(HTTP_INTERNAL_SERVER_ERROR, "Unhandled request");
+    } else if (!replySent && req) {
+        // A streamed reply was abandoned half way, e.g. by an error while
+        // producing it. End it rather than leak the request.
+        LogPrintf("%s: Unfinished reply\n", __func__);
+        WaitChunkDrained();
+        EndChunks(/*wait=*/true);
     }
     // evhttpd cleans up the request, as long as a reply was sent.
 }
@@ -687,17 +716,11 @@ std::string HTTPRequest::ReadBody()
     if (!buf)
         return "";
     size_t size = evbuffer_get_length(buf);
-    /** Trivial implementation: if this is ever a performance bottleneck,
-     * internal copying can be avoided in multi-segment buffers by using
-     * evbuffer_peek and an awkward loop. Though in that case, it'd be even
-     * better to not copy into an intermediate string but use a stream
-     * abstraction to consume the evbuffer on the fly in the parsing algorithm.
-     */
-    const char* data = (const char*)evbuffer_pullup(buf, size);
-    if (!data) // returns nullptr in case of empty buffer
-        return "";
-    std::string rv(data, size);
-    evbuffer_drain(buf, size);
+    // Copy straight out of the (possibly multi-segment) buffer instead of
+    // linearizing it with evbuffer_pullup first.
+    std::string rv(size, '\0');
+    const int copied{evbuffer_remove(buf, rv.data(), size)};
+    rv.resize(std::max(copied, 0));
     return rv;
 }
 
@@ -712,13 +735,105 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
     evhttp_add_header(headers, hdr.c_str(), value.c_str());
 }
 
+void HTTPRequest::StartChunks(int nStatus)
+{
+    if (startedChunkTransfer) return;
+    if (m_interrupt) {
+        WriteHeader("Connection", "close");
+    }
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, nullptr, [req_copy, nStatus] {
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+    });
+    ev->trigger(nullptr);
+
+    startDetectClientClose();
+    startedChunkTransfer = true;
+}
+
+void HTTPRequest::SendChunk(std::string_view chunk, bool track_drain)
+{
+    if (chunk.empty()) return;
+    auto databuf = evbuffer_new(); // HTTPEvent will free this buffer
+    evbuffer_add(databuf, chunk.data(), chunk.size());
+    auto req_copy = req;
+    HTTPEvent* ev;
+    if (track_drain) {
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            chunkDrained = false;
+        }
+        // libevent calls back once the output buffer has drained to its low-water mark
+        ev = new HTTPEvent(eventBase, true, databuf, [this, req_copy, databuf] {
+            evhttp_send_reply_chunk_with_cb(req_copy, databuf, [](evhttp_connection*, void* data) {
+                auto req = (HTTPRequest*) data;
+                std::lock_guard<std::mutex> lock(req->cs);
+                req->chunkDrained = true;
+                req->closeCv.notify_all();
+            }, (void*) this);
+        });
+    } else {
+        ev = new HTTPEvent(eventBase, true, databuf,
+                std::bind(evhttp_send_reply_chunk, req_copy, databuf));
+    }
+    ev->trigger(nullptr);
+}
+
+void HTTPRequest::WaitChunkDrained()
+{
+    // A client that stops reading is disconnected by the -rpcservertimeout
+    // write timeout, which ends this wait through the close callback.
+    std::unique_lock<std::mutex> lock(cs);
+    while (!chunkDrained && !connClosed && IsRPCRunning()) {
+        closeCv.wait_for(lock, std::chrono::milliseconds(500));
+    }
+}
+
+void HTTPRequest::EndChunks(bool wait)
+{
+    auto req_copy = req;
+    HTTPEvent* ev;
+    if (wait) {
+        {
+            std::lock_guard<std::mutex> lock(cs);
+            chunksEnded = false;
+        }
+        ev = new HTTPEvent(eventBase, true, nullptr, [this, req_copy] {
+            // Hand the connection back to the request tracker before the
+            // reply completes, so that a later close of this keep-alive
+            // connection does not call back into a destroyed HTTPRequest.
+            if (evhttp_connection* conn = evhttp_request_get_connection(req_copy)) {
+                evhttp_connection_set_closecb(conn, http_connection_close_cb, nullptr);
+            }
+            // evhttp_send_reply_end may free the request and its connection
+            http_reenable_reading(req_copy);
+            evhttp_send_reply_end(req_copy);
+
+            std::lock_guard<std::mutex> lock(cs);
+            chunksEnded = true;
+            closeCv.notify_all();
+        });
+    } else {
+        ev = new HTTPEvent(eventBase, true, nullptr, [req_copy] {
+            http_reenable_reading(req_copy);
+            evhttp_send_reply_end(req_copy);
+        });
+    }
+    ev->trigger(nullptr);
+
+    if (wait) {
+        std::unique_lock<std::mutex> lock(cs);
+        while (!chunksEnded && IsRPCRunning()) {
+            closeCv.wait_for(lock, std::chrono::milliseconds(500));
+        }
+    }
+}
+
 void HTTPRequest::ChunkEnd() {
     assert(startedChunkTransfer && !replySent);
 
-    HTTPEvent* ev = new HTTPEvent(eventBase, true, NULL,
-            std::bind(evhttp_send_reply_end, req));
-
-    ev->trigger(0);
+    WaitChunkDrained();
+    EndChunks(/*wait=*/false);
 
     // If HTTPRequest is destroyed before connection is closed, evhttp seems to get messed up.
     // We wait here for connection close before returning back to the handler, where HTTPRequest will be reclaimed.
@@ -733,26 +848,8 @@ void HTTPRequest::ChunkEnd() {
 void HTTPRequest::Chunk(const std::string& chunk) {
     assert(!replySent);
 
-    int status = 200;
-
-    if (!startedChunkTransfer) {
-        HTTPEvent* ev = new HTTPEvent(eventBase, true, NULL,
-                std::bind(evhttp_send_reply_start, req, status,
-                        (const char*) NULL));
-        ev->trigger(0);
-
-        startDetectClientClose();
-        startedChunkTransfer = true;
-    }
-
-
-    if (chunk.size() > 0) {
-        auto databuf = evbuffer_new(); // HTTPEvent will free this buffer
-        evbuffer_add(databuf, chunk.data(), chunk.size());
-        HTTPEvent* ev = new HTTPEvent(eventBase, true, databuf,
-                std::bind(evhttp_send_reply_chunk, req, databuf));
-        ev->trigger(0);
-    }
+    StartChunks(HTTP_OK);
+    SendChunk(chunk, /*track_drain=*/false);
 }
 
 /** Closure sent to main thread to request a reply to be sent to
@@ -773,23 +870,36 @@ void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, nullptr, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
-            }
-        }
+        http_reenable_reading(req_copy);
     });
     ev->trigger(nullptr);
     replySent = true;
     req = nullptr; // transferred back to main thread
 }
 
+void HTTPRequest::WriteReplyPart(int nStatus, std::string_view part, bool last)
+{
+    assert(!replySent && req);
+    if (!startedChunkTransfer && last) {
+        WriteReply(nStatus, part);
+        return;
+    }
+    StartChunks(nStatus);
+    // Hold the next part back until the client has taken the previous one,
+    // so that a slow reader does not make us buffer the whole body.
+    WaitChunkDrained();
+    if (!isConnClosed()) {
+        SendChunk(part, /*track_drain=*/true);
+    }
+    if (last) {
+        // No drain callback may be left pointing at this request
+        WaitChunkDrained();
+        EndChunks(/*wait=*/true);
+        replySent = true;
+        req = nullptr; // transferred back to main thread
+    }
+}
+
 CService HTTPRequest::GetPeer() const
 {
     evhttp_connection* con = evhttp_request_get_connection(req);
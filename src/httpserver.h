@@ -9,6 +9,7 @@
 #include <optional>
 #include <span>
 #include <string>
+#include <string_view>
 #include <mutex>
 #include <condition_variable>
 
@@ -77,6 +78,10 @@ private:
     bool replySent;
     bool startedChunkTransfer;
     bool connClosed;
+    //! Set once libevent has flushed the last part sent by WriteReplyPart
+    bool chunkDrained{true};
+    //! Set once the event thread has ended a streamed reply
+    bool chunksEnded{false};
 
     std::mutex cs;
     std::condition_variable closeCv;
@@ -84,6 +89,14 @@ private:
     void startDetectClientClose();
     void waitClientClose();
 
+    /** Send the status line and headers of a chunked reply, once. */
+    void StartChunks(int nStatus);
+    /** Queue one chunk. With track_drain, WaitChunkDrained waits for it to be flushed. */
+    void SendChunk(std::string_view chunk, bool track_drain);
+    void WaitChunkDrained();
+    /** End a chunked reply. With wait, return only once the event thread no longer refers to this request. */
+    void EndChunks(bool wait);
+
 public:
     explicit HTTPRequest(struct evhttp_request* req, const util::SignalInterrupt& interrupt, bool replySent = false);
     ~HTTPRequest();
@@ -158,6 +171,16 @@ public:
     }
     void WriteReply(int nStatus, std::span<const std::byte> reply);
 
+    /**
+     * Write HTTP reply in parts, as produced by a JSONStreamWriter sink.
+     * A reply that is complete in its first part is sent like WriteReply,
+     * otherwise chunked transfer encoding is used, and each part is only
+     * queued once the client has taken the previous one.
+     *
+     * @note Same constraints as WriteReply once called with last set.
+     */
+    void WriteReplyPart(int nStatus, std::string_view part, bool last);
+
     /**
      * Start chunk transfer. Assume to be 200.
      */
@@ -45,6 +45,7 @@
 #include <netgroup.h>
 #include <node/blockmanager_args.h>
 #include <node/blockstorage.h>
+#include <node/cache_warmup.h>
 #include <node/caches.h>
 #include <node/chainstate.h>
 #include <node/chainstatemanager_args.h>
@@ -62,12 +63,15 @@
 #include <policy/policy.h>
 #include <policy/settings.h>
 #include <protocol.h>
+#include <qtum/statediffjournal.h>
 #include <rpc/blockchain.h>
 #include <rpc/register.h>
+#include <rpc/response_cache.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <scheduler.h>
 #include <script/sigcache.h>
+#include <streams.h>
 #include <sync.h>
 #include <torcontrol.h>
 #include <txdb.h>
@@ -108,6 +112,7 @@
 #include <cstdio>
 #include <fstream>
 #include <functional>
+#include <limits>
 #include <set>
 #include <string>
 #include <thread>
@@ -156,6 +161,12 @@ static constexpr bool DEFAULT_PROXYRANDOMIZE{true};
 static constexpr bool DEFAULT_REST_ENABLE{false};
 static constexpr bool DEFAULT_I2P_ACCEPT_INCOMING{true};
 static constexpr bool DEFAULT_STOPAFTERBLOCKIMPORT{false};
+//! How often receipts outside of the -logeventsretain window are pruned
+static constexpr auto LOGEVENTS_PRUNE_INTERVAL{std::chrono::seconds{10}};
+//! How soon the next batch is pruned while there are more to prune
+static constexpr auto LOGEVENTS_PRUNE_BACKLOG_INTERVAL{std::chrono::milliseconds{500}};
+//! Most blocks pruned from the receipts at a time, short enough to not hold up the scheduler
+static constexpr int LOGEVENTS_PRUNE_BATCH{50};
 
 #ifdef WIN32
 // Win32 LevelDB doesn't use filedescriptors, and the ones used for
@@ -343,6 +354,7 @@ void Shutdown(NodeContext& node)
 
     // After the threads that potentially access these pointers have been stopped,
     // destruct and reset all to nullptr.
+    if (node.peerman) node.peerman->SaveChainUptime();
     node.peerman.reset();
     node.connman.reset();
     node.banman.reset();
@@ -350,7 +362,18 @@ void Shutdown(NodeContext& node)
     node.netgroupman.reset();
 
     if (node.mempool && node.mempool->GetLoadTried() && ShouldPersistMempool(*node.args)) {
-        DumpMempool(*node.mempool, MempoolPath(*node.args));
+        DumpMempool(*node.mempool, MempoolPath(*node.args), fsbridge::fopen, /*skip_file_commit=*/false,
+                    node.chainman ? &node.chainman->ActiveChainstate() : nullptr);
+    }
+
+    // Keep the dumped keys if their warm-up was cut short, the caches hold only part of them
+    const node::CacheWarmupProgress warmup{node::GetCacheWarmupProgress()};
+    if (node.chainman && node::ShouldWarmCaches(*node.args) && !warmup.active && (warmup.complete || warmup.coins + warmup.nodes == 0)) {
+        LOCK(cs_main);
+        Chainstate& chainstate{node.chainman->ActiveChainstate()};
+        if (chainstate.CanFlushToDisk()) {
+            node::DumpCacheWarmupKeys(node::GetCacheWarmupKeys(chainstate), node::CacheWarmupPath(*node.args));
+        }
     }
 
     // Drop transactions we were still watching, record fee estimations and unregister
@@ -420,6 +443,16 @@ void Shutdown(NodeContext& node)
     }
 #endif
 
+    if (g_state_diff_journal) {
+        if (node.validation_signals) node.validation_signals->UnregisterValidationInterface(g_state_diff_journal.get());
+        g_state_diff_journal.reset();
+    }
+
+    if (g_rpc_response_cache) {
+        if (node.validation_signals) node.validation_signals->UnregisterValidationInterface(g_rpc_response_cache.get());
+        g_rpc_response_cache.reset();
+    }
+
     node.chain_clients.clear();
     if (node.validation_signals) {
         node.validation_signals->UnregisterAllValidationInterfaces();
@@ -515,11 +548,13 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
                              kernel::DEFAULT_XOR_BLOCKSDIR),
                    ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-fastprune", "Use smaller block files and lower minimum prune height for testing purposes", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-blockarena", strprintf("Allocate the transactions of each block read from disk or received from peers from one arena (default: %u)", kernel::DEFAULT_BLOCK_ARENA), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
 #if HAVE_SYSTEM
     argsman.AddArg("-blocknotify=<cmd>", "Execute command when the best block changes (%s in cmd is replaced by block hash)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #endif
     argsman.AddArg("-blockreconstructionextratxn=<n>", strprintf("Extra transactions to keep in memory for compact block reconstructions (default: %u)", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blocksonly", strprintf("Whether to reject transactions from network peers. Disables automatic broadcast and rebroadcast of transactions, unless the source peer has the 'forcerelay' permission. RPC transactions are not affected. (default: %u)", DEFAULT_BLOCKSONLY), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-cachewarmup", strprintf("Whether to save the keys of the cached coins and the recently read EVM state entries on shutdown and prefetch them in the background on restart, before staking resumes (default: %u)", node::DEFAULT_CACHE_WARMUP), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-coinstatsindex", strprintf("Maintain coinstats index used by the gettxoutsetinfo RPC (default: %u)", DEFAULT_COINSTATSINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-conf=<file>", strprintf("Specify path to read-only configuration file. Relative paths will be prefixed by datadir location (only useable from command line, not configuration file) (default: %s)", BITCOIN_CONF_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-datadir=<dir>", "Specify data directory", ArgsManager::ALLOW_ANY | ArgsManager::DISALLOW_NEGATION, OptionsCategory::OPTIONS);
@@ -529,6 +564,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-allowignoredconf", strprintf("For backwards compatibility, treat an unused %s file in the datadir as a warning, not an error.", BITCOIN_CONF_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-loadblock=<file>", "Imports blocks from external file on startup", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE_MB), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-maxorphanblocksmib=<n>", strprintf("Keep at most <n> MiB of unconnectable blocks in memory, a quarter of it per peer (default: %u)", DEFAULT_MAX_ORPHAN_BLOCKS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxorphantx=<n>", strprintf("Keep at most <n> unconnectable transactions in memory (default: %u)", DEFAULT_MAX_ORPHAN_TRANSACTIONS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-mempoolexpiry=<n>", strprintf("Do not keep transactions in the mempool longer than <n> hours (default: %u)", DEFAULT_MEMPOOL_EXPIRY_HOURS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet3: %s, testnet4: %s, signet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnet4ChainParams->GetConsensus().nMinimumChainWork.GetHex(), signetChainParams->GetConsensus().nMinimumChainWork.GetHex()), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
@@ -540,6 +576,11 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
                              "(version 1) or the current format (version 2). This temporary option will be removed in the future. (default: %u)",
                              DEFAULT_PERSIST_V1_DAT),
                    ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-persistmempoolwitness",
+                   strprintf("Whether to store validation results with the transactions in mempool.dat, so that transactions whose "
+                             "results still apply at the chain tip are restored without verifying their scripts again (default: %u)",
+                             DEFAULT_PERSIST_WITNESS),
+                   ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", BITCOIN_PID_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
@@ -558,7 +599,10 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
                  " If <type> is not supplied or if <type> = 1, indexes for all known types are enabled.",
                  ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-logevents", strprintf("Maintain a full EVM log index, used by searchlogs and gettransactionreceipt rpc calls (default: %u)", DEFAULT_LOGEVENTS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-logeventsretain=<n>", strprintf("Only keep the receipts and log index entries of the last <n> blocks, pruning older ones in the background. The entries of the delegation contract used by super stakers are always kept (default: %u = keep all, otherwise at least %u)", DEFAULT_LOGEVENTS_RETAIN, MIN_BLOCKS_TO_KEEP), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-logeventsretainsize=<n>", strprintf("Prune the receipts and log index entries of the oldest blocks in the background to keep the receipts under about <n> MiB. The last %u blocks and the entries of the delegation contract are always kept (default: %u = no limit)", MIN_BLOCKS_TO_KEEP, DEFAULT_LOGEVENTS_RETAIN_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-addrindex", strprintf("Maintain a full address index (default: %u)", DEFAULT_ADDRINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-evmstatediffjournal=<n>", strprintf("Append the EVM account and storage changes of every block connected to or disconnected from the active chain to a rolling journal in the evmstatediff directory, keeping about <n> MiB of it (default: %u, 0 = disabled)", DEFAULT_STATE_DIFF_JOURNAL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-deleteblockchaindata", "Delete the local copy of the block chain data", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-forceinitialblocksdownloadmode", strprintf("Force initial blocks download mode for the node (default: %u)", DEFAULT_FORCE_INITIAL_BLOCKS_DOWNLOAD_MODE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 
@@ -591,6 +635,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-v2transport", strprintf("Support v2 transport (default: %u)", DEFAULT_V2_TRANSPORT), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-peerbloomfilters", strprintf("Support filtering of blocks and transaction with bloom filters (default: %u)", DEFAULT_PEERBLOOMFILTERS), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-peerblockfilters", strprintf("Serve compact block filters to peers per BIP 157 (default: %u)", DEFAULT_PEERBLOCKFILTERS), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
+    argsman.AddArg("-peerevmstate", strprintf("Serve the EVM state of recent blocks to peers syncing it (default: %u)", DEFAULT_PEEREVMSTATE), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-txreconciliation", strprintf("Enable transaction reconciliations per BIP 330 (default: %d)", DEFAULT_TXRECONCILIATION_ENABLE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::CONNECTION);
     argsman.AddArg("-port=<port>", strprintf("Listen for connections on <port> (default: %u, testnet3: %u, testnet4: %u, signet: %u, regtest: %u). Not relevant for I2P (see doc/i2p.md). If set to a value x, the default onion listening port will be set to x+1.", defaultChainParams->GetDefaultPort(), testnetChainParams->GetDefaultPort(), testnet4ChainParams->GetDefaultPort(), signetChainParams->GetDefaultPort(), regtestChainParams->GetDefaultPort()), ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY, OptionsCategory::CONNECTION);
 #ifdef HAVE_SOCKADDR_UN
@@ -629,22 +674,26 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-zmqpubrawblock=<address>", "Enable publish raw block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtx=<address>", "Enable publish raw transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequence=<address>", "Enable publish hash block and tx sequence in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubevmstatediff=<address>", "Enable publish EVM state changes of connected and disconnected blocks in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashblockhwm=<n>", strprintf("Set publish hash block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashtxhwm=<n>", strprintf("Set publish hash transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawblockhwm=<n>", strprintf("Set publish raw block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtxhwm=<n>", strprintf("Set publish raw transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequencehwm=<n>", strprintf("Set publish hash sequence message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubevmstatediffhwm=<n>", strprintf("Set publish EVM state changes message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
 #else
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
     hidden_args.emplace_back("-zmqpubrawblock=<address>");
     hidden_args.emplace_back("-zmqpubrawtx=<address>");
     hidden_args.emplace_back("-zmqpubsequence=<n>");
+    hidden_args.emplace_back("-zmqpubevmstatediff=<address>");
     hidden_args.emplace_back("-zmqpubhashblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubhashtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubsequencehwm=<n>");
+    hidden_args.emplace_back("-zmqpubevmstatediffhwm=<n>");
 #endif
 
     argsman.AddArg("-checkblocks=<n>", strprintf("How many blocks to check at startup (default: %u, 0 = all)", DEFAULT_CHECKBLOCKS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -679,6 +728,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-offlinestakingheight=<n>", "Use given block height to check offline staking fork (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-delegationsaddress=<adr>", "Use given contract delegations address for offline staking fork (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-lastmposheight=<n>", "Use given block height to check remove mpos fork (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-mposbalanceheight=<n>", "Use given block height to check accrued MPoS balances fork (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-reduceblocktimeheight=<n>", "Use given block height to check blocks with reduced target spacing (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-powallowmindifficultyblocks", "Use given value for pow allow min difficulty blocks parameter (regtest-only, default: 1)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-pownoretargeting", "Use given value for pow no retargeting parameter (regtest-only, default: 1)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
@@ -689,6 +739,8 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-shanghaiheight=<n>", "Use given block height to check contracts with EVM Shanghai (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-cancunheight=<n>", "Use given block height to check contracts with EVM Cancun (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-pectraheight=<n>", "Use given block height to check contracts with EVM Pectra (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-dilithiumkeyrefheight=<n>", "Use given block height to allow Dilithium public key references in spends (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-heartbeataggregateheight=<n>", "Use given block height to activate heartbeat aggregates in proof-of-stake blocks (regtest-only)", ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
 
     SetupChainParamsBaseOptions(argsman);
 
@@ -727,6 +779,8 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-rpcauth=<userpw>", "Username and HMAC-SHA-256 hashed password for JSON-RPC connections. The field <userpw> comes in the format: <USERNAME>:<SALT>$<HASH>. A canonical python script is included in share/rpcauth. The client then connects normally using the rpcuser=<USERNAME>/rpcpassword=<PASSWORD> pair of arguments. This option can be specified multiple times", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcbind=<addr>[:port]", "Bind to given address to listen for JSON-RPC connections. Do not expose the RPC server to untrusted networks such as the public internet! This option is ignored unless -rpcallowip is also passed. Port is optional and overrides -rpcport. Use [host]:port notation for IPv6. This option can be specified multiple times (default: 127.0.0.1 and ::1 i.e., localhost)", ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-rpcdoccheck", strprintf("Throw a non-fatal error at runtime if the documentation for an RPC is incorrect (default: %u)", DEFAULT_RPC_DOC_CHECK), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
+    argsman.AddArg("-rpccachedepth=<n>", strprintf("Only cache responses about blocks with at least <n> confirmations (default: %d)", DEFAULT_RPC_CACHE_DEPTH), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpccachesize=<n>", strprintf("Keep up to <n> MiB of memory for responses of getblock, getblockheader, getrawtransaction, gettransactionreceipt and searchlogs about blocks deep in the active chain, to answer repeated requests without reading them from disk (default: %u, 0 = disabled)", DEFAULT_RPC_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpccookiefile=<loc>", "Location of the auth cookie. Relative paths will be prefixed by a net-specific datadir location. (default: data dir)", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpccookieperms=<readable-by>", strprintf("Set permissions on the RPC auth cookie file so that it is readable by [owner|group|all] (default: owner [via umask 0077])"), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcpassword=<pw>", "Password for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
@@ -791,6 +845,15 @@ static void StartupNotify(const ArgsManager& args)
 }
 #endif
 
+/** Prune the receipts in small batches, the next one soon while there are more to prune */
+static void SchedulePruneLogEvents(CScheduler& scheduler, ChainstateManager& chainman, unsigned int retain_blocks, uint64_t retain_bytes, std::chrono::milliseconds delta)
+{
+    scheduler.scheduleFromNow([&scheduler, &chainman, retain_blocks, retain_bytes] {
+        const bool more{PruneLogEvents(chainman, retain_blocks, retain_bytes, LOGEVENTS_PRUNE_BATCH)};
+        SchedulePruneLogEvents(scheduler, chainman, retain_blocks, retain_bytes, more ? LOGEVENTS_PRUNE_BACKLOG_INTERVAL : LOGEVENTS_PRUNE_INTERVAL);
+    }, delta);
+}
+
 static bool AppInitServers(NodeContext& node)
 {
     const ArgsManager& args = *Assert(node.args);
@@ -1072,6 +1135,10 @@ bool AppInitParameterInteraction(const ArgsManager& args)
         g_local_services = ServiceFlags(g_local_services | NODE_COMPACT_FILTERS);
     }
 
+    if (args.GetBoolArg("-peerevmstate", DEFAULT_PEEREVMSTATE)) {
+        g_local_services = ServiceFlags(g_local_services | NODE_EVM_STATE);
+    }
+
     if (args.GetIntArg("-prune", 0)) {
         if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX))
             return InitError(_("Prune mode is incompatible with -txindex."));
@@ -1080,6 +1147,14 @@ bool AppInitParameterInteraction(const ArgsManager& args)
         }
     }
 
+    const int64_t logevents_retain{args.GetIntArg("-logeventsretain", DEFAULT_LOGEVENTS_RETAIN)};
+    if (logevents_retain < 0 || (logevents_retain > 0 && logevents_retain < MIN_BLOCKS_TO_KEEP)) {
+        return InitError(Untranslated(strprintf("-logeventsretain must be 0 or at least %u.", MIN_BLOCKS_TO_KEEP)));
+    }
+    if (args.GetIntArg("-logeventsretainsize", DEFAULT_LOGEVENTS_RETAIN_SIZE) < 0) {
+        return InitError(Untranslated("-logeventsretainsize cannot be negative."));
+    }
+
     // If -forcednsseed is set to true, ensure -dnsseed has not been set to false
     if (args.GetBoolArg("-forcednsseed", DEFAULT_FORCEDNSSEED) && !args.GetBoolArg("-dnsseed", DEFAULT_DNSSEED)){
         return InitError(_("Cannot set -forcednsseed to true when setting -dnsseed to false."));
@@ -1319,6 +1394,20 @@ bool AppInitParameterInteraction(const ArgsManager& args)
         }
     }
 
+    if (args.IsArgSet("-mposbalanceheight")) {
+        // Allow overriding MPoS balance block height for testing
+        if (!chainparams.MineBlocksOnDemand()) {
+            return InitError(Untranslated("MPoS balance block height may only be overridden on regtest."));
+        }
+
+        int mposBalanceHeight = args.GetIntArg("-mposbalanceheight", 0);
+        if(mposBalanceHeight >= 0)
+        {
+            UpdateMPoSBalanceHeight(mposBalanceHeight);
+            LogPrintf("Activate MPoS balances at block height %d\n.", mposBalanceHeight);
+        }
+    }
+
     if (args.IsArgSet("-reduceblocktimeheight")) {
         // Allow overriding short block time block height for testing
         if (!chainparams.MineBlocksOnDemand()) {
@@ -1450,6 +1539,34 @@ bool AppInitParameterInteraction(const ArgsManager& args)
         }
     }
 
+    if (args.IsArgSet("-dilithiumkeyrefheight")) {
+        // Allow overriding Dilithium key reference block height for testing
+        if (!chainparams.MineBlocksOnDemand()) {
+            return InitError(Untranslated("Short Dilithium key reference height may only be overridden on regtest."));
+        }
+
+        int dilithiumkeyrefheight = args.GetIntArg("-dilithiumkeyrefheight", 0);
+        if(dilithiumkeyrefheight >= 0)
+        {
+            UpdateDilithiumKeyRefHeight(dilithiumkeyrefheight);
+            LogPrintf("Activate Dilithium key references at block height %d\n.", dilithiumkeyrefheight);
+        }
+    }
+
+    if (args.IsArgSet("-heartbeataggregateheight")) {
+        // Allow overriding heartbeat aggregate block height for testing
+        if (!chainparams.MineBlocksOnDemand()) {
+            return InitError(Untranslated("Heartbeat aggregate height may only be overridden on regtest."));
+        }
+
+        int heartbeataggregateheight = args.GetIntArg("-heartbeataggregateheight", 0);
+        if(heartbeataggregateheight >= 0)
+        {
+            UpdateHeartbeatAggregateHeight(heartbeataggregateheight);
+            LogPrintf("Activate heartbeat aggregates at block height %d\n.", heartbeataggregateheight);
+        }
+    }
+
     if(args.IsArgSet("-stakingallowlist") && args.IsArgSet("-stakingexcludelist"))
     {
         return InitError(Untranslated("Either -stakingallowlist or -stakingexcludelist parameter can be specified to the staker, not both."));
@@ -1557,6 +1674,7 @@ bool CheckHostPortOptions(const ArgsManager& args) {
         {"-zmqpubrawblock",         true},
         {"-zmqpubrawtx",            true},
         {"-zmqpubsequence",         true},
+        {"-zmqpubevmstatediff",     true},
     }) {
         for (const std::string& socket_addr : args.GetArgs(arg)) {
             std::string host_out;
@@ -2030,11 +2148,40 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
             return InitError(ResolveErrMsg("externalip", strAddr));
     }
 
+    const int64_t state_diff_journal{args.GetIntArg("-evmstatediffjournal", DEFAULT_STATE_DIFF_JOURNAL)};
+    if (state_diff_journal < 0) {
+        return InitError(Untranslated("-evmstatediffjournal cannot be negative."));
+    }
+    if (state_diff_journal > 0 || !args.GetArgs("-zmqpubevmstatediff").empty()) {
+        g_state_diff_journal = std::make_unique<StateDiffJournal>(args.GetDataDirNet() / "evmstatediff", uint64_t(state_diff_journal) << 20);
+        if (g_state_diff_journal->IsJournaling()) {
+            validation_signals.RegisterValidationInterface(g_state_diff_journal.get());
+        }
+    }
+
+    const int64_t rpc_cache_size{args.GetIntArg("-rpccachesize", DEFAULT_RPC_CACHE_SIZE)};
+    if (rpc_cache_size < 0) {
+        return InitError(Untranslated("-rpccachesize cannot be negative."));
+    }
+    const int64_t rpc_cache_depth{args.GetIntArg("-rpccachedepth", DEFAULT_RPC_CACHE_DEPTH)};
+    if (rpc_cache_depth < 1) {
+        return InitError(Untranslated("-rpccachedepth must be at least 1."));
+    }
+    if (rpc_cache_size > 0) {
+        g_rpc_response_cache = std::make_unique<RPCResponseCache>(size_t(rpc_cache_size) << 20, int(std::min<int64_t>(rpc_cache_depth, std::numeric_limits<int>::max())));
+        validation_signals.RegisterValidationInterface(g_rpc_response_cache.get());
+    }
+
 #ifdef ENABLE_ZMQ
     g_zmq_notification_interface = CZMQNotificationInterface::Create(
         [&chainman = node.chainman](std::vector<uint8_t>& block, const CBlockIndex& index) {
             assert(chainman);
             return chainman->m_blockman.ReadRawBlock(block, WITH_LOCK(cs_main, return index.GetBlockPos()));
+        },
+        [](std::vector<uint8_t>& diff, const CBlockIndex& index) {
+            assert(g_state_diff_journal);
+            VectorWriter{diff, 0, g_state_diff_journal->GetOrUnavailable(index)};
+            return true;
         });
 
     if (g_zmq_notification_interface) {
@@ -2061,6 +2208,7 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
                   index_cache_sizes.filter_index * (1.0 / 1024 / 1024), BlockFilterTypeName(filter_type));
     }
     LogInfo("* Using %.1f MiB for chain state database", kernel_cache_sizes.coins_db * (1.0 / 1024 / 1024));
+    LogInfo("* Using %.1f MiB for EVM state databases", kernel_cache_sizes.evm_state_db * (1.0 / 1024 / 1024));
 
     assert(!node.mempool);
     assert(!node.chainman);
@@ -2108,6 +2256,13 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
 
     ChainstateManager& chainman = *Assert(node.chainman);
 
+    // Load the cache keys of the last run, prefetched once the node has started
+    const bool cache_warmup{node::ShouldWarmCaches(args)};
+    if (cache_warmup && globalState) {
+        node::RecordStateReads(*globalState);
+        if (!do_reindex && !do_reindex_chainstate) node::LoadCacheWarmup(node::CacheWarmupPath(args));
+    }
+
     assert(!node.peerman);
     node.peerman = PeerManager::make(*node.connman, *node.addrman,
                                      node.banman.get(), chainman,
@@ -2143,7 +2298,9 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     // ********************************************************* Step 8c: initialize trust system
     LogPrintf("Initializing trust system...\n");
     static trust::TrustScoreManager trust_manager(chainparams.GetConsensus());
+    trust_manager.LoadDemotions(args.GetDataDirNet() / "equivocations.dat");
     trust::InitHeartbeatManager(trust_manager, chainparams.GetConsensus());
+    node.peerman->LoadChainUptime(args.GetDataDirNet() / "uptime.dat");
     trust::InitPeerDiscovery(fs::PathToString(args.GetDataDirNet()));
 
     // ********************************************************* Step 9: load wallet
@@ -2175,6 +2332,14 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         }
     }
 
+    // prune receipts and log index entries outside of the retention window
+    // in the background, from the oldest block up
+    const unsigned int logevents_retain{(unsigned int)args.GetIntArg("-logeventsretain", DEFAULT_LOGEVENTS_RETAIN)};
+    const uint64_t logevents_retain_bytes{uint64_t(args.GetIntArg("-logeventsretainsize", DEFAULT_LOGEVENTS_RETAIN_SIZE)) << 20};
+    if (fLogEvents && (logevents_retain > 0 || logevents_retain_bytes > 0)) {
+        SchedulePruneLogEvents(scheduler, chainman, logevents_retain, logevents_retain_bytes, LOGEVENTS_PRUNE_INTERVAL);
+    }
+
     // ********************************************************* Step 11: import blocks
 
     if (!CheckDiskSpace(args.GetDataDirNet())) {
@@ -2245,9 +2410,13 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         }
         // Load mempool from disk
         if (auto* pool{chainman.ActiveChainstate().GetMempool()}) {
-            LoadMempool(*pool, ShouldPersistMempool(args) ? MempoolPath(args) : fs::path{}, chainman.ActiveChainstate(), {});
+            LoadMempool(*pool, ShouldPersistMempool(args) ? MempoolPath(args) : fs::path{}, chainman.ActiveChainstate(), {.use_restore_witness = true});
             pool->SetLoadTried(!chainman.m_interrupt);
         }
+
+        // Prefetch the cache keys of the last run once the indexes are
+        // started and the mempool is loaded, so that it holds up neither
+        if (cache_warmup) node::RunCacheWarmup(chainman.ActiveChainstate(), chainman.m_interrupt);
     });
 
     node.peerman->InitCleanBlockIndex();
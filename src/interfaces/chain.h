@@ -438,6 +438,9 @@ public:
     //! Get transaction gas fee.
     virtual CAmount getTxGasFee(const CMutableTransaction& tx) = 0;
 
+    //! Get the DGP minimum gas price of contract executions in the next block.
+    virtual uint64_t getMinGasPrice() = 0;
+
 #ifdef ENABLE_WALLET
     //! Start staking qtums.
     virtual void startStake(wallet::CWallet& wallet) = 0;
@@ -94,6 +94,44 @@ public:
     virtual std::unique_ptr<BlockTemplate> createNewBlock(const node::BlockCreateOptions& options = {},
                                                                  bool fProofOfStake=false, int64_t* pTotalFees = 0, int32_t nTime=0, int32_t nTimeLimit=0) = 0;
 
+    //! Returns the proof-of-stake parameters of the block on top of the tip
+    virtual std::optional<node::StakeTarget> getStakeTarget() = 0;
+
+    /**
+     * Get the changes to the coins that can be staked since a block, from the
+     * blocks connected since. A full scan of the UTXO set is only done for a
+     * null or reorganized block, or one too far behind the tip.
+     *
+     * @param[in] scripts output scripts the staker can sign for
+     * @param[in] since   tip of the previous update, or null
+     * @returns           coins paying to one of the scripts created and spent
+     *                    since, with a null tip if the chain changed meanwhile
+     */
+    virtual node::StakeCoinsUpdate getStakeCoins(const std::vector<CScript>& scripts, const uint256& since) = 0;
+
+    /**
+     * Construct a proof-of-stake block for a kernel found by the caller. The
+     * coinstake spends the kernel and pays the stake and reward to
+     * options.coinbase_output_script; its input and the block are left
+     * unsigned.
+     *
+     * @param[in] options   options for creating the block
+     * @param[in] prev_hash tip the kernel was found on
+     * @param[in] kernel    staked coin
+     * @param[in] time      block time the kernel was found for
+     * @returns a block template, or nullptr if the tip changed or the kernel
+     *          does not meet the target
+     */
+    virtual std::unique_ptr<BlockTemplate> createNewStakeBlock(const node::BlockCreateOptions& options, const uint256& prev_hash,
+                                                               const COutPoint& kernel, uint32_t time) = 0;
+
+    /**
+     * Process a signed proof-of-stake block.
+     *
+     * @returns if the block was new and accepted
+     */
+    virtual bool submitStakeBlock(const CBlock& block) = 0;
+
     //! Get internal node context. Useful for RPC and testing,
     //! but not accessible across processes.
     virtual node::NodeContext* context() { return nullptr; }
@@ -16,6 +16,7 @@ class CChainParams;
 namespace kernel {
 
 static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+static constexpr bool DEFAULT_BLOCK_ARENA{false};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -26,6 +27,8 @@ struct BlockManagerOpts {
     bool use_xor{DEFAULT_XOR_BLOCKSDIR};
     uint64_t prune_target{0};
     bool fast_prune{false};
+    //! Allocate the transactions of blocks read from disk or the network from one arena per block
+    bool block_arena{DEFAULT_BLOCK_ARENA};
     const fs::path blocks_dir;
     Notifications& notifications;
     DBParams block_tree_db_params;
@@ -15,11 +15,14 @@ static constexpr size_t DEFAULT_KERNEL_CACHE{450_MiB};
 static constexpr size_t MAX_BLOCK_DB_CACHE{2_MiB};
 //! Max memory allocated to coin DB specific cache (bytes)
 static constexpr size_t MAX_COINS_DB_CACHE{8_MiB};
+//! Max memory allocated to the block caches of the EVM state databases combined (bytes)
+static constexpr size_t MAX_EVM_STATE_DB_CACHE{64_MiB};
 
 namespace kernel {
 struct CacheSizes {
     size_t block_tree_db;
     size_t coins_db;
+    size_t evm_state_db;
     size_t coins;
 
     CacheSizes(size_t total_cache)
@@ -28,6 +31,8 @@ struct CacheSizes {
         total_cache -= block_tree_db;
         coins_db = std::min(total_cache / 2, MAX_COINS_DB_CACHE);
         total_cache -= coins_db;
+        evm_state_db = std::min(total_cache / 8, MAX_EVM_STATE_DB_CACHE);
+        total_cache -= evm_state_db;
         coins = total_cache; // the rest goes to the coins cache
     }
 };
@@ -27,6 +27,7 @@
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <type_traits>
 
 ///////////////////////////////////////////// // qtum
@@ -129,6 +130,7 @@ public:
         consensus.nShanghaiHeight = 0;
         consensus.nCancunHeight = 0;
         consensus.nPectraHeight = 0;
+        consensus.nDilithiumKeyRefHeight = std::numeric_limits<int>::max(); // Not yet scheduled
         consensus.powLimit = uint256{"0000ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.posLimit = uint256{"00000000ffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.QIP9PosLimit = uint256{"0000000000001fffffffffffffffffffffffffffffffffffffffffffffffffff"};
@@ -285,6 +287,7 @@ public:
         consensus.nShanghaiHeight = 0;
         consensus.nCancunHeight = 0;
         consensus.nPectraHeight = 0;
+        consensus.nDilithiumKeyRefHeight = std::numeric_limits<int>::max(); // Not yet scheduled
         consensus.powLimit = uint256{"0000ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.posLimit = uint256{"0000ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.QIP9PosLimit = uint256{"0000000000001fffffffffffffffffffffffffffffffffffffffffffffffffff"}; // The new POS-limit activated after QIP9
@@ -435,6 +438,7 @@ public:
         consensus.nShanghaiHeight = 0;
         consensus.nCancunHeight = 0;
         consensus.nPectraHeight = 0;
+        consensus.nDilithiumKeyRefHeight = std::numeric_limits<int>::max(); // Not yet scheduled
         consensus.powLimit = uint256{"0000ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.posLimit = uint256{"0000ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.QIP9PosLimit = uint256{"0000000000001fffffffffffffffffffffffffffffffffffffffffffffffffff"}; // The new POS-limit activated after QIP9
@@ -603,6 +607,7 @@ public:
         consensus.nShanghaiHeight = 0;
         consensus.nCancunHeight = 0;
         consensus.nPectraHeight = 0;
+        consensus.nDilithiumKeyRefHeight = std::numeric_limits<int>::max(); // Not yet scheduled
         consensus.powLimit = uint256{"0000ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.posLimit = uint256{"0000ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.QIP9PosLimit = uint256{"0000000000001fffffffffffffffffffffffffffffffffffffffffffffffffff"}; // The new POS-limit activated after QIP9
@@ -716,6 +721,7 @@ public:
         consensus.nShanghaiHeight = 0;
         consensus.nCancunHeight = 0;
         consensus.nPectraHeight = 0;
+        consensus.nDilithiumKeyRefHeight = 0;
         consensus.powLimit = uint256{"7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.posLimit = uint256{"7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
         consensus.QIP9PosLimit = uint256{"7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"}; // The new POS-limit activated after QIP9
@@ -829,6 +835,7 @@ public:
         consensus.nRBTCoinbaseMaturity = 10;  // WATTx regtest: lowered for fast testing
         consensus.nSubsidyHalvingIntervalV2 = consensus.nBlocktimeDownscaleFactor*985500; // qtum halving every 4 years (nSubsidyHalvingInterval * nBlocktimeDownscaleFactor)
         consensus.nMinValidatorStake = 100 * COIN; // Lower for regtest (100 WATTx)
+        consensus.nHeartbeatAggregateHeight = 0;
 
         consensus.nLastPOWBlock = 0x7fffffff;
         consensus.nLastBigReward = 5000;
@@ -1046,6 +1053,11 @@ void CChainParams::UpdateLastMPoSBlockHeight(int nHeight)
     consensus.nLastMPoSBlock = nHeight;
 }
 
+void CChainParams::UpdateMPoSBalanceHeight(int nHeight)
+{
+    consensus.nMPoSBalanceHeight = nHeight;
+}
+
 void CChainParams::UpdateReduceBlocktimeHeight(int nHeight)
 {
     consensus.nReduceBlocktimeHeight = nHeight;
@@ -1105,3 +1117,13 @@ void CChainParams::UpdatePectraHeight(int nHeight)
 {
     consensus.nPectraHeight = nHeight;
 }
+
+void CChainParams::UpdateDilithiumKeyRefHeight(int nHeight)
+{
+    consensus.nDilithiumKeyRefHeight = nHeight;
+}
+
+void CChainParams::UpdateHeartbeatAggregateHeight(int nHeight)
+{
+    consensus.nHeartbeatAggregateHeight = nHeight;
+}
@@ -133,6 +133,7 @@ public:
     void UpdateOfflineStakingBlockHeight(int nHeight);
     void UpdateDelegationsAddress(const uint160& address);
     void UpdateLastMPoSBlockHeight(int nHeight);
+    void UpdateMPoSBalanceHeight(int nHeight);
     void UpdateReduceBlocktimeHeight(int nHeight);
     void UpdatePowAllowMinDifficultyBlocks(bool fValue);
     void UpdatePowNoRetargeting(bool fValue);
@@ -144,6 +145,8 @@ public:
     void UpdateShanghaiHeight(int nHeight);
     void UpdateCancunHeight(int nHeight);
     void UpdatePectraHeight(int nHeight);
+    void UpdateDilithiumKeyRefHeight(int nHeight);
+    void UpdateHeartbeatAggregateHeight(int nHeight);
 
     std::optional<AssumeutxoData> AssumeutxoForHeight(int height) const
     {
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <core_memusage.h>
 #include <memusage.h>
+#include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <util/hasher.h>
 
@@ -50,7 +51,8 @@ size_t DisconnectedBlockTransactions::DynamicMemoryUsage() const
 {
     iters_by_txid.reserve(iters_by_txid.size() + vtx.size());
     for (auto block_it = vtx.rbegin(); block_it != vtx.rend(); ++block_it) {
-        auto it = queuedTx.insert(queuedTx.end(), *block_it);
+        // The transactions go back to the mempool, and must not keep the arena of their block alive
+        auto it = queuedTx.insert(queuedTx.end(), BlockWithArena::Detach(*block_it));
         auto [_, inserted] = iters_by_txid.emplace((*block_it)->GetHash(), it);
         assert(inserted); // callers may never pass multiple transactions with the same txid
         cachedInnerUsage += RecursiveDynamicUsage(*block_it);
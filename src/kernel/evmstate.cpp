@@ -0,0 +1,138 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kernel/evmstate.h>
+
+#include <chain.h>
+#include <primitives/block.h>
+#include <qtum/qtumstate.h>
+#include <util/check.h>
+#include <util/convert.h>
+#include <validation.h>
+
+#include <libethereum/State.h>
+
+#include <sstream>
+
+namespace kernel {
+
+EvmStateView::EvmStateView(const CBlockIndex& block)
+{
+    LOCK(::cs_main);
+    m_state = std::make_unique<dev::eth::State>(dev::u256(0), Assert(globalState)->db(), dev::eth::BaseState::PreExisting);
+    m_state->setRoot(uintToh256(block.hashStateRoot));
+}
+
+EvmStateView::~EvmStateView()
+{
+    LOCK(::cs_main);
+    m_state.reset();
+}
+
+bool EvmStateView::AddressInUse(const uint160& address) const
+{
+    LOCK(::cs_main);
+    return m_state->addressInUse(uintToh160(address));
+}
+
+CAmount EvmStateView::Balance(const uint160& address) const
+{
+    LOCK(::cs_main);
+    return CAmount(m_state->balance(uintToh160(address)));
+}
+
+std::vector<unsigned char> EvmStateView::Code(const uint160& address) const
+{
+    LOCK(::cs_main);
+    return m_state->code(uintToh160(address));
+}
+
+uint256 EvmStateView::StorageAt(const uint160& address, const uint256& key) const
+{
+    LOCK(::cs_main);
+    return u256Touint(m_state->storage(uintToh160(address), uintTou256(key)));
+}
+
+std::map<uint256, uint256> EvmStateView::Storage(const uint160& address) const
+{
+    LOCK(::cs_main);
+    std::map<uint256, uint256> result;
+    // Entries are keyed by the hash of the storage key
+    for (const auto& [hashed_key, entry] : m_state->storage(uintToh160(address))) {
+        result.emplace(u256Touint(entry.first), u256Touint(entry.second));
+    }
+    return result;
+}
+
+static ContractReceipt MakeReceipt(const TransactionReceiptInfo& info)
+{
+    ContractReceipt receipt;
+    receipt.block_hash = info.blockHash;
+    receipt.block_number = info.blockNumber;
+    receipt.tx_hash = info.transactionHash;
+    receipt.tx_index = info.transactionIndex;
+    receipt.output_index = info.outputIndex;
+    receipt.from = h160Touint(info.from);
+    receipt.to = h160Touint(info.to);
+    receipt.contract_address = h160Touint(info.contractAddress);
+    receipt.gas_used = info.gasUsed;
+    receipt.cumulative_gas_used = info.cumulativeGasUsed;
+    std::stringstream ss;
+    ss << info.excepted;
+    receipt.excepted = ss.str();
+    receipt.excepted_message = info.exceptedMessage;
+    receipt.state_root = h256Touint(info.stateRoot);
+    receipt.utxo_root = h256Touint(info.utxoRoot);
+    receipt.logs.reserve(info.logs.size());
+    for (const dev::eth::LogEntry& entry : info.logs) {
+        ContractLog& log = receipt.logs.emplace_back();
+        log.address = h160Touint(entry.address);
+        log.topics.reserve(entry.topics.size());
+        for (const dev::h256& topic : entry.topics) {
+            log.topics.push_back(h256Touint(topic));
+        }
+        log.data = entry.data;
+    }
+    return receipt;
+}
+
+std::vector<ContractReceipt> GetTransactionReceipts(const uint256& txid)
+{
+    AssertLockHeld(::cs_main);
+    std::vector<ContractReceipt> receipts;
+    for (const TransactionReceiptInfo& info : Assert(pstorageresult)->getResult(uintToh256(txid))) {
+        receipts.push_back(MakeReceipt(info));
+    }
+    return receipts;
+}
+
+std::vector<ContractReceipt> GetBlockReceipts(const CBlock& block)
+{
+    AssertLockHeld(::cs_main);
+    std::vector<ContractReceipt> receipts;
+    for (const CTransactionRef& tx : block.vtx) {
+        if (!tx->HasCreateOrCall() && !tx->HasOpSpend()) continue;
+        std::vector<ContractReceipt> tx_receipts{GetTransactionReceipts(tx->GetHash())};
+        receipts.insert(receipts.end(), std::make_move_iterator(tx_receipts.begin()), std::make_move_iterator(tx_receipts.end()));
+    }
+    return receipts;
+}
+
+EvmBlockSubscriber::EvmBlockSubscriber(Callback connected, Callback disconnected)
+    : m_connected(std::move(connected)), m_disconnected(std::move(disconnected)) {}
+
+void EvmBlockSubscriber::BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    // Background validation of a snapshot does not move the active chain
+    if (role == ChainstateRole::BACKGROUND || !m_connected) return;
+    std::vector<ContractReceipt> receipts{WITH_LOCK(::cs_main, return GetBlockReceipts(*block))};
+    m_connected(*block, *pindex, receipts);
+}
+
+void EvmBlockSubscriber::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    if (m_disconnected) m_disconnected(*block, *pindex, {});
+}
+
+} // namespace kernel
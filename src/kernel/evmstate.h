@@ -0,0 +1,124 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_KERNEL_EVMSTATE_H
+#define BITCOIN_KERNEL_EVMSTATE_H
+
+#include <consensus/amount.h>
+#include <kernel/cs_main.h>
+#include <uint256.h>
+#include <validationinterface.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+class ChainstateManager;
+
+namespace dev::eth {
+class State;
+} // namespace dev::eth
+
+//! Embedded access to the contract state and execution results of a loaded
+//! chainstate, so indexers can read them without going through JSON-RPC.
+//!
+//! Addresses are the 20 bytes of the EVM address in order, storage keys and
+//! values are 256-bit big-endian words.
+namespace kernel {
+
+//! Log entry emitted by a contract
+struct ContractLog {
+    uint160 address;
+    std::vector<uint256> topics;
+    std::vector<unsigned char> data;
+};
+
+//! Execution result of one contract output of a transaction
+struct ContractReceipt {
+    uint256 block_hash;
+    uint32_t block_number{0};
+    uint256 tx_hash;
+    uint32_t tx_index{0};
+    uint32_t output_index{0};
+    uint160 from;
+    uint160 to;
+    uint160 contract_address;
+    uint64_t gas_used{0};
+    uint64_t cumulative_gas_used{0};
+    //! "None" if the execution succeeded
+    std::string excepted;
+    std::string excepted_message;
+    uint256 state_root;
+    uint256 utxo_root;
+    std::vector<ContractLog> logs;
+};
+
+/**
+ * Read-only view of the contract state committed by a block of the active
+ * chain. It shares the state database of the chainstate but keeps its own
+ * root. Block validation writes to the same database, so every lookup takes
+ * cs_main and waits for a block being connected.
+ */
+class EvmStateView
+{
+public:
+    explicit EvmStateView(const CBlockIndex& block);
+    ~EvmStateView();
+
+    EvmStateView(const EvmStateView&) = delete;
+    EvmStateView& operator=(const EvmStateView&) = delete;
+
+    bool AddressInUse(const uint160& address) const;
+    CAmount Balance(const uint160& address) const;
+    std::vector<unsigned char> Code(const uint160& address) const;
+    //! Value of one storage word, zero if unset
+    uint256 StorageAt(const uint160& address, const uint256& key) const;
+    //! Every storage word set by the contract
+    std::map<uint256, uint256> Storage(const uint160& address) const;
+
+private:
+    std::unique_ptr<dev::eth::State> m_state;
+};
+
+/**
+ * Receipts of the contract transactions of a connected block, in block order.
+ * Receipts are only stored by nodes running with -logevents; otherwise the
+ * result is empty.
+ */
+std::vector<ContractReceipt> GetBlockReceipts(const CBlock& block) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+//! Receipts of one transaction, one per contract output
+std::vector<ContractReceipt> GetTransactionReceipts(const uint256& txid) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+/**
+ * Validation interface forwarding blocks connected to and disconnected from
+ * the active chain together with their execution results. Disconnected
+ * blocks carry no receipts, their results are erased with the block.
+ * Register it with ValidationSignals::RegisterSharedValidationInterface.
+ */
+class EvmBlockSubscriber final : public CValidationInterface
+{
+public:
+    using Callback = std::function<void(const CBlock& block, const CBlockIndex& index, const std::vector<ContractReceipt>& receipts)>;
+
+    EvmBlockSubscriber(Callback connected, Callback disconnected);
+
+protected:
+    void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override;
+
+private:
+    const Callback m_connected;
+    const Callback m_disconnected;
+};
+
+} // namespace kernel
+
+#endif // BITCOIN_KERNEL_EVMSTATE_H
@@ -90,6 +90,7 @@ private:
     CAmount m_modified_fee;         //!< Used for determining the priority of the transaction for mining in a block
     mutable LockPoints lockPoints;  //!< Track the height and time at which tx was final
     CAmount nMinGasPrice{0};        //!< The minimum gas price among the contract outputs of the tx
+    const uint64_t nGasLimit{0};    //!< Total gas limit of the contract outputs of the tx
 
     // Information about descendants of this transaction that are in the
     // mempool; if we remove this transaction we must remove all of these
@@ -105,12 +106,13 @@ private:
     int64_t nSizeWithAncestors;
     CAmount nModFeesWithAncestors;
     int64_t nSigOpCostWithAncestors;
+    uint64_t nGasWithAncestors;        //!< Total gas limit of the contract outputs of us and our ancestors
 
 public:
     CTxMemPoolEntry(const CTransactionRef& tx, CAmount fee,
                     int64_t time, unsigned int entry_height, uint64_t entry_sequence,
                     bool spends_coinbase,
-                    int64_t sigops_cost, LockPoints lp, CAmount min_gas_price = 0)
+                    int64_t sigops_cost, LockPoints lp, CAmount min_gas_price = 0, uint64_t gas_limit = 0)
         : tx{tx},
           nFee{fee},
           nTxWeight{GetTransactionWeight(*tx)},
@@ -123,11 +125,13 @@ public:
           m_modified_fee{nFee},
           lockPoints{lp},
           nMinGasPrice{min_gas_price},
+          nGasLimit{gas_limit},
           nSizeWithDescendants{GetTxSize()},
           nModFeesWithDescendants{nFee},
           nSizeWithAncestors{GetTxSize()},
           nModFeesWithAncestors{nFee},
-          nSigOpCostWithAncestors{sigOpCost} {}
+          nSigOpCostWithAncestors{sigOpCost},
+          nGasWithAncestors{gas_limit} {}
 
     CTxMemPoolEntry(ExplicitCopyTag, const CTxMemPoolEntry& entry) : CTxMemPoolEntry(entry) {}
     CTxMemPoolEntry& operator=(const CTxMemPoolEntry&) = delete;
@@ -152,11 +156,23 @@ public:
     size_t DynamicMemoryUsage() const { return nUsageSize; }
     const LockPoints& GetLockPoints() const { return lockPoints; }
     const CAmount& GetMinGasPrice() const { return nMinGasPrice; }
+    uint64_t GetGasLimit() const { return nGasLimit; }
+    /**
+     * Gas price that mining the tx with its unconfirmed ancestors pays: their
+     * fees per unit of their gas limit, so a child can pay for a contract
+     * parent it is mined with. Without contract ancestors it is the minimum
+     * gas price of the tx itself.
+     */
+    CAmount GetPackageGasPrice() const
+    {
+        if (nGasWithAncestors == nGasLimit) return nMinGasPrice;
+        return nModFeesWithAncestors / CAmount(nGasWithAncestors);
+    }
 
     // Adjusts the descendant state.
     void UpdateDescendantState(int32_t modifySize, CAmount modifyFee, int64_t modifyCount);
     // Adjusts the ancestor state
-    void UpdateAncestorState(int32_t modifySize, CAmount modifyFee, int64_t modifyCount, int64_t modifySigOps);
+    void UpdateAncestorState(int32_t modifySize, CAmount modifyFee, int64_t modifyCount, int64_t modifySigOps, int64_t modifyGas = 0);
     // Updates the modified fees with descendants/ancestors.
     void UpdateModifiedFee(CAmount fee_diff)
     {
@@ -181,6 +197,7 @@ public:
     int64_t GetSizeWithAncestors() const { return nSizeWithAncestors; }
     CAmount GetModFeesWithAncestors() const { return nModFeesWithAncestors; }
     int64_t GetSigOpCostWithAncestors() const { return nSigOpCostWithAncestors; }
+    uint64_t GetGasWithAncestors() const { return nGasWithAncestors; }
 
     const Parents& GetMemPoolParentsConst() const { return m_parents; }
     const Children& GetMemPoolChildrenConst() const { return m_children; }
@@ -8,6 +8,7 @@
 #include <addrman.h>
 #include <banman.h>
 #include <blockencodings.h>
+#include <blockorphanage.h>
 #include <blockfilter.h>
 #include <chainparams.h>
 #include <consensus/amount.h>
@@ -31,6 +32,7 @@
 #include <policy/policy.h>
 #include <policy/settings.h>
 #include <primitives/block.h>
+#include <qtum/evmstatesync.h>
 #include <primitives/transaction.h>
 #include <random.h>
 #include <scheduler.h>
@@ -52,6 +54,8 @@
 #include <common/args.h>
 #include <trust/trustscore.h>
 #include <trust/heartbeat_net.h>
+#include <validators/equivocation.h>
+#include <validators/validatordb.h>
 
 #include <algorithm>
 #include <atomic>
@@ -172,13 +176,20 @@ static constexpr double MAX_ADDR_RATE_PER_SECOND{0.1};
 static constexpr size_t MAX_ADDR_PROCESSING_TOKEN_BUCKET{MAX_ADDR_TO_SEND};
 /** The compactblocks version we support. See BIP 152. */
 static constexpr uint64_t CMPCTBLOCKS_VERSION{2};
-
-struct COrphanBlock {
-    uint256 hashBlock;
-    uint256 hashPrev;
-    std::pair<COutPoint, unsigned int> stake;
-    std::vector<unsigned char> vchBlock;
-};
+/** The maximum rate of equivocation evidence messages we are willing to process from a peer. */
+static constexpr double MAX_EVIDENCE_RATE_PER_SECOND{0.1};
+/** The burst of equivocation evidence messages we accept from a peer before rate limiting. */
+static constexpr double MAX_EVIDENCE_TOKEN_BUCKET{10.0};
+/** The maximum rate of EVM state entries we are willing to look up for a peer. */
+static constexpr double MAX_EVM_STATE_RATE_PER_SECOND{1000.0};
+/** The burst of EVM state entries we look up for a peer before rate limiting. */
+static constexpr double MAX_EVM_STATE_TOKEN_BUCKET{2.0 * qtum::MAX_EVM_STATE_REQUEST};
+/** How long to wait for a peer to answer a getevmstate request before asking others. */
+static constexpr auto EVM_STATE_REQUEST_TIMEOUT{30s};
+/** How far below the best header the EVM state sync picks its block when following the headers chain. */
+static constexpr int EVM_STATE_SYNC_DEPTH{16};
+/** How many blocks the headers chain has to move before a following EVM state sync moves to a newer block. */
+static constexpr int EVM_STATE_SYNC_RETARGET{128};
 
 // Internal stuff
 namespace {
@@ -366,6 +377,16 @@ struct Peer {
     /** Total number of addresses that were processed (excludes rate-limited ones). */
     std::atomic<uint64_t> m_addr_processed{0};
 
+    /** Number of equivocation evidence messages that can be processed from this peer. */
+    double m_evidence_token_bucket GUARDED_BY(NetEventsInterface::g_msgproc_mutex){MAX_EVIDENCE_TOKEN_BUCKET};
+    /** When m_evidence_token_bucket was last updated */
+    std::chrono::microseconds m_evidence_token_timestamp GUARDED_BY(NetEventsInterface::g_msgproc_mutex){GetTime<std::chrono::microseconds>()};
+
+    /** Number of EVM state entries that can be looked up for this peer. */
+    double m_evm_state_token_bucket GUARDED_BY(NetEventsInterface::g_msgproc_mutex){MAX_EVM_STATE_TOKEN_BUCKET};
+    /** When m_evm_state_token_bucket was last updated */
+    std::chrono::microseconds m_evm_state_token_timestamp GUARDED_BY(NetEventsInterface::g_msgproc_mutex){GetTime<std::chrono::microseconds>()};
+
     /** Whether we've sent this peer a getheaders in response to an inv prior to initial-headers-sync completing */
     bool m_inv_triggered_getheaders_before_sync GUARDED_BY(NetEventsInterface::g_msgproc_mutex){false};
 
@@ -479,6 +500,11 @@ struct CNodeState {
 
     //! Time of last new block announcement
     int64_t m_last_block_announcement{0};
+
+    //! EVM state hashes requested from this peer and not answered yet
+    std::vector<qtum::EVMStateRequest> m_evm_state_requests;
+    //! When the requests in m_evm_state_requests were sent
+    std::chrono::microseconds m_evm_state_request_time{0us};
 };
 
 class CNodeHeaders
@@ -623,6 +649,10 @@ public:
     ServiceFlags GetDesirableServiceFlags(ServiceFlags services) const override;
     void InitCleanBlockIndex() override;
     void StopCleanBlockIndex() override;
+    std::optional<std::string> StartEVMStateSync(const CBlockIndex* block_index) override EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+    std::optional<qtum::EVMStateSync::Stats> GetEVMStateSyncStats() const override EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+    void LoadChainUptime(const fs::path& path) override EXCLUSIVE_LOCKS_REQUIRED(!::cs_main, !m_chain_uptime_mutex);
+    void SaveChainUptime() override EXCLUSIVE_LOCKS_REQUIRED(!m_chain_uptime_mutex);
 
 private:
     /** Consider evicting an outbound peer based on the amount of time they've been behind our tip */
@@ -775,6 +805,11 @@ private:
                                   std::vector<CBlockHeader>& headers)
         EXCLUSIVE_LOCKS_REQUIRED(!peer.m_headers_sync_mutex, !m_peer_mutex, !m_headers_presync_mutex, g_msgproc_mutex);
 
+    /** Check the block signature of a proof-of-stake header seen in a low-work
+     * headers sync, if its kernel is in our UTXO set. Returns false only if
+     * the signature does not match the staked coin. */
+    bool CheckPresyncStake(const CBlockHeader& header, int height) LOCKS_EXCLUDED(::cs_main);
+
     /** Return true if the given header is an ancestor of
      *  m_chainman.m_best_header or our current tip */
     bool IsAncestorOfBestHeaderOrTip(const CBlockIndex* header) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -828,11 +863,8 @@ private:
     void MaybeSendFeefilter(CNode& node, Peer& peer, std::chrono::microseconds current_time) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
 
     /** Process net block. */
-    void PushGetBlocks(CNode& node, const CBlockIndex* pindexBegin, const uint256& hashEnd);
-    uint256 GetOrphanRoot(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
-    void PruneOrphanBlocks() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool ProcessNetBlockHeaders(CNode& node, const std::vector<CBlockHeader>& block, bool min_pow_checked, BlockValidationState& state, const CBlockIndex** ppindex=nullptr);
-    bool ProcessNetBlock(const std::shared_ptr<const CBlock> pblock, bool force_processing, bool min_pow_checked, bool* new_block, CNode& node);
+    bool ProcessNetBlock(const std::shared_ptr<const CBlock> pblock, bool force_processing, bool min_pow_checked, bool* new_block, CNode& node) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
 
     /** Clean block index. */
     bool RemoveStateBlockIndex(CBlockIndex *pindex);
@@ -843,10 +875,43 @@ private:
     CNodeHeaders& ServiceHeaders(const CService& address) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void CleanAddressHeaders(const CAddress& addr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
-    std::map<uint256, COrphanBlock*> mapOrphanBlocks GUARDED_BY(cs_main);
-    std::multimap<uint256, COrphanBlock*> mapOrphanBlocksByPrev GUARDED_BY(cs_main);
-    std::set<std::pair<COutPoint, unsigned int>> setStakeSeenOrphan GUARDED_BY(cs_main);
-    size_t nOrphanBlocksSize = 0;
+    /** Proof-of-stake blocks received before their parent, with per-peer quotas and its own lock. */
+    BlockOrphanage m_block_orphanage;
+
+    /** Recently seen signed proof-of-stake headers, to detect stakers signing conflicting blocks. */
+    validators::EquivocationDetector m_equivocation_detector;
+    /**
+     * Check a header received from a peer against the recently seen ones, once
+     * it was accepted into the block index. A second header for the stake and
+     * slot of an accepted one is refused as a duplicate stake, so it is only
+     * checked within the peer's evidence rate limit: recovering the signer of
+     * unchecked headers would let peers spend our CPU for free.
+     */
+    void DetectEquivocation(const CBlockHeader& header, Peer& peer) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
+    /** Take a token from the peer's equivocation evidence rate limit, false if none is left. */
+    bool ConsumeEvidenceToken(Peer& peer) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
+
+    /** Take up to count EVM state lookup tokens from the peer, returns how many were taken. */
+    size_t ConsumeEVMStateTokens(Peer& peer, size_t count) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
+    /**
+     * Act on equivocation evidence found locally (from is nullopt) or received
+     * from a peer: jail and demote the offender, and relay the evidence once.
+     * Returns false if the evidence is invalid.
+     */
+    bool ProcessEquivocationEvidence(const validators::EquivocationEvidence& evidence, std::optional<NodeId> from);
+    /** Update the uptime derived from the heartbeat aggregates committed on chain. */
+    void UpdateChainUptime(const CBlock& block, const CBlockIndex* pindex, bool connected) EXCLUSIVE_LOCKS_REQUIRED(!m_chain_uptime_mutex);
+    /**
+     * Apply a block to the uptime if it extends or undoes m_chain_uptime_tip,
+     * so that a block seen both by LoadChainUptime() and by a validation
+     * callback is only counted once.
+     */
+    void ApplyChainUptime(const CBlock& block, const CBlockIndex* pindex, bool connected) EXCLUSIVE_LOCKS_REQUIRED(m_chain_uptime_mutex);
+    Mutex m_chain_uptime_mutex;
+    /** File the uptime is saved to, empty until LoadChainUptime() */
+    fs::path m_chain_uptime_path GUARDED_BY(m_chain_uptime_mutex);
+    /** Last block whose heartbeat aggregate is reflected in the uptime, null until LoadChainUptime() */
+    uint256 m_chain_uptime_tip GUARDED_BY(m_chain_uptime_mutex);
     std::thread threadCleanBlockIndex;
     std::atomic<bool> m_stop_thread_clean_block_index = false;
 
@@ -875,6 +940,13 @@ private:
 
     std::unique_ptr<TxReconciliationTracker> m_txreconciliation;
 
+    /** Download of the EVM state of a block, once started by StartEVMStateSync() */
+    std::unique_ptr<qtum::EVMStateSync> m_evm_state_sync GUARDED_BY(::cs_main);
+    /** Whether the EVM state sync moves along with the best header */
+    bool m_evm_state_sync_follow GUARDED_BY(::cs_main){false};
+    /** Block below the best header whose EVM state a following sync targets */
+    const CBlockIndex* EVMStateSyncTarget() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
     /** The height of the best chain */
     std::atomic<int> m_best_height{-1};
     /** The time of the best chain tip block */
@@ -1049,6 +1121,9 @@ private:
     /** When our tip was last updated. */
     std::atomic<std::chrono::seconds> m_last_tip_update{0s};
 
+    /** Announce the transactions a txreconciliation found the peer to be missing. */
+    void AnnounceReconciledTxs(CNode& node, Peer& peer, const std::vector<Wtxid>& wtxids);
+
     /** Determine whether or not a peer can request a transaction, and return it (or nullptr if not found or not allowed). */
     CTransactionRef FindTxForGetData(const Peer::TxRelay& tx_relay, const GenTxid& gtxid)
         EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex, NetEventsInterface::g_msgproc_mutex);
@@ -1058,7 +1133,7 @@ private:
         LOCKS_EXCLUDED(::cs_main);
 
     /** Process a new block. Perform any post-processing housekeeping */
-    void ProcessBlock(CNode& node, const std::shared_ptr<const CBlock>& block, bool force_processing, bool min_pow_checked);
+    void ProcessBlock(CNode& node, const std::shared_ptr<const CBlock>& block, bool force_processing, bool min_pow_checked) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
 
     /** Process compact block txns  */
     void ProcessCompactBlockTxns(CNode& pfrom, Peer& peer, const BlockTransactions& block_transactions)
@@ -1768,7 +1843,9 @@ void PeerManagerImpl::FinalizeNode(const CNode& node)
         LOCK(m_tx_download_mutex);
         m_txdownloadman.DisconnectedPeer(nodeid);
     }
+    m_block_orphanage.EraseForPeer(nodeid);
     if (m_txreconciliation) m_txreconciliation->ForgetPeer(nodeid);
+    if (m_evm_state_sync) m_evm_state_sync->Retry(state->m_evm_state_requests);
     m_num_preferred_download_peers -= state->fPreferredDownload;
     m_peers_downloading_from -= (!state->vBlocksInFlight.empty());
     assert(m_peers_downloading_from >= 0);
@@ -1927,6 +2004,95 @@ void PeerManagerImpl::Misbehaving(Peer& peer, const std::string& message)
     );
 }
 
+bool PeerManagerImpl::ConsumeEvidenceToken(Peer& peer)
+{
+    const auto current_time{GetTime<std::chrono::microseconds>()};
+    if (peer.m_evidence_token_bucket < MAX_EVIDENCE_TOKEN_BUCKET) {
+        const auto time_diff = std::max(current_time - peer.m_evidence_token_timestamp, 0us);
+        const double increment = Ticks<SecondsDouble>(time_diff) * MAX_EVIDENCE_RATE_PER_SECOND;
+        peer.m_evidence_token_bucket = std::min<double>(peer.m_evidence_token_bucket + increment, MAX_EVIDENCE_TOKEN_BUCKET);
+    }
+    peer.m_evidence_token_timestamp = current_time;
+    if (peer.m_evidence_token_bucket < 1.0) {
+        return false;
+    }
+    peer.m_evidence_token_bucket -= 1.0;
+    return true;
+}
+
+size_t PeerManagerImpl::ConsumeEVMStateTokens(Peer& peer, size_t count)
+{
+    const auto current_time{GetTime<std::chrono::microseconds>()};
+    if (peer.m_evm_state_token_bucket < MAX_EVM_STATE_TOKEN_BUCKET) {
+        const auto time_diff = std::max(current_time - peer.m_evm_state_token_timestamp, 0us);
+        const double increment = Ticks<SecondsDouble>(time_diff) * MAX_EVM_STATE_RATE_PER_SECOND;
+        peer.m_evm_state_token_bucket = std::min<double>(peer.m_evm_state_token_bucket + increment, MAX_EVM_STATE_TOKEN_BUCKET);
+    }
+    peer.m_evm_state_token_timestamp = current_time;
+    const size_t taken = std::min<size_t>(count, peer.m_evm_state_token_bucket);
+    peer.m_evm_state_token_bucket -= taken;
+    return taken;
+}
+
+void PeerManagerImpl::DetectEquivocation(const CBlockHeader& header, Peer& peer)
+{
+    if (!header.IsProofOfStake()) return;
+    bool accepted;
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindex{m_chainman.m_blockman.LookupBlockIndex(header.GetHash())};
+        if (pindex && (pindex->nStatus & BLOCK_FAILED_MASK)) return;
+        accepted = pindex != nullptr;
+        if (!accepted && !(g_stake_seen.Contains(header.prevoutStake, header.nTime) &&
+                           m_chainman.m_blockman.LookupBlockIndex(header.hashPrevBlock))) {
+            return;
+        }
+    }
+    if (!accepted && !ConsumeEvidenceToken(peer)) {
+        LogDebug(BCLog::NET, "Rate limited equivocation check of header %s from peer=%d\n", header.GetHash().ToString(), peer.m_id);
+        return;
+    }
+    std::optional<validators::EquivocationEvidence> evidence{m_equivocation_detector.AddHeader(header, GetTime())};
+    if (evidence) {
+        LogPrintf("Detected staker equivocation in header %s from peer=%d\n", header.GetHash().ToString(), peer.m_id);
+        ProcessEquivocationEvidence(*evidence, std::nullopt);
+    }
+}
+
+bool PeerManagerImpl::ProcessEquivocationEvidence(const validators::EquivocationEvidence& evidence, std::optional<NodeId> from)
+{
+    const uint256 hash{evidence.GetHash()};
+    if (m_equivocation_detector.HaveEvidence(hash)) return true;
+
+    CKeyID offender;
+    std::string reason;
+    if (!evidence.Verify(offender, reason)) {
+        LogDebug(BCLog::NET, "Invalid equivocation evidence %s: %s\n", hash.ToString(), reason);
+        return false;
+    }
+    if (!m_equivocation_detector.AddEvidence(hash)) return true;
+
+    LogPrintf("Staker %s equivocated at time %u (blocks %s and %s)\n", offender.ToString(),
+              evidence.first.nTime, evidence.first.GetHash().ToString(), evidence.second.GetHash().ToString());
+
+    if (validators::g_validator_db && validators::g_validator_db->GetValidator(offender)) {
+        validators::g_validator_db->JailValidator(offender, validators::DEFAULT_JAIL_BLOCKS);
+    }
+    if (trust::g_heartbeat_manager) {
+        trust::g_heartbeat_manager->GetTrustManager()->DemoteValidator(offender, evidence.first.nTime);
+    }
+
+    // Old evidence is still acted upon, but only recent evidence is worth relaying
+    if (int64_t{evidence.first.nTime} + validators::EquivocationDetector::DEFAULT_WINDOW < GetTime()) {
+        return true;
+    }
+    m_connman.ForEachNode([&](CNode* pnode) {
+        if (!pnode->fSuccessfullyConnected || pnode->fDisconnect || pnode->GetId() == from) return;
+        MakeAndPushMessage(*pnode, NetMsgType::EQUIVOCATION, evidence);
+    });
+    return true;
+}
+
 void PeerManagerImpl::MaybePunishNodeForBlock(NodeId nodeid, const BlockValidationState& state,
                                               bool via_compact_block, const std::string& message)
 {
@@ -2073,11 +2239,11 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
       m_chainman(chainman),
       m_mempool(pool),
       m_txdownloadman(node::TxDownloadOptions{pool, m_rng, opts.max_orphan_txs, opts.deterministic_rng}),
+      m_block_orphanage{size_t{opts.max_orphan_blocks_mib} << 20, (size_t{opts.max_orphan_blocks_mib} << 20) / ORPHAN_BLOCK_PEER_SHARE},
       m_warnings{warnings},
       m_opts{opts}
 {
-    // While Erlay support is incomplete, it must be enabled explicitly via -txreconciliation.
-    // This argument can go away after Erlay support is complete.
+    // Erlay stays opt-in via -txreconciliation until enough of the network supports it.
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
@@ -2149,16 +2315,119 @@ void PeerManagerImpl::BlockConnected(
     if (role == ChainstateRole::BACKGROUND) {
         return;
     }
+    UpdateChainUptime(*pblock, pindex, /*connected=*/true);
     LOCK(m_tx_download_mutex);
     m_txdownloadman.BlockConnected(pblock);
 }
 
 void PeerManagerImpl::BlockDisconnected(const std::shared_ptr<const CBlock> &block, const CBlockIndex* pindex)
 {
+    UpdateChainUptime(*block, pindex, /*connected=*/false);
     LOCK(m_tx_download_mutex);
     m_txdownloadman.BlockDisconnected();
 }
 
+void PeerManagerImpl::UpdateChainUptime(const CBlock& block, const CBlockIndex* pindex, bool connected)
+{
+    LOCK(m_chain_uptime_mutex);
+    ApplyChainUptime(block, pindex, connected);
+}
+
+void PeerManagerImpl::ApplyChainUptime(const CBlock& block, const CBlockIndex* pindex, bool connected)
+{
+    AssertLockHeld(m_chain_uptime_mutex);
+    if (!trust::g_heartbeat_manager) return;
+    const uint256 prev_hash{pindex->pprev ? pindex->pprev->GetBlockHash() : uint256{}};
+    if (m_chain_uptime_tip != (connected ? prev_hash : pindex->GetBlockHash())) return;
+
+    // Aggregates were checked when the block was validated
+    trust::HeartbeatAggregate aggregate;
+    uint256 windowBlockHash;
+    const bool has_aggregate{block.IsProofOfStake() && pindex->nHeight >= m_chainparams.GetConsensus().nHeartbeatAggregateHeight &&
+                             trust::ReadHeartbeatAggregate(*block.vtx[0], aggregate)};
+    if (has_aggregate) {
+        windowBlockHash = pindex->GetAncestor(aggregate.windowHeight)->GetBlockHash();
+    }
+    if (connected) {
+        trust::g_heartbeat_manager->BlockConnected(pindex->nHeight, has_aggregate ? &aggregate : nullptr, windowBlockHash);
+    } else {
+        trust::g_heartbeat_manager->BlockDisconnected(pindex->nHeight, has_aggregate ? &aggregate : nullptr, windowBlockHash);
+    }
+
+    m_chain_uptime_tip = connected ? pindex->GetBlockHash() : prev_hash;
+    // Save once per heartbeat interval, so that little has to be caught up with after a crash
+    if (connected && !m_chain_uptime_path.empty() && pindex->nHeight % m_chainparams.GetConsensus().nHeartbeatInterval == 0) {
+        trust::g_heartbeat_manager->GetTrustManager()->WriteAttestedWindows(m_chain_uptime_path, m_chain_uptime_tip);
+    }
+}
+
+void PeerManagerImpl::LoadChainUptime(const fs::path& path)
+{
+    if (!trust::g_heartbeat_manager) return;
+    trust::TrustScoreManager& trust_manager{*trust::g_heartbeat_manager->GetTrustManager()};
+    // Validation callbacks wait until the catch up is done, and then skip the
+    // blocks it already applied
+    LOCK(m_chain_uptime_mutex);
+    uint256 saved_tip;
+    const bool have_saved{trust_manager.ReadAttestedWindows(path, saved_tip)};
+
+    // Blocks to undo from the saved tip back to the active chain, and to apply from there on
+    std::vector<const CBlockIndex*> disconnect;
+    std::vector<const CBlockIndex*> connect;
+    uint256 tip;
+    {
+        LOCK(::cs_main);
+        const CChain& chain{m_chainman.ActiveChain()};
+        if (!chain.Tip()) return;
+        const Consensus::Params& params{m_chainparams.GetConsensus()};
+        const int oldest{std::max({1, params.nHeartbeatAggregateHeight, chain.Height() - params.nUptimeWindow - params.nHeartbeatInclusionWindow})};
+        const CBlockIndex* saved{have_saved ? m_chainman.m_blockman.LookupBlockIndex(saved_tip) : nullptr};
+        const CBlockIndex* fork{saved ? chain.FindFork(saved) : nullptr};
+        if (fork) {
+            for (const CBlockIndex* pindex{saved}; pindex != fork; pindex = pindex->pprev) disconnect.push_back(pindex);
+        } else {
+            trust_manager.ClearAttestedWindows();
+        }
+        for (int height = fork ? std::max(fork->nHeight + 1, oldest) : oldest; height <= chain.Height(); ++height) {
+            connect.push_back(chain[height]);
+        }
+        m_chain_uptime_tip = fork ? saved_tip : chain.Tip()->GetBlockHash();
+        tip = chain.Tip()->GetBlockHash();
+    }
+    if (!have_saved || !disconnect.empty() || connect.size() > 1) {
+        LogPrintf("Catching up with the validator uptime of %d blocks\n", disconnect.size() + connect.size());
+    }
+
+    const auto apply{[&](const std::vector<const CBlockIndex*>& blocks, bool connected) EXCLUSIVE_LOCKS_REQUIRED(m_chain_uptime_mutex) {
+        for (const CBlockIndex* pindex : blocks) {
+            CBlock block;
+            if (!m_chainman.m_blockman.ReadBlock(block, *pindex)) return false;
+            ApplyChainUptime(block, pindex, connected);
+        }
+        return true;
+    }};
+    bool ok{apply(disconnect, /*connected=*/false)};
+    if (ok && !connect.empty()) {
+        // Blocks before the first one to apply are too old to matter
+        m_chain_uptime_tip = connect.front()->pprev->GetBlockHash();
+        ok = apply(connect, /*connected=*/true);
+    }
+    if (!ok) {
+        LogPrintf("Failed to read the blocks to catch up with, the validator uptime starts over\n");
+        trust_manager.ClearAttestedWindows();
+        m_chain_uptime_tip = tip;
+    }
+
+    m_chain_uptime_path = path;
+}
+
+void PeerManagerImpl::SaveChainUptime()
+{
+    LOCK(m_chain_uptime_mutex);
+    if (m_chain_uptime_path.empty() || !trust::g_heartbeat_manager) return;
+    trust::g_heartbeat_manager->GetTrustManager()->WriteAttestedWindows(m_chain_uptime_path, m_chain_uptime_tip);
+}
+
 /**
  * Maintain state about the best-seen block and fast-announce a compact block
  * to compatible peers.
@@ -2564,6 +2833,26 @@ CTransactionRef PeerManagerImpl::FindTxForGetData(const Peer::TxRelay& tx_relay,
     return {};
 }
 
+void PeerManagerImpl::AnnounceReconciledTxs(CNode& node, Peer& peer, const std::vector<Wtxid>& wtxids)
+{
+    auto tx_relay = peer.GetTxRelay();
+    if (!tx_relay) return;
+
+    std::vector<CInv> invs;
+    LOCK(tx_relay->m_tx_inventory_mutex);
+    for (const Wtxid& wtxid : wtxids) {
+        // Not in the mempool anymore? don't bother announcing it.
+        if (!m_mempool.exists(GenTxid::Wtxid(wtxid))) continue;
+        tx_relay->m_tx_inventory_known_filter.insert(wtxid.ToUint256());
+        invs.emplace_back(MSG_WTX, wtxid.ToUint256());
+        if (invs.size() == MAX_INV_SZ) {
+            MakeAndPushMessage(node, NetMsgType::INV, invs);
+            invs.clear();
+        }
+    }
+    if (!invs.empty()) MakeAndPushMessage(node, NetMsgType::INV, invs);
+}
+
 void PeerManagerImpl::ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic<bool>& interruptMsgProc)
 {
     AssertLockNotHeld(cs_main);
@@ -2779,6 +3068,18 @@ bool PeerManagerImpl::CheckHeadersTimestampAndSignatureSize(const std::vector<CB
     return true;
 }
 
+bool PeerManagerImpl::CheckPresyncStake(const CBlockHeader& header, int height)
+{
+    if (height <= m_chainparams.GetConsensus().nEnableHeaderSignatureHeight) return true;
+
+    // The coins staked on the peer's chain are not known before its blocks
+    // are, only those in our UTXO set can be checked
+    LOCK(::cs_main);
+    const std::optional<Coin> coin{m_chainman.ActiveChainstate().CoinsTip().GetCoin(header.prevoutStake)};
+    if (!coin) return true;
+    return CheckRecoveredPubKeyFromBlockSignature(height, header, *coin);
+}
+
 bool PeerManagerImpl::IsContinuationOfLowWorkHeadersSync(Peer& peer, CNode& pfrom, std::vector<CBlockHeader>& headers)
 {
     if (peer.m_headers_sync) {
@@ -2888,7 +3189,8 @@ bool PeerManagerImpl::TryLowWorkHeadersSync(Peer& peer, CNode& pfrom, const CBlo
             // advancing to the first unknown header would be a small effect.
             LOCK(peer.m_headers_sync_mutex);
             peer.m_headers_sync.reset(new HeadersSyncState(peer.m_id, m_chainparams.GetConsensus(),
-                chain_start_header, minimum_chain_work));
+                chain_start_header, minimum_chain_work,
+                [this](const CBlockHeader& header, int height) { return CheckPresyncStake(header, height); }));
 
             // Now a HeadersSyncState object for tracking this synchronization
             // is created, process the headers using it as normal. Failures are
@@ -3186,7 +3488,13 @@ void PeerManagerImpl::ProcessHeadersMessage(CNode& pfrom, Peer& peer,
 
     // Now process all the headers.
     BlockValidationState state;
-    if (!ProcessNetBlockHeaders(pfrom, headers, /*min_pow_checked=*/true, state, &pindexLast)) {
+    const bool processed{ProcessNetBlockHeaders(pfrom, headers, /*min_pow_checked=*/true, state, &pindexLast)};
+    if (received_new_header && !m_chainman.IsInitialBlockDownload()) {
+        for (const CBlockHeader& header : headers) {
+            DetectEquivocation(header, peer);
+        }
+    }
+    if (!processed) {
         if (state.IsInvalid()) {
             MaybePunishNodeForBlock(pfrom.GetId(), state, via_compact_block, "invalid header received");
             return;
@@ -4170,6 +4478,74 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         return;
     }
 
+    if (msg_type == NetMsgType::REQRECON || msg_type == NetMsgType::SKETCH ||
+        msg_type == NetMsgType::REQSKETCHEXT || msg_type == NetMsgType::RECONCILDIFF) {
+        if (!m_txreconciliation || !m_txreconciliation->IsPeerRegistered(pfrom.GetId())) {
+            LogDebug(BCLog::NET, "%s from peer=%d ignored, as we do not reconcile transactions with it\n", msg_type, pfrom.GetId());
+            return;
+        }
+    }
+
+    if (msg_type == NetMsgType::REQRECON) {
+        uint16_t peer_recon_set_size, peer_q;
+        vRecv >> peer_recon_set_size >> peer_q;
+        if (!m_txreconciliation->HandleReconciliationRequest(pfrom.GetId(), peer_recon_set_size, peer_q)) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected reqrecon), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+        }
+        return;
+    }
+
+    if (msg_type == NetMsgType::SKETCH) {
+        std::vector<uint8_t> skdata;
+        vRecv >> skdata;
+        HandleSketchResult result{m_txreconciliation->HandleSketch(pfrom.GetId(), skdata)};
+        switch (result.action) {
+        case HandleSketchResult::Action::PROTOCOL_VIOLATION:
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected or invalid sketch), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        case HandleSketchResult::Action::REQUEST_EXTENSION:
+            MakeAndPushMessage(pfrom, NetMsgType::REQSKETCHEXT);
+            return;
+        case HandleSketchResult::Action::SEND_DIFF:
+            MakeAndPushMessage(pfrom, NetMsgType::RECONCILDIFF, uint8_t{result.success}, result.txs_to_request);
+            AnnounceReconciledTxs(pfrom, *peer, result.txs_to_announce);
+            return;
+        case HandleSketchResult::Action::IGNORE:
+            LogDebug(BCLog::NET, "late sketch from peer=%d ignored\n", pfrom.GetId());
+            return;
+        }
+        return;
+    }
+
+    if (msg_type == NetMsgType::REQSKETCHEXT) {
+        if (auto extension = m_txreconciliation->HandleSketchExtensionRequest(pfrom.GetId())) {
+            MakeAndPushMessage(pfrom, NetMsgType::SKETCH, *extension);
+        } else {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected reqsketchext), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+        }
+        return;
+    }
+
+    if (msg_type == NetMsgType::RECONCILDIFF) {
+        uint8_t success;
+        std::vector<uint32_t> ask_shortids;
+        vRecv >> success >> ask_shortids;
+        std::optional<std::vector<Wtxid>> announce;
+        if (ask_shortids.size() <= MAX_RECONSET_SIZE) {
+            announce = m_txreconciliation->HandleReconciliationDifference(pfrom.GetId(), success != 0, ask_shortids);
+        }
+        if (!announce) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected or invalid reconcildiff), %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        AnnounceReconciledTxs(pfrom, *peer, *announce);
+        return;
+    }
+
     if (msg_type == NetMsgType::INV) {
         std::vector<CInv> vInv;
         vRecv >> vInv;
@@ -4220,6 +4596,10 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 }
                 const GenTxid gtxid = ToGenTxid(inv);
                 AddKnownTx(*peer, inv.hash);
+                if (m_txreconciliation && inv.IsMsgWtx()) {
+                    // The peer has the transaction, there is no need to reconcile it
+                    m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), Wtxid::FromUint256(inv.hash));
+                }
 
                 if (!m_chainman.IsInitialBlockDownload()) {
                     const bool fAlreadyHave{m_txdownloadman.AddTxAnnouncement(pfrom.GetId(), gtxid, current_time)};
@@ -4512,6 +4892,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         const uint256& hash = peer->m_wtxid_relay ? wtxid : txid;
         AddKnownTx(*peer, hash);
+        if (m_txreconciliation) m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), ptx->GetWitnessHash());
 
         LOCK2(cs_main, m_tx_download_mutex);
 
@@ -4873,7 +5254,11 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         }
 
         std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-        vRecv >> TX_WITH_WITNESS(*pblock);
+        if (m_chainman.m_blockman.UseBlockArena()) {
+            vRecv >> TX_WITH_WITNESS(BlockWithArena{*pblock, vRecv.size()});
+        } else {
+            vRecv >> TX_WITH_WITNESS(*pblock);
+        }
 
         LogDebug(BCLog::NET, "received block %s peer=%d\n", pblock->GetHash().ToString(), pfrom.GetId());
 
@@ -4908,6 +5293,9 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             }
         }
         ProcessBlock(pfrom, pblock, forceProcessing, min_pow_checked);
+        if (!m_chainman.IsInitialBlockDownload()) {
+            DetectEquivocation(*pblock, *peer);
+        }
         return;
     }
 
@@ -5182,6 +5570,68 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         return;
     }
 
+    if (msg_type == NetMsgType::EQUIVOCATION) {
+        // Verifying evidence costs two signature recoveries, so apply rate limiting
+        if (!ConsumeEvidenceToken(*peer)) {
+            LogDebug(BCLog::NET, "Rate limited equivocation evidence from peer=%d\n", pfrom.GetId());
+            return;
+        }
+
+        validators::EquivocationEvidence evidence;
+        vRecv >> evidence;
+        if (!ProcessEquivocationEvidence(evidence, pfrom.GetId())) {
+            Misbehaving(*peer, "invalid equivocation evidence");
+        }
+        return;
+    }
+
+    if (msg_type == NetMsgType::GETEVMSTATE) {
+        if (!(peer->m_our_services & NODE_EVM_STATE)) {
+            LogDebug(BCLog::NET, "getevmstate request with -peerevmstate disabled, %s\n", pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        std::vector<qtum::EVMStateRequest> requests;
+        vRecv >> requests;
+        if (requests.size() > qtum::MAX_EVM_STATE_REQUEST) {
+            Misbehaving(*peer, strprintf("getevmstate message size = %u", requests.size()));
+            return;
+        }
+        // Entries beyond the peer's lookup budget are answered empty, the
+        // peer asks for them again later
+        const size_t count = ConsumeEVMStateTokens(*peer, requests.size());
+        std::vector<dev::bytes> data;
+        if (count > 0) {
+            LOCK(cs_main);
+            data = qtum::LookupEVMState(globalState->db(), globalState->dbUtxo(), {requests.begin(), requests.begin() + count});
+        }
+        data.resize(requests.size());
+        MakeAndPushMessage(pfrom, NetMsgType::EVMSTATE, data);
+        return;
+    }
+
+    if (msg_type == NetMsgType::EVMSTATE) {
+        std::vector<dev::bytes> data;
+        vRecv >> data;
+        LOCK(cs_main);
+        CNodeState& state = *State(pfrom.GetId());
+        if (!m_evm_state_sync || state.m_evm_state_requests.empty()) {
+            LogDebug(BCLog::NET, "Unrequested evmstate from peer=%d\n", pfrom.GetId());
+            return;
+        }
+        std::vector<qtum::EVMStateRequest> requests;
+        requests.swap(state.m_evm_state_requests);
+        const bool was_complete{m_evm_state_sync->IsComplete()};
+        if (!m_evm_state_sync->ProcessResponse(requests, data)) {
+            Misbehaving(*peer, "invalid evmstate data");
+            return;
+        }
+        if (!was_complete && m_evm_state_sync->IsComplete()) {
+            LogInfo("Synced the EVM state of block %s\n", m_evm_state_sync->GetTarget().ToString());
+        }
+        return;
+    }
+
     if (msg_type == NetMsgType::GETVALIDATORS) {
         // Return list of known validators
         if (trust::g_heartbeat_manager) {
@@ -6076,6 +6526,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     // No reason to drain out at many times the network's capacity,
                     // especially since we have many peers and some will draw much shorter delays.
                     unsigned int nRelayedTransactions = 0;
+                    const bool reconcile_txs{m_txreconciliation && m_txreconciliation->IsPeerRegistered(pto->GetId())};
                     LOCK(tx_relay->m_bloom_filter_mutex);
                     size_t broadcast_max{INVENTORY_BROADCAST_TARGET + (tx_relay->m_tx_inventory_to_send.size()/1000)*5};
                     broadcast_max = std::min<size_t>(INVENTORY_BROADCAST_MAX, broadcast_max);
@@ -6102,6 +6553,13 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                             continue;
                         }
                         if (tx_relay->m_bloom_filter && !tx_relay->m_bloom_filter->IsRelevantAndUpdate(*txinfo.tx)) continue;
+                        // Leave it to the next txreconciliation unless the peer is one the
+                        // transaction is flooded to
+                        if (reconcile_txs && !m_txreconciliation->IsFanoutTarget(pto->GetId(), Wtxid::FromUint256(hash)) &&
+                            m_txreconciliation->AddToSet(pto->GetId(), Wtxid::FromUint256(hash))) {
+                            tx_relay->m_tx_inventory_known_filter.insert(hash);
+                            continue;
+                        }
                         // Send
                         vInv.push_back(inv);
                         nRelayedTransactions++;
@@ -6120,6 +6578,22 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         if (!vInv.empty())
             MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
 
+        //
+        // Message: txreconciliation
+        //
+        if (m_txreconciliation) {
+            if (const auto announce = m_txreconciliation->MaybeTimeoutReconciliation(pto->GetId(), current_time)) {
+                MakeAndPushMessage(*pto, NetMsgType::RECONCILDIFF, uint8_t{false}, std::vector<uint32_t>{});
+                AnnounceReconciledTxs(*pto, *peer, *announce);
+            }
+            if (const auto request = m_txreconciliation->MaybeRequestReconciliation(pto->GetId(), current_time)) {
+                MakeAndPushMessage(*pto, NetMsgType::REQRECON, request->first, request->second);
+            }
+            if (const auto skdata = m_txreconciliation->MaybeRespondToReconciliationRequest(pto->GetId())) {
+                MakeAndPushMessage(*pto, NetMsgType::SKETCH, *skdata);
+            }
+        }
+
         // Detect whether we're stalling
         auto stalling_timeout = m_block_stalling_timeout.load();
         if (state.m_stalling_since.count() && state.m_stalling_since < current_time - stalling_timeout) {
@@ -6242,66 +6716,45 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
 
         if (!vGetData.empty())
             MakeAndPushMessage(*pto, NetMsgType::GETDATA, vGetData);
+
+        //
+        // Message: getevmstate
+        //
+        if (m_evm_state_sync && (peer->m_their_services & NODE_EVM_STATE)) {
+            if (!state.m_evm_state_requests.empty() && current_time > state.m_evm_state_request_time + EVM_STATE_REQUEST_TIMEOUT) {
+                LogDebug(BCLog::NET, "EVM state request timed out, peer=%d\n", pto->GetId());
+                m_evm_state_sync->Retry(state.m_evm_state_requests);
+                state.m_evm_state_requests.clear();
+            }
+            if (m_evm_state_sync_follow && !m_evm_state_sync->IsComplete()) {
+                // Move to a newer block when the headers chain went far
+                // ahead, the parts of the state that did not change since are
+                // not downloaded again
+                const CBlockIndex* target{EVMStateSyncTarget()};
+                const CBlockIndex* current{m_chainman.m_blockman.LookupBlockIndex(m_evm_state_sync->GetTarget())};
+                if (target && (!current || target->nHeight >= current->nHeight + EVM_STATE_SYNC_RETARGET)) {
+                    LogInfo("Syncing the EVM state of block %s at height %d\n", target->GetBlockHash().ToString(), target->nHeight);
+                    m_evm_state_sync->SetTarget(target->GetBlockHash(), target->hashStateRoot, target->hashUTXORoot);
+                }
+            }
+            if (state.m_evm_state_requests.empty() && !m_evm_state_sync->IsComplete()) {
+                state.m_evm_state_requests = m_evm_state_sync->NextRequests(qtum::MAX_EVM_STATE_REQUEST);
+                if (!state.m_evm_state_requests.empty()) {
+                    state.m_evm_state_request_time = current_time;
+                    MakeAndPushMessage(*pto, NetMsgType::GETEVMSTATE, state.m_evm_state_requests);
+                }
+            }
+        }
     } // release cs_main
     MaybeSendFeefilter(*pto, *peer, current_time);
     return true;
 }
 
-void PeerManagerImpl::PushGetBlocks(CNode& node, const CBlockIndex* pindexBegin, const uint256& hashEnd)
-{
-    MakeAndPushMessage(node, NetMsgType::GETBLOCKS, GetLocator(pindexBegin), hashEnd);
-}
-
-uint256 PeerManagerImpl::GetOrphanRoot(const uint256& hash)
-{
-    AssertLockHeld(cs_main);
-    std::map<uint256, COrphanBlock*>::iterator it = mapOrphanBlocks.find(hash);
-    if (it == mapOrphanBlocks.end())
-        return hash;
-
-    // Work back to the first block in the orphan chain
-    do {
-        std::map<uint256, COrphanBlock*>::iterator it2 = mapOrphanBlocks.find(it->second->hashPrev);
-        if (it2 == mapOrphanBlocks.end())
-            return it->first;
-        it = it2;
-    } while(true);
-}
-
-// Remove a random orphan block (which does not have any dependent orphans).
-void PeerManagerImpl::PruneOrphanBlocks()
-{
-    AssertLockHeld(cs_main);
-    size_t nMaxOrphanBlocksSize = gArgs.GetIntArg("-maxorphanblocksmib", DEFAULT_MAX_ORPHAN_BLOCKS) * ((size_t) 1 << 20);
-    while (nOrphanBlocksSize > nMaxOrphanBlocksSize)
-    {
-        // Pick a random orphan block.
-        uint256 randomhash = GetRandHash();
-        std::multimap<uint256, COrphanBlock*>::iterator it = mapOrphanBlocksByPrev.lower_bound(randomhash);
-        if (it == mapOrphanBlocksByPrev.end())
-            it = mapOrphanBlocksByPrev.begin();
-
-        // As long as this block has other orphans depending on it, move to one of those successors.
-        do {
-            std::multimap<uint256, COrphanBlock*>::iterator it2 = mapOrphanBlocksByPrev.find(it->second->hashBlock);
-            if (it2 == mapOrphanBlocksByPrev.end())
-                break;
-            it = it2;
-        } while(1);
-
-        setStakeSeenOrphan.erase(it->second->stake);
-        uint256 hash = it->second->hashBlock;
-        nOrphanBlocksSize -= it->second->vchBlock.size();
-        delete it->second;
-        mapOrphanBlocksByPrev.erase(it);
-        mapOrphanBlocks.erase(hash);
-    }
-}
-
 bool PeerManagerImpl::ProcessNetBlock(const std::shared_ptr<const CBlock> pblock, bool force_processing, bool min_pow_checked, bool* new_block, CNode& pfrom)
 {
     PeerRef peer = GetPeerRef(pfrom.GetId());
     uint256 hash;
+    bool missing_prev;
     {
         LOCK(cs_main);
 
@@ -6317,26 +6770,30 @@ bool PeerManagerImpl::ProcessNetBlock(const std::shared_ptr<const CBlock> pblock
         // Duplicate stake allowed only when there is orphan child block
         // if the block header is already known, allow it (to account for headers being sent before the block itself)
         hash = pblock->GetHash();
-        if (!m_chainman.m_blockman.LoadingBlocks() && pblock->IsProofOfStake() && setStakeSeen.count(pblock->GetProofOfStake()) && !m_chainman.BlockIndex().count(hash) && !mapOrphanBlocksByPrev.count(hash)) {
+        if (!m_chainman.m_blockman.LoadingBlocks() && pblock->IsProofOfStake() && g_stake_seen.Contains(pblock->prevoutStake, pblock->nTime) && !m_chainman.BlockIndex().count(hash) && !m_block_orphanage.HaveChild(hash)) {
             LogError("ProcessNetBlock() : duplicate proof-of-stake (%s, %d) for block %s", pblock->GetProofOfStake().first.ToString(), pblock->GetProofOfStake().second, hash.ToString());
             return false;
         }
+        missing_prev = !m_chainman.m_blockman.LookupBlockIndex(pblock->hashPrevBlock);
     }
 
-    // Process the header before processing the block
-    const CBlockIndex *pindex = nullptr;
-    BlockValidationState state;
-    if (!ProcessNetBlockHeaders(pfrom, {*pblock}, min_pow_checked, state, &pindex)) {
-        if (state.IsInvalid()) {
-            MaybePunishNodeForBlock(pfrom.GetId(), state, false, strprintf("Peer %d sent us invalid header\n", pfrom.GetId()));
-            LogError("ProcessNetBlock() : invalid header received");
-            return false;
+    // Process the header before processing the block. Without its parent the
+    // header cannot connect, so the block goes to the orphan pool instead.
+    if (!missing_prev) {
+        const CBlockIndex *pindex = nullptr;
+        BlockValidationState state;
+        if (!ProcessNetBlockHeaders(pfrom, {*pblock}, min_pow_checked, state, &pindex)) {
+            if (state.IsInvalid()) {
+                MaybePunishNodeForBlock(pfrom.GetId(), state, false, strprintf("Peer %d sent us invalid header\n", pfrom.GetId()));
+                LogError("ProcessNetBlock() : invalid header received");
+                return false;
+            }
         }
     }
 
     {
         LOCK(cs_main);
-        if (mapOrphanBlocks.count(hash)) {
+        if (m_block_orphanage.HaveBlock(hash)) {
             LogError("ProcessNetBlock() : already have block (orphan) %s", hash.ToString());
             return false;
         }
@@ -6367,38 +6824,23 @@ bool PeerManagerImpl::ProcessNetBlock(const std::shared_ptr<const CBlock> pblock
         // If we don't already have its previous block, shunt it off to holding area until we get it
         if (!m_chainman.BlockIndex().count(pblock->hashPrevBlock))
         {
-            LogPrintf("ProcessNetBlock: ORPHAN BLOCK %lu, prev=%s\n", (unsigned long)mapOrphanBlocks.size(), pblock->hashPrevBlock.ToString());
+            LogPrintf("ProcessNetBlock: ORPHAN BLOCK %lu, prev=%s\n", (unsigned long)m_block_orphanage.Size(), pblock->hashPrevBlock.ToString());
 
-            // Accept orphans as long as there is a node to request its parents from
             // ppcoin: check proof-of-stake
             if (pblock->IsProofOfStake())
             {
                 // Limited duplicity on stake: prevents block flood attack
                 // Duplicate stake allowed only when there is orphan child block
-                if (setStakeSeenOrphan.count(pblock->GetProofOfStake()) && !mapOrphanBlocksByPrev.count(hash)) {
+                if (m_block_orphanage.HaveStake(pblock->prevoutStake, pblock->nTime) && !m_block_orphanage.HaveChild(hash)) {
                     LogError("ProcessNetBlock() : duplicate proof-of-stake (%s, %d) for orphan block %s", pblock->GetProofOfStake().first.ToString(), pblock->GetProofOfStake().second, hash.ToString());
                     return false;
                 }
             }
-            PruneOrphanBlocks();
-            COrphanBlock* pblock2 = new COrphanBlock();
-            {
-                DataStream ss;
-                ss << TX_WITH_WITNESS(*pblock);
-                Span<const uint8_t> cs = MakeUCharSpan(ss);
-                pblock2->vchBlock = std::vector<unsigned char>(cs.begin(), cs.end());
-            }
-            pblock2->hashBlock = hash;
-            pblock2->hashPrev = pblock->hashPrevBlock;
-            pblock2->stake = pblock->GetProofOfStake();
-            nOrphanBlocksSize += pblock2->vchBlock.size();
-            mapOrphanBlocks.insert(std::make_pair(hash, pblock2));
-            mapOrphanBlocksByPrev.insert(std::make_pair(pblock2->hashPrev, pblock2));
-            if (pblock->IsProofOfStake())
-                setStakeSeenOrphan.insert(pblock->GetProofOfStake());
+            m_block_orphanage.AddBlock(pblock, pfrom.GetId());
 
-            // Ask this guy to fill in what we're missing
-            PushGetBlocks(pfrom, m_chainman.m_best_header, GetOrphanRoot(hash));
+            // Ask this peer for the headers we are missing, the blocks are then
+            // downloaded as usual and connecting the parent releases the orphan
+            if (peer) MaybeSendGetHeaders(pfrom, GetLocator(m_chainman.m_best_header), *peer);
             return true;
         }
     }
@@ -6409,35 +6851,44 @@ bool PeerManagerImpl::ProcessNetBlock(const std::shared_ptr<const CBlock> pblock
     }
 
     std::vector<uint256> vWorkQueue;
-    vWorkQueue.push_back(pblock->GetHash());
+    vWorkQueue.push_back(hash);
     for (unsigned int i = 0; i < vWorkQueue.size(); i++)
     {
-        uint256 hashPrev = vWorkQueue[i];
-        for (std::multimap<uint256, COrphanBlock*>::iterator mi = mapOrphanBlocksByPrev.lower_bound(hashPrev);
-             mi != mapOrphanBlocksByPrev.upper_bound(hashPrev);
-             ++mi)
-        {
-            CBlock block;
+        for (const auto& [orphan, orphan_peer] : m_block_orphanage.ExtractChildren(vWorkQueue[i])) {
+            // The orphan is judged on its own header, like a block its sender
+            // had just relayed, not with the flags of the block releasing it
+            const uint256 orphan_hash{orphan->GetHash()};
+            bool orphan_force_processing{false};
+            bool orphan_min_pow_checked{false};
             {
-                DataStream ss(mi->second->vchBlock);
-                ss >> TX_WITH_WITNESS(block);
+                LOCK(cs_main);
+                const CBlockIndex* prev_block{m_chainman.m_blockman.LookupBlockIndex(orphan->hashPrevBlock)};
+                orphan_force_processing = IsBlockRequested(orphan_hash);
+                if (prev_block && prev_block->nChainWork + CalculateClaimedHeadersWork({{orphan->GetBlockHeader()}}) >= GetAntiDoSWorkThreshold()) {
+                    orphan_min_pow_checked = true;
+                }
             }
-            block.hashMerkleRoot = BlockMerkleRoot(block);
-
+            BlockValidationState state;
+            if (!m_chainman.ProcessNewBlockHeaders({{orphan->GetBlockHeader()}}, orphan_min_pow_checked, state)) {
+                if (state.IsInvalid()) {
+                    MaybePunishNodeForBlock(orphan_peer, state, false, strprintf("Peer %d sent us invalid orphan header\n", orphan_peer));
+                }
+                LogDebug(BCLog::NET, "released orphan block %s from peer=%d has a bad header: %s\n", orphan_hash.ToString(), orphan_peer, state.ToString());
+                continue;
+            }
+            // Record the sender only once the header is accepted, for BlockChecked
+            // to punish it, and drop the record again like ProcessBlock does
+            // when the block turns out not to be new
+            WITH_LOCK(cs_main, mapBlockSource.emplace(orphan_hash, std::make_pair(orphan_peer, true)));
             bool new_blockOrphan = false;
-            std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(block);
-            if (m_chainman.ProcessNewBlock(shared_pblock, force_processing, min_pow_checked, &new_blockOrphan))
-                vWorkQueue.push_back(mi->second->hashBlock);
-
-            LOCK(cs_main);
-            mapOrphanBlocks.erase(mi->second->hashBlock);
-            setStakeSeenOrphan.erase(block.GetProofOfStake());
-            nOrphanBlocksSize -= mi->second->vchBlock.size();
-            delete mi->second;
+            const bool orphan_accepted{m_chainman.ProcessNewBlock(orphan, orphan_force_processing, orphan_min_pow_checked, &new_blockOrphan)};
+            if (!new_blockOrphan) {
+                LOCK(cs_main);
+                mapBlockSource.erase(orphan_hash);
+            }
+            if (orphan_accepted)
+                vWorkQueue.push_back(orphan_hash);
         }
-
-        LOCK(cs_main);
-        mapOrphanBlocksByPrev.erase(hashPrev);
     }
 
     return true;
@@ -6584,6 +7035,34 @@ void PeerManagerImpl::StopCleanBlockIndex()
     }
 }
 
+const CBlockIndex* PeerManagerImpl::EVMStateSyncTarget() const
+{
+    AssertLockHeld(::cs_main);
+    if (!m_chainman.m_best_header) return nullptr;
+    return m_chainman.m_best_header->GetAncestor(std::max(0, m_chainman.m_best_header->nHeight - EVM_STATE_SYNC_DEPTH));
+}
+
+std::optional<std::string> PeerManagerImpl::StartEVMStateSync(const CBlockIndex* block_index)
+{
+    LOCK(::cs_main);
+    if (!globalState) return "EVM state is not loaded";
+    m_evm_state_sync_follow = block_index == nullptr;
+    if (!block_index) block_index = EVMStateSyncTarget();
+    if (!block_index) return "No headers to sync the EVM state of";
+
+    if (!m_evm_state_sync) m_evm_state_sync = std::make_unique<qtum::EVMStateSync>(globalState->db(), globalState->dbUtxo());
+    LogInfo("Syncing the EVM state of block %s at height %d\n", block_index->GetBlockHash().ToString(), block_index->nHeight);
+    m_evm_state_sync->SetTarget(block_index->GetBlockHash(), block_index->hashStateRoot, block_index->hashUTXORoot);
+    return std::nullopt;
+}
+
+std::optional<qtum::EVMStateSync::Stats> PeerManagerImpl::GetEVMStateSyncStats() const
+{
+    LOCK(::cs_main);
+    if (!m_evm_state_sync) return std::nullopt;
+    return m_evm_state_sync->GetStats();
+}
+
 unsigned int GefaultHeaderSpamFilterMaxSize()
 {
     return Params().GetConsensus().MaxCheckpointSpan();
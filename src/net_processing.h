@@ -7,7 +7,9 @@
 #define BITCOIN_NET_PROCESSING_H
 
 #include <net.h>
+#include <qtum/evmstatesync.h>
 #include <txorphanage.h>
+#include <util/fs.h>
 #include <validationinterface.h>
 
 #include <chrono>
@@ -30,6 +32,8 @@ static const uint32_t DEFAULT_MAX_ORPHAN_TRANSACTIONS{100};
 static const uint32_t DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN{100};
 static const bool DEFAULT_PEERBLOOMFILTERS = false;
 static const bool DEFAULT_PEERBLOCKFILTERS = false;
+/** Default for -peerevmstate, serve the EVM state of recent blocks to peers */
+static const bool DEFAULT_PEEREVMSTATE = false;
 /** Maximum number of outstanding CMPCTBLOCK requests for the same block. */
 static const unsigned int MAX_CMPCTBLOCKS_INFLIGHT_PER_BLOCK = 3;
 /** Number of headers sent in one getheaders result. We rely on the assumption that if a peer sends
@@ -83,6 +87,8 @@ public:
         bool reconcile_txs{DEFAULT_TXRECONCILIATION_ENABLE};
         //! Maximum number of orphan transactions kept in memory
         uint32_t max_orphan_txs{DEFAULT_MAX_ORPHAN_TRANSACTIONS};
+        //! Maximum size of the orphan blocks kept in memory, in MiB
+        uint32_t max_orphan_blocks_mib{DEFAULT_MAX_ORPHAN_BLOCKS};
         //! Number of non-mempool transactions to keep around for block reconstruction. Includes
         //! orphan, replaced, and rejected transactions.
         uint32_t max_extra_txs{DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN};
@@ -174,6 +180,29 @@ public:
 
     /** Stop clean block index thread */
     virtual void StopCleanBlockIndex() = 0;
+
+    /**
+     * Start downloading the EVM state of a block from peers that serve it.
+     * Without a block, the state of a block a little below the best header
+     * is downloaded, moving to newer blocks as the headers chain grows.
+     *
+     * @returns std::nullopt if the sync was started, otherwise an error message
+     */
+    virtual std::optional<std::string> StartEVMStateSync(const CBlockIndex* block_index) = 0;
+
+    /** Progress of the EVM state sync, if one was started */
+    virtual std::optional<qtum::EVMStateSync::Stats> GetEVMStateSyncStats() const = 0;
+
+    /**
+     * Restore the validator uptime recorded by the heartbeat aggregates of the
+     * active chain from a file written by SaveChainUptime(), and catch up with
+     * the chain. Without a usable file it is rebuilt from the blocks of the
+     * uptime window.
+     */
+    virtual void LoadChainUptime(const fs::path& path) = 0;
+
+    /** Write the validator uptime recorded by the heartbeat aggregates to the file given to LoadChainUptime() */
+    virtual void SaveChainUptime() = 0;
 };
 
 /** Default for -headerspamfiltermaxsize, maximum size of the list of indexes in the header spam filter */
@@ -6,6 +6,7 @@
 
 #include <arith_uint256.h>
 #include <chain.h>
+#include <consensus/consensus.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <dbwrapper.h>
@@ -41,6 +42,7 @@
 #include <cstddef>
 #include <map>
 #include <ranges>
+#include <type_traits>
 #include <unordered_map>
 
 namespace kernel {
@@ -63,6 +65,10 @@ static constexpr uint8_t DB_ADDRESSUNSPENTINDEX{'u'};
 static constexpr uint8_t DB_TIMESTAMPINDEX{'S'};
 static constexpr uint8_t DB_BLOCKHASHINDEX{'z'};
 static constexpr uint8_t DB_SPENTINDEX{'p'};
+static constexpr uint8_t DB_DILITHIUMKEYINDEX{'q'};
+static constexpr uint8_t DB_MPOSBALANCE{'m'};
+static constexpr uint8_t DB_MPOSBALANCEUNDO{'n'};
+static constexpr uint8_t DB_MPOSBALANCEBEST{'N'};
 
 struct DelegateEntry {
     uint160 address;
@@ -176,9 +182,6 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
                     return false;
                 }
 
-                // NovaCoin: build setStakeSeen
-                if (pindexNew->IsProofOfStake())
-                    setStakeSeen.insert(std::make_pair(pindexNew->prevoutStake, pindexNew->nTime));
                 pcursor->Next();
             } else {
                 LogError("%s: failed to read value\n", __func__);
@@ -274,6 +277,34 @@ bool BlockTreeDB::EraseHeightIndex(const unsigned int &height) {
     return WriteBatch(batch);
 }
 
+bool BlockTreeDB::PruneHeightIndex(const unsigned int &height, const dev::h160 &keepAddress, std::set<uint256> &kept) {
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    CDBBatch batch(*this);
+
+    pcursor->Seek(std::make_pair(DB_HEIGHTINDEX, CHeightTxIndexIteratorKey(height)));
+
+    while (pcursor->Valid()) {
+        std::pair<uint8_t, CHeightTxIndexKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_HEIGHTINDEX && key.second.height == height) {
+            if (key.second.address == keepAddress) {
+                std::vector<uint256> hashesTx;
+                if (!pcursor->GetValue(hashesTx)) {
+                    return false;
+                }
+                kept.insert(hashesTx.begin(), hashesTx.end());
+            } else {
+                batch.Erase(key);
+            }
+            pcursor->Next();
+        } else {
+            break;
+        }
+    }
+
+    return WriteBatch(batch);
+}
+
 bool BlockTreeDB::WipeHeightIndex() {
 
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
@@ -555,6 +586,94 @@ bool BlockTreeDB::UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, C
     return WriteBatch(batch);
 }
 
+bool BlockTreeDB::WriteDilithiumKeyIndex(const std::vector<std::pair<uint160, CDilithiumKeyIndexValue>>& vect) {
+    CDBBatch batch(*this);
+    for (const auto& [keyid, value] : vect) {
+        batch.Write(std::make_pair(DB_DILITHIUMKEYINDEX, keyid), value);
+    }
+    return WriteBatch(batch);
+}
+
+bool BlockTreeDB::ReadDilithiumKeyIndex(const uint160& keyid, CDilithiumKeyIndexValue& value) const {
+    return Read(std::make_pair(DB_DILITHIUMKEYINDEX, keyid), value);
+}
+
+bool BlockTreeDB::EraseDilithiumKeyIndex(const std::vector<uint160>& vect) {
+    CDBBatch batch(*this);
+    for (const uint160& keyid : vect) {
+        batch.Erase(std::make_pair(DB_DILITHIUMKEYINDEX, keyid));
+    }
+    return WriteBatch(batch);
+}
+
+bool BlockTreeDB::ReadMPoSBalance(const uint160& keyid, CAmount& balance) const {
+    balance = 0;
+    return !Exists(std::make_pair(DB_MPOSBALANCE, keyid)) || Read(std::make_pair(DB_MPOSBALANCE, keyid), balance);
+}
+
+bool BlockTreeDB::ReadMPoSBalanceBestBlock(uint256& hash) const {
+    return Read(DB_MPOSBALANCEBEST, hash);
+}
+
+bool BlockTreeDB::ReadMPoSBalanceUndo(int height, CMPoSBalanceUndo& undo) const {
+    return Read(std::make_pair(DB_MPOSBALANCEUNDO, height), undo);
+}
+
+bool BlockTreeDB::WriteMPoSBalances(int height, const std::vector<std::pair<uint160, CAmount>>& balances, const CMPoSBalanceUndo& undo, int pruneHeight) {
+    CDBBatch batch(*this);
+    for (const auto& [keyid, balance] : balances) {
+        if (balance == 0) {
+            batch.Erase(std::make_pair(DB_MPOSBALANCE, keyid));
+        } else {
+            batch.Write(std::make_pair(DB_MPOSBALANCE, keyid), balance);
+        }
+    }
+    batch.Write(std::make_pair(DB_MPOSBALANCEUNDO, height), undo);
+    if (pruneHeight >= 0) {
+        batch.Erase(std::make_pair(DB_MPOSBALANCEUNDO, pruneHeight));
+    }
+    batch.Write(DB_MPOSBALANCEBEST, undo.blockHash);
+    return WriteBatch(batch);
+}
+
+bool BlockTreeDB::UndoMPoSBalances(int height, const CMPoSBalanceUndo& undo, const uint256& hashPrevBlock) {
+    CDBBatch batch(*this);
+    for (const auto& [keyid, balance] : undo.balances) {
+        if (balance == 0) {
+            batch.Erase(std::make_pair(DB_MPOSBALANCE, keyid));
+        } else {
+            batch.Write(std::make_pair(DB_MPOSBALANCE, keyid), balance);
+        }
+    }
+    batch.Erase(std::make_pair(DB_MPOSBALANCEUNDO, height));
+    batch.Write(DB_MPOSBALANCEBEST, hashPrevBlock);
+    return WriteBatch(batch);
+}
+
+bool BlockTreeDB::WipeMPoSBalances() {
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    CDBBatch batch(*this);
+
+    for (uint8_t prefix : {DB_MPOSBALANCE, DB_MPOSBALANCEUNDO}) {
+        pcursor->Seek(prefix);
+        while (pcursor->Valid()) {
+            std::pair<uint8_t, uint160> balanceKey;
+            std::pair<uint8_t, int> undoKey;
+            if (prefix == DB_MPOSBALANCE && pcursor->GetKey(balanceKey) && balanceKey.first == prefix) {
+                batch.Erase(balanceKey);
+            } else if (prefix == DB_MPOSBALANCEUNDO && pcursor->GetKey(undoKey) && undoKey.first == prefix) {
+                batch.Erase(undoKey);
+            } else {
+                break;
+            }
+            pcursor->Next();
+        }
+    }
+    batch.Erase(DB_MPOSBALANCEBEST);
+
+    return WriteBatch(batch);
+}
+
 bool BlockTreeDB::blockOnchainActive(const uint256 &hash, ChainstateManager &chainman) {
     LOCK(cs_main);
     node::BlockMap::iterator mi = chainman.BlockIndex().find(hash);
@@ -642,8 +761,6 @@ CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, CBlockInde
     // competitive advantage.
     pindexNew->nSequenceId = 0;
 
-    if (pindexNew->IsProofOfStake())
-        setStakeSeen.insert(std::make_pair(pindexNew->prevoutStake, pindexNew->nTime));
     pindexNew->phashBlock = &((*mi).first);
     BlockMap::iterator miPrev = m_block_index.find(block.hashPrevBlock);
     if (miPrev != m_block_index.end()) {
@@ -657,6 +774,10 @@ CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, CBlockInde
     pindexNew->RaiseValidity(BLOCK_VALID_TREE);
     if (best_header == nullptr || best_header->nChainWork < pindexNew->nChainWork) {
         best_header = pindexNew;
+        g_stake_seen.SetMinHeight(GetStakeSeenCutoff(best_header->nHeight, GetConsensus()));
+    }
+    if (pindexNew->IsProofOfStake()) {
+        g_stake_seen.Insert(pindexNew->prevoutStake, pindexNew->nTime, pindexNew->nHeight);
     }
 
     m_dirty_blockindex.insert(pindexNew);
@@ -859,6 +980,12 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
     std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
               CBlockIndexHeightOnlyComparator());
 
+    // Only the stakes of blocks near the best header are needed to detect duplicates
+    g_stake_seen.Clear();
+    if (!vSortedByHeight.empty()) {
+        g_stake_seen.SetMinHeight(GetStakeSeenCutoff(vSortedByHeight.back()->nHeight, GetConsensus()));
+    }
+
     CBlockIndex* previous_index{nullptr};
     for (CBlockIndex* pindex : vSortedByHeight) {
         if (m_interrupt) return false;
@@ -897,6 +1024,9 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
         if (pindex->pprev) {
             pindex->BuildSkip();
         }
+        if (pindex->IsProofOfStake()) {
+            g_stake_seen.Insert(pindex->prevoutStake, pindex->nTime, pindex->nHeight);
+        }
     }
 
     return true;
@@ -1478,7 +1608,15 @@ bool BlockManager::ReadBlock(Block& block, const FlatFilePos& pos) const
 
     // Read block
     try {
-        filein >> TX_WITH_WITNESS(block);
+        if constexpr (std::is_same_v<Block, CBlock>) {
+            if (m_opts.block_arena) {
+                filein >> TX_WITH_WITNESS(BlockWithArena{block, dgpMaxBlockSerSize});
+            } else {
+                filein >> TX_WITH_WITNESS(block);
+            }
+        } else {
+            filein >> TX_WITH_WITNESS(block);
+        }
     } catch (const std::exception& e) {
         LogError("%s: Deserialize or I/O error - %s at %s\n", __func__, e.what(), pos.ToString());
         return false;
@@ -54,6 +54,8 @@ struct CMempoolAddressDeltaKey;
 struct CTimestampIndexKey;
 struct CTimestampBlockIndexKey;
 struct CTimestampBlockIndexValue;
+struct CDilithiumKeyIndexValue;
+struct CMPoSBalanceUndo;
 ////////////////////////////////////
 namespace Consensus {
 struct Params;
@@ -99,6 +101,15 @@ public:
     bool EraseHeightIndex(const unsigned int &height);
     bool WipeHeightIndex();
 
+    /**
+     * Erases the log index entries of a block height, except those of one address.
+     *
+     * @param height block height to prune
+     * @param keepAddress address whose entries are kept
+     * @param kept transaction hashes of the kept entries are added to this set.
+     */
+    bool PruneHeightIndex(const unsigned int &height, const dev::h160 &keepAddress, std::set<uint256> &kept);
+
 
     bool WriteStakeIndex(unsigned int height, uint160 address);
     bool ReadStakeIndex(unsigned int height, uint160& address);
@@ -127,6 +138,22 @@ public:
     bool ReadSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value);
     bool UpdateSpentIndex(const std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> >&vect);
     bool blockOnchainActive(const uint256 &hash, ChainstateManager &chainman);
+
+    // Dilithium public keys revealed on chain, keyed by HASH160 of the key.
+    // Entries are only valid while their block is in the active chain, see ChainDilithiumKeys
+    bool WriteDilithiumKeyIndex(const std::vector<std::pair<uint160, CDilithiumKeyIndexValue>>& vect);
+    bool ReadDilithiumKeyIndex(const uint160& keyid, CDilithiumKeyIndexValue& value) const;
+    bool EraseDilithiumKeyIndex(const std::vector<uint160>& vect);
+
+    // MPoS rewards accrued to the public key hash of their recipient, see Consensus::Params::nMPoSBalanceHeight
+    bool ReadMPoSBalance(const uint160& keyid, CAmount& balance) const;
+    bool ReadMPoSBalanceBestBlock(uint256& hash) const;
+    bool ReadMPoSBalanceUndo(int height, CMPoSBalanceUndo& undo) const;
+    /** Set the balances after the block at height, 0 removes a balance, and keep the undo data of the block. The undo data of the block at pruneHeight is removed. */
+    bool WriteMPoSBalances(int height, const std::vector<std::pair<uint160, CAmount>>& balances, const CMPoSBalanceUndo& undo, int pruneHeight);
+    /** Restore the balances before the block at height */
+    bool UndoMPoSBalances(int height, const CMPoSBalanceUndo& undo, const uint256& hashPrevBlock);
+    bool WipeMPoSBalances();
     //////////////////////////////////////////////////////////////////////////////
 };
 } // namespace kernel
@@ -417,6 +444,8 @@ public:
 
     /** Attempt to stay below this number of bytes of block files. */
     [[nodiscard]] uint64_t GetPruneTarget() const { return m_opts.prune_target; }
+    /** Whether blocks are deserialized with their transactions in one arena, see BlockWithArena. */
+    [[nodiscard]] bool UseBlockArena() const { return m_opts.block_arena; }
     static constexpr auto PRUNE_TARGET_MANUAL{std::numeric_limits<uint64_t>::max()};
 
     [[nodiscard]] bool LoadingBlocks() const { return m_importing || !m_blockfiles_indexed; }
@@ -762,6 +791,44 @@ struct CAddressUnspentValue {
     }
 };
 
+struct CDilithiumKeyIndexValue {
+    int blockHeight;
+    //! Block that revealed the key
+    uint256 blockHash;
+    std::vector<unsigned char> pubkey;
+
+    SERIALIZE_METHODS(CDilithiumKeyIndexValue, obj) { READWRITE(obj.blockHeight, obj.blockHash, obj.pubkey); }
+
+    CDilithiumKeyIndexValue(int height, const uint256& hash, std::vector<unsigned char> key) {
+        blockHeight = height;
+        blockHash = hash;
+        pubkey = std::move(key);
+    }
+
+    CDilithiumKeyIndexValue() {
+        SetNull();
+    }
+
+    void SetNull() {
+        blockHeight = 0;
+        blockHash.SetNull();
+        pubkey.clear();
+    }
+
+    bool IsNull() const {
+        return pubkey.empty();
+    }
+};
+
+struct CMPoSBalanceUndo {
+    //! Block that changed the balances
+    uint256 blockHash;
+    //! Balances before the block of every key hash it changed
+    std::vector<std::pair<uint160, CAmount>> balances;
+
+    SERIALIZE_METHODS(CMPoSBalanceUndo, obj) { READWRITE(obj.blockHash, obj.balances); }
+};
+
 struct CAddressIndexKey {
     uint8_t type;
     uint256 hashBytes;
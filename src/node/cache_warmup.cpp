@@ -0,0 +1,288 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/cache_warmup.h>
+
+#include <coins.h>
+#include <common/args.h>
+#include <logging.h>
+#include <qtum/qtumstate.h>
+#include <serialize.h>
+#include <streams.h>
+#include <sync.h>
+#include <util/convert.h>
+#include <util/fs.h>
+#include <util/fs_helpers.h>
+#include <util/signalinterrupt.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace node {
+
+static const uint64_t CACHE_WARMUP_DUMP_VERSION{1};
+
+/** Keys read per cs_main lock */
+static constexpr size_t CACHE_WARMUP_BATCH{1000};
+
+namespace {
+
+/**
+ * The last MAX_WARMUP_STATE_NODES node hashes read from a database,
+ * overwriting the oldest. Every trie node read from disk is recorded, so
+ * recording takes no lock: each slot is a sequence lock, and a slot that is
+ * being written while it is read is skipped.
+ */
+class StateReadRecorder
+{
+    struct Slot {
+        //! Number of the read stored in the slot plus one, 0 while it is written
+        std::atomic<uint64_t> seq{0};
+        std::array<std::atomic<uint64_t>, 4> words{};
+    };
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<uint64_t> m_next{0};
+
+public:
+    //! Allocate the slots, before the reads are observed
+    void Enable()
+    {
+        if (!m_slots) m_slots = std::make_unique<Slot[]>(MAX_WARMUP_STATE_NODES);
+    }
+
+    void Record(const dev::h256& hash)
+    {
+        const uint64_t n{m_next.fetch_add(1, std::memory_order_relaxed)};
+        Slot& slot{m_slots[n % MAX_WARMUP_STATE_NODES]};
+        std::array<uint64_t, 4> words;
+        static_assert(sizeof(words) == dev::h256::size);
+        std::memcpy(words.data(), hash.data(), sizeof(words));
+        slot.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < words.size(); ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.seq.store(n + 1, std::memory_order_release);
+    }
+
+    //! The distinct hashes, newest first
+    std::vector<uint256> Get() const
+    {
+        if (!m_slots) return {};
+        std::vector<std::pair<uint64_t, uint256>> reads;
+        for (size_t i = 0; i < MAX_WARMUP_STATE_NODES; ++i) {
+            const Slot& slot{m_slots[i]};
+            const uint64_t seq{slot.seq.load(std::memory_order_acquire)};
+            if (seq == 0) continue;
+            std::array<uint64_t, 4> words;
+            for (size_t j = 0; j < words.size(); ++j) {
+                words[j] = slot.words[j].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+            uint256 hash;
+            std::memcpy(hash.data(), words.data(), sizeof(words));
+            reads.emplace_back(seq, hash);
+        }
+        std::sort(reads.begin(), reads.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        std::vector<uint256> hashes;
+        std::set<uint256> seen;
+        for (const auto& [seq, hash] : reads) {
+            if (seen.insert(hash).second) hashes.push_back(hash);
+        }
+        return hashes;
+    }
+};
+
+StateReadRecorder g_state_reads;
+StateReadRecorder g_utxo_reads;
+
+Mutex g_warmup_mutex;
+std::optional<CacheWarmupKeys> g_warmup_keys GUARDED_BY(g_warmup_mutex);
+CacheWarmupProgress g_warmup_progress GUARDED_BY(g_warmup_mutex);
+
+} // namespace
+
+bool ShouldWarmCaches(const ArgsManager& argsman)
+{
+    return argsman.GetBoolArg("-cachewarmup", DEFAULT_CACHE_WARMUP);
+}
+
+fs::path CacheWarmupPath(const ArgsManager& argsman)
+{
+    return argsman.GetDataDirNet() / "warmcache.dat";
+}
+
+void RecordStateReads(QtumState& state)
+{
+    g_state_reads.Enable();
+    g_utxo_reads.Enable();
+    state.db().setReadObserver([](const dev::h256& hash) { g_state_reads.Record(hash); });
+    state.dbUtxo().setReadObserver([](const dev::h256& hash) { g_utxo_reads.Record(hash); });
+}
+
+CacheWarmupKeys GetCacheWarmupKeys(Chainstate& chainstate)
+{
+    AssertLockHeld(::cs_main);
+    CacheWarmupKeys keys;
+    if (const CBlockIndex* tip{chainstate.m_chain.Tip()}) keys.tip = tip->GetBlockHash();
+    keys.coins = chainstate.CoinsTip().GetCachedOutpoints(MAX_WARMUP_COINS);
+    keys.state_nodes = g_state_reads.Get();
+    keys.utxo_nodes = g_utxo_reads.Get();
+    return keys;
+}
+
+bool DumpCacheWarmupKeys(const CacheWarmupKeys& keys, const fs::path& dump_path)
+{
+    AutoFile file{fsbridge::fopen(dump_path + ".new", "wb")};
+    if (file.IsNull()) {
+        return false;
+    }
+
+    try {
+        file << CACHE_WARMUP_DUMP_VERSION;
+        file << keys.tip;
+        file << keys.coins;
+        file << keys.state_nodes;
+        file << keys.utxo_nodes;
+
+        if (!file.Commit())
+            throw std::runtime_error("Commit failed");
+        file.fclose();
+        if (!RenameOver(dump_path + ".new", dump_path)) {
+            throw std::runtime_error("Rename failed");
+        }
+        LogInfo("Dumped the keys of %u coins and %u trie nodes for the cache warm-up\n",
+                keys.coins.size(), keys.state_nodes.size() + keys.utxo_nodes.size());
+    } catch (const std::exception& e) {
+        LogInfo("Failed to dump the cache warm-up keys: %s. Continuing anyway.\n", e.what());
+        return false;
+    }
+    return true;
+}
+
+bool LoadCacheWarmup(const fs::path& load_path)
+{
+    AutoFile file{fsbridge::fopen(load_path, "rb")};
+    if (file.IsNull()) {
+        LogInfo("No cache warm-up file, the caches start cold.\n");
+        return false;
+    }
+
+    CacheWarmupKeys keys;
+    try {
+        uint64_t version;
+        file >> version;
+        if (version != CACHE_WARMUP_DUMP_VERSION) {
+            return false;
+        }
+        file >> keys.tip;
+        file >> keys.coins;
+        file >> keys.state_nodes;
+        file >> keys.utxo_nodes;
+    } catch (const std::exception& e) {
+        LogInfo("Failed to read the cache warm-up file: %s. Continuing anyway.\n", e.what());
+        return false;
+    }
+
+    LOCK(g_warmup_mutex);
+    g_warmup_progress = {};
+    g_warmup_progress.active = true;
+    g_warmup_progress.coins = keys.coins.size();
+    g_warmup_progress.nodes = keys.state_nodes.size() + keys.utxo_nodes.size();
+    g_warmup_keys = std::move(keys);
+    return true;
+}
+
+void RunCacheWarmup(Chainstate& chainstate, const util::SignalInterrupt& interrupt)
+{
+    std::optional<CacheWarmupKeys> keys;
+    {
+        LOCK(g_warmup_mutex);
+        keys.swap(g_warmup_keys);
+    }
+    if (!keys) return;
+
+    const auto start{SteadyClock::now()};
+    const auto update = [&](uint64_t coins_loaded, uint64_t nodes_loaded, bool done) {
+        LOCK(g_warmup_mutex);
+        g_warmup_progress.coins_loaded += coins_loaded;
+        g_warmup_progress.nodes_loaded += nodes_loaded;
+        g_warmup_progress.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - start);
+        if (done) {
+            g_warmup_progress.active = false;
+            g_warmup_progress.complete = !interrupt;
+        }
+    };
+    {
+        LOCK(::cs_main);
+        if (const CBlockIndex* tip{chainstate.m_chain.Tip()}; tip && tip->GetBlockHash() != keys->tip) {
+            LogInfo("The cache warm-up keys were dumped at another tip, prefetching them anyway\n");
+        }
+    }
+
+    // Reading a node loads its block into the block cache of the state
+    // database, sized from -dbcache, which is where the trie nodes are
+    // cached between blocks
+    const auto prefetch_nodes = [&](const std::vector<uint256>& hashes, bool utxo) {
+        for (size_t i = 0; i < hashes.size() && !interrupt; i += CACHE_WARMUP_BATCH) {
+            const size_t end{std::min(hashes.size(), i + CACHE_WARMUP_BATCH)};
+            {
+                LOCK(::cs_main);
+                if (!globalState) return;
+                const dev::OverlayDB& db{utxo ? globalState->dbUtxo() : globalState->db()};
+                for (size_t j = i; j < end; ++j) {
+                    db.lookup(uintToh256(hashes[j]));
+                }
+            }
+            update(0, end - i, false);
+        }
+    };
+    prefetch_nodes(keys->state_nodes, /*utxo=*/false);
+    prefetch_nodes(keys->utxo_nodes, /*utxo=*/true);
+
+    for (size_t i = 0; i < keys->coins.size() && !interrupt; i += CACHE_WARMUP_BATCH) {
+        const size_t end{std::min(keys->coins.size(), i + CACHE_WARMUP_BATCH)};
+        {
+            LOCK(::cs_main);
+            CCoinsViewCache& coins{chainstate.CoinsTip()};
+            if (coins.DynamicMemoryUsage() > chainstate.m_coinstip_cache_size_bytes / 2) break;
+            for (size_t j = i; j < end; ++j) {
+                coins.HaveCoin(keys->coins[j]);
+            }
+        }
+        update(end - i, 0, false);
+    }
+    update(0, 0, true);
+
+    const CacheWarmupProgress progress{GetCacheWarmupProgress()};
+    LogInfo("Cache warm-up %s: %u of %u coins and %u of %u trie nodes in %.3fs\n",
+            progress.complete ? "done" : "interrupted", progress.coins_loaded, progress.coins,
+            progress.nodes_loaded, progress.nodes, Ticks<SecondsDouble>(progress.elapsed));
+}
+
+CacheWarmupProgress GetCacheWarmupProgress()
+{
+    LOCK(g_warmup_mutex);
+    return g_warmup_progress;
+}
+
+bool IsCacheWarmupActive()
+{
+    LOCK(g_warmup_mutex);
+    return g_warmup_progress.active;
+}
+
+} // namespace node
@@ -0,0 +1,90 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_CACHE_WARMUP_H
+#define BITCOIN_NODE_CACHE_WARMUP_H
+
+#include <kernel/cs_main.h>
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/fs.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+class ArgsManager;
+class Chainstate;
+class QtumState;
+namespace util {
+class SignalInterrupt;
+} // namespace util
+
+namespace node {
+
+static constexpr bool DEFAULT_CACHE_WARMUP{true};
+/** Coins of the coins tip cache remembered for the next start */
+static constexpr size_t MAX_WARMUP_COINS{200000};
+/** Recently read EVM trie nodes remembered per database for the next start */
+static constexpr size_t MAX_WARMUP_STATE_NODES{100000};
+
+/** The keys of the cache entries at shutdown */
+struct CacheWarmupKeys {
+    uint256 tip;
+    //! Unspent coins in the coins tip cache, in no particular order
+    std::vector<COutPoint> coins;
+    //! Account, storage and code nodes of the EVM state read from disk, newest first
+    std::vector<uint256> state_nodes;
+    //! Nodes of the contract UTXO trie read from disk, newest first
+    std::vector<uint256> utxo_nodes;
+};
+
+struct CacheWarmupProgress {
+    //! Whether the prefetch is pending or running, which holds back staking
+    bool active{false};
+    //! Whether the prefetch finished without being interrupted
+    bool complete{false};
+    uint64_t coins{0};
+    uint64_t coins_loaded{0};
+    uint64_t nodes{0};
+    uint64_t nodes_loaded{0};
+    std::chrono::milliseconds elapsed{0};
+};
+
+bool ShouldWarmCaches(const ArgsManager& argsman);
+fs::path CacheWarmupPath(const ArgsManager& argsman);
+
+/** Remember the EVM trie nodes that the state and contract UTXO databases of state read from disk */
+void RecordStateReads(QtumState& state);
+
+/**
+ * Collect the coins of the coins tip cache and the trie nodes recorded since
+ * RecordStateReads(). The cache does not track when a coin was last used, so
+ * when it holds more than MAX_WARMUP_COINS coins the ones kept are an
+ * arbitrary subset of them.
+ */
+CacheWarmupKeys GetCacheWarmupKeys(Chainstate& chainstate) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+bool DumpCacheWarmupKeys(const CacheWarmupKeys& keys, const fs::path& dump_path);
+
+/**
+ * Read the keys dumped at the last shutdown for RunCacheWarmup(). Staking
+ * waits from now on until the prefetch is done.
+ */
+bool LoadCacheWarmup(const fs::path& load_path);
+
+/**
+ * Read the loaded trie nodes and coins into the caches of the chainstate in
+ * batches, taking cs_main for each batch so blocks are connected in between.
+ * Coins are only added while the coins tip cache is less than half full.
+ */
+void RunCacheWarmup(Chainstate& chainstate, const util::SignalInterrupt& interrupt) EXCLUSIVE_LOCKS_REQUIRED(!::cs_main);
+
+CacheWarmupProgress GetCacheWarmupProgress();
+bool IsCacheWarmupActive();
+
+} // namespace node
+
+#endif // BITCOIN_NODE_CACHE_WARMUP_H
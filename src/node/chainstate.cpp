@@ -23,6 +23,7 @@
 #include <validation.h>
 #include <chainparams.h>
 #include <common/args.h>
+#include <libdevcore/LevelDB.h>
 
 #include <algorithm>
 #include <cassert>
@@ -225,6 +226,8 @@ ChainstateLoadResult LoadChainstate(ChainstateManager& chainman, const CacheSize
 
     chainman.m_total_coinstip_cache = cache_sizes.coins;
     chainman.m_total_coinsdb_cache = cache_sizes.coins_db;
+    // Split between the state and the UTXO trie databases
+    dev::db::LevelDB::setBlockCacheSize(cache_sizes.evm_state_db / 2);
 
     // Load the fully validated chainstate.
     chainman.InitializeChainstate(options.mempool);
@@ -44,6 +44,8 @@
 #include <policy/policy.h>
 #include <policy/rbf.h>
 #include <policy/settings.h>
+#include <pos.h>
+#include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
@@ -54,6 +56,7 @@
 #include <util/time.h>
 #include <txmempool.h>
 #include <uint256.h>
+#include <undo.h>
 #include <univalue.h>
 #include <util/check.h>
 #include <util/result.h>
@@ -98,6 +101,9 @@ namespace node {
 // All members of the classes in this namespace are intentionally public, as the
 // classes themselves are private.
 namespace {
+//! Blocks a staker can be behind before getStakeCoins() scans the UTXO set again instead of replaying them
+static constexpr int MAX_STAKE_COINS_UPDATE_BLOCKS{1000};
+
 #ifdef ENABLE_EXTERNAL_SIGNER
 class ExternalSignerImpl : public interfaces::ExternalSigner
 {
@@ -993,6 +999,12 @@ public:
     {
         return GetTxGasFee(tx, mempool(), chainman().ActiveChainstate());
     }
+    uint64_t getMinGasPrice() override
+    {
+        LOCK(::cs_main);
+        QtumDGP qtumDGP(globalState.get(), chainman().ActiveChainstate(), fGettingValuesDGP);
+        return qtumDGP.getMinGasPrice(chainman().ActiveChain().Height() + 1);
+    }
 #ifdef ENABLE_WALLET
     void startStake(wallet::CWallet& wallet) override
     {
@@ -1155,6 +1167,133 @@ public:
         return std::make_unique<BlockTemplateImpl>(BlockAssembler{chainman().ActiveChainstate(), context()->mempool.get(), assemble_options}.CreateNewBlock(fProofOfStake, pTotalFees, nTime, nTimeLimit), m_node);
     }
 
+    std::optional<StakeTarget> getStakeTarget() override
+    {
+        LOCK(::cs_main);
+        const CBlockIndex* tip{chainman().ActiveChain().Tip()};
+        if (!tip) return {};
+        const Consensus::Params& params{chainman().GetConsensus()};
+        StakeTarget target;
+        target.prev_hash = tip->GetBlockHash();
+        target.height = tip->nHeight + 1;
+        target.timestamp_mask = params.StakeTimestampMask(target.height);
+        CBlockHeader header;
+        header.nTime = TicksSinceEpoch<std::chrono::seconds>(NodeClock::now()) & ~target.timestamp_mask;
+        target.bits = GetNextWorkRequired(tip, &header, params, /*fProofOfStake=*/true);
+        target.stake_modifier = tip->nStakeModifier;
+        target.min_time = std::max(tip->GetMedianTimePast(), tip->GetBlockTime()) + 1;
+        target.max_coin_height = target.height - params.CoinbaseMaturity(target.height);
+        return target;
+    }
+
+    StakeCoinsUpdate getStakeCoins(const std::vector<CScript>& scripts, const uint256& since) override
+    {
+        const std::set<CScript> needles(scripts.begin(), scripts.end());
+        Chainstate& chainstate{chainman().ActiveChainstate()};
+        StakeCoinsUpdate update;
+        uint256 from{since};
+        std::unique_ptr<CCoinsViewCursor> cursor;
+        {
+            LOCK(::cs_main);
+            const CBlockIndex* since_index{since.IsNull() ? nullptr : chainman().m_blockman.LookupBlockIndex(since)};
+            if (!since_index || !chainstate.m_chain.Contains(since_index) ||
+                chainstate.m_chain.Height() - since_index->nHeight > MAX_STAKE_COINS_UPDATE_BLOCKS) {
+                // Start over from the UTXO set last flushed to disk, and catch
+                // up with the blocks connected since. Only flush when that
+                // state was reorganized away.
+                const CBlockIndex* flushed{chainman().m_blockman.LookupBlockIndex(chainstate.CoinsDB().GetBestBlock())};
+                if (!flushed || !chainstate.m_chain.Contains(flushed)) chainstate.ForceFlushStateToDisk();
+                cursor = chainstate.CoinsDB().Cursor();
+                if (!cursor) return {};
+                from = cursor->GetBestBlock();
+                update.full = true;
+            }
+        }
+        // The cursor reads a snapshot, so the scan needs no lock
+        for (; cursor && cursor->Valid(); cursor->Next()) {
+            COutPoint prevout;
+            Coin coin;
+            if (!cursor->GetKey(prevout) || !cursor->GetValue(coin)) continue;
+            if (needles.count(coin.out.scriptPubKey) == 0) continue;
+            update.coins.push_back({prevout, coin.out, int(coin.nHeight), 0});
+        }
+
+        std::vector<const CBlockIndex*> blocks;
+        {
+            LOCK(::cs_main);
+            const CBlockIndex* tip{chainstate.m_chain.Tip()};
+            const CBlockIndex* from_index{chainman().m_blockman.LookupBlockIndex(from)};
+            // Reorganized while scanning, the caller retries on the next tip
+            if (!tip || !from_index || !chainstate.m_chain.Contains(from_index)) return {};
+            for (StakeCoin& coin : update.coins) {
+                coin.block_from_time = tip->GetAncestor(coin.height)->nTime;
+            }
+            for (const CBlockIndex* pindex{tip}; pindex != from_index; pindex = pindex->pprev) {
+                blocks.push_back(pindex);
+            }
+            update.tip = tip->GetBlockHash();
+        }
+
+        // Replay the blocks since, taking the scripts of spent coins from the undo data
+        for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+            const CBlockIndex& index{**it};
+            CBlock block;
+            CBlockUndo block_undo;
+            if (!chainman().m_blockman.ReadBlock(block, index) || !chainman().m_blockman.ReadBlockUndo(block_undo, index) ||
+                block_undo.vtxundo.size() + 1 != block.vtx.size()) {
+                return {};
+            }
+            for (size_t i = 0; i < block.vtx.size(); ++i) {
+                const CTransaction& tx{*block.vtx[i]};
+                if (i > 0) {
+                    const CTxUndo& tx_undo{block_undo.vtxundo[i - 1]};
+                    for (size_t j = 0; j < tx.vin.size() && j < tx_undo.vprevout.size(); ++j) {
+                        if (needles.count(tx_undo.vprevout[j].out.scriptPubKey) == 0) continue;
+                        const COutPoint& prevout{tx.vin[j].prevout};
+                        if (std::erase_if(update.coins, [&](const StakeCoin& coin) { return coin.prevout == prevout; }) == 0) {
+                            update.spent.push_back(prevout);
+                        }
+                    }
+                }
+                for (size_t n = 0; n < tx.vout.size(); ++n) {
+                    if (needles.count(tx.vout[n].scriptPubKey) == 0) continue;
+                    update.coins.push_back({COutPoint{tx.GetHash(), uint32_t(n)}, tx.vout[n], index.nHeight, index.nTime});
+                }
+            }
+        }
+        return update;
+    }
+
+    std::unique_ptr<BlockTemplate> createNewStakeBlock(const BlockCreateOptions& options, const uint256& prev_hash,
+                                                       const COutPoint& kernel, uint32_t time) override
+    {
+        BlockAssembler::Options assemble_options{options};
+        ApplyArgsManOptions(*Assert(m_node.args), assemble_options);
+        LOCK(::cs_main);
+        const CBlockIndex* tip{chainman().ActiveChain().Tip()};
+        if (!tip || tip->GetBlockHash() != prev_hash) return nullptr;
+        int64_t total_fees{0};
+        std::unique_ptr<CBlockTemplate> block_template{BlockAssembler{chainman().ActiveChainstate(), context()->mempool.get(), assemble_options}.CreateNewBlock(/*fProofOfStake=*/true, &total_fees, time)};
+        if (!block_template) return nullptr;
+        CBlock& block{block_template->block};
+        CCoinsViewCache& view{chainman().ActiveChainstate().CoinsTip()};
+        const Coin& coin{view.AccessCoin(kernel)};
+        if (coin.IsSpent() || block.nTime != time ||
+            !CheckKernel(const_cast<CBlockIndex*>(tip), block.nBits, block.nTime, kernel, view, chainman().ActiveChainstate()) ||
+            !FillCoinStake(block, kernel, coin.out, total_fees, tip, chainman())) {
+            return nullptr;
+        }
+        return std::make_unique<BlockTemplateImpl>(std::move(block_template), m_node);
+    }
+
+    bool submitStakeBlock(const CBlock& block) override
+    {
+        if (!block.IsProofOfStake()) return false;
+        auto block_ptr = std::make_shared<const CBlock>(block);
+        bool new_block{false};
+        return chainman().ProcessNewBlock(block_ptr, /*force_processing=*/true, /*min_pow_checked=*/true, &new_block) && new_block;
+    }
+
     NodeContext* context() override { return &m_node; }
     ChainstateManager& chainman() { return *Assert(m_node.chainman); }
     KernelNotifications& notifications() { return *Assert(m_node.notifications); }
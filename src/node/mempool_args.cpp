@@ -102,6 +102,7 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& argsman, const CChainP
     }
 
     mempool_opts.persist_v1_dat = argsman.GetBoolArg("-persistmempoolv1", mempool_opts.persist_v1_dat);
+    mempool_opts.persist_witness = argsman.GetBoolArg("-persistmempoolwitness", mempool_opts.persist_witness);
 
     ApplyArgsManOptions(argsman, mempool_opts.limits);
 
@@ -37,6 +37,11 @@ namespace node {
 
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
 static const uint64_t MEMPOOL_DUMP_VERSION{2};
+/** Like MEMPOOL_DUMP_VERSION, with the validation results of each transaction */
+static const uint64_t MEMPOOL_DUMP_VERSION_WITNESS{3};
+
+/** Bits of the per-transaction witness byte in MEMPOOL_DUMP_VERSION_WITNESS files */
+static constexpr uint8_t WITNESS_SCRIPTS_VERIFIED{1 << 0};
 
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
@@ -53,6 +58,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
     int64_t failed = 0;
     int64_t already_there = 0;
     int64_t unbroadcast = 0;
+    int64_t witnessed = 0;
     const auto now{NodeClock::now()};
 
     try {
@@ -61,12 +67,19 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         std::vector<std::byte> xor_key;
         if (version == MEMPOOL_DUMP_VERSION_NO_XOR_KEY) {
             // Leave XOR-key empty
-        } else if (version == MEMPOOL_DUMP_VERSION) {
+        } else if (version == MEMPOOL_DUMP_VERSION || version == MEMPOOL_DUMP_VERSION_WITNESS) {
             file >> xor_key;
         } else {
             return false;
         }
         file.SetXor(xor_key);
+        const bool has_witness{version == MEMPOOL_DUMP_VERSION_WITNESS};
+        uint256 witness_tip;
+        uint64_t witness_script_flags{0};
+        if (has_witness) {
+            file >> witness_tip;
+            file >> witness_script_flags;
+        }
         uint64_t total_txns_to_load;
         file >> total_txns_to_load;
         uint64_t txns_tried = 0;
@@ -87,6 +100,10 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             file >> TX_WITH_WITNESS(tx);
             file >> nTime;
             file >> nFeeDelta;
+            uint8_t witness_bits{0};
+            if (has_witness) {
+                file >> witness_bits;
+            }
 
             if (opts.use_current_time) {
                 nTime = TicksSinceEpoch<std::chrono::seconds>(now);
@@ -98,9 +115,22 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             }
             if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
                 LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
+                // The stored script results only hold as long as the saved tip
+                // was not reorged away and the flags are unchanged. All other
+                // checks, the contract checks included, run again.
+                MempoolRestoreWitness witness;
+                if (has_witness && opts.use_restore_witness) {
+                    const CBlockIndex* saved_tip{active_chainstate.m_blockman.LookupBlockIndex(witness_tip)};
+                    if (saved_tip && active_chainstate.m_chain.Contains(saved_tip)) {
+                        witness.scripts_verified = (witness_bits & WITNESS_SCRIPTS_VERIFIED) &&
+                                                   GetMempoolScriptFlags(active_chainstate) == witness_script_flags;
+                    }
+                }
+                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false,
+                                                          witness.scripts_verified ? &witness : nullptr);
                 if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
                     ++count;
+                    if (witness.scripts_verified) ++witnessed;
                 } else {
                     // mempool may contain the transaction already, e.g. from
                     // wallet(s) having loaded it while we were processing
@@ -142,28 +172,43 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         return false;
     }
 
-    LogInfo("Imported mempool transactions from file: %i succeeded, %i failed, %i expired, %i already there, %i waiting for initial broadcast\n", count, failed, expired, already_there, unbroadcast);
+    LogInfo("Imported mempool transactions from file: %i succeeded (%i without script re-verification), %i failed, %i expired, %i already there, %i waiting for initial broadcast\n", count, witnessed, failed, expired, already_there, unbroadcast);
     return true;
 }
 
-bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mockable_fopen_function, bool skip_file_commit)
+bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mockable_fopen_function, bool skip_file_commit, const Chainstate* chainstate)
 {
     auto start = SteadyClock::now();
 
     std::map<uint256, CAmount> mapDeltas;
     std::vector<TxMempoolInfo> vinfo;
     std::set<uint256> unbroadcast_txids;
+    bool with_witness{false};
+    uint256 witness_tip;
+    uint64_t witness_script_flags{0};
 
     static Mutex dump_mutex;
     LOCK(dump_mutex);
 
-    {
-        LOCK(pool.cs);
+    const auto copy_pool = [&]() EXCLUSIVE_LOCKS_REQUIRED(pool.cs) {
         for (const auto &i : pool.mapDeltas) {
             mapDeltas[i.first] = i.second;
         }
         vinfo = pool.infoAll();
         unbroadcast_txids = pool.GetUnbroadcastTxs();
+    };
+    if (chainstate && pool.m_opts.persist_witness && !pool.m_opts.persist_v1_dat) {
+        // Hold cs_main so that the pool contents match the tip they were validated against
+        LOCK2(::cs_main, pool.cs);
+        if (const CBlockIndex* tip{chainstate->m_chain.Tip()}) {
+            with_witness = true;
+            witness_tip = tip->GetBlockHash();
+            witness_script_flags = GetMempoolScriptFlags(*chainstate);
+        }
+        copy_pool();
+    } else {
+        LOCK(pool.cs);
+        copy_pool();
     }
 
     auto mid = SteadyClock::now();
@@ -174,7 +219,9 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
     }
 
     try {
-        const uint64_t version{pool.m_opts.persist_v1_dat ? MEMPOOL_DUMP_VERSION_NO_XOR_KEY : MEMPOOL_DUMP_VERSION};
+        const uint64_t version{pool.m_opts.persist_v1_dat ? MEMPOOL_DUMP_VERSION_NO_XOR_KEY :
+                               with_witness                ? MEMPOOL_DUMP_VERSION_WITNESS :
+                                                             MEMPOOL_DUMP_VERSION};
         file << version;
 
         std::vector<std::byte> xor_key(8);
@@ -183,6 +230,10 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
             file << xor_key;
         }
         file.SetXor(xor_key);
+        if (with_witness) {
+            file << witness_tip;
+            file << witness_script_flags;
+        }
 
         uint64_t mempool_transactions_to_write(vinfo.size());
         file << mempool_transactions_to_write;
@@ -191,6 +242,11 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
             file << TX_WITH_WITNESS(*(i.tx));
             file << int64_t{count_seconds(i.m_time)};
             file << int64_t{i.nFeeDelta};
+            if (with_witness) {
+                // Everything in the pool passed the script checks at this tip
+                const uint8_t witness_bits{WITNESS_SCRIPTS_VERIFIED};
+                file << witness_bits;
+            }
             mapDeltas.erase(i.tx->GetHash());
         }
 
@@ -12,16 +12,27 @@ class CTxMemPool;
 
 namespace node {
 
-/** Dump the mempool to a file. */
+/**
+ * Dump the mempool to a file. When a chainstate is given, the validation
+ * results of the transactions at its tip are stored along with them (unless
+ * disabled by the pool options), so LoadMempool() can skip re-verifying them.
+ */
 bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path,
                  fsbridge::FopenFn mockable_fopen_function = fsbridge::fopen,
-                 bool skip_file_commit = false);
+                 bool skip_file_commit = false,
+                 const Chainstate* chainstate = nullptr);
 
 struct ImportMempoolOptions {
     fsbridge::FopenFn mockable_fopen_function{fsbridge::fopen};
     bool use_current_time{false};
     bool apply_fee_delta_priority{true};
     bool apply_unbroadcast_set{true};
+    /**
+     * Reuse stored validation results that still apply at the active chain tip.
+     * A crafted file can make invalid transactions skip their checks, so this
+     * is only for files written by this node.
+     */
+    bool use_restore_witness{false};
 };
 /** Import the file and attempt to add its contents to the mempool. */
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path,
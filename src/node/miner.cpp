@@ -17,6 +17,7 @@
 #include <consensus/validation.h>
 #include <deploymentstatus.h>
 #include <logging.h>
+#include <node/cache_warmup.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <pow.h>
@@ -29,6 +30,7 @@
 #include <key_io.h>
 #include <qtum/qtumledger.h>
 #include <qtum/qtumdelegation.h>
+#include <trust/heartbeat_net.h>
 #ifdef ENABLE_WALLET
 #include <wallet/wallet.h>
 #include <wallet/receive.h>
@@ -114,6 +116,45 @@ void RegenerateCommitments(CBlock& block, ChainstateManager& chainman)
     block.hashMerkleRoot = BlockMerkleRoot(block);
 }
 
+bool FillCoinStake(CBlock& block, const COutPoint& kernel, const CTxOut& kernel_out, const CAmount& nTotalFees, const CBlockIndex* pindexPrev, ChainstateManager& chainman)
+{
+    AssertLockHeld(::cs_main);
+    if (block.vtx.size() < 2 || !CheckFirstCoinstakeOutput(block))
+        return false;
+
+    const Consensus::Params& consensusParams = chainman.GetConsensus();
+    CAmount nStakerReward;
+    int64_t nRewardPiece;
+    if (!GetCoinStakeReward(pindexPrev->nHeight + 1, nTotalFees, consensusParams, nStakerReward, nRewardPiece))
+        return false;
+
+    const CTransaction& tx = *block.vtx[1];
+    CMutableTransaction txNew(tx);
+    txNew.vin.assign(1, CTxIn(kernel));
+    txNew.vout.clear();
+    txNew.vout.push_back(tx.vout[0]);
+    txNew.vout.push_back(CTxOut(kernel_out.nValue + nStakerReward, tx.vout[1].scriptPubKey));
+
+    if(pindexPrev->nHeight >= consensusParams.nFirstMPoSBlock && pindexPrev->nHeight < consensusParams.nLastMPoSBlock)
+    {
+        if(!CreateMPoSOutputs(txNew, nRewardPiece, pindexPrev->nHeight, consensusParams, chainman.ActiveChain(), chainman.m_blockman)) {
+            LogError("FillCoinStake : failed to create MPoS reward outputs");
+            return false;
+        }
+    }
+
+    // Append the Refunds To Sender to the transaction outputs
+    for(unsigned int i = 2; i < tx.vout.size(); i++)
+    {
+        txNew.vout.push_back(tx.vout[i]);
+    }
+
+    block.vtx[1] = MakeTransactionRef(std::move(txNew));
+    block.prevoutStake = kernel;
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    return true;
+}
+
 static BlockAssembler::Options ClampOptions(BlockAssembler::Options options)
 {
     Assert(options.block_reserved_weight <= (dgpMaxBlockWeight - 4000));
@@ -170,6 +211,7 @@ void BlockAssembler::resetBlock()
     // These counters do not include coinbase tx
     nBlockTx = 0;
     nFees = 0;
+    mposClaims.clear();
 }
 
 void BlockAssembler::RebuildRefundTransaction(CBlock* pblock){
@@ -251,6 +293,21 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(bool fProofOfStak
     {
         // Make the coinbase tx empty in case of proof of stake
         coinbaseTx.vout[0].SetEmpty();
+
+        // Commit the heartbeats observed for the current heartbeat window
+        const Consensus::Params& consensusParams = chainparams.GetConsensus();
+        const int windowHeight = trust::GetHeartbeatWindow(nHeight - 1, consensusParams);
+        if (nHeight >= consensusParams.nHeartbeatAggregateHeight && trust::g_heartbeat_manager &&
+            nHeight - windowHeight <= consensusParams.nHeartbeatInclusionWindow) {
+            trust::HeartbeatAggregate aggregate{trust::g_heartbeat_manager->GetAggregate(windowHeight, pindexPrev->GetAncestor(windowHeight)->GetBlockHash())};
+            CTxOut aggregateOut{0, trust::GetHeartbeatAggregateScript(aggregate)};
+            const uint64_t aggregateWeight = WITNESS_SCALE_FACTOR * ::GetSerializeSize(aggregateOut);
+            if (!aggregate.signatures.empty() && nBlockWeight + aggregateWeight < m_options.nBlockMaxWeight) {
+                // Not covered by the weight reserved for the coinbase
+                nBlockWeight += aggregateWeight;
+                coinbaseTx.vout.push_back(aggregateOut);
+            }
+        }
     }
     else
     {
@@ -282,6 +339,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(bool fProofOfStak
     globalSealEngine->setQtumSchedule(qtumDGP.getGasSchedule(nHeight));
     uint32_t blockSizeDGP = qtumDGP.getBlockSize(nHeight);
     minGasPrice = qtumDGP.getMinGasPrice(nHeight);
+    dgpMinGasPrice = minGasPrice;
     if(gArgs.IsArgSet("-staker-min-tx-gas-price")) {
         std::optional<CAmount> stakerMinGasPrice = ParseMoney(gArgs.GetArg("-staker-min-tx-gas-price", ""));
         minGasPrice = std::max(minGasPrice, (uint64_t)(stakerMinGasPrice.value_or(0)));
@@ -489,7 +547,22 @@ bool BlockAssembler::TestPackageTransactions(const CTxMemPool::setEntries& packa
     return true;
 }
 
-bool BlockAssembler::AttemptToAddContractToBlock(CTxMemPool::txiter iter, uint64_t minGasPrice, CBlock* pblock) {
+// A claim in the mempool can exceed the balance left after a block from another
+// node paid out a claim of the same key
+bool BlockAssembler::TestMPoSClaim(const uint160& keyid, CAmount nClaimed) const
+{
+    CAmount balance = 0;
+    if (!m_chainstate.m_blockman.m_block_tree_db->ReadMPoSBalance(keyid, balance)) {
+        return false;
+    }
+    auto it = mposClaims.find(keyid);
+    if (it != mposClaims.end()) {
+        balance -= it->second;
+    }
+    return nClaimed <= balance;
+}
+
+bool BlockAssembler::AttemptToAddContractToBlock(CTxMemPool::txiter iter, uint64_t minGasPrice, CAmount packageGasPrice, CBlock* pblock) {
     if (nTimeLimit != 0 && TicksSinceEpoch<std::chrono::seconds>(NodeClock::now()) >= nTimeLimit - nBytecodeTimeBuffer) {
         return false;
     }
@@ -532,8 +605,13 @@ bool BlockAssembler::AttemptToAddContractToBlock(CTxMemPool::txiter iter, uint64
                 LogPrintf("AttemptToAddContractToBlock(): The gas needed is bigger than -staker-soft-block-gas-limit for the contract tx %s\n", iter->GetTx().GetHash().ToString());
             return false;
         }
-        if(qtumTransaction.gasPrice() < minGasPrice){
+        if(qtumTransaction.gasPrice() < dgpMinGasPrice){
             //if this transaction's gasPrice is less than the current DGP minGasPrice don't add it
+            LogPrintf("AttemptToAddContractToBlock(): The gas price is less than the DGP minimum gas price for the contract tx %s\n", iter->GetTx().GetHash().ToString());
+            return false;
+        }
+        if(std::max(iter->GetMinGasPrice(), packageGasPrice) < (CAmount)minGasPrice){
+            //the fees of the package it is added with can make up for a gas price below -staker-min-tx-gas-price
             LogPrintf("AttemptToAddContractToBlock(): The gas price is less than -staker-min-tx-gas-price for the contract tx %s\n", iter->GetTx().GetHash().ToString());
             return false;
         }
@@ -836,6 +914,14 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
         std::vector<CTxMemPool::txiter> sortedEntries;
         SortForBlock(ancestors, sortedEntries);
 
+        // Gas price of the package as a whole, which a contract tx in it may
+        // fall short of when the rest of the package pays for it
+        uint64_t packageGas = 0;
+        for (CTxMemPool::txiter entry : sortedEntries) {
+            packageGas += entry->GetGasLimit();
+        }
+        const CAmount packageGasPrice = packageGas ? packageFees / CAmount(packageGas) : 0;
+
         bool wasAdded=true;
         for (size_t i = 0; i < sortedEntries.size(); ++i) {
             if(!wasAdded || (nTimeLimit != 0 && TicksSinceEpoch<std::chrono::seconds>(NodeClock::now()) >= nTimeLimit))
@@ -847,18 +933,25 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
             }
             const CTransaction& tx = sortedEntries[i]->GetTx();
             if(wasAdded) {
-                if (tx.HasCreateOrCall()) {
-                    wasAdded = AttemptToAddContractToBlock(sortedEntries[i], minGasPrice, pblock);
-                    if(!wasAdded){
-                        if(fUsingModified) {
-                            //this only needs to be done once to mark the whole package (everything in sortedEntries) as failed
-                            mapModifiedTx.get<ancestor_score_or_gas_price>().erase(modit);
-                            failedTx.insert(iter->GetSharedTx()->GetHash());
-                        }
-                    }
+                uint160 claimKey;
+                CAmount nClaimed = 0;
+                const bool fClaim = nHeight >= chainparams.GetConsensus().nMPoSBalanceHeight && GetMPoSClaim(tx, claimKey, nClaimed);
+                if (fClaim && !TestMPoSClaim(claimKey, nClaimed)) {
+                    wasAdded = false;
+                } else if (tx.HasCreateOrCall()) {
+                    wasAdded = AttemptToAddContractToBlock(sortedEntries[i], minGasPrice, packageGasPrice, pblock);
                 } else {
                     AddToBlock(sortedEntries[i]);
                 }
+                if(!wasAdded){
+                    if(fUsingModified) {
+                        //this only needs to be done once to mark the whole package (everything in sortedEntries) as failed
+                        mapModifiedTx.get<ancestor_score_or_gas_price>().erase(modit);
+                        failedTx.insert(iter->GetSharedTx()->GetHash());
+                    }
+                } else if (fClaim) {
+                    mposClaims[claimKey] += nClaimed;
+                }
             }
             // Erase from the modified set, if present
             mapModifiedTx.erase(sortedEntries[i]);
@@ -1659,9 +1752,9 @@ protected:
 
     bool IsReady()
     {
-        // Check if wallet is ready
+        // Check if wallet is ready, and the caches warm after a restart
         while (d->pwallet->IsLocked() || !d->pwallet->m_enabled_staking || 
-               d->pwallet->chain().chainman().m_blockman.LoadingBlocks())
+               d->pwallet->chain().chainman().m_blockman.LoadingBlocks() || IsCacheWarmupActive())
         {
             d->pwallet->m_last_coin_stake_search_interval = 0;
             if(!Sleep(10000))
@@ -13,6 +13,7 @@
 #include <util/feefrac.h>
 #include <validation.h>
 
+#include <map>
 #include <memory>
 #include <optional>
 #include <stdint.h>
@@ -97,6 +98,7 @@ struct CTxMemPoolModifiedEntry {
         nSizeWithAncestors = entry->GetSizeWithAncestors();
         nModFeesWithAncestors = entry->GetModFeesWithAncestors();
         nSigOpCostWithAncestors = entry->GetSigOpCostWithAncestors();
+        nGasWithAncestors = entry->GetGasWithAncestors();
     }
 
     CAmount GetModifiedFee() const { return iter->GetModifiedFee(); }
@@ -104,11 +106,17 @@ struct CTxMemPoolModifiedEntry {
     CAmount GetModFeesWithAncestors() const { return nModFeesWithAncestors; }
     size_t GetTxSize() const { return iter->GetTxSize(); }
     const CTransaction& GetTx() const { return iter->GetTx(); }
+    CAmount GetPackageGasPrice() const
+    {
+        if (nGasWithAncestors == iter->GetGasLimit()) return iter->GetMinGasPrice();
+        return nModFeesWithAncestors / CAmount(nGasWithAncestors);
+    }
 
     CTxMemPool::txiter iter;
     uint64_t nSizeWithAncestors;
     CAmount nModFeesWithAncestors;
     int64_t nSigOpCostWithAncestors;
+    uint64_t nGasWithAncestors;
 };
 
 /** Comparator for CTxMemPool::txiter objects.
@@ -170,9 +178,10 @@ struct CompareModifiedEntry {
             // Otherwise, prioritize the contract tx with the highest (minimum among its outputs) gas price
             // The reason for using the gas price of the output that sets the minimum gas price is that
             // otherwise it may be possible to game the prioritization by setting a large gas price in one output
-            // that does no execution, while the real execution has a very low gas price
-            if(a.iter->GetMinGasPrice() != b.iter->GetMinGasPrice()) {
-                return a.iter->GetMinGasPrice() > b.iter->GetMinGasPrice();
+            // that does no execution, while the real execution has a very low gas price.
+            // The fees of the ancestors not yet in the block count towards it, so a child can pay for a contract parent.
+            if(a.GetPackageGasPrice() != b.GetPackageGasPrice()) {
+                return a.GetPackageGasPrice() > b.GetPackageGasPrice();
             }
 
             // Otherwise, prioritize the tx with the min size
@@ -236,6 +245,7 @@ struct update_for_parent_inclusion
         e.nModFeesWithAncestors -= iter->GetModifiedFee();
         e.nSizeWithAncestors -= iter->GetTxSize();
         e.nSigOpCostWithAncestors -= iter->GetSigOpCost();
+        e.nGasWithAncestors -= iter->GetGasLimit();
     }
 
     CTxMemPool::txiter iter;
@@ -254,6 +264,8 @@ private:
     uint64_t nBlockSigOpsCost;
     CAmount nFees;
     std::unordered_set<Txid, SaltedTxidHasher> inBlock;
+    //! MPoS balances claimed by the transactions in the block, by key hash
+    std::map<uint160, CAmount> mposClaims;
 
     // Chain context for the block
     int nHeight;
@@ -284,6 +296,8 @@ public:
 ///////////////////////////////////////////// // qtum
     ByteCodeExecResult bceResult;
     uint64_t minGasPrice = 1;
+    //! Minimum gas price of the DGP, which minGasPrice can raise with -staker-min-tx-gas-price
+    uint64_t dgpMinGasPrice = 1;
     uint64_t hardBlockGasLimit;
     uint64_t softBlockGasLimit;
     uint64_t txGasLimit;
@@ -313,7 +327,7 @@ private:
     /** Add a tx to the block */
     void AddToBlock(CTxMemPool::txiter iter);
 
-    bool AttemptToAddContractToBlock(CTxMemPool::txiter iter, uint64_t minGasPrice, CBlock* pblock);
+    bool AttemptToAddContractToBlock(CTxMemPool::txiter iter, uint64_t minGasPrice, CAmount packageGasPrice, CBlock* pblock);
 
     // Methods for how to add transactions to a block.
     /** Add transactions based on feerate including unconfirmed ancestors
@@ -336,6 +350,8 @@ private:
       * These checks should always succeed, and they're here
       * only as an extra check in case of suboptimal node configuration */
     bool TestPackageTransactions(const CTxMemPool::setEntries& package) const;
+    /** Test if the MPoS balance of a key covers a claim on top of the claims already in the block */
+    bool TestMPoSClaim(const uint160& keyid, CAmount nClaimed) const;
     /** Sort the package in an order that is valid to appear in a block */
     void SortForBlock(const CTxMemPool::setEntries& package, std::vector<CTxMemPool::txiter>& sortedEntries);
 };
@@ -358,6 +374,14 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 /** Update an old GenerateCoinbaseCommitment from CreateNewBlock after the block txs have changed */
 void RegenerateCommitments(CBlock& block, ChainstateManager& chainman);
 
+/**
+ * Fill the coinstake of a proof-of-stake block template for a kernel found
+ * outside the wallet: spend the kernel and pay the stake and reward to the
+ * script of the template's coinstake output, keeping the refund outputs.
+ * The coinstake input is left unsigned.
+ */
+bool FillCoinStake(CBlock& block, const COutPoint& kernel, const CTxOut& kernel_out, const CAmount& nTotalFees, const CBlockIndex* pindexPrev, ChainstateManager& chainman) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
 /** Apply -blockmintxfee and -blockmaxweight options from ArgsManager to BlockAssembler options. */
 void ApplyArgsManOptions(const ArgsManager& gArgs, BlockAssembler::Options& options);
 
@@ -0,0 +1,157 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/staker.h>
+
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <interfaces/mining.h>
+#include <logging.h>
+#include <pos.h>
+#include <script/sign.h>
+#include <script/solver.h>
+#include <util/signalinterrupt.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace node {
+
+Staker::Staker(interfaces::Mining& mining, const std::vector<CKey>& keys)
+    : m_mining(mining)
+{
+    for (const CKey& key : keys) {
+        const CPubKey pubkey{key.GetPubKey()};
+        m_keystore.AddKeyPubKey(key, pubkey);
+        // The only kernel types the coinstake rules accept
+        m_scripts.push_back(GetScriptForRawPubKey(pubkey));
+        m_scripts.push_back(GetScriptForDestination(PKHash(pubkey)));
+    }
+}
+
+bool Staker::Update()
+{
+    std::optional<StakeTarget> target{m_mining.getStakeTarget()};
+    if (!target) return false;
+    if (!m_target || m_target->prev_hash != target->prev_hash) {
+        m_last_searched = 0;
+        StakeCoinsUpdate update{m_mining.getStakeCoins(m_scripts, m_coins_tip)};
+        // On failure, keep the coins and try again on the next tip
+        if (!update.tip.IsNull()) {
+            if (update.full) m_coins.clear();
+            const std::set<COutPoint> spent(update.spent.begin(), update.spent.end());
+            std::erase_if(m_coins, [&](const StakeCoin& coin) { return spent.count(coin.prevout) > 0; });
+            m_coins.insert(m_coins.end(), update.coins.begin(), update.coins.end());
+            m_coins_tip = update.tip;
+            LogDebug(BCLog::COINSTAKE, "Staker: %u coins at block %s\n", m_coins.size(), m_coins_tip.ToString());
+        }
+    }
+    m_target = std::move(target);
+    return true;
+}
+
+/** Get the public key the coinstake must pay back to for a kernel */
+static bool GetStakePubKey(const SigningProvider& provider, const CScript& script, CPubKey& pubkey)
+{
+    std::vector<std::vector<unsigned char>> solutions;
+    switch (Solver(script, solutions)) {
+    case TxoutType::PUBKEY:
+        pubkey = CPubKey(solutions[0]);
+        return true;
+    case TxoutType::PUBKEYHASH:
+        return provider.GetPubKey(CKeyID(uint160(solutions[0])), pubkey);
+    default:
+        return false;
+    }
+}
+
+std::optional<CBlock> Staker::Search(int64_t now)
+{
+    if (!m_target) return std::nullopt;
+    const StakeTarget& target{*m_target};
+    const int64_t mask{target.timestamp_mask};
+    // Only search whole slots that have not been searched on this tip yet
+    const int64_t first{(std::max(target.min_time, m_last_searched + 1) + mask) & ~mask};
+    const int64_t last{now & ~mask};
+
+    for (int64_t time = first; time <= last; time += mask + 1) {
+        for (auto it = m_coins.begin(); it != m_coins.end();) {
+            uint256 hash_proof, target_proof;
+            if (it->height > target.max_coin_height || int64_t{it->block_from_time} > time ||
+                !CheckStakeKernelHash(target.stake_modifier, target.height, target.bits, it->block_from_time, it->out.nValue,
+                                      it->prevout, time, hash_proof, target_proof)) {
+                ++it;
+                continue;
+            }
+
+            LogDebug(BCLog::COINSTAKE, "Staker: kernel found %s at %d\n", it->prevout.ToString(), time);
+            CPubKey pubkey;
+            if (!GetStakePubKey(m_keystore, it->out.scriptPubKey, pubkey)) {
+                it = m_coins.erase(it);
+                continue;
+            }
+            BlockCreateOptions options;
+            options.coinbase_output_script = GetScriptForRawPubKey(pubkey);
+            std::unique_ptr<interfaces::BlockTemplate> block_template{m_mining.createNewStakeBlock(options, target.prev_hash, it->prevout, time)};
+            if (!block_template) {
+                // Either the tip moved on, in which case the caller updates,
+                // or the node does not consider the coin stakeable on this
+                // tip. Spent coins are dropped by the next update.
+                std::optional<StakeTarget> current{m_mining.getStakeTarget()};
+                if (current && current->prev_hash != target.prev_hash) return std::nullopt;
+                ++it;
+                continue;
+            }
+
+            CBlock block{block_template->getBlock()};
+            if (!SignBlock(block, *it)) {
+                LogPrintf("Staker: failed to sign block for kernel %s\n", it->prevout.ToString());
+                ++it;
+                continue;
+            }
+            m_last_searched = time;
+            return block;
+        }
+    }
+    m_last_searched = std::max(m_last_searched, last);
+    return std::nullopt;
+}
+
+bool Staker::SignBlock(CBlock& block, const StakeCoin& coin) const
+{
+    if (block.vtx.size() < 2 || block.vtx[1]->vin.size() != 1) return false;
+    CMutableTransaction coinstake{*block.vtx[1]};
+    if (!SignTransactionStake(coinstake, &m_keystore, {{coin.out, 0}})) return false;
+    block.vtx[1] = MakeTransactionRef(std::move(coinstake));
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+
+    CPubKey pubkey;
+    CKey key;
+    if (!GetStakePubKey(m_keystore, coin.out.scriptPubKey, pubkey) || !m_keystore.GetKey(pubkey.GetID(), key)) return false;
+    const bool compact{m_target && m_target->height >= Params().GetConsensus().nOfflineStakeHeight};
+    return SignBlockStake(block, key, compact);
+}
+
+void Staker::Run(const util::SignalInterrupt& interrupt, std::chrono::milliseconds interval)
+{
+    while (!interrupt) {
+        if (Update()) {
+            std::optional<CBlock> block{Search(TicksSinceEpoch<std::chrono::seconds>(NodeClock::now()))};
+            if (block) {
+                if (m_mining.submitStakeBlock(*block)) {
+                    LogPrintf("Staker: new proof-of-stake block found %s\n", block->GetHash().ToString());
+                    std::erase_if(m_coins, [&](const StakeCoin& coin) { return coin.prevout == block->prevoutStake; });
+                } else {
+                    LogPrintf("Staker: block %s was rejected\n", block->GetHash().ToString());
+                }
+                continue;
+            }
+        }
+        m_mining.waitTipChanged(m_target ? m_target->prev_hash : uint256{}, interval);
+    }
+}
+
+} // namespace node
@@ -0,0 +1,80 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_STAKER_H
+#define BITCOIN_NODE_STAKER_H
+
+#include <key.h>
+#include <node/types.h>
+#include <primitives/block.h>
+#include <script/signingprovider.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace interfaces {
+class Mining;
+} // namespace interfaces
+
+namespace util {
+class SignalInterrupt;
+} // namespace util
+
+namespace node {
+
+/**
+ * Proof-of-stake block producer that only talks to the node through
+ * interfaces::Mining.
+ *
+ * The kernel search runs against a local cache of the staker's coins, kept
+ * up to date with the blocks connected, and takes no node lock. The node is only called to refresh the target, to
+ * assemble the block once a kernel is found and to validate the signed
+ * result.
+ */
+class Staker
+{
+public:
+    Staker(interfaces::Mining& mining, const std::vector<CKey>& keys);
+
+    /**
+     * Refresh the target and, when the tip changed, the stake cache
+     *
+     * @returns false if the node has no tip yet
+     */
+    bool Update();
+
+    /**
+     * Search the stake cache for a kernel in the time slots up to now, and
+     * build and sign a block for the first one found
+     */
+    std::optional<CBlock> Search(int64_t now);
+
+    /**
+     * Stake until interrupted, waking up on every new tip and at least once
+     * per interval
+     */
+    void Run(const util::SignalInterrupt& interrupt, std::chrono::milliseconds interval = std::chrono::seconds{1});
+
+    size_t CacheSize() const { return m_coins.size(); }
+
+private:
+    bool SignBlock(CBlock& block, const StakeCoin& coin) const;
+
+    interfaces::Mining& m_mining;
+    FillableSigningProvider m_keystore;
+    std::vector<CScript> m_scripts;
+
+    std::optional<StakeTarget> m_target;
+    //! Coins as of m_coins_tip
+    std::vector<StakeCoin> m_coins;
+    uint256 m_coins_tip;
+    //! Last block time searched on the current tip
+    int64_t m_last_searched{0};
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_STAKER_H
@@ -0,0 +1,56 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/stakeseen.h>
+
+#include <chain.h>
+#include <consensus/params.h>
+#include <memusage.h>
+
+#include <algorithm>
+
+namespace node {
+
+int GetStakeSeenCutoff(int height, const Consensus::Params& params)
+{
+    return std::max(0, height - params.CheckpointSpan(height) - CBlockIndex::nMedianTimeSpan);
+}
+
+void StakeSeenCache::Insert(const COutPoint& prevout, uint32_t time, int height)
+{
+    if (height < m_min_height) return;
+    auto [it, inserted] = m_entries.try_emplace(Key{prevout, time}, height);
+    if (!inserted) {
+        it->second = std::max(it->second, height);
+    }
+    SetMinHeight(m_min_height);
+}
+
+bool StakeSeenCache::Contains(const COutPoint& prevout, uint32_t time) const
+{
+    return m_entries.count(Key{prevout, time}) > 0;
+}
+
+void StakeSeenCache::SetMinHeight(int min_height)
+{
+    m_min_height = std::max(m_min_height, min_height);
+    if (m_entries.size() < m_next_scan) return;
+    // Scanning only once the cache doubled keeps the cost per insert constant
+    std::erase_if(m_entries, [&](const auto& entry) { return entry.second < m_min_height; });
+    m_next_scan = std::max(MIN_SCAN_SIZE, 2 * m_entries.size());
+}
+
+void StakeSeenCache::Clear()
+{
+    m_entries.clear();
+    m_min_height = 0;
+    m_next_scan = MIN_SCAN_SIZE;
+}
+
+size_t StakeSeenCache::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(m_entries);
+}
+
+} // namespace node
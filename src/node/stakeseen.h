@@ -0,0 +1,93 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_STAKESEEN_H
+#define BITCOIN_NODE_STAKESEEN_H
+
+#include <primitives/transaction.h>
+#include <util/hasher.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Consensus {
+struct Params;
+} // namespace Consensus
+
+namespace node {
+
+/**
+ * Get the lowest block height whose stake still needs to be remembered when
+ * the active tip is at the given height.
+ *
+ * Headers that fork below the sync checkpoint are rejected before the
+ * duplicate stake check, and the timestamp of any other header is above the
+ * median time past of an ancestor at or after the checkpoint. A stake used
+ * more than nMedianTimeSpan blocks below the checkpoint can therefore not be
+ * reused with the same timestamp by a header that would be accepted.
+ */
+int GetStakeSeenCutoff(int height, const Consensus::Params& params);
+
+/**
+ * The (prevout, time) pairs of the proof-of-stake blocks in the block index,
+ * used to reject headers that reuse a stake at the same time.
+ *
+ * Only blocks at or above a minimum height are kept. The minimum is raised
+ * as the tip advances and older entries are dropped in amortized full scans,
+ * so the cache holds roughly a checkpoint span of blocks plus the competing
+ * headers seen within it instead of every stake since genesis.
+ *
+ * Not thread safe; the global instance is guarded by cs_main.
+ */
+class StakeSeenCache
+{
+public:
+    /** Remember the stake of a proof-of-stake block at the given height */
+    void Insert(const COutPoint& prevout, uint32_t time, int height);
+
+    /** Whether the stake was used at that time by a remembered block */
+    bool Contains(const COutPoint& prevout, uint32_t time) const;
+
+    /** Raise the minimum height, forgetting the stakes of lower blocks */
+    void SetMinHeight(int min_height);
+
+    int GetMinHeight() const { return m_min_height; }
+
+    void Clear();
+
+    size_t Size() const { return m_entries.size(); }
+
+    size_t DynamicMemoryUsage() const;
+
+private:
+    struct Key {
+        COutPoint prevout;
+        uint32_t time;
+
+        friend bool operator==(const Key& a, const Key& b) { return a.prevout == b.prevout && a.time == b.time; }
+    };
+
+    struct KeyHasher {
+        SaltedOutpointHasher m_hasher;
+
+        size_t operator()(const Key& key) const noexcept
+        {
+            return m_hasher(key.prevout) ^ (uint64_t{key.time} * 0x9e3779b97f4a7c15ULL);
+        }
+    };
+
+    //! Smallest size at which a scan for expired entries is attempted
+    static constexpr size_t MIN_SCAN_SIZE{1024};
+
+    //! Height of the block that used each stake
+    std::unordered_map<Key, int, KeyHasher> m_entries;
+    int m_min_height{0};
+    //! Size at which the next scan for expired entries happens
+    size_t m_next_scan{MIN_SCAN_SIZE};
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_STAKESEEN_H
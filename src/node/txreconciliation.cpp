@@ -5,10 +5,18 @@
 #include <node/txreconciliation.h>
 
 #include <common/system.h>
+#include <crypto/siphash.h>
 #include <logging.h>
+#include <node/minisketchwrapper.h>
 #include <util/check.h>
+#include <util/hasher.h>
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 
@@ -29,6 +37,40 @@ uint256 ComputeSalt(uint64_t salt1, uint64_t salt2)
     return (HashWriter(RECON_SALT_HASHER) << std::min(salt1, salt2) << std::max(salt1, salt2)).GetSHA256();
 }
 
+/**
+ * Coefficient used to estimate the set difference from the sizes of the sets, as the expected
+ * fraction of the smaller set missing on the other side, see BIP-330.
+ */
+constexpr double RECON_Q{0.25};
+/** Precision of the q coefficient as sent in REQRECON. */
+constexpr uint16_t Q_PRECISION{(2 << 14) - 1};
+/** Sketches are made large enough that a failure to decode is noticed with probability 1-2^-16. */
+constexpr uint32_t RECON_FALSE_POSITIVE_COEF{16};
+/** Number of outbound peers each transaction is flooded to, see IsFanoutTarget. */
+constexpr size_t OUTBOUND_FANOUT_DESTINATIONS{1};
+/** Fraction of the inbound peers each transaction is flooded to, see IsFanoutTarget. */
+constexpr double INBOUND_FANOUT_DESTINATIONS_FRACTION{0.1};
+/**
+ * Number of transactions whose fanout targets are remembered. A transaction is announced to all
+ * peers within a few trickle intervals, so this only needs to cover the transactions of those.
+ */
+constexpr size_t MAX_FANOUT_TARGETS_CACHE{10000};
+
+/** Step of a reconciliation with a peer, from our side. */
+enum class ReconciliationPhase {
+    NONE,
+    /** Initiator: REQRECON sent, waiting for the sketch */
+    INIT_REQUESTED,
+    /** Initiator: REQSKETCHEXT sent, waiting for the extension */
+    EXT_REQUESTED,
+    /** Responder: REQRECON received, the sketch is due */
+    INIT_PENDING,
+    /** Responder: the sketch was sent, waiting for REQSKETCHEXT or RECONCILDIFF */
+    INIT_RESPONDED,
+    /** Responder: the extension was sent, waiting for RECONCILDIFF */
+    EXT_RESPONDED,
+};
+
 /**
  * Keeps track of txreconciliation-related per-peer state.
  */
@@ -36,9 +78,6 @@ class TxReconciliationState
 {
 public:
     /**
-     * TODO: This field is public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * Reconciliation protocol assumes using one role consistently: either a reconciliation
      * initiator (requesting sketches), or responder (sending sketches). This defines our role,
      * based on the direction of the p2p connection.
@@ -47,14 +86,81 @@ public:
     bool m_we_initiate;
 
     /**
-     * TODO: These fields are public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * These values are used to salt short IDs, which is necessary for transaction reconciliations.
      */
     uint64_t m_k0, m_k1;
 
+    /** Transactions to announce to the peer at the next reconciliation. */
+    std::unordered_set<Wtxid, SaltedTxidHasher> m_local_set;
+
+    /**
+     * The set of the ongoing reconciliation. It is moved aside when the sketch is computed, so
+     * the extension and the difference refer to the same transactions while new ones go to
+     * m_local_set.
+     */
+    std::vector<Wtxid> m_local_set_snapshot;
+
+    ReconciliationPhase m_phase{ReconciliationPhase::NONE};
+
+    /** Initiator: when to send the next REQRECON. */
+    std::chrono::microseconds m_next_recon_request{0};
+
+    /** Initiator: when the ongoing reconciliation times out. */
+    std::chrono::microseconds m_recon_timeout{0};
+
+    /** Initiator: whether the peer owes a sketch of a reconciliation that timed out. */
+    bool m_late_sketch{false};
+
+    /** Initiator: the initial sketch of the peer, kept to be extended. */
+    std::vector<uint8_t> m_remote_sketch;
+
+    /** Responder: the set size and q coefficient the peer sent in REQRECON. */
+    uint16_t m_remote_set_size{0};
+    uint16_t m_remote_q{0};
+
+    /** Responder: capacity of the sketch we sent. */
+    uint32_t m_sketch_capacity{0};
+
     TxReconciliationState(bool we_initiate, uint64_t k0, uint64_t k1) : m_we_initiate(we_initiate), m_k0(k0), m_k1(k1) {}
+
+    /** Short ID of a transaction as defined by BIP-330: 1 + (SipHash(wtxid) mod 2^32-1). */
+    uint32_t ComputeShortID(const Wtxid& wtxid) const
+    {
+        const uint64_t s{SipHashUint256(m_k0, m_k1, wtxid.ToUint256())};
+        return 1 + uint32_t(s % 0xFFFFFFFF);
+    }
+
+    /** Sketch of the short IDs of the snapshot. */
+    Minisketch ComputeSketch(uint32_t capacity) const
+    {
+        Minisketch sketch{node::MakeMinisketch32(capacity)};
+        for (const Wtxid& wtxid : m_local_set_snapshot) {
+            sketch.Add(ComputeShortID(wtxid));
+        }
+        return sketch;
+    }
+
+    /**
+     * Responder: capacity of the sketch for a set difference estimated from the set sizes,
+     * |local - remote| + q * min(local, remote) + 1.
+     */
+    uint32_t EstimateSketchCapacity(size_t local_set_size) const
+    {
+        const size_t remote_set_size{m_remote_set_size};
+        const double q{double(m_remote_q) / Q_PRECISION};
+        const size_t set_size_diff{local_set_size > remote_set_size ? local_set_size - remote_set_size : remote_set_size - local_set_size};
+        const size_t estimated_diff{set_size_diff + size_t(q * std::min(local_set_size, remote_set_size)) + 1};
+        return std::min<uint32_t>(Minisketch::ComputeCapacity(32, estimated_diff, RECON_FALSE_POSITIVE_COEF), MAX_SKETCH_CAPACITY);
+    }
+
+    /** End the reconciliation, returning the snapshot. */
+    std::vector<Wtxid> FinishReconciliation()
+    {
+        m_phase = ReconciliationPhase::NONE;
+        m_remote_sketch.clear();
+        m_sketch_capacity = 0;
+        return std::exchange(m_local_set_snapshot, {});
+    }
 };
 
 } // namespace
@@ -76,6 +182,52 @@ private:
      */
     std::unordered_map<NodeId, std::variant<uint64_t, TxReconciliationState>> m_states GUARDED_BY(m_txreconciliation_mutex);
 
+    /** Salt of the choice of the peers a transaction is flooded to. */
+    const uint64_t m_fanout_k0{FastRandomContext().rand64()};
+    const uint64_t m_fanout_k1{FastRandomContext().rand64()};
+
+    /**
+     * The peers each recent transaction is flooded to, computed once per transaction rather than
+     * for each peer it is announced to. Cleared when a peer registers or is forgotten, as the
+     * choice depends on the registered peers, and trimmed oldest first.
+     */
+    mutable std::unordered_map<Wtxid, std::vector<NodeId>, SaltedTxidHasher> m_fanout_targets GUARDED_BY(m_txreconciliation_mutex);
+    mutable std::deque<Wtxid> m_fanout_targets_order GUARDED_BY(m_txreconciliation_mutex);
+
+    /**
+     * Rank the registered peers of each direction by a salted hash of the transaction and the
+     * peer, and pick the first ones.
+     */
+    std::vector<NodeId> ComputeFanoutTargets(const Wtxid& wtxid) const EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        AssertLockHeld(m_txreconciliation_mutex);
+        std::vector<std::pair<uint64_t, NodeId>> outbound, inbound;
+        for (const auto& [id, state] : m_states) {
+            const auto* peer_state{std::get_if<TxReconciliationState>(&state)};
+            if (!peer_state) continue;
+            (peer_state->m_we_initiate ? outbound : inbound).emplace_back(SipHashUint256Extra(m_fanout_k0, m_fanout_k1, wtxid.ToUint256(), uint32_t(id)), id);
+        }
+
+        std::vector<NodeId> targets;
+        const auto pick = [&](std::vector<std::pair<uint64_t, NodeId>>& ranked, size_t destinations) {
+            destinations = std::min(destinations, ranked.size());
+            std::partial_sort(ranked.begin(), ranked.begin() + destinations, ranked.end());
+            for (size_t i = 0; i < destinations; ++i) targets.push_back(ranked[i].second);
+        };
+        pick(outbound, OUTBOUND_FANOUT_DESTINATIONS);
+        // Round up, so that a node with few inbound peers still floods to one of them
+        pick(inbound, size_t(std::ceil(inbound.size() * INBOUND_FANOUT_DESTINATIONS_FRACTION)));
+        return targets;
+    }
+
+    TxReconciliationState* GetRegisteredPeerState(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        AssertLockHeld(m_txreconciliation_mutex);
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&recon_state->second);
+    }
+
 public:
     explicit Impl(uint32_t recon_version) : m_recon_version(recon_version) {}
 
@@ -121,7 +273,9 @@ public:
                       peer_id, is_peer_inbound);
 
         const uint256 full_salt{ComputeSalt(local_salt, remote_salt)};
-        recon_state->second = TxReconciliationState(!is_peer_inbound, full_salt.GetUint64(0), full_salt.GetUint64(1));
+        recon_state->second.emplace<TxReconciliationState>(!is_peer_inbound, full_salt.GetUint64(0), full_salt.GetUint64(1));
+        m_fanout_targets.clear();
+        m_fanout_targets_order.clear();
         return ReconciliationRegisterResult::SUCCESS;
     }
 
@@ -131,6 +285,8 @@ public:
         LOCK(m_txreconciliation_mutex);
         if (m_states.erase(peer_id)) {
             LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Forget txreconciliation state of peer=%d\n", peer_id);
+            m_fanout_targets.clear();
+            m_fanout_targets_order.clear();
         }
     }
 
@@ -142,6 +298,237 @@ public:
         return (recon_state != m_states.end() &&
                 std::holds_alternative<TxReconciliationState>(recon_state->second));
     }
+
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state) return false;
+        if (peer_state->m_local_set.size() >= MAX_RECONSET_SIZE) {
+            LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation set of peer=%d is full, flooding tx %s\n",
+                          peer_id, wtxid.ToString());
+            return false;
+        }
+        peer_state->m_local_set.insert(wtxid);
+        return true;
+    }
+
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        return peer_state && peer_state->m_local_set.erase(wtxid) > 0;
+    }
+
+    bool IsFanoutTarget(NodeId peer_id, const Wtxid& wtxid) const EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return true;
+        if (!std::holds_alternative<TxReconciliationState>(recon_state->second)) return true;
+
+        auto targets{m_fanout_targets.find(wtxid)};
+        if (targets == m_fanout_targets.end()) {
+            if (m_fanout_targets_order.size() >= MAX_FANOUT_TARGETS_CACHE) {
+                m_fanout_targets.erase(m_fanout_targets_order.front());
+                m_fanout_targets_order.pop_front();
+            }
+            targets = m_fanout_targets.emplace(wtxid, ComputeFanoutTargets(wtxid)).first;
+            m_fanout_targets_order.push_back(wtxid);
+        }
+        return std::find(targets->second.begin(), targets->second.end(), peer_id) != targets->second.end();
+    }
+
+    std::optional<std::pair<uint16_t, uint16_t>> MaybeRequestReconciliation(NodeId peer_id, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || !peer_state->m_we_initiate || peer_state->m_phase != ReconciliationPhase::NONE) return std::nullopt;
+
+        if (peer_state->m_next_recon_request == std::chrono::microseconds{0}) {
+            // Give the first transactions time to gather
+            peer_state->m_next_recon_request = now + RECON_REQUEST_INTERVAL;
+            return std::nullopt;
+        }
+        if (now < peer_state->m_next_recon_request) return std::nullopt;
+        peer_state->m_next_recon_request = now + RECON_REQUEST_INTERVAL;
+        peer_state->m_recon_timeout = now + RECON_RESPONSE_TIMEOUT;
+        peer_state->m_phase = ReconciliationPhase::INIT_REQUESTED;
+
+        const uint16_t set_size{uint16_t(std::min<size_t>(peer_state->m_local_set.size(), std::numeric_limits<uint16_t>::max()))};
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Request reconciliation from peer=%d (set size %d)\n",
+                      peer_id, set_size);
+        return std::make_pair(set_size, uint16_t(RECON_Q * Q_PRECISION));
+    }
+
+    std::optional<std::vector<Wtxid>> MaybeTimeoutReconciliation(NodeId peer_id, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || !peer_state->m_we_initiate || now < peer_state->m_recon_timeout ||
+            (peer_state->m_phase != ReconciliationPhase::INIT_REQUESTED && peer_state->m_phase != ReconciliationPhase::EXT_REQUESTED)) {
+            return std::nullopt;
+        }
+
+        // Without the initial sketch the set was not moved aside yet
+        const bool initial{peer_state->m_phase == ReconciliationPhase::INIT_REQUESTED};
+        std::vector<Wtxid> announce{peer_state->FinishReconciliation()};
+        if (initial) {
+            announce.assign(peer_state->m_local_set.begin(), peer_state->m_local_set.end());
+            peer_state->m_local_set.clear();
+        }
+        peer_state->m_late_sketch = true;
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d timed out, announcing %d txs\n",
+                      peer_id, announce.size());
+        return announce;
+    }
+
+    bool HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || peer_state->m_we_initiate || peer_state->m_phase != ReconciliationPhase::NONE) return false;
+
+        peer_state->m_remote_set_size = peer_recon_set_size;
+        peer_state->m_remote_q = peer_q;
+        peer_state->m_phase = ReconciliationPhase::INIT_PENDING;
+        return true;
+    }
+
+    std::optional<std::vector<uint8_t>> MaybeRespondToReconciliationRequest(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || peer_state->m_phase != ReconciliationPhase::INIT_PENDING) return std::nullopt;
+
+        peer_state->m_local_set_snapshot.assign(peer_state->m_local_set.begin(), peer_state->m_local_set.end());
+        peer_state->m_local_set.clear();
+        peer_state->m_phase = ReconciliationPhase::INIT_RESPONDED;
+
+        // With nothing on both sides an empty sketch ends the reconciliation
+        if (peer_state->m_local_set_snapshot.empty() && peer_state->m_remote_set_size == 0) {
+            peer_state->m_sketch_capacity = 0;
+            return std::vector<uint8_t>{};
+        }
+        peer_state->m_sketch_capacity = peer_state->EstimateSketchCapacity(peer_state->m_local_set_snapshot.size());
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Send sketch of capacity %d to peer=%d (set size %d)\n",
+                      peer_state->m_sketch_capacity, peer_id, peer_state->m_local_set_snapshot.size());
+        return peer_state->ComputeSketch(peer_state->m_sketch_capacity).Serialize();
+    }
+
+    HandleSketchResult HandleSketch(NodeId peer_id, Span<const uint8_t> skdata) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        if (peer_state && peer_state->m_we_initiate && peer_state->m_late_sketch) {
+            // The peer sends the sketch it owes before answering a later request
+            peer_state->m_late_sketch = false;
+            return {HandleSketchResult::Action::IGNORE};
+        }
+        if (!peer_state || !peer_state->m_we_initiate || skdata.size() % 4 != 0 ||
+            (peer_state->m_phase != ReconciliationPhase::INIT_REQUESTED && peer_state->m_phase != ReconciliationPhase::EXT_REQUESTED)) {
+            return {HandleSketchResult::Action::PROTOCOL_VIOLATION};
+        }
+
+        if (peer_state->m_phase == ReconciliationPhase::INIT_REQUESTED) {
+            if (skdata.size() / 4 > MAX_SKETCH_CAPACITY) return {HandleSketchResult::Action::PROTOCOL_VIOLATION};
+            peer_state->m_local_set_snapshot.assign(peer_state->m_local_set.begin(), peer_state->m_local_set.end());
+            peer_state->m_local_set.clear();
+            peer_state->m_remote_sketch.assign(skdata.begin(), skdata.end());
+        } else {
+            // The extension holds as many elements as the initial sketch
+            if (skdata.size() != peer_state->m_remote_sketch.size()) return {HandleSketchResult::Action::PROTOCOL_VIOLATION};
+            peer_state->m_remote_sketch.insert(peer_state->m_remote_sketch.end(), skdata.begin(), skdata.end());
+        }
+
+        HandleSketchResult result{HandleSketchResult::Action::SEND_DIFF};
+        const uint32_t capacity{uint32_t(peer_state->m_remote_sketch.size() / 4)};
+        std::optional<std::vector<uint64_t>> differences;
+        if (capacity > 0) {
+            Minisketch remote_sketch{node::MakeMinisketch32(capacity)};
+            remote_sketch.Deserialize(peer_state->m_remote_sketch);
+            differences = remote_sketch.Merge(peer_state->ComputeSketch(capacity)).DecodeFP(RECON_FALSE_POSITIVE_COEF);
+        }
+
+        if (!differences && capacity > 0 && peer_state->m_phase == ReconciliationPhase::INIT_REQUESTED) {
+            LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Request sketch extension from peer=%d\n", peer_id);
+            peer_state->m_phase = ReconciliationPhase::EXT_REQUESTED;
+            return {HandleSketchResult::Action::REQUEST_EXTENSION};
+        }
+
+        if (!differences) {
+            // Fall back to announcing the whole set, as does the peer
+            LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d failed, announcing %d txs\n",
+                          peer_id, peer_state->m_local_set_snapshot.size());
+            result.txs_to_announce = peer_state->FinishReconciliation();
+            return result;
+        }
+
+        std::unordered_map<uint32_t, Wtxid> local_short_ids;
+        for (const Wtxid& wtxid : peer_state->m_local_set_snapshot) {
+            local_short_ids.emplace(peer_state->ComputeShortID(wtxid), wtxid);
+        }
+        for (const uint64_t short_id : *differences) {
+            const auto local{local_short_ids.find(uint32_t(short_id))};
+            if (local != local_short_ids.end()) {
+                result.txs_to_announce.push_back(local->second);
+            } else {
+                result.txs_to_request.push_back(uint32_t(short_id));
+            }
+        }
+        result.success = true;
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciled with peer=%d: %d txs to announce, %d to request\n",
+                      peer_id, result.txs_to_announce.size(), result.txs_to_request.size());
+        peer_state->FinishReconciliation();
+        return result;
+    }
+
+    std::optional<std::vector<uint8_t>> HandleSketchExtensionRequest(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || peer_state->m_phase != ReconciliationPhase::INIT_RESPONDED || peer_state->m_sketch_capacity == 0) return std::nullopt;
+
+        // A sketch of twice the capacity starts with the serialization of the initial one, only
+        // the rest is sent
+        const uint32_t capacity{peer_state->m_sketch_capacity};
+        std::vector<uint8_t> extended{peer_state->ComputeSketch(2 * capacity).Serialize()};
+        peer_state->m_phase = ReconciliationPhase::EXT_RESPONDED;
+        return std::vector<uint8_t>(extended.begin() + 4 * capacity, extended.end());
+    }
+
+    std::optional<std::vector<Wtxid>> HandleReconciliationDifference(NodeId peer_id, bool success, const std::vector<uint32_t>& ask_shortids) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        TxReconciliationState* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || (peer_state->m_phase != ReconciliationPhase::INIT_RESPONDED && peer_state->m_phase != ReconciliationPhase::EXT_RESPONDED)) {
+            return std::nullopt;
+        }
+
+        std::vector<Wtxid> snapshot{peer_state->FinishReconciliation()};
+        if (!success) {
+            LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d failed, announcing %d txs\n",
+                          peer_id, snapshot.size());
+            return snapshot;
+        }
+
+        std::unordered_set<uint32_t> asked(ask_shortids.begin(), ask_shortids.end());
+        std::vector<Wtxid> announce;
+        for (const Wtxid& wtxid : snapshot) {
+            if (asked.count(peer_state->ComputeShortID(wtxid))) announce.push_back(wtxid);
+        }
+        return announce;
+    }
 };
 
 TxReconciliationTracker::TxReconciliationTracker(uint32_t recon_version) : m_impl{std::make_unique<TxReconciliationTracker::Impl>(recon_version)} {}
@@ -168,3 +555,54 @@ bool TxReconciliationTracker::IsPeerRegistered(NodeId peer_id) const
 {
     return m_impl->IsPeerRegistered(peer_id);
 }
+
+bool TxReconciliationTracker::AddToSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->AddToSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->TryRemovingFromSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::IsFanoutTarget(NodeId peer_id, const Wtxid& wtxid) const
+{
+    return m_impl->IsFanoutTarget(peer_id, wtxid);
+}
+
+std::optional<std::pair<uint16_t, uint16_t>> TxReconciliationTracker::MaybeRequestReconciliation(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->MaybeRequestReconciliation(peer_id, now);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::MaybeTimeoutReconciliation(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->MaybeTimeoutReconciliation(peer_id, now);
+}
+
+bool TxReconciliationTracker::HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q)
+{
+    return m_impl->HandleReconciliationRequest(peer_id, peer_recon_set_size, peer_q);
+}
+
+std::optional<std::vector<uint8_t>> TxReconciliationTracker::MaybeRespondToReconciliationRequest(NodeId peer_id)
+{
+    return m_impl->MaybeRespondToReconciliationRequest(peer_id);
+}
+
+HandleSketchResult TxReconciliationTracker::HandleSketch(NodeId peer_id, Span<const uint8_t> skdata)
+{
+    return m_impl->HandleSketch(peer_id, skdata);
+}
+
+std::optional<std::vector<uint8_t>> TxReconciliationTracker::HandleSketchExtensionRequest(NodeId peer_id)
+{
+    return m_impl->HandleSketchExtensionRequest(peer_id);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::HandleReconciliationDifference(NodeId peer_id, bool success,
+                                                                                           const std::vector<uint32_t>& ask_shortids)
+{
+    return m_impl->HandleReconciliationDifference(peer_id, success, ask_shortids);
+}
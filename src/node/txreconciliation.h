@@ -6,13 +6,30 @@
 #define BITCOIN_NODE_TXRECONCILIATION_H
 
 #include <net.h>
+#include <span.h>
 #include <sync.h>
+#include <util/transaction_identifier.h>
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 /** Supported transaction reconciliation protocol version */
 static constexpr uint32_t TXRECONCILIATION_VERSION{1};
+/** How often we request a reconciliation from each peer we initiate reconciliations with */
+static constexpr std::chrono::microseconds RECON_REQUEST_INTERVAL{std::chrono::seconds{2}};
+/** How long a reconciliation we initiated may wait for the sketches before its set is flooded */
+static constexpr std::chrono::microseconds RECON_RESPONSE_TIMEOUT{std::chrono::seconds{10}};
+/**
+ * Maximum number of transactions waiting to be reconciled with a peer. Transactions that do
+ * not fit are announced by flooding instead.
+ */
+static constexpr size_t MAX_RECONSET_SIZE{3000};
+/** Maximum number of elements a sketch can hold, bounding the size of sketch messages */
+static constexpr uint32_t MAX_SKETCH_CAPACITY{2 << 12};
 
 enum class ReconciliationRegisterResult {
     NOT_FOUND,
@@ -21,6 +38,27 @@ enum class ReconciliationRegisterResult {
     PROTOCOL_VIOLATION,
 };
 
+/** What the initiator of a reconciliation does after receiving a sketch from the peer. */
+struct HandleSketchResult {
+    enum class Action {
+        //! The sketch was not expected or is invalid, the peer should be disconnected
+        PROTOCOL_VIOLATION,
+        //! The difference could not be decoded, request an extension of the sketch
+        REQUEST_EXTENSION,
+        //! Send RECONCILDIFF and announce txs_to_announce
+        SEND_DIFF,
+        //! The sketch answers a reconciliation that timed out, drop it
+        IGNORE,
+    };
+    Action action;
+    //! Whether the set difference was found, sent in RECONCILDIFF
+    bool success{false};
+    //! Short IDs of the transactions only the peer has, sent in RECONCILDIFF
+    std::vector<uint32_t> txs_to_request;
+    //! Transactions to announce to the peer: the ones only we have, or all of our set on failure
+    std::vector<Wtxid> txs_to_announce;
+};
+
 /**
  * Transaction reconciliation is a way for nodes to efficiently announce transactions.
  * This object keeps track of all txreconciliation-related communications with the peers.
@@ -84,6 +122,71 @@ public:
      * Check if a peer is registered to reconcile transactions with us.
      */
     bool IsPeerRegistered(NodeId peer_id) const;
+
+    /**
+     * Step 1. Add a transaction to the set we announce to a registered peer by reconciliation.
+     * Returns false if the transaction must be announced by flooding instead, because the set
+     * is full.
+     */
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Remove a transaction from the set of a peer, because the peer announced it to us. Returns
+     * whether it was in the set. Transactions of an ongoing reconciliation are not removed.
+     */
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Whether a transaction should be announced to a registered peer by flooding rather than
+     * added to its set. A small deterministic choice of the reconciling peers (one outbound
+     * peer, a tenth of the inbound peers rounded up) gets each transaction by flooding, so it
+     * spreads quickly while the rest of the links only carry the set differences.
+     */
+    bool IsFanoutTarget(NodeId peer_id, const Wtxid& wtxid) const;
+
+    /**
+     * Step 2. If we initiate reconciliations with the peer and it is time for the next one,
+     * returns the size of our set and the q coefficient to send in REQRECON.
+     */
+    std::optional<std::pair<uint16_t, uint16_t>> MaybeRequestReconciliation(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * If the peer did not send the sketches of a reconciliation we initiated within
+     * RECON_RESPONSE_TIMEOUT, end the reconciliation as failed. Returns the transactions to
+     * announce, after sending a failed RECONCILDIFF so the peer announces its set too. A sketch
+     * the peer still sends for the reconciliation is ignored.
+     */
+    std::optional<std::vector<Wtxid>> MaybeTimeoutReconciliation(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2. Record a REQRECON from a peer that initiates reconciliations with us. Returns
+     * false if the peer violated the protocol.
+     */
+    bool HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q);
+
+    /**
+     * Step 2. If the peer requested a reconciliation, returns the sketch of our set to send in
+     * SKETCH. The set is kept aside until the reconciliation ends.
+     */
+    std::optional<std::vector<uint8_t>> MaybeRespondToReconciliationRequest(NodeId peer_id);
+
+    /**
+     * Steps 3 and 4. Combine a sketch received from the peer with the sketch of our set.
+     */
+    HandleSketchResult HandleSketch(NodeId peer_id, Span<const uint8_t> skdata);
+
+    /**
+     * Step 4b. Returns the extension of the sketch we sent, to send in SKETCH, or nullopt if the
+     * peer violated the protocol.
+     */
+    std::optional<std::vector<uint8_t>> HandleSketchExtensionRequest(NodeId peer_id);
+
+    /**
+     * End of a reconciliation we responded to. Returns the transactions to announce to the peer,
+     * or nullopt if the peer violated the protocol.
+     */
+    std::optional<std::vector<Wtxid>> HandleReconciliationDifference(NodeId peer_id, bool success,
+                                                                      const std::vector<uint32_t>& ask_shortids);
 };
 
 #endif // BITCOIN_NODE_TXRECONCILIATION_H
@@ -14,8 +14,11 @@
 #define BITCOIN_NODE_TYPES_H
 
 #include <cstddef>
+#include <cstdint>
 #include <policy/policy.h>
+#include <primitives/transaction.h>
 #include <script/script.h>
+#include <uint256.h>
 
 namespace node {
 enum class TransactionError {
@@ -61,6 +64,50 @@ struct BlockCreateOptions {
      */
     CScript coinbase_output_script{CScript() << OP_TRUE};
 };
+
+/**
+ * Proof-of-stake parameters of the block on top of the current tip, enough
+ * to search kernels without access to the block index.
+ */
+struct StakeTarget {
+    uint256 prev_hash;
+    //! Height of the block to stake
+    int height{0};
+    uint32_t bits{0};
+    uint256 stake_modifier;
+    //! Block times must have these bits cleared
+    uint32_t timestamp_mask{0};
+    //! Earliest valid block time
+    int64_t min_time{0};
+    //! Coins created above this height are not mature
+    int max_coin_height{0};
+};
+
+/**
+ * Unspent output that can be used as a proof-of-stake kernel.
+ */
+struct StakeCoin {
+    COutPoint prevout;
+    CTxOut out;
+    //! Height of the block that created the coin
+    int height{0};
+    //! Time of the block that created the coin
+    uint32_t block_from_time{0};
+};
+
+/**
+ * Changes to the coins of a staker up to a block.
+ */
+struct StakeCoinsUpdate {
+    //! Block the coins are up to date with, null if the update failed
+    uint256 tip;
+    //! Whether coins replace all previous coins instead of adding to them
+    bool full{false};
+    //! Coins created
+    std::vector<StakeCoin> coins;
+    //! Previous coins spent
+    std::vector<COutPoint> spent;
+};
 } // namespace node
 
 #endif // BITCOIN_NODE_TYPES_H
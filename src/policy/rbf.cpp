@@ -157,6 +157,23 @@ std::optional<std::string> PaysMoreThanConflicts(const CTxMemPool::setEntries& i
     return std::nullopt;
 }
 
+std::optional<std::string> PaysMoreGasPriceThanConflicts(const CTxMemPool::setEntries& iters_conflicting,
+                                                         CAmount replacement_gas_price,
+                                                         const uint256& txid)
+{
+    for (const auto& mi : iters_conflicting) {
+        // Replacing a contract execution with one at the same gas price would
+        // not make it any more likely to be mined.
+        if (mi->GetTx().HasCreateOrCall() && replacement_gas_price <= mi->GetMinGasPrice()) {
+            return strprintf("rejecting replacement %s; new gas price %d <= old gas price %d",
+                             txid.ToString(),
+                             replacement_gas_price,
+                             mi->GetMinGasPrice());
+        }
+    }
+    return std::nullopt;
+}
+
 std::optional<std::string> PaysForRBF(CAmount original_fees,
                                       CAmount replacement_fees,
                                       size_t replacement_vsize,
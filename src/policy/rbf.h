@@ -100,6 +100,14 @@ std::optional<std::string> EntriesAndTxidsDisjoint(const CTxMemPool::setEntries&
 std::optional<std::string> PaysMoreThanConflicts(const CTxMemPool::setEntries& iters_conflicting,
                                                  CFeeRate replacement_feerate, const uint256& txid);
 
+/** Check that the minimum gas price of the replacement transaction is higher than the minimum
+ * gas price of each of the contract transactions in iters_conflicting.
+ * @param[in]   iters_conflicting  The set of mempool entries.
+ * @returns error message if the gas price is insufficient, otherwise std::nullopt.
+ */
+std::optional<std::string> PaysMoreGasPriceThanConflicts(const CTxMemPool::setEntries& iters_conflicting,
+                                                         CAmount replacement_gas_price, const uint256& txid);
+
 /** The replacement transaction must pay more fees than the original transactions. The additional
  * fees must pay for the replacement's bandwidth at or above the incremental relay feerate.
  * @param[in]   original_fees       Total modified fees of original transaction(s).
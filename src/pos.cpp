@@ -64,15 +64,13 @@ uint256 ComputeStakeModifier(const CBlockIndex* pindexPrev, const uint256& kerne
 //   quantities so as to generate blocks faster, degrading the system back into
 //   a proof-of-work situation.
 //
-bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t blockFromTime, CAmount prevoutValue, const COutPoint& prevout, unsigned int nTimeBlock, uint256& hashProofOfStake, uint256& targetProofOfStake, bool fPrintProofOfStake)
+bool CheckStakeKernelHash(const uint256& nStakeModifier, int nHeight, unsigned int nBits, uint32_t blockFromTime, CAmount prevoutValue, const COutPoint& prevout, unsigned int nTimeBlock, uint256& hashProofOfStake, uint256& targetProofOfStake, bool fPrintProofOfStake)
 {
     if (nTimeBlock < blockFromTime) {  // Transaction timestamp violation
         LogError("CheckStakeKernelHash() : nTime violation");
         return false;
     }
 
-    // Get height
-    int nHeight = pindexPrev->nHeight + 1;
     bool fNoBNOverflow = nHeight >= Params().GetConsensus().nReduceBlocktimeHeight;
 
     // Base target
@@ -87,8 +85,6 @@ bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t
 
     targetProofOfStake = ArithToUint256(bnTarget);
 
-    uint256 nStakeModifier = pindexPrev->nStakeModifier;
-
     // Calculate hash
     HashWriter ss;
     ss << nStakeModifier;
@@ -122,6 +118,12 @@ bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t
     return true;
 }
 
+bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t blockFromTime, CAmount prevoutValue, const COutPoint& prevout, unsigned int nTimeBlock, uint256& hashProofOfStake, uint256& targetProofOfStake, bool fPrintProofOfStake)
+{
+    return CheckStakeKernelHash(pindexPrev->nStakeModifier, pindexPrev->nHeight + 1, nBits, blockFromTime, prevoutValue, prevout,
+                                nTimeBlock, hashProofOfStake, targetProofOfStake, fPrintProofOfStake);
+}
+
 bool ViewGetCoin(CCoinsViewCache& view, const COutPoint &outpoint, Coin &coin) {
     auto coinIn = view.GetCoin(outpoint);
     if (coinIn.has_value()) {
@@ -285,7 +287,7 @@ bool CheckProofOfStake(CBlockIndex* pindexPrev, BlockValidationState& state, con
     return true;
 }
 
-bool CheckBlockInputPubKeyMatchesOutputPubKey(const CBlock& block, CCoinsViewCache& view, bool delegateOutputExist) {
+bool CheckBlockInputPubKeyMatchesOutputPubKey(const CBlock& block, CCoinsViewCache& view, bool delegateOutputExist, bool fMPoSCredit) {
 
     Coin coinIn;
     if(!ViewGetCoin(view, block.prevoutStake, coinIn)) {
@@ -305,6 +307,16 @@ bool CheckBlockInputPubKeyMatchesOutputPubKey(const CBlock& block, CCoinsViewCac
 
     const CTxOut& txout = coinstakeTx->vout[1 + hasDelegation];
 
+    // After the MPoS balance fork the reward of the delegate accrues to the balance of its key
+    if(hasDelegation && fMPoSCredit) {
+        uint160 credit, owner;
+        if(!ExtractMPoSCredit(txout.scriptPubKey, credit) || !GetMPoSBalanceKey(coinIn.out.scriptPubKey, owner) || credit != owner) {
+            LogError("%s: delegate output does not credit the MPoS balance of the delegate", __func__);
+            return false;
+        }
+        return true;
+    }
+
     if(coinIn.out.scriptPubKey == txout.scriptPubKey) {
         return true;
     }
@@ -351,6 +363,10 @@ bool CheckRecoveredPubKeyFromBlockSignature(CBlockIndex* pindexPrev, const CBloc
         }
     }
 
+    return CheckRecoveredPubKeyFromBlockSignature(pindexPrev->nHeight + 1, block, coinPrev);
+}
+
+bool CheckRecoveredPubKeyFromBlockSignature(int nHeight, const CBlockHeader& block, const Coin& coinPrev) {
     uint256 hash = block.GetHashWithoutSign();
     CPubKey pubkey;
     std::vector<unsigned char> vchBlockSig = block.GetBlockSignature();
@@ -363,7 +379,7 @@ bool CheckRecoveredPubKeyFromBlockSignature(CBlockIndex* pindexPrev, const CBloc
     }
 
     // Recover the public key
-    if (pindexPrev->nHeight + 1 >= Params().GetConsensus().nOfflineStakeHeight)
+    if (nHeight >= Params().GetConsensus().nOfflineStakeHeight)
     {
         // Recover the public key from compact signature
         if(hasDelegation)
@@ -778,6 +794,12 @@ bool GetMPoSOutputs(std::vector<CTxOut>& mposOutputList, int64_t nRewardPiece, i
 
 bool CreateMPoSOutputs(CMutableTransaction& txNew, int64_t nRewardPiece, int nHeight, const Consensus::Params &consensusParams, CChain& chain, node::BlockManager& blockman)
 {
+    // The pieces accrue to the balances of the recipients, see ConnectBlock
+    if(nHeight + 1 >= consensusParams.nMPoSBalanceHeight)
+    {
+        return true;
+    }
+
     std::vector<CTxOut> mposOutputList;
     if(!GetMPoSOutputs(mposOutputList, nRewardPiece, nHeight, consensusParams, chain, blockman))
     {
@@ -793,6 +815,33 @@ bool CreateMPoSOutputs(CMutableTransaction& txNew, int64_t nRewardPiece, int nHe
     return true;
 }
 
+bool GetCoinStakeReward(int nHeight, const CAmount& nTotalFees, const Consensus::Params& consensusParams, CAmount& nStakerReward, int64_t& nRewardPiece)
+{
+    nRewardPiece = 0;
+    int64_t nReward = nTotalFees + GetBlockSubsidy(nHeight, consensusParams);
+    if (nReward < 0)
+        return false;
+
+    // HYBRID CONSENSUS: After activation, split reward between miner (PoW) and validator (PoS)
+    if (nHeight >= consensusParams.nHybridConsensusActivationHeight) {
+        // The validator gets their share in the coinstake, the miner's share
+        // is handled separately in block creation
+        nStakerReward = (nReward * consensusParams.nGapcoinValidatorRewardPercent) / 100;
+    }
+    else if(nHeight - 1 < consensusParams.nFirstMPoSBlock || nHeight - 1 >= consensusParams.nLastMPoSBlock)
+    {
+        // Keep whole reward (legacy behavior)
+        nStakerReward = nReward;
+    }
+    else
+    {
+        // Split the reward when mpos is used (legacy MPoS)
+        nRewardPiece = nReward / consensusParams.nMPoSRewardRecipients;
+        nStakerReward = nRewardPiece + nReward % consensusParams.nMPoSRewardRecipients;
+    }
+    return true;
+}
+
 //////////////////////////////////////////////////
 // WATTx Trust Tier PoS Functions Implementation
 //////////////////////////////////////////////////
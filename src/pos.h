@@ -26,6 +26,10 @@ uint256 ComputeStakeModifier(const CBlockIndex* pindexPrev, const uint256& kerne
 // Sets hashProofOfStake on success return
 bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, uint32_t blockFromTime, CAmount prevoutAmount, const COutPoint& prevout, unsigned int nTimeTx, uint256& hashProofOfStake, uint256& targetProofOfStake, bool fPrintProofOfStake=false);
 
+// Check whether stake kernel meets hash target for the block at nHeight,
+// without access to the block index
+bool CheckStakeKernelHash(const uint256& nStakeModifier, int nHeight, unsigned int nBits, uint32_t blockFromTime, CAmount prevoutAmount, const COutPoint& prevout, unsigned int nTimeTx, uint256& hashProofOfStake, uint256& targetProofOfStake, bool fPrintProofOfStake=false);
+
 // Check kernel hash target and coinstake signature
 // Sets hashProofOfStake on success return
 bool CheckProofOfStake(CBlockIndex* pindexPrev, BlockValidationState& state, const CTransaction& tx, unsigned int nBits, uint32_t nTimeBlock, const std::vector<unsigned char>& vchPoD, const COutPoint& headerPrevout, uint256& hashProofOfStake, uint256& targetProofOfStake, CCoinsViewCache& view, Chainstate& chainstate);
@@ -38,11 +42,15 @@ inline bool CheckCoinStakeTimestamp(uint32_t nTimeBlock, int nHeight, const Cons
 
 // Should be called in ConnectBlock to make sure that the input pubkey == output pubkey
 // Since it is only used in ConnectBlock, we know that we have access to the full contextual utxo set
-bool CheckBlockInputPubKeyMatchesOutputPubKey(const CBlock& block, CCoinsViewCache& view, bool delegateOutputExist);
+// After the MPoS balance fork the delegate output must credit the balance of the delegate
+bool CheckBlockInputPubKeyMatchesOutputPubKey(const CBlock& block, CCoinsViewCache& view, bool delegateOutputExist, bool fMPoSCredit);
 
 // Recover the pubkey and check that it matches the prevoutStake's scriptPubKey.
 bool CheckRecoveredPubKeyFromBlockSignature(CBlockIndex* pindexPrev, const CBlockHeader& block, CCoinsViewCache& view, Chainstate& chainstate);
 
+// Recover the pubkey and check that it matches the scriptPubKey of the staked coin, for a block at nHeight.
+bool CheckRecoveredPubKeyFromBlockSignature(int nHeight, const CBlockHeader& block, const Coin& coinPrev);
+
 // Wrapper around CheckStakeKernelHash()
 // Also checks existence of kernel input and min age
 // Convenient for searching a kernel
@@ -70,6 +78,10 @@ bool GetMPoSOutputs(std::vector<CTxOut>& mposOutputList, int64_t nRewardPiece, i
 
 bool CreateMPoSOutputs(CMutableTransaction& txNew, int64_t nRewardPiece, int nHeight, const Consensus::Params& consensusParams, CChain& chain, node::BlockManager& blockman);
 
+// Get the part of the reward and fees of the block at nHeight paid by the
+// coinstake to its staker, and the piece paid to each MPoS recipient
+bool GetCoinStakeReward(int nHeight, const CAmount& nTotalFees, const Consensus::Params& consensusParams, CAmount& nStakerReward, int64_t& nRewardPiece);
+
 //////////////////////////////////////////////////
 // WATTx Trust Tier PoS Functions
 //////////////////////////////////////////////////
@@ -6,11 +6,17 @@
 #ifndef BITCOIN_PRIMITIVES_BLOCK_H
 #define BITCOIN_PRIMITIVES_BLOCK_H
 
+#include <consensus/consensus.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <support/allocators/arena.h>
 #include <uint256.h>
 #include <util/time.h>
 
+#include <algorithm>
+#include <memory>
+#include <new>
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -192,6 +198,60 @@ public:
     std::string ToString() const;
 };
 
+/**
+ * Deserialization wrapper reading a CBlock with its transaction objects, and
+ * their reference counts, allocated from one arena instead of one heap
+ * allocation each. The arena is released once the block and every
+ * transaction taken from it are gone.
+ *
+ * Only the CTransaction objects live in the arena. Their inputs, outputs,
+ * scripts and witnesses still own heap buffers, as their types are shared
+ * with the rest of the code base. A transaction kept beyond the block should
+ * go through Detach(), so that it does not keep the whole arena alive.
+ *
+ * Use as `s >> TX_WITH_WITNESS(BlockWithArena{block, max_size})`, where
+ * max_size bounds the bytes the block can be read from.
+ */
+struct BlockWithArena {
+    //! Space reserved per transaction, covering the shared_ptr control block
+    static constexpr size_t TX_ARENA_SIZE{sizeof(CTransaction) + 6 * sizeof(void*)};
+    //! Bound on the transactions to reserve space for before they are read
+    static constexpr uint64_t MAX_PRESIZED_TXS{1 << 14};
+    //! Lower bound for the size of a serialized transaction
+    static constexpr size_t MIN_TX_SIZE{MIN_SERIALIZABLE_TRANSACTION_WEIGHT / WITNESS_SCALE_FACTOR};
+
+    //! Destroys a transaction read into an arena, whose memory goes with the arena
+    struct TxDeleter {
+        void operator()(const CTransaction* tx) const { tx->~CTransaction(); }
+    };
+
+    CBlock& block;
+    size_t max_size;
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> AsBase<CBlockHeader>(block);
+        // The count is not trusted, so only reserve for as many transactions as fit in the data
+        const uint64_t count{ReadCompactSize(s)};
+        const uint64_t presized{std::min({count, MAX_PRESIZED_TXS, uint64_t{max_size / MIN_TX_SIZE}})};
+        ArenaAllocator<CTransaction> alloc{std::make_shared<MonotonicArena>(std::max<size_t>(presized * TX_ARENA_SIZE, MonotonicArena::DEFAULT_CHUNK_SIZE / 16))};
+        block.vtx.clear();
+        block.vtx.reserve(presized);
+        for (uint64_t i = 0; i < count; ++i) {
+            CTransaction* tx{new (alloc.allocate(1)) CTransaction(deserialize, s)};
+            block.vtx.emplace_back(tx, TxDeleter{}, alloc);
+        }
+    }
+
+    /** The transaction itself, or a copy of it on the heap if it was read into an arena. */
+    static CTransactionRef Detach(const CTransactionRef& tx)
+    {
+        if (tx && std::get_deleter<TxDeleter>(tx)) return std::make_shared<const CTransaction>(*tx);
+        return tx;
+    }
+};
+
 /** Describes a place in the block chain to another node such that if the
  * other node doesn't have the same branch, it can find a recent common trunk.
  * The further back it is, the further before the fork it may be.
@@ -264,6 +264,27 @@ inline constexpr const char* WTXIDRELAY{"wtxidrelay"};
  * txreconciliation, as described by BIP 330.
  */
 inline constexpr const char* SENDTXRCNCL{"sendtxrcncl"};
+/**
+ * Starts a txreconciliation round. Contains the size of the set of the
+ * initiator and the coefficient used to estimate the set difference, as
+ * described by BIP 330.
+ */
+inline constexpr const char* REQRECON{"reqrecon"};
+/**
+ * Contains a sketch of the short txids of the set of the responder, or its
+ * extension after a reqsketchext.
+ */
+inline constexpr const char* SKETCH{"sketch"};
+/**
+ * Requests an extension of the sketch when the set difference could not be
+ * decoded from it.
+ */
+inline constexpr const char* REQSKETCHEXT{"reqsketchext"};
+/**
+ * Ends a txreconciliation round. Contains whether it succeeded and the short
+ * txids the initiator is missing.
+ */
+inline constexpr const char* RECONCILDIFF{"reconcildiff"};
 
 //////////////////////////////////////////////////
 // WATTx Trust Tier System Messages
@@ -296,6 +317,28 @@ inline constexpr const char* VALIDATORS{"validators"};
  */
 inline constexpr const char* REGVALIDATOR{"regvalidator"};
 
+/**
+ * The equivocation message carries two conflicting proof-of-stake headers
+ * signed by the same staker for the same slot, as evidence of equivocation.
+ * @since WATTx protocol version 1.
+ */
+inline constexpr const char* EQUIVOCATION{"equivocation"};
+
+/**
+ * The getevmstate message requests EVM state trie nodes, contract code and
+ * trie key preimages by their hash, to sync the EVM state of a recent block.
+ * Only available with service bit NODE_EVM_STATE.
+ * @since WATTx protocol version 1.
+ */
+inline constexpr const char* GETEVMSTATE{"getevmstate"};
+
+/**
+ * The evmstate message contains the data of a getevmstate request in the
+ * order of the request, with empty entries for unknown hashes.
+ * @since WATTx protocol version 1.
+ */
+inline constexpr const char* EVMSTATE{"evmstate"};
+
 }; // namespace NetMsgType
 
 /** All known message types (see above). Keep this in the same order as the list of messages above. */
@@ -335,11 +378,18 @@ inline const std::array ALL_NET_MESSAGE_TYPES{std::to_array<std::string>({
     NetMsgType::CFCHECKPT,
     NetMsgType::WTXIDRELAY,
     NetMsgType::SENDTXRCNCL,
+    NetMsgType::REQRECON,
+    NetMsgType::SKETCH,
+    NetMsgType::REQSKETCHEXT,
+    NetMsgType::RECONCILDIFF,
     // WATTx Trust Tier messages
     NetMsgType::HEARTBEAT,
     NetMsgType::GETVALIDATORS,
     NetMsgType::VALIDATORS,
     NetMsgType::REGVALIDATOR,
+    NetMsgType::EQUIVOCATION,
+    NetMsgType::GETEVMSTATE,
+    NetMsgType::EVMSTATE,
 })};
 
 /** nServices flags */
@@ -370,6 +420,10 @@ enum ServiceFlags : uint64_t {
     // participating in the tiered PoS consensus
     NODE_VALIDATOR = (1 << 12),
 
+    // WATTx: NODE_EVM_STATE means the node serves the EVM state of recent
+    // blocks with getevmstate
+    NODE_EVM_STATE = (1 << 13),
+
     // Bits 24-31 are reserved for temporary experiments. Just pick a bit that
     // isn't getting used, or one not being used much, and notify the
     // bitcoin-development mailing list. Remember that service bits are just
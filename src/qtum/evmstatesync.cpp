@@ -0,0 +1,269 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <qtum/evmstatesync.h>
+
+#include <util/convert.h>
+
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TrieCommon.h>
+
+#include <functional>
+#include <string>
+
+namespace qtum {
+
+std::vector<dev::bytes> LookupEVMState(dev::OverlayDB const& state_db, dev::OverlayDB const& utxo_db, std::vector<EVMStateRequest> const& requests, size_t max_size)
+{
+    std::vector<dev::bytes> result;
+    result.reserve(requests.size());
+    size_t size{0};
+    for (EVMStateRequest const& request : requests) {
+        dev::bytes& data = result.emplace_back();
+        if (size >= max_size)
+            continue;
+        dev::h256 const hash = uintToh256(request.hash);
+        switch (request.kind) {
+        case EVMStateRequest::STATE_NODE:
+            data = dev::asBytes(state_db.lookup(hash));
+            break;
+        case EVMStateRequest::UTXO_NODE:
+            data = dev::asBytes(utxo_db.lookup(hash));
+            break;
+        case EVMStateRequest::STATE_KEY:
+            data = state_db.tryLookupAux(hash);
+            break;
+        case EVMStateRequest::UTXO_KEY:
+            data = utxo_db.tryLookupAux(hash);
+            break;
+        }
+        size += data.size();
+    }
+    return result;
+}
+
+bool HasEVMState(dev::OverlayDB const& state_db, dev::OverlayDB const& utxo_db, uint256 const& state_root, uint256 const& utxo_root)
+{
+    dev::h256 const state = uintToh256(state_root);
+    dev::h256 const utxo = uintToh256(utxo_root);
+    return (state == dev::EmptyTrie || state_db.exists(state)) && (utxo == dev::EmptyTrie || utxo_db.exists(utxo));
+}
+
+EVMStateSync::EVMStateSync(dev::OverlayDB& state_db, dev::OverlayDB& utxo_db)
+    : m_state_db(state_db), m_utxo_db(utxo_db)
+{
+}
+
+void EVMStateSync::SetTarget(uint256 const& block_hash, uint256 const& state_root, uint256 const& utxo_root)
+{
+    // Whatever was stored for the previous target stays, so only the parts
+    // of the tries that changed since are downloaded again
+    m_block_hash = block_hash;
+    m_stats.block_hash = block_hash;
+    m_pending.clear();
+    m_queue.clear();
+    Schedule({EVMStateRequest::STATE_NODE, state_root}, Type::ACCOUNT, {}, nullptr);
+    Schedule({EVMStateRequest::UTXO_NODE, utxo_root}, Type::UTXO, {}, nullptr);
+}
+
+std::vector<EVMStateRequest> EVMStateSync::NextRequests(size_t max)
+{
+    // Depth first: the latest scheduled requests are the children of the
+    // latest received nodes, finishing their subtrees keeps m_pending small
+    std::vector<EVMStateRequest> requests;
+    while (requests.size() < max && !m_queue.empty()) {
+        EVMStateRequest request = m_queue.back();
+        m_queue.pop_back();
+        auto it = m_pending.find(request);
+        if (it != m_pending.end() && it->second.data.empty())
+            requests.push_back(request);
+    }
+    return requests;
+}
+
+bool EVMStateSync::ProcessResponse(std::vector<EVMStateRequest> const& requests, std::vector<dev::bytes> const& data)
+{
+    if (data.size() != requests.size()) {
+        Retry(requests);
+        return false;
+    }
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!data[i].empty() && dev::sha3(data[i]) != uintToh256(requests[i].hash)) {
+            Retry(requests);
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto it = m_pending.find(requests[i]);
+        if (it == m_pending.end() || !it->second.data.empty())
+            continue;
+        if (data[i].empty()) {
+            m_queue.push_front(requests[i]);
+            continue;
+        }
+        it->second.data = data[i];
+        m_stats.bytes += data[i].size();
+        ScheduleChildren(requests[i], it->second);
+        if (it->second.children == 0)
+            Store(requests[i]);
+    }
+    m_state_db.commit();
+    m_utxo_db.commit();
+    return true;
+}
+
+void EVMStateSync::Retry(std::vector<EVMStateRequest> const& requests)
+{
+    for (auto request = requests.rbegin(); request != requests.rend(); ++request) {
+        auto it = m_pending.find(*request);
+        if (it != m_pending.end() && it->second.data.empty())
+            m_queue.push_back(*request);
+    }
+}
+
+EVMStateSync::Stats EVMStateSync::GetStats() const
+{
+    Stats stats{m_stats};
+    stats.pending = m_pending.size();
+    stats.complete = IsComplete();
+    return stats;
+}
+
+bool EVMStateSync::IsStored(EVMStateRequest const& request) const
+{
+    dev::h256 const hash = uintToh256(request.hash);
+    switch (request.kind) {
+    case EVMStateRequest::STATE_NODE:
+        return hash == dev::EmptyTrie || hash == dev::EmptySHA3 || m_state_db.exists(hash);
+    case EVMStateRequest::UTXO_NODE:
+        return hash == dev::EmptyTrie || m_utxo_db.exists(hash);
+    case EVMStateRequest::STATE_KEY:
+        return !m_state_db.tryLookupAux(hash).empty();
+    case EVMStateRequest::UTXO_KEY:
+        return !m_utxo_db.tryLookupAux(hash).empty();
+    }
+    return false;
+}
+
+void EVMStateSync::Schedule(EVMStateRequest const& request, Type type, std::vector<uint8_t> path, EVMStateRequest const* parent)
+{
+    if (IsStored(request))
+        return;
+    auto [it, inserted] = m_pending.try_emplace(request);
+    if (inserted) {
+        it->second.type = type;
+        it->second.path = std::move(path);
+        m_queue.push_back(request);
+    }
+    if (parent) {
+        it->second.parents.push_back(*parent);
+        ++m_pending.at(*parent).children;
+    }
+}
+
+void EVMStateSync::ScheduleChildren(EVMStateRequest const& request, Pending& pending)
+{
+    if (pending.type == Type::CODE || pending.type == Type::KEY)
+        return;
+    const EVMStateRequest::Kind kind = pending.type == Type::UTXO ? EVMStateRequest::UTXO_NODE : EVMStateRequest::STATE_NODE;
+
+    // Nodes shorter than 32 bytes are embedded in their parent and walked
+    // as part of it
+    std::function<void(dev::RLP const&, std::vector<uint8_t> const&)> walk;
+    auto child = [&](dev::RLP const& item, std::vector<uint8_t> const& path) {
+        if (item.isList()) {
+            walk(item, path);
+        } else if (item.size() == dev::h256::size) {
+            Schedule({kind, h256Touint(item.toHash<dev::h256>())}, pending.type, path, &request);
+        }
+    };
+    walk = [&](dev::RLP const& node, std::vector<uint8_t> const& path) {
+        if (!node.isList())
+            return;
+        if (node.itemCount() == 17) {
+            for (uint8_t i = 0; i < 16; ++i) {
+                std::vector<uint8_t> child_path{path};
+                child_path.push_back(i);
+                child(node[i], child_path);
+            }
+        } else if (node.itemCount() == 2 && node[0].isData() && !node[0].payload().empty()) {
+            dev::NibbleSlice const key = dev::keyOf(node);
+            std::vector<uint8_t> child_path{path};
+            for (unsigned i = 0; i < key.size(); ++i)
+                child_path.push_back(key[i]);
+            if (dev::isLeaf(node)) {
+                ScheduleLeaf(request, pending, child_path, node[1].payload());
+            } else {
+                child(node[1], child_path);
+            }
+        }
+    };
+
+    try {
+        walk(dev::RLP(pending.data), pending.path);
+    } catch (dev::Exception const&) {
+        // The data matches a hash committed to by the chain, so it can only
+        // be malformed if the chain is; store whatever could be read
+    }
+}
+
+void EVMStateSync::ScheduleLeaf(EVMStateRequest const& request, Pending& pending, std::vector<uint8_t> const& path, dev::bytesConstRef value)
+{
+    // The tries are keyed by the hash of the address or slot, which is the
+    // whole path down to a leaf
+    if (path.size() == 2 * dev::h256::size) {
+        dev::h256 key;
+        for (size_t i = 0; i < dev::h256::size; ++i)
+            key[i] = (path[2 * i] << 4) | path[2 * i + 1];
+        const EVMStateRequest::Kind kind = pending.type == Type::UTXO ? EVMStateRequest::UTXO_KEY : EVMStateRequest::STATE_KEY;
+        Schedule({kind, h256Touint(key)}, Type::KEY, {}, &request);
+    }
+
+    if (pending.type != Type::ACCOUNT)
+        return;
+    dev::RLP const account(value);
+    if (!account.isList() || account.itemCount() < 4)
+        return;
+    Schedule({EVMStateRequest::STATE_NODE, h256Touint(account[2].toHash<dev::h256>())}, Type::STORAGE, {}, &request);
+    Schedule({EVMStateRequest::STATE_NODE, h256Touint(account[3].toHash<dev::h256>())}, Type::CODE, {}, &request);
+}
+
+void EVMStateSync::Store(EVMStateRequest const& request)
+{
+    auto it = m_pending.find(request);
+    Pending& pending = it->second;
+    dev::h256 const hash = uintToh256(request.hash);
+    switch (request.kind) {
+    case EVMStateRequest::STATE_NODE:
+        m_state_db.insert(hash, &pending.data);
+        break;
+    case EVMStateRequest::UTXO_NODE:
+        m_utxo_db.insert(hash, &pending.data);
+        break;
+    case EVMStateRequest::STATE_KEY:
+        m_state_db.insertAux(hash, &pending.data);
+        break;
+    case EVMStateRequest::UTXO_KEY:
+        m_utxo_db.insertAux(hash, &pending.data);
+        break;
+    }
+    switch (pending.type) {
+    case Type::CODE: ++m_stats.codes; break;
+    case Type::KEY: ++m_stats.keys; break;
+    default: ++m_stats.nodes; break;
+    }
+
+    std::vector<EVMStateRequest> parents = std::move(pending.parents);
+    m_pending.erase(it);
+    for (EVMStateRequest const& parent : parents) {
+        auto parent_it = m_pending.find(parent);
+        if (parent_it != m_pending.end() && --parent_it->second.children == 0)
+            Store(parent);
+    }
+}
+
+} // namespace qtum
@@ -0,0 +1,156 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef QTUM_EVMSTATESYNC_H
+#define QTUM_EVMSTATESYNC_H
+
+#include <serialize.h>
+#include <uint256.h>
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/OverlayDB.h>
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+/**
+ * Download of the EVM state of a recent block from peers.
+ *
+ * The account state, contract storage and contract UTXO tries are fetched
+ * node by node from the roots in the block header. Every node, contract code
+ * and trie key is requested by its hash and checked against it, so the state
+ * is verified against the header roots as it arrives and a peer sending
+ * anything else is caught at once.
+ */
+namespace qtum {
+
+//! Maximum number of entries of a getevmstate message
+static constexpr size_t MAX_EVM_STATE_REQUEST{384};
+//! Maximum total size of the entries of an evmstate message
+static constexpr size_t MAX_EVM_STATE_RESPONSE_SIZE{2 << 20};
+
+struct EVMStateRequest {
+    enum Kind : uint8_t {
+        //! Node of the account or a storage trie, or contract code
+        STATE_NODE = 0,
+        //! Node of the contract UTXO trie
+        UTXO_NODE = 1,
+        //! Account address or storage slot hashed into the state tries
+        STATE_KEY = 2,
+        //! Address hashed into the contract UTXO trie
+        UTXO_KEY = 3,
+    };
+
+    uint8_t kind{STATE_NODE};
+    uint256 hash;
+
+    SERIALIZE_METHODS(EVMStateRequest, obj) { READWRITE(obj.kind, obj.hash); }
+
+    friend bool operator==(const EVMStateRequest& a, const EVMStateRequest& b) { return a.kind == b.kind && a.hash == b.hash; }
+    friend bool operator<(const EVMStateRequest& a, const EVMStateRequest& b) { return a.kind != b.kind ? a.kind < b.kind : a.hash < b.hash; }
+};
+
+/**
+ * Look up the data of a getevmstate request.
+ *
+ * @param[in] state_db  Database of the account and storage tries
+ * @param[in] utxo_db   Database of the contract UTXO trie
+ * @param[in] requests  Requested hashes
+ * @param[in] max_size  Total size after which no more data is returned
+ * @return one entry per request, empty when unknown or over max_size
+ */
+std::vector<dev::bytes> LookupEVMState(dev::OverlayDB const& state_db, dev::OverlayDB const& utxo_db, std::vector<EVMStateRequest> const& requests, size_t max_size = MAX_EVM_STATE_RESPONSE_SIZE);
+
+/**
+ * Whether the tries below a pair of state roots are stored. A root is only
+ * written by EVMStateSync once the tries below it are complete, so this
+ * holds for a synced state as well as for the state of connected blocks.
+ */
+bool HasEVMState(dev::OverlayDB const& state_db, dev::OverlayDB const& utxo_db, uint256 const& state_root, uint256 const& utxo_root);
+
+/**
+ * Fetches the tries below a pair of state roots into the local databases.
+ *
+ * A trie node is only written once everything below it is written, so a
+ * node found in the database always has its whole subtree. Nodes that are
+ * already known are not requested, which makes moving to the roots of a
+ * newer block only download the changes. Received data is written to the
+ * databases, so the caller must hold whatever lock protects them.
+ */
+class EVMStateSync
+{
+public:
+    struct Stats {
+        uint256 block_hash;
+        uint64_t nodes{0};
+        uint64_t codes{0};
+        uint64_t keys{0};
+        uint64_t bytes{0};
+        size_t pending{0};
+        bool complete{false};
+    };
+
+    EVMStateSync(dev::OverlayDB& state_db, dev::OverlayDB& utxo_db);
+
+    //! Start syncing to the roots of a block, dropping any unfinished work
+    void SetTarget(uint256 const& block_hash, uint256 const& state_root, uint256 const& utxo_root);
+
+    //! Next hashes to request, at most max of them
+    std::vector<EVMStateRequest> NextRequests(size_t max);
+
+    /**
+     * Add the data a peer returned for requests.
+     * Empty entries are requested again later.
+     * @return false if the peer sent data that does not match its hash
+     */
+    bool ProcessResponse(std::vector<EVMStateRequest> const& requests, std::vector<dev::bytes> const& data);
+
+    //! Requests that were not answered are requested again
+    void Retry(std::vector<EVMStateRequest> const& requests);
+
+    //! Whether everything below the roots of the target is stored
+    bool IsComplete() const { return !m_block_hash.IsNull() && m_pending.empty(); }
+
+    uint256 const& GetTarget() const { return m_block_hash; }
+    Stats GetStats() const;
+
+private:
+    enum class Type { ACCOUNT, STORAGE, UTXO, CODE, KEY };
+
+    struct Pending {
+        Type type;
+        //! Nibbles of the key hashes below a trie node
+        std::vector<uint8_t> path;
+        //! Received and checked data, kept until all children are stored
+        dev::bytes data;
+        //! Number of children not stored yet
+        size_t children{0};
+        //! Nodes waiting for this one
+        std::vector<EVMStateRequest> parents;
+    };
+
+    bool IsStored(EVMStateRequest const& request) const;
+    void Schedule(EVMStateRequest const& request, Type type, std::vector<uint8_t> path, EVMStateRequest const* parent);
+    void ScheduleChildren(EVMStateRequest const& request, Pending& pending);
+    void ScheduleLeaf(EVMStateRequest const& request, Pending& pending, std::vector<uint8_t> const& path, dev::bytesConstRef value);
+    void Store(EVMStateRequest const& request);
+
+    dev::OverlayDB& m_state_db;
+    dev::OverlayDB& m_utxo_db;
+
+    uint256 m_block_hash;
+    std::map<EVMStateRequest, Pending> m_pending;
+    //! Pending requests that are not being requested from a peer, taken
+    //! from the back so the tries are walked depth first. Requests a peer
+    //! did not have go to the front.
+    std::deque<EVMStateRequest> m_queue;
+    Stats m_stats;
+};
+
+} // namespace qtum
+
+#endif // QTUM_EVMSTATESYNC_H
@@ -92,7 +92,7 @@ ResultExecute QtumState::execute(EnvInfo const& _envInfo, SealEngineFace const&
             qtum::commit(cacheUTXO, stateUTXO, m_cache);
             cacheUTXO.clear();
             bool removeEmptyAccounts = _envInfo.number() >= _sealEngine.chainParams().EIP158ForkBlock;
-            commit(removeEmptyAccounts ? State::CommitBehaviour::RemoveEmptyAccounts : State::CommitBehaviour::KeepEmptyAccounts);
+            commitRecording(removeEmptyAccounts ? State::CommitBehaviour::RemoveEmptyAccounts : State::CommitBehaviour::KeepEmptyAccounts);
         }
     }
     catch(Exception const& _e){
@@ -101,7 +101,7 @@ ResultExecute QtumState::execute(EnvInfo const& _envInfo, SealEngineFace const&
         res.gasUsed = _t.gas();
         if(_chain.Height() < consensusParams.nFixUTXOCacheHFHeight  && _p != Permanence::Reverted){
             deleteAccounts(_sealEngine.deleteAddresses);
-            commit(CommitBehaviour::RemoveEmptyAccounts);
+            commitRecording(CommitBehaviour::RemoveEmptyAccounts);
         } else {
             m_cache.clear();
             cacheUTXO.clear();
@@ -314,12 +314,110 @@ void QtumState::validateTransfersWithChangeLog(){
 	transfers=validatedTransfers;
 }
 
+namespace {
+/// Read the fields of an account as stored in the state trie
+void readAccountState(std::string const& _rlp, bool& o_exists, uint64_t& o_nonce, uint256& o_balance, uint256& o_codeHash, h256& o_storageRoot)
+{
+    o_exists = !_rlp.empty();
+    if (!o_exists) {
+        o_nonce = 0;
+        o_balance = uint256();
+        o_codeHash = uint256();
+        o_storageRoot = EmptyTrie;
+        return;
+    }
+    RLP state(_rlp);
+    o_nonce = static_cast<uint64_t>(state[0].toInt<u256>());
+    o_balance = u256Touint(state[1].toInt<u256>());
+    o_storageRoot = state[2].toHash<h256>();
+    o_codeHash = h256Touint(state[3].toHash<h256>());
+}
+}
+
+void QtumState::commitRecording(CommitBehaviour _commitBehaviour)
+{
+    if (!m_stateDiff) {
+        commit(_commitBehaviour);
+        return;
+    }
+
+    // The trie still holds the state from before these changes. The first
+    // commit that touches an account in a block provides its old values,
+    // later ones only update the new values.
+    std::vector<std::pair<Address, AccountStateDiff*>> changed;
+    for (auto const& i : m_cache) {
+        Account const& acc = i.second;
+        if (!acc.isDirty())
+            continue;
+        auto [it, inserted] = m_stateDiff->try_emplace(i.first);
+        AccountStateDiff& diff = it->second;
+        bool exists;
+        uint64_t nonce;
+        uint256 balance, codeHash;
+        h256 storageRoot;
+        readAccountState(m_state.at(i.first), exists, nonce, balance, codeHash, storageRoot);
+        if (inserted) {
+            diff.address = h160Touint(i.first);
+            diff.existed = exists;
+            diff.old_nonce = nonce;
+            diff.old_balance = balance;
+            diff.old_code_hash = codeHash;
+        }
+
+        if (storageRoot != EmptyTrie && (!acc.isAlive() || acc.baseRoot() != storageRoot)) {
+            diff.storage_cleared = true;
+            for (auto& slot : diff.storage)
+                slot.second.second = uint256();
+        }
+        if (acc.isAlive()) {
+            SecureTrieDB<h256, OverlayDB> const storage(const_cast<OverlayDB*>(&m_db), storageRoot);
+            for (auto const& [key, value] : acc.storageOverlay()) {
+                auto slot = diff.storage.try_emplace(u256Touint(key));
+                if (slot.second) {
+                    std::string const payload = storage.at(key);
+                    slot.first->second.first = u256Touint(payload.size() ? RLP(payload).toInt<u256>() : 0);
+                }
+                slot.first->second.second = u256Touint(value);
+            }
+            if (acc.hasNewCode())
+                diff.new_code = acc.code();
+        }
+        changed.emplace_back(i.first, &diff);
+    }
+
+    commit(_commitBehaviour);
+
+    // Accounts emptied by the commit are removed from the trie, so read the
+    // new values back from it
+    for (auto& [address, diff] : changed) {
+        h256 storageRoot;
+        readAccountState(m_state.at(address), diff->exists, diff->new_nonce, diff->new_balance, diff->new_code_hash, storageRoot);
+    }
+}
+
+std::vector<AccountStateDiff> QtumState::stopStateDiff()
+{
+    std::vector<AccountStateDiff> ret;
+    if (!m_stateDiff)
+        return ret;
+    for (auto& i : *m_stateDiff) {
+        AccountStateDiff& diff = i.second;
+        std::erase_if(diff.storage, [](auto const& slot) { return slot.second.first == slot.second.second; });
+        if (diff.old_code_hash == diff.new_code_hash || !diff.exists)
+            diff.new_code.clear();
+        if (!diff.IsUnchanged())
+            ret.push_back(std::move(diff));
+    }
+    m_stateDiff.reset();
+    return ret;
+}
+
 void QtumState::deployDelegationsContract(){
     dev::Address delegationsAddress = uintToh160(Params().GetConsensus().delegationsAddress);
     if(!QtumState::addressInUse(delegationsAddress)){
         QtumState::createContract(delegationsAddress);
         QtumState::setCode(delegationsAddress, bytes{fromHex(DELEGATIONS_CONTRACT_CODE)}, QtumState::version(delegationsAddress));
-        commit(CommitBehaviour::RemoveEmptyAccounts);
+        commitRecording(CommitBehaviour::RemoveEmptyAccounts);
         db().commit();
     }
 }
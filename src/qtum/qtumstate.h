@@ -9,10 +9,14 @@
 #include <util/convert.h>
 #include <primitives/transaction.h>
 #include <qtum/qtumtransaction.h>
+#include <qtum/statediff.h>
 
 #include <libethereum/Executive.h>
 #include <libethcore/SealEngine.h>
 
+#include <map>
+#include <optional>
+
 class CChain;
 
 using OnOpFunc = std::function<void(uint64_t, uint64_t, dev::eth::Instruction, dev::bigint, dev::bigint,
@@ -128,6 +132,12 @@ public:
 
     void deployDelegationsContract();
 
+    /// Record the accounts changed by the commits of execute() until stopStateDiff()
+    void startStateDiff() { m_stateDiff.emplace(); }
+
+    /// Stop recording and return the changes, sorted by address
+    std::vector<AccountStateDiff> stopStateDiff();
+
     virtual ~QtumState(){}
 
     friend CondensingTX;
@@ -152,6 +162,9 @@ private:
 
     void printfErrorLog(const dev::eth::TransactionException er);
 
+    /// Commit the cache, recording the changes if startStateDiff() was called
+    void commitRecording(CommitBehaviour _commitBehaviour);
+
     dev::Address newAddress;
 
     std::vector<TransferInfo> transfers;
@@ -163,6 +176,8 @@ private:
 	std::unordered_map<dev::Address, Vin> cacheUTXO;
 
 	void validateTransfersWithChangeLog();
+
+    std::optional<std::map<dev::Address, AccountStateDiff>> m_stateDiff;
 };
 
 
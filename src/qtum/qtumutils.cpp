@@ -1,13 +1,82 @@
 #include <qtum/qtumutils.h>
 #include <libdevcore/CommonData.h>
 #include <pubkey.h>
+#include <hash.h>
+#include <sync.h>
 #include <util/convert.h>
 #include <chainparams.h>
 #include <chain.h>
 
+#include <secp256k1.h>
+#include <secp256k1_recovery.h>
+
+#include <array>
+
 using namespace dev;
 
-bool qtumutils::btc_ecrecover(const dev::h256 &hash, const dev::u256 &v, const dev::h256 &r, const dev::h256 &s, dev::h256 &key)
+namespace {
+/**
+ * Recent btc_ecrecover results. Meta transactions and permits recover the
+ * same signature several times within a block, so a few entries are enough;
+ * they are searched linearly and the least recently used one is replaced.
+ */
+class EcrecoverCache
+{
+public:
+    static constexpr size_t SIZE{128};
+    //! Message hash, v, r and s
+    static constexpr size_t KEY_SIZE{32 + 1 + 32 + 32};
+    using Key = std::array<unsigned char, KEY_SIZE>;
+
+    bool get(const Key& key, bool& recovered, dev::h256& result)
+    {
+        LOCK(m_mutex);
+        for (Entry& entry : m_entries) {
+            if (entry.last_used && entry.key == key) {
+                entry.last_used = ++m_counter;
+                recovered = entry.recovered;
+                if (recovered) {
+                    result = entry.result;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void put(const Key& key, bool recovered, const dev::h256& result)
+    {
+        LOCK(m_mutex);
+        Entry* oldest = &m_entries[0];
+        for (Entry& entry : m_entries) {
+            if (entry.last_used < oldest->last_used) {
+                oldest = &entry;
+            }
+        }
+        oldest->key = key;
+        oldest->recovered = recovered;
+        oldest->result = result;
+        oldest->last_used = ++m_counter;
+    }
+
+private:
+    struct Entry {
+        Key key;
+        bool recovered{false};
+        dev::h256 result;
+        //! 0 for an unused entry
+        uint64_t last_used{0};
+    };
+
+    Mutex m_mutex;
+    std::array<Entry, SIZE> m_entries GUARDED_BY(m_mutex);
+    uint64_t m_counter GUARDED_BY(m_mutex){0};
+};
+
+EcrecoverCache g_ecrecover_cache;
+} // namespace
+
+bool qtumutils::btc_ecrecover_uncached(const dev::h256 &hash, const dev::u256 &v, const dev::h256 &r, const dev::h256 &s, dev::h256 &key)
 {
     // Check input parameters
     if(v >= 256)
@@ -16,28 +85,53 @@ bool qtumutils::btc_ecrecover(const dev::h256 &hash, const dev::u256 &v, const d
         return false;
     }
 
-    // Convert the data into format usable for btc
-    CPubKey pubKey;
-    std::vector<unsigned char> vchSig;
-    vchSig.push_back((unsigned char)v);
-    vchSig += r.asBytes();
-    vchSig += s.asBytes();
-    uint256 mesage = h256Touint(hash);
+    // Same as CPubKey::RecoverCompact on a compact signature of v, r and s,
+    // without copying the data into vectors
+    const unsigned char header = (unsigned char)v;
+    int recid = (header - 27) & 3;
+    bool fComp = ((header - 27) & 4) != 0;
+    unsigned char compact[64];
+    memcpy(compact, r.data(), 32);
+    memcpy(compact + 32, s.data(), 32);
+
+    secp256k1_ecdsa_recoverable_signature sig;
+    if(!secp256k1_ecdsa_recoverable_signature_parse_compact(secp256k1_context_static, &sig, compact, recid))
+        return false;
+    secp256k1_pubkey pubkey;
+    if(!secp256k1_ecdsa_recover(secp256k1_context_static, &pubkey, &sig, hash.data()))
+        return false;
 
-    // Recover public key from compact signature (65 bytes)
     // The public key can be compressed (33 bytes) or uncompressed (65 bytes)
     // Pubkeyhash is RIPEMD160 hash of the public key, handled both types
-    if(pubKey.RecoverCompact(mesage, vchSig))
-    {
-        // Get the pubkeyhash
-        CKeyID id = pubKey.GetID();
-        size_t padding = sizeof(key) - sizeof(id);
-        memset(key.data(), 0, padding);
-        memcpy(key.data() + padding, id.begin(), sizeof(id));
-        return true;
-    }
+    unsigned char pub[CPubKey::SIZE];
+    size_t publen = CPubKey::SIZE;
+    secp256k1_ec_pubkey_serialize(secp256k1_context_static, pub, &publen, &pubkey, fComp ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED);
+    unsigned char id[CHash160::OUTPUT_SIZE];
+    CHash160().Write({pub, publen}).Finalize(id);
+    size_t padding = sizeof(key) - sizeof(id);
+    memset(key.data(), 0, padding);
+    memcpy(key.data() + padding, id, sizeof(id));
+    return true;
+}
 
-    return false;
+bool qtumutils::btc_ecrecover(const dev::h256 &hash, const dev::u256 &v, const dev::h256 &r, const dev::h256 &s, dev::h256 &key)
+{
+    if(v >= 256)
+        return false;
+
+    EcrecoverCache::Key cacheKey;
+    memcpy(cacheKey.data(), hash.data(), 32);
+    cacheKey[32] = (unsigned char)v;
+    memcpy(cacheKey.data() + 33, r.data(), 32);
+    memcpy(cacheKey.data() + 65, s.data(), 32);
+
+    bool recovered = false;
+    if(g_ecrecover_cache.get(cacheKey, recovered, key))
+        return recovered;
+
+    recovered = btc_ecrecover_uncached(hash, v, r, s, key);
+    g_ecrecover_cache.put(cacheKey, recovered, key);
+    return recovered;
 }
 
 struct EthChainIdCache
@@ -14,10 +14,23 @@ class CBlockIndex;
 namespace qtumutils
 {
 /**
- * @brief btc_ecrecover Wrapper to CPubKey::RecoverCompact
+ * @brief btc_ecrecover Recover the public key hash of a compact signature, same as
+ * CPubKey::RecoverCompact and CPubKey::GetID. Recent results are cached.
+ * @param hash Message hash
+ * @param v Compact signature header
+ * @param r Signature R
+ * @param s Signature S
+ * @param key Output public key hash, left padded to 32 bytes
+ * @return true if the public key was recovered
  */
 bool btc_ecrecover(dev::h256 const& hash, dev::u256 const& v, dev::h256 const& r, dev::h256 const& s, dev::h256 & key);
 
+/**
+ * @brief btc_ecrecover_uncached Recover the public key hash of a compact signature
+ * straight on libsecp256k1, without the cache of btc_ecrecover
+ */
+bool btc_ecrecover_uncached(dev::h256 const& hash, dev::u256 const& v, dev::h256 const& r, dev::h256 const& s, dev::h256 & key);
+
 
 /**
  * @brief The ChainIdType enum Chain Id values for the networks
@@ -0,0 +1,75 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef QTUM_STATEDIFF_H
+#define QTUM_STATEDIFF_H
+
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * Changes a block made to the EVM account state, as recorded while its
+ * contract transactions were committed.
+ *
+ * Addresses are the 20 bytes of the EVM address in order; balances, storage
+ * keys and values are 256-bit big-endian words.
+ */
+
+//! Changes to one account. Old values are those before the block, new values
+//! those after it.
+struct AccountStateDiff {
+    uint160 address;
+    bool existed{false};
+    bool exists{false};
+    uint64_t old_nonce{0};
+    uint64_t new_nonce{0};
+    uint256 old_balance;
+    uint256 new_balance;
+    uint256 old_code_hash;
+    uint256 new_code_hash;
+    //! Code deployed by the block, empty if the code did not change
+    std::vector<unsigned char> new_code;
+    //! The storage of the account was wiped, by a self-destruct or because
+    //! the address was reused. Slots that the block did not set again are
+    //! gone without being listed in storage.
+    bool storage_cleared{false};
+    //! Changed storage slots: key -> (old value, new value)
+    std::map<uint256, std::pair<uint256, uint256>> storage;
+
+    //! Whether the block left the account as it found it
+    bool IsUnchanged() const
+    {
+        return existed == exists && old_nonce == new_nonce && old_balance == new_balance &&
+               old_code_hash == new_code_hash && !storage_cleared && storage.empty();
+    }
+
+    SERIALIZE_METHODS(AccountStateDiff, obj)
+    {
+        READWRITE(obj.address, obj.existed, obj.exists, obj.old_nonce, obj.new_nonce, obj.old_balance, obj.new_balance,
+                  obj.old_code_hash, obj.new_code_hash, obj.new_code, obj.storage_cleared, obj.storage);
+    }
+};
+
+//! Changes made by one block, accounts sorted by address
+struct BlockStateDiff {
+    uint256 block_hash;
+    int32_t height{0};
+    std::vector<AccountStateDiff> accounts;
+    //! False when the changes of the block were not recorded, because it was
+    //! connected before the node started or too long ago. The accounts are
+    //! then empty, which does not mean that the block changed nothing.
+    bool available{true};
+
+    SERIALIZE_METHODS(BlockStateDiff, obj)
+    {
+        READWRITE(obj.block_hash, obj.height, obj.available, obj.accounts);
+    }
+};
+
+#endif // QTUM_STATEDIFF_H
@@ -0,0 +1,154 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <qtum/statediffjournal.h>
+
+#include <chain.h>
+#include <kernel/chain.h>
+#include <logging.h>
+#include <serialize.h>
+#include <streams.h>
+#include <tinyformat.h>
+#include <util/check.h>
+#include <util/strencodings.h>
+
+#include <cstdio>
+#include <ios>
+#include <string>
+#include <system_error>
+#include <utility>
+
+std::unique_ptr<StateDiffJournal> g_state_diff_journal;
+
+StateDiffJournal::StateDiffJournal(fs::path dir, uint64_t max_size, uint64_t file_size)
+    : m_dir{std::move(dir)}, m_max_size{max_size}, m_file_size{file_size}
+{
+    if (!IsJournaling()) return;
+    fs::create_directories(m_dir);
+
+    LOCK(m_mutex);
+    std::optional<uint32_t> first, last;
+    for (const auto& entry : fs::directory_iterator(m_dir)) {
+        const std::string name{fs::PathToString(entry.path().filename())};
+        if (name.size() != 13 || !name.starts_with("diff") || !name.ends_with(".dat")) continue;
+        const auto index{ToIntegral<uint32_t>(name.substr(4, 5))};
+        if (!index) continue;
+        if (!first || *index < *first) first = index;
+        if (!last || *index > *last) last = index;
+    }
+    if (!last) return;
+
+    // Continue the sequence of the newest file. Its last record may have been
+    // cut short by a crash, so new records go to a new file.
+    AutoFile file{fsbridge::fopen(FilePath(*last), "rb")};
+    try {
+        while (!file.IsNull()) {
+            std::vector<std::byte> record(ReadCompactSize(file));
+            file.read(record);
+            DataStream stream{record};
+            uint8_t label;
+            uint64_t sequence;
+            stream >> label >> sequence;
+            m_sequence = sequence + 1;
+        }
+    } catch (const std::ios_base::failure&) {
+    }
+    m_first_file = *first;
+    m_last_file = *last + 1;
+}
+
+fs::path StateDiffJournal::FilePath(uint32_t index) const
+{
+    return m_dir / fs::u8path(strprintf("diff%05u.dat", index));
+}
+
+void StateDiffJournal::Add(BlockStateDiff diff)
+{
+    LOCK(m_mutex);
+    const int32_t height{diff.height};
+    std::erase_if(m_diffs, [height](const auto& entry) { return entry.second.height <= height - MEMORY_BLOCKS; });
+    m_diffs.insert_or_assign(diff.block_hash, std::move(diff));
+}
+
+std::optional<BlockStateDiff> StateDiffJournal::Get(const uint256& block_hash) const
+{
+    LOCK(m_mutex);
+    const auto it{m_diffs.find(block_hash)};
+    if (it == m_diffs.end()) return std::nullopt;
+    return it->second;
+}
+
+static BlockStateDiff UnavailableDiff(const CBlockIndex& index)
+{
+    BlockStateDiff diff{index.GetBlockHash(), index.nHeight, {}};
+    diff.available = false;
+    return diff;
+}
+
+BlockStateDiff StateDiffJournal::GetOrUnavailable(const CBlockIndex& index) const
+{
+    if (std::optional<BlockStateDiff> diff{Get(index.GetBlockHash())}) return std::move(*diff);
+    return UnavailableDiff(index);
+}
+
+void StateDiffJournal::Append(char label, const CBlockIndex& index)
+{
+    AssertLockHeld(m_mutex);
+    DataStream record;
+    record << uint8_t(label) << m_sequence;
+    if (const auto it{m_diffs.find(index.GetBlockHash())}; it != m_diffs.end()) {
+        record << it->second;
+    } else {
+        record << UnavailableDiff(index);
+    }
+
+    std::error_code ec;
+    if (fs::file_size(FilePath(m_last_file), ec) >= m_file_size && !ec) ++m_last_file;
+    AutoFile file{fsbridge::fopen(FilePath(m_last_file), "ab")};
+    if (file.IsNull()) {
+        LogError("Unable to open state diff journal file %s\n", fs::PathToString(FilePath(m_last_file)));
+        return;
+    }
+    try {
+        WriteCompactSize(file, record.size());
+        file.write(MakeByteSpan(record));
+    } catch (const std::ios_base::failure& e) {
+        LogError("Unable to write to state diff journal: %s\n", e.what());
+        return;
+    }
+    if (file.fclose() != 0) {
+        LogError("Unable to close state diff journal file %s\n", fs::PathToString(FilePath(m_last_file)));
+        return;
+    }
+    ++m_sequence;
+
+    // Drop the oldest files, never the one being written
+    uint64_t total{0};
+    for (uint32_t i = m_first_file; i <= m_last_file; ++i) {
+        const uint64_t size{fs::file_size(FilePath(i), ec)};
+        if (!ec) total += size;
+        ec.clear();
+    }
+    while (total > m_max_size && m_first_file < m_last_file) {
+        const uint64_t size{fs::file_size(FilePath(m_first_file), ec)};
+        if (!ec) total -= size;
+        ec.clear();
+        fs::remove(FilePath(m_first_file), ec);
+        ++m_first_file;
+    }
+}
+
+void StateDiffJournal::BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    if (role == ChainstateRole::BACKGROUND || !IsJournaling()) return;
+    LOCK(m_mutex);
+    Append(/* Block (C)onnect */ 'C', *Assert(pindex));
+}
+
+void StateDiffJournal::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    if (!IsJournaling()) return;
+    LOCK(m_mutex);
+    Append(/* Block (D)isconnect */ 'D', *Assert(pindex));
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef QTUM_STATEDIFFJOURNAL_H
+#define QTUM_STATEDIFFJOURNAL_H
+
+#include <qtum/statediff.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/fs.h>
+#include <validationinterface.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+
+class CBlock;
+class CBlockIndex;
+
+//! Default size of the on-disk state change journal in MiB, 0 disables it
+static constexpr int64_t DEFAULT_STATE_DIFF_JOURNAL{0};
+
+/**
+ * Keeps the EVM state changes recorded while connecting blocks, so they can be
+ * published without executing the blocks again.
+ *
+ * The changes of recent blocks are held in memory for the ZMQ notifier. When
+ * enabled, the journal also appends every connection and disconnection of a
+ * block of the active chain to files in its directory, in the order they
+ * happen. Each record is
+ *
+ *     <compact size of the rest> <label 'C' or 'D'> <uint64 sequence> <BlockStateDiff>
+ *
+ * where the sequence number counts records across files and restarts. A
+ * disconnection record carries the changes that are being undone, so a reader
+ * can revert them without keeping its own history. The changes of blocks
+ * connected before the node started, or more than MEMORY_BLOCKS before the
+ * newest, are not known and their records are marked unavailable. A new diff<nnnnn>.dat
+ * file is started every few MiB, and the oldest files are deleted to keep
+ * the journal within its size.
+ */
+class StateDiffJournal final : public CValidationInterface
+{
+public:
+    //! Number of blocks back from the newest whose changes stay in memory
+    static constexpr int MEMORY_BLOCKS{144};
+    //! Default size at which a new journal file is started
+    static constexpr uint64_t FILE_SIZE{16 << 20};
+
+    /**
+     * @param[in] dir       Directory of the journal files
+     * @param[in] max_size  Total size of journal files to keep, 0 to only keep
+     *                      changes in memory
+     * @param[in] file_size Size at which a new journal file is started
+     */
+    StateDiffJournal(fs::path dir, uint64_t max_size, uint64_t file_size = FILE_SIZE);
+
+    //! Record the changes of a block connected by ConnectBlock
+    void Add(BlockStateDiff diff) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Changes of a block, if it was connected recently
+    std::optional<BlockStateDiff> Get(const uint256& block_hash) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Changes of a block, marked unavailable if they are not in memory
+    BlockStateDiff GetOrUnavailable(const CBlockIndex& index) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    bool IsJournaling() const { return m_max_size > 0; }
+
+protected:
+    void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    fs::path FilePath(uint32_t index) const;
+    void Append(char label, const CBlockIndex& index) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    const fs::path m_dir;
+    const uint64_t m_max_size;
+    const uint64_t m_file_size;
+
+    mutable Mutex m_mutex;
+    std::map<uint256, BlockStateDiff> m_diffs GUARDED_BY(m_mutex);
+    uint32_t m_first_file GUARDED_BY(m_mutex){0};
+    uint32_t m_last_file GUARDED_BY(m_mutex){0};
+    uint64_t m_sequence GUARDED_BY(m_mutex){0};
+};
+
+//! Set when state changes are published or journaled; ConnectBlock only
+//! records changes while it is
+extern std::unique_ptr<StateDiffJournal> g_state_diff_journal;
+
+#endif // QTUM_STATEDIFFJOURNAL_H
@@ -0,0 +1,137 @@
+#include <qtum/stateproof.h>
+
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TrieCommon.h>
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+
+namespace qtum {
+
+namespace {
+
+using NodeLookup = std::function<bool(dev::h256 const&, std::string&)>;
+
+/**
+ * Follow key from root the same way GenericTrieDB::atAux does, fetching every
+ * node that is referenced by hash through lookup.
+ * Returns false if a node is missing or malformed.
+ */
+bool WalkTrie(dev::h256 const& root, dev::h256 const& hashedKey, NodeLookup const& lookup, dev::bytes& value)
+{
+    value.clear();
+    if (root == dev::EmptyTrie)
+        return true;
+
+    std::string data;
+    if (!lookup(root, data))
+        return false;
+    dev::RLP here(data);
+    dev::NibbleSlice key(hashedKey.ref());
+
+    while (true) {
+        if (here.isEmpty() || here.isNull())
+            return true;
+        if (!here.isList())
+            return false;
+
+        dev::RLP next;
+        size_t itemCount = here.itemCount();
+        if (itemCount == 2) {
+            if (!here[0].isData() || here[0].payload().empty())
+                return false;
+            dev::NibbleSlice k = dev::keyOf(here);
+            bool leaf = dev::isLeaf(here);
+            if (leaf && key == k) {
+                value = here[1].toBytes();
+                return true;
+            }
+            if (leaf || !key.contains(k))
+                return true;
+            next = here[1];
+            key = key.mid(k.size());
+        } else if (itemCount == 17) {
+            if (key.empty()) {
+                value = here[16].toBytes();
+                return true;
+            }
+            next = here[key[0]];
+            if (next.isEmpty())
+                return true;
+            key = key.mid(1);
+        } else {
+            return false;
+        }
+
+        if (next.isList()) {
+            // Nodes shorter than 32 bytes are embedded in their parent
+            here = next;
+            continue;
+        }
+        if (next.size() != dev::h256::size)
+            return false;
+        std::string child;
+        if (!lookup(next.toHash<dev::h256>(), child))
+            return false;
+        data = std::move(child);
+        here = dev::RLP(data);
+    }
+}
+
+} // namespace
+
+bool ProveTrieKeys(dev::OverlayDB const& db, dev::h256 const& root, std::vector<dev::bytes> const& keys, std::vector<dev::bytes>& values, std::vector<dev::bytes>& nodes)
+{
+    values.clear();
+    nodes.clear();
+
+    std::set<dev::h256> seen;
+    NodeLookup lookup = [&](dev::h256 const& hash, std::string& out) {
+        out = db.lookup(hash);
+        if (out.empty())
+            return false;
+        if (seen.insert(hash).second)
+            nodes.emplace_back(out.begin(), out.end());
+        return true;
+    };
+
+    try {
+        for (dev::bytes const& key : keys) {
+            dev::bytes value;
+            if (!WalkTrie(root, dev::sha3(key), lookup, value))
+                return false;
+            values.push_back(std::move(value));
+        }
+    } catch (dev::Exception const&) {
+        return false;
+    }
+    return true;
+}
+
+bool VerifyTrieProof(dev::h256 const& root, std::vector<dev::bytes> const& nodes, dev::bytesConstRef key, dev::bytes& value)
+{
+    std::map<dev::h256, dev::bytes const*> byHash;
+    for (dev::bytes const& node : nodes)
+        byHash.emplace(dev::sha3(node), &node);
+
+    NodeLookup lookup = [&](dev::h256 const& hash, std::string& out) {
+        auto it = byHash.find(hash);
+        if (it == byHash.end())
+            return false;
+        out.assign(it->second->begin(), it->second->end());
+        return true;
+    };
+
+    try {
+        return WalkTrie(root, dev::sha3(key), lookup, value);
+    } catch (dev::Exception const&) {
+        value.clear();
+        return false;
+    }
+}
+
+} // namespace qtum
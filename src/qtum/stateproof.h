@@ -0,0 +1,45 @@
+#ifndef QTUM_STATEPROOF_H
+#define QTUM_STATEPROOF_H
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/OverlayDB.h>
+
+#include <vector>
+
+/**
+ * Merkle proofs against the secure (key-hashed) Patricia tries used for the
+ * EVM account state, contract storage and the contract UTXO set.
+ *
+ * A proof is the set of trie nodes on the paths from the root to the
+ * requested keys. It proves presence as well as absence of a key, and
+ * several keys of the same trie share the nodes of their common prefix.
+ */
+namespace qtum {
+
+/**
+ * Collect a proof for keys in the trie with the given root.
+ *
+ * @param[in]  db      Database holding the trie nodes
+ * @param[in]  root    Root hash of the trie
+ * @param[in]  keys    Unhashed keys, e.g. an address or a 32 byte storage slot
+ * @param[out] values  Value stored under each key, empty when absent
+ * @param[out] nodes   RLP encoded trie nodes, root first, without duplicates
+ * @return false if a node on one of the paths is missing from db
+ */
+bool ProveTrieKeys(dev::OverlayDB const& db, dev::h256 const& root, std::vector<dev::bytes> const& keys, std::vector<dev::bytes>& values, std::vector<dev::bytes>& nodes);
+
+/**
+ * Look up key in the trie with the given root using only the nodes of a proof.
+ *
+ * @param[in]  root   Root hash of the trie
+ * @param[in]  nodes  RLP encoded trie nodes, in any order
+ * @param[in]  key    Unhashed key
+ * @param[out] value  Value stored under key, empty when the proof shows it is absent
+ * @return false if the proof does not reach a conclusion for key
+ */
+bool VerifyTrieProof(dev::h256 const& root, std::vector<dev::bytes> const& nodes, dev::bytesConstRef key, dev::bytes& value);
+
+} // namespace qtum
+
+#endif // QTUM_STATEPROOF_H
@@ -2,6 +2,26 @@
 #include <util/convert.h>
 #include <logging.h>
 
+#include <map>
+#include <memory>
+
+// Receipts are stored by the hex of the transaction hash, so keys of other
+// records start with an upper case letter
+static const std::string DB_HEIGHT_RESULTS{"H"};
+static const std::string DB_PRUNED_HEIGHT{"P"};
+static const std::string DB_RESULTS_SIZE{"S"};
+static const std::string DB_ALL_RECORDED{"R"};
+
+static std::string HeightResultsKey(uint32_t height)
+{
+    // Big endian so that the records are ordered by height
+    std::string key{DB_HEIGHT_RESULTS};
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        key.push_back(char((height >> shift) & 0xff));
+    }
+    return key;
+}
+
 StorageResults::StorageResults(std::string const& _path){
 	path = _path + "/resultsDB";
     leveldb::Options options;
@@ -9,6 +29,7 @@ StorageResults::StorageResults(std::string const& _path){
     leveldb::Status status = leveldb::DB::Open(options, path, &db);
     assert(status.ok());
     LogPrintf("Opened LevelDB successfully\n");
+    readCounters();
 }
 
 StorageResults::~StorageResults()
@@ -38,19 +59,79 @@ void StorageResults::wipeResults(){
         leveldb::Status status = leveldb::DB::Open(options, path, &db);
         assert(status.ok());
     }
+    m_pruned_height = -1;
+    m_results_size = 0;
+    m_all_recorded = true;
 }
 
-void StorageResults::deleteResults(std::vector<CTransactionRef> const& txs){
+void StorageResults::deleteResults(std::vector<CTransactionRef> const& txs, uint32_t height){
+
+    // The disconnected block is the last one at its height. Receipts that
+    // were committed before they were recorded by height are counted by
+    // their stored size.
+    std::set<dev::h256> recorded;
+    for (auto const& [hashTx, size] : readHeightResults(height)) {
+        m_results_size -= std::min(m_results_size, size);
+        recorded.insert(hashTx);
+    }
 
     for(CTransactionRef tx : txs){
         dev::h256 hashTx = uintToh256(tx->GetHash());
         m_cache_result.erase(hashTx);
+        if (!recorded.count(hashTx)) {
+            m_results_size -= std::min(m_results_size, readResultSize(hashTx));
+        }
 
         std::string keyTemp = hashTx.hex();
 	    leveldb::Slice key(keyTemp);
         leveldb::Status status = db->Delete(leveldb::WriteOptions(), key);
         assert(status.ok());
     }
+
+    leveldb::WriteBatch batch;
+    writeHeightResults(batch, height, {});
+    writeCounters(batch);
+    leveldb::Status status = db->Write(leveldb::WriteOptions(), &batch);
+    assert(status.ok());
+}
+
+void StorageResults::pruneResults(uint32_t height, std::vector<CTransactionRef> const& txs, std::set<dev::h256> const& keep){
+
+    leveldb::WriteBatch batch;
+    auto prune = [&](dev::h256 const& hashTx) {
+        m_cache_result.erase(hashTx);
+        batch.Delete(hashTx.hex());
+    };
+
+    std::set<dev::h256> recorded;
+    std::vector<std::pair<dev::h256, uint64_t>> kept;
+    for (auto const& [hashTx, size] : readHeightResults(height)) {
+        recorded.insert(hashTx);
+        if (keep.count(hashTx)) {
+            kept.emplace_back(hashTx, size);
+        } else {
+            prune(hashTx);
+            m_results_size -= std::min(m_results_size, size);
+        }
+    }
+    for (CTransactionRef const& tx : txs) {
+        dev::h256 hashTx = uintToh256(tx->GetHash());
+        if (!keep.count(hashTx) && !recorded.count(hashTx)) {
+            m_results_size -= std::min(m_results_size, readResultSize(hashTx));
+            prune(hashTx);
+        }
+    }
+
+    writeHeightResults(batch, height, kept);
+    m_pruned_height = height;
+    writeCounters(batch);
+    leveldb::Status status = db->Write(leveldb::WriteOptions(), &batch);
+    assert(status.ok());
+}
+
+bool StorageResults::isHeightRecorded(uint32_t height){
+    std::string value;
+    return m_all_recorded || db->Get(leveldb::ReadOptions(), HeightResultsKey(height), &value).ok();
 }
 
 std::vector<TransactionReceiptInfo> StorageResults::getResult(dev::h256 const& hashTx){
@@ -68,6 +149,8 @@ std::vector<TransactionReceiptInfo> StorageResults::getResult(dev::h256 const& h
 void StorageResults::commitResults(){
     if(m_cache_result.size()){
 
+        std::map<uint32_t, std::vector<std::pair<dev::h256, uint64_t>>> heightResults;
+
         for (auto const& i: m_cache_result){
             std::string valueTemp;
             std::string keyTemp = i.first.hex();
@@ -108,10 +191,106 @@ void StorageResults::commitResults(){
                 leveldb::Slice value(stringData);
                 status = db->Put(leveldb::WriteOptions(), key, value);
                 assert(status.ok());
+
+                if(i.second.size()){
+                    heightResults[i.second[0].blockNumber].emplace_back(i.first, keyTemp.size() + stringData.size());
+                }
             }
         }
         m_cache_result.clear();
+
+        if(heightResults.size()){
+            leveldb::WriteBatch batch;
+            for (auto& [height, results] : heightResults) {
+                for (auto const& [hashTx, size] : results) {
+                    m_results_size += size;
+                }
+                std::vector<std::pair<dev::h256, uint64_t>> stored = readHeightResults(height);
+                results.insert(results.begin(), stored.begin(), stored.end());
+                writeHeightResults(batch, height, results);
+            }
+            writeCounters(batch);
+            leveldb::Status status = db->Write(leveldb::WriteOptions(), &batch);
+            assert(status.ok());
+        }
+    }
+}
+
+std::vector<std::pair<dev::h256, uint64_t>> StorageResults::readHeightResults(uint32_t height){
+    std::vector<std::pair<dev::h256, uint64_t>> results;
+    std::string value;
+    leveldb::Status s = db->Get(leveldb::ReadOptions(), HeightResultsKey(height), &value);
+    if(s.ok()){
+        for (dev::RLP const& item : dev::RLP(value)) {
+            results.emplace_back(item[0].toHash<dev::h256>(), item[1].toInt<uint64_t>());
+        }
+    }
+    return results;
+}
+
+void StorageResults::writeHeightResults(leveldb::WriteBatch& batch, uint32_t height, std::vector<std::pair<dev::h256, uint64_t>> const& results){
+    if(results.empty()){
+        batch.Delete(HeightResultsKey(height));
+        return;
+    }
+    dev::RLPStream streamRLP(results.size());
+    for (auto const& [hashTx, size] : results) {
+        streamRLP.appendList(2) << hashTx << size;
+    }
+    dev::bytes data = streamRLP.out();
+    batch.Put(HeightResultsKey(height), std::string(data.begin(), data.end()));
+}
+
+void StorageResults::writeCounters(leveldb::WriteBatch& batch){
+    // The pruned height is stored one up, so that it can not be negative
+    dev::bytes prunedHeight = dev::rlp(uint64_t(m_pruned_height + 1));
+    dev::bytes resultsSize = dev::rlp(m_results_size);
+    batch.Put(DB_PRUNED_HEIGHT, std::string(prunedHeight.begin(), prunedHeight.end()));
+    batch.Put(DB_RESULTS_SIZE, std::string(resultsSize.begin(), resultsSize.end()));
+}
+
+void StorageResults::readCounters(){
+    std::string value;
+    if(db->Get(leveldb::ReadOptions(), DB_PRUNED_HEIGHT, &value).ok()){
+        m_pruned_height = int(dev::RLP(value).toInt<uint64_t>()) - 1;
+    }
+    if(db->Get(leveldb::ReadOptions(), DB_RESULTS_SIZE, &value).ok()){
+        m_results_size = dev::RLP(value).toInt<uint64_t>();
+        m_all_recorded = db->Get(leveldb::ReadOptions(), DB_ALL_RECORDED, &value).ok();
+        return;
+    }
+
+    // The receipts of a database from before the size was recorded are
+    // counted once, so that the size limit covers them too
+    std::unique_ptr<leveldb::Iterator> it{db->NewIterator(leveldb::ReadOptions())};
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        char const first = it->key()[0];
+        if (first < 'A' || first > 'Z') {
+            m_results_size += it->key().size() + it->value().size();
+        }
+    }
+    assert(it->status().ok());
+    if (m_results_size > 0) {
+        LogPrintf("Counted %u bytes of stored receipts\n", m_results_size);
+    }
+    leveldb::WriteBatch batch;
+    if (m_results_size == 0) {
+        // A new database has every receipt recorded by height
+        m_all_recorded = true;
+        batch.Put(DB_ALL_RECORDED, "");
+    }
+    writeCounters(batch);
+    leveldb::Status status = db->Write(leveldb::WriteOptions(), &batch);
+    assert(status.ok());
+}
+
+uint64_t StorageResults::readResultSize(dev::h256 const& hashTx){
+    std::string keyTemp = hashTx.hex();
+    std::string value;
+    if(!db->Get(leveldb::ReadOptions(), keyTemp, &value).ok()){
+        return 0;
     }
+    return keyTemp.size() + value.size();
 }
 
 bool StorageResults::readResult(dev::h256 const& _key, std::vector<TransactionReceiptInfo>& _result){
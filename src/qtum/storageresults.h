@@ -3,8 +3,11 @@
 #include <libethereum/State.h>
 #include <libethereum/Transaction.h>
 #include <leveldb/db.h>
+#include <leveldb/write_batch.h>
 #include <common/system.h>
 
+#include <set>
+
 using logEntriesSerialize = std::vector<std::pair<dev::Address, std::pair<dev::h256s, dev::bytes>>>;
 
 struct TransactionReceiptInfo{
@@ -58,7 +61,7 @@ public:
 
 	void addResult(dev::h256 hashTx, std::vector<TransactionReceiptInfo>& result);
 
-    void deleteResults(std::vector<CTransactionRef> const& txs);
+    void deleteResults(std::vector<CTransactionRef> const& txs, uint32_t height);
 
     std::vector<TransactionReceiptInfo> getResult(dev::h256 const& hashTx);
 
@@ -68,8 +71,45 @@ public:
 
     void wipeResults();
 
+    /**
+     * Remove the receipts of the block at height, except those of the
+     * transactions in keep, and move the pruned height up to it. Heights
+     * must be pruned in order.
+     *
+     * @param height  Height of the block, one above getPrunedHeight()
+     * @param txs     Transactions of the block, for the receipts committed
+     *                before the receipts of each height were recorded
+     * @param keep    Transactions whose receipts stay
+     */
+    void pruneResults(uint32_t height, std::vector<CTransactionRef> const& txs, std::set<dev::h256> const& keep);
+
+    /**
+     * Whether the receipts of the block at height are all found through its
+     * height record, so that pruning it does not need the transactions of
+     * the block
+     */
+    bool isHeightRecorded(uint32_t height);
+
+    /** Height up to which receipts were pruned, -1 if none were */
+    int getPrunedHeight() const { return m_pruned_height; }
+
+    /** Size of the stored receipts, counted on the first start of a database from before it was recorded */
+    uint64_t getResultsSize() const { return m_results_size; }
+
 private:
 
+    /** Receipts committed at a height and their size */
+    std::vector<std::pair<dev::h256, uint64_t>> readHeightResults(uint32_t height);
+
+    void writeHeightResults(leveldb::WriteBatch& batch, uint32_t height, std::vector<std::pair<dev::h256, uint64_t>> const& results);
+
+    void writeCounters(leveldb::WriteBatch& batch);
+
+    void readCounters();
+
+    /** Stored size of the receipts of a transaction, 0 if there are none */
+    uint64_t readResultSize(dev::h256 const& hashTx);
+
 	bool readResult(dev::h256 const& _key, std::vector<TransactionReceiptInfo>& _result);
 
 	logEntriesSerialize logEntriesSerialization(dev::eth::LogEntries const& _logs);
@@ -81,4 +121,11 @@ private:
     leveldb::DB* db;
 
 	std::unordered_map<dev::h256, std::vector<TransactionReceiptInfo>> m_cache_result;
+
+    int m_pruned_height{-1};
+
+    uint64_t m_results_size{0};
+
+    /** Whether the database was created with the height records, so that no receipts are without one */
+    bool m_all_recorded{false};
 };
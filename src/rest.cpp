@@ -10,6 +10,7 @@
 #include <blockfilter.h>
 #include <chain.h>
 #include <chainparams.h>
+#include <common/json_stream.h>
 #include <core_io.h>
 #include <flatfile.h>
 #include <httpserver.h>
@@ -176,6 +177,13 @@ static std::string AvailableDataFormatsString()
     return formats;
 }
 
+/** Start a JSON reply whose body is serialized straight into the HTTP response */
+static JSONStreamWriter JSONReplyWriter(HTTPRequest* req)
+{
+    req->WriteHeader("Content-Type", "application/json");
+    return JSONStreamWriter{[req](std::string_view part, bool last) { req->WriteReplyPart(HTTP_OK, part, last); }};
+}
+
 static bool CheckWarmup(HTTPRequest* req)
 {
     std::string statusmessage;
@@ -341,10 +349,10 @@ static bool rest_block(const std::any& context,
         CBlock block{};
         DataStream block_stream{block_data};
         block_stream >> TX_WITH_WITNESS(block);
-        UniValue objBlock = blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
-        std::string strJSON = objBlock.write() + "\n";
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        JSONStreamWriter writer{JSONReplyWriter(req)};
+        blockToJSONStream(writer, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        writer.Raw("\n");
+        writer.Finish();
         return true;
     }
 
@@ -662,7 +670,7 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
 
     switch (rf) {
     case RESTResponseFormat::JSON: {
-        std::string str_json;
+        UniValue json;
         if (param == "contents") {
             std::string raw_verbose;
             try {
@@ -687,13 +695,15 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
             if (verbose && mempool_sequence) {
                 return RESTERR(req, HTTP_BAD_REQUEST, "Verbose results cannot contain mempool sequence values. (hint: set \"verbose=false\")");
             }
-            str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
+            json = MempoolToJSON(*mempool, verbose, mempool_sequence);
         } else {
-            str_json = MempoolInfoToJSON(*mempool).write() + "\n";
+            json = MempoolInfoToJSON(*mempool);
         }
 
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, str_json);
+        JSONStreamWriter writer{JSONReplyWriter(req)};
+        writer.Value(json);
+        writer.Raw("\n");
+        writer.Finish();
         return true;
     }
     default: {
@@ -1005,6 +1015,67 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
     }
 }
 
+static bool rest_proof(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, str_uri_part);
+    if (rf != RESTResponseFormat::JSON) {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+
+    // Parse /rest/proof/<blockhash>/<address>.json?slots=<slot>,<slot>
+    std::vector<std::string> uri_parts = SplitString(param, '/');
+    if (uri_parts.size() != 2) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/proof/<blockhash>/<address>.json");
+    }
+    auto block_hash{uint256::FromHex(uri_parts[0])};
+    if (!block_hash) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + uri_parts[0]);
+    }
+    if (uri_parts[1].size() != 40 || !IsHex(uri_parts[1])) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid address: " + uri_parts[1]);
+    }
+
+    std::vector<uint256> slots;
+    try {
+        const std::string raw_slots{req->GetQueryParameter("slots").value_or("")};
+        if (!raw_slots.empty()) {
+            for (const std::string& raw_slot : SplitString(raw_slots, ',')) {
+                std::optional<uint256> slot{ParseStorageSlot(raw_slot)};
+                if (!slot) {
+                    return RESTERR(req, HTTP_BAD_REQUEST, "Invalid storage slot: " + raw_slot);
+                }
+                slots.push_back(*slot);
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+    ChainstateManager& chainman = *maybe_chainman;
+
+    UniValue proof;
+    try {
+        LOCK(cs_main);
+        const CBlockIndex* pblockindex = chainman.m_blockman.LookupBlockIndex(*block_hash);
+        if (!pblockindex || !pblockindex->IsValid(BLOCK_VALID_SCRIPTS)) {
+            return RESTERR(req, HTTP_NOT_FOUND, uri_parts[0] + " not found");
+        }
+        proof = stateProofToJSON(*pblockindex, uint160(ParseHex(uri_parts[1])), slots);
+    } catch (const UniValue& e) {
+        return RESTERR(req, HTTP_NOT_FOUND, e.find_value("message").get_str());
+    }
+
+    JSONStreamWriter writer{JSONReplyWriter(req)};
+    writer.Value(proof);
+    writer.Raw("\n");
+    writer.Finish();
+    return true;
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
@@ -1021,6 +1092,7 @@ static const struct {
       {"/rest/deploymentinfo/", rest_deploymentinfo},
       {"/rest/deploymentinfo", rest_deploymentinfo},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/proof/", rest_proof},
 };
 
 void StartREST(const std::any& context)
@@ -12,6 +12,7 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <common/args.h>
+#include <common/json_stream.h>
 #include <consensus/amount.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
@@ -28,12 +29,14 @@
 #include <net.h>
 #include <net_processing.h>
 #include <node/blockstorage.h>
+#include <node/cache_warmup.h>
 #include <node/context.h>
 #include <node/transaction.h>
 #include <node/utxo_snapshot.h>
 #include <node/warnings.h>
 #include <key_io.h>
 #include <primitives/transaction.h>
+#include <rpc/response_cache.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
@@ -58,12 +61,14 @@
 #include <txdb.h>
 #include <util/convert.h>
 #include <qtum/qtumdelegation.h>
+#include <qtum/stateproof.h>
 #include <util/tokenstr.h>
 #include <rpc/contract_util.h>
 
 #include <stdint.h>
 
 #include <condition_variable>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -306,19 +311,13 @@ UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex
     return result;
 }
 
-UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+/** Convert each transaction of a block at the requested verbosity and pass it to fn */
+static void ForEachBlockTxJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& blockindex, TxVerbosity verbosity, const std::function<void(UniValue&&)>& fn)
 {
-    UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
-
-    result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
-    result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
-    result.pushKV("weight", (int)::GetBlockWeight(block));
-    UniValue txs(UniValue::VARR);
-
     switch (verbosity) {
         case TxVerbosity::SHOW_TXID:
             for (const CTransactionRef& tx : block.vtx) {
-                txs.push_back(tx->GetHash().GetHex());
+                fn(UniValue{tx->GetHash().GetHex()});
             }
             break;
 
@@ -336,16 +335,49 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
                 const CTxUndo* txundo = (have_undo && i > 0) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
                 UniValue objTx(UniValue::VOBJ);
                 TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, txundo, verbosity);
-                txs.push_back(std::move(objTx));
+                fn(std::move(objTx));
             }
             break;
     }
+}
+
+static UniValue blockSummaryToJSON(const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit)
+{
+    UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
+
+    result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
+    result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
+    result.pushKV("weight", (int)::GetBlockWeight(block));
+    return result;
+}
+
+UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    UniValue result = blockSummaryToJSON(block, tip, blockindex, pow_limit);
 
+    UniValue txs(UniValue::VARR);
+    ForEachBlockTxJSON(blockman, block, blockindex, verbosity, [&](UniValue&& tx) { txs.push_back(std::move(tx)); });
     result.pushKV("tx", std::move(txs));
 
     return result;
 }
 
+void blockToJSONStream(JSONStreamWriter& writer, BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    const UniValue summary = blockSummaryToJSON(block, tip, blockindex, pow_limit);
+
+    writer.BeginObject();
+    for (size_t i = 0; i < summary.size(); ++i) {
+        writer.Key(summary.getKeys()[i]);
+        writer.Value(summary.getValues()[i]);
+    }
+    writer.Key("tx");
+    writer.BeginArray();
+    ForEachBlockTxJSON(blockman, block, blockindex, verbosity, [&](UniValue&& tx) { writer.Value(tx); });
+    writer.EndArray();
+    writer.EndObject();
+}
+
 static RPCHelpMan getestimatedannualroi()
 {
     return RPCHelpMan{"getestimatedannualroi",
@@ -911,6 +943,186 @@ static RPCHelpMan getstorage()
     };
 }
 
+std::optional<uint256> ParseStorageSlot(const std::string& hex)
+{
+    if (hex.empty() || hex.size() > 64 || !IsHex(hex.size() % 2 ? "0" + hex : hex))
+        return std::nullopt;
+    return uint256(ParseHex(std::string(64 - hex.size(), '0') + hex));
+}
+
+static UniValue ProofNodesToJSON(const std::vector<dev::bytes>& nodes)
+{
+    UniValue result(UniValue::VARR);
+    for (const dev::bytes& node : nodes) {
+        result.push_back(HexStr(node));
+    }
+    return result;
+}
+
+UniValue stateProofToJSON(const CBlockIndex& blockindex, const uint160& address, const std::vector<uint256>& slots)
+{
+    AssertLockHeld(::cs_main);
+
+    const dev::Address addrAccount{uintToh160(address)};
+    const dev::h256 stateRoot{uintToh256(blockindex.hashStateRoot)};
+    const dev::h256 utxoRoot{uintToh256(blockindex.hashUTXORoot)};
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("address", addrAccount.hex());
+    result.pushKV("blockhash", blockindex.GetBlockHash().GetHex());
+    result.pushKV("height", blockindex.nHeight);
+    result.pushKV("stateroot", stateRoot.hex());
+    result.pushKV("utxoroot", utxoRoot.hex());
+
+    // Account in the state trie
+    std::vector<dev::bytes> values;
+    std::vector<dev::bytes> nodes;
+    if (!qtum::ProveTrieKeys(globalState->db(), stateRoot, {addrAccount.asBytes()}, values, nodes)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "State trie data not available for this block");
+    }
+    dev::h256 storageRoot = dev::EmptyTrie;
+    if (!values[0].empty()) {
+        dev::RLP account(values[0]);
+        storageRoot = account[2].toHash<dev::h256>();
+        UniValue accountUV(UniValue::VOBJ);
+        accountUV.pushKV("nonce", uint64_t(account[0].toInt<dev::u256>()));
+        accountUV.pushKV("balance", CAmount(account[1].toInt<dev::u256>()));
+        accountUV.pushKV("storageroot", storageRoot.hex());
+        accountUV.pushKV("codehash", account[3].toHash<dev::h256>().hex());
+        result.pushKV("account", accountUV);
+    } else {
+        result.pushKV("account", NullUniValue);
+    }
+    result.pushKV("accountproof", ProofNodesToJSON(nodes));
+
+    // Storage slots in the account storage trie, sharing one node set
+    std::vector<dev::bytes> keys;
+    for (const uint256& slot : slots) {
+        keys.push_back(uintToh256(slot).asBytes());
+    }
+    if (!qtum::ProveTrieKeys(globalState->db(), storageRoot, keys, values, nodes)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Storage trie data not available for this block");
+    }
+    UniValue storageUV(UniValue::VARR);
+    for (size_t i = 0; i < slots.size(); i++) {
+        dev::u256 value = values[i].empty() ? 0 : dev::RLP(values[i]).toInt<dev::u256>();
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("key", uintToh256(slots[i]).hex());
+        entry.pushKV("value", dev::h256(value).hex());
+        storageUV.push_back(entry);
+    }
+    result.pushKV("storage", storageUV);
+    result.pushKV("storageproof", ProofNodesToJSON(nodes));
+
+    // Condensing UTXO of the contract in the UTXO trie
+    if (!qtum::ProveTrieKeys(globalState->dbUtxo(), utxoRoot, {addrAccount.asBytes()}, values, nodes)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "UTXO trie data not available for this block");
+    }
+    if (!values[0].empty()) {
+        dev::RLP vin(values[0]);
+        valtype vchHash(vin[0].toHash<dev::h256>().asBytes());
+        std::reverse(vchHash.begin(), vchHash.end());
+        UniValue vinUV(UniValue::VOBJ);
+        vinUV.pushKV("hash", HexStr(vchHash));
+        vinUV.pushKV("nVout", uint64_t(vin[1].toInt<uint32_t>()));
+        vinUV.pushKV("value", uint64_t(vin[2].toInt<dev::u256>()));
+        vinUV.pushKV("alive", vin[3].toInt<uint8_t>() != 0);
+        result.pushKV("vin", vinUV);
+    } else {
+        result.pushKV("vin", NullUniValue);
+    }
+    result.pushKV("vinproof", ProofNodesToJSON(nodes));
+
+    return result;
+}
+
+static RPCHelpMan getproof()
+{
+    return RPCHelpMan{"getproof",
+                "\nReturns Merkle proofs for a contract account, a set of its storage slots and its condensing UTXO.\n"
+                "The proofs are against the hashStateRoot and hashUTXORoot committed in the header of the requested block.\n"
+                "Each proof is a list of RLP encoded trie nodes; slots share the nodes of their common trie paths.\n",
+                {
+                    {"address", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The contract address"},
+                    {"slots", RPCArg::Type::ARR, RPCArg::Default{UniValue::VARR}, "The storage slots to prove",
+                        {
+                            {"slot", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "A storage slot, up to 32 bytes"},
+                        },
+                    },
+                    {"blocknum", RPCArg::Type::NUM, RPCArg::Default{-1}, "Number of block to get the proofs for, -1 for the tip."},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "address", "The contract address"},
+                        {RPCResult::Type::STR_HEX, "blockhash", "The block the proofs refer to"},
+                        {RPCResult::Type::NUM, "height", "The height of the block"},
+                        {RPCResult::Type::STR_HEX, "stateroot", "The state root committed in the block header"},
+                        {RPCResult::Type::STR_HEX, "utxoroot", "The UTXO root committed in the block header"},
+                        {RPCResult::Type::OBJ, "account", /*optional=*/true, "The account, null if it does not exist",
+                        {
+                            {RPCResult::Type::NUM, "nonce", "The account nonce"},
+                            {RPCResult::Type::NUM, "balance", "The account balance"},
+                            {RPCResult::Type::STR_HEX, "storageroot", "Root of the account storage trie"},
+                            {RPCResult::Type::STR_HEX, "codehash", "Hash of the account code"},
+                        }},
+                        {RPCResult::Type::ARR, "accountproof", "Trie nodes from stateroot to the account",
+                            {{RPCResult::Type::STR_HEX, "", "RLP encoded trie node"}}},
+                        {RPCResult::Type::ARR, "storage", "",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR_HEX, "key", "The storage slot"},
+                                {RPCResult::Type::STR_HEX, "value", "The value stored in the slot"},
+                            }},
+                        }},
+                        {RPCResult::Type::ARR, "storageproof", "Trie nodes from storageroot to all requested slots",
+                            {{RPCResult::Type::STR_HEX, "", "RLP encoded trie node"}}},
+                        {RPCResult::Type::OBJ, "vin", /*optional=*/true, "The condensing UTXO of the contract, null if it has none",
+                        {
+                            {RPCResult::Type::STR_HEX, "hash", "The transaction id of the UTXO"},
+                            {RPCResult::Type::NUM, "nVout", "The output index of the UTXO"},
+                            {RPCResult::Type::NUM, "value", "The value of the UTXO"},
+                            {RPCResult::Type::BOOL, "alive", "Whether the contract is alive"},
+                        }},
+                        {RPCResult::Type::ARR, "vinproof", "Trie nodes from utxoroot to the condensing UTXO",
+                            {{RPCResult::Type::STR_HEX, "", "RLP encoded trie node"}}},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getproof", "eb23c0b3e6042821da281a2e2364feb22dd543e3 '[\"00\"]'")
+            + HelpExampleRpc("getproof", "\"eb23c0b3e6042821da281a2e2364feb22dd543e3\", [\"00\"]")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    LOCK(cs_main);
+
+    CChain& active_chain = chainman.ActiveChain();
+    std::string strAddr = request.params[0].get_str();
+    if(strAddr.size() != 40 || !CheckHex(strAddr))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Incorrect address");
+
+    std::vector<uint256> slots;
+    if (!request.params[1].isNull()) {
+        for (const UniValue& slot : request.params[1].get_array().getValues()) {
+            std::optional<uint256> parsed = ParseStorageSlot(slot.get_str());
+            if (!parsed)
+                throw JSONRPCError(RPC_INVALID_PARAMS, "Incorrect storage slot: " + slot.get_str());
+            slots.push_back(*parsed);
+        }
+    }
+
+    int blockNum = request.params[2].isNull() ? -1 : request.params[2].getInt<int>();
+    if((blockNum < 0 && blockNum != -1) || blockNum > active_chain.Height())
+        throw JSONRPCError(RPC_INVALID_PARAMS, "Incorrect block number");
+    const CBlockIndex* pblockindex = blockNum == -1 ? active_chain.Tip() : active_chain[blockNum];
+
+    return stateProofToJSON(*pblockindex, uint160(ParseHex(strAddr)), slots);
+},
+    };
+}
+
 static RPCHelpMan getblockheader()
 {
     return RPCHelpMan{"getblockheader",
@@ -967,26 +1179,39 @@ static RPCHelpMan getblockheader()
 
     const CBlockIndex* pblockindex;
     const CBlockIndex* tip;
+    const CBlockIndex* anchor;
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    UniValue cache_params(UniValue::VARR);
+    cache_params.push_back(hash.GetHex());
+    cache_params.push_back(fVerbose);
+    if (auto cached{GetCachedRPCResponse(chainman, "getblockheader", cache_params)}) {
+        return std::move(*cached);
+    }
     {
         LOCK(cs_main);
         pblockindex = chainman.m_blockman.LookupBlockIndex(hash);
         tip = chainman.ActiveChain().Tip();
-    }
 
-    if (!pblockindex) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
+        if (!pblockindex) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
+        }
+        // The next block is part of the verbose response
+        anchor = chainman.ActiveChain().Next(pblockindex);
     }
 
     if (!fVerbose)
     {
         DataStream ssBlock{};
         ssBlock << pblockindex->GetBlockHeader();
-        std::string strHex = HexStr(ssBlock);
+        UniValue strHex{HexStr(ssBlock)};
+        // The serialized header does not depend on the next block
+        CacheRPCResponse(chainman, "getblockheader", cache_params, strHex, pblockindex);
         return strHex;
     }
 
-    return blockheaderToJSON(*tip, *pblockindex, chainman.GetConsensus().powLimit);
+    UniValue result{blockheaderToJSON(*tip, *pblockindex, chainman.GetConsensus().powLimit)};
+    CacheRPCResponse(chainman, "getblockheader", cache_params, result, anchor);
+    return result;
 },
     };
 }
@@ -1173,6 +1398,12 @@ static RPCHelpMan getblock()
     const CBlockIndex* pblockindex;
     const CBlockIndex* tip;
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    UniValue cache_params(UniValue::VARR);
+    cache_params.push_back(hash.GetHex());
+    cache_params.push_back(std::clamp(verbosity, 0, 3));
+    if (auto cached{GetCachedRPCResponse(chainman, "getblock", cache_params)}) {
+        return std::move(*cached);
+    }
     {
         LOCK(cs_main);
         pblockindex = chainman.m_blockman.LookupBlockIndex(hash);
@@ -1182,11 +1413,15 @@ static RPCHelpMan getblock()
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
         }
     }
+    // The next block is part of the response
+    const CBlockIndex* anchor{WITH_LOCK(cs_main, return chainman.ActiveChain().Next(pblockindex))};
 
     const std::vector<uint8_t> block_data{GetRawBlockChecked(chainman.m_blockman, *pblockindex)};
 
     if (verbosity <= 0) {
-        return HexStr(block_data);
+        UniValue result{HexStr(block_data)};
+        CacheRPCResponse(chainman, "getblock", cache_params, result, anchor);
+        return result;
     }
 
     DataStream block_stream{block_data};
@@ -1202,7 +1437,18 @@ static RPCHelpMan getblock()
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
     }
 
-    return blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+    // With transaction details, write the block straight into the reply
+    // instead of building it as a tree. A streamed reply is not cached.
+    JSONRPCRequest& stream_request = (JSONRPCRequest&) request;
+    if (verbosity >= 2 && stream_request.StreamResult([&](JSONStreamWriter& writer) {
+            blockToJSONStream(writer, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        })) {
+        return NullUniValue;
+    }
+
+    UniValue result{blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit)};
+    CacheRPCResponse(chainman, "getblock", cache_params, result, anchor);
+    return result;
 },
     };
 }
@@ -1408,6 +1654,7 @@ RPCHelpMan waitforlogs()
     Mining& miner = EnsureMining(node);
 
     WaitForLogsParams params(request.params, miner);
+    WITH_LOCK(cs_main, EnsureLogEventsRetained(params.fromBlock));
 
     request.PollStart();
 
@@ -1681,7 +1928,25 @@ RPCHelpMan gettransactionreceipt()
 
     uint256 hash = uint256::FromHex(hashTemp).value_or(uint256::ZERO);
 
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    UniValue cache_params(UniValue::VARR);
+    cache_params.push_back(hash.GetHex());
+    if (auto cached{GetCachedRPCResponse(chainman, "gettransactionreceipt", cache_params)}) {
+        EnsureLogEventsRetained((*cached)[0]["blockNumber"].getInt<int>());
+        return std::move(*cached);
+    }
+
     std::vector<TransactionReceiptInfo> transactionReceiptInfo = pstorageresult->getResult(uintToh256(hash));
+    if(transactionReceiptInfo.empty() && pstorageresult->getPrunedHeight() >= 0){
+        // The block of the transaction is only known with -txindex
+        uint256 hashBlock;
+        if(node::GetTransaction(nullptr, nullptr, hash, hashBlock, chainman.m_blockman)){
+            const CBlockIndex* pblockindex = chainman.m_blockman.LookupBlockIndex(hashBlock);
+            if(pblockindex && chainman.ActiveChain().Contains(pblockindex)){
+                EnsureLogEventsRetained(pblockindex->nHeight);
+            }
+        }
+    }
 
     UniValue result(UniValue::VARR);
     for(TransactionReceiptInfo& t : transactionReceiptInfo){
@@ -1689,6 +1954,9 @@ RPCHelpMan gettransactionreceipt()
         transactionReceiptInfoToJSON(t, tri);
         result.push_back(tri);
     }
+    if(!transactionReceiptInfo.empty()){
+        CacheRPCResponse(chainman, "gettransactionreceipt", cache_params, result, WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(transactionReceiptInfo[0].blockHash)));
+    }
     return result;
 },
     };
@@ -1761,6 +2029,7 @@ RPCHelpMan getblocktransactionreceipts()
     if (!pblockindex) {
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
     }
+    EnsureLogEventsRetained(pblockindex->nHeight);
     const CBlock block{GetBlockChecked(chainman.m_blockman, *pblockindex)};
 
     UniValue result(UniValue::VARR);
@@ -1842,6 +2111,48 @@ RPCHelpMan getdelegationinfoforaddress()
     };
 }
 
+RPCHelpMan getmposbalance()
+{
+    return RPCHelpMan{"getmposbalance",
+                "\nGet the MPoS rewards accrued to an address, and to a delegate the rewards of its delegated blocks.\n"
+                "The balance is claimed by a transaction whose first input spends a coin of the address\n"
+                "and which has a null data output pushing \"mposclaim\", the key hash of the address and\n"
+                "the claimed amount in satoshis as a 64-bit little endian integer. The claimed amount adds\n"
+                "to the value of the inputs of the transaction.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The qtum address string"},
+                },
+                RPCResult{
+                    RPCResult::Type::STR_AMOUNT, "", "The accrued balance in " + CURRENCY_UNIT},
+                RPCExamples{
+                    HelpExampleCli("getmposbalance", "QM72Sfpbz1BPpXFHz9m3CdqATR44Jvaydd")
+            + HelpExampleRpc("getmposbalance", "QM72Sfpbz1BPpXFHz9m3CdqATR44Jvaydd")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    LOCK(cs_main);
+
+    CTxDestination dest = DecodeDestination(request.params[0].get_str());
+    if (!IsValidDestination(dest)) {
+        throw JSONRPCError(RPC_TYPE_ERROR, "Invalid address");
+    }
+
+    if (!std::holds_alternative<PKHash>(dest)) {
+        throw JSONRPCError(RPC_TYPE_ERROR, "Address does not refer to public key hash");
+    }
+
+    CAmount balance = 0;
+    if (!chainman.m_blockman.m_block_tree_db->ReadMPoSBalance(uint160(std::get<PKHash>(dest)), balance)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to read MPoS balance");
+    }
+
+    return ValueFromAmount(balance);
+},
+    };
+}
+
 class DelegationsStakerFilter : public IDelegationFilter
 {
 public:
@@ -4592,6 +4903,48 @@ return RPCHelpMan{
     };
 }
 
+static RPCHelpMan getcachewarmupinfo()
+{
+    return RPCHelpMan{"getcachewarmupinfo",
+        "\nReturns the progress of prefetching the coins and EVM trie nodes that were cached at the last shutdown (-cachewarmup).\n"
+        "Staking waits while the warm-up is active.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::BOOL, "active", "Whether the warm-up is pending or running"},
+                {RPCResult::Type::BOOL, "complete", "Whether the warm-up finished without being interrupted"},
+                {RPCResult::Type::NUM, "coins", "The number of coins to prefetch"},
+                {RPCResult::Type::NUM, "coins_loaded", "The number of coins prefetched so far"},
+                {RPCResult::Type::NUM, "nodes", "The number of trie nodes to prefetch"},
+                {RPCResult::Type::NUM, "nodes_loaded", "The number of trie nodes prefetched so far"},
+                {RPCResult::Type::NUM, "progress", "The share of the keys prefetched so far, between 0 and 1"},
+                {RPCResult::Type::NUM, "elapsed", "The time spent prefetching, in seconds"},
+            }},
+        RPCExamples{
+            HelpExampleCli("getcachewarmupinfo", "")
+            + HelpExampleRpc("getcachewarmupinfo", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const node::CacheWarmupProgress progress{node::GetCacheWarmupProgress()};
+    const uint64_t total{progress.coins + progress.nodes};
+    const uint64_t loaded{progress.coins_loaded + progress.nodes_loaded};
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("active", progress.active);
+    obj.pushKV("complete", progress.complete);
+    obj.pushKV("coins", progress.coins);
+    obj.pushKV("coins_loaded", progress.coins_loaded);
+    obj.pushKV("nodes", progress.nodes);
+    obj.pushKV("nodes_loaded", progress.nodes_loaded);
+    obj.pushKV("progress", total ? double(loaded) / total : 1.0);
+    obj.pushKV("elapsed", Ticks<SecondsDouble>(progress.elapsed));
+    return obj;
+},
+    };
+}
+
 static RPCHelpMan qrc20name()
 {
     return RPCHelpMan{"qrc20name",
@@ -4921,6 +5274,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &getaccountinfo},
         {"blockchain", &getcontractcode},
         {"blockchain", &getstorage},
+        {"blockchain", &getproof},
         {"blockchain", &preciousblock},
         {"blockchain", &scantxoutset},
         {"blockchain", &scanblocks},
@@ -4929,6 +5283,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
+        {"blockchain", &getcachewarmupinfo},
         {"blockchain", &callcontract},
         {"blockchain", &qrc20name},
         {"blockchain", &qrc20symbol},
@@ -4944,6 +5299,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &waitforlogs},
         {"blockchain", &getestimatedannualroi},
         {"blockchain", &getdelegationinfoforaddress},
+        {"blockchain", &getmposbalance},
         {"blockchain", &getdelegationsforstaker},
         {"hidden", &invalidateblock},
         {"hidden", &reconsiderblock},
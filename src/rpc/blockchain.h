@@ -13,12 +13,15 @@
 #include <validation.h>
 
 #include <any>
+#include <optional>
 #include <stdint.h>
+#include <string>
 #include <vector>
 
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class JSONStreamWriter;
 class UniValue;
 namespace node {
 class BlockManager;
@@ -38,9 +41,18 @@ double GetDifficulty(const CBlockIndex& blockindex);
 /** Block description to JSON */
 UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
+/** Block description to JSON, streamed one transaction at a time. Produces the same output as blockToJSON. */
+void blockToJSONStream(JSONStreamWriter& writer, node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
+
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
+/** Parse a hex storage slot of up to 32 bytes, left padded with zeros */
+std::optional<uint256> ParseStorageSlot(const std::string& hex);
+
+/** Merkle proofs for a contract account, storage slots and condensing UTXO against the roots in blockindex */
+UniValue stateProofToJSON(const CBlockIndex& blockindex, const uint160& address, const std::vector<uint256>& slots) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
 /** Used by getblockstats to get feerates at different percentiles by weight  */
 void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight);
 
@@ -281,6 +281,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "importmempool", 1, "apply_fee_delta_priority" },
     { "importmempool", 1, "use_current_time" },
     { "importmempool", 1, "apply_unbroadcast_set" },
+    { "importmempool", 1, "use_restore_witness" },
     { "importmulti", 0, "requests" },
     { "importmulti", 1, "options" },
     { "importmulti", 1, "rescan" },
@@ -370,6 +371,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getcontractcode", 1, "blocknum" },
     { "getstorage", 2, "index" },
     { "getstorage", 1, "blocknum" },
+    { "getproof", 1, "slots" },
+    { "getproof", 2, "blocknum" },
     // Echo with conversion (For testing only)
     { "echojson", 0, "arg0" },
     { "echojson", 1, "arg1" },
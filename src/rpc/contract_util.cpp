@@ -2,6 +2,7 @@
 #include <rpc/util.h>
 #include <common/system.h>
 #include <key_io.h>
+#include <rpc/response_cache.h>
 #include <rpc/server.h>
 #include <txdb.h>
 
@@ -352,6 +353,15 @@ private:
 
 };
 
+void EnsureLogEventsRetained(int height)
+{
+    AssertLockHeld(cs_main);
+    const int prunedHeight = pstorageresult->getPrunedHeight();
+    if (height <= prunedHeight) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Receipts and logs below height %d are pruned (-logeventsretain)", prunedHeight + 1));
+    }
+}
+
 UniValue SearchLogs(const UniValue& _params, ChainstateManager &chainman)
 {
     if(!fLogEvents)
@@ -362,6 +372,25 @@ UniValue SearchLogs(const UniValue& _params, ChainstateManager &chainman)
     LOCK(cs_main);
 
     SearchLogsParams params(_params, chainman.ActiveChain().Height());
+    EnsureLogEventsRetained(params.fromBlock);
+
+    UniValue cache_params(UniValue::VARR);
+    cache_params.push_back((uint64_t)params.fromBlock);
+    cache_params.push_back((uint64_t)params.toBlock);
+    UniValue cache_addresses(UniValue::VARR);
+    for (const dev::h160& address : params.addresses) {
+        cache_addresses.push_back(address.hex());
+    }
+    cache_params.push_back(cache_addresses);
+    UniValue cache_topics(UniValue::VARR);
+    for (const auto& topic : params.topics) {
+        cache_topics.push_back(topic ? UniValue(topic->hex()) : NullUniValue);
+    }
+    cache_params.push_back(cache_topics);
+    cache_params.push_back((uint64_t)params.minconf);
+    if (auto cached{GetCachedRPCResponse(chainman, "searchlogs", cache_params)}) {
+        return std::move(*cached);
+    }
 
     std::vector<std::vector<uint256>> hashesToBlock;
 
@@ -428,6 +457,13 @@ UniValue SearchLogs(const UniValue& _params, ChainstateManager &chainman)
         }
     }
 
+    // Blocks with fewer confirmations than minconf are left out, so the
+    // result only stays the same once the last block has them
+    const CChain& chain = chainman.ActiveChain();
+    if (params.toBlock <= (size_t)chain.Height() && (size_t)chain.Height() - params.toBlock + 1 >= params.minconf) {
+        CacheRPCResponse(chainman, "searchlogs", cache_params, result, chain[params.toBlock]);
+    }
+
     return result;
 }
 
@@ -564,8 +600,16 @@ bool CallToken::execEvents(const int64_t &fromBlock, const int64_t &toBlock, con
 
 bool CallToken::searchTokenTx(const int64_t &fromBlock, const int64_t &toBlock, const int64_t &minconf, const std::string &eventName, const std::string &contractAddress, const std::string &senderAddress, const int &numTopics, UniValue &resultVar)
 {
+    // Token history starts where the receipts are kept
+    const int64_t retainedFrom = std::max<int64_t>(fromBlock, WITH_LOCK(cs_main, return pstorageresult->getPrunedHeight()) + 1);
+    if(toBlock > -1 && toBlock < retainedFrom)
+    {
+        resultVar = UniValue(UniValue::VARR);
+        return true;
+    }
+
     UniValue params(UniValue::VARR);
-    params.push_back(fromBlock);
+    params.push_back(retainedFrom);
     params.push_back(toBlock);
 
     UniValue addresses(UniValue::VARR);
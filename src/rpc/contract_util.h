@@ -11,6 +11,9 @@ UniValue CallToContract(const UniValue& params, ChainstateManager &chainman);
 
 UniValue SearchLogs(const UniValue& params, ChainstateManager &chainman);
 
+/** Throw if the receipts and logs of the block at height were pruned by -logeventsretain */
+void EnsureLogEventsRetained(int height);
+
 void assignJSON(UniValue& entry, const TransactionReceiptInfo& resExec);
 
 void assignJSON(UniValue& logEntry, const dev::eth::LogEntry& log,
@@ -803,6 +803,10 @@ static RPCHelpMan importmempool()
                  {"apply_unbroadcast_set", RPCArg::Type::BOOL, RPCArg::Default{false},
                   "Whether to apply the unbroadcast set metadata from the mempool file.\n"
                   "Warning: Importing untrusted metadata may lead to unexpected issues and undesirable behavior."},
+                 {"use_restore_witness", RPCArg::Type::BOOL, RPCArg::Default{false},
+                  "Whether to trust the validation results stored in the mempool file and skip the script and contract checks they cover.\n"
+                  "Warning: A crafted file can add invalid transactions to the mempool this way.\n"
+                  "Only set this bool for files written by this node."},
              },
              RPCArgOptions{.oneline_description = "options"}},
         },
@@ -823,10 +827,12 @@ static RPCHelpMan importmempool()
             const UniValue& use_current_time{request.params[1]["use_current_time"]};
             const UniValue& apply_fee_delta{request.params[1]["apply_fee_delta_priority"]};
             const UniValue& apply_unbroadcast{request.params[1]["apply_unbroadcast_set"]};
+            const UniValue& use_restore_witness{request.params[1]["use_restore_witness"]};
             node::ImportMempoolOptions opts{
                 .use_current_time = use_current_time.isNull() ? true : use_current_time.get_bool(),
                 .apply_fee_delta_priority = apply_fee_delta.isNull() ? false : apply_fee_delta.get_bool(),
                 .apply_unbroadcast_set = apply_unbroadcast.isNull() ? false : apply_unbroadcast.get_bool(),
+                .use_restore_witness = use_restore_witness.isNull() ? false : use_restore_witness.get_bool(),
             };
 
             if (!node::LoadMempool(mempool, load_path, chainstate, std::move(opts))) {
@@ -857,6 +863,7 @@ static RPCHelpMan savemempool()
 {
     const ArgsManager& args{EnsureAnyArgsman(request.context)};
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
+    const Chainstate& chainstate = EnsureAnyChainman(request.context).ActiveChainstate();
 
     if (!mempool.GetLoadTried()) {
         throw JSONRPCError(RPC_MISC_ERROR, "The mempool was not loaded yet");
@@ -864,7 +871,7 @@ static RPCHelpMan savemempool()
 
     const fs::path& dump_path = MempoolPath(args);
 
-    if (!DumpMempool(mempool, dump_path)) {
+    if (!DumpMempool(mempool, dump_path, fsbridge::fopen, /*skip_file_commit=*/false, &chainstate)) {
         throw JSONRPCError(RPC_MISC_ERROR, "Unable to dump mempool to disk");
     }
 
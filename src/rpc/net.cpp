@@ -1063,6 +1063,88 @@ static RPCHelpMan sendmsgtopeer()
     };
 }
 
+static RPCHelpMan syncevmstate()
+{
+    return RPCHelpMan{"syncevmstate",
+        "Download the EVM state of a block from peers that serve it with -peerevmstate.\n"
+        "Every trie node, contract code and key is checked against the state roots in the block header.\n"
+        "Without a block hash, the state of a block a little below the best header is downloaded,\n"
+        "moving to newer blocks as the headers chain grows, so that only the changes are downloaded again.\n"
+        "The parts of the state that are already stored are not downloaded.",
+        {
+            {"blockhash", RPCArg::Type::STR_HEX, RPCArg::DefaultHint{"follow the best header"}, "The hash of the block whose EVM state to download"},
+        },
+        RPCResult{RPCResult::Type::NONE, "", ""},
+        RPCExamples{
+            HelpExampleCli("syncevmstate", "")
+            + HelpExampleCli("syncevmstate", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\"")
+            + HelpExampleRpc("syncevmstate", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\"")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    ChainstateManager& chainman = EnsureChainman(node);
+    PeerManager& peerman = EnsurePeerman(node);
+
+    const CBlockIndex* block_index{nullptr};
+    if (!request.params[0].isNull()) {
+        const uint256 hash{ParseHashV(request.params[0], "blockhash")};
+        block_index = WITH_LOCK(::cs_main, return chainman.m_blockman.LookupBlockIndex(hash));
+        if (!block_index) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block header not found");
+        }
+    }
+    if (const auto error{peerman.StartEVMStateSync(block_index)}) {
+        throw JSONRPCError(RPC_MISC_ERROR, *error);
+    }
+    return UniValue::VNULL;
+},
+    };
+}
+
+static RPCHelpMan getevmstatesyncinfo()
+{
+    return RPCHelpMan{"getevmstatesyncinfo",
+        "Returns the progress of the EVM state download started by syncevmstate.",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::BOOL, "active", "Whether a download was started"},
+                {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "The block whose EVM state is downloaded"},
+                {RPCResult::Type::BOOL, "complete", /*optional=*/true, "Whether the whole EVM state of the block is stored"},
+                {RPCResult::Type::NUM, "pending", /*optional=*/true, "The number of trie nodes, codes and keys still to download"},
+                {RPCResult::Type::NUM, "nodes", /*optional=*/true, "The number of trie nodes downloaded"},
+                {RPCResult::Type::NUM, "codes", /*optional=*/true, "The number of contract codes downloaded"},
+                {RPCResult::Type::NUM, "keys", /*optional=*/true, "The number of trie keys downloaded"},
+                {RPCResult::Type::NUM, "bytes", /*optional=*/true, "The number of bytes downloaded"},
+            }},
+        RPCExamples{
+            HelpExampleCli("getevmstatesyncinfo", "")
+            + HelpExampleRpc("getevmstatesyncinfo", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    const PeerManager& peerman = EnsurePeerman(node);
+
+    UniValue obj(UniValue::VOBJ);
+    const auto stats{peerman.GetEVMStateSyncStats()};
+    obj.pushKV("active", stats.has_value());
+    if (stats) {
+        obj.pushKV("blockhash", stats->block_hash.GetHex());
+        obj.pushKV("complete", stats->complete);
+        obj.pushKV("pending", uint64_t(stats->pending));
+        obj.pushKV("nodes", stats->nodes);
+        obj.pushKV("codes", stats->codes);
+        obj.pushKV("keys", stats->keys);
+        obj.pushKV("bytes", stats->bytes);
+    }
+    return obj;
+},
+    };
+}
+
 static RPCHelpMan getaddrmaninfo()
 {
     return RPCHelpMan{
@@ -1196,6 +1278,8 @@ void RegisterNetRPCCommands(CRPCTable& t)
         {"network", &setnetworkactive},
         {"network", &getnodeaddresses},
         {"network", &getaddrmaninfo},
+        {"network", &syncevmstate},
+        {"network", &getevmstatesyncinfo},
         {"hidden", &addconnection},
         {"hidden", &addpeeraddress},
         {"hidden", &sendmsgtopeer},
@@ -17,6 +17,7 @@
 #include <kernel/cs_main.h>
 #include <logging.h>
 #include <node/context.h>
+#include <rpc/response_cache.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
@@ -196,6 +197,63 @@ static RPCHelpMan getmemoryinfo()
     };
 }
 
+static RPCHelpMan getrpccacheinfo()
+{
+    return RPCHelpMan{"getrpccacheinfo",
+                "\nReturns the usage of the cache of responses about blocks deep in the active chain (-rpccachesize).\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::BOOL, "enabled", "Whether the cache is enabled"},
+                        {RPCResult::Type::NUM, "entries", "The number of cached responses"},
+                        {RPCResult::Type::NUM, "bytes", "The memory used by the cached responses"},
+                        {RPCResult::Type::NUM, "max_bytes", "The size of the cache"},
+                        {RPCResult::Type::NUM, "depth", "The confirmations a block needs before responses about it are cached"},
+                        {RPCResult::Type::NUM, "evicted", "The number of responses evicted to make room for newer ones"},
+                        {RPCResult::Type::NUM, "invalidated", "The number of responses dropped because their block was disconnected"},
+                        {RPCResult::Type::OBJ_DYN, "methods", "Lookups by method",
+                        {
+                            {RPCResult::Type::OBJ, "method", "",
+                            {
+                                {RPCResult::Type::NUM, "hits", "The number of requests answered from the cache"},
+                                {RPCResult::Type::NUM, "misses", "The number of requests that were not in the cache"},
+                                {RPCResult::Type::NUM, "hit_rate", "The share of requests answered from the cache, between 0 and 1"},
+                            }},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getrpccacheinfo", "")
+            + HelpExampleRpc("getrpccacheinfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const RPCResponseCache::Stats stats{g_rpc_response_cache ? g_rpc_response_cache->GetStats() : RPCResponseCache::Stats{}};
+
+    UniValue methods(UniValue::VOBJ);
+    for (const auto& [method, method_stats] : stats.methods) {
+        const uint64_t lookups{method_stats.hits + method_stats.misses};
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("hits", method_stats.hits);
+        entry.pushKV("misses", method_stats.misses);
+        entry.pushKV("hit_rate", lookups ? double(method_stats.hits) / lookups : 0.0);
+        methods.pushKV(method, std::move(entry));
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("enabled", g_rpc_response_cache != nullptr);
+    obj.pushKV("entries", uint64_t(stats.entries));
+    obj.pushKV("bytes", uint64_t(stats.bytes));
+    obj.pushKV("max_bytes", uint64_t(stats.max_bytes));
+    obj.pushKV("depth", stats.depth);
+    obj.pushKV("evicted", stats.evicted);
+    obj.pushKV("invalidated", stats.invalidated);
+    obj.pushKV("methods", std::move(methods));
+    return obj;
+},
+    };
+}
+
 static void EnableOrDisableLogCategories(UniValue cats, bool enable) {
     cats = cats.get_array();
     for (unsigned int i = 0; i < cats.size(); ++i) {
@@ -1256,6 +1314,7 @@ void RegisterNodeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
+        {"control", &getrpccacheinfo},
         {"control", &logging},
         {"control", &getdgpinfo},
         {"util", &getindexinfo},
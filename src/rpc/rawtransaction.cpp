@@ -25,6 +25,7 @@
 #include <random.h>
 #include <rpc/blockchain.h>
 #include <rpc/rawtransaction_util.h>
+#include <rpc/response_cache.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
@@ -538,6 +539,18 @@ static RPCHelpMan getrawtransaction()
 
     int verbosity{ParseVerbosity(request.params[1], /*default_verbosity=*/0, /*allow_bool=*/true)};
 
+    // With -addrindex the outputs show where they are spent, which changes
+    const bool cacheable{verbosity <= 0 || !fAddressIndex};
+    UniValue cache_params(UniValue::VARR);
+    cache_params.push_back(hash.GetHex());
+    cache_params.push_back(std::clamp(verbosity, 0, 2));
+    cache_params.push_back(request.params[2].isNull() ? NullUniValue : UniValue(ParseHashV(request.params[2], "parameter 3").GetHex()));
+    if (cacheable) {
+        if (auto cached{GetCachedRPCResponse(chainman, "getrawtransaction", cache_params)}) {
+            return std::move(*cached);
+        }
+    }
+
     if (!request.params[2].isNull()) {
         LOCK(cs_main);
 
@@ -573,8 +586,12 @@ static RPCHelpMan getrawtransaction()
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, errmsg + ". Use gettransaction for wallet transactions.");
     }
 
+    const CBlockIndex* anchor{cacheable && !hash_block.IsNull() ? WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(hash_block)) : nullptr};
+
     if (verbosity <= 0) {
-        return EncodeHexTx(*tx);
+        UniValue hex{EncodeHexTx(*tx)};
+        CacheRPCResponse(chainman, "getrawtransaction", cache_params, hex, anchor);
+        return hex;
     }
 
     //////////////////////////////////////////////////////// // qtum
@@ -612,6 +629,7 @@ static RPCHelpMan getrawtransaction()
     if (verbosity == 1) {
         TxToJSON(*tx, hash_block, result, chainman.ActiveChainstate());
         if (fAddressIndex) TxToJSONExpanded(*tx, hash_block, result, mempool, chainman.m_blockman, nHeight, nConfirmations, nBlockTime);
+        CacheRPCResponse(chainman, "getrawtransaction", cache_params, result, anchor);
         return result;
     }
 
@@ -621,6 +639,7 @@ static RPCHelpMan getrawtransaction()
     if (tx->IsCoinBase() || !blockindex || WITH_LOCK(::cs_main, return !(blockindex->nStatus & BLOCK_HAVE_MASK))) {
         TxToJSON(*tx, hash_block, result, chainman.ActiveChainstate());
         if (fAddressIndex) TxToJSONExpanded(*tx, hash_block, result, mempool, chainman.m_blockman, nHeight, nConfirmations, nBlockTime);
+        CacheRPCResponse(chainman, "getrawtransaction", cache_params, result, anchor);
         return result;
     }
     if (!chainman.m_blockman.ReadBlockUndo(blockUndo, *blockindex)) {
@@ -638,6 +657,7 @@ static RPCHelpMan getrawtransaction()
     }
     TxToJSON(*tx, hash_block, result, chainman.ActiveChainstate(), undoTX, TxVerbosity::SHOW_DETAILS_AND_PREVOUT);
     if (fAddressIndex) TxToJSONExpanded(*tx, hash_block, result, mempool, chainman.m_blockman, nHeight, nConfirmations, nBlockTime);
+    CacheRPCResponse(chainman, "getrawtransaction", cache_params, result, anchor);
     return result;
 },
     };
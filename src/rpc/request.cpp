@@ -259,3 +259,5 @@ void JSONRPCRequest::PollPing() {}
 void JSONRPCRequest::PollCancel() {}
 
 void JSONRPCRequest::PollReply(const UniValue& result) {}
+
+bool JSONRPCRequest::StreamResult(const std::function<void(JSONStreamWriter&)>& write_result) { return false; }
@@ -7,12 +7,15 @@
 #define BITCOIN_RPC_REQUEST_H
 
 #include <any>
+#include <functional>
 #include <optional>
 #include <string>
 
 #include <univalue.h>
 #include <util/fs.h>
 
+class JSONStreamWriter;
+
 enum class JSONRPCVersion {
     V1_LEGACY,
     V2
@@ -45,6 +48,9 @@ public:
     std::any context;
     JSONRPCVersion m_json_version = JSONRPCVersion::V1_LEGACY;
     bool isLongPolling = false;
+    //! Set by the transport when the result of this request may be streamed
+    bool canStream = false;
+    bool isStreamed = false;
     void *httpreq = nullptr;
 
     void parse(const UniValue& valRequest);
@@ -74,6 +80,14 @@ public:
      * Return the JSON result of a long poll request
      */
     virtual void PollReply(const UniValue& result);
+
+    /**
+     * Write the result straight into the reply instead of returning it, so
+     * that a large result never has to exist as a UniValue tree. Returns
+     * false if the reply cannot be streamed, in which case the method has to
+     * return its result as usual.
+     */
+    virtual bool StreamResult(const std::function<void(JSONStreamWriter&)>& write_result);
 };
 
 #endif // BITCOIN_RPC_REQUEST_H
@@ -0,0 +1,139 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/response_cache.h>
+
+#include <chain.h>
+#include <memusage.h>
+#include <validation.h>
+
+std::unique_ptr<RPCResponseCache> g_rpc_response_cache;
+
+namespace {
+std::string Key(const std::string& method, const UniValue& params)
+{
+    return method + " " + params.write();
+}
+} // namespace
+
+size_t UniValueUsage(const UniValue& value)
+{
+    size_t usage{memusage::DynamicUsage(value.getValStr())};
+    if (value.isObject()) {
+        usage += memusage::DynamicUsage(value.getKeys());
+        for (const std::string& key : value.getKeys()) usage += memusage::DynamicUsage(key);
+    }
+    if (value.isObject() || value.isArray()) {
+        usage += memusage::DynamicUsage(value.getValues());
+        for (const UniValue& item : value.getValues()) usage += UniValueUsage(item);
+    }
+    return usage;
+}
+
+RPCResponseCache::RPCResponseCache(size_t max_bytes, int depth)
+    : m_max_bytes{max_bytes}, m_depth{depth} {}
+
+std::optional<UniValue> RPCResponseCache::Get(const std::string& method, const UniValue& params, const CChain& chain)
+{
+    AssertLockHeld(::cs_main);
+    LOCK(m_mutex);
+    MethodStats& stats{m_methods[method]};
+    const auto it{m_index.find(Key(method, params))};
+    if (it == m_index.end()) {
+        ++stats.misses;
+        return std::nullopt;
+    }
+
+    const Entries::iterator entry{it->second};
+    const CBlockIndex* anchor{chain[entry->height]};
+    if (!anchor || anchor->GetBlockHash() != entry->hash) {
+        // The anchor was reorganized away before BlockDisconnected() got to it
+        Erase(entry);
+        ++m_invalidated;
+        ++stats.misses;
+        return std::nullopt;
+    }
+    ++stats.hits;
+    m_entries.splice(m_entries.begin(), m_entries, entry);
+
+    UniValue result{entry->result};
+    if (result.isObject() && result.exists("confirmations")) {
+        result.pushKV("confirmations", result["confirmations"].getInt<int>() + chain.Height() - entry->tip_height);
+    }
+    return result;
+}
+
+bool RPCResponseCache::Put(const std::string& method, const UniValue& params, const UniValue& result, const CBlockIndex& anchor, const CChain& chain)
+{
+    AssertLockHeld(::cs_main);
+    if (!chain.Contains(&anchor) || chain.Height() - anchor.nHeight + 1 < m_depth) return false;
+
+    std::string key{Key(method, params)};
+    // The entry with its list node, the key in the entry and in the index,
+    // the index node and the response tree
+    const size_t bytes{memusage::MallocUsage(sizeof(Entry) + 2 * sizeof(void*)) + 2 * memusage::DynamicUsage(key) +
+                       memusage::MallocUsage(sizeof(std::pair<const std::string, Entries::iterator>) + sizeof(void*)) +
+                       UniValueUsage(result)};
+    if (bytes > m_max_bytes) return false;
+
+    LOCK(m_mutex);
+    if (const auto it{m_index.find(key)}; it != m_index.end()) Erase(it->second);
+    while (m_bytes + bytes > m_max_bytes) {
+        Erase(std::prev(m_entries.end()));
+        ++m_evicted;
+    }
+    m_entries.push_front({key, result, anchor.nHeight, anchor.GetBlockHash(), chain.Height(), bytes});
+    m_index.emplace(std::move(key), m_entries.begin());
+    m_bytes += bytes;
+    return true;
+}
+
+RPCResponseCache::Stats RPCResponseCache::GetStats() const
+{
+    LOCK(m_mutex);
+    Stats stats;
+    stats.entries = m_entries.size();
+    stats.bytes = m_bytes;
+    stats.max_bytes = m_max_bytes;
+    stats.depth = m_depth;
+    stats.evicted = m_evicted;
+    stats.invalidated = m_invalidated;
+    stats.methods = m_methods;
+    return stats;
+}
+
+void RPCResponseCache::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    LOCK(m_mutex);
+    for (auto it{m_entries.begin()}; it != m_entries.end();) {
+        if (it->height >= pindex->nHeight) {
+            Erase(it++);
+            ++m_invalidated;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void RPCResponseCache::Erase(Entries::iterator it)
+{
+    AssertLockHeld(m_mutex);
+    m_bytes -= it->bytes;
+    m_index.erase(it->key);
+    m_entries.erase(it);
+}
+
+std::optional<UniValue> GetCachedRPCResponse(const ChainstateManager& chainman, const std::string& method, const UniValue& params)
+{
+    if (!g_rpc_response_cache) return std::nullopt;
+    LOCK(::cs_main);
+    return g_rpc_response_cache->Get(method, params, chainman.ActiveChain());
+}
+
+void CacheRPCResponse(const ChainstateManager& chainman, const std::string& method, const UniValue& params, const UniValue& result, const CBlockIndex* anchor)
+{
+    if (!g_rpc_response_cache || !anchor) return;
+    LOCK(::cs_main);
+    g_rpc_response_cache->Put(method, params, result, *anchor, chainman.ActiveChain());
+}
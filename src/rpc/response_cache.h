@@ -0,0 +1,123 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPC_RESPONSE_CACHE_H
+#define BITCOIN_RPC_RESPONSE_CACHE_H
+
+#include <kernel/cs_main.h>
+#include <sync.h>
+#include <uint256.h>
+#include <univalue.h>
+#include <validationinterface.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+class CBlock;
+class CBlockIndex;
+class CChain;
+class ChainstateManager;
+
+//! Default size of the RPC response cache in MiB, 0 disables it
+static constexpr int64_t DEFAULT_RPC_CACHE_SIZE{0};
+//! Default number of confirmations a block needs before responses about it are cached
+static constexpr int DEFAULT_RPC_CACHE_DEPTH{100};
+
+//! Heap memory of a response tree, which is several times its serialized size
+size_t UniValueUsage(const UniValue& value);
+
+/**
+ * Responses of RPCs about blocks deep enough in the active chain not to be
+ * reorganized, such as getblock, getrawtransaction and searchlogs over old
+ * ranges, so repeated requests do not read and decode them from disk again.
+ *
+ * An entry is keyed by the method and its parameters in canonical form, and
+ * is anchored at the newest block the response depends on, which for a block
+ * with a "nextblockhash" is the next block. It is only returned while the
+ * anchor is still in the active chain, and is dropped when the anchor is
+ * disconnected. A top-level "confirmations" field is brought up to date on
+ * every hit. The least recently used entries are evicted to keep the memory
+ * of the entries, including the response trees, within the size of the cache.
+ */
+class RPCResponseCache final : public CValidationInterface
+{
+public:
+    struct MethodStats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+    };
+
+    struct Stats {
+        size_t entries{0};
+        size_t bytes{0};
+        size_t max_bytes{0};
+        int depth{0};
+        uint64_t evicted{0};
+        uint64_t invalidated{0};
+        std::map<std::string, MethodStats> methods;
+    };
+
+    /**
+     * @param[in] max_bytes Memory of the entries to keep
+     * @param[in] depth     Confirmations the anchor block needs before a response is cached
+     */
+    RPCResponseCache(size_t max_bytes, int depth);
+
+    //! Cached response of method to the canonical params
+    std::optional<UniValue> Get(const std::string& method, const UniValue& params, const CChain& chain)
+        EXCLUSIVE_LOCKS_REQUIRED(::cs_main, !m_mutex);
+
+    //! Cache the response of method to the canonical params if anchor is deep enough in chain
+    bool Put(const std::string& method, const UniValue& params, const UniValue& result, const CBlockIndex& anchor, const CChain& chain)
+        EXCLUSIVE_LOCKS_REQUIRED(::cs_main, !m_mutex);
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+protected:
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Entry {
+        std::string key;
+        UniValue result;
+        //! Height and hash of the anchor block
+        int height;
+        uint256 hash;
+        //! Height of the tip when the response was made, to update its confirmations
+        int tip_height;
+        //! Memory of the entry
+        size_t bytes;
+    };
+    using Entries = std::list<Entry>;
+
+    void Erase(Entries::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    const size_t m_max_bytes;
+    const int m_depth;
+
+    mutable Mutex m_mutex;
+    //! Most recently used first
+    Entries m_entries GUARDED_BY(m_mutex);
+    std::unordered_map<std::string, Entries::iterator> m_index GUARDED_BY(m_mutex);
+    size_t m_bytes GUARDED_BY(m_mutex){0};
+    uint64_t m_evicted GUARDED_BY(m_mutex){0};
+    uint64_t m_invalidated GUARDED_BY(m_mutex){0};
+    std::map<std::string, MethodStats> m_methods GUARDED_BY(m_mutex);
+};
+
+//! Set when -rpccachesize is not 0
+extern std::unique_ptr<RPCResponseCache> g_rpc_response_cache;
+
+//! Cached response of method to the canonical params, if the cache is enabled
+std::optional<UniValue> GetCachedRPCResponse(const ChainstateManager& chainman, const std::string& method, const UniValue& params);
+
+//! Cache the response of method to the canonical params, if the cache is enabled and anchor is deep enough
+void CacheRPCResponse(const ChainstateManager& chainman, const std::string& method, const UniValue& params, const UniValue& result, const CBlockIndex* anchor);
+
+#endif // BITCOIN_RPC_RESPONSE_CACHE_H
@@ -8,10 +8,12 @@
 #include <rpc/server.h>
 
 #include <common/args.h>
+#include <common/json_stream.h>
 #include <common/system.h>
 #include <logging.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
+#include <rpc/protocol.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
 #include <sync.h>
@@ -372,6 +374,39 @@ void JSONRPCRequestLong::PollReply(const UniValue& result) {
     req()->ChunkEnd();
 }
 
+bool JSONRPCRequestLong::StreamResult(const std::function<void(JSONStreamWriter&)>& write_result) {
+    if (!canStream || isLongPolling || IsNotification()) return false;
+    isStreamed = true;
+
+    // Same reply object as JSONRPCReplyObj. Nothing reaches the client before
+    // the first part is flushed, so an error thrown until then still gets
+    // the usual error reply.
+    HTTPRequest* http_req = req();
+    JSONStreamWriter writer{[http_req](std::string_view part, bool last) {
+        if (!http_req->isChunkMode()) http_req->WriteHeader("Content-Type", "application/json");
+        http_req->WriteReplyPart(HTTP_OK, part, last);
+    }};
+    writer.BeginObject();
+    if (m_json_version == JSONRPCVersion::V2) {
+        writer.Key("jsonrpc");
+        writer.Value(UniValue{"2.0"});
+    }
+    writer.Key("result");
+    write_result(writer);
+    if (m_json_version == JSONRPCVersion::V1_LEGACY) {
+        writer.Key("error");
+        writer.Value(NullUniValue);
+    }
+    if (id.has_value()) {
+        writer.Key("id");
+        writer.Value(id.value());
+    }
+    writer.EndObject();
+    writer.Raw("\n");
+    writer.Finish();
+    return true;
+}
+
 HTTPRequest* JSONRPCRequestLong::req() {
     return (HTTPRequest*)httpreq;
 }
@@ -52,6 +52,11 @@ public:
      */
     void PollReply(const UniValue& result) override;
 
+    /**
+     * Stream the result of a singleton request as the JSON-RPC reply
+     */
+    bool StreamResult(const std::function<void(JSONStreamWriter&)>& write_result) override;
+
     /**
      * Return the http request
      */
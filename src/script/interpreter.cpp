@@ -1425,6 +1425,72 @@ public:
     }
 };
 
+/**
+ * Legacy signature hash using the serialized inputs, outputs and hasher
+ * states of PrecomputedTransactionData. Equal to hashing
+ * CTransactionSignatureSerializer without SIGHASH_ANYONECANPAY, but only the
+ * signed input is serialized, and for SIGHASH_ALL hashing resumes close to it.
+ */
+template <class T>
+uint256 GetLegacySignatureHash(const CScript& scriptCode, const T& txTo, unsigned int nIn, int32_t nHashType, const PrecomputedTransactionData& cache)
+{
+    constexpr size_t INPUT_SIZE{PrecomputedTransactionData::LEGACY_INPUT_SIZE};
+    const Span<const std::byte> inputs{MakeByteSpan(cache.m_legacy_inputs)};
+    const bool fHashSingle{(nHashType & 0x1f) == SIGHASH_SINGLE};
+    const bool fHashNone{(nHashType & 0x1f) == SIGHASH_NONE};
+    const CTransactionSignatureSerializer<T> txTmp(txTo, scriptCode, nIn, nHashType);
+
+    HashWriter ss{};
+    if (!fHashSingle && !fHashNone) {
+        const size_t checkpoint{nIn / PrecomputedTransactionData::LEGACY_MIDSTATE_INTERVAL};
+        const size_t first{checkpoint * PrecomputedTransactionData::LEGACY_MIDSTATE_INTERVAL};
+        ss = cache.m_legacy_midstates[checkpoint];
+        ss.write(inputs.subspan(first * INPUT_SIZE, (nIn - first) * INPUT_SIZE));
+        txTmp.SerializeInput(ss, nIn);
+        ss.write(inputs.subspan((nIn + 1) * INPUT_SIZE));
+        ss.write(MakeByteSpan(cache.m_legacy_outputs));
+    } else {
+        ss << txTo.version;
+        ::WriteCompactSize(ss, txTo.vin.size());
+        for (unsigned int nInput = 0; nInput < txTo.vin.size(); nInput++) {
+            if (nInput == nIn) {
+                txTmp.SerializeInput(ss, nInput);
+            } else {
+                // Blank script, and a zero nSequence
+                ss.write(inputs.subspan(nInput * INPUT_SIZE, INPUT_SIZE - 4));
+                ss << int32_t{0};
+            }
+        }
+        const unsigned int nOutputs = fHashNone ? 0 : nIn + 1;
+        ::WriteCompactSize(ss, nOutputs);
+        for (unsigned int nOutput = 0; nOutput < nOutputs; nOutput++)
+            txTmp.SerializeOutput(ss, nOutput);
+    }
+    ss << txTo.nLockTime << nHashType;
+    return ss.GetHash();
+}
+
+/** Stream appending serialized data to a byte vector. */
+class ByteVectorWriter
+{
+    std::vector<unsigned char>& m_data;
+
+public:
+    explicit ByteVectorWriter(std::vector<unsigned char>& data LIFETIMEBOUND) : m_data{data} {}
+
+    void write(Span<const std::byte> src)
+    {
+        m_data.insert(m_data.end(), UCharCast(src.data()), UCharCast(src.data() + src.size()));
+    }
+
+    template <typename T>
+    ByteVectorWriter& operator<<(const T& obj)
+    {
+        ::Serialize(*this, obj);
+        return *this;
+    }
+};
+
 /** Compute the (single) SHA256 of the concatenation of all prevouts of a tx. */
 template <class T>
 uint256 GetPrevoutsSHA256(const T& txTo)
@@ -1577,6 +1643,28 @@ void PrecomputedTransactionData::Init(const T& txTo, std::vector<CTxOut>&& spent
         m_spent_scripts_single_hash = GetSpentScriptsSHA256(m_spent_outputs);
         m_bip341_taproot_ready = true;
     }
+
+    // Legacy signature hashes are quadratic in the number of inputs, cache
+    // them when more than one input may use them.
+    size_t legacy_inputs{0};
+    for (const auto& txin : txTo.vin) {
+        if (force || txin.scriptWitness.IsNull()) ++legacy_inputs;
+    }
+    if (legacy_inputs > 1) {
+        HashWriter ss{};
+        ss << txTo.version;
+        ::WriteCompactSize(ss, txTo.vin.size());
+        m_legacy_inputs.reserve(txTo.vin.size() * LEGACY_INPUT_SIZE);
+        m_legacy_midstates.reserve((txTo.vin.size() + LEGACY_MIDSTATE_INTERVAL - 1) / LEGACY_MIDSTATE_INTERVAL);
+        ByteVectorWriter inputs{m_legacy_inputs};
+        for (size_t i = 0; i < txTo.vin.size(); ++i) {
+            if (i % LEGACY_MIDSTATE_INTERVAL == 0) m_legacy_midstates.push_back(ss);
+            inputs << txTo.vin[i].prevout << CScript() << txTo.vin[i].nSequence;
+            ss.write(MakeByteSpan(m_legacy_inputs).last(LEGACY_INPUT_SIZE));
+        }
+        ByteVectorWriter{m_legacy_outputs} << txTo.vout;
+        m_legacy_ready = true;
+    }
 }
 
 template <class T>
@@ -1813,6 +1901,10 @@ uint256 SignatureHash(const CScript& scriptCode, const T& txTo, unsigned int nIn
         }
     }
 
+    if (cache && cache->m_legacy_ready && !(nHashType & SIGHASH_ANYONECANPAY)) {
+        return GetLegacySignatureHash(scriptCode, txTo, nIn, nHashType, *cache);
+    }
+
     // Wrapper to serialize only the necessary parts of the transaction being signed
     CTransactionSignatureSerializer<T> txTmp(txTo, scriptCode, nIn, nHashType);
 
@@ -2197,6 +2289,16 @@ bool VerifyScript(const CScript& scriptSig, const CScript& scriptPubKey, const C
     if (!EvalScript(stack, scriptSig, flags, checker, SigVersion::BASE, serror))
         // serror is set
         return false;
+    // A Dilithium pubkey hash spend may push the key id in place of a public key that
+    // was already revealed on chain. Expand it before the scriptPubKey hashes the key.
+    if ((flags & SCRIPT_VERIFY_DILITHIUM_KEYREF) && scriptPubKey.IsPayToDilithiumPubKeyHash() &&
+        !stack.empty() && stack.back().size() == DILITHIUM_KEYREF_SIZE) {
+        const uint160 keyid{Span{scriptPubKey}.subspan(3, DILITHIUM_KEYREF_SIZE)};
+        if (!std::equal(stack.back().begin(), stack.back().end(), keyid.begin()) ||
+            !checker.GetDilithiumPubKey(keyid, stack.back())) {
+            return set_error(serror, SCRIPT_ERR_DILITHIUM_KEYREF);
+        }
+    }
     if (flags & SCRIPT_VERIFY_P2SH)
         stackCopy = stack;
     if (!EvalScript(stack, scriptPubKey, flags, checker, SigVersion::BASE, serror))
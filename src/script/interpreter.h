@@ -145,6 +145,12 @@ enum : uint32_t {
     // Making unknown public key versions (in BIP 342 scripts) non-standard
     SCRIPT_VERIFY_DISCOURAGE_UPGRADABLE_PUBKEYTYPE = (1U << 20),
 
+    // Allow spends of Dilithium pubkey hash outputs to push the 20-byte key id instead of the
+    // full public key, once that key has been revealed on chain (see DilithiumKeyLookup).
+    // Unlike the flags above this relaxes the rules, so it is activated by block height.
+    //
+    SCRIPT_VERIFY_DILITHIUM_KEYREF = (1U << 21),
+
     // Support sender address in contract output
     //
     SCRIPT_OUTPUT_SENDER = (1U << 29),
@@ -182,6 +188,22 @@ struct PrecomputedTransactionData
     //! Whether m_spent_outputs is initialized.
     bool m_spent_outputs_ready = false;
 
+    // Legacy (pre-segwit) signature hash data. Every input but the one being
+    // signed appears in the signature hash with a blank script, so without
+    // these each signature hash re-serializes the whole transaction.
+    //! Inputs serialized with blank scripts, LEGACY_INPUT_SIZE bytes each.
+    std::vector<unsigned char> m_legacy_inputs;
+    //! Outputs serialized as for SIGHASH_ALL, with their count.
+    std::vector<unsigned char> m_legacy_outputs;
+    //! Hasher states of SIGHASH_ALL signature hashes after the version, the
+    //! input count and the first i * LEGACY_MIDSTATE_INTERVAL inputs.
+    std::vector<HashWriter> m_legacy_midstates;
+    //! Whether the 3 fields above are initialized.
+    bool m_legacy_ready = false;
+
+    static constexpr size_t LEGACY_INPUT_SIZE{32 + 4 + 1 + 4};
+    static constexpr size_t LEGACY_MIDSTATE_INTERVAL{16};
+
     PrecomputedTransactionData() = default;
 
     /** Initialize this PrecomputedTransactionData with transaction data.
@@ -256,6 +278,18 @@ uint256 SignatureHash(const CScript& scriptCode, const T& txTo, unsigned int nIn
 template <class T>
 uint256 SignatureHashOutput(const CScript& scriptCode, const T& txTo, unsigned int nOut, int32_t nHashType, const CAmount& amount, SigVersion sigversion, const PrecomputedTransactionData* cache = nullptr);
 
+/** Size of a Dilithium public key reference pushed in place of the full key */
+static constexpr size_t DILITHIUM_KEYREF_SIZE = 20;
+
+/** Source of Dilithium public keys that were already revealed on chain */
+class DilithiumKeyLookup
+{
+public:
+    virtual bool GetDilithiumPubKey(const uint160& keyid, std::vector<unsigned char>& pubkey) const = 0;
+
+    virtual ~DilithiumKeyLookup() = default;
+};
+
 class BaseSignatureChecker
 {
 public:
@@ -279,6 +313,11 @@ public:
          return false;
     }
 
+    virtual bool GetDilithiumPubKey(const uint160& keyid, std::vector<unsigned char>& pubkey) const
+    {
+         return false;
+    }
+
     virtual ~BaseSignatureChecker() = default;
 };
 
@@ -303,6 +342,7 @@ private:
     unsigned int nIn;
     const CAmount amount;
     const PrecomputedTransactionData* txdata;
+    const DilithiumKeyLookup* m_dilithium_keys{nullptr};
 
 protected:
     virtual bool VerifyECDSASignature(const std::vector<unsigned char>& vchSig, const CPubKey& vchPubKey, const uint256& sighash) const;
@@ -315,6 +355,11 @@ public:
     bool CheckSchnorrSignature(Span<const unsigned char> sig, Span<const unsigned char> pubkey, SigVersion sigversion, ScriptExecutionData& execdata, ScriptError* serror = nullptr) const override;
     bool CheckLockTime(const CScriptNum& nLockTime) const override;
     bool CheckSequence(const CScriptNum& nSequence) const override;
+    bool GetDilithiumPubKey(const uint160& keyid, std::vector<unsigned char>& pubkey) const override
+    {
+        return m_dilithium_keys && m_dilithium_keys->GetDilithiumPubKey(keyid, pubkey);
+    }
+    void SetDilithiumKeyLookup(const DilithiumKeyLookup* dilithium_keys) { m_dilithium_keys = dilithium_keys; }
 };
 
 using TransactionSignatureChecker = GenericTransactionSignatureChecker<CTransaction>;
@@ -346,6 +391,10 @@ public:
     {
         return m_checker.CheckSequence(nSequence);
     }
+    bool GetDilithiumPubKey(const uint160& keyid, std::vector<unsigned char>& pubkey) const override
+    {
+        return m_checker.GetDilithiumPubKey(keyid, pubkey);
+    }
 };
 
 template <class T>
@@ -262,6 +262,17 @@ bool CScript::IsPayToPubkeyHash() const
 }
 /////////////////////////////////////////////////////////
 
+bool CScript::IsPayToDilithiumPubKeyHash() const
+{
+    // Extra-fast test for OP_DUP OP_HASH160 <keyid> OP_EQUALVERIFY OP_CHECKSIG_DILITHIUM:
+    return (this->size() == 25 &&
+            (*this)[0] == OP_DUP &&
+            (*this)[1] == OP_HASH160 &&
+            (*this)[2] == 0x14 &&
+            (*this)[23] == OP_EQUALVERIFY &&
+            (*this)[24] == OP_CHECKSIG_DILITHIUM);
+}
+
 bool CScript::IsPayToWitnessScriptHash() const
 {
     // Extra-fast test for pay-to-witness-script-hash CScripts:
@@ -82,6 +82,9 @@ typedef enum ScriptError_t
     SCRIPT_ERR_OP_CODESEPARATOR,
     SCRIPT_ERR_SIG_FINDANDDELETE,
 
+    /* Dilithium public key references */
+    SCRIPT_ERR_DILITHIUM_KEYREF,
+
     SCRIPT_ERR_ERROR_COUNT
 } ScriptError;
 
@@ -3,6 +3,8 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <crypto/common.h>
+#include <hash.h>
 #include <pubkey.h>
 #include <script/interpreter.h>
 #include <script/script.h>
@@ -16,6 +18,7 @@
 #include <algorithm>
 #include <cassert>
 #include <string>
+#include <string_view>
 #include <streams.h>
 
 typedef std::vector<unsigned char> valtype;
@@ -529,3 +532,139 @@ bool GetSenderPubKey(const CScript &outputPubKey, CScript &senderPubKey)
     }
     return false;
 }
+
+//! Split a contract output into its operations. The contract part starts after
+//! the OP_SENDER prefix, if there is one, and is
+//! <version> <gas limit> <gas price> <code or data> [<contract address>] OP_CREATE|OP_CALL
+static bool GetContractOps(const CScript& outputPubKey, std::vector<std::pair<opcodetype, valtype>>& ops, size_t& start)
+{
+    CScript::const_iterator pc = outputPubKey.begin();
+    opcodetype opcode;
+    valtype data;
+    start = 0;
+    while (pc < outputPubKey.end()) {
+        if (!outputPubKey.GetOp(pc, opcode, data))
+            return false;
+        ops.emplace_back(opcode, data);
+        if (opcode == OP_SENDER)
+            start = ops.size();
+    }
+    if (ops.empty())
+        return false;
+    const opcodetype last = ops.back().first;
+    const size_t expected = last == OP_CREATE ? 5 : last == OP_CALL ? 6 : 0;
+    return expected != 0 && ops.size() - start == expected;
+}
+
+static uint64_t ContractNum(const std::pair<opcodetype, valtype>& op)
+{
+    if (op.second.empty() && op.first >= OP_1 && op.first <= OP_16)
+        return CScript::DecodeOP_N(op.first);
+    return CScriptNum::vch_to_uint64(op.second);
+}
+
+bool ExtractContractGas(const CScript& outputPubKey, uint64_t& gasLimit, uint64_t& gasPrice)
+{
+    std::vector<std::pair<opcodetype, valtype>> ops;
+    size_t start;
+    if (!GetContractOps(outputPubKey, ops, start))
+        return false;
+    gasLimit = ContractNum(ops[start + 1]);
+    gasPrice = ContractNum(ops[start + 2]);
+    return true;
+}
+
+bool SetContractGasPrice(CScript& outputPubKey, uint64_t gasPrice)
+{
+    std::vector<std::pair<opcodetype, valtype>> ops;
+    size_t start;
+    if (gasPrice > INT64_MAX || !GetContractOps(outputPubKey, ops, start))
+        return false;
+    // The sender signature is pushed right before OP_SENDER
+    if (start >= 2)
+        ops[start - 2] = {OP_0, valtype()};
+    ops[start + 2] = {OP_PUSHDATA1, CScriptNum(int64_t(gasPrice)).getvch()};
+
+    // Write data pushes with the shortest push, everything else as it was
+    CScript script;
+    for (const auto& [opcode, data] : ops) {
+        if (opcode <= OP_PUSHDATA4)
+            script << data;
+        else
+            script << opcode;
+    }
+    outputPubKey = script;
+    return true;
+}
+
+/** Tags starting the null data of the MPoS balance outputs */
+static constexpr std::string_view MPOS_CLAIM_TAG{"mposclaim"};
+static constexpr std::string_view MPOS_CREDIT_TAG{"mposcredit"};
+
+static CScript MakeMPoSData(std::string_view tag, Span<const unsigned char> data)
+{
+    valtype push(tag.begin(), tag.end());
+    push.insert(push.end(), data.begin(), data.end());
+    return CScript() << OP_RETURN << push;
+}
+
+static bool MatchMPoSData(const CScript& script, std::string_view tag, size_t size, valtype& data)
+{
+    CScript::const_iterator pc = script.begin();
+    opcodetype opcode;
+    valtype push;
+    if (!script.GetOp(pc, opcode) || opcode != OP_RETURN)
+        return false;
+    if (!script.GetOp(pc, opcode, push) || opcode > OP_PUSHDATA4 || pc != script.end())
+        return false;
+    if (push.size() != tag.size() + size || !std::equal(tag.begin(), tag.end(), push.begin()))
+        return false;
+    data.assign(push.begin() + tag.size(), push.end());
+    return true;
+}
+
+CScript GetScriptForMPoSClaim(const uint160& keyid, CAmount amount)
+{
+    valtype data(keyid.begin(), keyid.end());
+    data.resize(uint160::size() + 8);
+    WriteLE64(data.data() + uint160::size(), uint64_t(amount));
+    return MakeMPoSData(MPOS_CLAIM_TAG, data);
+}
+
+bool ExtractMPoSClaim(const CScript& outputPubKey, uint160& keyid, CAmount& amount)
+{
+    valtype data;
+    if (!MatchMPoSData(outputPubKey, MPOS_CLAIM_TAG, uint160::size() + 8, data))
+        return false;
+    keyid = uint160(Span{data}.first(uint160::size()));
+    amount = CAmount(ReadLE64(data.data() + uint160::size()));
+    return true;
+}
+
+CScript GetScriptForMPoSCredit(const uint160& keyid)
+{
+    return MakeMPoSData(MPOS_CREDIT_TAG, keyid);
+}
+
+bool ExtractMPoSCredit(const CScript& outputPubKey, uint160& keyid)
+{
+    valtype data;
+    if (!MatchMPoSData(outputPubKey, MPOS_CREDIT_TAG, uint160::size(), data))
+        return false;
+    keyid = uint160(data);
+    return true;
+}
+
+bool GetMPoSBalanceKey(const CScript& scriptPubKey, uint160& keyid)
+{
+    valtype data;
+    if (MatchPayToPubkeyHash(scriptPubKey, data)) {
+        keyid = uint160(data);
+        return true;
+    }
+    if (MatchPayToPubkey(scriptPubKey, data)) {
+        keyid = Hash160(data);
+        return true;
+    }
+    return false;
+}
@@ -9,8 +9,10 @@
 #define BITCOIN_SCRIPT_SOLVER_H
 
 #include <attributes.h>
+#include <consensus/amount.h>
 #include <script/script.h>
 #include <span.h>
+#include <uint256.h>
 
 #include <string>
 #include <optional>
@@ -58,6 +60,34 @@ bool ExtractSenderData(const CScript& outputPubKey, CScript* senderPubKey, CScri
 
 bool GetSenderPubKey(const CScript& outputPubKey, CScript& senderPubKey);
 
+/** Parse the gas limit and the gas price of a contract (OP_CREATE or OP_CALL) output. */
+bool ExtractContractGas(const CScript& outputPubKey, uint64_t& gasLimit, uint64_t& gasPrice);
+
+/**
+ * Set the gas price of a contract output. The signature of an OP_SENDER output
+ * is cleared, as it does not commit to the changed transaction.
+ */
+bool SetContractGasPrice(CScript& outputPubKey, uint64_t gasPrice);
+
+/**
+ * Generate the null data output of a transaction claiming an accrued MPoS
+ * balance. The claim is valid when the first input of the transaction spends
+ * an output paying to the key hash, see Consensus::Params::nMPoSBalanceHeight.
+ */
+CScript GetScriptForMPoSClaim(const uint160& keyid, CAmount amount);
+
+/** Parse the key hash and the claimed amount of an MPoS balance claim output. */
+bool ExtractMPoSClaim(const CScript& outputPubKey, uint160& keyid, CAmount& amount);
+
+/** Generate the output of a delegated coinstake crediting the reward of the delegate to its MPoS balance. */
+CScript GetScriptForMPoSCredit(const uint160& keyid);
+
+/** Parse the key hash of an MPoS balance credit output. */
+bool ExtractMPoSCredit(const CScript& outputPubKey, uint160& keyid);
+
+/** Get the key hash owning the MPoS balance of a P2PKH or P2PK output. */
+bool GetMPoSBalanceKey(const CScript& scriptPubKey, uint160& keyid);
+
 /**
  * Parse a scriptPubKey and identify script type for standard scripts. If
  * successful, returns script type and parsed pubkeys or hashes, depending on
@@ -0,0 +1,114 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+#define BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Monotonic memory arena. Memory is handed out from large chunks by bumping a
+ * pointer, and is only released, all at once, when the arena is destroyed.
+ *
+ * This suits objects sharing one lifetime, such as the transactions of a
+ * deserialized block: instead of one heap allocation per object there is one
+ * per chunk, and the objects end up next to each other in memory.
+ *
+ * Allocate() is not thread-safe. The arena does not reuse freed memory, so
+ * only objects that are released together with the arena should be put in it.
+ */
+class MonotonicArena
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE{1 << 16};
+
+    explicit MonotonicArena(size_t chunk_size = DEFAULT_CHUNK_SIZE) : m_chunk_size{chunk_size} {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* Allocate(size_t bytes, size_t alignment)
+    {
+        size_t space = m_available_end - m_available_begin;
+        void* ptr = m_available_begin;
+        if (!ptr || !std::align(alignment, bytes, ptr, space)) {
+            // Start a new chunk, large enough for the request if it exceeds
+            // the chunk size. The rest of the current chunk is not used again.
+            if (bytes > std::numeric_limits<size_t>::max() - alignment) throw std::bad_alloc();
+            const size_t size{std::max(m_chunk_size, bytes + alignment)};
+            m_chunks.emplace_back(std::make_unique_for_overwrite<std::byte[]>(size));
+            m_allocated_bytes += size;
+            m_available_begin = m_chunks.back().get();
+            m_available_end = m_available_begin + size;
+            ptr = m_available_begin;
+            space = size;
+            std::align(alignment, bytes, ptr, space);
+        }
+        m_available_begin = static_cast<std::byte*>(ptr) + bytes;
+        return ptr;
+    }
+
+    //! Total size of the chunks allocated from the heap
+    size_t AllocatedBytes() const { return m_allocated_bytes; }
+
+    size_t NumChunks() const { return m_chunks.size(); }
+
+private:
+    const size_t m_chunk_size;
+    std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+    std::byte* m_available_begin{nullptr};
+    std::byte* m_available_end{nullptr};
+    size_t m_allocated_bytes{0};
+};
+
+/**
+ * Allocator handing out memory from a shared MonotonicArena, and keeping it alive.
+ *
+ * Deallocation is a no-op. Because every copy of the allocator holds a
+ * reference to the arena, objects created with std::allocate_shared keep the
+ * arena alive until the last of them is released, wherever they end up.
+ */
+template <typename T>
+class ArenaAllocator
+{
+    template <typename U>
+    friend class ArenaAllocator;
+
+    std::shared_ptr<MonotonicArena> m_arena;
+
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(std::shared_ptr<MonotonicArena> arena) noexcept : m_arena{std::move(arena)} {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena{other.m_arena} {}
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    T* allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    friend bool operator==(const ArenaAllocator& a, const ArenaAllocator<U>& b) noexcept
+    {
+        return a.m_arena == b.m_arena;
+    }
+};
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
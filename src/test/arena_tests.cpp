@@ -0,0 +1,107 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <streams.h>
+#include <support/allocators/arena.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(arena_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(arena_allocating)
+{
+    MonotonicArena arena{1024};
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 0U);
+
+    // Allocations are aligned and share a chunk
+    void* a = arena.Allocate(3, 1);
+    void* b = arena.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(b) % 8, 0U);
+    BOOST_CHECK(static_cast<std::byte*>(b) >= static_cast<std::byte*>(a) + 3);
+    void* c = arena.Allocate(16, 16);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(c) % 16, 0U);
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 1U);
+    BOOST_CHECK_EQUAL(arena.AllocatedBytes(), 1024U);
+
+    // A request larger than the chunk size gets a chunk of its own
+    void* big = arena.Allocate(4000, 8);
+    BOOST_CHECK(big != nullptr);
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 2U);
+    BOOST_CHECK(arena.AllocatedBytes() >= 1024U + 4000U);
+
+    // Running out of a chunk starts a new one
+    for (int i = 0; i < 100; ++i) arena.Allocate(64, 8);
+    BOOST_CHECK(arena.NumChunks() > 2U);
+}
+
+BOOST_AUTO_TEST_CASE(arena_allocator_lifetime)
+{
+    auto arena = std::make_shared<MonotonicArena>();
+    std::weak_ptr<MonotonicArena> weak{arena};
+    std::shared_ptr<const std::vector<int>> object{std::allocate_shared<const std::vector<int>>(ArenaAllocator<int>{arena}, 3, 7)};
+    arena.reset();
+    // The shared object keeps the arena alive
+    BOOST_CHECK(!weak.expired());
+    BOOST_CHECK_EQUAL(object->at(2), 7);
+    object.reset();
+    BOOST_CHECK(weak.expired());
+}
+
+BOOST_AUTO_TEST_CASE(block_with_arena)
+{
+    CBlock block;
+    block.nTime = 1234;
+    for (int i = 0; i < 50; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(Txid::FromUint256(uint256{uint8_t(i)}), i);
+        tx.vin[0].scriptSig = CScript() << std::vector<unsigned char>(i * 3, 0xab);
+        tx.vin[0].scriptWitness.stack.emplace_back(i, 0xcd);
+        tx.vout.emplace_back(i * COIN, CScript() << OP_TRUE << std::vector<unsigned char>(i, 0xef));
+        block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block);
+    const std::vector<std::byte> serialized{stream.begin(), stream.end()};
+
+    auto arena_block = std::make_unique<CBlock>();
+    stream >> TX_WITH_WITNESS(BlockWithArena{*arena_block, stream.size()});
+    BOOST_CHECK(stream.empty());
+    BOOST_CHECK_EQUAL(arena_block->GetHash(), block.GetHash());
+    BOOST_REQUIRE_EQUAL(arena_block->vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        BOOST_CHECK(*arena_block->vtx[i] == *block.vtx[i]);
+        BOOST_CHECK_EQUAL(arena_block->vtx[i]->GetWitnessHash(), block.vtx[i]->GetWitnessHash());
+    }
+    DataStream reserialized;
+    reserialized << TX_WITH_WITNESS(*arena_block);
+    BOOST_CHECK(std::vector<std::byte>(reserialized.begin(), reserialized.end()) == serialized);
+
+    // Detaching copies transactions out of the arena only
+    const CTransactionRef detached{BlockWithArena::Detach(arena_block->vtx[0])};
+    BOOST_CHECK(detached != arena_block->vtx[0]);
+    BOOST_CHECK(*detached == *arena_block->vtx[0]);
+    BOOST_CHECK(BlockWithArena::Detach(detached) == detached);
+    BOOST_CHECK(BlockWithArena::Detach(block.vtx[0]) == block.vtx[0]);
+
+    // A transaction outlives the block it was read with
+    const CTransactionRef tx{arena_block->vtx[49]};
+    arena_block.reset();
+    BOOST_CHECK_EQUAL(tx->GetHash(), block.vtx[49]->GetHash());
+    BOOST_CHECK_EQUAL(tx->vout[0].nValue, 49 * COIN);
+
+    // Truncated data fails like the default deserialization
+    DataStream truncated{Span{serialized}.first(serialized.size() - 10)};
+    CBlock failed;
+    BOOST_CHECK_THROW(truncated >> TX_WITH_WITNESS(BlockWithArena{failed, truncated.size()}), std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,178 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockorphanage.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(blockorphanage_tests, BasicTestingSetup)
+
+static std::shared_ptr<const CBlock> MakeBlock(FastRandomContext& rng, const uint256& prev, size_t padding = 0, const COutPoint& stake = {})
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].scriptSig = CScript() << rng.randbytes(8);
+    coinbase.vout.emplace_back(0, CScript() << std::vector<unsigned char>(padding));
+    auto block = std::make_shared<CBlock>();
+    block->hashPrevBlock = prev;
+    block->nTime = rng.rand32();
+    block->prevoutStake = stake;
+    block->vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+    return block;
+}
+
+static size_t Usage(const std::shared_ptr<const CBlock>& block)
+{
+    return GetSerializeSize(TX_WITH_WITNESS(*block));
+}
+
+BOOST_AUTO_TEST_CASE(add_and_extract)
+{
+    BlockOrphanage orphanage{1 << 20, 1 << 20};
+    const uint256 parent{m_rng.rand256()};
+    const auto a{MakeBlock(m_rng, parent)};
+    const auto b{MakeBlock(m_rng, parent)};
+    const auto c{MakeBlock(m_rng, a->GetHash())};
+    BOOST_CHECK(orphanage.AddBlock(a, 0));
+    BOOST_CHECK(!orphanage.AddBlock(a, 1));
+    BOOST_CHECK(orphanage.AddBlock(b, 1));
+    BOOST_CHECK(orphanage.AddBlock(c, 1));
+    BOOST_CHECK_EQUAL(orphanage.Size(), 3U);
+    BOOST_CHECK(orphanage.HaveBlock(a->GetHash()));
+    BOOST_CHECK(orphanage.HaveChild(parent));
+    BOOST_CHECK(orphanage.HaveChild(a->GetHash()));
+    BOOST_CHECK(!orphanage.HaveChild(c->GetHash()));
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(1), Usage(b) + Usage(c));
+    orphanage.SanityCheck();
+
+    // Children come out once, oldest first
+    const auto children{orphanage.ExtractChildren(parent)};
+    BOOST_REQUIRE_EQUAL(children.size(), 2U);
+    BOOST_CHECK(children[0].first == a);
+    BOOST_CHECK_EQUAL(children[0].second, 0);
+    BOOST_CHECK(children[1].first == b);
+    BOOST_CHECK_EQUAL(children[1].second, 1);
+    BOOST_CHECK(orphanage.ExtractChildren(parent).empty());
+    BOOST_CHECK_EQUAL(orphanage.Size(), 1U);
+    BOOST_CHECK_EQUAL(orphanage.ExtractChildren(a->GetHash()).size(), 1U);
+    BOOST_CHECK_EQUAL(orphanage.TotalUsage(), 0U);
+    orphanage.SanityCheck();
+}
+
+BOOST_AUTO_TEST_CASE(stakes)
+{
+    BlockOrphanage orphanage{1 << 20, 1 << 20};
+    const COutPoint stake{Txid::FromUint256(m_rng.rand256()), 1};
+    const auto a{MakeBlock(m_rng, m_rng.rand256(), 0, stake)};
+    const auto b{MakeBlock(m_rng, m_rng.rand256(), 0, stake)};
+    BOOST_CHECK(orphanage.AddBlock(a, 0));
+    BOOST_CHECK(orphanage.HaveStake(stake, a->nTime));
+    BOOST_CHECK(!orphanage.HaveStake(stake, a->nTime + 1));
+    BOOST_CHECK(!orphanage.HaveStake(COutPoint{stake.hash, 0}, a->nTime));
+
+    // The stake is remembered until the last orphan using it is gone
+    auto b_same_time{std::make_shared<CBlock>(*b)};
+    b_same_time->nTime = a->nTime;
+    BOOST_CHECK(orphanage.AddBlock(b_same_time, 1));
+    orphanage.EraseForPeer(0);
+    BOOST_CHECK(orphanage.HaveStake(stake, a->nTime));
+    orphanage.EraseForPeer(1);
+    BOOST_CHECK(!orphanage.HaveStake(stake, a->nTime));
+    BOOST_CHECK_EQUAL(orphanage.Size(), 0U);
+    orphanage.SanityCheck();
+}
+
+BOOST_AUTO_TEST_CASE(peer_quota)
+{
+    const size_t usage{Usage(MakeBlock(m_rng, uint256{}, 1000))};
+    // Room for eight blocks in total and two per peer
+    BlockOrphanage orphanage{8 * usage, 2 * usage};
+
+    // Too large for any peer
+    BOOST_CHECK(!orphanage.AddBlock(MakeBlock(m_rng, m_rng.rand256(), 3000), 0));
+
+    // A flooding peer only replaces its own orphans
+    const auto honest{MakeBlock(m_rng, m_rng.rand256(), 1000)};
+    BOOST_CHECK(orphanage.AddBlock(honest, 1));
+    std::shared_ptr<const CBlock> last;
+    for (int i = 0; i < 100; ++i) {
+        last = MakeBlock(m_rng, m_rng.rand256(), 1000);
+        BOOST_CHECK(orphanage.AddBlock(last, 0));
+        BOOST_CHECK(orphanage.UsageByPeer(0) <= 2 * usage);
+    }
+    BOOST_CHECK(orphanage.HaveBlock(honest->GetHash()));
+    BOOST_CHECK(orphanage.HaveBlock(last->GetHash()));
+    BOOST_CHECK_EQUAL(orphanage.Size(), 3U);
+    orphanage.SanityCheck();
+}
+
+BOOST_AUTO_TEST_CASE(pool_limit)
+{
+    // All orphans arrive within the same second, eviction still goes by arrival
+    SetMockTime(GetTime<std::chrono::seconds>());
+    const size_t usage{Usage(MakeBlock(m_rng, uint256{}, 1000))};
+    BlockOrphanage orphanage{4 * usage, 2 * usage};
+
+    // Peers 0 and 1 fill the pool
+    std::vector<std::shared_ptr<const CBlock>> blocks;
+    for (NodeId peer : {0, 0, 1, 1}) {
+        blocks.push_back(MakeBlock(m_rng, m_rng.rand256(), 1000));
+        BOOST_CHECK(orphanage.AddBlock(blocks.back(), peer));
+    }
+    BOOST_CHECK_EQUAL(orphanage.TotalUsage(), 4 * usage);
+
+    // A new peer evicts the oldest orphan of a peer using the most
+    const auto fresh{MakeBlock(m_rng, m_rng.rand256(), 1000)};
+    BOOST_CHECK(orphanage.AddBlock(fresh, 2));
+    BOOST_CHECK(orphanage.HaveBlock(fresh->GetHash()));
+    BOOST_CHECK(!orphanage.HaveBlock(blocks[0]->GetHash()));
+    BOOST_CHECK(orphanage.HaveBlock(blocks[1]->GetHash()));
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(0), usage);
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(1), 2 * usage);
+
+    // The next one comes from peer 1, which now uses the most
+    BOOST_CHECK(orphanage.AddBlock(MakeBlock(m_rng, m_rng.rand256(), 1000), 2));
+    BOOST_CHECK(!orphanage.HaveBlock(blocks[2]->GetHash()));
+    BOOST_CHECK_EQUAL(orphanage.Size(), 4U);
+    orphanage.SanityCheck();
+
+    orphanage.EraseForPeer(2);
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(2), 0U);
+    BOOST_CHECK_EQUAL(orphanage.Size(), 2U);
+    orphanage.SanityCheck();
+    SetMockTime(0s);
+}
+
+BOOST_AUTO_TEST_CASE(expiry)
+{
+    BlockOrphanage orphanage{1 << 20, 1 << 20};
+    const auto now{GetTime<std::chrono::seconds>()};
+    SetMockTime(now);
+    const auto old{MakeBlock(m_rng, m_rng.rand256())};
+    BOOST_CHECK(orphanage.AddBlock(old, 0));
+
+    SetMockTime(now + ORPHAN_BLOCK_EXPIRE_TIME - 1s);
+    const auto recent{MakeBlock(m_rng, m_rng.rand256())};
+    BOOST_CHECK(orphanage.AddBlock(recent, 1));
+    orphanage.Expire();
+    BOOST_CHECK_EQUAL(orphanage.Size(), 2U);
+
+    SetMockTime(now + ORPHAN_BLOCK_EXPIRE_TIME);
+    orphanage.Expire();
+    BOOST_CHECK(!orphanage.HaveBlock(old->GetHash()));
+    BOOST_CHECK(orphanage.HaveBlock(recent->GetHash()));
+    orphanage.SanityCheck();
+    SetMockTime(0s);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <chain.h>
+#include <crypto/dilithium.h>
+#include <hash.h>
+#include <node/blockstorage.h>
+#include <random.h>
+#include <script/interpreter.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <vector>
+
+namespace {
+/** Signature checker that only knows a fixed set of revealed Dilithium keys */
+class KeyRefChecker : public BaseSignatureChecker
+{
+public:
+    std::map<uint160, std::vector<unsigned char>> keys;
+
+    bool GetDilithiumPubKey(const uint160& keyid, std::vector<unsigned char>& pubkey) const override
+    {
+        auto it = keys.find(keyid);
+        if (it == keys.end()) return false;
+        pubkey = it->second;
+        return true;
+    }
+};
+
+ScriptError Verify(const CScript& scriptSig, const CScript& scriptPubKey, unsigned int flags, const BaseSignatureChecker& checker)
+{
+    ScriptError err;
+    BOOST_CHECK(!VerifyScript(scriptSig, scriptPubKey, nullptr, flags, checker, &err));
+    return err;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(dilithium_keyref_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(keyref_script_verification)
+{
+    const std::vector<unsigned char> pubkey{m_rng.randbytes(dilithium::PUBLIC_KEY_SIZE)};
+    const DilithiumPubKeyHash keyid{pubkey};
+    const CScript scriptPubKey{GetScriptForDestination(keyid)};
+    BOOST_CHECK(scriptPubKey.IsPayToDilithiumPubKeyHash());
+
+    const std::vector<unsigned char> keyref(keyid.begin(), keyid.end());
+    BOOST_CHECK_EQUAL(keyref.size(), DILITHIUM_KEYREF_SIZE);
+
+    // An empty signature gets past the key hash check and fails in OP_CHECKSIG_DILITHIUM,
+    // which tells a resolved key reference apart from an unresolved one.
+    const CScript fullSpend{CScript() << std::vector<unsigned char>() << pubkey};
+    const CScript refSpend{CScript() << std::vector<unsigned char>() << keyref};
+    const unsigned int flags{SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_DILITHIUM_KEYREF};
+
+    KeyRefChecker checker;
+    BOOST_CHECK_EQUAL(Verify(fullSpend, scriptPubKey, SCRIPT_VERIFY_P2SH, checker), SCRIPT_ERR_EVAL_FALSE);
+    BOOST_CHECK_EQUAL(Verify(fullSpend, scriptPubKey, flags, checker), SCRIPT_ERR_EVAL_FALSE);
+
+    // Before activation the key id is hashed like a public key and does not match
+    BOOST_CHECK_EQUAL(Verify(refSpend, scriptPubKey, SCRIPT_VERIFY_P2SH, checker), SCRIPT_ERR_EQUALVERIFY);
+
+    // Unknown key
+    BOOST_CHECK_EQUAL(Verify(refSpend, scriptPubKey, flags, checker), SCRIPT_ERR_DILITHIUM_KEYREF);
+
+    // Revealed key
+    checker.keys.emplace(uint160{keyref}, pubkey);
+    BOOST_CHECK_EQUAL(Verify(refSpend, scriptPubKey, flags, checker), SCRIPT_ERR_EVAL_FALSE);
+
+    // A reference must name the key id committed to by the output
+    std::vector<unsigned char> otherref{keyref};
+    otherref[0] ^= 1;
+    checker.keys.emplace(uint160{otherref}, pubkey);
+    const CScript otherSpend{CScript() << std::vector<unsigned char>() << otherref};
+    BOOST_CHECK_EQUAL(Verify(otherSpend, scriptPubKey, flags, checker), SCRIPT_ERR_DILITHIUM_KEYREF);
+
+    // References are only expanded for Dilithium pubkey hash outputs
+    const CScript p2pkh{GetScriptForDestination(PKHash(uint160{keyref}))};
+    BOOST_CHECK_EQUAL(Verify(refSpend, p2pkh, flags, checker), SCRIPT_ERR_EQUALVERIFY);
+}
+
+BOOST_AUTO_TEST_CASE(keyref_index)
+{
+    kernel::BlockTreeDB db{DBParams{.path = "", .cache_bytes = 1 << 20, .memory_only = true}};
+
+    // A chain of 50 blocks and a fork of it from height 40
+    std::vector<uint256> hashes;
+    for (int i = 0; i < 60; ++i) hashes.push_back(m_rng.rand256());
+    std::vector<CBlockIndex> blocks(60);
+    for (int i = 0; i < 60; ++i) {
+        blocks[i].nHeight = i < 50 ? i : i - 10;
+        blocks[i].pprev = i == 0 ? nullptr : (i == 50 ? &blocks[39] : &blocks[i - 1]);
+        blocks[i].phashBlock = &hashes[i];
+        blocks[i].BuildSkip();
+    }
+    const CBlockIndex* tip{&blocks[49]};
+    const CBlockIndex* fork_tip{&blocks[59]};
+
+    const std::vector<unsigned char> pubkey{m_rng.randbytes(dilithium::PUBLIC_KEY_SIZE)};
+    const uint160 keyid{Hash160(pubkey)};
+
+    const ChainDilithiumKeys lookup{db, tip};
+    std::vector<unsigned char> found;
+    BOOST_CHECK(!lookup.GetDilithiumPubKey(keyid, found));
+
+    BOOST_REQUIRE(db.WriteDilithiumKeyIndex({{keyid, CDilithiumKeyIndexValue(42, blocks[42].GetBlockHash(), pubkey)}}));
+    CDilithiumKeyIndexValue value;
+    BOOST_REQUIRE(db.ReadDilithiumKeyIndex(keyid, value));
+    BOOST_CHECK_EQUAL(value.blockHeight, 42);
+    BOOST_CHECK(value.blockHash == blocks[42].GetBlockHash());
+    BOOST_CHECK(value.pubkey == pubkey);
+
+    BOOST_CHECK(lookup.GetDilithiumPubKey(keyid, found));
+    BOOST_CHECK(found == pubkey);
+
+    // Keys revealed above the tip or outside its chain do not resolve
+    BOOST_CHECK(!ChainDilithiumKeys(db, &blocks[41]).GetDilithiumPubKey(keyid, found));
+    BOOST_CHECK(!ChainDilithiumKeys(db, fork_tip).GetDilithiumPubKey(keyid, found));
+    BOOST_CHECK(!ChainDilithiumKeys(db, nullptr).GetDilithiumPubKey(keyid, found));
+    BOOST_REQUIRE(db.WriteDilithiumKeyIndex({{keyid, CDilithiumKeyIndexValue(42, fork_tip->GetAncestor(42)->GetBlockHash(), pubkey)}}));
+    BOOST_CHECK(ChainDilithiumKeys(db, fork_tip).GetDilithiumPubKey(keyid, found));
+    BOOST_CHECK(!lookup.GetDilithiumPubKey(keyid, found));
+
+    BOOST_REQUIRE(db.EraseDilithiumKeyIndex({keyid}));
+    BOOST_CHECK(!db.ReadDilithiumKeyIndex(keyid, value));
+    BOOST_CHECK(!ChainDilithiumKeys(db, fork_tip).GetDilithiumPubKey(keyid, found));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,213 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <key.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <trust/trustscore.h>
+#include <validators/equivocation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <optional>
+#include <string>
+
+using validators::EquivocationDetector;
+using validators::EquivocationEvidence;
+
+static constexpr int64_t NOW{1700000000};
+
+static CBlockHeader SignedHeader(const CKey& key, const uint256& prev, const COutPoint& stake, uint32_t time, uint32_t nonce = 0)
+{
+    CBlockHeader header;
+    header.nVersion = 4;
+    header.hashPrevBlock = prev;
+    header.nTime = time;
+    header.nBits = 0x1d00ffff;
+    header.nNonce = nonce;
+    header.prevoutStake = stake;
+    std::vector<unsigned char> sig;
+    BOOST_REQUIRE(key.SignCompact(header.GetHashWithoutSign(), sig));
+    header.SetBlockSignature(sig);
+    return header;
+}
+
+BOOST_FIXTURE_TEST_SUITE(equivocation_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(same_parent_and_slot)
+{
+    const CKey key{GenerateRandomKey()};
+    const uint256 prev{m_rng.rand256()};
+    const COutPoint stake_a{Txid::FromUint256(m_rng.rand256()), 0};
+    const COutPoint stake_b{Txid::FromUint256(m_rng.rand256()), 1};
+    EquivocationDetector detector;
+
+    const CBlockHeader a{SignedHeader(key, prev, stake_a, NOW)};
+    BOOST_CHECK(!detector.AddHeader(a, NOW));
+    // Seeing the same header again is fine
+    BOOST_CHECK(!detector.AddHeader(a, NOW));
+    // Another staker in the same slot is fine
+    BOOST_CHECK(!detector.AddHeader(SignedHeader(GenerateRandomKey(), prev, stake_b, NOW), NOW));
+    // The next slot is fine
+    BOOST_CHECK(!detector.AddHeader(SignedHeader(key, prev, stake_a, NOW + 1), NOW));
+
+    // A second block on the same parent and slot, even with another stake
+    const CBlockHeader b{SignedHeader(key, prev, stake_b, NOW, /*nonce=*/1)};
+    std::optional<EquivocationEvidence> evidence{detector.AddHeader(b, NOW)};
+    BOOST_REQUIRE(evidence);
+
+    CKeyID offender;
+    std::string reason;
+    BOOST_CHECK(evidence->Verify(offender, reason));
+    BOOST_CHECK(offender == key.GetPubKey().GetID());
+
+    // Both orders give the same evidence
+    BOOST_CHECK_EQUAL(EquivocationEvidence(a, b).GetHash(), EquivocationEvidence(b, a).GetHash());
+    BOOST_CHECK_EQUAL(EquivocationEvidence(a, b).GetHash(), evidence->GetHash());
+
+    // Round trip through the wire format
+    DataStream ss{};
+    ss << *evidence;
+    EquivocationEvidence decoded;
+    ss >> decoded;
+    BOOST_CHECK_EQUAL(decoded.GetHash(), evidence->GetHash());
+    BOOST_CHECK(decoded.Verify(offender, reason));
+
+    BOOST_CHECK(detector.AddEvidence(evidence->GetHash()));
+    BOOST_CHECK(!detector.AddEvidence(evidence->GetHash()));
+    BOOST_CHECK(detector.HaveEvidence(evidence->GetHash()));
+}
+
+BOOST_AUTO_TEST_CASE(stake_reused_on_competing_tips)
+{
+    const CKey key{GenerateRandomKey()};
+    const COutPoint stake{Txid::FromUint256(m_rng.rand256()), 0};
+    EquivocationDetector detector;
+
+    BOOST_CHECK(!detector.AddHeader(SignedHeader(key, m_rng.rand256(), stake, NOW), NOW));
+    // Restaking the coin later on another tip is fine
+    BOOST_CHECK(!detector.AddHeader(SignedHeader(key, m_rng.rand256(), stake, NOW + 16), NOW));
+
+    std::optional<EquivocationEvidence> evidence{detector.AddHeader(SignedHeader(key, m_rng.rand256(), stake, NOW), NOW)};
+    BOOST_REQUIRE(evidence);
+    CKeyID offender;
+    std::string reason;
+    BOOST_CHECK(evidence->Verify(offender, reason));
+    BOOST_CHECK(offender == key.GetPubKey().GetID());
+}
+
+BOOST_AUTO_TEST_CASE(invalid_evidence)
+{
+    const CKey key{GenerateRandomKey()};
+    const uint256 prev{m_rng.rand256()};
+    const COutPoint stake{Txid::FromUint256(m_rng.rand256()), 0};
+    const CBlockHeader a{SignedHeader(key, prev, stake, NOW)};
+    CKeyID offender;
+    std::string reason;
+
+    // Different signers
+    BOOST_CHECK(!EquivocationEvidence(a, SignedHeader(GenerateRandomKey(), prev, stake, NOW, 1)).Verify(offender, reason));
+    BOOST_CHECK_EQUAL(reason, "different-signers");
+
+    // Different slots
+    BOOST_CHECK(!EquivocationEvidence(a, SignedHeader(key, prev, stake, NOW + 1)).Verify(offender, reason));
+    BOOST_CHECK_EQUAL(reason, "different-slot");
+
+    // Unrelated blocks of the same staker
+    const COutPoint other_stake{Txid::FromUint256(m_rng.rand256()), 0};
+    BOOST_CHECK(!EquivocationEvidence(a, SignedHeader(key, m_rng.rand256(), other_stake, NOW)).Verify(offender, reason));
+    BOOST_CHECK_EQUAL(reason, "no-conflict");
+
+    // Fields outside the signature changed by someone else
+    CBlockHeader malleated{a};
+    malleated.nGapSize = 7;
+    BOOST_CHECK(malleated.GetHash() != a.GetHash());
+    BOOST_CHECK(!EquivocationEvidence(a, malleated).Verify(offender, reason));
+    BOOST_CHECK_EQUAL(reason, "same-signed-header");
+    EquivocationDetector detector;
+    BOOST_CHECK(!detector.AddHeader(a, NOW));
+    BOOST_CHECK(!detector.AddHeader(malleated, NOW));
+
+    // Forged signature
+    CBlockHeader forged{SignedHeader(key, prev, stake, NOW, 1)};
+    forged.nNonce = 2;
+    BOOST_CHECK(!EquivocationEvidence(a, forged).Verify(offender, reason));
+}
+
+BOOST_AUTO_TEST_CASE(expiry)
+{
+    const CKey key{GenerateRandomKey()};
+    const uint256 prev{m_rng.rand256()};
+    const COutPoint stake{Txid::FromUint256(m_rng.rand256()), 0};
+    EquivocationDetector detector{/*window=*/60, /*max_headers=*/2};
+
+    // Too old to be indexed
+    BOOST_CHECK(!detector.AddHeader(SignedHeader(key, prev, stake, NOW - 61), NOW));
+    BOOST_CHECK_EQUAL(detector.Size(), 0U);
+
+    BOOST_CHECK(!detector.AddHeader(SignedHeader(key, prev, stake, NOW - 30), NOW - 30));
+    BOOST_CHECK_EQUAL(detector.Size(), 1U);
+    // Expired once the window has passed
+    BOOST_CHECK(!detector.AddHeader(SignedHeader(GenerateRandomKey(), prev, stake, NOW + 31), NOW + 31));
+    BOOST_CHECK_EQUAL(detector.Size(), 1U);
+
+    // Bounded in size
+    for (int i = 0; i < 5; ++i) {
+        detector.AddHeader(SignedHeader(GenerateRandomKey(), prev, stake, NOW + 31), NOW + 31);
+    }
+    BOOST_CHECK(detector.Size() <= 3U);
+}
+
+BOOST_AUTO_TEST_CASE(trust_demotion)
+{
+    const Consensus::Params& params{Params().GetConsensus()};
+    trust::TrustScoreManager manager{params};
+    const CKeyID id{GenerateRandomKey().GetPubKey().GetID()};
+    BOOST_REQUIRE(manager.RegisterValidator(id, params.nMinValidatorStake, 0, 1));
+    BOOST_CHECK(manager.GetValidatorTier(id) == trust::TrustTier::PLATINUM);
+
+    const fs::path path{m_args.GetDataDirBase() / "equivocations.dat"};
+    BOOST_CHECK(!manager.LoadDemotions(path));
+
+    BOOST_CHECK(manager.DemoteValidator(id, NOW));
+    BOOST_CHECK(manager.GetValidatorTier(id) == trust::TrustTier::GOLD);
+    BOOST_CHECK_EQUAL(manager.GetValidatorRewardMultiplier(id), params.nGoldRewardMultiplier);
+    BOOST_CHECK_EQUAL(manager.GetDemotions(id), 1);
+
+    // More evidence for the same slot, e.g. a third conflicting header, does not count again
+    BOOST_CHECK(!manager.DemoteValidator(id, NOW));
+    BOOST_CHECK_EQUAL(manager.GetDemotions(id), 1);
+
+    // Demotions survive a restart
+    {
+        trust::TrustScoreManager restarted{params};
+        BOOST_CHECK(restarted.LoadDemotions(path));
+        BOOST_REQUIRE(restarted.RegisterValidator(id, params.nMinValidatorStake, 0, 1));
+        BOOST_CHECK(restarted.GetValidatorTier(id) == trust::TrustTier::GOLD);
+        BOOST_CHECK(!restarted.DemoteValidator(id, NOW));
+    }
+
+    for (int i = 1; i <= 5; ++i) manager.DemoteValidator(id, NOW + 16 * i);
+    BOOST_CHECK_EQUAL(manager.GetDemotions(id), 6);
+    BOOST_CHECK(manager.GetValidatorTier(id) == trust::TrustTier::NONE);
+    BOOST_CHECK(!manager.IsValidatorEligible(id));
+
+    BOOST_CHECK(!manager.DemoteValidator(GenerateRandomKey().GetPubKey().GetID(), NOW));
+
+    // Demotions last one uptime window, also after a restart
+    manager.UpdateHeartbeatExpectations(params.nUptimeWindow - 1);
+    BOOST_CHECK_EQUAL(manager.GetDemotions(id), 6);
+    manager.UpdateHeartbeatExpectations(params.nUptimeWindow);
+    BOOST_CHECK_EQUAL(manager.GetDemotions(id), 0);
+    {
+        trust::TrustScoreManager restarted{params};
+        BOOST_CHECK(restarted.LoadDemotions(path));
+        BOOST_CHECK_EQUAL(restarted.GetDemotions(id), 0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <kernel/evmstate.h>
+#include <primitives/block.h>
+#include <qtum/qtumstate.h>
+#include <test/util/setup_common.h>
+#include <util/convert.h>
+#include <util/strencodings.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(evmstate_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(state_view_at_block)
+{
+    const uint160 address{ParseHex("0202020202020202020202020202020202020202")};
+    const dev::Address contract{uintToh160(address)};
+    CBlockIndex before;
+    before.hashStateRoot = h256Touint(globalState->rootHash());
+
+    globalState->createContract(contract);
+    globalState->setCode(contract, dev::bytes{0x60, 0x00}, 0);
+    globalState->setStorage(contract, 7, 42);
+    globalState->commit(dev::eth::State::CommitBehaviour::KeepEmptyAccounts);
+    globalState->db().commit();
+    CBlockIndex after;
+    after.hashStateRoot = h256Touint(globalState->rootHash());
+
+    const kernel::EvmStateView view{after};
+    BOOST_CHECK(view.AddressInUse(address));
+    BOOST_CHECK_EQUAL(view.Balance(address), 0);
+    BOOST_CHECK(view.Code(address) == std::vector<unsigned char>({0x60, 0x00}));
+    BOOST_CHECK_EQUAL(view.StorageAt(address, u256Touint(7)), u256Touint(42));
+    BOOST_CHECK_EQUAL(view.StorageAt(address, u256Touint(8)), uint256::ZERO);
+    const std::map<uint256, uint256> storage{view.Storage(address)};
+    BOOST_REQUIRE_EQUAL(storage.size(), 1U);
+    BOOST_CHECK_EQUAL(storage.begin()->first, u256Touint(7));
+    BOOST_CHECK_EQUAL(storage.begin()->second, u256Touint(42));
+
+    // An older block does not see the contract, and reading it leaves the
+    // root of the chainstate alone
+    const kernel::EvmStateView old_view{before};
+    BOOST_CHECK(!old_view.AddressInUse(address));
+    BOOST_CHECK(old_view.Code(address).empty());
+    BOOST_CHECK(globalState->rootHash() == uintToh256(after.hashStateRoot));
+}
+
+BOOST_AUTO_TEST_CASE(block_receipts)
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.emplace_back(0, CScript() << OP_TRUE);
+    CMutableTransaction call;
+    call.vin.resize(1);
+    call.vout.emplace_back(0, CScript() << ParseHex("00") << ParseHex("0202020202020202020202020202020202020202") << OP_CALL);
+    CBlock block;
+    block.vtx = {MakeTransactionRef(coinbase), MakeTransactionRef(call)};
+
+    TransactionReceiptInfo info{};
+    info.blockHash = block.GetHash();
+    info.blockNumber = 5;
+    info.transactionHash = block.vtx[1]->GetHash();
+    info.transactionIndex = 1;
+    info.to = dev::Address("0202020202020202020202020202020202020202");
+    info.gasUsed = 21000;
+    info.excepted = dev::eth::TransactionException::None;
+    info.logs.emplace_back(info.to, dev::h256s{dev::h256(dev::u256(1)), dev::h256(dev::u256(2))}, dev::bytes{0xab});
+    std::vector<TransactionReceiptInfo> results{info};
+    pstorageresult->addResult(uintToh256(block.vtx[1]->GetHash()), results);
+
+    LOCK(::cs_main);
+    BOOST_CHECK(kernel::GetTransactionReceipts(block.vtx[0]->GetHash()).empty());
+    const std::vector<kernel::ContractReceipt> receipts{kernel::GetBlockReceipts(block)};
+    BOOST_REQUIRE_EQUAL(receipts.size(), 1U);
+    const kernel::ContractReceipt& receipt{receipts[0]};
+    BOOST_CHECK_EQUAL(receipt.block_hash, block.GetHash());
+    BOOST_CHECK_EQUAL(receipt.block_number, 5U);
+    BOOST_CHECK_EQUAL(receipt.tx_hash, block.vtx[1]->GetHash());
+    BOOST_CHECK_EQUAL(receipt.tx_index, 1U);
+    BOOST_CHECK_EQUAL(HexStr(receipt.to), "0202020202020202020202020202020202020202");
+    BOOST_CHECK_EQUAL(receipt.gas_used, 21000U);
+    BOOST_CHECK_EQUAL(receipt.excepted, "None");
+    BOOST_REQUIRE_EQUAL(receipt.logs.size(), 1U);
+    BOOST_CHECK(receipt.logs[0].address == receipt.to);
+    BOOST_REQUIRE_EQUAL(receipt.logs[0].topics.size(), 2U);
+    BOOST_CHECK_EQUAL(receipt.logs[0].topics[1], u256Touint(2));
+    BOOST_CHECK(receipt.logs[0].data == std::vector<unsigned char>{0xab});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
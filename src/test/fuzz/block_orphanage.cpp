@@ -0,0 +1,88 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockorphanage.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <test/fuzz/FuzzedDataProvider.h>
+#include <test/fuzz/fuzz.h>
+#include <test/fuzz/util.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/check.h>
+#include <util/time.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+void initialize_block_orphanage()
+{
+    static const auto testing_setup = MakeNoLogFileContext();
+}
+
+FUZZ_TARGET(block_orphanage, .init = initialize_block_orphanage)
+{
+    FuzzedDataProvider fuzzed_data_provider(buffer.data(), buffer.size());
+    SetMockTime(ConsumeTime(fuzzed_data_provider));
+
+    const size_t max_usage{fuzzed_data_provider.ConsumeIntegralInRange<size_t>(0, 100'000)};
+    const size_t max_peer_usage{fuzzed_data_provider.ConsumeIntegralInRange<size_t>(0, 100'000)};
+    BlockOrphanage orphanage{max_usage, max_peer_usage};
+
+    // Blocks may build on earlier ones, so chains of orphans are exercised too
+    std::vector<uint256> hashes{uint256{}};
+    std::vector<COutPoint> stakes{COutPoint{}};
+    stakes.emplace_back(Txid::FromUint256(uint256::ONE), 0);
+
+    LIMITED_WHILE(fuzzed_data_provider.ConsumeBool(), 10'000)
+    {
+        const NodeId peer_id{fuzzed_data_provider.ConsumeIntegralInRange<NodeId>(0, 16)};
+        CallOneOf(
+            fuzzed_data_provider,
+            [&] {
+                CMutableTransaction coinbase;
+                coinbase.vin.resize(1);
+                coinbase.vin[0].scriptSig = CScript() << fuzzed_data_provider.ConsumeIntegral<uint32_t>();
+                coinbase.vout.emplace_back(0, CScript() << std::vector<unsigned char>(fuzzed_data_provider.ConsumeIntegralInRange<size_t>(0, 10'000)));
+                auto block{std::make_shared<CBlock>()};
+                block->hashPrevBlock = PickValue(fuzzed_data_provider, hashes);
+                block->nTime = fuzzed_data_provider.ConsumeIntegralInRange<uint32_t>(0, 4);
+                block->prevoutStake = PickValue(fuzzed_data_provider, stakes);
+                block->vtx.push_back(MakeTransactionRef(std::move(coinbase)));
+
+                const bool have_block{orphanage.HaveBlock(block->GetHash())};
+                const bool added{orphanage.AddBlock(block, peer_id)};
+                Assert(!have_block || !added);
+                if (added) {
+                    Assert(orphanage.HaveBlock(block->GetHash()));
+                    Assert(orphanage.HaveChild(block->hashPrevBlock));
+                    Assert(!block->IsProofOfStake() || orphanage.HaveStake(block->prevoutStake, block->nTime));
+                    Assert(GetSerializeSize(TX_WITH_WITNESS(*block)) <= orphanage.UsageByPeer(peer_id));
+                }
+                hashes.push_back(block->GetHash());
+            },
+            [&] {
+                const uint256 parent{PickValue(fuzzed_data_provider, hashes)};
+                for (const auto& [child, child_peer] : orphanage.ExtractChildren(parent)) {
+                    Assert(child->hashPrevBlock == parent);
+                    Assert(!orphanage.HaveBlock(child->GetHash()));
+                }
+                Assert(!orphanage.HaveChild(parent));
+            },
+            [&] {
+                orphanage.EraseForPeer(peer_id);
+                Assert(orphanage.UsageByPeer(peer_id) == 0);
+            },
+            [&] {
+                SetMockTime(GetTime<std::chrono::seconds>() + std::chrono::seconds{fuzzed_data_provider.ConsumeIntegralInRange<int64_t>(0, 3600)});
+                orphanage.Expire();
+            });
+
+        Assert(orphanage.TotalUsage() <= max_usage);
+        Assert(orphanage.UsageByPeer(peer_id) <= max_peer_usage);
+        orphanage.SanityCheck();
+    }
+}
@@ -8,6 +8,7 @@
 #include <headerssync.h>
 #include <pow.h>
 #include <test/util/setup_common.h>
+#include <util/time.h>
 #include <validation.h>
 #include <vector>
 
@@ -24,6 +25,12 @@ struct HeadersGeneratorSetup : public RegTestingSetup {
     void GenerateHeaders(std::vector<CBlockHeader>& headers, size_t count,
             const uint256& starting_hash, const int nVersion, int prev_time,
             const uint256& merkle_root, const uint32_t nBits);
+    /**
+     * Generate proof-of-stake headers, which have no proof of work, staking
+     * distinct outputs and advancing time by 16 seconds.
+     */
+    void GenerateStakeHeaders(std::vector<CBlockHeader>& headers, size_t count,
+            const uint256& starting_hash, int prev_time, const uint32_t nBits);
 };
 
 void HeadersGeneratorSetup::FindProofOfWork(CBlockHeader& starting_header)
@@ -55,6 +62,24 @@ void HeadersGeneratorSetup::GenerateHeaders(std::vector<CBlockHeader>& headers,
     return;
 }
 
+void HeadersGeneratorSetup::GenerateStakeHeaders(std::vector<CBlockHeader>& headers,
+        size_t count, const uint256& starting_hash, int prev_time, const uint32_t nBits)
+{
+    uint256 prev_hash = starting_hash;
+
+    while (headers.size() < count) {
+        CBlockHeader& next_header = headers.emplace_back();
+        next_header.nVersion = Params().GenesisBlock().nVersion;
+        next_header.hashPrevBlock = prev_hash;
+        next_header.nTime = prev_time + 16;
+        next_header.nBits = nBits;
+        next_header.prevoutStake = COutPoint(Txid::FromUint256(uint256::ONE), headers.size());
+        next_header.vchBlockSigDlgt = {0x01};
+        prev_hash = next_header.GetHash();
+        prev_time = next_header.nTime;
+    }
+}
+
 BOOST_FIXTURE_TEST_SUITE(headers_sync_chainwork_tests, HeadersGeneratorSetup)
 
 // In this test, we construct two sets of headers from genesis, one with
@@ -143,4 +168,97 @@ BOOST_AUTO_TEST_CASE(headers_sync_state)
     BOOST_CHECK(result.success);
 }
 
+// A flood of low-work headers longer than any chain that could exist at the
+// current time is aborted in presync, before its commitments exceed their
+// bound.
+BOOST_AUTO_TEST_CASE(headers_sync_long_flood)
+{
+    const CBlockHeader& genesis = Params().GenesisBlock();
+    const CBlockIndex* chain_start = WITH_LOCK(::cs_main, return m_node.chainman->m_blockman.LookupBlockIndex(genesis.GetHash()));
+    const arith_uint256 chain_work = UintToArith256(uint256{"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"});
+
+    // Right after genesis, a chain can have at most 6 headers per second of
+    // the allowed time in the future
+    SetMockTime(genesis.nTime);
+    const size_t max_headers = 6 * MAX_FUTURE_BLOCK_TIME;
+    std::vector<CBlockHeader> flood;
+    GenerateStakeHeaders(flood, max_headers + 200, genesis.GetHash(), genesis.nTime, genesis.nBits);
+
+    HeadersSyncState hss(0, Params().GetConsensus(), chain_start, chain_work);
+    BOOST_CHECK_EQUAL(hss.GetCommitmentPeriod(), 59U);
+    auto result = hss.ProcessNextHeaders(std::vector<CBlockHeader>(flood.begin(), flood.begin() + max_headers - 100), true);
+    BOOST_CHECK(result.success);
+    BOOST_CHECK(hss.GetState() == HeadersSyncState::State::PRESYNC);
+    result = hss.ProcessNextHeaders(std::vector<CBlockHeader>(flood.begin() + max_headers - 100, flood.end()), true);
+    BOOST_CHECK(!result.success);
+    BOOST_CHECK(hss.GetState() == HeadersSyncState::State::FINAL);
+    SetMockTime(0);
+}
+
+// Chains that could be very long store commitments for more headers, and
+// still resynchronize.
+BOOST_AUTO_TEST_CASE(headers_sync_commitment_period)
+{
+    const CBlockHeader& genesis = Params().GenesisBlock();
+    const CBlockIndex* chain_start = WITH_LOCK(::cs_main, return m_node.chainman->m_blockman.LookupBlockIndex(genesis.GetHash()));
+
+    // 10^9 seconds after genesis, a chain can have 6 * 10^9 headers, which
+    // would take over 100 million commitments at one per 59 headers
+    SetMockTime(int64_t{genesis.nTime} + 1'000'000'000);
+    const uint64_t max_headers = 6 * (1'000'000'000 + MAX_FUTURE_BLOCK_TIME);
+    const unsigned period = (max_headers + (1 << 21) - 1) >> 21;
+
+    const int target_blocks = 15000;
+    std::vector<CBlockHeader> chain;
+    GenerateStakeHeaders(chain, target_blocks, genesis.GetHash(), genesis.nTime, genesis.nBits);
+    const arith_uint256 chain_work = chain_start->nChainWork + GetBlockProof(CBlockIndex(chain.back())) * target_blocks;
+
+    HeadersSyncState hss(0, Params().GetConsensus(), chain_start, chain_work);
+    BOOST_CHECK_EQUAL(hss.GetCommitmentPeriod(), period);
+    BOOST_CHECK(period > 59);
+    (void)hss.ProcessNextHeaders(chain, true);
+    BOOST_CHECK(hss.GetState() == HeadersSyncState::State::REDOWNLOAD);
+    auto result = hss.ProcessNextHeaders(chain, true);
+    BOOST_CHECK(result.success);
+    BOOST_CHECK_EQUAL(result.pow_validated_headers.size(), chain.size());
+    BOOST_CHECK(hss.GetState() == HeadersSyncState::State::FINAL);
+    SetMockTime(0);
+}
+
+// The stake of one header per commitment period is checked in presync, and a
+// failed check aborts the sync.
+BOOST_AUTO_TEST_CASE(headers_sync_stake_spot_checks)
+{
+    const CBlockHeader& genesis = Params().GenesisBlock();
+    const CBlockIndex* chain_start = WITH_LOCK(::cs_main, return m_node.chainman->m_blockman.LookupBlockIndex(genesis.GetHash()));
+    const arith_uint256 chain_work = UintToArith256(uint256{"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"});
+
+    std::vector<CBlockHeader> chain;
+    GenerateStakeHeaders(chain, 2000, genesis.GetHash(), genesis.nTime, genesis.nBits);
+
+    std::vector<int> checked_heights;
+    HeadersSyncState hss(0, Params().GetConsensus(), chain_start, chain_work,
+        [&](const CBlockHeader& header, int height) {
+            BOOST_CHECK(header.GetHash() == chain.at(height - 1).GetHash());
+            checked_heights.push_back(height);
+            return true;
+        });
+    const unsigned period = hss.GetCommitmentPeriod();
+    BOOST_CHECK(hss.ProcessNextHeaders(chain, true).success);
+    BOOST_CHECK(hss.GetState() == HeadersSyncState::State::PRESYNC);
+    BOOST_CHECK_EQUAL(checked_heights.size(), chain.size() / period + (checked_heights.front() <= int(chain.size() % period) ? 1 : 0));
+    for (size_t i = 1; i < checked_heights.size(); ++i) {
+        BOOST_CHECK_EQUAL(checked_heights[i] - checked_heights[i - 1], int(period));
+    }
+
+    // A forged stake ends the sync at the first checked header
+    int checks = 0;
+    HeadersSyncState forged(0, Params().GetConsensus(), chain_start, chain_work,
+        [&](const CBlockHeader&, int) { ++checks; return false; });
+    auto result = forged.ProcessNextHeaders(chain, true);
+    BOOST_CHECK(!result.success);
+    BOOST_CHECK_EQUAL(checks, 1);
+    BOOST_CHECK(forged.GetState() == HeadersSyncState::State::FINAL);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,279 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <key.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <streams.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <trust/heartbeat_aggregate.h>
+#include <trust/heartbeat_net.h>
+#include <trust/trustscore.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using trust::HeartbeatAggregate;
+
+/** Consensus parameters with short heartbeat windows */
+static Consensus::Params AggregateParams()
+{
+    Consensus::Params params{Params().GetConsensus()};
+    params.nHeartbeatInterval = 10;
+    params.nHeartbeatInclusionWindow = 5;
+    params.nUptimeWindow = 1000;
+    params.nHeartbeatAggregateHeight = 100;
+    return params;
+}
+
+static std::map<CKeyID, std::vector<unsigned char>> Attest(const std::vector<CKey>& keys, int windowHeight, const uint256& windowBlockHash)
+{
+    std::map<CKeyID, std::vector<unsigned char>> attestations;
+    for (const CKey& key : keys) {
+        std::vector<unsigned char> sig;
+        BOOST_REQUIRE(key.SignCompact(trust::GetAttestationHash(windowHeight, windowBlockHash), sig));
+        attestations.emplace(key.GetPubKey().GetID(), sig);
+    }
+    return attestations;
+}
+
+BOOST_FIXTURE_TEST_SUITE(heartbeat_aggregate_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(encoding)
+{
+    const std::vector<CKey> keys{GenerateRandomKey(), GenerateRandomKey(), GenerateRandomKey()};
+    const uint256 window_hash{m_rng.rand256()};
+    const HeartbeatAggregate aggregate{120, Attest(keys, 120, window_hash)};
+
+    std::vector<CKeyID> signers;
+    BOOST_REQUIRE(aggregate.GetSigners(window_hash, signers));
+    BOOST_REQUIRE_EQUAL(signers.size(), keys.size());
+    BOOST_CHECK(std::is_sorted(signers.begin(), signers.end()));
+    for (const CKey& key : keys) {
+        BOOST_CHECK(std::find(signers.begin(), signers.end(), key.GetPubKey().GetID()) != signers.end());
+    }
+
+    // Attestations for another block recover to other keys
+    std::vector<CKeyID> other_signers;
+    if (aggregate.GetSigners(m_rng.rand256(), other_signers)) {
+        BOOST_CHECK(other_signers != signers);
+    }
+
+    // Only the ascending order is accepted
+    HeartbeatAggregate reordered{aggregate};
+    std::swap(reordered.signatures[0], reordered.signatures[1]);
+    BOOST_CHECK(!reordered.GetSigners(window_hash, signers));
+    HeartbeatAggregate duplicated{aggregate};
+    duplicated.signatures[1] = duplicated.signatures[0];
+    BOOST_CHECK(!duplicated.GetSigners(window_hash, signers));
+
+    // Round trip through a coinbase output
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    coinbase.vout[0].SetEmpty();
+    BOOST_CHECK_EQUAL(trust::GetHeartbeatAggregateIndex(CTransaction{coinbase}), -1);
+    coinbase.vout.emplace_back(0, trust::GetHeartbeatAggregateScript(aggregate));
+    BOOST_CHECK_EQUAL(trust::GetHeartbeatAggregateIndex(CTransaction{coinbase}), 1);
+    HeartbeatAggregate decoded;
+    BOOST_REQUIRE(trust::ReadHeartbeatAggregate(CTransaction{coinbase}, decoded));
+    BOOST_CHECK_EQUAL(decoded.windowHeight, aggregate.windowHeight);
+    BOOST_CHECK(decoded.signatures == aggregate.signatures);
+
+    // Trailing data is rejected
+    std::vector<unsigned char> data(trust::HEARTBEAT_AGGREGATE_HEADER.begin(), trust::HEARTBEAT_AGGREGATE_HEADER.end());
+    DataStream ss{};
+    ss << aggregate << uint8_t{0};
+    data.insert(data.end(), UCharCast(ss.data()), UCharCast(ss.data() + ss.size()));
+    coinbase.vout[1].scriptPubKey = CScript() << OP_RETURN << data;
+    BOOST_CHECK_EQUAL(trust::GetHeartbeatAggregateIndex(CTransaction{coinbase}), 1);
+    BOOST_CHECK(!trust::ReadHeartbeatAggregate(CTransaction{coinbase}, decoded));
+}
+
+BOOST_AUTO_TEST_CASE(inclusion_rules)
+{
+    const Consensus::Params params{AggregateParams()};
+    const std::vector<CKey> keys{GenerateRandomKey()};
+    const uint256 window_hash{m_rng.rand256()};
+    std::string reason;
+
+    BOOST_CHECK_EQUAL(trust::GetHeartbeatWindow(129, params), 120);
+    BOOST_CHECK_EQUAL(trust::GetHeartbeatWindow(130, params), 130);
+
+    const HeartbeatAggregate aggregate{120, Attest(keys, 120, window_hash)};
+    BOOST_CHECK(!trust::CheckHeartbeatAggregate(aggregate, 120, params, reason));
+    BOOST_CHECK(trust::CheckHeartbeatAggregate(aggregate, 121, params, reason));
+    BOOST_CHECK(trust::CheckHeartbeatAggregate(aggregate, 125, params, reason));
+    BOOST_CHECK(!trust::CheckHeartbeatAggregate(aggregate, 126, params, reason));
+
+    const HeartbeatAggregate unaligned{121, Attest(keys, 121, window_hash)};
+    BOOST_CHECK(!trust::CheckHeartbeatAggregate(unaligned, 122, params, reason));
+    BOOST_CHECK(!trust::CheckHeartbeatAggregate(HeartbeatAggregate{120, {}}, 121, params, reason));
+}
+
+BOOST_AUTO_TEST_CASE(coinbase_outputs)
+{
+    const uint256 window_hash{m_rng.rand256()};
+    const HeartbeatAggregate aggregate{120, Attest({GenerateRandomKey()}, 120, window_hash)};
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    coinbase.vout[0].SetEmpty();
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    BOOST_CHECK(CheckFirstCoinstakeOutput(block));
+
+    coinbase.vout.emplace_back(0, trust::GetHeartbeatAggregateScript(aggregate));
+    block.vtx[0] = MakeTransactionRef(coinbase);
+    BOOST_CHECK(CheckFirstCoinstakeOutput(block));
+
+    // Only one aggregate, carrying no value
+    coinbase.vout.emplace_back(0, trust::GetHeartbeatAggregateScript(aggregate));
+    block.vtx[0] = MakeTransactionRef(coinbase);
+    BOOST_CHECK(!CheckFirstCoinstakeOutput(block));
+    coinbase.vout.pop_back();
+    coinbase.vout[1].nValue = 1;
+    block.vtx[0] = MakeTransactionRef(coinbase);
+    BOOST_CHECK(!CheckFirstCoinstakeOutput(block));
+}
+
+BOOST_AUTO_TEST_CASE(identical_tiers_across_peer_views)
+{
+    const Consensus::Params params{AggregateParams()};
+    const CKey reliable{GenerateRandomKey()};
+    const CKey flaky{GenerateRandomKey()};
+    const CKeyID reliable_id{reliable.GetPubKey().GetID()};
+    const CKeyID flaky_id{flaky.GetPubKey().GetID()};
+
+    // Two nodes with the same validators but different peers
+    trust::TrustScoreManager node_a{params};
+    trust::TrustScoreManager node_b{params};
+    for (trust::TrustScoreManager* node : {&node_a, &node_b}) {
+        BOOST_REQUIRE(node->RegisterValidator(reliable_id, params.nMinValidatorStake, 0, 100));
+        BOOST_REQUIRE(node->RegisterValidator(flaky_id, params.nMinValidatorStake, 0, 100));
+    }
+
+    std::map<int, uint256> window_hashes;
+    for (int height = 101; height <= 400; ++height) {
+        const int window = trust::GetHeartbeatWindow(height - 1, params);
+        if (!window_hashes.count(window)) window_hashes[window] = m_rng.rand256();
+        node_a.SetHeight(height);
+        node_b.SetHeight(height);
+
+        // Only node A hears the flaky validator's heartbeats over P2P
+        if (height == window + 1) {
+            trust::Heartbeat heartbeat;
+            heartbeat.validatorId = flaky_id;
+            heartbeat.blockHeight = window;
+            node_a.ProcessHeartbeat(heartbeat, window);
+        }
+
+        // The chain includes the flaky validator in every other window
+        if (height == window + 2) {
+            std::vector<CKey> keys{reliable};
+            if ((window / params.nHeartbeatInterval) % 2) keys.push_back(flaky);
+            std::vector<CKeyID> signers;
+            BOOST_REQUIRE(HeartbeatAggregate(window, Attest(keys, window, window_hashes[window])).GetSigners(window_hashes[window], signers));
+            node_a.ConnectHeartbeatAggregate(window, signers);
+            node_b.ConnectHeartbeatAggregate(window, signers);
+        }
+        node_a.UpdateHeartbeatExpectations(height);
+        node_b.UpdateHeartbeatExpectations(height);
+    }
+
+    for (const CKeyID& id : {reliable_id, flaky_id}) {
+        BOOST_CHECK(node_a.GetValidatorTier(id) == node_b.GetValidatorTier(id));
+        BOOST_CHECK_EQUAL(node_a.GetValidator(id)->heartbeatsReceived, node_b.GetValidator(id)->heartbeatsReceived);
+        BOOST_CHECK_EQUAL(node_a.GetValidator(id)->heartbeatsExpected, node_b.GetValidator(id)->heartbeatsExpected);
+    }
+    BOOST_CHECK(node_a.GetValidatorTier(reliable_id) == trust::TrustTier::PLATINUM);
+    BOOST_CHECK(node_a.GetValidatorTier(flaky_id) == trust::TrustTier::NONE);
+    BOOST_CHECK(node_a.GetValidator(flaky_id)->lastHeartbeatHeight != node_b.GetValidator(flaky_id)->lastHeartbeatHeight);
+
+    // Disconnecting a block undoes its attestations on both nodes alike
+    const int last_window{trust::GetHeartbeatWindow(400 - params.nHeartbeatInclusionWindow, params)};
+    BOOST_CHECK_EQUAL(node_a.GetAttestedWindows(reliable_id, last_window - 1, last_window), 1);
+    node_a.DisconnectHeartbeatAggregate(last_window, {reliable_id});
+    node_b.DisconnectHeartbeatAggregate(last_window, {reliable_id});
+    BOOST_CHECK_EQUAL(node_a.GetAttestedWindows(reliable_id, last_window - 1, last_window), 0);
+    node_a.UpdateHeartbeatExpectations(400);
+    node_b.UpdateHeartbeatExpectations(400);
+    BOOST_CHECK(node_a.GetValidatorTier(reliable_id) == node_b.GetValidatorTier(reliable_id));
+    BOOST_CHECK(node_a.GetValidatorTier(reliable_id) != trust::TrustTier::PLATINUM);
+
+    // A restarted node reads the attested windows back
+    const fs::path path{m_args.GetDataDirBase() / "uptime.dat"};
+    const uint256 tip{m_rng.rand256()};
+    BOOST_REQUIRE(node_a.WriteAttestedWindows(path, tip));
+    trust::TrustScoreManager restarted{params};
+    uint256 read_tip;
+    BOOST_REQUIRE(restarted.ReadAttestedWindows(path, read_tip));
+    BOOST_CHECK_EQUAL(read_tip, tip);
+    for (const CKeyID& id : {reliable_id, flaky_id}) {
+        BOOST_CHECK_EQUAL(restarted.GetAttestedWindows(id, 0, 400), node_a.GetAttestedWindows(id, 0, 400));
+    }
+    BOOST_CHECK(restarted.GetAttestedWindows(reliable_id, 0, 400) > 0);
+    restarted.ClearAttestedWindows();
+    BOOST_CHECK_EQUAL(restarted.GetAttestedWindows(reliable_id, 0, 400), 0);
+}
+
+BOOST_AUTO_TEST_CASE(collect_attestations)
+{
+    const Consensus::Params params{AggregateParams()};
+    trust::TrustScoreManager trust_manager{params};
+    trust::HeartbeatManager manager{trust_manager, params};
+    const CKey key{GenerateRandomKey()};
+    const CKeyID id{key.GetPubKey().GetID()};
+    BOOST_REQUIRE(trust_manager.RegisterValidator(id, params.nMinValidatorStake, 0, 100));
+    manager.BlockConnected(121, nullptr, uint256());
+
+    trust::Heartbeat heartbeat;
+    heartbeat.validatorId = id;
+    heartbeat.blockHeight = 120;
+    heartbeat.blockHash = m_rng.rand256();
+    heartbeat.timestamp = 1;
+    BOOST_REQUIRE(heartbeat.Sign(key));
+    BOOST_REQUIRE(heartbeat.SignAttestation(key));
+    BOOST_CHECK(heartbeat.VerifyAttestation());
+
+    DataStream ss{};
+    ss << heartbeat;
+    trust::Heartbeat decoded;
+    ss >> decoded;
+    BOOST_CHECK(decoded.attestation == heartbeat.attestation);
+
+    // Older nodes send heartbeats without an attestation
+    trust::Heartbeat legacy{heartbeat};
+    legacy.attestation.clear();
+    ss << legacy;
+    ss.resize(ss.size() - 1);
+    ss >> decoded;
+    BOOST_CHECK(decoded.attestation.empty());
+    BOOST_CHECK_EQUAL(decoded.GetHash(), heartbeat.GetHash());
+
+    BOOST_CHECK(manager.ProcessHeartbeat(heartbeat, /*from=*/0));
+    const HeartbeatAggregate aggregate{manager.GetAggregate(120, heartbeat.blockHash)};
+    BOOST_CHECK_EQUAL(aggregate.signatures.size(), 1U);
+    BOOST_CHECK(manager.GetAggregate(120, m_rng.rand256()).signatures.empty());
+
+    // Committed on chain, and dropped once the window closes
+    manager.BlockConnected(122, &aggregate, heartbeat.blockHash);
+    BOOST_CHECK_EQUAL(trust_manager.GetAttestedWindows(id, 119, 120), 1);
+    manager.BlockConnected(126, nullptr, uint256());
+    BOOST_CHECK(manager.GetAggregate(120, heartbeat.blockHash).signatures.empty());
+
+    // Stale heartbeats are no longer gossiped
+    heartbeat.timestamp = 2;
+    BOOST_CHECK(!manager.ProcessHeartbeat(heartbeat, /*from=*/0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
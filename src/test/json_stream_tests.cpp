@@ -0,0 +1,87 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <common/json_stream.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(json_stream_tests, BasicTestingSetup)
+
+static UniValue SampleDocument()
+{
+    UniValue inner(UniValue::VOBJ);
+    inner.pushKV("escaped \"key\"", "line\nbreak");
+    inner.pushKV("empty_obj", UniValue(UniValue::VOBJ));
+    inner.pushKV("empty_arr", UniValue(UniValue::VARR));
+    inner.pushKV("null", UniValue());
+
+    UniValue arr(UniValue::VARR);
+    for (int i = 0; i < 100; ++i) {
+        arr.push_back(i);
+        arr.push_back(inner);
+    }
+
+    UniValue doc(UniValue::VOBJ);
+    doc.pushKV("flag", true);
+    doc.pushKV("amount", 1.5);
+    doc.pushKV("items", arr);
+    return doc;
+}
+
+BOOST_AUTO_TEST_CASE(matches_univalue_write)
+{
+    const UniValue doc{SampleDocument()};
+    for (const size_t flush_bytes : {size_t{1}, size_t{7}, size_t{4096}, JSONStreamWriter::DEFAULT_FLUSH_BYTES}) {
+        std::string out;
+        std::vector<size_t> parts;
+        bool got_last{false};
+        JSONStreamWriter writer{[&](std::string_view part, bool last) {
+            BOOST_CHECK(!got_last);
+            out += part;
+            parts.push_back(part.size());
+            got_last = last;
+        }, flush_bytes};
+        writer.Value(doc);
+        writer.Raw("\n");
+        writer.Finish();
+
+        BOOST_CHECK(got_last);
+        BOOST_CHECK_EQUAL(out, doc.write() + "\n");
+        BOOST_CHECK_EQUAL(writer.BytesWritten(), out.size());
+        if (flush_bytes < out.size()) {
+            BOOST_CHECK(parts.size() > 1);
+        } else {
+            BOOST_CHECK_EQUAL(parts.size(), 1U);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(element_by_element)
+{
+    const UniValue doc{SampleDocument()};
+    std::string out;
+    JSONStreamWriter writer{[&](std::string_view part, bool) { out += part; }, 16};
+    writer.BeginObject();
+    writer.Key("flag");
+    writer.Value(doc["flag"]);
+    writer.Key("amount");
+    writer.Value(doc["amount"]);
+    writer.Key("items");
+    writer.BeginArray();
+    for (const UniValue& item : doc["items"].getValues()) {
+        writer.Value(item);
+    }
+    writer.EndArray();
+    writer.EndObject();
+    writer.Finish();
+
+    BOOST_CHECK_EQUAL(out, doc.write());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
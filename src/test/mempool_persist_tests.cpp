@@ -0,0 +1,150 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <consensus/validation.h>
+#include <key.h>
+#include <node/mempool_persist.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using node::DumpMempool;
+using node::ImportMempoolOptions;
+using node::LoadMempool;
+
+struct MempoolPersistSetup : public TestChain100Setup {
+    MempoolPersistSetup() : TestChain100Setup{ChainType::UNITTEST, {.extra_args = {"-persistmempoolwitness=1"}}} {}
+
+    /** A transaction spending coinbase n that is valid apart from its signature */
+    CTransactionRef BadSignatureTx(size_t n, const CScript& spk)
+    {
+        CMutableTransaction mtx{CreateValidMempoolTransaction(m_coinbase_txns[n], 0, 0, coinbaseKey, spk,
+                                                              CAmount(19999 * COIN), /*submit=*/false)};
+        // Flip a bit in the middle of the DER signature
+        mtx.vin[0].scriptSig[10] ^= 1;
+        return MakeTransactionRef(mtx);
+    }
+
+    void ClearMempool(const std::vector<CTransactionRef>& txs)
+    {
+        LOCK(m_node.mempool->cs);
+        for (const auto& tx : txs) {
+            m_node.mempool->removeRecursive(*tx, MemPoolRemovalReason::REPLACED);
+        }
+        BOOST_REQUIRE_EQUAL(m_node.mempool->size(), 0U);
+    }
+
+    uint64_t FileVersion(const fs::path& path)
+    {
+        AutoFile file{fsbridge::fopen(path, "rb")};
+        uint64_t version;
+        file >> version;
+        return version;
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(mempool_persist_tests, MempoolPersistSetup)
+
+BOOST_AUTO_TEST_CASE(restore_witness_skips_scripts)
+{
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    CTxMemPool& pool{*m_node.mempool};
+    const CScript spk{CScript() << OP_TRUE};
+    const CTransactionRef bad{BadSignatureTx(0, spk)};
+
+    LOCK(cs_main);
+    BOOST_CHECK(AcceptToMemoryPool(chainstate, bad, GetTime(), false, /*test_accept=*/true).m_result_type ==
+                MempoolAcceptResult::ResultType::INVALID);
+
+    MempoolRestoreWitness witness;
+    witness.scripts_verified = true;
+    BOOST_CHECK(AcceptToMemoryPool(chainstate, bad, GetTime(), false, /*test_accept=*/true, &witness).m_result_type ==
+                MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK_EQUAL(pool.size(), 0U);
+
+    // Flags combine the policy and the next block's consensus flags
+    const uint64_t flags{GetMempoolScriptFlags(chainstate)};
+    BOOST_CHECK_EQUAL((flags >> 32) & STANDARD_SCRIPT_VERIFY_FLAGS, STANDARD_SCRIPT_VERIFY_FLAGS);
+    BOOST_CHECK((flags & 0xffffffff) != 0);
+}
+
+BOOST_AUTO_TEST_CASE(dump_and_load)
+{
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    CTxMemPool& pool{*m_node.mempool};
+    const CScript spk{CScript() << OP_TRUE};
+    const fs::path path{m_args.GetDataDirNet() / "mempool_persist_test.dat"};
+
+    // Build on a block of our own so that the saved tip can be invalidated
+    // without making the spent coinbases immature.
+    mineBlocks(1);
+
+    std::vector<CTransactionRef> txs;
+    for (size_t i = 1; i <= 3; ++i) {
+        txs.push_back(MakeTransactionRef(CreateValidMempoolTransaction(m_coinbase_txns[i], 0, 0, coinbaseKey, spk,
+                                                                       CAmount(19999 * COIN))));
+    }
+    // Smuggle in a transaction that fails script verification. It is only
+    // restored while the stored results are trusted.
+    const CTransactionRef bad{BadSignatureTx(0, spk)};
+    {
+        LOCK(cs_main);
+        MempoolRestoreWitness witness;
+        witness.scripts_verified = true;
+        BOOST_REQUIRE(AcceptToMemoryPool(chainstate, bad, GetTime(), false, false, &witness).m_result_type ==
+                      MempoolAcceptResult::ResultType::VALID);
+    }
+    txs.push_back(bad);
+    BOOST_REQUIRE_EQUAL(pool.size(), 4U);
+
+    // Without a chainstate the previous format is written
+    BOOST_REQUIRE(DumpMempool(pool, path, fsbridge::fopen, /*skip_file_commit=*/true));
+    BOOST_CHECK_EQUAL(FileVersion(path), 2U);
+    ClearMempool(txs);
+    BOOST_CHECK(LoadMempool(pool, path, chainstate, {}));
+    BOOST_CHECK_EQUAL(pool.size(), 3U);
+    BOOST_CHECK(!pool.exists(GenTxid::Txid(bad->GetHash())));
+    {
+        LOCK(cs_main);
+        MempoolRestoreWitness witness;
+        witness.scripts_verified = true;
+        BOOST_REQUIRE(AcceptToMemoryPool(chainstate, bad, GetTime(), false, false, &witness).m_result_type ==
+                      MempoolAcceptResult::ResultType::VALID);
+    }
+
+    BOOST_REQUIRE(DumpMempool(pool, path, fsbridge::fopen, /*skip_file_commit=*/true, &chainstate));
+    BOOST_CHECK_EQUAL(FileVersion(path), 3U);
+
+    // Same tip: everything comes back without re-verification
+    ClearMempool(txs);
+    BOOST_CHECK(LoadMempool(pool, path, chainstate, ImportMempoolOptions{.use_restore_witness = true}));
+    BOOST_CHECK_EQUAL(pool.size(), 4U);
+
+    // Stored results are not trusted unless requested, as for importmempool
+    ClearMempool(txs);
+    BOOST_CHECK(LoadMempool(pool, path, chainstate, {}));
+    BOOST_CHECK_EQUAL(pool.size(), 3U);
+    BOOST_CHECK(!pool.exists(GenTxid::Txid(bad->GetHash())));
+
+    // Saved tip reorged away: full validation
+    ClearMempool(txs);
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(cs_main, return chainstate.m_chain.Tip())};
+        BOOST_REQUIRE(chainstate.InvalidateBlock(state, tip));
+    }
+    BOOST_CHECK(LoadMempool(pool, path, chainstate, ImportMempoolOptions{.use_restore_witness = true}));
+    BOOST_CHECK_EQUAL(pool.size(), 3U);
+    BOOST_CHECK(!pool.exists(GenTxid::Txid(bad->GetHash())));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+#include <boost/test/unit_test.hpp>
+#include <test/util/setup_common.h>
+#include <key.h>
+#include <pubkey.h>
+#include <qtum/qtumutils.h>
+#include <util/convert.h>
+
+namespace BtcEcrecoverTest{
+
+/** btc_ecrecover as it was before it used libsecp256k1 directly */
+bool RecoverCompactReference(dev::h256 const& hash, dev::u256 const& v, dev::h256 const& r, dev::h256 const& s, dev::h256& key)
+{
+    if(v >= 256)
+        return false;
+    CPubKey pubKey;
+    std::vector<unsigned char> vchSig;
+    vchSig.push_back((unsigned char)v);
+    vchSig.insert(vchSig.end(), r.begin(), r.end());
+    vchSig.insert(vchSig.end(), s.begin(), s.end());
+    if(!pubKey.RecoverCompact(h256Touint(hash), vchSig))
+        return false;
+    CKeyID id = pubKey.GetID();
+    size_t padding = sizeof(key) - sizeof(id);
+    memset(key.data(), 0, padding);
+    memcpy(key.data() + padding, id.begin(), sizeof(id));
+    return true;
+}
+
+/** Check that the direct and the cached paths agree with the reference */
+void CheckEquivalent(dev::h256 const& hash, dev::u256 const& v, dev::h256 const& r, dev::h256 const& s)
+{
+    dev::h256 expected, uncached, cached;
+    const bool recovered = RecoverCompactReference(hash, v, r, s, expected);
+    BOOST_CHECK_EQUAL(qtumutils::btc_ecrecover_uncached(hash, v, r, s, uncached), recovered);
+    BOOST_CHECK_EQUAL(qtumutils::btc_ecrecover(hash, v, r, s, cached), recovered);
+    if (recovered) {
+        BOOST_CHECK(uncached == expected);
+        BOOST_CHECK(cached == expected);
+    }
+}
+
+struct Signature {
+    dev::h256 hash;
+    dev::u256 v;
+    dev::h256 r;
+    dev::h256 s;
+    CKeyID id;
+};
+
+Signature Sign(bool compressed)
+{
+    const CKey key{GenerateRandomKey(compressed)};
+    const uint256 hash{GetRandHash()};
+    std::vector<unsigned char> sig;
+    BOOST_REQUIRE(key.SignCompact(hash, sig));
+    return {uintToh256(hash), sig[0], dev::h256(&sig[1], dev::h256::ConstructFromPointer), dev::h256(&sig[33], dev::h256::ConstructFromPointer), key.GetPubKey().GetID()};
+}
+
+BOOST_FIXTURE_TEST_SUITE(btcecrecover_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(btc_ecrecover_signatures){
+    for (int i = 0; i < 50; i++) {
+        const Signature sig = Sign(i % 2 == 0);
+        dev::h256 key;
+        BOOST_REQUIRE(qtumutils::btc_ecrecover(sig.hash, sig.v, sig.r, sig.s, key));
+        BOOST_CHECK(dev::right160(key) == dev::h160(sig.id.begin(), dev::h160::ConstructFromPointer));
+        BOOST_CHECK(key.ref().cropped(0, 12).toBytes() == dev::bytes(12, 0));
+        CheckEquivalent(sig.hash, sig.v, sig.r, sig.s);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(btc_ecrecover_headers){
+    // Every header byte, valid or not, and headers that do not fit in a byte
+    const Signature sig = Sign(true);
+    for (unsigned v = 0; v < 300; v++) {
+        CheckEquivalent(sig.hash, v, sig.r, sig.s);
+    }
+    dev::h256 key;
+    BOOST_CHECK(!qtumutils::btc_ecrecover(sig.hash, dev::u256(1) << 200, sig.r, sig.s, key));
+}
+
+BOOST_AUTO_TEST_CASE(btc_ecrecover_invalid){
+    const Signature sig = Sign(false);
+    const dev::h256 zero;
+    const dev::h256 overflow(ParseHex("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"));
+    for (unsigned v = 27; v < 35; v++) {
+        CheckEquivalent(sig.hash, v, zero, sig.s);
+        CheckEquivalent(sig.hash, v, sig.r, zero);
+        CheckEquivalent(sig.hash, v, overflow, sig.s);
+        CheckEquivalent(sig.hash, v, sig.r, overflow);
+        CheckEquivalent(zero, v, sig.r, sig.s);
+    }
+
+    // A failed recovery leaves the output as it is, also when cached
+    dev::h256 key(1);
+    BOOST_CHECK(!qtumutils::btc_ecrecover(sig.hash, 27, zero, sig.s, key));
+    BOOST_CHECK(!qtumutils::btc_ecrecover(sig.hash, 27, zero, sig.s, key));
+    BOOST_CHECK(key == dev::h256(1));
+}
+
+BOOST_AUTO_TEST_CASE(btc_ecrecover_cache_eviction){
+    // More signatures than the cache holds, recovered twice so that the
+    // second pass mixes hits and replaced entries
+    std::vector<Signature> sigs;
+    for (int i = 0; i < 200; i++) {
+        sigs.push_back(Sign(i % 3 != 0));
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        for (const Signature& sig : sigs) {
+            dev::h256 key;
+            BOOST_REQUIRE(qtumutils::btc_ecrecover(sig.hash, sig.v, sig.r, sig.s, key));
+            BOOST_CHECK(dev::right160(key) == dev::h160(sig.id.begin(), dev::h160::ConstructFromPointer));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
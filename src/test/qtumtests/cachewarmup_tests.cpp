@@ -0,0 +1,107 @@
+#include <boost/test/unit_test.hpp>
+#include <test/util/setup_common.h>
+#include <node/cache_warmup.h>
+#include <streams.h>
+#include <util/convert.h>
+#include <util/signalinterrupt.h>
+#include <validation.h>
+
+#include <algorithm>
+
+namespace CacheWarmupTest{
+
+BOOST_FIXTURE_TEST_SUITE(cachewarmup_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(warm_caches_after_restart){
+    ChainstateManager& chainman = *m_node.chainman;
+    Chainstate& chainstate = chainman.ActiveChainstate();
+    const fs::path path{m_args.GetDataDirNet() / "warmcache.dat"};
+
+    // Trie nodes read from disk are recorded
+    node::RecordStateReads(*globalState);
+    const dev::h256 root = globalState->rootHash();
+    BOOST_CHECK(!globalState->db().lookup(root).empty());
+
+    node::CacheWarmupKeys keys;
+    {
+        LOCK(cs_main);
+        keys = node::GetCacheWarmupKeys(chainstate);
+        BOOST_CHECK(keys.tip == chainstate.m_chain.Tip()->GetBlockHash());
+        BOOST_CHECK(!keys.coins.empty());
+        BOOST_CHECK(std::find(keys.state_nodes.begin(), keys.state_nodes.end(), h256Touint(root)) != keys.state_nodes.end());
+        BOOST_CHECK(node::DumpCacheWarmupKeys(keys, path));
+
+        // Flushing empties the coins cache, as after a restart
+        chainstate.ForceFlushStateToDisk();
+        BOOST_CHECK_EQUAL(chainstate.CoinsTip().GetCacheSize(), 0U);
+    }
+
+    BOOST_CHECK(!node::IsCacheWarmupActive());
+    BOOST_REQUIRE(node::LoadCacheWarmup(path));
+    BOOST_CHECK(node::IsCacheWarmupActive());
+    node::CacheWarmupProgress progress = node::GetCacheWarmupProgress();
+    BOOST_CHECK_EQUAL(progress.coins, keys.coins.size());
+    BOOST_CHECK_EQUAL(progress.nodes, keys.state_nodes.size() + keys.utxo_nodes.size());
+    BOOST_CHECK_EQUAL(progress.coins_loaded, 0U);
+
+    node::RunCacheWarmup(chainstate, chainman.m_interrupt);
+    progress = node::GetCacheWarmupProgress();
+    BOOST_CHECK(!progress.active);
+    BOOST_CHECK(progress.complete);
+    BOOST_CHECK_EQUAL(progress.coins_loaded, progress.coins);
+    BOOST_CHECK_EQUAL(progress.nodes_loaded, progress.nodes);
+    {
+        LOCK(cs_main);
+        for (const COutPoint& outpoint : keys.coins) {
+            BOOST_CHECK(chainstate.CoinsTip().HaveCoinInCache(outpoint));
+        }
+    }
+
+    // The keys are consumed by the warm-up
+    node::RunCacheWarmup(chainstate, chainman.m_interrupt);
+    BOOST_CHECK_EQUAL(node::GetCacheWarmupProgress().coins_loaded, progress.coins);
+}
+
+BOOST_AUTO_TEST_CASE(interrupted_warmup){
+    ChainstateManager& chainman = *m_node.chainman;
+    Chainstate& chainstate = chainman.ActiveChainstate();
+    const fs::path path{m_args.GetDataDirNet() / "warmcache.dat"};
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(node::DumpCacheWarmupKeys(node::GetCacheWarmupKeys(chainstate), path));
+    }
+
+    BOOST_REQUIRE(node::LoadCacheWarmup(path));
+    util::SignalInterrupt interrupt;
+    BOOST_CHECK(interrupt());
+    node::RunCacheWarmup(chainstate, interrupt);
+    const node::CacheWarmupProgress progress = node::GetCacheWarmupProgress();
+    BOOST_CHECK(!progress.active);
+    BOOST_CHECK(!progress.complete);
+    BOOST_CHECK(progress.coins > 0);
+    BOOST_CHECK_EQUAL(progress.coins_loaded, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(load_bad_files){
+    const fs::path path{m_args.GetDataDirNet() / "warmcache.dat"};
+    BOOST_CHECK(!node::LoadCacheWarmup(path));
+
+    // Unknown version
+    {
+        AutoFile file{fsbridge::fopen(path, "wb")};
+        file << uint64_t{2} << uint256{};
+    }
+    BOOST_CHECK(!node::LoadCacheWarmup(path));
+
+    // Truncated
+    {
+        AutoFile file{fsbridge::fopen(path, "wb")};
+        file << uint64_t{1} << uint256{};
+    }
+    BOOST_CHECK(!node::LoadCacheWarmup(path));
+    BOOST_CHECK(!node::IsCacheWarmupActive());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
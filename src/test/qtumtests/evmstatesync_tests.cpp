@@ -0,0 +1,226 @@
+#include <boost/test/unit_test.hpp>
+#include <test/util/setup_common.h>
+#include <qtum/evmstatesync.h>
+#include <qtum/stateproof.h>
+#include <util/convert.h>
+#include <libdevcore/Address.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TrieCommon.h>
+#include <libethereum/SecureTrieDB.h>
+
+namespace EVMStateSyncTest{
+
+using AccountTrie = dev::eth::SecureTrieDB<dev::Address, dev::OverlayDB>;
+using StorageTrie = dev::eth::SecureTrieDB<dev::h256, dev::OverlayDB>;
+
+const dev::bytes CODE = ParseHex("600035600055" "00");
+
+dev::Address Account(unsigned i)
+{
+    return dev::Address(dev::u160(i + 1));
+}
+
+dev::h256 Slot(unsigned i)
+{
+    return dev::h256(dev::u256(i));
+}
+
+dev::bytes AccountRLP(dev::h256 const& storage_root, dev::h256 const& code_hash)
+{
+    dev::RLPStream stream(4);
+    stream << dev::u256(1) << dev::u256(100) << storage_root << code_hash;
+    return stream.out();
+}
+
+/**
+ * Source of the sync: a contract with code and 300 storage slots among 100
+ * plain accounts, and a contract UTXO trie of 20 entries
+ */
+struct SourceState {
+    dev::OverlayDB state_db;
+    dev::OverlayDB utxo_db;
+    dev::h256 storage_root;
+    dev::h256 state_root;
+    dev::h256 utxo_root;
+
+    SourceState()
+    {
+        StorageTrie storage(&state_db);
+        storage.init();
+        for (unsigned i = 0; i < 300; i++) {
+            storage.insert(Slot(i), dev::rlp(dev::u256(i + 1)));
+        }
+        storage_root = storage.root();
+        state_db.insert(dev::sha3(CODE), &CODE);
+
+        AccountTrie accounts(&state_db);
+        accounts.init();
+        for (unsigned i = 1; i < 100; i++) {
+            accounts.insert(Account(i), AccountRLP(dev::EmptyTrie, dev::EmptySHA3));
+        }
+        accounts.insert(Account(0), AccountRLP(storage_root, dev::sha3(CODE)));
+        state_root = accounts.root();
+
+        AccountTrie utxos(&utxo_db);
+        utxos.init();
+        for (unsigned i = 0; i < 20; i++) {
+            utxos.insert(Account(i), dev::rlp(dev::u256(i)));
+        }
+        utxo_root = utxos.root();
+    }
+
+    /** Write slot 7 of the contract, which changes the state root */
+    void Change(unsigned value)
+    {
+        StorageTrie storage(&state_db);
+        storage.setRoot(storage_root);
+        storage.insert(Slot(7), dev::rlp(dev::u256(value)));
+        storage_root = storage.root();
+        AccountTrie accounts(&state_db);
+        accounts.setRoot(state_root);
+        accounts.insert(Account(0), AccountRLP(storage_root, dev::sha3(CODE)));
+        state_root = accounts.root();
+    }
+};
+
+/** Answer the requests of sync from source until it is complete */
+void Sync(qtum::EVMStateSync& sync, SourceState const& source)
+{
+    for (int i = 0; i < 1000 && !sync.IsComplete(); i++) {
+        std::vector<qtum::EVMStateRequest> requests = sync.NextRequests(qtum::MAX_EVM_STATE_REQUEST);
+        BOOST_REQUIRE(!requests.empty());
+        BOOST_REQUIRE(sync.ProcessResponse(requests, qtum::LookupEVMState(source.state_db, source.utxo_db, requests)));
+    }
+    BOOST_CHECK(sync.IsComplete());
+}
+
+/** Check that db has the same value as source for key */
+void CheckKey(dev::OverlayDB const& db, dev::OverlayDB const& source_db, dev::h256 const& root, dev::bytes const& key)
+{
+    std::vector<dev::bytes> values, source_values, nodes;
+    BOOST_REQUIRE(qtum::ProveTrieKeys(db, root, {key}, values, nodes));
+    BOOST_REQUIRE(qtum::ProveTrieKeys(source_db, root, {key}, source_values, nodes));
+    BOOST_CHECK(!values[0].empty());
+    BOOST_CHECK(values[0] == source_values[0]);
+}
+
+BOOST_FIXTURE_TEST_SUITE(evmstatesync_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(sync_state){
+    SourceState source;
+    dev::OverlayDB state_db, utxo_db;
+    const uint256 block_hash{1};
+    BOOST_CHECK(!qtum::HasEVMState(state_db, utxo_db, h256Touint(source.state_root), h256Touint(source.utxo_root)));
+
+    qtum::EVMStateSync sync(state_db, utxo_db);
+    BOOST_CHECK(!sync.IsComplete());
+    sync.SetTarget(block_hash, h256Touint(source.state_root), h256Touint(source.utxo_root));
+    Sync(sync, source);
+    BOOST_CHECK(qtum::HasEVMState(state_db, utxo_db, h256Touint(source.state_root), h256Touint(source.utxo_root)));
+
+    // Accounts, storage, code and the contract UTXO trie are all there, as
+    // well as the keys the tries are hashed by
+    CheckKey(state_db, source.state_db, source.state_root, Account(0).asBytes());
+    CheckKey(state_db, source.state_db, source.state_root, Account(99).asBytes());
+    CheckKey(state_db, source.state_db, source.storage_root, Slot(0).asBytes());
+    CheckKey(state_db, source.state_db, source.storage_root, Slot(299).asBytes());
+    CheckKey(utxo_db, source.utxo_db, source.utxo_root, Account(19).asBytes());
+    BOOST_CHECK(dev::asBytes(state_db.lookup(dev::sha3(CODE))) == CODE);
+    BOOST_CHECK(state_db.lookupAux(dev::sha3(Account(42))) == Account(42).asBytes());
+    BOOST_CHECK(state_db.lookupAux(dev::sha3(Slot(42))) == Slot(42).asBytes());
+    BOOST_CHECK(utxo_db.lookupAux(dev::sha3(Account(7))) == Account(7).asBytes());
+
+    qtum::EVMStateSync::Stats stats = sync.GetStats();
+    BOOST_CHECK(stats.block_hash == block_hash);
+    BOOST_CHECK(stats.complete);
+    BOOST_CHECK_EQUAL(stats.pending, 0U);
+    BOOST_CHECK_EQUAL(stats.codes, 1U);
+    BOOST_CHECK_EQUAL(stats.keys, 100U + 300U + 20U);
+    BOOST_CHECK(stats.nodes > 0);
+    BOOST_CHECK(stats.bytes > 0);
+}
+
+BOOST_AUTO_TEST_CASE(sync_heals_after_new_target){
+    SourceState source;
+    dev::OverlayDB state_db, utxo_db;
+    qtum::EVMStateSync sync(state_db, utxo_db);
+    sync.SetTarget(uint256{1}, h256Touint(source.state_root), h256Touint(source.utxo_root));
+
+    // Part of the state arrives before the target moves. Nothing that is
+    // written is without the nodes below it, so the roots are not there.
+    for (int i = 0; i < 3; i++) {
+        std::vector<qtum::EVMStateRequest> requests = sync.NextRequests(20);
+        BOOST_REQUIRE(sync.ProcessResponse(requests, qtum::LookupEVMState(source.state_db, source.utxo_db, requests)));
+    }
+    BOOST_CHECK(!sync.IsComplete());
+    BOOST_CHECK(!qtum::HasEVMState(state_db, utxo_db, h256Touint(source.state_root), h256Touint(source.utxo_root)));
+
+    source.Change(1000);
+    sync.SetTarget(uint256{2}, h256Touint(source.state_root), h256Touint(source.utxo_root));
+    Sync(sync, source);
+    CheckKey(state_db, source.state_db, source.storage_root, Slot(7).asBytes());
+    CheckKey(state_db, source.state_db, source.storage_root, Slot(8).asBytes());
+    const uint64_t nodes = sync.GetStats().nodes;
+
+    // Moving to a newer state only downloads what changed
+    source.Change(2000);
+    sync.SetTarget(uint256{3}, h256Touint(source.state_root), h256Touint(source.utxo_root));
+    BOOST_CHECK(!sync.IsComplete());
+    Sync(sync, source);
+    CheckKey(state_db, source.state_db, source.storage_root, Slot(7).asBytes());
+    BOOST_CHECK(sync.GetStats().nodes - nodes < 20);
+
+    // A state that is already stored is complete at once
+    sync.SetTarget(uint256{4}, h256Touint(source.state_root), h256Touint(source.utxo_root));
+    BOOST_CHECK(sync.IsComplete());
+    BOOST_CHECK(sync.NextRequests(qtum::MAX_EVM_STATE_REQUEST).empty());
+}
+
+BOOST_AUTO_TEST_CASE(sync_rejects_bad_data){
+    SourceState source;
+    dev::OverlayDB state_db, utxo_db;
+    qtum::EVMStateSync sync(state_db, utxo_db);
+    sync.SetTarget(uint256{1}, h256Touint(source.state_root), h256Touint(source.utxo_root));
+
+    std::vector<qtum::EVMStateRequest> requests = sync.NextRequests(qtum::MAX_EVM_STATE_REQUEST);
+    BOOST_REQUIRE_EQUAL(requests.size(), 2U);
+    std::vector<dev::bytes> data = qtum::LookupEVMState(source.state_db, source.utxo_db, requests);
+
+    // Data that does not match its hash, and a response of the wrong size
+    std::vector<dev::bytes> bad{data};
+    bad[0].back() ^= 1;
+    BOOST_CHECK(!sync.ProcessResponse(requests, bad));
+    BOOST_CHECK(sync.NextRequests(qtum::MAX_EVM_STATE_REQUEST) == requests);
+    BOOST_CHECK(!sync.ProcessResponse(requests, std::vector<dev::bytes>{data[0]}));
+    BOOST_CHECK(sync.NextRequests(qtum::MAX_EVM_STATE_REQUEST) == requests);
+
+    // Unknown entries are requested again
+    BOOST_CHECK(sync.ProcessResponse(requests, std::vector<dev::bytes>{{}, data[1]}));
+    // The children of the received node are requested before them
+    std::vector<qtum::EVMStateRequest> first = sync.NextRequests(1);
+    BOOST_REQUIRE_EQUAL(first.size(), 1U);
+    BOOST_CHECK(!(first[0] == requests[0]));
+    sync.Retry(first);
+    std::vector<qtum::EVMStateRequest> next = sync.NextRequests(qtum::MAX_EVM_STATE_REQUEST);
+    BOOST_CHECK(std::find(next.begin(), next.end(), requests[0]) != next.end());
+    BOOST_CHECK(std::find(next.begin(), next.end(), requests[1]) == next.end());
+
+    // Requests of a peer that went away are requested again
+    sync.Retry(next);
+    BOOST_CHECK(sync.NextRequests(qtum::MAX_EVM_STATE_REQUEST) == next);
+    sync.Retry(next);
+    Sync(sync, source);
+
+    // Responses are limited in size
+    std::vector<qtum::EVMStateRequest> code(3, {qtum::EVMStateRequest::STATE_NODE, h256Touint(dev::sha3(CODE))});
+    data = qtum::LookupEVMState(source.state_db, source.utxo_db, code, CODE.size() + 1);
+    BOOST_REQUIRE_EQUAL(data.size(), 3U);
+    BOOST_CHECK(data[0] == CODE);
+    BOOST_CHECK(data[1] == CODE);
+    BOOST_CHECK(data[2].empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,167 @@
+#include <boost/test/unit_test.hpp>
+#include <test/util/setup_common.h>
+#include <chain.h>
+#include <consensus/validation.h>
+#include <rpc/response_cache.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+namespace RPCResponseCacheTest{
+
+UniValue Params(const std::string& param)
+{
+    UniValue params(UniValue::VARR);
+    params.push_back(param);
+    return params;
+}
+
+UniValue Confirmations(int confirmations)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("confirmations", confirmations);
+    return result;
+}
+
+BOOST_FIXTURE_TEST_SUITE(rpcresponsecache_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(cache_deep_responses){
+    RPCResponseCache cache(1 << 20, 10);
+    LOCK(cs_main);
+    const CChain& chain = m_node.chainman->ActiveChain();
+    const int height = chain.Height();
+
+    BOOST_CHECK(!cache.Get("getblock", Params("a"), chain));
+
+    // Responses about blocks with fewer confirmations than the depth are not cached
+    BOOST_CHECK(!cache.Put("getblock", Params("a"), UniValue("a"), *chain.Tip(), chain));
+    BOOST_CHECK(!cache.Put("getblock", Params("a"), UniValue("a"), *chain[height - 8], chain));
+    BOOST_CHECK(!cache.Get("getblock", Params("a"), chain));
+
+    BOOST_CHECK(cache.Put("getblock", Params("a"), UniValue("a"), *chain[height - 9], chain));
+    std::optional<UniValue> cached = cache.Get("getblock", Params("a"), chain);
+    BOOST_REQUIRE(cached);
+    BOOST_CHECK_EQUAL(cached->get_str(), "a");
+
+    // The method and params are both part of the key
+    BOOST_CHECK(!cache.Get("getblock", Params("b"), chain));
+    BOOST_CHECK(!cache.Get("getblockheader", Params("a"), chain));
+
+    RPCResponseCache::Stats stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_EQUAL(stats.depth, 10);
+    BOOST_CHECK_EQUAL(stats.methods["getblock"].hits, 1U);
+    BOOST_CHECK_EQUAL(stats.methods["getblock"].misses, 3U);
+    BOOST_CHECK_EQUAL(stats.methods["getblockheader"].misses, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(count_response_memory){
+    RPCResponseCache cache(1 << 20, 1);
+    LOCK(cs_main);
+    const CChain& chain = m_node.chainman->ActiveChain();
+
+    // A tree takes more memory than its serialization
+    UniValue tree(UniValue::VARR);
+    for (int i = 0; i < 100; ++i) {
+        UniValue item(UniValue::VOBJ);
+        item.pushKV("confirmations", i);
+        tree.push_back(item);
+    }
+    BOOST_CHECK(cache.Put("m", Params("a"), tree, *chain.Tip(), chain));
+    BOOST_CHECK(cache.GetStats().bytes > 2 * tree.write().size());
+}
+
+BOOST_AUTO_TEST_CASE(update_confirmations){
+    RPCResponseCache cache(1 << 20, 1);
+    {
+        LOCK(cs_main);
+        const CChain& chain = m_node.chainman->ActiveChain();
+        BOOST_CHECK(cache.Put("getblock", Params("a"), Confirmations(10), *chain[chain.Height() - 9], chain));
+    }
+
+    mineBlocks(2);
+    LOCK(cs_main);
+    std::optional<UniValue> cached = cache.Get("getblock", Params("a"), m_node.chainman->ActiveChain());
+    BOOST_REQUIRE(cached);
+    BOOST_CHECK_EQUAL((*cached)["confirmations"].getInt<int>(), 12);
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used){
+    const UniValue result(std::string(93, 'x'));
+    LOCK(cs_main);
+    const CChain& chain = m_node.chainman->ActiveChain();
+
+    // Two entries fit
+    RPCResponseCache probe(1 << 20, 1);
+    BOOST_CHECK(probe.Put("m", Params("a"), result, *chain.Tip(), chain));
+    const size_t entry_bytes{probe.GetStats().bytes};
+    RPCResponseCache cache(entry_bytes * 5 / 2, 1);
+
+    BOOST_CHECK(cache.Put("m", Params("a"), result, *chain.Tip(), chain));
+    BOOST_CHECK(cache.Put("m", Params("b"), result, *chain.Tip(), chain));
+    BOOST_CHECK_EQUAL(cache.GetStats().bytes, 2 * entry_bytes);
+    BOOST_CHECK(cache.Get("m", Params("a"), chain));
+
+    BOOST_CHECK(cache.Put("m", Params("c"), result, *chain.Tip(), chain));
+    BOOST_CHECK(cache.Get("m", Params("a"), chain));
+    BOOST_CHECK(!cache.Get("m", Params("b"), chain));
+    BOOST_CHECK(cache.Get("m", Params("c"), chain));
+
+    // Replacing an entry does not evict another one
+    BOOST_CHECK(cache.Put("m", Params("c"), result, *chain.Tip(), chain));
+    BOOST_CHECK(cache.Get("m", Params("a"), chain));
+
+    // Responses larger than the cache are not cached
+    BOOST_CHECK(!cache.Put("m", Params("d"), UniValue(std::string(entry_bytes * 3, 'x')), *chain.Tip(), chain));
+
+    const RPCResponseCache::Stats stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.entries, 2U);
+    BOOST_CHECK_EQUAL(stats.bytes, 2 * entry_bytes);
+    BOOST_CHECK_EQUAL(stats.max_bytes, entry_bytes * 5 / 2);
+    BOOST_CHECK_EQUAL(stats.evicted, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_on_reorg){
+    RPCResponseCache cache(1 << 20, 1);
+    m_node.validation_signals->RegisterValidationInterface(&cache);
+    Chainstate& chainstate = m_node.chainman->ActiveChainstate();
+    const CChain& chain = chainstate.m_chain;
+    const int height = WITH_LOCK(cs_main, return chain.Height());
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(cache.Put("getblock", Params("kept"), UniValue("kept"), *chain[height - 5], chain));
+        BOOST_CHECK(cache.Put("getblock", Params("stale"), UniValue("stale"), *chain[height - 4], chain));
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        BlockValidationState state;
+        BOOST_CHECK(chainstate.InvalidateBlock(state, WITH_LOCK(cs_main, return chain.Tip())));
+    }
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    {
+        LOCK(cs_main);
+        BOOST_CHECK_EQUAL(chain.Height(), height - 5);
+        BOOST_CHECK(cache.Get("getblock", Params("kept"), chain));
+        BOOST_CHECK(!cache.Get("getblock", Params("stale"), chain));
+        BOOST_CHECK_EQUAL(cache.GetStats().invalidated, 1U);
+    }
+
+    // An entry whose anchor was reorganized away before the notification is not returned either
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(cache.Put("getblock", Params("stale"), UniValue("stale"), *chain.Tip(), chain));
+    }
+    m_node.validation_signals->UnregisterValidationInterface(&cache);
+    {
+        BlockValidationState state;
+        BOOST_CHECK(chainstate.InvalidateBlock(state, WITH_LOCK(cs_main, return chain.Tip())));
+    }
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(!cache.Get("getblock", Params("stale"), chain));
+        BOOST_CHECK_EQUAL(cache.GetStats().invalidated, 2U);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
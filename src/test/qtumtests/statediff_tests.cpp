@@ -0,0 +1,216 @@
+#include <boost/test/unit_test.hpp>
+#include <test/util/setup_common.h>
+#include <test/qtumtests/test_utils.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <kernel/chain.h>
+#include <qtum/statediffjournal.h>
+#include <streams.h>
+#include <validationinterface.h>
+
+#include <algorithm>
+
+namespace StateDiffTest{
+
+const dev::u256 GASLIMIT = dev::u256(500000);
+const dev::h256 HASHTX = dev::h256(ParseHex("abababababababababababababababababababababababababababababababab"));
+
+// Constructor stores 5 in slot 0, the deployed code stores its first call
+// data word in slot 0
+const valtype CODE = ParseHex("60056000556007601160003960076000f3600035600055" "00");
+const valtype RUNTIME_CODE = ParseHex("600035600055" "00");
+
+valtype Word(uint8_t value)
+{
+    valtype word(32, 0);
+    word[31] = value;
+    return word;
+}
+
+void GenesisLoading()
+{
+    const CChainParams& chainparams = Params();
+    dev::eth::ChainParams cp(chainparams.EVMGenesisInfo(0x7fffffff));
+    globalState->populateFrom(cp.genesisState);
+    globalSealEngine = std::unique_ptr<dev::eth::SealEngineFace>(cp.createSealEngine());
+    globalState->db().commit();
+}
+
+struct JournalRecord {
+    uint8_t label;
+    uint64_t sequence;
+    BlockStateDiff diff;
+};
+
+std::vector<JournalRecord> ReadJournal(const fs::path& path)
+{
+    std::vector<std::byte> data(fs::file_size(path));
+    AutoFile file{fsbridge::fopen(path, "rb")};
+    file.read(data);
+    DataStream stream{data};
+    std::vector<JournalRecord> records;
+    while (!stream.empty()) {
+        const uint64_t size{ReadCompactSize(stream)};
+        const size_t remaining{stream.size()};
+        JournalRecord& record = records.emplace_back();
+        stream >> record.label >> record.sequence >> record.diff;
+        BOOST_CHECK_EQUAL(remaining - stream.size(), size);
+    }
+    return records;
+}
+
+void Notify(ValidationSignals& signals, StateDiffJournal& journal, const std::vector<std::pair<char, const CBlockIndex*>>& events)
+{
+    const auto block{std::make_shared<const CBlock>()};
+    signals.RegisterValidationInterface(&journal);
+    for (const auto& [label, index] : events) {
+        if (label == 'C') {
+            signals.BlockConnected(ChainstateRole::NORMAL, block, index);
+        } else {
+            signals.BlockDisconnected(block, index);
+        }
+    }
+    signals.SyncWithValidationInterfaceQueue();
+    signals.UnregisterValidationInterface(&journal);
+}
+
+BOOST_FIXTURE_TEST_SUITE(statediff_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(state_diff_of_execution){
+    GenesisLoading();
+
+    globalState->startStateDiff();
+    auto result = executeBC({createQtumTransaction(CODE, 0, GASLIMIT, dev::u256(1), HASHTX, dev::Address())}, *m_node.chainman);
+    const dev::Address contract = result.first[0].execRes.newAddress;
+    BOOST_REQUIRE(contract != dev::Address());
+    executeBC({createQtumTransaction(Word(9), 0, GASLIMIT, dev::u256(1), HASHTX, contract)}, *m_node.chainman);
+    std::vector<AccountStateDiff> diffs = globalState->stopStateDiff();
+
+    // The sender is not part of the state, only the new contract changed.
+    // The slot written by both the constructor and the call shows its value
+    // from before and after both.
+    BOOST_REQUIRE_EQUAL(diffs.size(), 1U);
+    BOOST_CHECK(diffs[0].address == h160Touint(contract));
+    BOOST_CHECK(!diffs[0].existed);
+    BOOST_CHECK(diffs[0].exists);
+    BOOST_CHECK(diffs[0].old_code_hash == uint256());
+    BOOST_CHECK(diffs[0].new_code_hash == h256Touint(dev::sha3(RUNTIME_CODE)));
+    BOOST_CHECK(diffs[0].new_code == RUNTIME_CODE);
+    BOOST_CHECK(!diffs[0].storage_cleared);
+    BOOST_REQUIRE_EQUAL(diffs[0].storage.size(), 1U);
+    BOOST_CHECK(diffs[0].storage.begin()->first == uint256());
+    BOOST_CHECK(diffs[0].storage.begin()->second.first == uint256());
+    BOOST_CHECK(diffs[0].storage.begin()->second.second == u256Touint(9));
+
+    // The next recording starts from the committed state
+    globalState->startStateDiff();
+    executeBC({createQtumTransaction(Word(0), 0, GASLIMIT, dev::u256(1), HASHTX, contract)}, *m_node.chainman);
+    diffs = globalState->stopStateDiff();
+    BOOST_REQUIRE_EQUAL(diffs.size(), 1U);
+    BOOST_CHECK(diffs[0].existed);
+    BOOST_CHECK(diffs[0].exists);
+    BOOST_CHECK(diffs[0].old_code_hash == diffs[0].new_code_hash);
+    BOOST_CHECK(diffs[0].new_code.empty());
+    BOOST_REQUIRE_EQUAL(diffs[0].storage.size(), 1U);
+    BOOST_CHECK(diffs[0].storage.begin()->second.first == u256Touint(9));
+    BOOST_CHECK(diffs[0].storage.begin()->second.second == uint256());
+
+    // Writing a slot back to its value is no change, and nothing is
+    // recorded outside of a recording
+    globalState->startStateDiff();
+    executeBC({createQtumTransaction(Word(4), 0, GASLIMIT, dev::u256(1), HASHTX, contract)}, *m_node.chainman);
+    executeBC({createQtumTransaction(Word(0), 0, GASLIMIT, dev::u256(1), HASHTX, contract)}, *m_node.chainman);
+    BOOST_CHECK(globalState->stopStateDiff().empty());
+    executeBC({createQtumTransaction(Word(4), 0, GASLIMIT, dev::u256(1), HASHTX, contract)}, *m_node.chainman);
+    BOOST_CHECK(globalState->stopStateDiff().empty());
+}
+
+BOOST_AUTO_TEST_CASE(state_diff_journal){
+    const fs::path dir{m_args.GetDataDirNet() / "evmstatediff"};
+    AccountStateDiff account;
+    account.address = uint160{ParseHex("0202020202020202020202020202020202020202")};
+    account.exists = true;
+    account.new_balance = u256Touint(5);
+    account.storage.emplace(uint256::ONE, std::make_pair(uint256(), uint256::ONE));
+    uint256 hash1{1}, hash2{2};
+    CBlockIndex index1, index2;
+    index1.phashBlock = &hash1;
+    index1.nHeight = 1;
+    index2.phashBlock = &hash2;
+    index2.nHeight = 2;
+
+    {
+        StateDiffJournal journal{dir, 1 << 20};
+        journal.Add(BlockStateDiff{hash1, 1, {account}});
+        BOOST_CHECK(journal.Get(hash1));
+        BOOST_CHECK(!journal.Get(hash2));
+        Notify(*m_node.validation_signals, journal, {{'C', &index1}, {'D', &index1}});
+    }
+    std::vector<JournalRecord> records = ReadJournal(dir / "diff00000.dat");
+    BOOST_REQUIRE_EQUAL(records.size(), 2U);
+    BOOST_CHECK_EQUAL(records[0].label, 'C');
+    BOOST_CHECK_EQUAL(records[0].sequence, 0U);
+    BOOST_CHECK_EQUAL(records[1].label, 'D');
+    BOOST_CHECK_EQUAL(records[1].sequence, 1U);
+    for (const JournalRecord& record : records) {
+        BOOST_CHECK(record.diff.available);
+        BOOST_CHECK(record.diff.block_hash == hash1);
+        BOOST_CHECK_EQUAL(record.diff.height, 1);
+        BOOST_REQUIRE_EQUAL(record.diff.accounts.size(), 1U);
+        BOOST_CHECK(record.diff.accounts[0].address == account.address);
+        BOOST_CHECK(record.diff.accounts[0].new_balance == account.new_balance);
+        BOOST_CHECK(record.diff.accounts[0].storage == account.storage);
+    }
+
+    // After a restart the sequence continues in a new file, and blocks
+    // connected before are marked as having no known changes
+    {
+        StateDiffJournal journal{dir, 1 << 20};
+        Notify(*m_node.validation_signals, journal, {{'D', &index2}});
+        BOOST_CHECK(!journal.GetOrUnavailable(index2).available);
+    }
+    records = ReadJournal(dir / "diff00001.dat");
+    BOOST_REQUIRE_EQUAL(records.size(), 1U);
+    BOOST_CHECK_EQUAL(records[0].label, 'D');
+    BOOST_CHECK_EQUAL(records[0].sequence, 2U);
+    BOOST_CHECK(records[0].diff.block_hash == hash2);
+    BOOST_CHECK(!records[0].diff.available);
+    BOOST_CHECK(records[0].diff.accounts.empty());
+}
+
+BOOST_AUTO_TEST_CASE(state_diff_journal_pruning){
+    const fs::path dir{m_args.GetDataDirNet() / "evmstatediff"};
+    std::vector<uint256> hashes;
+    for (int i = 0; i < 10; ++i) hashes.emplace_back(uint8_t(i + 1));
+    std::vector<CBlockIndex> indexes(hashes.size());
+    std::vector<std::pair<char, const CBlockIndex*>> events;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        indexes[i].phashBlock = &hashes[i];
+        indexes[i].nHeight = int(i);
+        events.emplace_back('C', &indexes[i]);
+    }
+
+    // Every record starts a new file, and two of them fit in the journal
+    DataStream record;
+    record << uint8_t{'C'} << uint64_t{0} << BlockStateDiff{hashes[0], 0, {}};
+    StateDiffJournal journal{dir, 2 * (record.size() + 1), 1};
+    Notify(*m_node.validation_signals, journal, events);
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) files.push_back(entry.path().filename());
+    std::sort(files.begin(), files.end());
+    BOOST_REQUIRE_EQUAL(files.size(), 2U);
+    BOOST_CHECK_EQUAL(fs::PathToString(files[0]), "diff00008.dat");
+    BOOST_CHECK_EQUAL(fs::PathToString(files[1]), "diff00009.dat");
+    BOOST_CHECK_EQUAL(ReadJournal(dir / files[1])[0].sequence, 9U);
+
+    // Only recent blocks are kept in memory
+    journal.Add(BlockStateDiff{hashes[0], 1, {}});
+    BOOST_CHECK(journal.Get(hashes[0]));
+    journal.Add(BlockStateDiff{hashes[1], 1 + StateDiffJournal::MEMORY_BLOCKS, {}});
+    BOOST_CHECK(!journal.Get(hashes[0]));
+    BOOST_CHECK(journal.Get(hashes[1]));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
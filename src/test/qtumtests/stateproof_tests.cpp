@@ -0,0 +1,115 @@
+#include <boost/test/unit_test.hpp>
+#include <test/util/setup_common.h>
+#include <qtum/stateproof.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+#include <libethereum/SecureTrieDB.h>
+
+namespace StateProofTest{
+
+using StorageTrie = dev::eth::SecureTrieDB<dev::h256, dev::OverlayDB>;
+
+dev::h256 Slot(unsigned i)
+{
+    return dev::h256(dev::u256(i));
+}
+
+/** Fill a storage trie with slots 0..count-1 holding i + 1 */
+dev::h256 FillTrie(dev::OverlayDB& db, unsigned count)
+{
+    StorageTrie trie(&db);
+    trie.init();
+    for (unsigned i = 0; i < count; i++) {
+        trie.insert(Slot(i), dev::rlp(dev::u256(i + 1)));
+    }
+    return trie.root();
+}
+
+BOOST_FIXTURE_TEST_SUITE(stateproof_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(prove_and_verify_storage){
+    dev::OverlayDB db;
+    dev::h256 root = FillTrie(db, 300);
+
+    // Present slots, plus one that was never written
+    std::vector<dev::bytes> keys = {Slot(0).asBytes(), Slot(7).asBytes(), Slot(299).asBytes(), Slot(1000).asBytes()};
+    std::vector<dev::bytes> values;
+    std::vector<dev::bytes> nodes;
+    BOOST_REQUIRE(qtum::ProveTrieKeys(db, root, keys, values, nodes));
+    BOOST_REQUIRE_EQUAL(values.size(), keys.size());
+    BOOST_CHECK(dev::RLP(values[0]).toInt<dev::u256>() == 1);
+    BOOST_CHECK(dev::RLP(values[1]).toInt<dev::u256>() == 8);
+    BOOST_CHECK(dev::RLP(values[2]).toInt<dev::u256>() == 300);
+    BOOST_CHECK(values[3].empty());
+
+    // The root node is shared by all keys and only included once
+    BOOST_CHECK(dev::sha3(nodes[0]) == root);
+    std::set<dev::h256> unique;
+    for (const dev::bytes& node : nodes) unique.insert(dev::sha3(node));
+    BOOST_CHECK_EQUAL(unique.size(), nodes.size());
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        dev::bytes value;
+        BOOST_CHECK(qtum::VerifyTrieProof(root, nodes, &keys[i], value));
+        BOOST_CHECK(value == values[i]);
+    }
+
+    // A batched proof is smaller than the individual proofs together
+    size_t separate = 0;
+    for (const dev::bytes& key : keys) {
+        std::vector<dev::bytes> single_values;
+        std::vector<dev::bytes> single_nodes;
+        BOOST_REQUIRE(qtum::ProveTrieKeys(db, root, {key}, single_values, single_nodes));
+        separate += single_nodes.size();
+    }
+    BOOST_CHECK(nodes.size() < separate);
+}
+
+BOOST_AUTO_TEST_CASE(reject_bad_proofs){
+    dev::OverlayDB db;
+    dev::h256 root = FillTrie(db, 300);
+
+    dev::bytes key = Slot(42).asBytes();
+    std::vector<dev::bytes> values;
+    std::vector<dev::bytes> nodes;
+    BOOST_REQUIRE(qtum::ProveTrieKeys(db, root, {key}, values, nodes));
+    BOOST_REQUIRE(nodes.size() > 1);
+    dev::bytes value;
+
+    // Wrong root
+    BOOST_CHECK(!qtum::VerifyTrieProof(dev::sha3(root), nodes, &key, value));
+
+    // Missing node
+    std::vector<dev::bytes> truncated(nodes.begin(), nodes.end() - 1);
+    BOOST_CHECK(!qtum::VerifyTrieProof(root, truncated, &key, value));
+
+    // Tampered leaf no longer matches the hash its parent commits to
+    std::vector<dev::bytes> tampered = nodes;
+    tampered.back().back() ^= 1;
+    BOOST_CHECK(!qtum::VerifyTrieProof(root, tampered, &key, value));
+
+    // Proof for a key does not prove an unrelated present key
+    dev::bytes other = Slot(43).asBytes();
+    BOOST_CHECK(!qtum::VerifyTrieProof(root, nodes, &other, value) || value.empty());
+}
+
+BOOST_AUTO_TEST_CASE(empty_trie){
+    dev::OverlayDB db;
+    std::vector<dev::bytes> values;
+    std::vector<dev::bytes> nodes;
+    dev::bytes key = Slot(1).asBytes();
+    BOOST_REQUIRE(qtum::ProveTrieKeys(db, dev::EmptyTrie, {key}, values, nodes));
+    BOOST_CHECK(values[0].empty());
+    BOOST_CHECK(nodes.empty());
+
+    dev::bytes value;
+    BOOST_CHECK(qtum::VerifyTrieProof(dev::EmptyTrie, nodes, &key, value));
+    BOOST_CHECK(value.empty());
+
+    // Nodes missing from the database
+    BOOST_CHECK(!qtum::ProveTrieKeys(db, dev::sha3(key), {key}, values, nodes));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
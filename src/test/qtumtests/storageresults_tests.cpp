@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+#include <test/util/setup_common.h>
+#include <primitives/transaction.h>
+#include <qtum/storageresults.h>
+#include <util/convert.h>
+
+namespace StorageResultsTest{
+
+CTransactionRef MakeTx(uint32_t n)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vout.emplace_back(0, CScript() << OP_TRUE);
+    tx.nLockTime = n;
+    return MakeTransactionRef(tx);
+}
+
+void AddResult(StorageResults& results, CTransactionRef const& tx, uint32_t height)
+{
+    TransactionReceiptInfo info{};
+    info.blockNumber = height;
+    info.transactionHash = tx->GetHash();
+    info.excepted = dev::eth::TransactionException::None;
+    info.logs.emplace_back(dev::Address(1), dev::h256s{dev::h256(dev::u256(height))}, dev::bytes(100, 0xab));
+    std::vector<TransactionReceiptInfo> receipts{info};
+    results.addResult(uintToh256(tx->GetHash()), receipts);
+}
+
+bool HasResult(StorageResults& results, CTransactionRef const& tx)
+{
+    return !results.getResult(uintToh256(tx->GetHash())).empty();
+}
+
+BOOST_FIXTURE_TEST_SUITE(storageresults_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(prune_results_by_height){
+    const std::string path{fs::PathToString(m_args.GetDataDirBase())};
+    std::vector<CTransactionRef> txs;
+    for (uint32_t i = 0; i < 4; i++) {
+        txs.push_back(MakeTx(i));
+    }
+
+    {
+        StorageResults results(path);
+        BOOST_CHECK_EQUAL(results.getPrunedHeight(), -1);
+        BOOST_CHECK_EQUAL(results.getResultsSize(), 0U);
+        // A new database needs no blocks to prune
+        BOOST_CHECK(results.isHeightRecorded(1));
+        AddResult(results, txs[0], 1);
+        AddResult(results, txs[1], 2);
+        AddResult(results, txs[2], 2);
+        AddResult(results, txs[3], 3);
+        results.commitResults();
+        BOOST_CHECK(results.getResultsSize() > 0);
+        const uint64_t size = results.getResultsSize();
+
+        results.pruneResults(1, {}, {});
+        BOOST_CHECK_EQUAL(results.getPrunedHeight(), 1);
+        BOOST_CHECK(!HasResult(results, txs[0]));
+        BOOST_CHECK(HasResult(results, txs[1]));
+        BOOST_CHECK(results.getResultsSize() < size);
+
+        // Kept receipts stay and are still counted
+        results.pruneResults(2, {}, {uintToh256(txs[2]->GetHash())});
+        BOOST_CHECK_EQUAL(results.getPrunedHeight(), 2);
+        BOOST_CHECK(!HasResult(results, txs[1]));
+        BOOST_CHECK(HasResult(results, txs[2]));
+        BOOST_CHECK_EQUAL(results.getResultsSize(), 2 * size / 4);
+    }
+
+    // The pruned height and size are kept across restarts
+    StorageResults results(path);
+    BOOST_CHECK_EQUAL(results.getPrunedHeight(), 2);
+    BOOST_CHECK(HasResult(results, txs[2]));
+    BOOST_CHECK(HasResult(results, txs[3]));
+    const uint64_t size = results.getResultsSize();
+
+    // Disconnecting a block drops its receipts from the size
+    results.deleteResults({txs[3]}, 3);
+    BOOST_CHECK(!HasResult(results, txs[3]));
+    BOOST_CHECK_EQUAL(results.getResultsSize(), size / 2);
+
+    results.wipeResults();
+    BOOST_CHECK_EQUAL(results.getPrunedHeight(), -1);
+    BOOST_CHECK_EQUAL(results.getResultsSize(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(prune_results_without_height_record){
+    StorageResults results(fs::PathToString(m_args.GetDataDirBase()));
+    CTransactionRef tx = MakeTx(0);
+    CTransactionRef kept = MakeTx(1);
+    AddResult(results, tx, 1);
+    AddResult(results, kept, 1);
+    results.commitResults();
+
+    // Receipts committed before the height records are found through the
+    // transactions of the block
+    results.deleteResults({}, 1);
+    BOOST_CHECK_EQUAL(results.getResultsSize(), 0U);
+    BOOST_CHECK(HasResult(results, tx));
+    results.pruneResults(1, {tx, kept}, {uintToh256(kept->GetHash())});
+    BOOST_CHECK(!HasResult(results, tx));
+    BOOST_CHECK(HasResult(results, kept));
+}
+
+BOOST_AUTO_TEST_CASE(count_results_of_old_database){
+    const std::string path{fs::PathToString(m_args.GetDataDirBase())};
+    CTransactionRef tx = MakeTx(0);
+    CTransactionRef kept = MakeTx(1);
+    uint64_t size;
+    {
+        StorageResults results(path);
+        AddResult(results, tx, 1);
+        AddResult(results, kept, 1);
+        results.commitResults();
+        size = results.getResultsSize();
+    }
+
+    // A database from before the size and the height records were written
+    {
+        leveldb::DB* db;
+        BOOST_REQUIRE(leveldb::DB::Open(leveldb::Options(), path + "/resultsDB", &db).ok());
+        BOOST_CHECK(db->Delete(leveldb::WriteOptions(), "S").ok());
+        BOOST_CHECK(db->Delete(leveldb::WriteOptions(), "R").ok());
+        BOOST_CHECK(db->Delete(leveldb::WriteOptions(), std::string{'H', 0, 0, 0, 1}).ok());
+        delete db;
+    }
+
+    StorageResults results(path);
+    BOOST_CHECK_EQUAL(results.getResultsSize(), size);
+    BOOST_CHECK(!results.isHeightRecorded(1));
+
+    // Pruning the receipts found through the transactions of the block
+    // drops them from the size
+    results.pruneResults(1, {tx, kept}, {uintToh256(kept->GetHash())});
+    BOOST_CHECK(!HasResult(results, tx));
+    BOOST_CHECK_EQUAL(results.getResultsSize(), size / 2);
+    results.deleteResults({kept}, 1);
+    BOOST_CHECK_EQUAL(results.getResultsSize(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
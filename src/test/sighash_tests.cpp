@@ -205,6 +205,41 @@ BOOST_AUTO_TEST_CASE(sighash_from_data)
 
         sh = SignatureHash(scriptCode, *tx, nIn, nHashType, 0, SigVersion::BASE);
         BOOST_CHECK_MESSAGE(sh.GetHex() == sigHashHex, strTest);
+
+        PrecomputedTransactionData txdata;
+        txdata.Init(*tx, {}, /*force=*/true);
+        sh = SignatureHash(scriptCode, *tx, nIn, nHashType, 0, SigVersion::BASE, &txdata);
+        BOOST_CHECK_MESSAGE(sh.GetHex() == sigHashHex, strTest);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sighash_legacy_cache)
+{
+    for (int i = 0; i < 200; i++) {
+        int nHashType{int(m_rng.rand32())};
+        const bool fSingle{(nHashType & 0x1f) == SIGHASH_SINGLE};
+        CMutableTransaction txTo;
+        RandomTransaction(txTo, fSingle);
+        // Enough inputs to span several hasher states
+        const int extra_ins = m_rng.randrange(3 * PrecomputedTransactionData::LEGACY_MIDSTATE_INTERVAL);
+        for (int in = 0; in < extra_ins; in++) {
+            CTxIn& txin = txTo.vin.emplace_back(COutPoint{Txid::FromUint256(m_rng.rand256()), m_rng.rand32()});
+            RandomScript(txin.scriptSig);
+            txin.nSequence = m_rng.rand32();
+            if (fSingle && m_rng.randbool()) txTo.vout.emplace_back(RandMoney(m_rng), CScript() << OP_TRUE);
+        }
+        CScript scriptCode;
+        RandomScript(scriptCode);
+
+        const CTransaction tx{txTo};
+        PrecomputedTransactionData txdata;
+        txdata.Init(tx, {});
+        BOOST_CHECK_EQUAL(txdata.m_legacy_ready, tx.vin.size() > 1);
+        for (unsigned int nIn = 0; nIn < tx.vin.size(); nIn++) {
+            const uint256 sho{SignatureHashOld(scriptCode, tx, nIn, nHashType)};
+            BOOST_CHECK(SignatureHash(scriptCode, tx, nIn, nHashType, 0, SigVersion::BASE) == sho);
+            BOOST_CHECK(SignatureHash(scriptCode, tx, nIn, nHashType, 0, SigVersion::BASE, &txdata) == sho);
+        }
     }
 }
 BOOST_AUTO_TEST_SUITE_END()
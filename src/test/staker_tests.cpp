@@ -0,0 +1,146 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <interfaces/mining.h>
+#include <key.h>
+#include <node/staker.h>
+#include <policy/policy.h>
+#include <pos.h>
+#include <script/interpreter.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <optional>
+
+using node::StakeCoin;
+using node::StakeCoinsUpdate;
+using node::StakeTarget;
+
+BOOST_FIXTURE_TEST_SUITE(staker_tests, TestChain100Setup)
+
+BOOST_AUTO_TEST_CASE(kernel_hash_without_index)
+{
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    const COutPoint prevout{m_coinbase_txns[0]->GetHash(), 0};
+    const unsigned int bits{0x1d00ffff};
+    for (uint32_t time = tip->nTime; time < tip->nTime + 64; time += 16) {
+        uint256 hash_index, target_index, hash, target;
+        const bool found_index{CheckStakeKernelHash(const_cast<CBlockIndex*>(tip), bits, tip->nTime - 100, 1000 * COIN, prevout, time, hash_index, target_index)};
+        const bool found{CheckStakeKernelHash(tip->nStakeModifier, tip->nHeight + 1, bits, tip->nTime - 100, 1000 * COIN, prevout, time, hash, target)};
+        BOOST_CHECK_EQUAL(found, found_index);
+        BOOST_CHECK_EQUAL(hash, hash_index);
+        BOOST_CHECK_EQUAL(target, target_index);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stake_target_and_coins)
+{
+    auto mining{interfaces::MakeMining(m_node)};
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+    const Consensus::Params& params{Params().GetConsensus()};
+
+    std::optional<StakeTarget> target{mining->getStakeTarget()};
+    BOOST_REQUIRE(target);
+    BOOST_CHECK_EQUAL(target->prev_hash, tip->GetBlockHash());
+    BOOST_CHECK_EQUAL(target->height, tip->nHeight + 1);
+    BOOST_CHECK_EQUAL(target->stake_modifier, tip->nStakeModifier);
+    BOOST_CHECK(target->min_time > tip->GetBlockTime());
+    BOOST_CHECK_EQUAL(target->max_coin_height, target->height - params.CoinbaseMaturity(target->height));
+
+    // The first update scans the UTXO set, and catches up with the blocks
+    // connected since it was last flushed
+    const CScript script{GetScriptForRawPubKey(coinbaseKey.GetPubKey())};
+    const StakeCoinsUpdate update{mining->getStakeCoins({script}, uint256{})};
+    BOOST_CHECK(update.full);
+    BOOST_CHECK_EQUAL(update.tip, tip->GetBlockHash());
+    BOOST_CHECK(update.spent.empty());
+    BOOST_CHECK_EQUAL(update.coins.size(), m_coinbase_txns.size());
+    for (const StakeCoin& coin : update.coins) {
+        BOOST_CHECK(coin.out.scriptPubKey == script);
+        const CBlockIndex* block_from{WITH_LOCK(::cs_main, return tip->GetAncestor(coin.height))};
+        BOOST_REQUIRE(block_from);
+        BOOST_CHECK_EQUAL(coin.block_from_time, block_from->nTime);
+    }
+    BOOST_CHECK(mining->getStakeCoins({GetScriptForRawPubKey(GenerateRandomKey().GetPubKey())}, uint256{}).coins.empty());
+
+    // Later updates only replay the blocks connected since the previous one
+    const StakeCoinsUpdate up_to_date{mining->getStakeCoins({script}, tip->GetBlockHash())};
+    BOOST_CHECK(!up_to_date.full);
+    BOOST_CHECK_EQUAL(up_to_date.tip, tip->GetBlockHash());
+    BOOST_CHECK(up_to_date.coins.empty());
+    const CBlockIndex* since{WITH_LOCK(::cs_main, return tip->GetAncestor(tip->nHeight - 10))};
+    const StakeCoinsUpdate recent{mining->getStakeCoins({script}, since->GetBlockHash())};
+    BOOST_CHECK(!recent.full);
+    BOOST_CHECK_EQUAL(recent.tip, tip->GetBlockHash());
+    BOOST_REQUIRE_EQUAL(recent.coins.size(), 10U);
+    for (const StakeCoin& coin : recent.coins) {
+        BOOST_CHECK(coin.height > since->nHeight);
+        BOOST_CHECK(std::any_of(m_coinbase_txns.end() - 10, m_coinbase_txns.end(), [&](const CTransactionRef& tx) { return tx->GetHash() == coin.prevout.hash; }));
+    }
+
+    // An unknown block starts over
+    BOOST_CHECK(mining->getStakeCoins({script}, uint256::ONE).full);
+}
+
+BOOST_AUTO_TEST_CASE(stake_block)
+{
+    auto mining{interfaces::MakeMining(m_node)};
+    const Consensus::Params& params{Params().GetConsensus()};
+    node::Staker staker{*mining, {coinbaseKey}};
+    BOOST_REQUIRE(staker.Update());
+    BOOST_CHECK_EQUAL(staker.CacheSize(), m_coinbase_txns.size());
+    std::optional<StakeTarget> target{mining->getStakeTarget()};
+    BOOST_REQUIRE(target);
+
+    // Nothing to search before the first valid slot
+    BOOST_CHECK(!staker.Search(target->min_time - 1));
+
+    // A stale tip is refused
+    const COutPoint kernel{m_coinbase_txns[0]->GetHash(), 0};
+    node::BlockCreateOptions options;
+    options.coinbase_output_script = GetScriptForRawPubKey(coinbaseKey.GetPubKey());
+    const uint32_t time = (target->min_time + target->timestamp_mask) & ~target->timestamp_mask;
+    BOOST_CHECK(!mining->createNewStakeBlock(options, uint256::ONE, kernel, time));
+
+    // The coinstake spends the kernel and pays the stake and reward back
+    std::unique_ptr<interfaces::BlockTemplate> block_template{mining->createNewStakeBlock(options, target->prev_hash, kernel, time)};
+    BOOST_REQUIRE(block_template);
+    const CBlock unsigned_block{block_template->getBlock()};
+    BOOST_CHECK(unsigned_block.IsProofOfStake());
+    BOOST_CHECK(unsigned_block.prevoutStake == kernel);
+    BOOST_CHECK_EQUAL(unsigned_block.nTime, time);
+    const CTransaction& coinstake{*unsigned_block.vtx[1]};
+    BOOST_REQUIRE_EQUAL(coinstake.vin.size(), 1U);
+    BOOST_CHECK(coinstake.vin[0].prevout == kernel);
+    BOOST_CHECK(coinstake.vin[0].scriptSig.empty());
+    CAmount reward;
+    int64_t piece;
+    BOOST_REQUIRE(GetCoinStakeReward(target->height, /*nTotalFees=*/0, params, reward, piece));
+    BOOST_CHECK_EQUAL(coinstake.vout[1].nValue, m_coinbase_txns[0]->vout[0].nValue + reward);
+    BOOST_CHECK(coinstake.vout[1].scriptPubKey == options.coinbase_output_script);
+
+    // With the easiest target the staker finds a kernel in the first slot
+    // and signs both the coinstake and the block
+    std::optional<CBlock> block{staker.Search(time)};
+    BOOST_REQUIRE(block);
+    BOOST_CHECK_EQUAL(block->nTime, time);
+    BOOST_CHECK(block->hashMerkleRoot == BlockMerkleRoot(*block));
+    const CTxOut& staked{m_coinbase_txns[0]->vout[0]};
+    const CTransaction& signed_coinstake{*block->vtx[1]};
+    BOOST_CHECK(VerifyScript(signed_coinstake.vin[0].scriptSig, staked.scriptPubKey, &signed_coinstake.vin[0].scriptWitness,
+                             STANDARD_SCRIPT_VERIFY_FLAGS, TransactionSignatureChecker(&signed_coinstake, 0, staked.nValue, MissingDataBehavior::FAIL)));
+    CPubKey signer;
+    BOOST_REQUIRE(signer.RecoverCompact(block->GetHashWithoutSign(), block->GetBlockSignature()));
+    BOOST_CHECK(signer == coinbaseKey.GetPubKey());
+
+    // Slots already searched on this tip are skipped
+    BOOST_CHECK(!staker.Search(time));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
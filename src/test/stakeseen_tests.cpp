@@ -0,0 +1,74 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <chainparams.h>
+#include <node/stakeseen.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using node::GetStakeSeenCutoff;
+using node::StakeSeenCache;
+
+BOOST_FIXTURE_TEST_SUITE(stakeseen_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(insert_and_contains)
+{
+    StakeSeenCache cache;
+    const COutPoint stake{Txid::FromUint256(m_rng.rand256()), 1};
+    cache.Insert(stake, 1000, 10);
+    BOOST_CHECK(cache.Contains(stake, 1000));
+    // Same stake at another time, or another output of the same transaction
+    BOOST_CHECK(!cache.Contains(stake, 1016));
+    BOOST_CHECK(!cache.Contains(COutPoint{stake.hash, 0}, 1000));
+
+    // A competing block reusing the stake is stored once
+    cache.Insert(stake, 1000, 11);
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+    BOOST_CHECK(cache.DynamicMemoryUsage() > 0);
+
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.Size(), 0U);
+    BOOST_CHECK(!cache.Contains(stake, 1000));
+}
+
+BOOST_AUTO_TEST_CASE(expiry)
+{
+    StakeSeenCache cache;
+    std::vector<COutPoint> stakes;
+    for (int height = 0; height < 4000; ++height) {
+        stakes.emplace_back(Txid::FromUint256(m_rng.rand256()), 0);
+        cache.Insert(stakes.back(), height * 16, height);
+        cache.SetMinHeight(height - 500);
+    }
+    BOOST_CHECK_EQUAL(cache.GetMinHeight(), 3499);
+    // Bounded by the window and the amortized scan, not by the chain length
+    BOOST_CHECK(cache.Size() < stakes.size() / 2);
+    for (int height = 3499; height < 4000; ++height) {
+        BOOST_CHECK(cache.Contains(stakes[height], height * 16));
+    }
+
+    // Blocks below the minimum height are not remembered
+    const COutPoint old{Txid::FromUint256(m_rng.rand256()), 0};
+    cache.Insert(old, 0, 3000);
+    BOOST_CHECK(!cache.Contains(old, 0));
+
+    // The minimum height never goes back
+    cache.SetMinHeight(100);
+    BOOST_CHECK_EQUAL(cache.GetMinHeight(), 3499);
+}
+
+BOOST_AUTO_TEST_CASE(cutoff)
+{
+    const Consensus::Params& params{Params().GetConsensus()};
+    BOOST_CHECK_EQUAL(GetStakeSeenCutoff(0, params), 0);
+    const int height{10 * params.MaxCheckpointSpan()};
+    BOOST_CHECK_EQUAL(GetStakeSeenCutoff(height, params), height - params.CheckpointSpan(height) - CBlockIndex::nMedianTimeSpan);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
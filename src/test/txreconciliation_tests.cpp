@@ -8,6 +8,42 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
+namespace {
+
+/** Register an initiator and a responder as peer 0 of each other. */
+void RegisterPair(TxReconciliationTracker& initiator, TxReconciliationTracker& responder)
+{
+    const uint64_t initiator_salt{initiator.PreRegisterPeer(0)};
+    const uint64_t responder_salt{responder.PreRegisterPeer(0)};
+    BOOST_REQUIRE(initiator.RegisterPeer(0, /*is_peer_inbound=*/false, 1, responder_salt) == ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE(responder.RegisterPeer(0, /*is_peer_inbound=*/true, 1, initiator_salt) == ReconciliationRegisterResult::SUCCESS);
+}
+
+/** Run a reconciliation round up to the sketch, returning what the initiator makes of it. */
+HandleSketchResult RequestSketch(TxReconciliationTracker& initiator, TxReconciliationTracker& responder)
+{
+    // The first call only starts the timer
+    BOOST_CHECK(!initiator.MaybeRequestReconciliation(0, 1s));
+    BOOST_CHECK(!initiator.MaybeRequestReconciliation(0, 1s + RECON_REQUEST_INTERVAL - 1us));
+    const auto request{initiator.MaybeRequestReconciliation(0, 1s + RECON_REQUEST_INTERVAL)};
+    BOOST_REQUIRE(request);
+    BOOST_REQUIRE(responder.HandleReconciliationRequest(0, request->first, request->second));
+    const auto skdata{responder.MaybeRespondToReconciliationRequest(0)};
+    BOOST_REQUIRE(skdata);
+    BOOST_CHECK(!responder.MaybeRespondToReconciliationRequest(0));
+    return initiator.HandleSketch(0, *skdata);
+}
+
+std::vector<Wtxid> Sorted(std::vector<Wtxid> wtxids)
+{
+    std::sort(wtxids.begin(), wtxids.end());
+    return wtxids;
+}
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(txreconciliation_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(RegisterPeerTest)
@@ -81,4 +117,242 @@ BOOST_AUTO_TEST_CASE(IsPeerRegisteredTest)
     BOOST_CHECK(!tracker.IsPeerRegistered(peer_id0));
 }
 
+BOOST_AUTO_TEST_CASE(ReconciliationSetTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Transactions can only be added for registered peers
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+    tracker.PreRegisterPeer(0);
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(0, true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_CHECK(tracker.AddToSet(0, wtxid));
+    BOOST_CHECK(tracker.TryRemovingFromSet(0, wtxid));
+    BOOST_CHECK(!tracker.TryRemovingFromSet(0, wtxid));
+
+    // A full set makes further transactions flood
+    for (size_t i = 0; i < MAX_RECONSET_SIZE; ++i) {
+        BOOST_CHECK(tracker.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationRoundTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION), responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+
+    // Only the initiator requests reconciliations
+    BOOST_CHECK(!responder.MaybeRequestReconciliation(0, 1s));
+    BOOST_CHECK(!responder.MaybeRequestReconciliation(0, 1h));
+
+    std::vector<Wtxid> initiator_only, responder_only;
+    for (int i = 0; i < 20; ++i) {
+        const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+        BOOST_CHECK(initiator.AddToSet(0, wtxid));
+        BOOST_CHECK(responder.AddToSet(0, wtxid));
+    }
+    for (int i = 0; i < 3; ++i) {
+        initiator_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        BOOST_CHECK(initiator.AddToSet(0, initiator_only.back()));
+    }
+    for (int i = 0; i < 2; ++i) {
+        responder_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        BOOST_CHECK(responder.AddToSet(0, responder_only.back()));
+    }
+
+    const HandleSketchResult result{RequestSketch(initiator, responder)};
+    BOOST_REQUIRE(result.action == HandleSketchResult::Action::SEND_DIFF);
+    BOOST_CHECK(result.success);
+    BOOST_CHECK(Sorted(result.txs_to_announce) == Sorted(initiator_only));
+    BOOST_CHECK_EQUAL(result.txs_to_request.size(), responder_only.size());
+
+    // The responder announces what the initiator asked for
+    const auto announce{responder.HandleReconciliationDifference(0, true, result.txs_to_request)};
+    BOOST_REQUIRE(announce);
+    BOOST_CHECK(Sorted(*announce) == Sorted(responder_only));
+
+    // The round is over and the sets were reconciled
+    BOOST_CHECK(!responder.HandleReconciliationDifference(0, true, {}));
+    BOOST_CHECK(!initiator.TryRemovingFromSet(0, initiator_only[0]));
+    const auto next_request{initiator.MaybeRequestReconciliation(0, 1s + 2 * RECON_REQUEST_INTERVAL)};
+    BOOST_REQUIRE(next_request);
+    BOOST_CHECK_EQUAL(next_request->first, 0);
+}
+
+BOOST_AUTO_TEST_CASE(SketchExtensionTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION), responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+
+    // Sets of the same size differ by more than estimated from their sizes, but by less
+    // than an extended sketch holds
+    std::vector<Wtxid> initiator_only;
+    for (int i = 0; i < 16; ++i) {
+        const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+        initiator.AddToSet(0, wtxid);
+        responder.AddToSet(0, wtxid);
+    }
+    for (int i = 0; i < 4; ++i) {
+        initiator_only.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        initiator.AddToSet(0, initiator_only.back());
+        responder.AddToSet(0, Wtxid::FromUint256(m_rng.rand256()));
+    }
+
+    HandleSketchResult result{RequestSketch(initiator, responder)};
+    BOOST_REQUIRE(result.action == HandleSketchResult::Action::REQUEST_EXTENSION);
+    const auto extension{responder.HandleSketchExtensionRequest(0)};
+    BOOST_REQUIRE(extension);
+    // Only one extension is allowed
+    BOOST_CHECK(!responder.HandleSketchExtensionRequest(0));
+    result = initiator.HandleSketch(0, *extension);
+    BOOST_REQUIRE(result.action == HandleSketchResult::Action::SEND_DIFF);
+    BOOST_CHECK(result.success);
+    BOOST_CHECK(Sorted(result.txs_to_announce) == Sorted(initiator_only));
+    BOOST_CHECK_EQUAL(result.txs_to_request.size(), 4U);
+    const auto announce{responder.HandleReconciliationDifference(0, true, result.txs_to_request)};
+    BOOST_REQUIRE(announce);
+    BOOST_CHECK_EQUAL(announce->size(), 4U);
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationFailureTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION), responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+
+    // Disjoint sets differ by far more than even the extended sketch holds
+    std::vector<Wtxid> initiator_set, responder_set;
+    for (int i = 0; i < 10; ++i) {
+        initiator_set.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        initiator.AddToSet(0, initiator_set.back());
+        responder_set.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        responder.AddToSet(0, responder_set.back());
+    }
+
+    HandleSketchResult result{RequestSketch(initiator, responder)};
+    BOOST_REQUIRE(result.action == HandleSketchResult::Action::REQUEST_EXTENSION);
+    result = initiator.HandleSketch(0, *responder.HandleSketchExtensionRequest(0));
+    BOOST_REQUIRE(result.action == HandleSketchResult::Action::SEND_DIFF);
+
+    // Both sides announce their whole set
+    BOOST_CHECK(!result.success);
+    BOOST_CHECK(result.txs_to_request.empty());
+    BOOST_CHECK(Sorted(result.txs_to_announce) == Sorted(initiator_set));
+    const auto announce{responder.HandleReconciliationDifference(0, false, {})};
+    BOOST_REQUIRE(announce);
+    BOOST_CHECK(Sorted(*announce) == Sorted(responder_set));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationProtocolViolationTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION), responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+    const std::vector<uint8_t> skdata(8);
+
+    // Messages of the other role or out of order
+    BOOST_CHECK(!initiator.HandleReconciliationRequest(0, 0, 0));
+    BOOST_CHECK(responder.HandleSketch(0, skdata).action == HandleSketchResult::Action::PROTOCOL_VIOLATION);
+    BOOST_CHECK(initiator.HandleSketch(0, skdata).action == HandleSketchResult::Action::PROTOCOL_VIOLATION);
+    BOOST_CHECK(!responder.HandleSketchExtensionRequest(0));
+    BOOST_CHECK(!responder.HandleReconciliationDifference(0, true, {}));
+    BOOST_CHECK(responder.HandleReconciliationRequest(0, 0, 0));
+    BOOST_CHECK(!responder.HandleReconciliationRequest(0, 0, 0));
+
+    // Sketches must hold whole elements and stay within the capacity limit
+    BOOST_CHECK(!initiator.MaybeRequestReconciliation(0, 1s));
+    BOOST_REQUIRE(initiator.MaybeRequestReconciliation(0, 1s + RECON_REQUEST_INTERVAL));
+    BOOST_CHECK(initiator.HandleSketch(0, std::vector<uint8_t>(7)).action == HandleSketchResult::Action::PROTOCOL_VIOLATION);
+    BOOST_CHECK(initiator.HandleSketch(0, std::vector<uint8_t>(4 * (MAX_SKETCH_CAPACITY + 1))).action == HandleSketchResult::Action::PROTOCOL_VIOLATION);
+}
+
+BOOST_AUTO_TEST_CASE(FanoutTargetTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Peers we do not reconcile with get every transaction by flooding
+    BOOST_CHECK(tracker.IsFanoutTarget(0, wtxid));
+
+    // Each transaction is flooded to one outbound peer
+    for (NodeId peer_id = 0; peer_id < 8; ++peer_id) {
+        tracker.PreRegisterPeer(peer_id);
+        BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id, /*is_peer_inbound=*/false, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    }
+    for (int i = 0; i < 10; ++i) {
+        const Wtxid tx{Wtxid::FromUint256(m_rng.rand256())};
+        int targets{0};
+        for (NodeId peer_id = 0; peer_id < 8; ++peer_id) targets += tracker.IsFanoutTarget(peer_id, tx);
+        BOOST_CHECK_EQUAL(targets, 1);
+    }
+
+    // Forgetting the peer a transaction is flooded to moves it to another one
+    NodeId target{0};
+    while (!tracker.IsFanoutTarget(target, wtxid)) ++target;
+    tracker.ForgetPeer(target);
+    int targets{0};
+    for (NodeId peer_id = 0; peer_id < 8; ++peer_id) {
+        if (peer_id != target) targets += tracker.IsFanoutTarget(peer_id, wtxid);
+    }
+    BOOST_CHECK_EQUAL(targets, 1);
+
+    // And to a tenth of the inbound peers, rounded up
+    const auto inbound_targets = [&](NodeId end) {
+        for (NodeId peer_id = 8; peer_id < end; ++peer_id) {
+            if (tracker.IsPeerRegistered(peer_id)) continue;
+            tracker.PreRegisterPeer(peer_id);
+            BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id, /*is_peer_inbound=*/true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+        }
+        int targets{0};
+        for (NodeId peer_id = 8; peer_id < end; ++peer_id) targets += tracker.IsFanoutTarget(peer_id, wtxid);
+        return targets;
+    };
+    BOOST_CHECK_EQUAL(inbound_targets(13), 1);
+    BOOST_CHECK_EQUAL(inbound_targets(33), 3);
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationTimeoutTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION), responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+    std::vector<Wtxid> initiator_set, responder_set;
+    for (int i = 0; i < 3; ++i) {
+        initiator_set.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        initiator.AddToSet(0, initiator_set.back());
+        responder_set.push_back(Wtxid::FromUint256(m_rng.rand256()));
+        responder.AddToSet(0, responder_set.back());
+    }
+
+    BOOST_CHECK(!initiator.MaybeRequestReconciliation(0, 1s));
+    const auto request{initiator.MaybeRequestReconciliation(0, 1s + RECON_REQUEST_INTERVAL)};
+    BOOST_REQUIRE(request);
+    const auto timeout{1s + RECON_REQUEST_INTERVAL + RECON_RESPONSE_TIMEOUT};
+    BOOST_CHECK(!initiator.MaybeTimeoutReconciliation(0, timeout - 1us));
+    BOOST_CHECK(!initiator.MaybeRequestReconciliation(0, timeout - 1us));
+
+    // The peer answers only after the initiator gave up and announced its set
+    BOOST_REQUIRE(responder.HandleReconciliationRequest(0, request->first, request->second));
+    const auto skdata{responder.MaybeRespondToReconciliationRequest(0)};
+    BOOST_REQUIRE(skdata);
+    const auto announce{initiator.MaybeTimeoutReconciliation(0, timeout)};
+    BOOST_REQUIRE(announce);
+    BOOST_CHECK(Sorted(*announce) == Sorted(initiator_set));
+    BOOST_CHECK(!initiator.MaybeTimeoutReconciliation(0, timeout));
+
+    // The failed RECONCILDIFF makes the peer announce its set, and its late sketch is dropped
+    const auto responder_announce{responder.HandleReconciliationDifference(0, false, {})};
+    BOOST_REQUIRE(responder_announce);
+    BOOST_CHECK(Sorted(*responder_announce) == Sorted(responder_set));
+    BOOST_CHECK(initiator.HandleSketch(0, *skdata).action == HandleSketchResult::Action::IGNORE);
+
+    // The next round starts from the empty sets
+    const auto next_request{initiator.MaybeRequestReconciliation(0, timeout)};
+    BOOST_REQUIRE(next_request);
+    BOOST_CHECK_EQUAL(next_request->first, 0);
+    BOOST_REQUIRE(responder.HandleReconciliationRequest(0, next_request->first, next_request->second));
+    const auto next_skdata{responder.MaybeRespondToReconciliationRequest(0)};
+    BOOST_REQUIRE(next_skdata);
+    BOOST_CHECK(initiator.HandleSketch(0, *next_skdata).action == HandleSketchResult::Action::SEND_DIFF);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -273,6 +273,7 @@ ChainTestingSetup::ChainTestingSetup(const ChainType chainType, TestOpts opts)
         }
         const BlockManager::Options blockman_opts{
             .chainparams = chainman_opts.chainparams,
+            .block_arena = m_args.GetBoolArg("-blockarena", kernel::DEFAULT_BLOCK_ARENA),
             .blocks_dir = m_args.GetBlocksDirPath(),
             .notifications = chainman_opts.notifications,
             .block_tree_db_params = DBParams{
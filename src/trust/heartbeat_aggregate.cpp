@@ -0,0 +1,121 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <trust/heartbeat_aggregate.h>
+#include <hash.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <streams.h>
+#include <tinyformat.h>
+
+#include <algorithm>
+
+namespace trust {
+
+int GetHeartbeatWindow(int height, const Consensus::Params& params) {
+    return height - height % params.nHeartbeatInterval;
+}
+
+uint256 GetAttestationHash(int windowHeight, const uint256& windowBlockHash) {
+    HashWriter ss{};
+    ss << std::string{"WATTx heartbeat attestation"};
+    ss << windowHeight;
+    ss << windowBlockHash;
+    return ss.GetHash();
+}
+
+// HeartbeatAggregate implementation
+
+HeartbeatAggregate::HeartbeatAggregate(int windowHeight, const std::map<CKeyID, std::vector<unsigned char>>& attestations)
+    : windowHeight(windowHeight) {
+    // The map is ordered by signer, which is the order the encoding requires
+    for (const auto& [signer, signature] : attestations) {
+        if (signatures.size() >= MAX_HEARTBEAT_AGGREGATE_SIGNATURES) break;
+        signatures.push_back(signature);
+    }
+}
+
+bool HeartbeatAggregate::GetSigners(const uint256& windowBlockHash, std::vector<CKeyID>& signers) const {
+    signers.clear();
+    signers.reserve(signatures.size());
+    const uint256 hash = GetAttestationHash(windowHeight, windowBlockHash);
+    for (const auto& signature : signatures) {
+        CPubKey pubkey;
+        if (signature.size() != CPubKey::COMPACT_SIGNATURE_SIZE || !pubkey.RecoverCompact(hash, signature)) {
+            return false;
+        }
+        CKeyID signer = pubkey.GetID();
+        if (!signers.empty() && !(signers.back() < signer)) {
+            return false;
+        }
+        signers.push_back(signer);
+    }
+    return true;
+}
+
+bool CheckHeartbeatAggregate(const HeartbeatAggregate& aggregate, int height, const Consensus::Params& params, std::string& reason) {
+    if (aggregate.windowHeight < 0 || aggregate.windowHeight >= height ||
+        aggregate.windowHeight != GetHeartbeatWindow(aggregate.windowHeight, params)) {
+        reason = strprintf("invalid heartbeat window %d", aggregate.windowHeight);
+        return false;
+    }
+    if (height - aggregate.windowHeight > params.nHeartbeatInclusionWindow) {
+        reason = strprintf("heartbeat window %d closed before height %d", aggregate.windowHeight, height);
+        return false;
+    }
+    if (aggregate.signatures.empty() || aggregate.signatures.size() > MAX_HEARTBEAT_AGGREGATE_SIGNATURES) {
+        reason = strprintf("invalid number of attestations %u", aggregate.signatures.size());
+        return false;
+    }
+    return true;
+}
+
+CScript GetHeartbeatAggregateScript(const HeartbeatAggregate& aggregate) {
+    DataStream ss{};
+    ss << aggregate;
+    std::vector<unsigned char> data(HEARTBEAT_AGGREGATE_HEADER.begin(), HEARTBEAT_AGGREGATE_HEADER.end());
+    data.insert(data.end(), UCharCast(ss.data()), UCharCast(ss.data() + ss.size()));
+    return CScript() << OP_RETURN << data;
+}
+
+/** Get the data pushed after the header by an aggregate commitment script */
+static bool GetHeartbeatAggregateData(const CScript& script, std::vector<unsigned char>& data) {
+    if (script.empty() || script[0] != OP_RETURN) {
+        return false;
+    }
+    CScript::const_iterator pc = script.begin() + 1;
+    opcodetype opcode;
+    if (!script.GetOp(pc, opcode, data) || pc != script.end() || data.size() < HEARTBEAT_AGGREGATE_HEADER.size()) {
+        return false;
+    }
+    return std::equal(HEARTBEAT_AGGREGATE_HEADER.begin(), HEARTBEAT_AGGREGATE_HEADER.end(), data.begin());
+}
+
+int GetHeartbeatAggregateIndex(const CTransaction& coinbase) {
+    std::vector<unsigned char> data;
+    for (size_t i = 0; i < coinbase.vout.size(); ++i) {
+        if (GetHeartbeatAggregateData(coinbase.vout[i].scriptPubKey, data)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ReadHeartbeatAggregate(const CTransaction& coinbase, HeartbeatAggregate& aggregate) {
+    int pos = GetHeartbeatAggregateIndex(coinbase);
+    std::vector<unsigned char> data;
+    if (pos < 0 || !GetHeartbeatAggregateData(coinbase.vout[pos].scriptPubKey, data)) {
+        return false;
+    }
+    try {
+        SpanReader ss{Span{data}.subspan(HEARTBEAT_AGGREGATE_HEADER.size())};
+        ss >> aggregate;
+        // Trailing data would give the same aggregate another encoding
+        return ss.empty();
+    } catch (const std::ios_base::failure&) {
+        return false;
+    }
+}
+
+} // namespace trust
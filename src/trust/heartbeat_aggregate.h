@@ -0,0 +1,97 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef WATTX_TRUST_HEARTBEAT_AGGREGATE_H
+#define WATTX_TRUST_HEARTBEAT_AGGREGATE_H
+
+#include <consensus/params.h>
+#include <pubkey.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class CScript;
+class CTransaction;
+
+namespace trust {
+
+/** Prefix of the data pushed by the coinbase output committing to a heartbeat aggregate ("WHBA") */
+static constexpr std::array<unsigned char, 4> HEARTBEAT_AGGREGATE_HEADER{0x57, 0x48, 0x42, 0x41};
+
+/** Maximum number of validator attestations in one aggregate */
+static constexpr size_t MAX_HEARTBEAT_AGGREGATE_SIGNATURES{1000};
+
+/**
+ * Get the heartbeat window a block height belongs to, identified by the
+ * height of its first block
+ */
+int GetHeartbeatWindow(int height, const Consensus::Params& params);
+
+/**
+ * Get the hash a validator signs to attest that it was online during the
+ * heartbeat window starting at the given block
+ */
+uint256 GetAttestationHash(int windowHeight, const uint256& windowBlockHash);
+
+/**
+ * Attestations a staker observed for one heartbeat window, committed in the
+ * coinbase of a proof-of-stake block. Signers are not listed: each one is
+ * recovered from its compact signature, and they must be in strictly
+ * ascending order so that a set of attestations has exactly one encoding.
+ */
+class HeartbeatAggregate {
+public:
+    int32_t windowHeight{0};
+    std::vector<std::vector<unsigned char>> signatures;
+
+    HeartbeatAggregate() = default;
+
+    /**
+     * Build an aggregate from attestations keyed by signer
+     */
+    HeartbeatAggregate(int windowHeight, const std::map<CKeyID, std::vector<unsigned char>>& attestations);
+
+    SERIALIZE_METHODS(HeartbeatAggregate, obj) {
+        READWRITE(obj.windowHeight, obj.signatures);
+    }
+
+    /**
+     * Recover the attesting validators
+     * Fails if a signature is invalid or the signers are not strictly ascending
+     */
+    bool GetSigners(const uint256& windowBlockHash, std::vector<CKeyID>& signers) const;
+};
+
+/**
+ * Check the rules of an aggregate included at the given height that do not
+ * need the chain: it must name a window that started at most
+ * nHeartbeatInclusionWindow blocks earlier and hold a bounded, non-empty set
+ * of signatures
+ */
+bool CheckHeartbeatAggregate(const HeartbeatAggregate& aggregate, int height, const Consensus::Params& params, std::string& reason);
+
+/**
+ * Get the coinbase output script committing to an aggregate
+ */
+CScript GetHeartbeatAggregateScript(const HeartbeatAggregate& aggregate);
+
+/**
+ * Get the index of the first coinbase output committing to an aggregate, or -1
+ */
+int GetHeartbeatAggregateIndex(const CTransaction& coinbase);
+
+/**
+ * Decode the aggregate committed in a coinbase transaction
+ * Returns false if there is none or it is malformed
+ */
+bool ReadHeartbeatAggregate(const CTransaction& coinbase, HeartbeatAggregate& aggregate);
+
+} // namespace trust
+
+#endif // WATTX_TRUST_HEARTBEAT_AGGREGATE_H
@@ -102,11 +102,13 @@ bool HeartbeatManager::BroadcastHeartbeat(int blockHeight, const uint256& blockH
     // TODO: Get local address from connman when networking is fully integrated
     hb.nodePort = 18888; // Default WATTx port
 
-    // Sign it (signature includes IP address)
-    if (!hb.Sign(*m_validator_key)) {
+    // Sign it (signature includes IP address), and attest to the window for
+    // heartbeat aggregates
+    if (!hb.Sign(*m_validator_key) || !hb.SignAttestation(*m_validator_key)) {
         LogPrintf("HeartbeatManager: Failed to sign heartbeat\n");
         return false;
     }
+    m_attestations[{hb.blockHeight, hb.blockHash}][hb.validatorId] = hb.attestation;
 
     // Record that we've seen our own heartbeat
     m_seen_heartbeats.insert(hb.GetHash());
@@ -131,6 +133,14 @@ bool HeartbeatManager::ProcessHeartbeat(const Heartbeat& heartbeat, NodeId from)
         return false; // Already processed
     }
 
+    // Once heartbeats are aggregated on chain, they are only useful until the
+    // inclusion window of their heartbeat window has passed
+    if (m_trust_manager.GetHeight() >= m_consensus_params.nHeartbeatAggregateHeight &&
+        heartbeat.blockHeight + m_consensus_params.nHeartbeatInclusionWindow < m_trust_manager.GetHeight()) {
+        LogDebug(BCLog::NET, "HeartbeatManager: Ignoring stale heartbeat for height %d\n", heartbeat.blockHeight);
+        return false;
+    }
+
     // Add to seen set
     m_seen_heartbeats.insert(hbHash);
 
@@ -145,6 +155,16 @@ bool HeartbeatManager::ProcessHeartbeat(const Heartbeat& heartbeat, NodeId from)
         return false;
     }
 
+    // Collect the attestation for the aggregate of its window
+    if (!heartbeat.attestation.empty() &&
+        heartbeat.blockHeight == GetHeartbeatWindow(heartbeat.blockHeight, m_consensus_params) &&
+        heartbeat.VerifyAttestation()) {
+        auto& attestations = m_attestations[{heartbeat.blockHeight, heartbeat.blockHash}];
+        if (attestations.size() < MAX_HEARTBEAT_AGGREGATE_SIGNATURES) {
+            attestations.emplace(heartbeat.validatorId, heartbeat.attestation);
+        }
+    }
+
     // WATTx: Process IP address for trust scoring and peer discovery
     if (heartbeat.nodeAddress.IsValid()) {
         // Update validator's address in trust manager
@@ -262,6 +282,45 @@ void HeartbeatManager::OnNewBlock(int height) {
     }
 }
 
+HeartbeatAggregate HeartbeatManager::GetAggregate(int windowHeight, const uint256& windowBlockHash) const {
+    LOCK(cs_heartbeat);
+    auto it = m_attestations.find({windowHeight, windowBlockHash});
+    if (it == m_attestations.end()) {
+        return HeartbeatAggregate(windowHeight, {});
+    }
+    return HeartbeatAggregate(windowHeight, it->second);
+}
+
+void HeartbeatManager::BlockConnected(int height, const HeartbeatAggregate* aggregate, const uint256& windowBlockHash) {
+    LOCK(cs_heartbeat);
+    std::vector<CKeyID> signers;
+    if (aggregate && aggregate->GetSigners(windowBlockHash, signers)) {
+        m_trust_manager.ConnectHeartbeatAggregate(aggregate->windowHeight, signers);
+    }
+    m_trust_manager.SetHeight(height);
+    if (height >= m_consensus_params.nHeartbeatAggregateHeight) {
+        m_trust_manager.UpdateHeartbeatExpectations(height);
+    }
+
+    // Drop attestations that can no longer be included
+    for (auto it = m_attestations.begin(); it != m_attestations.end() &&
+         it->first.first + m_consensus_params.nHeartbeatInclusionWindow < height;) {
+        it = m_attestations.erase(it);
+    }
+}
+
+void HeartbeatManager::BlockDisconnected(int height, const HeartbeatAggregate* aggregate, const uint256& windowBlockHash) {
+    LOCK(cs_heartbeat);
+    std::vector<CKeyID> signers;
+    if (aggregate && aggregate->GetSigners(windowBlockHash, signers)) {
+        m_trust_manager.DisconnectHeartbeatAggregate(aggregate->windowHeight, signers);
+    }
+    m_trust_manager.SetHeight(height - 1);
+    if (height - 1 >= m_consensus_params.nHeartbeatAggregateHeight) {
+        m_trust_manager.UpdateHeartbeatExpectations(height - 1);
+    }
+}
+
 void HeartbeatManager::CleanupSeenHeartbeats() {
     LOCK(cs_heartbeat);
     // Simple cleanup: just clear half when we hit the limit
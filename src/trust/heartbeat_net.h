@@ -5,6 +5,7 @@
 #ifndef WATTX_TRUST_HEARTBEAT_NET_H
 #define WATTX_TRUST_HEARTBEAT_NET_H
 
+#include <trust/heartbeat_aggregate.h>
 #include <trust/trustscore.h>
 #include <net.h>
 #include <protocol.h>
@@ -13,8 +14,10 @@
 #include <key.h>
 
 #include <atomic>
+#include <map>
 #include <memory>
 #include <set>
+#include <utility>
 
 class CChainState;
 class CConnman;
@@ -80,6 +83,10 @@ private:
     // Last heartbeat height we broadcast
     int m_last_heartbeat_height GUARDED_BY(cs_heartbeat){0};
 
+    // Attestations of registered validators that can still be included in a
+    // block, by window (height and block hash) and signer
+    std::map<std::pair<int, uint256>, std::map<CKeyID, std::vector<unsigned char>>> m_attestations GUARDED_BY(cs_heartbeat);
+
     // Connection manager for broadcasting
     CConnman* m_connman{nullptr};
 
@@ -148,6 +155,23 @@ public:
      */
     void OnNewBlock(int height);
 
+    /**
+     * Get the aggregate of the attestations collected for a heartbeat window,
+     * to be committed in a block we stake
+     */
+    HeartbeatAggregate GetAggregate(int windowHeight, const uint256& windowBlockHash) const;
+
+    /**
+     * Update chain-derived uptime for a connected block, given the aggregate it
+     * committed (if any) and the hash of the block starting its window
+     */
+    void BlockConnected(int height, const HeartbeatAggregate* aggregate, const uint256& windowBlockHash);
+
+    /**
+     * Undo BlockConnected for a disconnected block
+     */
+    void BlockDisconnected(int height, const HeartbeatAggregate* aggregate, const uint256& windowBlockHash);
+
     /**
      * Clean up old seen heartbeats to prevent memory growth
      */
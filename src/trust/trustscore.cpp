@@ -3,11 +3,16 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <trust/trustscore.h>
+#include <trust/heartbeat_aggregate.h>
 #include <hash.h>
 #include <logging.h>
 #include <netbase.h>
+#include <streams.h>
+#include <util/fs_helpers.h>
 #include <util/time.h>
+#include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 
 namespace trust {
@@ -69,9 +74,7 @@ TrustTier ValidatorInfo::GetTrustTier(const Consensus::Params& params) const {
     return TrustTier::NONE;
 }
 
-int ValidatorInfo::GetRewardMultiplier(const Consensus::Params& params) const {
-    TrustTier tier = GetTrustTier(params);
-
+static int TierRewardMultiplier(TrustTier tier, const Consensus::Params& params) {
     switch (tier) {
         case TrustTier::PLATINUM: return params.nPlatinumRewardMultiplier;
         case TrustTier::GOLD:     return params.nGoldRewardMultiplier;
@@ -81,6 +84,10 @@ int ValidatorInfo::GetRewardMultiplier(const Consensus::Params& params) const {
     }
 }
 
+int ValidatorInfo::GetRewardMultiplier(const Consensus::Params& params) const {
+    return TierRewardMultiplier(GetTrustTier(params), params);
+}
+
 bool ValidatorInfo::MeetsMinimumStake(const Consensus::Params& params) const {
     return stakeAmount >= params.nMinValidatorStake;
 }
@@ -132,6 +139,18 @@ bool Heartbeat::Verify(const CPubKey& pubkey) const {
     return pubkey.Verify(hash, signature);
 }
 
+bool Heartbeat::SignAttestation(const CKey& key) {
+    return key.SignCompact(GetAttestationHash(blockHeight, blockHash), attestation);
+}
+
+bool Heartbeat::VerifyAttestation() const {
+    CPubKey pubkey;
+    if (!pubkey.RecoverCompact(GetAttestationHash(blockHeight, blockHash), attestation)) {
+        return false;
+    }
+    return pubkey.GetID() == validatorId;
+}
+
 // TrustScoreManager implementation
 
 TrustScoreManager::TrustScoreManager(const Consensus::Params& params)
@@ -229,8 +248,11 @@ bool TrustScoreManager::ProcessHeartbeat(const Heartbeat& heartbeat, int height)
         return false;
     }
 
-    // Record heartbeat
-    it->second.heartbeatsReceived++;
+    // Record heartbeat. Once aggregates are active, uptime only comes from
+    // the attestations committed on chain.
+    if (currentHeight < consensusParams.nHeartbeatAggregateHeight) {
+        it->second.heartbeatsReceived++;
+    }
     it->second.lastHeartbeatHeight = height;
 
     LogPrintf("TrustScoreManager: Processed heartbeat from validator at height %d\n", height);
@@ -239,6 +261,7 @@ bool TrustScoreManager::ProcessHeartbeat(const Heartbeat& heartbeat, int height)
 
 void TrustScoreManager::UpdateHeartbeatExpectations(int height) {
     currentHeight = height;
+    WITH_LOCK(cs_trust, PruneDemotions());
 
     for (auto& [id, info] : validators) {
         if (!info.isActive) continue;
@@ -254,9 +277,105 @@ void TrustScoreManager::UpdateHeartbeatExpectations(int height) {
         if (windowBlocks > 0) {
             info.heartbeatsExpected = windowBlocks / consensusParams.nHeartbeatInterval;
         }
+
+        // Derive uptime from chain data: count the windows since registration
+        // (and activation) whose inclusion period has ended
+        if (height >= consensusParams.nHeartbeatAggregateHeight) {
+            int from = std::max({info.registrationHeight, height - consensusParams.nUptimeWindow,
+                                 consensusParams.nHeartbeatAggregateHeight - 1});
+            int to = height - consensusParams.nHeartbeatInclusionWindow;
+            if (to > from) {
+                info.heartbeatsExpected = to / consensusParams.nHeartbeatInterval - from / consensusParams.nHeartbeatInterval;
+                info.heartbeatsReceived = GetAttestedWindows(id, from, to);
+            } else {
+                info.heartbeatsExpected = 0;
+                info.heartbeatsReceived = 0;
+            }
+        }
     }
 }
 
+void TrustScoreManager::ConnectHeartbeatAggregate(int windowHeight, const std::vector<CKeyID>& signers) {
+    LOCK(cs_trust);
+    auto& attested = attestedWindows[windowHeight];
+    for (const CKeyID& signer : signers) {
+        attested[signer]++;
+    }
+
+    // Windows older than the uptime window no longer count
+    const int oldest = windowHeight - consensusParams.nUptimeWindow - consensusParams.nHeartbeatInclusionWindow;
+    attestedWindows.erase(attestedWindows.begin(), attestedWindows.lower_bound(oldest));
+}
+
+void TrustScoreManager::DisconnectHeartbeatAggregate(int windowHeight, const std::vector<CKeyID>& signers) {
+    LOCK(cs_trust);
+    auto window = attestedWindows.find(windowHeight);
+    if (window == attestedWindows.end()) {
+        return;
+    }
+    for (const CKeyID& signer : signers) {
+        auto it = window->second.find(signer);
+        if (it != window->second.end() && --it->second == 0) {
+            window->second.erase(it);
+        }
+    }
+    if (window->second.empty()) {
+        attestedWindows.erase(window);
+    }
+}
+
+int TrustScoreManager::GetAttestedWindows(const CKeyID& validatorId, int fromHeight, int toHeight) const {
+    LOCK(cs_trust);
+    int count = 0;
+    for (auto it = attestedWindows.upper_bound(fromHeight); it != attestedWindows.end() && it->first <= toHeight; ++it) {
+        if (it->second.count(validatorId)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void TrustScoreManager::ClearAttestedWindows() {
+    LOCK(cs_trust);
+    attestedWindows.clear();
+}
+
+bool TrustScoreManager::WriteAttestedWindows(const fs::path& path, const uint256& tip) const {
+    LOCK(cs_trust);
+    const fs::path tmpPath{path + ".new"};
+    AutoFile file{fsbridge::fopen(tmpPath, "wb")};
+    if (file.IsNull()) {
+        LogPrintf("TrustScoreManager: Failed to open %s for writing\n", fs::PathToString(tmpPath));
+        return false;
+    }
+    try {
+        file << tip << attestedWindows;
+        if (!file.Commit()) throw std::runtime_error("Commit failed");
+        file.fclose();
+        if (!RenameOver(tmpPath, path)) throw std::runtime_error("Rename failed");
+    } catch (const std::exception& e) {
+        LogPrintf("TrustScoreManager: Failed to save attested windows: %s\n", e.what());
+        return false;
+    }
+    return true;
+}
+
+bool TrustScoreManager::ReadAttestedWindows(const fs::path& path, uint256& tip) {
+    LOCK(cs_trust);
+    AutoFile file{fsbridge::fopen(path, "rb")};
+    if (file.IsNull()) {
+        return false;
+    }
+    try {
+        file >> tip >> attestedWindows;
+    } catch (const std::exception& e) {
+        LogPrintf("TrustScoreManager: Failed to load attested windows: %s\n", e.what());
+        attestedWindows.clear();
+        return false;
+    }
+    return true;
+}
+
 const ValidatorInfo* TrustScoreManager::GetValidator(const CKeyID& validatorId) const {
     auto it = validators.find(validatorId);
     if (it == validators.end()) {
@@ -270,15 +389,13 @@ TrustTier TrustScoreManager::GetValidatorTier(const CKeyID& validatorId) const {
     if (!info) {
         return TrustTier::NONE;
     }
-    return info->GetTrustTier(consensusParams);
+    int tier = static_cast<int>(info->GetTrustTier(consensusParams));
+    tier = std::max(tier - GetDemotions(validatorId), static_cast<int>(TrustTier::NONE));
+    return static_cast<TrustTier>(tier);
 }
 
 int TrustScoreManager::GetValidatorRewardMultiplier(const CKeyID& validatorId) const {
-    const ValidatorInfo* info = GetValidator(validatorId);
-    if (!info) {
-        return 0;
-    }
-    return info->GetRewardMultiplier(consensusParams);
+    return TierRewardMultiplier(GetValidatorTier(validatorId), consensusParams);
 }
 
 bool TrustScoreManager::IsValidatorEligible(const CKeyID& validatorId) const {
@@ -286,7 +403,7 @@ bool TrustScoreManager::IsValidatorEligible(const CKeyID& validatorId) const {
     if (!info) {
         return false;
     }
-    return info->IsEligibleForStaking(consensusParams);
+    return info->IsEligibleForStaking(consensusParams) && GetValidatorTier(validatorId) != TrustTier::NONE;
 }
 
 std::vector<ValidatorInfo> TrustScoreManager::GetActiveValidators() const {
@@ -302,7 +419,7 @@ std::vector<ValidatorInfo> TrustScoreManager::GetActiveValidators() const {
 std::vector<ValidatorInfo> TrustScoreManager::GetValidatorsByTier(TrustTier tier) const {
     std::vector<ValidatorInfo> result;
     for (const auto& [id, info] : validators) {
-        if (info.isActive && info.GetTrustTier(consensusParams) == tier) {
+        if (info.isActive && GetValidatorTier(id) == tier) {
             result.push_back(info);
         }
     }
@@ -318,6 +435,80 @@ bool TrustScoreManager::DeactivateValidator(const CKeyID& validatorId) {
     return true;
 }
 
+bool TrustScoreManager::DemoteValidator(const CKeyID& validatorId, uint32_t slot) {
+    if (validators.find(validatorId) == validators.end()) {
+        return false;
+    }
+    LOCK(cs_trust);
+    if (!demotions[validatorId].emplace(slot, currentHeight + consensusParams.nUptimeWindow).second) {
+        return false;
+    }
+    WriteDemotions();
+    return true;
+}
+
+void TrustScoreManager::WriteDemotions() const {
+    AssertLockHeld(cs_trust);
+    if (demotionsPath.empty()) {
+        return;
+    }
+
+    // Demotions are rare, write them all out every time
+    const fs::path tmpPath{demotionsPath + ".new"};
+    AutoFile file{fsbridge::fopen(tmpPath, "wb")};
+    if (file.IsNull()) {
+        LogPrintf("TrustScoreManager: Failed to open %s for writing\n", fs::PathToString(tmpPath));
+        return;
+    }
+    try {
+        file << demotions;
+        if (!file.Commit()) throw std::runtime_error("Commit failed");
+        file.fclose();
+        if (!RenameOver(tmpPath, demotionsPath)) throw std::runtime_error("Rename failed");
+    } catch (const std::exception& e) {
+        LogPrintf("TrustScoreManager: Failed to save demotions: %s\n", e.what());
+    }
+}
+
+void TrustScoreManager::PruneDemotions() {
+    AssertLockHeld(cs_trust);
+    bool pruned{false};
+    for (auto it = demotions.begin(); it != demotions.end();) {
+        pruned |= std::erase_if(it->second, [&](const auto& demotion) { return demotion.second <= currentHeight; }) > 0;
+        it = it->second.empty() ? demotions.erase(it) : std::next(it);
+    }
+    if (pruned) {
+        WriteDemotions();
+    }
+}
+
+int TrustScoreManager::GetDemotions(const CKeyID& validatorId) const {
+    LOCK(cs_trust);
+    auto it = demotions.find(validatorId);
+    if (it == demotions.end()) {
+        return 0;
+    }
+    return std::count_if(it->second.begin(), it->second.end(), [&](const auto& demotion) { return demotion.second > currentHeight; });
+}
+
+bool TrustScoreManager::LoadDemotions(const fs::path& path) {
+    LOCK(cs_trust);
+    demotionsPath = path;
+    AutoFile file{fsbridge::fopen(path, "rb")};
+    if (file.IsNull()) {
+        return false;
+    }
+    try {
+        file >> demotions;
+    } catch (const std::exception& e) {
+        LogPrintf("TrustScoreManager: Failed to load demotions: %s\n", e.what());
+        demotions.clear();
+        return false;
+    }
+    LogPrintf("TrustScoreManager: Loaded demotions of %d validators\n", demotions.size());
+    return true;
+}
+
 //////////////////////////////////////////////////
 // WATTx IP-Based Trust & Peer Discovery
 //////////////////////////////////////////////////
@@ -13,6 +13,7 @@
 #include <netaddress.h>
 #include <netbase.h>
 #include <sync.h>
+#include <util/fs.h>
 
 #include <cstdint>
 #include <map>
@@ -148,6 +149,7 @@ public:
     CService nodeAddress;         // WATTx: Node's IP address and port for peer discovery
     uint16_t nodePort;            // WATTx: Node's listening port
     std::vector<unsigned char> signature;  // Signature proving validator identity
+    std::vector<unsigned char> attestation; // Compact signature of the attestation hash, for heartbeat aggregates
 
     Heartbeat() : blockHeight(0), timestamp(0), nodePort(18888) {}
 
@@ -163,6 +165,7 @@ public:
         ::Serialize(s, addrStr);
         ::Serialize(s, nodePort);
         ::Serialize(s, signature);
+        ::Serialize(s, attestation);
     }
 
     template<typename Stream>
@@ -179,6 +182,12 @@ public:
         }
         ::Unserialize(s, nodePort);
         ::Unserialize(s, signature);
+        // Optional, older nodes do not send it
+        if (!s.empty()) {
+            ::Unserialize(s, attestation);
+        } else {
+            attestation.clear();
+        }
     }
 
     /**
@@ -196,6 +205,17 @@ public:
      */
     bool Verify(const CPubKey& pubkey) const;
 
+    /**
+     * Attest with the validator's key that it was online for the heartbeat
+     * window starting at blockHeight
+     */
+    bool SignAttestation(const CKey& key);
+
+    /**
+     * Check that the attestation was signed by validatorId
+     */
+    bool VerifyAttestation() const;
+
     /**
      * Get the node address as a string for addnode command
      */
@@ -211,6 +231,24 @@ private:
     const Consensus::Params& consensusParams;
     int currentHeight;
 
+    // Guards the state shared between the net and validation threads and RPC
+    mutable Mutex cs_trust;
+
+    // Slots (block times) at which each validator was proven to equivocate,
+    // with the height the demotion expires at. Each one costs a trust tier.
+    std::map<CKeyID, std::map<uint32_t, int>> demotions GUARDED_BY(cs_trust);
+
+    // File the demotions are kept in across restarts, empty if not persisted
+    fs::path demotionsPath GUARDED_BY(cs_trust);
+
+    // Validators attested on chain for each heartbeat window, with the number
+    // of connected blocks that included the attestation
+    std::map<int, std::map<CKeyID, int>> attestedWindows GUARDED_BY(cs_trust);
+
+    // Drop expired demotions, rewriting the file if any were dropped
+    void PruneDemotions() EXCLUSIVE_LOCKS_REQUIRED(cs_trust);
+    void WriteDemotions() const EXCLUSIVE_LOCKS_REQUIRED(cs_trust);
+
 public:
     explicit TrustScoreManager(const Consensus::Params& params);
 
@@ -238,7 +276,7 @@ public:
     /**
      * Update expected heartbeats for all validators at new block height
      */
-    void UpdateHeartbeatExpectations(int height);
+    void UpdateHeartbeatExpectations(int height) EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
 
     /**
      * Get validator info by ID
@@ -248,17 +286,17 @@ public:
     /**
      * Get trust tier for a validator
      */
-    TrustTier GetValidatorTier(const CKeyID& validatorId) const;
+    TrustTier GetValidatorTier(const CKeyID& validatorId) const EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
 
     /**
      * Get reward multiplier for a validator
      */
-    int GetValidatorRewardMultiplier(const CKeyID& validatorId) const;
+    int GetValidatorRewardMultiplier(const CKeyID& validatorId) const EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
 
     /**
      * Check if a validator is eligible to stake
      */
-    bool IsValidatorEligible(const CKeyID& validatorId) const;
+    bool IsValidatorEligible(const CKeyID& validatorId) const EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
 
     /**
      * Get all active validators
@@ -268,18 +306,74 @@ public:
     /**
      * Get validators by tier
      */
-    std::vector<ValidatorInfo> GetValidatorsByTier(TrustTier tier) const;
+    std::vector<ValidatorInfo> GetValidatorsByTier(TrustTier tier) const EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
 
     /**
      * Deactivate a validator
      */
     bool DeactivateValidator(const CKeyID& validatorId);
 
+    /**
+     * Lower a validator's trust tier by one for equivocating at slot, for
+     * one uptime window from the current height. Further evidence for the
+     * same slot does not demote it again. Returns false if the validator is
+     * unknown or was already demoted for the slot.
+     */
+    bool DemoteValidator(const CKeyID& validatorId, uint32_t slot) EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
+    /**
+     * Get the number of tiers a validator was demoted by
+     */
+    int GetDemotions(const CKeyID& validatorId) const EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
+    /**
+     * Keep the demotions in a file, loading the ones it holds
+     */
+    bool LoadDemotions(const fs::path& path) EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
     /**
      * Set current block height for calculations
      */
     void SetHeight(int height) { currentHeight = height; }
 
+    /**
+     * Get current block height
+     */
+    int GetHeight() const { return currentHeight; }
+
+    /**
+     * Record the validators attested for a heartbeat window by the aggregate
+     * in a connected block
+     */
+    void ConnectHeartbeatAggregate(int windowHeight, const std::vector<CKeyID>& signers) EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
+    /**
+     * Forget the attestations of a disconnected block
+     */
+    void DisconnectHeartbeatAggregate(int windowHeight, const std::vector<CKeyID>& signers) EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
+    /**
+     * Get the number of heartbeat windows starting in (fromHeight, toHeight]
+     * that were attested on chain for a validator
+     */
+    int GetAttestedWindows(const CKeyID& validatorId, int fromHeight, int toHeight) const EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
+    /**
+     * Forget all heartbeat windows attested on chain
+     */
+    void ClearAttestedWindows() EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
+    /**
+     * Write the heartbeat windows attested on chain up to the block tip to a file
+     */
+    bool WriteAttestedWindows(const fs::path& path, const uint256& tip) const EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
+    /**
+     * Read the heartbeat windows attested on chain from a file, and the block
+     * they are up to date with
+     */
+    bool ReadAttestedWindows(const fs::path& path, uint256& tip) EXCLUSIVE_LOCKS_REQUIRED(!cs_trust);
+
     //////////////////////////////////////////////////
     // WATTx IP-Based Trust & Peer Discovery
     //////////////////////////////////////////////////
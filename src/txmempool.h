@@ -18,6 +18,7 @@
 #include <policy/packages.h>
 #include <primitives/transaction.h>
 #include <sync.h>
+#include <uint256.h>
 #include <util/epochguard.h>
 #include <util/hasher.h>
 #include <util/result.h>
@@ -315,9 +316,10 @@ public:
             // Otherwise, prioritize the contract tx with the highest (minimum among its outputs) gas price
             // The reason for using the gas price of the output that sets the minimum gas price is that there
             // otherwise it may be possible to game the prioritization by setting a large gas price in one output
-            // that does no execution, while the real execution has a very low gas price
-            if(a.GetMinGasPrice() != b.GetMinGasPrice()) {
-                return a.GetMinGasPrice() > b.GetMinGasPrice();
+            // that does no execution, while the real execution has a very low gas price.
+            // The fees of unconfirmed ancestors count towards it, so a child can pay for a contract parent.
+            if(a.GetPackageGasPrice() != b.GetPackageGasPrice()) {
+                return a.GetPackageGasPrice() > b.GetPackageGasPrice();
             }
 
             // Otherwise, prioritize the tx with the minimum size
@@ -588,6 +590,8 @@ private:
 public:
     indirectmap<COutPoint, const CTransaction*> mapNextTx GUARDED_BY(cs);
     std::map<uint256, CAmount> mapDeltas GUARDED_BY(cs);
+    //! The pending claim of each MPoS balance, see GetMPoSClaim
+    std::map<uint160, const CTransaction*> mapMPoSClaims GUARDED_BY(cs);
 
     using Options = kernel::MemPoolOptions;
 
@@ -1001,7 +1005,7 @@ public:
 
         using TxHandle = CTxMemPool::txiter;
 
-        TxHandle StageAddition(const CTransactionRef& tx, const CAmount fee, int64_t time, unsigned int entry_height, uint64_t entry_sequence, bool spends_coinbase, int64_t sigops_cost, LockPoints lp, CAmount min_gas_price = 0);
+        TxHandle StageAddition(const CTransactionRef& tx, const CAmount fee, int64_t time, unsigned int entry_height, uint64_t entry_sequence, bool spends_coinbase, int64_t sigops_cost, LockPoints lp, CAmount min_gas_price = 0, uint64_t gas_limit = 0);
         void StageRemoval(CTxMemPool::txiter it) { m_to_remove.insert(it); }
 
         const CTxMemPool::setEntries& GetRemovals() const { return m_to_remove; }
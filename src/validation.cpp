@@ -19,6 +19,7 @@
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
 #include <consensus/gapcoin_pow.h>
+#include <crypto/dilithium.h>
 #include <cuckoocache.h>
 #include <flatfile.h>
 #include <hash.h>
@@ -47,8 +48,10 @@
 #include <random.h>
 #include <script/script.h>
 #include <script/sigcache.h>
+#include <script/solver.h>
 #include <signet.h>
 #include <tinyformat.h>
+#include <trust/heartbeat_aggregate.h>
 #include <txdb.h>
 #include <txmempool.h>
 #include <uint256.h>
@@ -72,6 +75,8 @@
 #include <univalue.h>
 #include <util/signstr.h>
 #include <qtum/qtumutils.h>
+#include <qtum/evmstatesync.h>
+#include <qtum/statediffjournal.h>
 #include <common/args.h>
 #include <addresstype.h>
 
@@ -134,7 +139,7 @@ std::unique_ptr<StorageResults> pstorageresult;
 bool fRecordLogOpcodes = false;
 bool fIsVMlogFile = false;
 bool fGettingValuesDGP = false;
-std::set<std::pair<COutPoint, unsigned int>> setStakeSeen;
+node::StakeSeenCache g_stake_seen;
 bool fAddressIndex = false; // qtum
 bool fLogEvents = false;
 
@@ -162,7 +167,8 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                        const CCoinsViewCache& inputs, unsigned int flags, bool cacheSigStore,
                        bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
                        ValidationCache& validation_cache,
-                       std::vector<CScriptCheck>* pvChecks = nullptr)
+                       std::vector<CScriptCheck>* pvChecks = nullptr,
+                       const DilithiumKeyLookup* dilithium_keys = nullptr)
                        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 int64_t FutureDrift(uint32_t nTime, int nHeight, const Consensus::Params& consensusParams)
@@ -290,6 +296,97 @@ bool CheckSequenceLocksAtTip(CBlockIndex* tip,
 // Returns the script flags which should be checked for a given block
 static unsigned int GetBlockScriptFlags(const CBlockIndex& block_index, const ChainstateManager& chainman);
 
+/** Whether the next block on top of the active chain tip may reference revealed Dilithium keys */
+static bool DilithiumKeyRefActiveAfterTip(const Chainstate& active_chainstate) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    return active_chainstate.m_chain.Height() + 1 >= active_chainstate.m_chainman.GetConsensus().nDilithiumKeyRefHeight;
+}
+
+/** Script verification flags for mempool policy checks on top of the active chain tip */
+static unsigned int GetPolicyScriptFlags(const Chainstate& active_chainstate) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    unsigned int flags{STANDARD_SCRIPT_VERIFY_FLAGS};
+    if (DilithiumKeyRefActiveAfterTip(active_chainstate)) {
+        flags |= SCRIPT_VERIFY_DILITHIUM_KEYREF;
+    }
+    return flags;
+}
+
+/** Split a Dilithium pubkey hash spend into its signature and key (or key id) pushes */
+static bool GetDilithiumSpendPushes(const CScript& scriptSig, valtype& sig, valtype& key)
+{
+    CScript::const_iterator pc = scriptSig.begin();
+    opcodetype opcode;
+    if (!scriptSig.GetOp(pc, opcode, sig) || opcode > OP_PUSHDATA4) return false;
+    if (!scriptSig.GetOp(pc, opcode, key) || opcode > OP_PUSHDATA4) return false;
+    return pc == scriptSig.end();
+}
+
+/** Whether any input of tx pushes a Dilithium key id in place of the public key */
+static bool HasDilithiumKeyRef(const CTransaction& tx)
+{
+    valtype sig, key;
+    for (const CTxIn& txin : tx.vin) {
+        if (GetDilithiumSpendPushes(txin.scriptSig, sig, key) && key.size() == DILITHIUM_KEYREF_SIZE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Get the Dilithium public key revealed by a spend of a Dilithium pubkey hash output */
+static bool ExtractRevealedDilithiumKey(const CScript& scriptSig, const CScript& spentScript, uint160& keyid, valtype& pubkey)
+{
+    if (!spentScript.IsPayToDilithiumPubKeyHash()) return false;
+    valtype sig;
+    if (!GetDilithiumSpendPushes(scriptSig, sig, pubkey) || pubkey.size() != dilithium::PUBLIC_KEY_SIZE) return false;
+    keyid = uint160{Span{spentScript}.subspan(3, DILITHIUM_KEYREF_SIZE)};
+    return Hash160(pubkey) == keyid;
+}
+
+/** Whether every Dilithium key id that tx pushes in place of a public key resolves through keys */
+static bool DilithiumKeyRefsResolve(const CTransaction& tx, const CCoinsView& inputs, const DilithiumKeyLookup& keys)
+{
+    valtype sig, key, pubkey;
+    for (const CTxIn& txin : tx.vin) {
+        if (!GetDilithiumSpendPushes(txin.scriptSig, sig, key) || key.size() != DILITHIUM_KEYREF_SIZE) continue;
+        const std::optional<Coin> coin{inputs.GetCoin(txin.prevout)};
+        if (!coin || !coin->out.scriptPubKey.IsPayToDilithiumPubKeyHash()) continue;
+        if (!keys.GetDilithiumPubKey(uint160{key}, pubkey)) return false;
+    }
+    return true;
+}
+
+/** Forget the Dilithium public keys that block revealed first, it is being disconnected */
+static bool EraseDilithiumKeyReveals(const CBlock& block, const CBlockIndex& index, kernel::BlockTreeDB& db)
+{
+    std::vector<uint160> keyids;
+    valtype sig, pubkey;
+    for (const CTransactionRef& tx : block.vtx) {
+        for (const CTxIn& txin : tx->vin) {
+            if (!GetDilithiumSpendPushes(txin.scriptSig, sig, pubkey) || pubkey.size() != dilithium::PUBLIC_KEY_SIZE) continue;
+            const uint160 keyid{Hash160(pubkey)};
+            CDilithiumKeyIndexValue indexed;
+            if (db.ReadDilithiumKeyIndex(keyid, indexed) && indexed.blockHash == index.GetBlockHash()) {
+                keyids.push_back(keyid);
+            }
+        }
+    }
+    return keyids.empty() || db.EraseDilithiumKeyIndex(keyids);
+}
+
+bool ChainDilithiumKeys::GetDilithiumPubKey(const uint160& keyid, std::vector<unsigned char>& pubkey) const
+{
+    CDilithiumKeyIndexValue indexed;
+    if (!m_tip || !m_db.ReadDilithiumKeyIndex(keyid, indexed)) return false;
+    if (indexed.blockHeight < 0 || indexed.blockHeight > m_tip->nHeight ||
+        m_tip->GetAncestor(indexed.blockHeight)->GetBlockHash() != indexed.blockHash) {
+        return false;
+    }
+    pubkey = std::move(indexed.pubkey);
+    return true;
+}
+
 static void LimitMempoolSize(CTxMemPool& pool, CCoinsViewCache& coins_cache)
     EXCLUSIVE_LOCKS_REQUIRED(::cs_main, pool.cs)
 {
@@ -361,12 +458,13 @@ void Chainstate::MaybeUpdateMempoolForReorg(
     m_mempool->UpdateTransactionsFromBlock(vHashUpdate);
 
     // Predicate to use for filtering transactions in removeForReorg.
-    // Checks whether the transaction is still final and, if it spends a coinbase output, mature.
-    // Also updates valid entries' cached LockPoints if needed.
+    // Checks whether the transaction is still final and, if it spends a coinbase output, mature,
+    // and whether the Dilithium keys it references are still revealed. Also updates valid entries' cached LockPoints if needed.
     // If false, the tx is still valid and its lockpoints are updated.
     // If true, the tx would be invalid in the next block; remove this entry and all of its descendants.
     // Note that TRUC rules are not applied here, so reorgs may cause violations of TRUC inheritance or
     // topology restrictions.
+    const ChainDilithiumKeys dilithium_keys{*m_blockman.m_block_tree_db, m_chain.Tip()};
     const auto filter_final_and_mature = [&](CTxMemPool::txiter it)
         EXCLUSIVE_LOCKS_REQUIRED(m_mempool->cs, ::cs_main) {
         AssertLockHeld(m_mempool->cs);
@@ -406,6 +504,13 @@ void Chainstate::MaybeUpdateMempoolForReorg(
                 }
             }
         }
+
+        // Dilithium key references must still resolve, the block revealing the key may have been disconnected.
+        if (HasDilithiumKeyRef(tx)) {
+            if (!DilithiumKeyRefActiveAfterTip(*this)) return true;
+            const CCoinsViewMemPool view_mempool{&CoinsTip(), *m_mempool};
+            if (!DilithiumKeyRefsResolve(tx, view_mempool, dilithium_keys)) return true;
+        }
         // Transaction is still valid and cached LockPoints are updated.
         return false;
     };
@@ -424,7 +529,7 @@ void Chainstate::MaybeUpdateMempoolForReorg(
 static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, TxValidationState& state,
                 const CCoinsViewCache& view, const CTxMemPool& pool,
                 unsigned int flags, PrecomputedTransactionData& txdata, CCoinsViewCache& coins_tip,
-                ValidationCache& validation_cache)
+                ValidationCache& validation_cache, const DilithiumKeyLookup* dilithium_keys)
                 EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
 {
     AssertLockHeld(cs_main);
@@ -456,7 +561,7 @@ static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, TxValidationS
     }
 
     // Call CheckInputScripts() to cache signature and script validity against current tip consensus rules.
-    return CheckInputScripts(tx, state, view, flags, /* cacheSigStore= */ true, /* cacheFullScriptStore= */ true, txdata, validation_cache);
+    return CheckInputScripts(tx, state, view, flags, /* cacheSigStore= */ true, /* cacheFullScriptStore= */ true, txdata, validation_cache, /* pvChecks= */ nullptr, dilithium_keys);
 }
 
 namespace {
@@ -512,10 +617,13 @@ public:
         /** Whether CPFP carveout and RBF carveout are granted. */
         const bool m_allow_carveouts;
 
+        /** Results of an earlier acceptance of a restored transaction, nullptr if none */
+        const MempoolRestoreWitness* m_restore_witness{nullptr};
+
         /** Parameters for single transaction mempool validation. */
         static ATMPArgs SingleAccept(const CChainParams& chainparams, int64_t accept_time,
                                      bool bypass_limits, std::vector<COutPoint>& coins_to_uncache,
-                                     bool test_accept) {
+                                     bool test_accept, const MempoolRestoreWitness* restore_witness = nullptr) {
             return ATMPArgs{/* m_chainparams */ chainparams,
                             /* m_accept_time */ accept_time,
                             /* m_bypass_limits */ bypass_limits,
@@ -527,6 +635,7 @@ public:
                             /* m_package_feerates */ false,
                             /* m_client_maxfeerate */ {}, // checked by caller
                             /* m_allow_carveouts */ true,
+                            /* m_restore_witness */ restore_witness,
             };
         }
 
@@ -593,7 +702,8 @@ public:
                  bool package_submission,
                  bool package_feerates,
                  std::optional<CFeeRate> client_maxfeerate,
-                 bool allow_carveouts)
+                 bool allow_carveouts,
+                 const MempoolRestoreWitness* restore_witness = nullptr)
             : m_chainparams{chainparams},
               m_accept_time{accept_time},
               m_bypass_limits{bypass_limits},
@@ -604,7 +714,8 @@ public:
               m_package_submission{package_submission},
               m_package_feerates{package_feerates},
               m_client_maxfeerate{client_maxfeerate},
-              m_allow_carveouts{allow_carveouts}
+              m_allow_carveouts{allow_carveouts},
+              m_restore_witness{restore_witness}
         {
             // If we are using package feerates, we must be doing package submission.
             // It also means carveouts and sibling eviction are not permitted.
@@ -919,10 +1030,25 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     }
 
     // The mempool holds txs for the next block, so pass height+1 to CheckTxInputs
-    if (!Consensus::CheckTxInputs(tx, state, m_view, m_active_chainstate.m_chain.Height() + 1, ws.m_base_fees)) {
+    if (!Consensus::CheckTxInputs(tx, state, m_view, m_active_chainstate.m_chain.Height() + 1, ws.m_base_fees, chainparams.GetConsensus())) {
         return false; // state filled in by CheckTxInputs
     }
 
+    // An MPoS balance claim must be covered by the balance at the tip, and only
+    // one claim of a balance is kept, a replacement has to conflict with it
+    uint160 claimKey;
+    CAmount nClaimed = 0;
+    if (m_active_chainstate.m_chain.Height() + 1 >= chainparams.GetConsensus().nMPoSBalanceHeight && GetMPoSClaim(tx, claimKey, nClaimed)) {
+        CAmount balance = 0;
+        if (!m_active_chainstate.m_blockman.m_block_tree_db->ReadMPoSBalance(claimKey, balance) || nClaimed > balance) {
+            return state.Invalid(TxValidationResult::TX_CONFLICT, "bad-txns-mpos-claim-balance");
+        }
+        auto pending = m_pool.mapMPoSClaims.find(claimKey);
+        if (pending != m_pool.mapMPoSClaims.end() && !ws.m_conflicts.count(pending->second->GetHash())) {
+            return state.Invalid(TxValidationResult::TX_MEMPOOL_POLICY, "txn-mempool-mpos-claim-conflict");
+        }
+    }
+
     if (m_pool.m_opts.require_standard && !AreInputsStandard(tx, m_view)) {
         return state.Invalid(TxValidationResult::TX_INPUTS_NOT_STANDARD, "bad-txns-nonstandard-inputs");
     }
@@ -935,6 +1061,7 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     int64_t nSigOpsCost = GetTransactionSigOpCost(tx, m_view, STANDARD_SCRIPT_VERIFY_FLAGS);
 
     dev::u256 txMinGasPrice = 0;
+    uint64_t txGasLimit = 0;
 
     //////////////////////////////////////////////////////////// // qtum
     if(!CheckOpSender(tx, chainparams, m_active_chainstate.m_chain.Height() + 1)){
@@ -945,6 +1072,10 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
         if(!CheckSenderScript(m_view, tx)){
             return state.Invalid(TxValidationResult::TX_INVALID_SENDER_SCRIPT, "bad-txns-invalid-sender-script");
         }
+    }
+    // Restored transactions go through the contract checks too, as the
+    // -minmempoolgaslimit policy and the DGP parameters may have changed
+    if(tx.HasCreateOrCall()){
 
         QtumDGP qtumDGP(globalState.get(), m_active_chainstate, fGettingValuesDGP);
         uint64_t minGasPrice = qtumDGP.getMinGasPrice(m_active_chainstate.m_chain.Tip()->nHeight + 1);
@@ -953,7 +1084,8 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
         for(const CTxOut& o : tx.vout)
             count += o.scriptPubKey.HasOpCreate() || o.scriptPubKey.HasOpCall() ? 1 : 0;
         unsigned int contractflags = GetContractScriptFlags(m_active_chainstate.m_chain.Height() + 1, chainparams.GetConsensus());
-        QtumTxConverter converter(tx, m_active_chainstate, &m_pool, NULL, NULL, contractflags);
+        // The view has the outputs of package parents that are not in the mempool yet
+        QtumTxConverter converter(tx, m_active_chainstate, &m_pool, &m_view, NULL, contractflags);
         ExtractQtumTX resultConverter;
         if(!converter.extractionQtumTransactions(resultConverter)){
             return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-tx-bad-contract-format", "AcceptToMempool(): Contract transaction of the wrong format");
@@ -1014,6 +1146,8 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
 
         if(count > qtumTransactions.size())
             return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-incorrect-format");
+
+        txGasLimit = (uint64_t)gasAllTxs;
     }
     ////////////////////////////////////////////////////////////
 
@@ -1034,7 +1168,7 @@ bool MemPoolAccept::PreChecks(ATMPArgs& args, Workspace& ws)
     if (!m_subpackage.m_changeset) {
         m_subpackage.m_changeset = m_pool.GetChangeSet();
     }
-    ws.m_tx_handle = m_subpackage.m_changeset->StageAddition(ptx, ws.m_base_fees, nAcceptTime, m_active_chainstate.m_chain.Height(), entry_sequence, fSpendsCoinbase, nSigOpsCost, lock_points.value(), CAmount(txMinGasPrice));
+    ws.m_tx_handle = m_subpackage.m_changeset->StageAddition(ptx, ws.m_base_fees, nAcceptTime, m_active_chainstate.m_chain.Height(), entry_sequence, fSpendsCoinbase, nSigOpsCost, lock_points.value(), CAmount(txMinGasPrice), txGasLimit);
 
     // ws.m_modified_fees includes any fee deltas from PrioritiseTransaction
     ws.m_modified_fees = ws.m_tx_handle->GetModifiedFee();
@@ -1217,6 +1351,15 @@ bool MemPoolAccept::ReplacementChecks(Workspace& ws)
                              strprintf("insufficient fee%s", ws.m_sibling_eviction ? " (including sibling eviction)" : ""), *err_string);
     }
 
+    // Contract transactions are mined by gas price rather than feerate, so a
+    // replacement must also raise the gas price of the contract transactions it
+    // replaces.
+    if (tx.HasCreateOrCall()) {
+        if (const auto err_string{PaysMoreGasPriceThanConflicts(ws.m_iters_conflicting, ws.m_tx_handle->GetMinGasPrice(), hash)}) {
+            return state.Invalid(TxValidationResult::TX_MEMPOOL_POLICY, "insufficient gas price", *err_string);
+        }
+    }
+
     CTxMemPool::setEntries all_conflicts;
 
     // Calculate all conflicting entries and enforce Rule #5.
@@ -1359,17 +1502,23 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
     const CTransaction& tx = *ws.m_ptx;
     TxValidationState& state = ws.m_state;
 
-    constexpr unsigned int scriptVerifyFlags = STANDARD_SCRIPT_VERIFY_FLAGS;
+    if (args.m_restore_witness && args.m_restore_witness->scripts_verified) {
+        return true;
+    }
+
+    unsigned int scriptVerifyFlags = GetPolicyScriptFlags(m_active_chainstate);
+    const ChainDilithiumKeys chain_dilithium_keys{*m_active_chainstate.m_blockman.m_block_tree_db, m_active_chainstate.m_chain.Tip()};
+    const DilithiumKeyLookup* dilithium_keys{&chain_dilithium_keys};
 
     // Check input scripts and signatures.
     // This is done last to help prevent CPU exhaustion denial-of-service attacks.
-    if (!CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache())) {
+    if (!CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache(), nullptr, dilithium_keys)) {
         // SCRIPT_VERIFY_CLEANSTACK requires SCRIPT_VERIFY_WITNESS, so we
         // need to turn both off, and compare against just turning off CLEANSTACK
         // to see if the failure is specifically due to witness validation.
         TxValidationState state_dummy; // Want reported failures to be from first CheckInputScripts
-        if (!tx.HasWitness() && CheckInputScripts(tx, state_dummy, m_view, scriptVerifyFlags & ~(SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_CLEANSTACK), true, false, ws.m_precomputed_txdata, GetValidationCache()) &&
-                !CheckInputScripts(tx, state_dummy, m_view, scriptVerifyFlags & ~SCRIPT_VERIFY_CLEANSTACK, true, false, ws.m_precomputed_txdata, GetValidationCache())) {
+        if (!tx.HasWitness() && CheckInputScripts(tx, state_dummy, m_view, scriptVerifyFlags & ~(SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_CLEANSTACK), true, false, ws.m_precomputed_txdata, GetValidationCache(), nullptr, dilithium_keys) &&
+                !CheckInputScripts(tx, state_dummy, m_view, scriptVerifyFlags & ~SCRIPT_VERIFY_CLEANSTACK, true, false, ws.m_precomputed_txdata, GetValidationCache(), nullptr, dilithium_keys)) {
             // Only the witness is missing, so the transaction itself may be fine.
             state.Invalid(TxValidationResult::TX_WITNESS_STRIPPED,
                     state.GetRejectReason(), state.GetDebugMessage());
@@ -1403,9 +1552,22 @@ bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs& args, Workspace& ws)
     // There is a similar check in CreateNewBlock() to prevent creating
     // invalid blocks (using TestBlockValidity), however allowing such
     // transactions into the mempool can be exploited as a DoS attack.
+    //
+    // Restored transactions whose scripts were verified under the same flags
+    // before a restart are not checked again. They are then not added to the
+    // script execution cache either, so blocks still fully verify them.
+    if (args.m_restore_witness && args.m_restore_witness->scripts_verified) {
+        return true;
+    }
     unsigned int currentBlockScriptVerifyFlags{GetBlockScriptFlags(*m_active_chainstate.m_chain.Tip(), m_active_chainstate.m_chainman)};
+    // Key references become valid with the activation block itself, which the policy flags already allow
+    if (DilithiumKeyRefActiveAfterTip(m_active_chainstate)) {
+        currentBlockScriptVerifyFlags |= SCRIPT_VERIFY_DILITHIUM_KEYREF;
+    }
+    const ChainDilithiumKeys dilithium_keys{*m_active_chainstate.m_blockman.m_block_tree_db, m_active_chainstate.m_chain.Tip()};
     if (!CheckInputsFromMempoolAndCache(tx, state, m_view, m_pool, currentBlockScriptVerifyFlags,
-                                        ws.m_precomputed_txdata, m_active_chainstate.CoinsTip(), GetValidationCache())) {
+                                        ws.m_precomputed_txdata, m_active_chainstate.CoinsTip(), GetValidationCache(),
+                                        &dilithium_keys)) {
         LogPrintf("BUG! PLEASE REPORT THIS! CheckInputScripts failed against latest-block but not STANDARD flags %s, %s\n", hash.ToString(), state.ToString());
         return Assume(false);
     }
@@ -2023,8 +2185,16 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptPackage(const Package& package,
 
 } // anon namespace
 
+uint64_t GetMempoolScriptFlags(const Chainstate& active_chainstate)
+{
+    AssertLockHeld(::cs_main);
+    const unsigned int block_flags{GetBlockScriptFlags(*active_chainstate.m_chain.Tip(), active_chainstate.m_chainman)};
+    return (uint64_t{GetPolicyScriptFlags(active_chainstate)} << 32) | block_flags;
+}
+
 MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTransactionRef& tx,
-                                       int64_t accept_time, bool bypass_limits, bool test_accept)
+                                       int64_t accept_time, bool bypass_limits, bool test_accept,
+                                       const MempoolRestoreWitness* restore_witness)
 {
     AssertLockHeld(::cs_main);
     const CChainParams& chainparams{active_chainstate.m_chainman.GetParams()};
@@ -2032,7 +2202,7 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
     CTxMemPool& pool{*active_chainstate.GetMempool()};
 
     std::vector<COutPoint> coins_to_uncache;
-    auto args = MemPoolAccept::ATMPArgs::SingleAccept(chainparams, accept_time, bypass_limits, coins_to_uncache, test_accept);
+    auto args = MemPoolAccept::ATMPArgs::SingleAccept(chainparams, accept_time, bypass_limits, coins_to_uncache, test_accept, restore_witness);
     MempoolAcceptResult result = MemPoolAccept(pool, active_chainstate).AcceptSingleTransaction(tx, args);
     if (result.m_result_type != MempoolAcceptResult::ResultType::VALID) {
         // Remove coins that were not present in the coins cache before calling
@@ -2373,7 +2543,9 @@ std::optional<std::pair<ScriptError, std::string>> CScriptCheck::operator()() {
     const CScript &scriptSig = ptxTo->vin[nIn].scriptSig;
     const CScriptWitness *witness = &ptxTo->vin[nIn].scriptWitness;
     ScriptError error{SCRIPT_ERR_UNKNOWN_ERROR};
-    if (VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *m_signature_cache, *txdata), &error)) {
+    CachingTransactionSignatureChecker checker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *m_signature_cache, *txdata);
+    checker.SetDilithiumKeyLookup(m_dilithium_keys);
+    if (VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, checker, &error)) {
         return std::nullopt;
     } else {
         auto debug_str = strprintf("input %i of %s (wtxid %s), spending %s:%i", nIn, ptxTo->GetHash().ToString(), ptxTo->GetWitnessHash().ToString(), ptxTo->vin[nIn].prevout.hash.ToString(), ptxTo->vin[nIn].prevout.n);
@@ -2420,7 +2592,8 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                        const CCoinsViewCache& inputs, unsigned int flags, bool cacheSigStore,
                        bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
                        ValidationCache& validation_cache,
-                       std::vector<CScriptCheck>* pvChecks)
+                       std::vector<CScriptCheck>* pvChecks,
+                       const DilithiumKeyLookup* dilithium_keys)
 {
     if (tx.IsCoinBase()) return true;
 
@@ -2428,6 +2601,11 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
         pvChecks->reserve(tx.vin.size());
     }
 
+    // Dilithium key references resolve against the revealed-key index, which
+    // a reorg can shrink, so their result must not be kept in the script
+    // execution cache.
+    const bool skip_script_cache{(flags & SCRIPT_VERIFY_DILITHIUM_KEYREF) && HasDilithiumKeyRef(tx)};
+
     // First check if script executions have been cached with the same
     // flags. Note that this assumes that the inputs provided are
     // correct (ie that the transaction hash which is in tx's prevouts
@@ -2437,7 +2615,7 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
     CSHA256 hasher = validation_cache.ScriptExecutionCacheHasher();
     hasher.Write(UCharCast(tx.GetWitnessHash().begin()), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
     AssertLockHeld(cs_main); //TODO: Remove this requirement by making CuckooCache not require external locks
-    if (validation_cache.m_script_execution_cache.contains(hashCacheEntry, !cacheFullScriptStore)) {
+    if (!skip_script_cache && validation_cache.m_script_execution_cache.contains(hashCacheEntry, !cacheFullScriptStore)) {
         return true;
     }
 
@@ -2464,7 +2642,7 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
         // spent being checked as a part of CScriptCheck.
 
         // Verify signature
-        CScriptCheck check(txdata.m_spent_outputs[i], tx, validation_cache.m_signature_cache, i, flags, cacheSigStore, &txdata);
+        CScriptCheck check(txdata.m_spent_outputs[i], tx, validation_cache.m_signature_cache, i, flags, cacheSigStore, &txdata, dilithium_keys);
         if (pvChecks) {
             pvChecks->emplace_back(std::move(check));
         } else if (auto result = check(); result.has_value()) {
@@ -2478,7 +2656,7 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
                 // non-upgraded nodes by banning CONSENSUS-failing
                 // data providers.
                 CScriptCheck check2(txdata.m_spent_outputs[i], tx, validation_cache.m_signature_cache, i,
-                        flags & ~STANDARD_NOT_MANDATORY_VERIFY_FLAGS, cacheSigStore, &txdata);
+                        flags & ~STANDARD_NOT_MANDATORY_VERIFY_FLAGS, cacheSigStore, &txdata, dilithium_keys);
                 auto mandatory_result = check2();
                 if (!mandatory_result.has_value()) {
                     return state.Invalid(TxValidationResult::TX_NOT_STANDARD, strprintf("non-mandatory-script-verify-flag (%s)", ScriptErrorString(result->first)), result->second);
@@ -2512,7 +2690,7 @@ bool CheckInputScripts(const CTransaction& tx, TxValidationState& state,
         }
     }
 
-    if (cacheFullScriptStore && !pvChecks) {
+    if (cacheFullScriptStore && !pvChecks && !skip_script_cache) {
         // We executed all of the provided scripts, and were told to
         // cache the result. Do so now.
         validation_cache.m_script_execution_cache.insert(hashCacheEntry);
@@ -2562,6 +2740,109 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
     return fClean ? DISCONNECT_OK : DISCONNECT_UNCLEAN;
 }
 
+/** Check that the accrued MPoS balances before a block cover the claims of its
+ *  transactions. A block that is verified again after it was connected finds
+ *  the balances before it in its undo data. */
+static bool CheckMPoSClaims(const std::map<uint160, CAmount>& mposClaims, const CBlockIndex* pindex, bool fConnected, node::BlockManager& blockman, BlockValidationState& state)
+{
+    if(mposClaims.empty())
+        return true;
+
+    kernel::BlockTreeDB& db = *blockman.m_block_tree_db;
+    CMPoSBalanceUndo undo;
+    if(fConnected && (!db.ReadMPoSBalanceUndo(pindex->nHeight, undo) || undo.blockHash != pindex->GetBlockHash()))
+        return state.Error(strprintf("%s: MPoS balances not available for block %s", __func__, pindex->GetBlockHash().ToString()));
+
+    for(const auto& [key, amount] : mposClaims)
+    {
+        CAmount balance = 0;
+        if(fConnected)
+        {
+            // The undo data has the balance of every key the block changed
+            for(const auto& [keyid, value] : undo.balances)
+            {
+                if(keyid == key)
+                    balance = value;
+            }
+        }
+        else if(!db.ReadMPoSBalance(key, balance))
+        {
+            return state.Error(strprintf("%s: failed to read the MPoS balance of %s", __func__, key.GetReverseHex()));
+        }
+
+        if(amount > balance)
+            return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-txns-mpos-claim-balance", strprintf("%s: claims of %s exceed its MPoS balance (%d > %d)", __func__, key.GetReverseHex(), amount, balance));
+    }
+    return true;
+}
+
+/** Unwind the accrued MPoS balances to a block, with the undo data of the blocks
+ *  they were updated with since. Returns whether they are at the block. */
+static bool RewindMPoSBalances(const CBlockIndex* pindex, node::BlockManager& blockman) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    kernel::BlockTreeDB& db = *blockman.m_block_tree_db;
+    uint256 hashBest;
+    if(!db.ReadMPoSBalanceBestBlock(hashBest))
+        return false;
+
+    while(hashBest != pindex->GetBlockHash())
+    {
+        // Only blocks that are not ancestors of the block are unwound
+        const CBlockIndex* pindexBest = blockman.LookupBlockIndex(hashBest);
+        if(!pindexBest || !pindexBest->pprev || pindex->GetAncestor(pindexBest->nHeight) == pindexBest)
+            return false;
+
+        CMPoSBalanceUndo undo;
+        if(!db.ReadMPoSBalanceUndo(pindexBest->nHeight, undo) || undo.blockHash != hashBest)
+            return false;
+        if(!db.UndoMPoSBalances(pindexBest->nHeight, undo, pindexBest->pprev->GetBlockHash()))
+            return false;
+        hashBest = pindexBest->pprev->GetBlockHash();
+    }
+    return true;
+}
+
+/** Pay out the claimed balances of a block and add its accrued rewards to the MPoS balances */
+static bool UpdateMPoSBalances(const CBlockIndex* pindex, const std::map<uint160, CAmount>& mposClaims, const std::vector<CTxOut>& mposAccruals, const Consensus::Params& consensusParams, node::BlockManager& blockman)
+{
+    kernel::BlockTreeDB& db = *blockman.m_block_tree_db;
+    std::map<uint160, CAmount> balances;
+    CMPoSBalanceUndo undo;
+    undo.blockHash = pindex->GetBlockHash();
+
+    for(const auto& [key, amount] : mposClaims)
+    {
+        CAmount balance = 0;
+        if(!db.ReadMPoSBalance(key, balance))
+            return false;
+        undo.balances.emplace_back(key, balance);
+        balances[key] = balance - amount;
+    }
+
+    for(const CTxOut& accrual : mposAccruals)
+    {
+        // The pieces of unknown recipients are burnt, as their OP_RETURN outputs were
+        std::vector<valtype> vSolutions;
+        if(Solver(accrual.scriptPubKey, vSolutions) != TxoutType::PUBKEYHASH)
+            continue;
+        uint160 key(vSolutions[0]);
+        auto it = balances.find(key);
+        if(it == balances.end())
+        {
+            CAmount balance = 0;
+            if(!db.ReadMPoSBalance(key, balance))
+                return false;
+            undo.balances.emplace_back(key, balance);
+            it = balances.emplace(key, balance).first;
+        }
+        it->second += accrual.nValue;
+    }
+
+    // Keep the undo data as deep as the chain can be reorganized
+    const int pruneHeight = pindex->nHeight - consensusParams.MaxCheckpointSpan() - 1;
+    return db.WriteMPoSBalances(pindex->nHeight, {balances.begin(), balances.end()}, undo, pruneHeight);
+}
+
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
  *  When FAILED is returned, view is left in an indeterminate state. */
 DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, bool* pfClean)
@@ -2689,7 +2970,7 @@ DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIn
     globalState->setRootUTXO(uintToh256(pindex->pprev->hashUTXORoot)); // qtum
 
     if(pfClean == NULL && fLogEvents){
-        pstorageresult->deleteResults(block.vtx);
+        pstorageresult->deleteResults(block.vtx, pindex->nHeight);
         m_blockman.m_block_tree_db->EraseHeightIndex(pindex->nHeight);
     }
 
@@ -2702,6 +2983,18 @@ DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIn
             m_blockman.m_block_tree_db->EraseDelegateIndex(pindex->nHeight);
     }
 
+    // Unwind the MPoS balances of the block
+    if(pfClean == NULL && pindex->nHeight >= chainparams.GetConsensus().nMPoSBalanceHeight && !RewindMPoSBalances(pindex->pprev, m_blockman)) {
+        LogError("DisconnectBlock(): failed to unwind MPoS balances of block %s\n", pindex->GetBlockHash().ToString());
+        return DISCONNECT_FAILED;
+    }
+
+    if (pfClean == NULL && pindex->nHeight >= chainparams.GetConsensus().nDilithiumKeyRefHeight &&
+        !EraseDilithiumKeyReveals(block, *pindex, *m_blockman.m_block_tree_db)) {
+        LogError("Failed to delete Dilithium key index");
+        return DISCONNECT_FAILED;
+    }
+
     //////////////////////////////////////////////////// // qtum
     if (pfClean == NULL && fAddressIndex) {
         if (!m_blockman.m_block_tree_db->EraseAddressIndex(addressIndex)) {
@@ -2786,6 +3079,11 @@ static unsigned int GetBlockScriptFlags(const CBlockIndex& block_index, const Ch
         flags |= SCRIPT_OUTPUT_SENDER;
     }
 
+    // Allow spends to reference Dilithium public keys revealed in earlier blocks
+    if (block_index.nHeight >= consensusparams.nDilithiumKeyRefHeight) {
+        flags |= SCRIPT_VERIFY_DILITHIUM_KEYREF;
+    }
+
     return flags;
 }
 
@@ -3013,7 +3311,7 @@ bool CheckMinGasPrice(std::vector<EthTransactionParams>& etps, const uint64_t& m
     return true;
 }
 
-bool CheckReward(const CBlock& block, BlockValidationState& state, int nHeight, const Consensus::Params& consensusParams, CAmount nFees, CAmount gasRefunds, CAmount nActualStakeReward, const std::vector<CTxOut>& vouts, CAmount nValueCoinPrev, bool delegateOutputExist, CChain& chain, node::BlockManager& blockman)
+bool CheckReward(const CBlock& block, BlockValidationState& state, int nHeight, const Consensus::Params& consensusParams, CAmount nFees, CAmount gasRefunds, CAmount nActualStakeReward, const std::vector<CTxOut>& vouts, CAmount nValueCoinPrev, bool delegateOutputExist, CChain& chain, node::BlockManager& blockman, std::vector<CTxOut>& mposAccruals)
 {
     size_t offset = block.IsProofOfStake() ? 1 : 0;
     std::vector<CTxOut> vTempVouts=block.vtx[offset]->vout;
@@ -3073,6 +3371,15 @@ bool CheckReward(const CBlock& block, BlockValidationState& state, int nHeight,
             CAmount nMinedReward = nValueStaker + nValueDelegate - nValueCoinPrev;
             if(nReward != nMinedReward)
                 return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-cs-delegate-reward", "CheckReward(): The block reward is not split correctly between the staker and the delegate");
+
+            // After the fork the reward of the delegate accrues to its MPoS balance
+            if(delegateOutputExist && nHeight >= consensusParams.nMPoSBalanceHeight){
+                const CTxOut& credit = block.vtx[offset]->vout[2];
+                uint160 delegate;
+                if(!ExtractMPoSCredit(credit.scriptPubKey, delegate))
+                    return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-cs-delegate-credit", "CheckReward(): The reward of the delegate is not credited to its MPoS balance");
+                mposAccruals.push_back(CTxOut(credit.nValue, GetScriptForDestination(PKHash(delegate))));
+            }
         }
 
         //if only 1 then no MPoS logic required
@@ -3087,6 +3394,19 @@ bool CheckReward(const CBlock& block, BlockValidationState& state, int nHeight,
             return false;
         }
 
+        // After the fork the pieces accrue to the balances of the recipients,
+        // the coinstake must not pay them
+        if(nHeight >= consensusParams.nMPoSBalanceHeight){
+            CAmount nAccrued = 0;
+            for(const CTxOut& txout : mposOutputList){
+                nAccrued += txout.nValue;
+            }
+            if(nActualStakeReward > blockReward - nAccrued)
+                return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-cs-amount", strprintf("CheckReward(): coinstake pays the accrued MPoS rewards (actual=%d vs limit=%d)", nActualStakeReward, blockReward - nAccrued));
+            mposAccruals.insert(mposAccruals.end(), mposOutputList.begin(), mposOutputList.end());
+            return true;
+        }
+
         for(size_t i = 0; i < mposOutputList.size(); i++){
             it=std::find(vTempVouts.begin(), vTempVouts.end(), mposOutputList[i]);
             if(it==vTempVouts.end()){
@@ -3243,6 +3563,26 @@ void LastHashes::clear()
     m_lastHashes.clear();
 }
 
+/** Records the changes contract execution commits to globalState while in scope */
+class StateDiffRecorder
+{
+public:
+    explicit StateDiffRecorder(bool active) : m_active(active) {
+        if (m_active) globalState->startStateDiff();
+    }
+    ~StateDiffRecorder() {
+        if (m_active) globalState->stopStateDiff();
+    }
+    std::vector<AccountStateDiff> take() {
+        if (!m_active) return {};
+        m_active = false;
+        return globalState->stopStateDiff();
+    }
+
+private:
+    bool m_active;
+};
+
 class ExecTransientStorage
 {
 public:
@@ -3563,7 +3903,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-delegate-output", strprintf("%s : delegation output check failed", __func__));
     }
 
-    if (block.IsProofOfStake() && pindex->nHeight > params.GetConsensus().nEnableHeaderSignatureHeight && !CheckBlockInputPubKeyMatchesOutputPubKey(block, view, delegateOutputExist)) {
+    if (block.IsProofOfStake() && pindex->nHeight > params.GetConsensus().nEnableHeaderSignatureHeight && !CheckBlockInputPubKeyMatchesOutputPubKey(block, view, delegateOutputExist, pindex->nHeight >= params.GetConsensus().nMPoSBalanceHeight)) {
         return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-blk-coinstake-input-output-mismatch");
     }
 
@@ -3770,15 +4110,26 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     int64_t nSigOpsCost = 0;
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
 
+    // After the fork the MPoS rewards accrue to balances of their recipients,
+    // which transactions of later blocks claim
+    const bool fMPoSBalances = pindex->nHeight >= params.GetConsensus().nMPoSBalanceHeight;
+    const bool fExtendsTip = pindex->pprev == m_chain.Tip();
+    std::map<uint160, CAmount> mposClaims;
+
     ///////////////////////////////////////////////////////// // qtum
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
     std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
     std::map<dev::Address, std::pair<CHeightTxIndexKey, std::vector<uint256>>> heightIndexes;
     /////////////////////////////////////////////////////////
+    const bool fDilithiumKeyRef = pindex->nHeight >= params.GetConsensus().nDilithiumKeyRefHeight;
+    std::vector<std::pair<uint160, CDilithiumKeyIndexValue>> dilithiumKeyIndex;
+    // Keys revealed by earlier blocks of this chain, outlives the script checks of control
+    const ChainDilithiumKeys dilithiumKeys{*m_blockman.m_block_tree_db, pindex->pprev};
 
     uint64_t blockGasUsed = 0;
     CAmount gasRefunds=0;
+    StateDiffRecorder stateDiffRecorder(g_state_diff_journal && !fJustCheck);
 
     uint64_t nValueOut=0;
     uint64_t nValueIn=0;
@@ -3805,7 +4156,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         {
             CAmount txfee = 0;
             TxValidationState tx_state;
-            if (!Consensus::CheckTxInputs(tx, tx_state, view, pindex->nHeight, txfee)) {
+            if (!Consensus::CheckTxInputs(tx, tx_state, view, pindex->nHeight, txfee, params.GetConsensus())) {
                 // Any transaction validation failure in ConnectBlock is a block consensus failure
                 state.Invalid(BlockValidationResult::BLOCK_CONSENSUS,
                               tx_state.GetRejectReason(),
@@ -3819,6 +4170,18 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
                 break;
             }
 
+            uint160 claimKey;
+            CAmount nClaimed = 0;
+            if (fMPoSBalances && GetMPoSClaim(tx, claimKey, nClaimed)) {
+                CAmount& nKeyClaimed = mposClaims[claimKey];
+                nKeyClaimed += nClaimed;
+                if (!MoneyRange(nKeyClaimed)) {
+                    state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-txns-mpos-claim-balance",
+                                  "accumulated MPoS balance claims in the block out of range");
+                    break;
+                }
+            }
+
             // Check that transaction is BIP68 final
             // BIP68 lock checks (as opposed to nLockTime checks) must
             // be in ConnectBlock because they require the UTXO set
@@ -3880,7 +4243,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             std::vector<CScriptCheck> vChecks;
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
             TxValidationState tx_state;
-            if (fScriptChecks && !CheckInputScripts(tx, tx_state, view, flags, fCacheResults, fCacheResults, txsdata[i], m_chainman.m_validation_cache, (hasOpSpend || tx.HasCreateOrCall()) ? nullptr : (parallel_script_checks ? &vChecks : nullptr))) {
+            if (fScriptChecks && !CheckInputScripts(tx, tx_state, view, flags, fCacheResults, fCacheResults, txsdata[i], m_chainman.m_validation_cache, (hasOpSpend || tx.HasCreateOrCall()) ? nullptr : (parallel_script_checks ? &vChecks : nullptr), &dilithiumKeys)) {
                 // Any transaction validation failure in ConnectBlock is a block consensus failure
                 state.Invalid(BlockValidationResult::BLOCK_CONSENSUS,
                               tx_state.GetRejectReason(), tx_state.GetDebugMessage());
@@ -3888,6 +4251,21 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             }
             control.Add(std::move(vChecks));
 
+            // Index Dilithium public keys revealed for the first time, so that
+            // spends in later blocks can reference them by key id
+            if (fDilithiumKeyRef) {
+                for (const CTxIn& txin : tx.vin) {
+                    uint160 keyid;
+                    valtype pubkey;
+                    if (!ExtractRevealedDilithiumKey(txin.scriptSig, view.AccessCoin(txin.prevout).out.scriptPubKey, keyid, pubkey)) continue;
+                    // Entries of blocks outside this chain are stale and overwritten
+                    valtype revealed;
+                    if (dilithiumKeys.GetDilithiumPubKey(keyid, revealed)) continue;
+                    if (std::any_of(dilithiumKeyIndex.begin(), dilithiumKeyIndex.end(), [&](const auto& e) { return e.first == keyid; })) continue;
+                    dilithiumKeyIndex.emplace_back(keyid, CDilithiumKeyIndexValue(pindex->nHeight, pindex->GetBlockHash(), std::move(pubkey)));
+                }
+            }
+
             for(const CTxIn& j : tx.vin){
                 if(!j.scriptSig.HasOpSpend()){
                     const CTxOut& prevout = view.AccessCoin(j.prevout).out;
@@ -4132,7 +4510,24 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     if(state.IsValid() && nFees < gasRefunds) { //make sure it won't overflow
         state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-blk-fees-greater-gasrefund", "ConnectBlock(): Less total fees than gas refund fees");
     }
-    if(state.IsValid() && !CheckReward(block, state, pindex->nHeight, params.GetConsensus(), nFees, gasRefunds, nActualStakeReward, checkVouts, nValueCoinPrev, delegateOutputExist, m_chain, m_blockman))
+
+    std::vector<CTxOut> mposAccruals;
+    if(state.IsValid() && fMPoSBalances)
+    {
+        if(fExtendsTip && !fJustCheck && !RewindMPoSBalances(pindex->pprev, m_blockman))
+        {
+            // Start over at the fork, balances left from another chain are dropped
+            if(pindex->nHeight != params.GetConsensus().nMPoSBalanceHeight)
+                return FatalError(m_chainman.GetNotifications(), state, _("The MPoS balances do not match the chain. Please restart with -reindex."));
+            if(!m_blockman.m_block_tree_db->WipeMPoSBalances())
+                return FatalError(m_chainman.GetNotifications(), state, _("Failed to write MPoS balances"));
+        }
+
+        if(!CheckMPoSClaims(mposClaims, pindex, !fExtendsTip, m_blockman, state) && state.IsError())
+            return false;
+    }
+
+    if(state.IsValid() && !CheckReward(block, state, pindex->nHeight, params.GetConsensus(), nFees, gasRefunds, nActualStakeReward, checkVouts, nValueCoinPrev, delegateOutputExist, m_chain, m_blockman, mposAccruals))
         state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "block-reward-invalid", "ConnectBlock(): Reward check failed");
 
     auto parallel_result = control.Complete();
@@ -4288,6 +4683,22 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         }
     }
 
+    if (fMPoSBalances && fExtendsTip) {
+        if (!UpdateMPoSBalances(pindex, mposClaims, mposAccruals, params.GetConsensus(), m_blockman)) {
+            return FatalError(m_chainman.GetNotifications(), state, _("Failed to write MPoS balances"));
+        }
+    }
+
+    // The index is written ahead of the chainstate: FlushStateToDisk syncs the
+    // block tree DB before the coins, so after a crash it can only hold reveals
+    // of blocks missing from the coins DB. ChainDilithiumKeys ignores those and
+    // they are overwritten when the blocks are connected again.
+    if (!dilithiumKeyIndex.empty()) {
+        if (!m_blockman.m_block_tree_db->WriteDilithiumKeyIndex(dilithiumKeyIndex)) {
+            return FatalError(m_chainman.GetNotifications(), state, _("Failed to write Dilithium key index"));
+        }
+    }
+
     ///////////////////////////////////////////////////////////// // qtum
     if (fAddressIndex) {
         if (!m_blockman.m_block_tree_db->WriteAddressIndex(addressIndex)) {
@@ -4343,6 +4754,13 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     if (fLogEvents)
         pstorageresult->commitResults();
 
+    // Placed after the fJustCheck return on purpose: a block that is only
+    // checked (TestBlockValidity) has its state rewound above and is never
+    // connected, so it must not publish changes. The recorder is not armed
+    // for it either.
+    if (g_state_diff_journal)
+        g_state_diff_journal->Add(BlockStateDiff{block_hash, pindex->nHeight, stateDiffRecorder.take()});
+
     return true;
 }
 
@@ -5525,18 +5943,17 @@ void ChainstateManager::ReceivedBlockTransactions(const CBlock& block, CBlockInd
 
 bool CheckFirstCoinstakeOutput(const CBlock& block)
 {
-    // Coinbase output should be empty if proof-of-stake block
+    // Coinbase output should be empty if proof-of-stake block, apart from the
+    // witness commitment and the heartbeat aggregate (checked contextually)
     int commitpos = GetWitnessCommitmentIndex(block);
-    if(commitpos < 0)
-    {
-        if (block.vtx[0]->vout.size() != 1 || !block.vtx[0]->vout[0].IsEmpty())
-            return false;
-    }
-    else
-    {
-        if (block.vtx[0]->vout.size() != 2 || !block.vtx[0]->vout[0].IsEmpty() || block.vtx[0]->vout[1].nValue)
-            return false;
-    }
+    int aggregatepos = trust::GetHeartbeatAggregateIndex(*block.vtx[0]);
+    size_t outputs = 1 + (commitpos >= 0) + (aggregatepos >= 0);
+    if (block.vtx[0]->vout.size() != outputs || !block.vtx[0]->vout[0].IsEmpty())
+        return false;
+    if (commitpos >= 0 && block.vtx[0]->vout[commitpos].nValue)
+        return false;
+    if (aggregatepos >= 0 && block.vtx[0]->vout[aggregatepos].nValue)
+        return false;
 
     return true;
 }
@@ -5549,9 +5966,13 @@ bool GetBlockPublicKey(const CBlock& block, std::vector<unsigned char>& vchPubKe
     if (block.vchBlockSigDlgt.empty())
         return false;
 
+    return GetStakerPublicKey(block.vtx[1]->vout[1].scriptPubKey, vchPubKey);
+}
+
+bool GetStakerPublicKey(const CScript& scriptPubKey, std::vector<unsigned char>& vchPubKey)
+{
     std::vector<valtype> vSolutions;
-    const CTxOut& txout = block.vtx[1]->vout[1];
-    TxoutType whichType = Solver(txout.scriptPubKey, vSolutions);
+    TxoutType whichType = Solver(scriptPubKey, vSolutions);
 
     if (whichType == TxoutType::NONSTANDARD)
         return false;
@@ -5566,7 +5987,7 @@ bool GetBlockPublicKey(const CBlock& block, std::vector<unsigned char>& vchPubKe
         // Block signing key also can be encoded in the nonspendable output
         // This allows to not pollute UTXO set with useless outputs e.g. in case of multisig staking
 
-        const CScript& script = txout.scriptPubKey;
+        const CScript& script = scriptPubKey;
         CScript::const_iterator pc = script.begin();
         opcodetype opcode;
         valtype vchPushValue;
@@ -6079,6 +6500,31 @@ static bool ContextualCheckBlock(const CBlock& block, BlockValidationState& stat
         return false;
     }
 
+    // WATTx: Proof-of-stake blocks may commit the heartbeats their staker
+    // observed for a recent heartbeat window
+    if (block.IsProofOfStake() && trust::GetHeartbeatAggregateIndex(*block.vtx[0]) >= 0) {
+        if (nHeight < chainman.GetConsensus().nHeartbeatAggregateHeight) {
+            return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-cb-missing", "coinbase output not empty for proof-of-stake block");
+        }
+        trust::HeartbeatAggregate aggregate;
+        std::string reason;
+        if (!trust::ReadHeartbeatAggregate(*block.vtx[0], aggregate)) {
+            return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-hb-aggregate", "malformed heartbeat aggregate");
+        }
+        if (!trust::CheckHeartbeatAggregate(aggregate, nHeight, chainman.GetConsensus(), reason)) {
+            return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-hb-aggregate", reason);
+        }
+        // Recovering the signers costs up to MAX_HEARTBEAT_AGGREGATE_SIGNATURES
+        // ECDSA recoveries, each about one signature check. The sigop budget
+        // already allows dgpMaxBlockSigOps / WITNESS_SCALE_FACTOR (20000 by
+        // default) checks per block, so this adds at most about 5%, and only
+        // for a block whose proof-of-stake and signature already passed.
+        std::vector<CKeyID> signers;
+        if (!aggregate.GetSigners(pindexPrev->GetAncestor(aggregate.windowHeight)->GetBlockHash(), signers)) {
+            return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-hb-aggregate-sig", "invalid heartbeat attestation");
+        }
+    }
+
     return true;
 }
 
@@ -6365,7 +6811,7 @@ bool ChainstateManager::ProcessNewBlockHeaders(std::span<const CBlockHeader> hea
             const CBlockHeader& header = headers[i];
 
             // If the stake has been seen and the header has not yet been seen
-            if (!m_blockman.LoadingBlocks() && !IsInitialBlockDownload() && header.IsProofOfStake() && setStakeSeen.count(std::make_pair(header.prevoutStake, header.nTime)) && !BlockIndex().count(header.GetHash())) {
+            if (!m_blockman.LoadingBlocks() && !IsInitialBlockDownload() && header.IsProofOfStake() && g_stake_seen.Contains(header.prevoutStake, header.nTime) && !BlockIndex().count(header.GetHash())) {
                 // if it is the last header of the list
                 if(i+1 == headers.size()) {
                     if(fInstantBan) {
@@ -7032,6 +7478,11 @@ bool Chainstate::ReplayBlocks()
             // overwritten. It corresponds to cases where the block-to-be-disconnect never had all its operations
             // applied to the UTXO set. However, as both writing a UTXO and deleting a UTXO are idempotent operations,
             // the result is still a version of the UTXO set with the effects of that block undone.
+            if (pindexOld->nHeight >= m_chainman.GetConsensus().nDilithiumKeyRefHeight &&
+                !EraseDilithiumKeyReveals(block, *pindexOld, *m_blockman.m_block_tree_db)) {
+                LogError("RollbackBlock(): failed to delete Dilithium key index at %d, hash=%s\n", pindexOld->nHeight, pindexOld->GetBlockHash().ToString());
+                return false;
+            }
         }
         pindexOld = pindexOld->pprev;
     }
@@ -7886,6 +8337,12 @@ util::Result<CBlockIndex*> ChainstateManager::ActivateSnapshot(
             return util::Error{Untranslated(strprintf("The base block header (%s) is part of an invalid chain", base_blockhash.ToString()))};
         }
 
+        // Blocks after the base are executed on top of its EVM state, which
+        // is not part of the snapshot
+        if (!qtum::HasEVMState(globalState->db(), globalState->dbUtxo(), snapshot_start_block->hashStateRoot, snapshot_start_block->hashUTXORoot)) {
+            return util::Error{Untranslated(strprintf("The EVM state of the base block (%s) is missing. Download it with syncevmstate, and call loadtxoutset again", base_blockhash.ToString()))};
+        }
+
         if (!m_best_header || m_best_header->GetAncestor(snapshot_start_block->nHeight) != snapshot_start_block) {
             return util::Error{Untranslated("A forked headers-chain with more work than the chain with the snapshot base block header exists. Please proceed to sync without AssumeUtxo.")};
         }
@@ -8861,4 +9318,44 @@ std::map<COutPoint, uint32_t> GetImmatureStakes(ChainstateManager& chainman)
     }
     return immatureStakes;
 }
+
+bool PruneLogEvents(ChainstateManager& chainman, unsigned int retain_blocks, uint64_t retain_bytes, int max_blocks)
+{
+    const dev::h160 delegationsAddress = uintToh160(chainman.GetConsensus().delegationsAddress);
+    for (int i = 0; i < max_blocks; i++) {
+        // Let blocks connect in between
+        LOCK(cs_main);
+        if (!fLogEvents || !pstorageresult) {
+            return false;
+        }
+        const CChain& chain = chainman.ActiveChain();
+        const int height = pstorageresult->getPrunedHeight() + 1;
+        const bool overHeight = retain_blocks > 0 && height <= chain.Height() - int(retain_blocks);
+        const bool overSize = retain_bytes > 0 && pstorageresult->getResultsSize() > retain_bytes;
+        if ((!overHeight && !overSize) || height > chain.Height() - int(MIN_BLOCKS_TO_KEEP)) {
+            return false;
+        }
+
+        std::set<uint256> kept;
+        if (!chainman.m_blockman.m_block_tree_db->PruneHeightIndex(height, delegationsAddress, kept)) {
+            LogError("%s: Failed to prune the log index at height %d\n", __func__, height);
+            return false;
+        }
+        std::set<dev::h256> keep;
+        for (const uint256& hash : kept) {
+            keep.insert(uintToh256(hash));
+        }
+
+        // Receipts committed before they were recorded by height are found
+        // through the transactions of the block, which is only read for them
+        CBlock block;
+        const CBlockIndex* pindex = chain[height];
+        if (!pstorageresult->isHeightRecorded(height) &&
+            (!(pindex->nStatus & BLOCK_HAVE_DATA) || !chainman.m_blockman.ReadBlock(block, *pindex))) {
+            block.vtx.clear();
+        }
+        pstorageresult->pruneResults(height, block.vtx, keep);
+    }
+    return true;
+}
 //////////////////////////////////////////////////////////////////////////////////
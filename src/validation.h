@@ -18,6 +18,7 @@
 #include <kernel/chainstatemanager_opts.h>
 #include <kernel/cs_main.h> // IWYU pragma: export
 #include <node/blockstorage.h>
+#include <node/stakeseen.h>
 #include <policy/feerate.h>
 #include <policy/packages.h>
 #include <policy/policy.h>
@@ -97,6 +98,10 @@ static const uint64_t ADD_DELEGATION_MIN_GAS_LIMIT = 2200000;
 
 static const bool DEFAULT_ADDRINDEX = false;
 static const bool DEFAULT_LOGEVENTS = false;
+/** -logeventsretain default, keep the receipts and log index entries of all blocks */
+static const unsigned int DEFAULT_LOGEVENTS_RETAIN = 0;
+/** -logeventsretainsize default, no size limit on the receipts */
+static const uint64_t DEFAULT_LOGEVENTS_RETAIN_SIZE = 0;
 /** Block files containing a block-height within MIN_BLOCKS_TO_KEEP of ActiveChain().Tip() will not be pruned. */
 static const unsigned int MIN_BLOCKS_TO_KEEP = 288;
 static const signed int DEFAULT_CHECKBLOCKS = 6;
@@ -140,8 +145,8 @@ extern bool fLogEvents;
 /** Documentation for argument 'checklevel'. */
 extern const std::vector<std::string> CHECKLEVEL_DOC;
 
-/** The set of all seen COutPoint entries for proof of stake. */
-extern std::set<std::pair<COutPoint, unsigned int>> setStakeSeen;
+/** The recently seen COutPoint entries for proof of stake. */
+extern node::StakeSeenCache g_stake_seen GUARDED_BY(cs_main);
 
 int64_t FutureDrift(uint32_t nTime, int nHeight, const Consensus::Params& consensusParams);
 
@@ -312,6 +317,23 @@ struct PackageMempoolAcceptResult
         : m_tx_results{ {wtxid, result} } {}
 };
 
+/**
+ * Validation results of an earlier mempool acceptance that still hold for the
+ * current chain tip, as carried over a restart in mempool.dat.
+ */
+struct MempoolRestoreWitness {
+    /** The input scripts passed verification under the current GetMempoolScriptFlags() */
+    bool scripts_verified{false};
+};
+
+/**
+ * Script verification flags applied by mempool acceptance on top of the active
+ * chain tip: the policy flags in the high 32 bits and the flags of the next
+ * block in the low 32 bits. Earlier script verification results can only be
+ * reused while these are unchanged.
+ */
+uint64_t GetMempoolScriptFlags(const Chainstate& active_chainstate) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
 /**
  * Try to add a transaction to the mempool. This is an internal function and is exposed only for testing.
  * Client code should use ChainstateManager::ProcessTransaction()
@@ -323,11 +345,14 @@ struct PackageMempoolAcceptResult
  * @param[in]  bypass_limits      When true, don't enforce mempool fee and capacity limits,
  *                                and set entry_sequence to zero.
  * @param[in]  test_accept        When true, run validation checks but don't submit to mempool.
+ * @param[in]  restore_witness    Trusted results of an earlier acceptance of tx, used to skip
+ *                                the corresponding checks when restoring a persisted mempool.
  *
  * @returns a MempoolAcceptResult indicating whether the transaction was accepted/rejected with reason.
  */
 MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTransactionRef& tx,
-                                       int64_t accept_time, bool bypass_limits, bool test_accept)
+                                       int64_t accept_time, bool bypass_limits, bool test_accept,
+                                       const MempoolRestoreWitness* restore_witness = nullptr)
     EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 /**
@@ -401,12 +426,13 @@ private:
     PrecomputedTransactionData *txdata;
     SignatureCache* m_signature_cache;
     int nOut;
+    const DilithiumKeyLookup* m_dilithium_keys;
 
 public:
-    CScriptCheck(const CTxOut& outIn, const CTransaction& txToIn, SignatureCache& signature_cache, unsigned int nInIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn) :
-        m_tx_out(outIn), ptxTo(&txToIn), nIn(nInIn), nFlags(nFlagsIn), cacheStore(cacheIn), txdata(txdataIn), m_signature_cache(&signature_cache), nOut(-1) { }
+    CScriptCheck(const CTxOut& outIn, const CTransaction& txToIn, SignatureCache& signature_cache, unsigned int nInIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn, const DilithiumKeyLookup* dilithium_keys = nullptr) :
+        m_tx_out(outIn), ptxTo(&txToIn), nIn(nInIn), nFlags(nFlagsIn), cacheStore(cacheIn), txdata(txdataIn), m_signature_cache(&signature_cache), nOut(-1), m_dilithium_keys(dilithium_keys) { }
     CScriptCheck(const CTransaction& txToIn, SignatureCache& signature_cache, int nOutIn, unsigned int nFlagsIn, bool cacheIn, PrecomputedTransactionData* txdataIn) :
-        ptxTo(&txToIn), nIn(0), nFlags(nFlagsIn), cacheStore(cacheIn), txdata(txdataIn), m_signature_cache(&signature_cache), nOut(nOutIn){ }
+        ptxTo(&txToIn), nIn(0), nFlags(nFlagsIn), cacheStore(cacheIn), txdata(txdataIn), m_signature_cache(&signature_cache), nOut(nOutIn), m_dilithium_keys(nullptr) { }
 
     CScriptCheck(const CScriptCheck&) = delete;
     CScriptCheck& operator=(const CScriptCheck&) = delete;
@@ -423,6 +449,26 @@ static_assert(std::is_nothrow_move_assignable_v<CScriptCheck>);
 static_assert(std::is_nothrow_move_constructible_v<CScriptCheck>);
 static_assert(std::is_nothrow_destructible_v<CScriptCheck>);
 
+/**
+ * Dilithium public keys revealed by blocks of the chain ending at tip.
+ *
+ * The revealed-key index can hold entries of blocks that are not part of the
+ * chain (after a crash between the block tree and chainstate flushes, or
+ * after a rollback), so entries only resolve while the block recorded with
+ * them is an ancestor of tip. The index and tip must outlive the lookup.
+ */
+class ChainDilithiumKeys : public DilithiumKeyLookup
+{
+private:
+    const kernel::BlockTreeDB& m_db;
+    const CBlockIndex* m_tip;
+
+public:
+    ChainDilithiumKeys(const kernel::BlockTreeDB& db, const CBlockIndex* tip) : m_db(db), m_tip(tip) { }
+
+    bool GetDilithiumPubKey(const uint160& keyid, std::vector<unsigned char>& pubkey) const override;
+};
+
 /**
  * Convenience class for initializing and passing the script execution cache
  * and signature cache.
@@ -461,6 +507,17 @@ bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, const
 bool GetAddressWeight(uint256 addressHash, int type, const std::map<COutPoint, uint32_t>& immatureStakes, int32_t nHeight, uint64_t& nWeight, node::BlockManager& blockman);
 
 std::map<COutPoint, uint32_t> GetImmatureStakes(ChainstateManager& chainman);
+
+/**
+ * Prune the receipts and log index entries of the oldest blocks, in height
+ * order, until those of the last retain_blocks blocks are left and the
+ * receipts take at most retain_bytes (0 = no limit for either). The last
+ * MIN_BLOCKS_TO_KEEP blocks are never pruned, and neither are the entries of
+ * the delegation contract, which super stakers search from the first block.
+ *
+ * @return whether max_blocks were pruned and there may be more to prune
+ */
+bool PruneLogEvents(ChainstateManager& chainman, unsigned int retain_blocks, uint64_t retain_bytes, int max_blocks);
 /////////////////////////////////////////////////////////////////
 
 bool CheckIndexProof(const CBlockIndex& block, const Consensus::Params& consensusParams);
@@ -471,6 +528,7 @@ bool CheckIndexProof(const CBlockIndex& block, const Consensus::Params& consensu
 bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensus::Params& consensusParams, Chainstate& chainstate, bool fCheckPOW = true, bool fCheckMerkleRoot = true, bool fCheckSig=true);
 bool CheckFirstCoinstakeOutput(const CBlock& block);
 bool GetBlockPublicKey(const CBlock& block, std::vector<unsigned char>& vchPubKey);
+bool GetStakerPublicKey(const CScript& scriptPubKey, std::vector<unsigned char>& vchPubKey);
 bool GetBlockDelegation(const CBlock& block, const uint160& staker, uint160& address, uint8_t& fee, CCoinsViewCache& view, Chainstate& chainstate);
 bool CheckCanonicalBlockSignature(const CBlockHeader* pblock);
 
@@ -517,7 +575,7 @@ public:
         int nCheckDepth) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 };
 
-bool CheckReward(const CBlock& block, BlockValidationState& state, int nHeight, const Consensus::Params& consensusParams, CAmount nFees, CAmount gasRefunds, CAmount nActualStakeReward, const std::vector<CTxOut>& vouts, CAmount nValueCoinPrev, bool delegateOutputExist, CChain& chain, node::BlockManager& blockman);
+bool CheckReward(const CBlock& block, BlockValidationState& state, int nHeight, const Consensus::Params& consensusParams, CAmount nFees, CAmount gasRefunds, CAmount nActualStakeReward, const std::vector<CTxOut>& vouts, CAmount nValueCoinPrev, bool delegateOutputExist, CChain& chain, node::BlockManager& blockman, std::vector<CTxOut>& mposAccruals);
 
 //////////////////////////////////////////////////////// qtum
 bool GetSpentCoinFromBlock(const CBlockIndex* pindex, COutPoint prevout, Coin* coin, Chainstate& chainstate);
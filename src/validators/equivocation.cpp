@@ -0,0 +1,170 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <validators/equivocation.h>
+#include <hash.h>
+
+#include <algorithm>
+
+namespace validators {
+
+bool GetHeaderSigner(const CBlockHeader& header, CKeyID& signer) {
+    if (!header.IsProofOfStake()) {
+        return false;
+    }
+    std::vector<unsigned char> vchBlockSig = header.GetBlockSignature();
+    if (vchBlockSig.size() != CPubKey::COMPACT_SIGNATURE_SIZE) {
+        return false;
+    }
+    CPubKey pubkey;
+    if (!pubkey.RecoverCompact(header.GetHashWithoutSign(), vchBlockSig)) {
+        return false;
+    }
+    signer = pubkey.GetID();
+    return true;
+}
+
+// EquivocationEvidence implementation
+
+EquivocationEvidence::EquivocationEvidence(const CBlockHeader& a, const CBlockHeader& b) {
+    // Canonical order, so both detecting nodes produce the same evidence
+    if (a.GetHash() < b.GetHash()) {
+        first = a;
+        second = b;
+    } else {
+        first = b;
+        second = a;
+    }
+}
+
+uint256 EquivocationEvidence::GetHash() const {
+    uint256 a = first.GetHash();
+    uint256 b = second.GetHash();
+    if (b < a) std::swap(a, b);
+    HashWriter ss{};
+    ss << a << b;
+    return ss.GetHash();
+}
+
+bool EquivocationEvidence::Verify(CKeyID& offender, std::string& reason) const {
+    if (!first.IsProofOfStake() || !second.IsProofOfStake()) {
+        reason = "not-proof-of-stake";
+        return false;
+    }
+    // The signature does not cover every header field, so compare what was
+    // signed rather than the block hashes
+    if (first.GetHashWithoutSign() == second.GetHashWithoutSign()) {
+        reason = "same-signed-header";
+        return false;
+    }
+    if (first.nTime != second.nTime) {
+        reason = "different-slot";
+        return false;
+    }
+    if (first.hashPrevBlock != second.hashPrevBlock && first.prevoutStake != second.prevoutStake) {
+        reason = "no-conflict";
+        return false;
+    }
+    CKeyID signerFirst, signerSecond;
+    if (!GetHeaderSigner(first, signerFirst) || !GetHeaderSigner(second, signerSecond)) {
+        reason = "bad-signature";
+        return false;
+    }
+    if (signerFirst != signerSecond) {
+        reason = "different-signers";
+        return false;
+    }
+    offender = signerFirst;
+    return true;
+}
+
+// EquivocationDetector implementation
+
+EquivocationDetector::EquivocationDetector(int64_t window, size_t max_headers)
+    : m_window(window), m_max_headers(max_headers) {}
+
+void EquivocationDetector::Expire(int64_t now) {
+    while (!m_order.empty()) {
+        const auto& [slot, stake] = m_order.front();
+        if (m_order.size() <= m_max_headers && int64_t{std::get<2>(slot)} + m_window >= now) {
+            break;
+        }
+        auto itSlot = m_by_slot.find(slot);
+        auto itStake = m_by_stake.find(stake);
+        // The stake entry may belong to another staker's header for the same slot
+        if (itSlot != m_by_slot.end() && itStake != m_by_stake.end() &&
+            itStake->second.GetHashWithoutSign() == itSlot->second.GetHashWithoutSign()) {
+            m_by_stake.erase(itStake);
+        }
+        if (itSlot != m_by_slot.end()) {
+            m_by_slot.erase(itSlot);
+        }
+        m_order.pop_front();
+    }
+}
+
+std::optional<EquivocationEvidence> EquivocationDetector::AddHeader(const CBlockHeader& header, int64_t now) {
+    if (!header.IsProofOfStake() || int64_t{header.nTime} + m_window < now) {
+        return std::nullopt;
+    }
+    CKeyID signer;
+    if (!GetHeaderSigner(header, signer)) {
+        return std::nullopt;
+    }
+
+    LOCK(cs_detector);
+    Expire(now);
+
+    const uint256 signedHash = header.GetHashWithoutSign();
+    SlotKey slot{signer, header.hashPrevBlock, header.nTime};
+    StakeKey stake{header.prevoutStake, header.nTime};
+
+    // Signed two different headers on the same parent and slot
+    auto itSlot = m_by_slot.find(slot);
+    if (itSlot != m_by_slot.end()) {
+        if (itSlot->second.GetHashWithoutSign() != signedHash) {
+            return EquivocationEvidence(itSlot->second, header);
+        }
+        return std::nullopt;
+    }
+
+    // Reused the stake for the same slot on a competing tip
+    auto itStake = m_by_stake.find(stake);
+    if (itStake != m_by_stake.end() && itStake->second.GetHashWithoutSign() != signedHash) {
+        CKeyID otherSigner;
+        if (GetHeaderSigner(itStake->second, otherSigner) && otherSigner == signer) {
+            return EquivocationEvidence(itStake->second, header);
+        }
+    }
+
+    m_by_slot.emplace(slot, header);
+    m_by_stake.emplace(stake, header);
+    m_order.emplace_back(slot, stake);
+    return std::nullopt;
+}
+
+bool EquivocationDetector::AddEvidence(const uint256& hash) {
+    LOCK(cs_detector);
+    if (!m_known_evidence.insert(hash).second) {
+        return false;
+    }
+    m_known_order.push_back(hash);
+    if (m_known_order.size() > MAX_KNOWN_EVIDENCE) {
+        m_known_evidence.erase(m_known_order.front());
+        m_known_order.pop_front();
+    }
+    return true;
+}
+
+bool EquivocationDetector::HaveEvidence(const uint256& hash) const {
+    LOCK(cs_detector);
+    return m_known_evidence.count(hash) > 0;
+}
+
+size_t EquivocationDetector::Size() const {
+    LOCK(cs_detector);
+    return m_order.size();
+}
+
+} // namespace validators
@@ -0,0 +1,120 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef WATTX_VALIDATORS_EQUIVOCATION_H
+#define WATTX_VALIDATORS_EQUIVOCATION_H
+
+#include <primitives/block.h>
+#include <pubkey.h>
+#include <serialize.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace validators {
+
+/**
+ * Recover the key that signed a proof-of-stake header (the staker, or the
+ * delegate for offline staking). Only compact signatures are supported.
+ */
+bool GetHeaderSigner(const CBlockHeader& header, CKeyID& signer);
+
+/**
+ * Proof that a staker signed two conflicting proof-of-stake headers for the
+ * same slot (block time): either on the same parent, or using the same
+ * prevoutStake on competing tips. Self-contained, so it can be verified
+ * without knowing either block.
+ */
+class EquivocationEvidence {
+public:
+    CBlockHeader first;
+    CBlockHeader second;
+
+    EquivocationEvidence() = default;
+    EquivocationEvidence(const CBlockHeader& a, const CBlockHeader& b);
+
+    SERIALIZE_METHODS(EquivocationEvidence, obj) {
+        READWRITE(obj.first, obj.second);
+    }
+
+    /**
+     * Get the hash identifying this evidence. It does not depend on the order
+     * of the headers.
+     */
+    uint256 GetHash() const;
+
+    /**
+     * Check that the headers conflict and are signed by the same key
+     * Returns the offending key in offender, or the failure in reason
+     */
+    bool Verify(CKeyID& offender, std::string& reason) const;
+};
+
+/**
+ * Index of recently seen signed proof-of-stake headers, keyed by staker and
+ * slot, to detect equivocation as headers and blocks arrive.
+ */
+class EquivocationDetector {
+private:
+    using SlotKey = std::tuple<CKeyID, uint256, uint32_t>;     // signer, parent, time
+    using StakeKey = std::pair<COutPoint, uint32_t>;            // prevoutStake, time
+
+    mutable Mutex cs_detector;
+    std::map<SlotKey, CBlockHeader> m_by_slot GUARDED_BY(cs_detector);
+    std::map<StakeKey, CBlockHeader> m_by_stake GUARDED_BY(cs_detector);
+    // Insertion order, for expiry
+    std::deque<std::pair<SlotKey, StakeKey>> m_order GUARDED_BY(cs_detector);
+    // Evidence already acted upon
+    std::set<uint256> m_known_evidence GUARDED_BY(cs_detector);
+    std::deque<uint256> m_known_order GUARDED_BY(cs_detector);
+
+    const int64_t m_window;
+    const size_t m_max_headers;
+
+    void Expire(int64_t now) EXCLUSIVE_LOCKS_REQUIRED(cs_detector);
+
+public:
+    explicit EquivocationDetector(int64_t window = DEFAULT_WINDOW, size_t max_headers = DEFAULT_MAX_HEADERS);
+
+    /**
+     * Record a header seen on the network
+     * Returns evidence if it conflicts with a header recorded earlier. Headers
+     * that are not proof-of-stake, not signed, or older than the window
+     * relative to now are ignored.
+     */
+    std::optional<EquivocationEvidence> AddHeader(const CBlockHeader& header, int64_t now);
+
+    /**
+     * Remember evidence so that it is acted upon and relayed only once
+     * Returns false if it was already known
+     */
+    bool AddEvidence(const uint256& hash);
+
+    /**
+     * Check if evidence is already known
+     */
+    bool HaveEvidence(const uint256& hash) const;
+
+    /**
+     * Get the number of tracked headers
+     */
+    size_t Size() const;
+
+    // Seconds a header stays indexed, and the cap on indexed headers
+    static constexpr int64_t DEFAULT_WINDOW = 2 * 60 * 60;
+    static constexpr size_t DEFAULT_MAX_HEADERS = 20000;
+    static constexpr size_t MAX_KNOWN_EVIDENCE = 1000;
+};
+
+} // namespace validators
+
+#endif // WATTX_VALIDATORS_EQUIVOCATION_H
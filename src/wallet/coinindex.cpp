@@ -0,0 +1,49 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/coinindex.h>
+
+#include <bit>
+#include <cstdint>
+
+namespace wallet {
+size_t SpendableCoinIndex::Bucket(CAmount value)
+{
+    if (value <= 0) return 0;
+    return std::bit_width(uint64_t(value)) - 1;
+}
+
+void SpendableCoinIndex::Add(const COutPoint& outpoint, const Entry& entry)
+{
+    auto [it, inserted]{m_entries.try_emplace(outpoint, entry)};
+    if (!inserted) {
+        if (it->second.value != entry.value) {
+            m_buckets[Bucket(it->second.value)].erase(outpoint);
+            inserted = true;
+        }
+        it->second = entry;
+    }
+    if (inserted) m_buckets[Bucket(entry.value)].insert(outpoint);
+}
+
+void SpendableCoinIndex::Remove(const COutPoint& outpoint)
+{
+    const auto it{m_entries.find(outpoint)};
+    if (it == m_entries.end()) return;
+    m_buckets[Bucket(it->second.value)].erase(outpoint);
+    m_entries.erase(it);
+}
+
+void SpendableCoinIndex::Clear()
+{
+    m_entries.clear();
+    for (auto& bucket : m_buckets) bucket.clear();
+}
+
+const SpendableCoinIndex::Entry* SpendableCoinIndex::Find(const COutPoint& outpoint) const
+{
+    const auto it{m_entries.find(outpoint)};
+    return it == m_entries.end() ? nullptr : &it->second;
+}
+} // namespace wallet
@@ -0,0 +1,74 @@
+// Copyright (c) 2025 The WATTx Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_WALLET_COININDEX_H
+#define BITCOIN_WALLET_COININDEX_H
+
+#include <consensus/amount.h>
+#include <primitives/transaction.h>
+#include <util/hasher.h>
+#include <wallet/types.h>
+
+#include <array>
+#include <cstddef>
+#include <set>
+#include <unordered_map>
+
+namespace wallet {
+class CWalletTx;
+
+/**
+ * The outputs of wallet transactions that the wallet owns or watches and that no wallet
+ * transaction spends, bucketed by value.
+ *
+ * The wallet keeps it up to date as transactions are added, change state or are removed, so
+ * coin selection and listunspent go through the unspent outputs only instead of every output
+ * of every wallet transaction. What changes with the chain (depth, trust, maturity) and what
+ * the caller filters on (locks, used addresses) is still checked for each coin.
+ */
+class SpendableCoinIndex
+{
+public:
+    struct Entry {
+        const CWalletTx* wtx;
+        CAmount value;
+        isminetype mine;
+    };
+
+    //! Outputs are bucketed by the number of significant bits of their value
+    static constexpr size_t NUM_BUCKETS{64};
+
+    void Add(const COutPoint& outpoint, const Entry& entry);
+    void Remove(const COutPoint& outpoint);
+    void Clear();
+
+    size_t Size() const { return m_entries.size(); }
+    const Entry* Find(const COutPoint& outpoint) const;
+
+    /**
+     * Call fn(outpoint, entry) for the outputs with a value in [min_value, max_value], the
+     * lowest value buckets first, until it returns false.
+     */
+    template <typename Fn>
+    void ForEach(CAmount min_value, CAmount max_value, Fn&& fn) const
+    {
+        if (min_value > max_value) return;
+        for (size_t bucket = Bucket(min_value); bucket <= Bucket(max_value); ++bucket) {
+            for (const COutPoint& outpoint : m_buckets[bucket]) {
+                const Entry& entry{m_entries.at(outpoint)};
+                if (entry.value < min_value || entry.value > max_value) continue;
+                if (!fn(outpoint, entry)) return;
+            }
+        }
+    }
+
+    static size_t Bucket(CAmount value);
+
+private:
+    std::unordered_map<COutPoint, Entry, SaltedOutpointHasher> m_entries;
+    std::array<std::set<COutPoint>, NUM_BUCKETS> m_buckets;
+};
+} // namespace wallet
+
+#endif // BITCOIN_WALLET_COININDEX_H
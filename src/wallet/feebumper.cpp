@@ -8,6 +8,7 @@
 #include <node/types.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
+#include <script/solver.h>
 #include <util/moneystr.h>
 #include <util/rbf.h>
 #include <util/translation.h>
@@ -63,6 +64,39 @@ static feebumper::Result PreconditionChecks(const CWallet& wallet, const CWallet
     return feebumper::Result::OK;
 }
 
+//! Raise the gas price of the contract outputs of a transaction being bumped,
+//! so that the replacement also pays more for its execution than the original
+static feebumper::Result BumpGasPrice(const CWallet& wallet, std::vector<CTxOut>& txouts, const std::optional<CAmount>& gas_price, CAmount& old_gas_fee, CAmount& new_gas_fee, std::vector<bilingual_str>& errors)
+{
+    const uint64_t min_gas_price{wallet.chain().getMinGasPrice()};
+    old_gas_fee = 0;
+    new_gas_fee = 0;
+    for (CTxOut& output : txouts) {
+        uint64_t gas_limit, old_gas_price;
+        if (!ExtractContractGas(output.scriptPubKey, gas_limit, old_gas_price)) continue;
+
+        uint64_t new_gas_price{std::max<uint64_t>(old_gas_price + std::max<uint64_t>(1, old_gas_price / 10), min_gas_price)};
+        if (gas_price) {
+            if (*gas_price <= 0 || uint64_t(*gas_price) <= old_gas_price) {
+                errors.push_back(Untranslated(strprintf("Insufficient gas price: %s must be higher than the gas price of the original transaction %s", FormatMoney(*gas_price), FormatMoney(old_gas_price))));
+                return feebumper::Result::INVALID_PARAMETER;
+            }
+            if (uint64_t(*gas_price) < min_gas_price) {
+                errors.push_back(Untranslated(strprintf("Insufficient gas price: %s is below the minimum gas price %s", FormatMoney(*gas_price), FormatMoney(min_gas_price))));
+                return feebumper::Result::INVALID_PARAMETER;
+            }
+            new_gas_price = *gas_price;
+        }
+        if (!SetContractGasPrice(output.scriptPubKey, new_gas_price)) {
+            errors.push_back(Untranslated("Unable to change the gas price of the contract output"));
+            return feebumper::Result::MISC_ERROR;
+        }
+        old_gas_fee += gas_limit * old_gas_price;
+        new_gas_fee += gas_limit * new_gas_price;
+    }
+    return feebumper::Result::OK;
+}
+
 //! Check if the user provided a valid feeRate
 static feebumper::Result CheckFeeRate(const CWallet& wallet, const CMutableTransaction& mtx, const CFeeRate& newFeerate, const int64_t maxTxSize, CAmount old_fee, std::vector<bilingual_str>& errors)
 {
@@ -163,7 +197,8 @@ bool TransactionCanBeBumped(const CWallet& wallet, const uint256& txid)
 }
 
 Result CreateRateBumpTransaction(CWallet& wallet, const uint256& txid, const CCoinControl& coin_control, std::vector<bilingual_str>& errors,
-                                 CAmount& old_fee, CAmount& new_fee, CMutableTransaction& mtx, bool require_mine, const std::vector<CTxOut>& outputs, std::optional<uint32_t> original_change_index)
+                                 CAmount& old_fee, CAmount& new_fee, CMutableTransaction& mtx, bool require_mine, const std::vector<CTxOut>& outputs, std::optional<uint32_t> original_change_index,
+                                 std::optional<CAmount> gas_price)
 {
     // For now, cannot specify both new outputs to use and an output index to send change
     if (!outputs.empty() && original_change_index.has_value()) {
@@ -249,12 +284,31 @@ Result CreateRateBumpTransaction(CWallet& wallet, const uint256& txid, const CCo
 
     old_fee = input_value - output_value;
 
+    // The gas of contract outputs is paid on top of the fee for the size of
+    // the transaction, and the feerates below only cover the latter
+    std::vector<CTxOut> txouts = outputs.empty() ? wtx.tx->vout : outputs;
+    const bool has_contract{wtx.tx->HasCreateOrCall()};
+    CAmount old_gas_fee = 0;
+    CAmount new_gas_fee = 0;
+    if (has_contract) {
+        if (!outputs.empty()) {
+            errors.emplace_back(Untranslated("Cannot replace the outputs of a contract transaction"));
+            return Result::INVALID_PARAMETER;
+        }
+        Result res = BumpGasPrice(wallet, txouts, gas_price, old_gas_fee, new_gas_fee, errors);
+        if (res != Result::OK) {
+            return res;
+        }
+    } else if (gas_price) {
+        errors.emplace_back(Untranslated("The option 'gas_price' is only for transactions with contract outputs"));
+        return Result::INVALID_PARAMETER;
+    }
+
     // Fill in recipients (and preserve a single change key if there
     // is one). If outputs vector is non-empty, replace original
     // outputs with its contents, otherwise use original outputs.
     std::vector<CRecipient> recipients;
     CAmount new_outputs_value = 0;
-    const auto& txouts = outputs.empty() ? wtx.tx->vout : outputs;
     for (size_t i = 0; i < txouts.size(); ++i) {
         const CTxOut& output = txouts.at(i);
         CTxDestination dest;
@@ -293,13 +347,13 @@ Result CreateRateBumpTransaction(CWallet& wallet, const uint256& txid, const CCo
         }
         temp_mtx.vout = txouts;
         const int64_t maxTxSize{CalculateMaximumSignedTxSize(CTransaction(temp_mtx), &wallet, &new_coin_control).vsize};
-        Result res = CheckFeeRate(wallet, temp_mtx, *new_coin_control.m_feerate, maxTxSize, old_fee, errors);
+        Result res = CheckFeeRate(wallet, temp_mtx, *new_coin_control.m_feerate, maxTxSize, old_fee - old_gas_fee, errors);
         if (res != Result::OK) {
             return res;
         }
     } else {
         // The user did not provide a feeRate argument
-        new_coin_control.m_feerate = EstimateFeeRate(wallet, wtx, old_fee, new_coin_control);
+        new_coin_control.m_feerate = EstimateFeeRate(wallet, wtx, old_fee - old_gas_fee, new_coin_control);
     }
 
     // Fill in required inputs we are double-spending(all of them)
@@ -317,7 +371,8 @@ Result CreateRateBumpTransaction(CWallet& wallet, const uint256& txid, const CCo
     // We cannot source new unconfirmed inputs(bip125 rule 2)
     new_coin_control.m_min_depth = 1;
 
-    auto res = CreateTransaction(wallet, recipients, /*change_pos=*/std::nullopt, new_coin_control, false);
+    // The first input of a contract transaction stays first, it is the sender
+    auto res = CreateTransaction(wallet, recipients, /*change_pos=*/std::nullopt, new_coin_control, false, new_gas_fee, /*hasSender=*/has_contract);
     if (!res) {
         errors.emplace_back(Untranslated("Unable to create transaction.") + Untranslated(" ") + util::ErrorString(res));
         return Result::WALLET_ERROR;
@@ -349,6 +404,11 @@ bool SignTransaction(CWallet& wallet, CMutableTransaction& mtx) {
         complete = FinalizeAndExtractPSBT(psbtx, mtx);
         return complete;
     } else {
+        // Contract outputs with OP_SENDER are signed before the inputs, as
+        // the input signatures commit to them
+        if (mtx.HasOpSender() && !wallet.SignTransactionOutput(mtx)) {
+            return false;
+        }
         return wallet.SignTransaction(mtx);
     }
 }
@@ -45,6 +45,7 @@ bool TransactionCanBeBumped(const CWallet& wallet, const uint256& txid);
  * @param[in] require_mine Whether the original transaction must consist of inputs that can be spent by the wallet
  * @param[in] outputs Vector of new outputs to replace the bumped transaction's outputs
  * @param[in] original_change_index The position of the change output to deduct the fee from in the transaction being bumped
+ * @param[in] gas_price The new gas price of the contract outputs, raised by a tenth (at least to the minimum gas price) when not set
  */
 Result CreateRateBumpTransaction(CWallet& wallet,
     const uint256& txid,
@@ -55,7 +56,8 @@ Result CreateRateBumpTransaction(CWallet& wallet,
     CMutableTransaction& mtx,
     bool require_mine,
     const std::vector<CTxOut>& outputs,
-    std::optional<uint32_t> original_change_index = std::nullopt);
+    std::optional<uint32_t> original_change_index = std::nullopt,
+    std::optional<CAmount> gas_price = std::nullopt);
 
 //! Sign the new transaction,
 //! @return false if the tx couldn't be found or if it was
@@ -1092,6 +1092,8 @@ static RPCHelpMan bumpfee_helper(std::string method_name)
                                                                                                                             "The remainder after paying the recipients and fees will be sent to the output script of the "
                                                                                                                             "original change output. The change output’s amount can increase if bumping the transaction "
                                                                                                                             "adds new inputs, otherwise it will decrease. Cannot be used in combination with the 'outputs' option."},
+                    {"gas_price", RPCArg::Type::AMOUNT, RPCArg::DefaultHint{"a tenth more than the original, at least the minimum gas price"}, "The new gas price of the contract outputs, in " + CURRENCY_UNIT + " per gas unit.\n"
+                             "Must be higher than the gas price of the original transaction."},
                 },
                 RPCArgOptions{.oneline_description="options"}},
         },
@@ -1131,6 +1133,7 @@ static RPCHelpMan bumpfee_helper(std::string method_name)
     std::vector<CTxOut> outputs;
 
     std::optional<uint32_t> original_change_index;
+    std::optional<CAmount> gas_price;
 
     if (!request.params[1].isNull()) {
         UniValue options = request.params[1];
@@ -1143,6 +1146,7 @@ static RPCHelpMan bumpfee_helper(std::string method_name)
                 {"estimate_mode", UniValueType(UniValue::VSTR)},
                 {"outputs", UniValueType()}, // will be checked by AddOutputs()
                 {"original_change_index", UniValueType(UniValue::VNUM)},
+                {"gas_price", UniValueType()}, // will be checked by AmountFromValue()
             },
             true, true);
 
@@ -1170,6 +1174,10 @@ static RPCHelpMan bumpfee_helper(std::string method_name)
         if (options.exists("original_change_index")) {
             original_change_index = options["original_change_index"].getInt<uint32_t>();
         }
+
+        if (options.exists("gas_price")) {
+            gas_price = AmountFromValue(options["gas_price"]);
+        }
     }
 
     // Make sure the results are valid at least up to the most recent block
@@ -1187,7 +1195,7 @@ static RPCHelpMan bumpfee_helper(std::string method_name)
     CMutableTransaction mtx;
     feebumper::Result res;
     // Targeting feerate bump.
-    res = feebumper::CreateRateBumpTransaction(*pwallet, hash, coin_control, errors, old_fee, new_fee, mtx, /*require_mine=*/ !want_psbt, outputs, original_change_index);
+    res = feebumper::CreateRateBumpTransaction(*pwallet, hash, coin_control, errors, old_fee, new_fee, mtx, /*require_mine=*/ !want_psbt, outputs, original_change_index, gas_price);
     if (res != feebumper::Result::OK) {
         switch(res) {
             case feebumper::Result::INVALID_ADDRESS_OR_KEY:
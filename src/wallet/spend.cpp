@@ -22,6 +22,7 @@
 #include <util/trace.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
+#include <wallet/coinindex.h>
 #include <wallet/fees.h>
 #include <wallet/receive.h>
 #include <wallet/spend.h>
@@ -29,6 +30,7 @@
 #include <wallet/wallet.h>
 
 #include <cmath>
+#include <unordered_map>
 
 using common::StringForFeeReason;
 using common::TransactionErrorString;
@@ -327,24 +329,34 @@ CoinsResult AvailableCoins(const CWallet& wallet,
     const bool only_safe = {coinControl ? !coinControl->m_include_unsafe_inputs : true};
     const bool can_grind_r = wallet.CanGrindR();
     std::vector<COutPoint> outpoints;
+    bool reached_limit{false};
 
     std::set<uint256> trusted_parents;
-    for (const auto& entry : wallet.mapWallet)
-    {
-        const uint256& txid = entry.first;
-        const CWalletTx& wtx = entry.second;
+    // Whether the outputs of a transaction can be used and how, worked out for
+    // the first of its outputs in the index
+    struct TxInfo {
+        bool usable;
+        int depth;
+        bool safe;
+        bool from_me;
+    };
+    std::unordered_map<const CWalletTx*, TxInfo> tx_infos;
+    auto get_tx_info = [&](const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(wallet.cs_wallet) -> const TxInfo& {
+        auto [it, inserted]{tx_infos.try_emplace(&wtx, TxInfo{false, 0, false, false})};
+        if (!inserted) return it->second;
+        TxInfo& info{it->second};
 
         if (wallet.IsTxImmature(wtx) && !params.include_immature_coinbase)
-            continue;
+            return info;
 
         int nDepth = wallet.GetTxDepthInMainChain(wtx);
         if (nDepth < 0)
-            continue;
+            return info;
 
         // We should not consider coins which aren't at least in our mempool
         // It's possible for these to be conflicted via ancestors which we may never be able to detect
         if (nDepth == 0 && !wtx.InMempool())
-            continue;
+            return info;
 
         bool safeTx = CachedTxIsTrusted(wallet, wtx, trusted_parents);
 
@@ -380,87 +392,89 @@ CoinsResult AvailableCoins(const CWallet& wallet,
         }
 
         if (only_safe && !safeTx) {
-            continue;
+            return info;
         }
 
         if (nDepth < min_depth || nDepth > max_depth) {
-            continue;
+            return info;
         }
 
-        bool tx_from_me = CachedTxIsFromMe(wallet, wtx, ISMINE_ALL);
-
-        for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
-            const CTxOut& output = wtx.tx->vout[i];
-            const COutPoint outpoint(Txid::FromUint256(txid), i);
-
-            if (output.nValue < params.min_amount || output.nValue > params.max_amount)
-                continue;
-
-            // Skip manually selected coins (the caller can fetch them directly)
-            if (coinControl && coinControl->HasSelected() && coinControl->IsSelected(outpoint))
-                continue;
+        info = TxInfo{true, nDepth, safeTx, CachedTxIsFromMe(wallet, wtx, ISMINE_ALL)};
+        return info;
+    };
 
-            if (wallet.IsLockedCoin(outpoint) && params.skip_locked)
-                continue;
+    // Only the unspent outputs the wallet owns are looked at, in the index
+    // the wallet keeps of them, instead of every output of every transaction
+    wallet.GetSpendableCoins().ForEach(params.min_amount, params.max_amount, [&](const COutPoint& outpoint, const SpendableCoinIndex::Entry& entry) {
+        AssertLockHeld(wallet.cs_wallet);
+        const CWalletTx& wtx = *entry.wtx;
+        const CTxOut& output = wtx.tx->vout[outpoint.n];
+        const isminetype mine = entry.mine;
 
-            if (wallet.IsSpent(outpoint))
-                continue;
+        // Skip manually selected coins (the caller can fetch them directly)
+        if (coinControl && coinControl->HasSelected() && coinControl->IsSelected(outpoint))
+            return true;
 
-            isminetype mine = wallet.IsMine(output);
+        if (wallet.IsLockedCoin(outpoint) && params.skip_locked)
+            return true;
 
-            if (mine == ISMINE_NO) {
-                continue;
-            }
+        const TxInfo& tx_info = get_tx_info(wtx);
+        if (!tx_info.usable)
+            return true;
 
-            if (!allow_used_addresses && wallet.IsSpentKey(output.scriptPubKey)) {
-                continue;
-            }
+        if (!allow_used_addresses && wallet.IsSpentKey(output.scriptPubKey)) {
+            return true;
+        }
 
-            std::unique_ptr<SigningProvider> provider = wallet.GetSolvingProvider(output.scriptPubKey);
-
-            int input_bytes = CalculateMaximumSignedInputSize(output, COutPoint(), provider.get(), can_grind_r, coinControl);
-            // Because CalculateMaximumSignedInputSize infers a solvable descriptor to get the satisfaction size,
-            // it is safe to assume that this input is solvable if input_bytes is greater than -1.
-            bool solvable = input_bytes > -1;
-            bool spendable = ((mine & ISMINE_SPENDABLE) != ISMINE_NO) || (((mine & ISMINE_WATCH_ONLY) != ISMINE_NO) && (coinControl && coinControl->fAllowWatchOnly && solvable));
-
-            // Filter by spendable outputs only
-            if (!spendable && params.only_spendable) continue;
-
-            // Obtain script type
-            std::vector<std::vector<uint8_t>> script_solutions;
-            TxoutType type = Solver(output.scriptPubKey, script_solutions);
-
-            // If the output is P2SH and solvable, we want to know if it is
-            // a P2SH (legacy) or one of P2SH-P2WPKH, P2SH-P2WSH (P2SH-Segwit). We can determine
-            // this from the redeemScript. If the output is not solvable, it will be classified
-            // as a P2SH (legacy), since we have no way of knowing otherwise without the redeemScript
-            bool is_from_p2sh{false};
-            if (type == TxoutType::SCRIPTHASH && solvable) {
-                CScript script;
-                if (!provider->GetCScript(CScriptID(uint160(script_solutions[0])), script)) continue;
-                type = Solver(script, script_solutions);
-                is_from_p2sh = true;
-            }
+        std::unique_ptr<SigningProvider> provider = wallet.GetSolvingProvider(output.scriptPubKey);
+
+        int input_bytes = CalculateMaximumSignedInputSize(output, COutPoint(), provider.get(), can_grind_r, coinControl);
+        // Because CalculateMaximumSignedInputSize infers a solvable descriptor to get the satisfaction size,
+        // it is safe to assume that this input is solvable if input_bytes is greater than -1.
+        bool solvable = input_bytes > -1;
+        bool spendable = ((mine & ISMINE_SPENDABLE) != ISMINE_NO) || (((mine & ISMINE_WATCH_ONLY) != ISMINE_NO) && (coinControl && coinControl->fAllowWatchOnly && solvable));
+
+        // Filter by spendable outputs only
+        if (!spendable && params.only_spendable) return true;
+
+        // Obtain script type
+        std::vector<std::vector<uint8_t>> script_solutions;
+        TxoutType type = Solver(output.scriptPubKey, script_solutions);
+
+        // If the output is P2SH and solvable, we want to know if it is
+        // a P2SH (legacy) or one of P2SH-P2WPKH, P2SH-P2WSH (P2SH-Segwit). We can determine
+        // this from the redeemScript. If the output is not solvable, it will be classified
+        // as a P2SH (legacy), since we have no way of knowing otherwise without the redeemScript
+        bool is_from_p2sh{false};
+        if (type == TxoutType::SCRIPTHASH && solvable) {
+            CScript script;
+            if (!provider->GetCScript(CScriptID(uint160(script_solutions[0])), script)) return true;
+            type = Solver(script, script_solutions);
+            is_from_p2sh = true;
+        }
 
-            result.Add(GetOutputType(type, is_from_p2sh),
-                       COutput(outpoint, output, nDepth, input_bytes, spendable, solvable, safeTx, wtx.GetTxTime(), tx_from_me, feerate));
+        result.Add(GetOutputType(type, is_from_p2sh),
+                   COutput(outpoint, output, tx_info.depth, input_bytes, spendable, solvable, tx_info.safe, wtx.GetTxTime(), tx_info.from_me, feerate));
 
-            outpoints.push_back(outpoint);
+        outpoints.push_back(outpoint);
 
-            // Checks the sum amount of all UTXO's.
-            if (params.min_sum_amount != MAX_MONEY) {
-                if (result.GetTotalAmount() >= params.min_sum_amount) {
-                    return result;
-                }
+        // Checks the sum amount of all UTXO's.
+        if (params.min_sum_amount != MAX_MONEY) {
+            if (result.GetTotalAmount() >= params.min_sum_amount) {
+                reached_limit = true;
+                return false;
             }
+        }
 
-            // Checks the maximum number of UTXO's.
-            if (params.max_count > 0 && result.Size() >= params.max_count) {
-                return result;
-            }
+        // Checks the maximum number of UTXO's.
+        if (params.max_count > 0 && result.Size() >= params.max_count) {
+            reached_limit = true;
+            return false;
         }
-    }
+        return true;
+    });
+    // As before, coins returned because a limit was reached do not get bump fees
+    if (reached_limit) return result;
 
     if (feerate.has_value()) {
         std::map<COutPoint, CAmount> map_of_bump_fees = wallet.chain().calculateIndividualBumpFees(outpoints, feerate.value());
@@ -4,6 +4,7 @@
 #include <qtum/qtumledger.h>
 #include <pos.h>
 #include <key_io.h>
+#include <script/solver.h>
 #include <common/args.h>
 #include <chainparams.h>
 #include <util/moneystr.h>
@@ -226,33 +227,11 @@ bool CreateCoinStakeFromMine(CWallet& wallet, unsigned int nBits, const CAmount&
 
     // Calculate reward
     {
-        int64_t nReward = nTotalFees + GetBlockSubsidy(nNextHeight, consensusParams);
-        if (nReward < 0)
+        CAmount nStakerReward;
+        if (!GetCoinStakeReward(nNextHeight, nTotalFees, consensusParams, nStakerReward, nRewardPiece))
             return false;
-
-        // HYBRID CONSENSUS: After activation, split reward between miner (PoW) and validator (PoS)
-        if (nNextHeight >= consensusParams.nHybridConsensusActivationHeight) {
-            // Calculate validator's share (PoS portion)
-            int64_t nValidatorReward = (nReward * consensusParams.nGapcoinValidatorRewardPercent) / 100;
-            // Note: Miner's share will be handled separately in block creation
-            // The validator gets their share in the coinstake
-            nCredit += nValidatorReward;
-
-            // Apply trust tier multiplier to validator reward
-            // (This is handled in CalculateTieredBlockReward in pos.cpp)
-        }
-        else if(pindexPrev->nHeight < consensusParams.nFirstMPoSBlock || pindexPrev->nHeight >= consensusParams.nLastMPoSBlock)
-        {
-            // Keep whole reward (legacy behavior)
-            nCredit += nReward;
-        }
-        else
-        {
-            // Split the reward when mpos is used (legacy MPoS)
-            nRewardPiece = nReward / consensusParams.nMPoSRewardRecipients;
-            nCredit += nRewardPiece + nReward % consensusParams.nMPoSRewardRecipients;
-        }
-   }
+        nCredit += nStakerReward;
+    }
 
     if (nCredit >= GetStakeSplitThreshold())
     {
@@ -334,6 +313,7 @@ bool CreateCoinStakeFromDelegate(CWallet& wallet, unsigned int nBits, const CAmo
     CScript scriptPubKeyKernel;
     CScript scriptPubKeyStaker;
     Delegation delegation;
+    uint160 delegateAddress;
     bool delegateOutputExist = false;
 
     for(const COutPoint &prevoutStake : setDelegateCoins)
@@ -378,6 +358,7 @@ bool CreateCoinStakeFromDelegate(CWallet& wallet, unsigned int nBits, const CAmo
                     LogError("CreateCoinStake: Failed to find delegation");
                     return false;
                 }
+                delegateAddress = hash160;
 
                 pkhash = PKHash(delegation.staker);
                 CPubKey pubKeyStake;
@@ -397,6 +378,7 @@ bool CreateCoinStakeFromDelegate(CWallet& wallet, unsigned int nBits, const CAmo
                     LogError("CreateCoinStake: Failed to find delegation");
                     return false;
                 }
+                delegateAddress = hash160;
 
                 pkhash = PKHash(delegation.staker);
                 CPubKey pubKeyStake;
@@ -496,6 +478,12 @@ bool CreateCoinStakeFromDelegate(CWallet& wallet, unsigned int nBits, const CAmo
     if(delegateOutputExist)
     {
         txNew.vout[2].nValue = nRewardOffline;
+
+        // After the fork the reward of the delegate accrues to its MPoS balance
+        if(pindexPrev->nHeight + 1 >= consensusParams.nMPoSBalanceHeight)
+        {
+            txNew.vout[2].scriptPubKey = GetScriptForMPoSCredit(delegateAddress);
+        }
     }
 
     if(pindexPrev->nHeight >= consensusParams.nFirstMPoSBlock && pindexPrev->nHeight < consensusParams.nLastMPoSBlock)
@@ -677,6 +677,53 @@ BOOST_FIXTURE_TEST_CASE(ListCoinsTest, ListCoinsTestingSetup)
     BOOST_CHECK_EQUAL(list.begin()->second.size(), 2U);
 }
 
+static void CheckSpendableCoinIndex(const CWallet& wallet) EXCLUSIVE_LOCKS_REQUIRED(wallet.cs_wallet)
+{
+    std::set<COutPoint> expected;
+    for (const auto& [txid, wtx] : wallet.mapWallet) {
+        for (unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
+            const COutPoint outpoint(Txid::FromUint256(txid), i);
+            if (!wallet.IsSpent(outpoint) && wallet.IsMine(wtx.tx->vout[i]) != ISMINE_NO) expected.insert(outpoint);
+        }
+    }
+    std::set<COutPoint> indexed;
+    wallet.GetSpendableCoins().ForEach(0, MAX_MONEY, [&](const COutPoint& outpoint, const SpendableCoinIndex::Entry& entry) {
+        BOOST_CHECK_EQUAL(entry.value, entry.wtx->tx->vout[outpoint.n].nValue);
+        indexed.insert(outpoint);
+        return true;
+    });
+    BOOST_CHECK(indexed == expected);
+    BOOST_CHECK_EQUAL(wallet.GetSpendableCoins().Size(), expected.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(SpendableCoinIndexTest, ListCoinsTestingSetup)
+{
+    WITH_LOCK(wallet->cs_wallet, CheckSpendableCoinIndex(*wallet));
+
+    // Spending a coin takes it out of the index and adds the change
+    const CWalletTx& wtx = AddTx(CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false});
+    LOCK(wallet->cs_wallet);
+    CheckSpendableCoinIndex(*wallet);
+    for (const CTxIn& txin : wtx.tx->vin) {
+        BOOST_CHECK(!wallet->GetSpendableCoins().Find(txin.prevout));
+    }
+
+    // Coins come in value order and outside of the value range are skipped
+    CAmount last{0};
+    size_t count{0};
+    wallet->GetSpendableCoins().ForEach(2 * COIN, MAX_MONEY, [&](const COutPoint&, const SpendableCoinIndex::Entry& entry) {
+        BOOST_CHECK(entry.value >= 2 * COIN);
+        BOOST_CHECK(SpendableCoinIndex::Bucket(entry.value) >= SpendableCoinIndex::Bucket(last));
+        last = entry.value;
+        return ++count < 2;
+    });
+    BOOST_CHECK(count > 0 && count <= 2);
+
+    // Rebuilding gives the same index
+    wallet->MarkDirty();
+    CheckSpendableCoinIndex(*wallet);
+}
+
 void TestCoinsResult(ListCoinsTest& context, OutputType out_type, CAmount amount,
                      std::map<OutputType, size_t>& expected_coins_sizes)
 {
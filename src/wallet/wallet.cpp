@@ -801,6 +801,7 @@ void CWallet::AddToSpends(const COutPoint& outpoint, const uint256& wtxid, Walle
     std::pair<TxSpends::iterator, TxSpends::iterator> range;
     range = mapTxSpends.equal_range(outpoint);
     SyncMetaData(range);
+    RefreshSpendableCoin(outpoint);
 }
 
 void CWallet::RemoveFromSpends(const COutPoint& outpoint, const uint256& wtxid)
@@ -819,6 +820,7 @@ void CWallet::RemoveFromSpends(const COutPoint& outpoint, const uint256& wtxid)
     range = mapTxSpends.equal_range(outpoint);
     if(range.first != range.second)
         SyncMetaData(range);
+    RefreshSpendableCoin(outpoint);
 }
 
 void CWallet::AddToSpends(const CWalletTx& wtx, WalletBatch* batch)
@@ -830,6 +832,48 @@ void CWallet::AddToSpends(const CWalletTx& wtx, WalletBatch* batch)
         AddToSpends(txin.prevout, wtx.GetHash(), batch);
 }
 
+void CWallet::RefreshSpendableCoin(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_wallet);
+    const auto it{mapWallet.find(outpoint.hash)};
+    if (it == mapWallet.end() || !it->second.tx || outpoint.n >= it->second.tx->vout.size() || IsSpent(outpoint)) {
+        m_spendable_coins.Remove(outpoint);
+        return;
+    }
+    const CTxOut& output{it->second.tx->vout[outpoint.n]};
+    const isminetype mine{IsMine(output)};
+    if (mine == ISMINE_NO) {
+        m_spendable_coins.Remove(outpoint);
+    } else {
+        m_spendable_coins.Add(outpoint, {&it->second, output.nValue, mine});
+    }
+}
+
+void CWallet::RefreshSpendableCoins(const CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+    if (!wtx.tx) return;
+    for (unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
+        RefreshSpendableCoin(COutPoint(wtx.tx->GetHash(), i));
+    }
+    if (wtx.IsCoinBase()) return;
+    for (const CTxIn& txin : wtx.tx->vin) {
+        RefreshSpendableCoin(txin.prevout);
+    }
+}
+
+void CWallet::RebuildSpendableCoins()
+{
+    AssertLockHeld(cs_wallet);
+    m_spendable_coins.Clear();
+    for (const auto& [txid, wtx] : mapWallet) {
+        if (!wtx.tx) continue;
+        for (unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
+            RefreshSpendableCoin(COutPoint(Txid::FromUint256(txid), i));
+        }
+    }
+}
+
 void CWallet::RemoveFromSpends(const CWalletTx& wtx)
 {
     if (wtx.IsCoinBase()) // Coinbases don't spend anything!
@@ -1017,6 +1061,8 @@ void CWallet::MarkDirty()
         LOCK(cs_wallet);
         for (std::pair<const uint256, CWalletTx>& item : mapWallet)
             item.second.MarkDirty();
+        // Ownership may have changed, e.g. by importing keys
+        RebuildSpendableCoins();
     }
 }
 
@@ -1225,6 +1271,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
 
     // Break debit/credit balance caches:
     wtx.MarkDirty();
+    RefreshSpendableCoins(wtx);
 
     // Notify UI of new or updated transaction
     NotifyTransactionChanged(hash, fInsertedNew ? CT_NEW : CT_UPDATED);
@@ -1372,6 +1419,7 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
         if (it != mapWallet.end()) {
             it->second.MarkDirty();
         }
+        RefreshSpendableCoin(txin.prevout);
     }
 }
 
@@ -1861,7 +1909,12 @@ bool CWallet::ImportScripts(const std::set<CScript> scripts, int64_t timestamp)
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportScripts(scripts, timestamp);
+    if (!spk_man->ImportScripts(scripts, timestamp)) {
+        return false;
+    }
+    // Outputs of transactions the wallet already has may have become ours
+    RebuildSpendableCoins();
+    return true;
 }
 
 bool CWallet::ImportPrivKeys(const std::map<CKeyID, CKey>& privkey_map, const int64_t timestamp)
@@ -1871,7 +1924,12 @@ bool CWallet::ImportPrivKeys(const std::map<CKeyID, CKey>& privkey_map, const in
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportPrivKeys(privkey_map, timestamp);
+    if (!spk_man->ImportPrivKeys(privkey_map, timestamp)) {
+        return false;
+    }
+    // Outputs of transactions the wallet already has may have become ours
+    RebuildSpendableCoins();
+    return true;
 }
 
 bool CWallet::ImportPubKeys(const std::vector<std::pair<CKeyID, bool>>& ordered_pubkeys, const std::map<CKeyID, CPubKey>& pubkey_map, const std::map<CKeyID, std::pair<CPubKey, KeyOriginInfo>>& key_origins, const bool add_keypool, const int64_t timestamp)
@@ -1881,7 +1939,12 @@ bool CWallet::ImportPubKeys(const std::vector<std::pair<CKeyID, bool>>& ordered_
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportPubKeys(ordered_pubkeys, pubkey_map, key_origins, add_keypool, timestamp);
+    if (!spk_man->ImportPubKeys(ordered_pubkeys, pubkey_map, key_origins, add_keypool, timestamp)) {
+        return false;
+    }
+    // Outputs of transactions the wallet already has may have become ours
+    RebuildSpendableCoins();
+    return true;
 }
 
 bool CWallet::ImportScriptPubKeys(const std::string& label, const std::set<CScript>& script_pub_keys, const bool have_solving_data, const bool apply_label, const int64_t timestamp)
@@ -1894,6 +1957,7 @@ bool CWallet::ImportScriptPubKeys(const std::string& label, const std::set<CScri
     if (!spk_man->ImportScriptPubKeys(script_pub_keys, have_solving_data, timestamp)) {
         return false;
     }
+    RebuildSpendableCoins();
     if (apply_label) {
         WalletBatch batch(GetDatabase());
         for (const CScript& script : script_pub_keys) {
@@ -2698,6 +2762,8 @@ DBErrors CWallet::LoadWallet()
         assert(m_internal_spk_managers.empty());
     }
 
+    RebuildSpendableCoins();
+
     return nLoadWalletRet;
 }
 
@@ -2743,6 +2809,8 @@ util::Result<void> CWallet::RemoveTxs(WalletBatch& batch, std::vector<uint256>&
             wtxOrdered.erase(it->second.m_it_wtxOrdered);
             for (const auto& txin : it->second.tx->vin)
                 mapTxSpends.erase(txin.prevout);
+            for (unsigned int i = 0; i < it->second.tx->vout.size(); ++i)
+                m_spendable_coins.Remove(COutPoint(Txid::FromUint256(hash), i));
             mapWallet.erase(it);
             NotifyTransactionChanged(hash, CT_DELETED);
         }
@@ -4462,6 +4530,9 @@ ScriptPubKeyMan* CWallet::AddWalletDescriptor(WalletDescriptor& desc, const Flat
     // Save the descriptor to DB
     spk_man->WriteDescriptor();
 
+    // Outputs of transactions the wallet already has may have become ours
+    RebuildSpendableCoins();
+
     return spk_man;
 }
 
@@ -45,6 +45,7 @@ static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
+static const char *MSG_EVMSTATEDIFF = "evmstatediff";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -288,6 +289,32 @@ bool CZMQPublishSequenceNotifier::NotifyBlockDisconnect(const CBlockIndex *pinde
     return SendSequenceMsg(*this, hash, /* Block (D)isconnect */ 'D');
 }
 
+// Helper function to send an 'evmstatediff' topic message: the label
+// followed by the serialized state changes of the block
+static bool SendStateDiffMsg(CZMQAbstractPublishNotifier& notifier, const std::function<bool(std::vector<uint8_t>&, const CBlockIndex&)>& get_state_diff, const CBlockIndex& index, char label)
+{
+    std::vector<uint8_t> data{uint8_t(label)};
+    std::vector<uint8_t> diff;
+    if (!get_state_diff(diff, index)) {
+        zmqError("Can't get the EVM state changes of the block");
+        return false;
+    }
+    data.insert(data.end(), diff.begin(), diff.end());
+    return notifier.SendZmqMessage(MSG_EVMSTATEDIFF, data.data(), data.size());
+}
+
+bool CZMQPublishEvmStateDiffNotifier::NotifyBlockConnect(const CBlockIndex *pindex)
+{
+    LogDebug(BCLog::ZMQ, "Publish evmstatediff block connect %s to %s\n", pindex->GetBlockHash().GetHex(), this->address);
+    return SendStateDiffMsg(*this, m_get_state_diff, *pindex, /* Block (C)onnect */ 'C');
+}
+
+bool CZMQPublishEvmStateDiffNotifier::NotifyBlockDisconnect(const CBlockIndex *pindex)
+{
+    LogDebug(BCLog::ZMQ, "Publish evmstatediff block disconnect %s to %s\n", pindex->GetBlockHash().GetHex(), this->address);
+    return SendStateDiffMsg(*this, m_get_state_diff, *pindex, /* Block (D)isconnect */ 'D');
+}
+
 bool CZMQPublishSequenceNotifier::NotifyTransactionAcceptance(const CTransaction &transaction, uint64_t mempool_sequence)
 {
     uint256 hash = transaction.GetHash();
@@ -63,6 +63,18 @@ public:
     bool NotifyTransaction(const CTransaction &transaction) override;
 };
 
+class CZMQPublishEvmStateDiffNotifier : public CZMQAbstractPublishNotifier
+{
+private:
+    const std::function<bool(std::vector<uint8_t>&, const CBlockIndex&)> m_get_state_diff;
+
+public:
+    CZMQPublishEvmStateDiffNotifier(std::function<bool(std::vector<uint8_t>&, const CBlockIndex&)> get_state_diff)
+        : m_get_state_diff{std::move(get_state_diff)} {}
+    bool NotifyBlockConnect(const CBlockIndex *pindex) override;
+    bool NotifyBlockDisconnect(const CBlockIndex *pindex) override;
+};
+
 class CZMQPublishSequenceNotifier : public CZMQAbstractPublishNotifier
 {
 public:
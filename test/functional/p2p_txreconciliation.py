@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test transaction announcements by txreconciliation (BIP 330).
+
+Five fully connected nodes relay transactions created on all of them, once
+with -txreconciliation and once by flooding only. Both runs must get every
+transaction to every mempool, and the bytes spent on announcing them are
+compared.
+"""
+import time
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import MiniWallet
+
+NUM_NODES = 5
+NUM_TXS = 200
+# Messages that announce transactions, per announcement protocol
+ANNOUNCEMENT_MSGS = ['inv', 'reqrecon', 'sketch', 'reqsketchext', 'reconcildiff']
+RECONCILIATION_MSGS = ['reqrecon', 'sketch', 'reconcildiff']
+
+
+class TxReconciliationTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = NUM_NODES
+        self.extra_args = [['-txreconciliation']] * NUM_NODES
+
+    def setup_network(self):
+        self.setup_nodes()
+        self.connect_all()
+
+    def connect_all(self):
+        # Every node makes outbound connections to the next two, which fully
+        # connects five nodes with two outbound and two inbound peers each
+        for i in range(NUM_NODES):
+            self.connect_nodes(i, (i + 1) % NUM_NODES)
+            self.connect_nodes(i, (i + 2) % NUM_NODES)
+
+    def bytes_sent(self, msgs):
+        return sum(peer['bytessent_per_msg'].get(msg, 0) for node in self.nodes for peer in node.getpeerinfo() for msg in msgs)
+
+    def bump_mocktime(self):
+        self.mocktime += 1
+        for node in self.nodes:
+            node.setmocktime(self.mocktime)
+
+    def relay_txs(self):
+        """Create transactions on all nodes and return the bytes sent per message type until all mempools have them."""
+        before = {msg: self.bytes_sent([msg]) for msg in ANNOUNCEMENT_MSGS}
+        wtxids = set()
+        for i in range(NUM_TXS):
+            wtxids.add(self.wallet.send_self_transfer(from_node=self.nodes[i % NUM_NODES])['wtxid'])
+
+        # Let time pass slowly enough for the messages of each step to be
+        # processed, so rounds do not pile up
+        for _ in range(300):
+            self.bump_mocktime()
+            time.sleep(0.2)
+            if all(wtxids <= {entry['wtxid'] for entry in node.getrawmempool(verbose=True).values()} for node in self.nodes):
+                break
+        else:
+            raise AssertionError("Transactions were not relayed to all nodes")
+        return {msg: self.bytes_sent([msg]) - before[msg] for msg in ANNOUNCEMENT_MSGS}
+
+    def run_test(self):
+        self.wallet = MiniWallet(self.nodes[0])
+        self.mocktime = int(time.time())
+        self.bump_mocktime()
+
+        self.log.info("Split coins so every transaction spends a confirmed output")
+        self.wallet.send_self_transfer_multi(from_node=self.nodes[0], num_outputs=2 * NUM_TXS)
+        self.generate(self.nodes[0], 1)
+
+        self.log.info("Relay transactions with txreconciliation")
+        assert all(peer['bytesrecv_per_msg'].get('sendtxrcncl', 0) > 0 for node in self.nodes for peer in node.getpeerinfo())
+        erlay = self.relay_txs()
+        for msg in RECONCILIATION_MSGS:
+            assert erlay[msg] > 0, msg
+
+        self.log.info("Relay transactions by flooding")
+        for i in range(NUM_NODES):
+            self.restart_node(i, extra_args=[])
+        self.connect_all()
+        self.bump_mocktime()
+        flooding = self.relay_txs()
+        for msg in RECONCILIATION_MSGS:
+            assert_equal(flooding[msg], 0)
+
+        erlay_bytes = sum(erlay.values())
+        flooding_bytes = sum(flooding.values())
+        self.log.info(f"Announcement bytes for {NUM_TXS} transactions: {erlay_bytes} with txreconciliation {erlay}, {flooding_bytes} by flooding")
+        assert erlay_bytes < flooding_bytes
+
+
+if __name__ == '__main__':
+    TxReconciliationTest(__file__).main()
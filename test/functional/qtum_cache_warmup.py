@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the cache warm-up across restarts.
+
+A node dumps the keys of the hot coins and EVM trie nodes on shutdown and
+prefetches them in the background on the next start, reporting the progress
+in getcachewarmupinfo.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import *
+from test_framework.qtum import *
+from test_framework.qtumconfig import *
+
+# Constructor returns the runtime code, which stores the call data in slot 0
+CODE = "600680600b6000396000f3" "600035600055"
+
+
+class QtumCacheWarmupTest(BitcoinTestFramework):
+    def add_options(self, parser):
+        self.add_wallet_options(parser)
+
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+        self.extra_args = [['-logevents']]
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def run_test(self):
+        self.node = self.nodes[0]
+        self.generatetoaddress(self.node, COINBASE_MATURITY + 100, self.node.getnewaddress())
+        info = self.node.getcachewarmupinfo()
+        assert not info['active']
+        assert_equal(info['coins'], 0)
+
+        self.log.info("Read contract state so that trie nodes are hot")
+        contract = self.node.createcontract(CODE)['address']
+        self.generate(self.node, 1)
+        for i in range(3):
+            self.node.sendtocontract(contract, "%064x" % (i + 1))
+            self.generate(self.node, 1)
+
+        self.log.info("Dump the hot keys on shutdown and prefetch them on restart")
+        self.restart_node(0)
+        assert (self.node.chain_path / "warmcache.dat").exists()
+        self.wait_until(lambda: self.node.getcachewarmupinfo()['complete'])
+        info = self.node.getcachewarmupinfo()
+        assert not info['active']
+        assert info['coins'] > 0
+        assert info['nodes'] > 0
+        assert_equal(info['coins_loaded'], info['coins'])
+        assert_equal(info['nodes_loaded'], info['nodes'])
+        assert_equal(info['progress'], 1)
+
+        self.log.info("The node works with the warm caches")
+        txid = self.node.sendtocontract(contract, "%064x" % 4)['txid']
+        self.generate(self.node, 1)
+        assert_equal(self.node.gettransactionreceipt(txid)[0]['excepted'], 'None')
+
+        self.log.info("Nothing is dumped or loaded with -cachewarmup=0")
+        self.restart_node(0, ['-cachewarmup=0'])
+        info = self.node.getcachewarmupinfo()
+        assert not info['active']
+        assert not info['complete']
+        assert_equal(info['coins'], 0)
+
+
+if __name__ == '__main__':
+    QtumCacheWarmupTest(__file__).main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the replacement and package relay of contract transactions.
+
+Contract transactions are mined by gas price. A replacement must raise the
+gas price of the contract transactions it replaces, bumpfee raises it, and
+the fees of descendants make up for a gas price below the minimum of the
+staker.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import *
+from test_framework.script import *
+from test_framework.address import *
+from test_framework.qtum import *
+from test_framework.qtumconfig import *
+
+GAS_LIMIT = 1000000
+MIN_GAS_PRICE = 40
+
+def to_amount(satoshis):
+    return Decimal('%d.%08d' % divmod(satoshis, COIN))
+
+class QtumContractReplacementTest(BitcoinTestFramework):
+    def add_options(self, parser):
+        self.add_wallet_options(parser)
+
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def gas_price(self, txid):
+        """Gas price of the contract output of a mempool transaction, in satoshis per gas."""
+        tx = self.node.decoderawtransaction(self.node.getrawtransaction(txid))
+        for output in tx['vout']:
+            ops = output['scriptPubKey']['asm'].split()
+            if ops and ops[-1] == 'OP_CREATE':
+                return int(ops[-3])
+        assert False
+
+    def create_tx(self, unspent, gas_price, fee=Decimal('0.001'), nSequence=0):
+        """Raw OP_CREATE transaction without OP_SENDER, paying its change back to the spent address."""
+        tx = CTransaction()
+        tx.vin = [CTxIn(COutPoint(int(unspent['txid'], 16), unspent['vout']), nSequence=nSequence)]
+        tx.vout.append(CTxOut(0, scriptPubKey=CScript([b"\x04", CScriptNum(GAS_LIMIT), CScriptNum(gas_price), b"\x00", OP_CREATE])))
+        change = int(unspent['amount'] * COIN) - gas_price * GAS_LIMIT - int(fee * COIN)
+        tx.vout.append(CTxOut(change, scriptPubKey=bytes.fromhex(unspent['scriptPubKey'])))
+        return self.node.signrawtransactionwithwallet(tx.serialize().hex())['hex']
+
+    def spend_tx(self, parent_hex, fee):
+        """Transaction spending the change of a contract transaction."""
+        parent = self.node.decoderawtransaction(parent_hex)
+        change = parent['vout'][1]
+        tx = CTransaction()
+        tx.vin = [CTxIn(COutPoint(int(parent['txid'], 16), 1), nSequence=0)]
+        tx.vout.append(CTxOut(int(change['value'] * COIN) - int(fee * COIN), scriptPubKey=bytes.fromhex(change['scriptPubKey']['hex'])))
+        return self.node.signrawtransactionwithwallet(tx.serialize().hex(), [{'txid': parent['txid'], 'vout': 1, 'scriptPubKey': change['scriptPubKey']['hex'], 'amount': change['value']}])['hex']
+
+    def run_test(self):
+        self.node = self.nodes[0]
+        self.address = self.node.getnewaddress("", "legacy")
+        self.generatetoaddress(self.node, COINBASE_MATURITY + 20, self.address)
+
+        self.log.info("Bump the gas price with bumpfee")
+        txid = self.node.createcontract("00", GAS_LIMIT, to_amount(MIN_GAS_PRICE))['txid']
+        assert_equal(self.gas_price(txid), MIN_GAS_PRICE)
+        assert_raises_rpc_error(-8, "Insufficient gas price", self.node.bumpfee, txid, {"gas_price": to_amount(MIN_GAS_PRICE)})
+        bumped = self.node.bumpfee(txid)
+        assert bumped['fee'] > bumped['origfee']
+        assert_equal(self.gas_price(bumped['txid']), MIN_GAS_PRICE + MIN_GAS_PRICE // 10)
+        bumped = self.node.bumpfee(bumped['txid'], {"gas_price": to_amount(2 * MIN_GAS_PRICE)})
+        assert_equal(self.gas_price(bumped['txid']), 2 * MIN_GAS_PRICE)
+        assert_equal(self.node.getrawmempool(), [bumped['txid']])
+        self.generate(self.node, 1)
+        assert_equal(self.node.gettransaction(bumped['txid'])['confirmations'], 1)
+        unspents = self.node.listunspent(1, 9999999, [self.address])
+
+        self.log.info("Reject a replacement that only raises the fee")
+        original = self.node.sendrawtransaction(self.create_tx(unspents[0], MIN_GAS_PRICE))
+        assert_raises_rpc_error(-26, "insufficient gas price", self.node.sendrawtransaction, self.create_tx(unspents[0], MIN_GAS_PRICE, fee=Decimal('0.1')))
+        replacement = self.node.sendrawtransaction(self.create_tx(unspents[0], MIN_GAS_PRICE + 1, fee=Decimal('0.1')))
+        assert original not in self.node.getrawmempool()
+        assert replacement in self.node.getrawmempool()
+        self.generate(self.node, 1)
+
+        self.log.info("Relay a contract transaction with its child as a package")
+        parent_hex = self.create_tx(unspents[1], MIN_GAS_PRICE)
+        child_hex = self.spend_tx(parent_hex, Decimal('0.001'))
+        result = self.node.submitpackage([parent_hex, child_hex])
+        assert_equal(result['package_msg'], 'success')
+        assert_equal(len(self.node.getrawmempool()), 2)
+        self.generate(self.node, 1)
+        assert_equal(self.node.getrawmempool(), [])
+
+        self.log.info("Mine a gas price below the staker minimum when the package pays for it")
+        self.restart_node(0, ['-staker-min-tx-gas-price=%.8f' % to_amount(2 * MIN_GAS_PRICE)])
+        parent_hex = self.create_tx(unspents[2], MIN_GAS_PRICE)
+        parent = self.node.sendrawtransaction(parent_hex)
+        self.generate(self.node, 1)
+        assert_equal(self.node.getrawmempool(), [parent])
+        # The child pays more than the gas of the parent at the staker minimum
+        child = self.node.sendrawtransaction(self.spend_tx(parent_hex, to_amount(2 * MIN_GAS_PRICE * GAS_LIMIT)))
+        self.generate(self.node, 1)
+        assert_equal(self.node.getrawmempool(), [])
+        block = self.node.getblock(self.node.getbestblockhash())
+        assert parent in block['tx']
+        assert child in block['tx']
+
+if __name__ == '__main__':
+    QtumContractReplacementTest(__file__).main()
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the download of the EVM state of a block from peers.
+
+A node that only has the headers of the blocks with new contracts downloads
+their EVM state from a peer serving it with -peerevmstate, and can connect
+the blocks on top of it afterwards.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import *
+from test_framework.messages import *
+from test_framework.p2p import P2PInterface
+from test_framework.qtum import *
+from test_framework.qtumconfig import *
+
+# Constructor stores 5 in slot 0, the deployed code stores its first call
+# data word in slot 0
+CODE = "60056000556007601160003960076000f3600035600055" "00"
+STATE_NODE = 0
+
+
+class EVMStateClient(P2PInterface):
+    def get_evm_state(self, requests):
+        self.send_and_ping(msg_getevmstate(requests))
+        return self.last_message['evmstate'].data
+
+
+class QtumEVMStateSyncTest(BitcoinTestFramework):
+    def add_options(self, parser):
+        self.add_wallet_options(parser)
+
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+        self.extra_args = [['-peerevmstate'], []]
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def run_test(self):
+        node0, node1 = self.nodes
+        self.generate(node0, COINBASE_MATURITY + 20)
+
+        self.log.info("Create contracts on a node the other one does not get blocks from")
+        self.disconnect_nodes(0, 1)
+        start_height = node1.getblockcount()
+        contract = node0.createcontract(CODE)['address']
+        self.generate(node0, 1, sync_fun=self.no_op)
+        node0.sendtocontract(contract, "00" * 31 + "09")
+        self.generate(node0, 1, sync_fun=self.no_op)
+        node0.createcontract(CODE)
+        self.generate(node0, 2, sync_fun=self.no_op)
+        tip = node0.getbestblockhash()
+        assert_equal(len(node0.getstorage(contract)), 1)
+
+        # Give the headers to the second node, and keep it from downloading
+        # the blocks
+        for height in range(start_height + 1, node0.getblockcount() + 1):
+            node1.submitheader(node0.getblockheader(node0.getblockhash(height), False))
+        first_block = node0.getblockhash(start_height + 1)
+        node1.invalidateblock(first_block)
+
+        self.log.info("Serve EVM state data by hash")
+        header = node0.getblockheader(tip)
+        client = node0.add_p2p_connection(EVMStateClient())
+        data = client.get_evm_state([(STATE_NODE, int(header['hashStateRoot'], 16)), (STATE_NODE, 0x1234)])
+        assert_equal(len(data), 2)
+        assert len(data[0]) > 0
+        assert_equal(data[1], b'')
+
+        self.log.info("Disconnect peers with too large requests")
+        with node0.assert_debug_log(['Misbehaving', 'getevmstate message size = 385']):
+            client.send_message(msg_getevmstate([(STATE_NODE, i) for i in range(385)]))
+            client.wait_for_disconnect()
+
+        self.log.info("Disconnect peers asking a node that does not serve EVM state")
+        client = node1.add_p2p_connection(EVMStateClient())
+        client.send_message(msg_getevmstate([(STATE_NODE, int(header['hashStateRoot'], 16))]))
+        client.wait_for_disconnect()
+
+        self.log.info("Download the EVM state of the tip")
+        assert_equal(node1.getevmstatesyncinfo(), {'active': False})
+        assert_raises_rpc_error(-5, "Block header not found", node1.syncevmstate, "00" * 32)
+        node1.syncevmstate(tip)
+        self.connect_nodes(1, 0)
+        assert node0.getnetworkinfo()['localservicesnames'].count('EVM_STATE') == 1
+        self.wait_until(lambda: node1.getevmstatesyncinfo()['complete'])
+        info = node1.getevmstatesyncinfo()
+        assert_equal(info['blockhash'], tip)
+        assert_equal(info['pending'], 0)
+        assert_equal(info['codes'], 1)
+        assert info['nodes'] > 0
+        assert info['keys'] > 0
+        assert sum(peer['bytesrecv_per_msg'].get('evmstate', 0) for peer in node1.getpeerinfo()) > 0
+        assert_equal(node1.getblockcount(), start_height)
+
+        self.log.info("Connect the blocks on top of the downloaded state")
+        node1.reconsiderblock(first_block)
+        self.sync_blocks()
+        assert_equal(node1.getstorage(contract), node0.getstorage(contract))
+
+        self.log.info("Follow the best header")
+        node1.syncevmstate()
+        self.wait_until(lambda: node1.getevmstatesyncinfo()['complete'])
+        assert_equal(node1.getevmstatesyncinfo()['codes'], 1)
+
+
+if __name__ == '__main__':
+    QtumEVMStateSyncTest(__file__).main()
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the retention window of receipts and log index entries.
+
+A node running with -logeventsretain prunes the receipts and logs of blocks
+that fell out of the window in the background, reports the lowest retained
+height for requests below it, and keeps the delegation contract entries that
+super stakers search from the first block.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import *
+from test_framework.qtum import *
+from test_framework.qtumconfig import *
+
+RETAIN = 288
+# Constructor returns the runtime code, which emits an empty LOG0
+CODE = "600680600b6000396000f3" "60006000a000"
+
+
+class QtumLogEventsRetainTest(BitcoinTestFramework):
+    def add_options(self, parser):
+        self.add_wallet_options(parser)
+
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+        self.extra_args = [['-txindex', '-logevents', '-logeventsretain=%d' % RETAIN]]
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def pruned_below(self, height):
+        try:
+            self.node.searchlogs(1, 1)
+        except JSONRPCException as e:
+            return e.error['message'] == "Receipts and logs below height %d are pruned (-logeventsretain)" % height
+        return False
+
+    def run_test(self):
+        self.node = self.nodes[0]
+        delegator_address = self.node.getnewaddress()
+        staker_address = self.node.getnewaddress()
+        self.generatetoaddress(self.node, COINBASE_MATURITY + 100, delegator_address)
+
+        self.log.info("Create receipts, logs and a delegation")
+        delegate_to_staker(self.node, delegator_address, staker_address, 10, create_POD(self.node, delegator_address, staker_address))
+        contract = self.node.createcontract(CODE)['address']
+        self.generate(self.node, 1)
+        txid = self.node.sendtocontract(contract, "00")['txid']
+        block_hash = self.generate(self.node, 1)[0]
+        height = self.node.getblockcount()
+        assert_equal(len(self.node.gettransactionreceipt(txid)[0]['log']), 1)
+        assert_equal(len(self.node.searchlogs(height, height, {"addresses": [contract]})), 1)
+
+        self.log.info("Prune the blocks that leave the window")
+        self.generate(self.node, RETAIN + 10)
+        tip = self.node.getblockcount()
+        self.wait_until(lambda: self.pruned_below(tip - RETAIN + 1))
+        error = "Receipts and logs below height %d are pruned (-logeventsretain)" % (tip - RETAIN + 1)
+        assert_raises_rpc_error(-1, error, self.node.gettransactionreceipt, txid)
+        assert_raises_rpc_error(-1, error, self.node.getblocktransactionreceipts, block_hash)
+        assert_raises_rpc_error(-1, error, self.node.searchlogs, height, height)
+        assert_raises_rpc_error(-1, error, self.node.waitforlogs, height, height)
+        self.node.searchlogs(tip - RETAIN + 1, tip)
+
+        self.log.info("Keep the delegation contract entries")
+        delegations = self.node.getdelegationsforstaker(staker_address)
+        assert_equal(len(delegations), 1)
+        assert_equal(delegations[0]['delegate'], delegator_address)
+
+        self.log.info("Keep the pruned height across restarts")
+        self.restart_node(0)
+        assert self.pruned_below(tip - RETAIN + 1)
+        self.stop_node(0)
+        self.nodes[0].assert_start_raises_init_error(['-logevents', '-logeventsretain=%d' % (RETAIN - 1)], "Error: -logeventsretain must be 0 or at least %d." % RETAIN)
+
+
+if __name__ == '__main__':
+    QtumLogEventsRetainTest(__file__).main()
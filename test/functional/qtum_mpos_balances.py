@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the accrued MPoS balances.
+
+After the -mposbalanceheight fork the MPoS pieces of a block are added to the
+balances of the participants instead of being paid by its coinstake. A balance
+is claimed by a transaction spending a coin of its owner.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import *
+from test_framework.script import *
+from test_framework.address import *
+from test_framework.qtum import *
+from test_framework.qtumconfig import *
+from test_framework.messages import tx_from_hex
+
+MPOS_BALANCE_HEIGHT = 5010
+
+class QtumMPoSBalancesTest(BitcoinTestFramework):
+    def add_options(self, parser):
+        self.add_wallet_options(parser)
+
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+        self.extra_args = [['-lastmposheight=999999', '-mposbalanceheight=%d' % MPOS_BALANCE_HEIGHT]]
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def remove_from_staking_prevouts(self, remove_prevout):
+        for j in range(len(self.staking_prevouts)):
+            prevout = self.staking_prevouts[j]
+            if prevout[0].serialize() == remove_prevout.serialize():
+                self.staking_prevouts.pop(j)
+                break
+
+    def next_time(self):
+        nTime = (self.node.getblock(self.node.getbestblockhash())['time']+45) & 0xfffffff0
+        self.node.setmocktime(nTime)
+        return nTime
+
+    def create_balance_block(self, pay_balance=False, txs=[]):
+        block, block_sig_key = create_unsigned_pos_block(self.node, self.staking_prevouts, nTime=self.next_time())
+        txout = self.node.gettxout(hex(block.prevoutStake.hash)[2:].zfill(64), block.prevoutStake.n)
+        block_reward = int(INITIAL_BLOCK_REWARD_POS*COIN)
+        stake_per_participant = block_reward // MPOS_PARTICIPANTS
+        staker_reward = int(txout['value']*COIN) + block_reward - stake_per_participant*(MPOS_PARTICIPANTS-1)
+        block.vtx[1].vout[1].nValue = staker_reward // 2
+        block.vtx[1].vout[2].nValue = staker_reward // 2
+
+        balance = int(self.node.getmposbalance(self.staker_address)*COIN)
+        if pay_balance:
+            block.vtx[1].vout.append(CTxOut(balance, CScript([OP_DUP, OP_HASH160, self.staker_hpubkey, OP_EQUALVERIFY, OP_CHECKSIG])))
+
+        block.vtx[1] = rpc_sign_transaction(self.node, block.vtx[1])
+        block.vtx.extend(txs)
+        block.hashMerkleRoot = block.calc_merkle_root()
+        block.sign_block(block_sig_key)
+        return block
+
+    def create_claim_tx(self, amount, keyid=None, fee=1000000, sighashtype="ALL"):
+        prevout, value, _ = self.staking_prevouts.pop()
+        claim = b"mposclaim" + (keyid or self.staker_hpubkey) + struct.pack('<q', amount)
+        tx = CTransaction()
+        tx.vin = [CTxIn(prevout)]
+        tx.vout = [CTxOut(value + amount - fee, CScript([OP_DUP, OP_HASH160, self.staker_hpubkey, OP_EQUALVERIFY, OP_CHECKSIG])), CTxOut(0, CScript([OP_RETURN, claim]))]
+        if sighashtype == "ALL":
+            return rpc_sign_transaction(self.node, tx)
+        ret = self.node.signrawtransactionwithwallet(bytes_to_hex_str(tx.serialize()), [], sighashtype)
+        assert ret['complete']
+        return tx_from_hex(ret['hex'])
+
+    def submit(self, block, accepted=True):
+        block_count = self.node.getblockcount()
+        result = self.node.submitblock(bytes_to_hex_str(block.serialize()))
+        if accepted:
+            assert_equal(result, None)
+            assert_equal(self.node.getblockcount(), block_count+1)
+            self.remove_from_staking_prevouts(block.prevoutStake)
+        else:
+            assert result is not None
+            assert_equal(self.node.getblockcount(), block_count)
+        return result
+
+    def run_test(self):
+        self.node = self.nodes[0]
+        privkey = byte_to_base58(hash256(struct.pack('<I', 0)), 239)
+        self.node.importprivkey(privkey)
+        activate_mpos(self.node)
+
+        staker_key = ECKey()
+        staker_key.set(hash256(struct.pack('<I', 0)), False)
+        self.staker_hpubkey = hash160(staker_key.get_pubkey().get_bytes())
+        self.staker_address = hex_hash_to_p2pkh(bytes_to_hex_str(self.staker_hpubkey))
+        self.staking_prevouts = collect_prevouts(self.node, address="qSrM9K6FMhZ29Vkp8Rdk8Jp66bbfpjFETq")
+        stake_per_participant = int(INITIAL_BLOCK_REWARD_POS*COIN) // MPOS_PARTICIPANTS
+        accrued_per_block = stake_per_participant*(MPOS_PARTICIPANTS-1)
+
+        self.log.info("Stake MPoS blocks paying the participants in the coinstake")
+        assert_equal(self.node.getmposbalance(self.staker_address), 0)
+        txouts_before = self.node.gettxoutsetinfo()['txouts']
+        num_blocks = MPOS_BALANCE_HEIGHT - 1 - self.node.getblockcount()
+        for i in range(num_blocks):
+            block, block_sig_key = create_unsigned_mpos_block(self.node, self.staking_prevouts, nTime=self.next_time())
+            block.sign_block(block_sig_key)
+            self.submit(block)
+        growth_mpos_outputs = self.node.gettxoutsetinfo()['txouts'] - txouts_before
+        assert_equal(self.node.getmposbalance(self.staker_address), 0)
+
+        self.log.info("Stake MPoS blocks accruing the participant rewards")
+        txouts_before = self.node.gettxoutsetinfo()['txouts']
+        for i in range(num_blocks):
+            self.submit(self.create_balance_block())
+            assert_equal(int(self.node.getmposbalance(self.staker_address)*COIN), (i+1)*accrued_per_block)
+        growth_mpos_balances = self.node.gettxoutsetinfo()['txouts'] - txouts_before
+        self.log.info("UTXO set growth over %d blocks: %d with MPoS outputs, %d with MPoS balances" % (num_blocks, growth_mpos_outputs, growth_mpos_balances))
+        assert growth_mpos_balances < growth_mpos_outputs
+
+        self.log.info("Reject a coinstake that pays the participants")
+        block, block_sig_key = create_unsigned_mpos_block(self.node, self.staking_prevouts, nTime=self.next_time())
+        block.vtx[1].vout.append(CTxOut(accrued_per_block, CScript([OP_DUP, OP_HASH160, self.staker_hpubkey, OP_EQUALVERIFY, OP_CHECKSIG])))
+        block.vtx[1] = rpc_sign_transaction(self.node, block.vtx[1])
+        block.hashMerkleRoot = block.calc_merkle_root()
+        block.sign_block(block_sig_key)
+        self.submit(block, accepted=False)
+
+        self.log.info("Reject a coinstake that pays out the balance of the staker")
+        self.submit(self.create_balance_block(pay_balance=True), accepted=False)
+
+        self.log.info("Reject claims exceeding the balance or not signed by its owner")
+        balance = num_blocks*accrued_per_block
+        assert_raises_rpc_error(-26, "bad-txns-mpos-claim-balance", self.node.sendrawtransaction, bytes_to_hex_str(self.create_claim_tx(balance + 1).serialize()))
+        assert_raises_rpc_error(-26, "bad-txns-mpos-claim-owner", self.node.sendrawtransaction, bytes_to_hex_str(self.create_claim_tx(1, keyid=b"\x01"*20).serialize()))
+        for sighashtype in ["NONE", "SINGLE", "ALL|ANYONECANPAY"]:
+            assert_raises_rpc_error(-26, "bad-txns-mpos-claim-sighash", self.node.sendrawtransaction, bytes_to_hex_str(self.create_claim_tx(1, sighashtype=sighashtype).serialize()))
+
+        self.log.info("Claim the balance with a single transaction")
+        fee = 1000000
+        claim_tx = self.create_claim_tx(balance, fee=fee)
+        self.node.sendrawtransaction(bytes_to_hex_str(claim_tx.serialize()))
+        assert_raises_rpc_error(-26, "txn-mempool-mpos-claim-conflict", self.node.sendrawtransaction, bytes_to_hex_str(self.create_claim_tx(1).serialize()))
+        self.submit(self.create_balance_block(txs=[claim_tx]))
+        assert_equal(self.node.getrawmempool(), [])
+        accrued_with_fee = (int(INITIAL_BLOCK_REWARD_POS*COIN) + fee) // MPOS_PARTICIPANTS * (MPOS_PARTICIPANTS-1)
+        assert_equal(int(self.node.getmposbalance(self.staker_address)*COIN), accrued_with_fee)
+        claim_tx.rehash()
+        assert_equal(int(self.node.gettxout(claim_tx.hash, 0)['value']*COIN), claim_tx.vout[0].nValue)
+
+        self.log.info("Reject a block claiming more than the balance")
+        self.submit(self.create_balance_block(txs=[self.create_claim_tx(accrued_with_fee + 1)]), accepted=False)
+
+        self.log.info("Restore the balances when disconnecting blocks")
+        tip_hash = self.node.getbestblockhash()
+        claim_hash = tip_hash
+        self.node.invalidateblock(claim_hash)
+        assert_equal(int(self.node.getmposbalance(self.staker_address)*COIN), balance)
+        self.node.reconsiderblock(claim_hash)
+        fork_hash = self.node.getblockhash(MPOS_BALANCE_HEIGHT)
+        self.node.invalidateblock(fork_hash)
+        assert_equal(self.node.getmposbalance(self.staker_address), 0)
+        self.node.reconsiderblock(fork_hash)
+        assert_equal(self.node.getbestblockhash(), tip_hash)
+        assert_equal(int(self.node.getmposbalance(self.staker_address)*COIN), accrued_with_fee)
+
+        self.log.info("Keep the balances across a restart")
+        self.restart_node(0)
+        assert_equal(int(self.node.getmposbalance(self.staker_address)*COIN), accrued_with_fee)
+        self.submit(self.create_balance_block())
+        assert_equal(int(self.node.getmposbalance(self.staker_address)*COIN), accrued_with_fee + accrued_per_block)
+
+        self.log.info("Evict a pending claim when a block claims the same balance")
+        pending_tx = self.create_claim_tx(1)
+        self.node.sendrawtransaction(bytes_to_hex_str(pending_tx.serialize()))
+        self.submit(self.create_balance_block(txs=[self.create_claim_tx(2)]))
+        assert_equal(self.node.getrawmempool(), [])
+        self.node.sendrawtransaction(bytes_to_hex_str(self.create_claim_tx(3).serialize()))
+
+if __name__ == '__main__':
+    QtumMPoSBalancesTest(__file__).main()
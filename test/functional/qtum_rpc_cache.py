@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the RPC response cache.
+
+Responses about blocks with at least -rpccachedepth confirmations are kept
+within -rpccachesize, have their confirmations kept up to date, and are
+dropped when their block is disconnected.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import *
+
+DEPTH = 10
+
+
+class QtumRPCCacheTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+        self.extra_args = [['-rpccachesize=16', '-rpccachedepth=%d' % DEPTH, '-logevents']]
+
+    def lookups(self, method):
+        methods = self.node.getrpccacheinfo()['methods']
+        if method not in methods:
+            return 0, 0
+        return methods[method]['hits'], methods[method]['misses']
+
+    def assert_cached(self, method, *params):
+        hits, misses = self.lookups(method)
+        result = getattr(self.node, method)(*params)
+        assert_equal(self.lookups(method), (hits, misses + 1))
+        assert_equal(getattr(self.node, method)(*params), result)
+        assert_equal(self.lookups(method), (hits + 1, misses + 1))
+        return result
+
+    def assert_not_cached(self, method, *params):
+        hits, misses = self.lookups(method)
+        result = getattr(self.node, method)(*params)
+        assert_equal(getattr(self.node, method)(*params), result)
+        assert_equal(self.lookups(method), (hits, misses + 2))
+        return result
+
+    def run_test(self):
+        self.node = self.nodes[0]
+        self.generate(self.node, 200)
+        info = self.node.getrpccacheinfo()
+        assert info['enabled']
+        assert_equal(info['max_bytes'], 16 << 20)
+        assert_equal(info['depth'], DEPTH)
+        assert_equal(info['entries'], 0)
+
+        self.log.info("Responses about deep blocks are cached")
+        old_hash = self.node.getblockhash(50)
+        for verbosity in range(2):
+            self.assert_cached('getblock', old_hash, verbosity)
+        self.assert_cached('getblockheader', old_hash)
+        self.assert_cached('getblockheader', old_hash, False)
+        coinbase = self.node.getblock(old_hash)['tx'][0]
+        self.assert_cached('getrawtransaction', coinbase, True, old_hash)
+        self.assert_cached('getrawtransaction', coinbase, False, old_hash)
+        self.assert_cached('searchlogs', 1, 100)
+        assert_equal(self.node.getrpccacheinfo()['entries'], 7)
+
+        self.log.info("Blocks with transaction details are streamed instead")
+        for verbosity in range(2, 4):
+            block = self.assert_not_cached('getblock', old_hash, verbosity)
+            assert_equal(block['tx'][0]['txid'], coinbase)
+        assert_equal(self.node.getrpccacheinfo()['entries'], 7)
+
+        self.log.info("Unknown blocks are not found")
+        for verbose in [True, False]:
+            assert_raises_rpc_error(-5, "Block not found", self.node.getblockheader, "00" * 32, verbose)
+        assert_raises_rpc_error(-5, "Block not found", self.node.getblock, "00" * 32)
+
+        self.log.info("Responses about recent blocks are not cached")
+        tip_height = self.node.getblockcount()
+        self.assert_not_cached('getblock', self.node.getblockhash(tip_height))
+        # The next block of the header is part of the response
+        self.assert_not_cached('getblockheader', self.node.getblockhash(tip_height - DEPTH + 1))
+        self.assert_cached('getblockheader', self.node.getblockhash(tip_height - DEPTH))
+        self.assert_not_cached('searchlogs', 1, tip_height)
+
+        self.log.info("Cached confirmations follow the tip")
+        block = self.node.getblock(old_hash)
+        self.generate(self.node, 5)
+        hits, _ = self.lookups('getblock')
+        assert_equal(self.node.getblock(old_hash)['confirmations'], block['confirmations'] + 5)
+        assert_equal(self.lookups('getblock')[0], hits + 1)
+        tx = self.node.getrawtransaction(coinbase, True, old_hash)
+        assert_equal(tx['confirmations'], block['confirmations'] + 5)
+
+        self.log.info("Responses about disconnected blocks are dropped")
+        tip_height = self.node.getblockcount()
+        kept_hash = self.node.getblockhash(tip_height - 2 * DEPTH)
+        stale_hash = self.node.getblockhash(tip_height - DEPTH - 1)
+        kept = self.assert_cached('getblock', kept_hash)
+        self.assert_cached('getblock', stale_hash)
+        self.node.invalidateblock(self.node.getblockhash(tip_height - DEPTH - 1))
+        hits, _ = self.lookups('getblock')
+        assert_equal(self.node.getblock(kept_hash)['confirmations'], kept['confirmations'] - DEPTH - 2)
+        assert_equal(self.node.getblock(stale_hash)['confirmations'], -1)
+        assert_equal(self.lookups('getblock')[0], hits + 1)
+        assert self.node.getrpccacheinfo()['invalidated'] > 0
+        self.node.reconsiderblock(stale_hash)
+        assert_equal(self.node.getblockcount(), tip_height)
+        assert_equal(self.node.getblock(kept_hash)['confirmations'], kept['confirmations'])
+
+        self.log.info("The cache is disabled by default")
+        self.restart_node(0, ['-logevents'])
+        info = self.node.getrpccacheinfo()
+        assert not info['enabled']
+        self.node.getblock(old_hash)
+        assert_raises_rpc_error(-5, "Block not found", self.node.getblockheader, "00" * 32)
+        assert_equal(self.node.getrpccacheinfo()['methods'], {})
+
+        self.log.info("Invalid sizes and depths are rejected")
+        self.stop_node(0)
+        self.node.assert_start_raises_init_error(['-logevents', '-rpccachesize=-1'], 'Error: -rpccachesize cannot be negative.')
+        self.node.assert_start_raises_init_error(['-logevents', '-rpccachedepth=0'], 'Error: -rpccachedepth must be at least 1.')
+
+
+if __name__ == '__main__':
+    QtumRPCCacheTest(__file__).main()
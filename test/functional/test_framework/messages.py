@@ -63,6 +63,7 @@ NODE_WITNESS = (1 << 3)
 NODE_COMPACT_FILTERS = (1 << 6)
 NODE_NETWORK_LIMITED = (1 << 10)
 NODE_P2P_V2 = (1 << 11)
+NODE_EVM_STATE = (1 << 13)
 
 MSG_TX = 1
 MSG_BLOCK = 2
@@ -1603,6 +1604,69 @@ class msg_headers:
         return "msg_headers(headers=%s)" % repr(self.headers)
 
 
+class msg_equivocation:
+    __slots__ = ("first", "second")
+    msgtype = b"equivocation"
+
+    def __init__(self, first=None, second=None):
+        self.first = first if first is not None else CBlockHeader()
+        self.second = second if second is not None else CBlockHeader()
+
+    def deserialize(self, f):
+        self.first = CBlockHeader()
+        self.first.deserialize(f)
+        self.second = CBlockHeader()
+        self.second.deserialize(f)
+
+    def serialize(self):
+        return CBlockHeader(self.first).serialize() + CBlockHeader(self.second).serialize()
+
+    def __repr__(self):
+        return "msg_equivocation(first=%s second=%s)" % (repr(self.first), repr(self.second))
+
+
+class msg_getevmstate:
+    __slots__ = ("requests",)
+    msgtype = b"getevmstate"
+
+    def __init__(self, requests=None):
+        # List of (kind, hash) pairs
+        self.requests = requests or []
+
+    def deserialize(self, f):
+        self.requests = []
+        for _ in range(deser_compact_size(f)):
+            kind = int.from_bytes(f.read(1), "little")
+            self.requests.append((kind, deser_uint256(f)))
+
+    def serialize(self):
+        r = ser_compact_size(len(self.requests))
+        for kind, hash in self.requests:
+            r += kind.to_bytes(1, "little")
+            r += ser_uint256(hash)
+        return r
+
+    def __repr__(self):
+        return "msg_getevmstate(requests=%s)" % repr(self.requests)
+
+
+class msg_evmstate:
+    __slots__ = ("data",)
+    msgtype = b"evmstate"
+
+    def __init__(self, data=None):
+        self.data = data or []
+
+    def deserialize(self, f):
+        self.data = deser_string_vector(f)
+
+    def serialize(self):
+        return ser_string_vector(self.data)
+
+    def __repr__(self):
+        return "msg_evmstate(data=%s)" % repr(self.data)
+
+
 class msg_merkleblock:
     __slots__ = ("merkleblock",)
     msgtype = b"merkleblock"
@@ -1967,6 +2031,82 @@ class msg_sendtxrcncl:
         return "msg_sendtxrcncl(version=%lu, salt=%lu)" %\
             (self.version, self.salt)
 
+class msg_reqrecon:
+    __slots__ = ("set_size", "q")
+    msgtype = b"reqrecon"
+
+    def __init__(self, set_size=0, q=0):
+        self.set_size = set_size
+        self.q = q
+
+    def deserialize(self, f):
+        self.set_size = int.from_bytes(f.read(2), "little")
+        self.q = int.from_bytes(f.read(2), "little")
+
+    def serialize(self):
+        r = b""
+        r += self.set_size.to_bytes(2, "little")
+        r += self.q.to_bytes(2, "little")
+        return r
+
+    def __repr__(self):
+        return "msg_reqrecon(set_size=%i, q=%i)" % (self.set_size, self.q)
+
+class msg_sketch:
+    __slots__ = ("skdata",)
+    msgtype = b"sketch"
+
+    def __init__(self, skdata=b""):
+        self.skdata = skdata
+
+    def deserialize(self, f):
+        self.skdata = deser_string(f)
+
+    def serialize(self):
+        return ser_string(self.skdata)
+
+    def __repr__(self):
+        return "msg_sketch(skdata=%s)" % self.skdata.hex()
+
+class msg_reqsketchext:
+    __slots__ = ()
+    msgtype = b"reqsketchext"
+
+    def __init__(self):
+        pass
+
+    def deserialize(self, f):
+        pass
+
+    def serialize(self):
+        return b""
+
+    def __repr__(self):
+        return "msg_reqsketchext()"
+
+class msg_reconcildiff:
+    __slots__ = ("success", "ask_shortids")
+    msgtype = b"reconcildiff"
+
+    def __init__(self, success=0, ask_shortids=None):
+        self.success = success
+        self.ask_shortids = ask_shortids or []
+
+    def deserialize(self, f):
+        self.success = int.from_bytes(f.read(1), "little")
+        self.ask_shortids = [int.from_bytes(f.read(4), "little") for _ in range(deser_compact_size(f))]
+
+    def serialize(self):
+        r = b""
+        r += self.success.to_bytes(1, "little")
+        r += ser_compact_size(len(self.ask_shortids))
+        for short_id in self.ask_shortids:
+            r += short_id.to_bytes(4, "little")
+        return r
+
+    def __repr__(self):
+        return "msg_reconcildiff(success=%i, ask_shortids=%s)" % (self.success, self.ask_shortids)
+
 class TestFrameworkScript(unittest.TestCase):
     def test_addrv2_encode_decode(self):
         def check_addrv2(ip, net):
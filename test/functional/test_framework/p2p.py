@@ -41,6 +41,8 @@ from test_framework.messages import (
     msg_cfheaders,
     msg_cfilter,
     msg_cmpctblock,
+    msg_equivocation,
+    msg_evmstate,
     msg_feefilter,
     msg_filteradd,
     msg_filterclear,
@@ -52,6 +54,7 @@ from test_framework.messages import (
     msg_getcfheaders,
     msg_getcfilters,
     msg_getdata,
+    msg_getevmstate,
     msg_getheaders,
     msg_headers,
     msg_inv,
@@ -60,10 +63,14 @@ from test_framework.messages import (
     msg_notfound,
     msg_ping,
     msg_pong,
+    msg_reconcildiff,
+    msg_reqrecon,
+    msg_reqsketchext,
     msg_sendaddrv2,
     msg_sendcmpct,
     msg_sendheaders,
     msg_sendtxrcncl,
+    msg_sketch,
     msg_tx,
     MSG_TX,
     MSG_TYPE_MASK,
@@ -118,6 +125,8 @@ MESSAGEMAP = {
     b"cfheaders": msg_cfheaders,
     b"cfilter": msg_cfilter,
     b"cmpctblock": msg_cmpctblock,
+    b"equivocation": msg_equivocation,
+    b"evmstate": msg_evmstate,
     b"feefilter": msg_feefilter,
     b"filteradd": msg_filteradd,
     b"filterclear": msg_filterclear,
@@ -129,6 +138,7 @@ MESSAGEMAP = {
     b"getcfheaders": msg_getcfheaders,
     b"getcfilters": msg_getcfilters,
     b"getdata": msg_getdata,
+    b"getevmstate": msg_getevmstate,
     b"getheaders": msg_getheaders,
     b"headers": msg_headers,
     b"inv": msg_inv,
@@ -137,10 +147,14 @@ MESSAGEMAP = {
     b"notfound": msg_notfound,
     b"ping": msg_ping,
     b"pong": msg_pong,
+    b"reconcildiff": msg_reconcildiff,
+    b"reqrecon": msg_reqrecon,
+    b"reqsketchext": msg_reqsketchext,
     b"sendaddrv2": msg_sendaddrv2,
     b"sendcmpct": msg_sendcmpct,
     b"sendheaders": msg_sendheaders,
     b"sendtxrcncl": msg_sendtxrcncl,
+    b"sketch": msg_sketch,
     b"tx": msg_tx,
     b"verack": msg_verack,
     b"version": msg_version,
@@ -531,6 +545,8 @@ class P2PInterface(P2PConnection):
     def on_cfheaders(self, message): pass
     def on_cfilter(self, message): pass
     def on_cmpctblock(self, message): pass
+    def on_equivocation(self, message): pass
+    def on_evmstate(self, message): pass
     def on_feefilter(self, message): pass
     def on_filteradd(self, message): pass
     def on_filterclear(self, message): pass
@@ -539,16 +555,21 @@ class P2PInterface(P2PConnection):
     def on_getblocks(self, message): pass
     def on_getblocktxn(self, message): pass
     def on_getdata(self, message): pass
+    def on_getevmstate(self, message): pass
     def on_getheaders(self, message): pass
     def on_headers(self, message): pass
     def on_mempool(self, message): pass
     def on_merkleblock(self, message): pass
     def on_notfound(self, message): pass
     def on_pong(self, message): pass
+    def on_reconcildiff(self, message): pass
+    def on_reqrecon(self, message): pass
+    def on_reqsketchext(self, message): pass
     def on_sendaddrv2(self, message): pass
     def on_sendcmpct(self, message): pass
     def on_sendheaders(self, message): pass
     def on_sendtxrcncl(self, message): pass
+    def on_sketch(self, message): pass
     def on_tx(self, message): pass
     def on_wtxidrelay(self, message): pass
 
@@ -393,6 +393,7 @@ BASE_SCRIPTS = [
     'rpc_getdescriptoractivity.py',
     'rpc_scanblocks.py',
     'p2p_sendtxrcncl.py',
+    'p2p_txreconciliation.py',
     'rpc_scantxoutset.py',
     'feature_unsupported_utxo_db.py',
     'feature_logging.py',
@@ -494,6 +495,17 @@ BASE_SCRIPTS = [
     'qtum_assign_mpos_fees_to_gas_refund.py --descriptors',
     'qtum_ignore_mpos_participant_reward.py --legacy-wallet',
     'qtum_ignore_mpos_participant_reward.py --descriptors',
+    'qtum_mpos_balances.py --legacy-wallet',
+    'qtum_mpos_balances.py --descriptors',
+    'qtum_contract_replacement.py --legacy-wallet',
+    'qtum_contract_replacement.py --descriptors',
+    'qtum_evm_state_sync.py --legacy-wallet',
+    'qtum_evm_state_sync.py --descriptors',
+    'qtum_logevents_retain.py --legacy-wallet',
+    'qtum_logevents_retain.py --descriptors',
+    'qtum_cache_warmup.py --legacy-wallet',
+    'qtum_cache_warmup.py --descriptors',
+    'qtum_rpc_cache.py',
     'qtum_evm_constantinople_activation.py --legacy-wallet',
     'qtum_evm_constantinople_activation.py --descriptors',
     'qtum_many_value_refunds_from_same_tx.py --legacy-wallet',
@@ -522,6 +534,9 @@ BASE_SCRIPTS = [
     'qtum_block_number_corruption.py --descriptors',
     'qtum_duplicate_stake.py --legacy-wallet',
     'qtum_duplicate_stake.py --descriptors',
+    'wattx_staker_equivocation.py --legacy-wallet',
+    'wattx_staker_equivocation.py --descriptors',
+    'wattx_orphan_blocks.py',
     'qtum_rpc_bitcore.py --legacy-wallet',
     'qtum_rpc_bitcore.py --descriptors',
     'qtum_faulty_header_chain.py --legacy-wallet',
@@ -29,6 +29,7 @@ from test_framework.util import (
     assert_equal,
     set_node_times,
 )
+from test_framework.wallet_util import get_key
 
 import collections
 from decimal import Decimal
@@ -336,6 +337,24 @@ class ImportRescanTest(BitcoinTestFramework):
                 variant.expected_txs = 0
                 variant.check()
 
+        self.log.info("Imports without a rescan make the outputs of known transactions spendable")
+        node = self.nodes[0]
+        imports = [
+            (lambda key: node.importaddress(key.p2pkh_addr, "", False), False),
+            (lambda key: node.importpubkey(key.pubkey, "", False), False),
+            (lambda key: node.importprivkey(key.privkey, "", False), True),
+            (lambda key: node.importmulti([{"scriptPubKey": {"address": key.p2pkh_addr}, "timestamp": "now", "watchonly": True}], {"rescan": False}), False),
+        ]
+        for do_import, spendable in imports:
+            key = get_key(self.nodes[1])
+            txid = node.sendtoaddress(key.p2pkh_addr, 1)
+            assert not [utxo for utxo in node.listunspent(0) if utxo["address"] == key.p2pkh_addr]
+            do_import(key)
+            utxos = [utxo for utxo in node.listunspent(0) if utxo["address"] == key.p2pkh_addr]
+            assert_equal(len(utxos), 1)
+            assert_equal(utxos[0]["txid"], txid)
+            assert_equal(utxos[0]["spendable"], spendable)
+
 
 if __name__ == "__main__":
     ImportRescanTest(__file__).main()
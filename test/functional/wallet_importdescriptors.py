@@ -763,5 +763,19 @@ class ImportDescriptorsTest(BitcoinTestFramework):
             assert_equal(w_multipath.getrawchangeaddress(address_type="bech32"), w_multisplit.getrawchangeaddress(address_type="bech32"))
         assert_equal(sorted(w_multipath.listdescriptors()["descriptors"], key=lambda x: x["desc"]), sorted(w_multisplit.listdescriptors()["descriptors"], key=lambda x: x["desc"]))
 
+        self.log.info("Imported descriptors make the outputs of known transactions spendable")
+        key = get_generate_key()
+        txid = w0.sendtoaddress(key.p2pkh_addr, 10)
+        assert not [utxo for utxo in w0.listunspent(0) if utxo["address"] == key.p2pkh_addr]
+        # The transaction is only in the mempool, so the rescan does not find it
+        self.test_importdesc({"desc": descsum_create("pkh(" + key.privkey + ")"),
+                              "timestamp": "now"},
+                             success=True,
+                             wallet=w0)
+        utxos = [utxo for utxo in w0.listunspent(0) if utxo["address"] == key.p2pkh_addr]
+        assert_equal(len(utxos), 1)
+        assert_equal(utxos[0]["txid"], txid)
+        assert_equal(utxos[0]["spendable"], True)
+
 if __name__ == '__main__':
     ImportDescriptorsTest(__file__).main()
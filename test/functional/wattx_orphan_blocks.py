@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the orphan block pool.
+
+A block whose parent is unknown is kept until the parent arrives, without
+penalizing the peer that sent it. A peer flooding orphans only evicts its own,
+so an orphan from another peer is still connected afterwards.
+"""
+
+import os
+
+from test_framework.p2p import P2PInterface
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+
+FLOOD_BLOCKS = 4000
+
+
+class msg_raw_block:
+    """A block message sent as the node serialized it"""
+    __slots__ = ("data",)
+    msgtype = b"block"
+
+    def __init__(self, data):
+        self.data = data
+
+    def serialize(self):
+        return self.data
+
+
+class WattxOrphanBlocksTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+        self.extra_args = [["-maxorphanblocksmib=1", "-debug=net"], []]
+
+    def setup_network(self):
+        self.setup_nodes()
+
+    def get_raw_blocks(self, node, count):
+        hashes = self.generate(node, count, sync_fun=self.no_op)
+        return hashes, [bytes.fromhex(node.getblock(h, 0)) for h in hashes]
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.connect_nodes(0, 1)
+        self.generate(node, 10)
+        self.disconnect_nodes(0, 1)
+
+        # Blocks the node has not seen, mined on the other node
+        hashes, blocks = self.get_raw_blocks(self.nodes[1], 4)
+        tip = node.getbestblockhash()
+
+        honest = node.add_p2p_connection(P2PInterface())
+        flooder = node.add_p2p_connection(P2PInterface())
+
+        self.log.info("An orphan is connected once its parent arrives")
+        with node.assert_debug_log(["stored orphan block {}".format(hashes[1])]):
+            honest.send_and_ping(msg_raw_block(blocks[1]))
+        assert_equal(node.getbestblockhash(), tip)
+        honest.send_and_ping(msg_raw_block(blocks[0]))
+        assert_equal(node.getbestblockhash(), hashes[1])
+
+        self.log.info("A peer flooding orphans does not push out the orphans of others")
+        honest.send_and_ping(msg_raw_block(blocks[3]))
+        # Orphans with unknown parents, more than the whole pool can hold
+        flood_size = 0
+        for _ in range(FLOOD_BLOCKS):
+            data = blocks[3][:4] + os.urandom(32) + blocks[3][36:]
+            flood_size += len(data)
+            flooder.send_message(msg_raw_block(data))
+        assert flood_size > 1 << 20
+        flooder.sync_with_ping(timeout=120)
+        assert flooder.is_connected
+
+        honest.send_and_ping(msg_raw_block(blocks[2]))
+        assert_equal(node.getbestblockhash(), hashes[3])
+
+        self.log.info("Orphans are not penalized")
+        assert honest.is_connected
+        assert flooder.is_connected
+        assert_equal(len(node.getpeerinfo()), 2)
+
+
+if __name__ == '__main__':
+    WattxOrphanBlocksTest(__file__).main()
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 The WATTx Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test detection and relay of staker equivocation evidence.
+
+A staker signing two different blocks for the same slot on the same parent is
+detected by the receiving node, which relays the evidence to its peers.
+Invalid evidence gets the sender disconnected.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import *
+from test_framework.p2p import *
+from test_framework.messages import *
+from test_framework.qtum import *
+import time
+
+
+class WattxStakerEquivocationTest(BitcoinTestFramework):
+    def add_options(self, parser):
+        self.add_wallet_options(parser)
+
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def create_conflicting_blocks(self):
+        tip = self.node.getblock(self.node.getbestblockhash())
+        t = (tip['time']+0x10) & 0xfffffff0
+        block, block_sig_key = create_unsigned_pos_block(self.node, self.staking_prevouts, nTime=t)
+        block.sign_block(block_sig_key)
+        block.rehash()
+
+        # Same stake, parent and slot, only the nonce differs
+        alt_block = CBlock(block)
+        alt_block.vtx = block.vtx[:]
+        alt_block.nNonce = 1
+        alt_block.rehash()
+        alt_block.sign_block(block_sig_key)
+        alt_block.rehash()
+        return block, alt_block, block_sig_key
+
+    def detect_and_relay_test(self):
+        block, alt_block, _ = self.create_conflicting_blocks()
+        p2p_node = self.node.add_p2p_connection(P2PInterface())
+        p2p_alt_node = self.alt_node.add_p2p_connection(P2PInterface())
+
+        with self.alt_node.assert_debug_log(["equivocated"], timeout=10):
+            with self.node.assert_debug_log(["Detected staker equivocation", "equivocated"], timeout=10):
+                p2p_node.send_and_ping(msg_block(block))
+                p2p_node.send_and_ping(msg_block(alt_block))
+
+        # The evidence reaches our other peers, but only once
+        p2p_alt_node.wait_until(lambda: "equivocation" in p2p_alt_node.last_message)
+        evidence = p2p_alt_node.last_message["equivocation"]
+        assert_equal({evidence.first.hash, evidence.second.hash}, {block.hash, alt_block.hash})
+        with self.node.assert_debug_log([], unexpected_msgs=["equivocated"]):
+            p2p_node.send_and_ping(msg_equivocation(block, alt_block))
+
+        self.node.disconnect_p2ps()
+        self.alt_node.disconnect_p2ps()
+        self._remove_from_staking_prevouts(block.prevoutStake)
+
+    def invalid_evidence_test(self):
+        block, alt_block, _ = self.create_conflicting_blocks()
+        # Re-sign one header with another key
+        other_key = ECKey()
+        other_key.generate()
+        alt_block.sign_block(other_key)
+        alt_block.rehash()
+
+        p2p_node = self.node.add_p2p_connection(P2PInterface())
+        with self.node.assert_debug_log(["invalid equivocation evidence"]):
+            p2p_node.send_message(msg_equivocation(block, alt_block))
+            p2p_node.wait_for_disconnect()
+        self.node.disconnect_p2ps()
+
+    def _remove_from_staking_prevouts(self, remove_prevout):
+        for j in range(len(self.staking_prevouts)):
+            if self.staking_prevouts[j][0].serialize() == remove_prevout.serialize():
+                self.staking_prevouts.pop(j)
+                break
+
+    def run_test(self):
+        privkey = byte_to_base58(hash256(struct.pack('<I', 0)), 239)
+        for n in self.nodes:
+            n.importprivkey(privkey)
+
+        self.node = self.nodes[0]
+        self.alt_node = self.nodes[1]
+        # Keep the chain recent: only headers within the detection window are
+        # indexed, and detection is skipped during initial block download
+        generatesynchronized(self.node, COINBASE_MATURITY+50, "qSrM9K6FMhZ29Vkp8Rdk8Jp66bbfpjFETq", self.nodes)
+        self.sync_all()
+        self.staking_prevouts = collect_prevouts(self.node)
+        time.sleep(0x10)
+
+        self.log.info("Conflicting blocks from the same staker are detected and the evidence relayed")
+        self.detect_and_relay_test()
+        self.log.info("Evidence signed by different keys is rejected")
+        self.invalid_evidence_test()
+
+
+if __name__ == '__main__':
+    WattxStakerEquivocationTest(__file__).main()